@@ -33,6 +33,92 @@
 
 #include "core/math/geometry_3d.h"
 #include "core/object/script_language.h"
+#include "core/object/worker_thread_pool.h"
+
+void AStar3D::SearchContext::begin(uint32_t p_node_count) {
+	if (nodes.size() < p_node_count) {
+		nodes.resize(p_node_count);
+	}
+	open_list.clear();
+	pass++;
+	last_closest_point = nullptr;
+}
+
+void AStar3D::SearchContext::push_open(Point *p_point) {
+	SearchNode &n = nodes[p_point->index];
+	n.open_pass = pass;
+	n.heap_index = open_list.size();
+	open_list.push_back(p_point);
+	_sift_up(n.heap_index);
+}
+
+AStar3D::Point *AStar3D::SearchContext::pop_open() {
+	Point *top = open_list[0];
+	Point *last = open_list[open_list.size() - 1];
+	open_list.resize(open_list.size() - 1);
+	if (!open_list.is_empty()) {
+		open_list[0] = last;
+		nodes[last->index].heap_index = 0;
+		_sift_down(0);
+	}
+	return top;
+}
+
+void AStar3D::SearchContext::decrease_open(Point *p_point) {
+	_sift_up(nodes[p_point->index].heap_index);
+}
+
+void AStar3D::SearchContext::_sift_up(uint32_t p_heap_index) {
+	Point *p = open_list[p_heap_index];
+	while (p_heap_index > 0) {
+		uint32_t parent = (p_heap_index - 1) / 2;
+		if (!_is_worse(open_list[parent], p)) {
+			break;
+		}
+		open_list[p_heap_index] = open_list[parent];
+		nodes[open_list[p_heap_index]->index].heap_index = p_heap_index;
+		p_heap_index = parent;
+	}
+	open_list[p_heap_index] = p;
+	nodes[p->index].heap_index = p_heap_index;
+}
+
+void AStar3D::SearchContext::_sift_down(uint32_t p_heap_index) {
+	Point *p = open_list[p_heap_index];
+	const uint32_t size = open_list.size();
+	while (true) {
+		uint32_t child = p_heap_index * 2 + 1;
+		if (child >= size) {
+			break;
+		}
+		if (child + 1 < size && _is_worse(open_list[child], open_list[child + 1])) {
+			child++;
+		}
+		if (!_is_worse(p, open_list[child])) {
+			break;
+		}
+		open_list[p_heap_index] = open_list[child];
+		nodes[open_list[p_heap_index]->index].heap_index = p_heap_index;
+		p_heap_index = child;
+	}
+	open_list[p_heap_index] = p;
+	nodes[p->index].heap_index = p_heap_index;
+}
+
+AStar3D::SearchContext *AStar3D::_acquire_search_context() {
+	MutexLock lock(search_contexts_mutex);
+	if (free_search_contexts.is_empty()) {
+		return memnew(SearchContext);
+	}
+	SearchContext *context = free_search_contexts[free_search_contexts.size() - 1];
+	free_search_contexts.resize(free_search_contexts.size() - 1);
+	return context;
+}
+
+void AStar3D::_release_search_context(SearchContext *p_context) {
+	MutexLock lock(search_contexts_mutex);
+	free_search_contexts.push_back(p_context);
+}
 
 int64_t AStar3D::get_available_point_id() const {
 	if (points.has(last_free_id)) {
@@ -58,10 +144,13 @@ void AStar3D::add_point(int64_t p_id, const Vector3 &p_pos, real_t p_weight_scal
 		pt->id = p_id;
 		pt->pos = p_pos;
 		pt->weight_scale = p_weight_scale;
-		pt->prev_point = nullptr;
-		pt->open_pass = 0;
-		pt->closed_pass = 0;
 		pt->enabled = true;
+		if (free_point_indices.is_empty()) {
+			pt->index = point_index_count++;
+		} else {
+			pt->index = free_point_indices[free_point_indices.size() - 1];
+			free_point_indices.resize(free_point_indices.size() - 1);
+		}
 		points.set(p_id, pt);
 	} else {
 		found_pt->pos = p_pos;
@@ -123,6 +212,7 @@ void AStar3D::remove_point(int64_t p_id) {
 		(*it.value)->unlinked_neighbours.remove(p->id);
 	}
 
+	free_point_indices.push_back(p->index);
 	memdelete(p);
 	points.remove(p_id);
 	last_free_id = p_id;
@@ -249,6 +339,8 @@ void AStar3D::clear() {
 	}
 	segments.clear();
 	points.clear();
+	point_index_count = 0;
+	free_point_indices.clear();
 }
 
 int64_t AStar3D::get_point_count() const {
@@ -319,9 +411,8 @@ Vector3 AStar3D::get_closest_position_in_segment(const Vector3 &p_point) const {
 	return closest_point;
 }
 
-bool AStar3D::_solve(Point *begin_point, Point *end_point) {
-	last_closest_point = nullptr;
-	pass++;
+bool AStar3D::_solve(SearchContext &r_context, Point *begin_point, Point *end_point) {
+	r_context.begin(point_index_count);
 
 	if (!end_point->enabled) {
 		return false;
@@ -329,21 +420,25 @@ bool AStar3D::_solve(Point *begin_point, Point *end_point) {
 
 	bool found_route = false;
 
-	LocalVector<Point *> open_list;
-	SortArray<Point *, SortPoints> sorter;
+	SearchNode &begin_node = r_context.node(begin_point);
+	begin_node.g_score = 0;
+	begin_node.f_score = _estimate_cost(begin_point->id, end_point->id);
+	begin_node.abs_g_score = 0;
+	begin_node.abs_f_score = _estimate_cost(begin_point->id, end_point->id);
+	r_context.push_open(begin_point);
 
-	begin_point->g_score = 0;
-	begin_point->f_score = _estimate_cost(begin_point->id, end_point->id);
-	begin_point->abs_g_score = 0;
-	begin_point->abs_f_score = _estimate_cost(begin_point->id, end_point->id);
-	open_list.push_back(begin_point);
-
-	while (!open_list.is_empty()) {
-		Point *p = open_list[0]; // The currently processed point.
+	while (!r_context.open_list.is_empty()) {
+		Point *p = r_context.open_list[0]; // The currently processed point.
+		SearchNode &p_node = r_context.node(p);
 
 		// Find point closer to end_point, or same distance to end_point but closer to begin_point.
-		if (last_closest_point == nullptr || last_closest_point->abs_f_score > p->abs_f_score || (last_closest_point->abs_f_score >= p->abs_f_score && last_closest_point->abs_g_score > p->abs_g_score)) {
-			last_closest_point = p;
+		if (r_context.last_closest_point == nullptr) {
+			r_context.last_closest_point = p;
+		} else {
+			const SearchNode &closest_node = r_context.node(r_context.last_closest_point);
+			if (closest_node.abs_f_score > p_node.abs_f_score || (closest_node.abs_f_score >= p_node.abs_f_score && closest_node.abs_g_score > p_node.abs_g_score)) {
+				r_context.last_closest_point = p;
+			}
 		}
 
 		if (p == end_point) {
@@ -351,39 +446,37 @@ bool AStar3D::_solve(Point *begin_point, Point *end_point) {
 			break;
 		}
 
-		sorter.pop_heap(0, open_list.size(), open_list.ptr()); // Remove the current point from the open list.
-		open_list.remove_at(open_list.size() - 1);
-		p->closed_pass = pass; // Mark the point as closed.
+		r_context.pop_open(); // Remove the current point from the open list.
+		p_node.closed_pass = r_context.pass; // Mark the point as closed.
 
 		for (OAHashMap<int64_t, Point *>::Iterator it = p->neighbors.iter(); it.valid; it = p->neighbors.next_iter(it)) {
 			Point *e = *(it.value); // The neighbor point.
 
-			if (!e->enabled || e->closed_pass == pass) {
+			if (!e->enabled || r_context.is_closed(e)) {
 				continue;
 			}
 
-			real_t tentative_g_score = p->g_score + _compute_cost(p->id, e->id) * e->weight_scale;
+			SearchNode &e_node = r_context.node(e);
+			real_t tentative_g_score = p_node.g_score + _compute_cost(p->id, e->id) * e->weight_scale;
 
 			bool new_point = false;
 
-			if (e->open_pass != pass) { // The point wasn't inside the open list.
-				e->open_pass = pass;
-				open_list.push_back(e);
+			if (!r_context.is_open(e)) { // The point wasn't inside the open list.
 				new_point = true;
-			} else if (tentative_g_score >= e->g_score) { // The new path is worse than the previous.
+			} else if (tentative_g_score >= e_node.g_score) { // The new path is worse than the previous.
 				continue;
 			}
 
-			e->prev_point = p;
-			e->g_score = tentative_g_score;
-			e->f_score = e->g_score + _estimate_cost(e->id, end_point->id);
-			e->abs_g_score = tentative_g_score;
-			e->abs_f_score = e->f_score - e->g_score;
+			e_node.prev_point = p;
+			e_node.g_score = tentative_g_score;
+			e_node.f_score = e_node.g_score + _estimate_cost(e->id, end_point->id);
+			e_node.abs_g_score = tentative_g_score;
+			e_node.abs_f_score = e_node.f_score - e_node.g_score;
 
-			if (new_point) { // The position of the new points is already known.
-				sorter.push_heap(0, open_list.size() - 1, 0, e, open_list.ptr());
+			if (new_point) {
+				r_context.push_open(e);
 			} else {
-				sorter.push_heap(0, open_list.find(e), 0, e, open_list.ptr());
+				r_context.decrease_open(e);
 			}
 		}
 	}
@@ -443,21 +536,23 @@ Vector<Vector3> AStar3D::get_point_path(int64_t p_from_id, int64_t p_to_id, bool
 	Point *begin_point = a;
 	Point *end_point = b;
 
-	bool found_route = _solve(begin_point, end_point);
+	SearchContext *context = _acquire_search_context();
+	bool found_route = _solve(*context, begin_point, end_point);
 	if (!found_route) {
-		if (!p_allow_partial_path || last_closest_point == nullptr) {
+		if (!p_allow_partial_path || context->last_closest_point == nullptr) {
+			_release_search_context(context);
 			return Vector<Vector3>();
 		}
 
 		// Use closest point instead.
-		end_point = last_closest_point;
+		end_point = context->last_closest_point;
 	}
 
 	Point *p = end_point;
 	int64_t pc = 1; // Begin point
 	while (p != begin_point) {
 		pc++;
-		p = p->prev_point;
+		p = context->node(p).prev_point;
 	}
 
 	Vector<Vector3> path;
@@ -470,12 +565,14 @@ Vector<Vector3> AStar3D::get_point_path(int64_t p_from_id, int64_t p_to_id, bool
 		int64_t idx = pc - 1;
 		while (p2 != begin_point) {
 			w[idx--] = p2->pos;
-			p2 = p2->prev_point;
+			p2 = context->node(p2).prev_point;
 		}
 
 		w[0] = p2->pos; // Assign first
 	}
 
+	_release_search_context(context);
+
 	return path;
 }
 
@@ -497,21 +594,23 @@ Vector<int64_t> AStar3D::get_id_path(int64_t p_from_id, int64_t p_to_id, bool p_
 	Point *begin_point = a;
 	Point *end_point = b;
 
-	bool found_route = _solve(begin_point, end_point);
+	SearchContext *context = _acquire_search_context();
+	bool found_route = _solve(*context, begin_point, end_point);
 	if (!found_route) {
-		if (!p_allow_partial_path || last_closest_point == nullptr) {
+		if (!p_allow_partial_path || context->last_closest_point == nullptr) {
+			_release_search_context(context);
 			return Vector<int64_t>();
 		}
 
 		// Use closest point instead.
-		end_point = last_closest_point;
+		end_point = context->last_closest_point;
 	}
 
 	Point *p = end_point;
 	int64_t pc = 1; // Begin point
 	while (p != begin_point) {
 		pc++;
-		p = p->prev_point;
+		p = context->node(p).prev_point;
 	}
 
 	Vector<int64_t> path;
@@ -524,15 +623,53 @@ Vector<int64_t> AStar3D::get_id_path(int64_t p_from_id, int64_t p_to_id, bool p_
 		int64_t idx = pc - 1;
 		while (p != begin_point) {
 			w[idx--] = p->id;
-			p = p->prev_point;
+			p = context->node(p).prev_point;
 		}
 
 		w[0] = p->id; // Assign first
 	}
 
+	_release_search_context(context);
+
 	return path;
 }
 
+void AStar3D::_get_id_paths_task(uint32_t p_index, PathQueries *p_queries) {
+	p_queries->paths[p_index] = get_id_path(p_queries->from_ids[p_index], p_queries->to_ids[p_index], p_queries->allow_partial_path);
+}
+
+TypedArray<PackedInt64Array> AStar3D::get_id_paths(const PackedInt64Array &p_from_ids, const PackedInt64Array &p_to_ids, bool p_allow_partial_path) {
+	ERR_FAIL_COND_V_MSG(p_from_ids.size() != p_to_ids.size(), TypedArray<PackedInt64Array>(), vformat("Can't get id paths. The number of from ids (%d) doesn't match the number of to ids (%d).", p_from_ids.size(), p_to_ids.size()));
+
+	const uint32_t query_count = p_from_ids.size();
+	LocalVector<Vector<int64_t>> paths;
+	paths.resize(query_count);
+
+	PathQueries queries;
+	queries.from_ids = p_from_ids.ptr();
+	queries.to_ids = p_to_ids.ptr();
+	queries.allow_partial_path = p_allow_partial_path;
+	queries.paths = paths.ptr();
+
+	// Overridden cost functions are not safe to call from several threads at once.
+	if (query_count < 2 || GDVIRTUAL_IS_OVERRIDDEN(_estimate_cost) || GDVIRTUAL_IS_OVERRIDDEN(_compute_cost)) {
+		for (uint32_t i = 0; i < query_count; i++) {
+			_get_id_paths_task(i, &queries);
+		}
+	} else {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &AStar3D::_get_id_paths_task, &queries, query_count, -1, true, SNAME("AStar3DPathQueries"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	}
+
+	TypedArray<PackedInt64Array> ret;
+	ret.resize(query_count);
+	for (uint32_t i = 0; i < query_count; i++) {
+		ret[i] = paths[i];
+	}
+
+	return ret;
+}
+
 void AStar3D::set_point_disabled(int64_t p_id, bool p_disabled) {
 	Point *p = nullptr;
 	bool p_exists = points.lookup(p_id, p);
@@ -578,6 +715,7 @@ void AStar3D::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("get_point_path", "from_id", "to_id", "allow_partial_path"), &AStar3D::get_point_path, DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("get_id_path", "from_id", "to_id", "allow_partial_path"), &AStar3D::get_id_path, DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("get_id_paths", "from_ids", "to_ids", "allow_partial_path"), &AStar3D::get_id_paths, DEFVAL(false));
 
 	GDVIRTUAL_BIND(_estimate_cost, "from_id", "end_id")
 	GDVIRTUAL_BIND(_compute_cost, "from_id", "to_id")
@@ -585,6 +723,9 @@ void AStar3D::_bind_methods() {
 
 AStar3D::~AStar3D() {
 	clear();
+	for (SearchContext *context : free_search_contexts) {
+		memdelete(context);
+	}
 }
 
 /////////////////////////////////////////////////////////////
@@ -726,21 +867,23 @@ Vector<Vector2> AStar2D::get_point_path(int64_t p_from_id, int64_t p_to_id, bool
 	AStar3D::Point *begin_point = a;
 	AStar3D::Point *end_point = b;
 
-	bool found_route = _solve(begin_point, end_point);
+	AStar3D::SearchContext *context = astar._acquire_search_context();
+	bool found_route = _solve(*context, begin_point, end_point);
 	if (!found_route) {
-		if (!p_allow_partial_path || astar.last_closest_point == nullptr) {
+		if (!p_allow_partial_path || context->last_closest_point == nullptr) {
+			astar._release_search_context(context);
 			return Vector<Vector2>();
 		}
 
 		// Use closest point instead.
-		end_point = astar.last_closest_point;
+		end_point = context->last_closest_point;
 	}
 
 	AStar3D::Point *p = end_point;
 	int64_t pc = 1; // Begin point
 	while (p != begin_point) {
 		pc++;
-		p = p->prev_point;
+		p = context->node(p).prev_point;
 	}
 
 	Vector<Vector2> path;
@@ -753,12 +896,14 @@ Vector<Vector2> AStar2D::get_point_path(int64_t p_from_id, int64_t p_to_id, bool
 		int64_t idx = pc - 1;
 		while (p2 != begin_point) {
 			w[idx--] = Vector2(p2->pos.x, p2->pos.y);
-			p2 = p2->prev_point;
+			p2 = context->node(p2).prev_point;
 		}
 
 		w[0] = Vector2(p2->pos.x, p2->pos.y); // Assign first
 	}
 
+	astar._release_search_context(context);
+
 	return path;
 }
 
@@ -780,21 +925,23 @@ Vector<int64_t> AStar2D::get_id_path(int64_t p_from_id, int64_t p_to_id, bool p_
 	AStar3D::Point *begin_point = a;
 	AStar3D::Point *end_point = b;
 
-	bool found_route = _solve(begin_point, end_point);
+	AStar3D::SearchContext *context = astar._acquire_search_context();
+	bool found_route = _solve(*context, begin_point, end_point);
 	if (!found_route) {
-		if (!p_allow_partial_path || astar.last_closest_point == nullptr) {
+		if (!p_allow_partial_path || context->last_closest_point == nullptr) {
+			astar._release_search_context(context);
 			return Vector<int64_t>();
 		}
 
 		// Use closest point instead.
-		end_point = astar.last_closest_point;
+		end_point = context->last_closest_point;
 	}
 
 	AStar3D::Point *p = end_point;
 	int64_t pc = 1; // Begin point
 	while (p != begin_point) {
 		pc++;
-		p = p->prev_point;
+		p = context->node(p).prev_point;
 	}
 
 	Vector<int64_t> path;
@@ -807,18 +954,55 @@ Vector<int64_t> AStar2D::get_id_path(int64_t p_from_id, int64_t p_to_id, bool p_
 		int64_t idx = pc - 1;
 		while (p != begin_point) {
 			w[idx--] = p->id;
-			p = p->prev_point;
+			p = context->node(p).prev_point;
 		}
 
 		w[0] = p->id; // Assign first
 	}
 
+	astar._release_search_context(context);
+
 	return path;
 }
 
-bool AStar2D::_solve(AStar3D::Point *begin_point, AStar3D::Point *end_point) {
-	astar.last_closest_point = nullptr;
-	astar.pass++;
+void AStar2D::_get_id_paths_task(uint32_t p_index, AStar3D::PathQueries *p_queries) {
+	p_queries->paths[p_index] = get_id_path(p_queries->from_ids[p_index], p_queries->to_ids[p_index], p_queries->allow_partial_path);
+}
+
+TypedArray<PackedInt64Array> AStar2D::get_id_paths(const PackedInt64Array &p_from_ids, const PackedInt64Array &p_to_ids, bool p_allow_partial_path) {
+	ERR_FAIL_COND_V_MSG(p_from_ids.size() != p_to_ids.size(), TypedArray<PackedInt64Array>(), vformat("Can't get id paths. The number of from ids (%d) doesn't match the number of to ids (%d).", p_from_ids.size(), p_to_ids.size()));
+
+	const uint32_t query_count = p_from_ids.size();
+	LocalVector<Vector<int64_t>> paths;
+	paths.resize(query_count);
+
+	AStar3D::PathQueries queries;
+	queries.from_ids = p_from_ids.ptr();
+	queries.to_ids = p_to_ids.ptr();
+	queries.allow_partial_path = p_allow_partial_path;
+	queries.paths = paths.ptr();
+
+	// Overridden cost functions are not safe to call from several threads at once.
+	if (query_count < 2 || GDVIRTUAL_IS_OVERRIDDEN(_estimate_cost) || GDVIRTUAL_IS_OVERRIDDEN(_compute_cost)) {
+		for (uint32_t i = 0; i < query_count; i++) {
+			_get_id_paths_task(i, &queries);
+		}
+	} else {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &AStar2D::_get_id_paths_task, &queries, query_count, -1, true, SNAME("AStar2DPathQueries"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	}
+
+	TypedArray<PackedInt64Array> ret;
+	ret.resize(query_count);
+	for (uint32_t i = 0; i < query_count; i++) {
+		ret[i] = paths[i];
+	}
+
+	return ret;
+}
+
+bool AStar2D::_solve(AStar3D::SearchContext &r_context, AStar3D::AStar3D::Point *begin_point, AStar3D::AStar3D::Point *end_point) {
+	r_context.begin(astar.point_index_count);
 
 	if (!end_point->enabled) {
 		return false;
@@ -826,21 +1010,25 @@ bool AStar2D::_solve(AStar3D::Point *begin_point, AStar3D::Point *end_point) {
 
 	bool found_route = false;
 
-	LocalVector<AStar3D::Point *> open_list;
-	SortArray<AStar3D::Point *, AStar3D::SortPoints> sorter;
-
-	begin_point->g_score = 0;
-	begin_point->f_score = _estimate_cost(begin_point->id, end_point->id);
-	begin_point->abs_g_score = 0;
-	begin_point->abs_f_score = _estimate_cost(begin_point->id, end_point->id);
-	open_list.push_back(begin_point);
+	AStar3D::SearchNode &begin_node = r_context.node(begin_point);
+	begin_node.g_score = 0;
+	begin_node.f_score = _estimate_cost(begin_point->id, end_point->id);
+	begin_node.abs_g_score = 0;
+	begin_node.abs_f_score = _estimate_cost(begin_point->id, end_point->id);
+	r_context.push_open(begin_point);
 
-	while (!open_list.is_empty()) {
-		AStar3D::Point *p = open_list[0]; // The currently processed point.
+	while (!r_context.open_list.is_empty()) {
+		AStar3D::Point *p = r_context.open_list[0]; // The currently processed point.
+		AStar3D::SearchNode &p_node = r_context.node(p);
 
 		// Find point closer to end_point, or same distance to end_point but closer to begin_point.
-		if (astar.last_closest_point == nullptr || astar.last_closest_point->abs_f_score > p->abs_f_score || (astar.last_closest_point->abs_f_score >= p->abs_f_score && astar.last_closest_point->abs_g_score > p->abs_g_score)) {
-			astar.last_closest_point = p;
+		if (r_context.last_closest_point == nullptr) {
+			r_context.last_closest_point = p;
+		} else {
+			const AStar3D::SearchNode &closest_node = r_context.node(r_context.last_closest_point);
+			if (closest_node.abs_f_score > p_node.abs_f_score || (closest_node.abs_f_score >= p_node.abs_f_score && closest_node.abs_g_score > p_node.abs_g_score)) {
+				r_context.last_closest_point = p;
+			}
 		}
 
 		if (p == end_point) {
@@ -848,39 +1036,37 @@ bool AStar2D::_solve(AStar3D::Point *begin_point, AStar3D::Point *end_point) {
 			break;
 		}
 
-		sorter.pop_heap(0, open_list.size(), open_list.ptr()); // Remove the current point from the open list.
-		open_list.remove_at(open_list.size() - 1);
-		p->closed_pass = astar.pass; // Mark the point as closed.
+		r_context.pop_open(); // Remove the current point from the open list.
+		p_node.closed_pass = r_context.pass; // Mark the point as closed.
 
 		for (OAHashMap<int64_t, AStar3D::Point *>::Iterator it = p->neighbors.iter(); it.valid; it = p->neighbors.next_iter(it)) {
 			AStar3D::Point *e = *(it.value); // The neighbor point.
 
-			if (!e->enabled || e->closed_pass == astar.pass) {
+			if (!e->enabled || r_context.is_closed(e)) {
 				continue;
 			}
 
-			real_t tentative_g_score = p->g_score + _compute_cost(p->id, e->id) * e->weight_scale;
+			AStar3D::SearchNode &e_node = r_context.node(e);
+			real_t tentative_g_score = p_node.g_score + _compute_cost(p->id, e->id) * e->weight_scale;
 
 			bool new_point = false;
 
-			if (e->open_pass != astar.pass) { // The point wasn't inside the open list.
-				e->open_pass = astar.pass;
-				open_list.push_back(e);
+			if (!r_context.is_open(e)) { // The point wasn't inside the open list.
 				new_point = true;
-			} else if (tentative_g_score >= e->g_score) { // The new path is worse than the previous.
+			} else if (tentative_g_score >= e_node.g_score) { // The new path is worse than the previous.
 				continue;
 			}
 
-			e->prev_point = p;
-			e->g_score = tentative_g_score;
-			e->f_score = e->g_score + _estimate_cost(e->id, end_point->id);
-			e->abs_g_score = tentative_g_score;
-			e->abs_f_score = e->f_score - e->g_score;
+			e_node.prev_point = p;
+			e_node.g_score = tentative_g_score;
+			e_node.f_score = e_node.g_score + _estimate_cost(e->id, end_point->id);
+			e_node.abs_g_score = tentative_g_score;
+			e_node.abs_f_score = e_node.f_score - e_node.g_score;
 
-			if (new_point) { // The position of the new points is already known.
-				sorter.push_heap(0, open_list.size() - 1, 0, e, open_list.ptr());
+			if (new_point) {
+				r_context.push_open(e);
 			} else {
-				sorter.push_heap(0, open_list.find(e), 0, e, open_list.ptr());
+				r_context.decrease_open(e);
 			}
 		}
 	}
@@ -917,6 +1103,7 @@ void AStar2D::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("get_point_path", "from_id", "to_id", "allow_partial_path"), &AStar2D::get_point_path, DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("get_id_path", "from_id", "to_id", "allow_partial_path"), &AStar2D::get_id_path, DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("get_id_paths", "from_ids", "to_ids", "allow_partial_path"), &AStar2D::get_id_paths, DEFVAL(false));
 
 	GDVIRTUAL_BIND(_estimate_cost, "from_id", "end_id")
 	GDVIRTUAL_BIND(_compute_cost, "from_id", "to_id")
@@ -33,7 +33,9 @@
 
 #include "core/object/gdvirtual.gen.inc"
 #include "core/object/ref_counted.h"
+#include "core/os/mutex.h"
 #include "core/templates/oa_hash_map.h"
+#include "core/variant/typed_array.h"
 
 /**
 	A* pathfinding algorithm.
@@ -47,35 +49,60 @@ class AStar3D : public RefCounted {
 		Point() {}
 
 		int64_t id = 0;
+		uint32_t index = 0; // Index of the point's state in a SearchContext.
 		Vector3 pos;
 		real_t weight_scale = 0;
 		bool enabled = false;
 
 		OAHashMap<int64_t, Point *> neighbors = 4u;
 		OAHashMap<int64_t, Point *> unlinked_neighbours = 4u;
+	};
 
-		// Used for pathfinding.
+	// Pathfinding state of a point, owned by a single query.
+	struct SearchNode {
 		Point *prev_point = nullptr;
 		real_t g_score = 0;
 		real_t f_score = 0;
 		uint64_t open_pass = 0;
 		uint64_t closed_pass = 0;
+		uint32_t heap_index = 0;
 
 		// Used for getting closest_point_of_last_pathing_call.
 		real_t abs_g_score = 0;
 		real_t abs_f_score = 0;
 	};
 
-	struct SortPoints {
-		_FORCE_INLINE_ bool operator()(const Point *A, const Point *B) const { // Returns true when the Point A is worse than Point B.
-			if (A->f_score > B->f_score) {
+	// Everything a query writes to while solving, so queries on the same graph can run concurrently.
+	struct SearchContext {
+		LocalVector<SearchNode> nodes;
+		LocalVector<Point *> open_list; // Binary heap, the best point is first.
+		uint64_t pass = 0;
+		Point *last_closest_point = nullptr;
+
+		void begin(uint32_t p_node_count);
+
+		_FORCE_INLINE_ SearchNode &node(const Point *p_point) { return nodes[p_point->index]; }
+		_FORCE_INLINE_ bool is_open(const Point *p_point) const { return nodes[p_point->index].open_pass == pass; }
+		_FORCE_INLINE_ bool is_closed(const Point *p_point) const { return nodes[p_point->index].closed_pass == pass; }
+
+		void push_open(Point *p_point);
+		Point *pop_open();
+		void decrease_open(Point *p_point);
+
+	private:
+		_FORCE_INLINE_ bool _is_worse(const Point *p_a, const Point *p_b) const { // Returns true when the Point A is worse than Point B.
+			const SearchNode &a = nodes[p_a->index];
+			const SearchNode &b = nodes[p_b->index];
+			if (a.f_score > b.f_score) {
 				return true;
-			} else if (A->f_score < B->f_score) {
+			} else if (a.f_score < b.f_score) {
 				return false;
 			} else {
-				return A->g_score < B->g_score; // If the f_costs are the same then prioritize the points that are further away from the start.
+				return a.g_score < b.g_score; // If the f_costs are the same then prioritize the points that are further away from the start.
 			}
 		}
+		void _sift_up(uint32_t p_heap_index);
+		void _sift_down(uint32_t p_heap_index);
 	};
 
 	struct Segment {
@@ -109,13 +136,28 @@ class AStar3D : public RefCounted {
 	};
 
 	int64_t last_free_id = 0;
-	uint64_t pass = 1;
 
 	OAHashMap<int64_t, Point *> points;
 	HashSet<Segment, Segment> segments;
-	Point *last_closest_point = nullptr;
 
-	bool _solve(Point *begin_point, Point *end_point);
+	uint32_t point_index_count = 0;
+	LocalVector<uint32_t> free_point_indices;
+
+	BinaryMutex search_contexts_mutex;
+	LocalVector<SearchContext *> free_search_contexts;
+
+	SearchContext *_acquire_search_context();
+	void _release_search_context(SearchContext *p_context);
+
+	bool _solve(SearchContext &r_context, Point *begin_point, Point *end_point);
+
+	struct PathQueries {
+		const int64_t *from_ids = nullptr;
+		const int64_t *to_ids = nullptr;
+		bool allow_partial_path = false;
+		Vector<int64_t> *paths = nullptr;
+	};
+	void _get_id_paths_task(uint32_t p_index, PathQueries *p_queries);
 
 protected:
 	static void _bind_methods();
@@ -162,6 +204,7 @@ public:
 
 	Vector<Vector3> get_point_path(int64_t p_from_id, int64_t p_to_id, bool p_allow_partial_path = false);
 	Vector<int64_t> get_id_path(int64_t p_from_id, int64_t p_to_id, bool p_allow_partial_path = false);
+	TypedArray<PackedInt64Array> get_id_paths(const PackedInt64Array &p_from_ids, const PackedInt64Array &p_to_ids, bool p_allow_partial_path = false);
 
 	AStar3D() {}
 	~AStar3D();
@@ -171,7 +214,8 @@ class AStar2D : public RefCounted {
 	GDCLASS(AStar2D, RefCounted);
 	AStar3D astar;
 
-	bool _solve(AStar3D::Point *begin_point, AStar3D::Point *end_point);
+	bool _solve(AStar3D::SearchContext &r_context, AStar3D::Point *begin_point, AStar3D::Point *end_point);
+	void _get_id_paths_task(uint32_t p_index, AStar3D::PathQueries *p_queries);
 
 protected:
 	static void _bind_methods();
@@ -218,6 +262,7 @@ public:
 
 	Vector<Vector2> get_point_path(int64_t p_from_id, int64_t p_to_id, bool p_allow_partial_path = false);
 	Vector<int64_t> get_id_path(int64_t p_from_id, int64_t p_to_id, bool p_allow_partial_path = false);
+	TypedArray<PackedInt64Array> get_id_paths(const PackedInt64Array &p_from_ids, const PackedInt64Array &p_to_ids, bool p_allow_partial_path = false);
 
 	AStar2D() {}
 	~AStar2D() {}
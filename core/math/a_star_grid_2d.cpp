@@ -31,6 +31,7 @@
 #include "a_star_grid_2d.h"
 #include "a_star_grid_2d.compat.inc"
 
+#include "core/object/worker_thread_pool.h"
 #include "core/variant/typed_array.h"
 
 static real_t heuristic_euclidean(const Vector2i &p_from, const Vector2i &p_to) {
@@ -60,6 +61,18 @@ static real_t heuristic_chebyshev(const Vector2i &p_from, const Vector2i &p_to)
 
 static real_t (*heuristics[AStarGrid2D::HEURISTIC_MAX])(const Vector2i &, const Vector2i &) = { heuristic_euclidean, heuristic_manhattan, heuristic_octile, heuristic_chebyshev };
 
+// Offsets of the neighbors, in the order of AStarGrid2D::_get_jump_direction().
+static const Vector2i neighbor_offsets[8] = {
+	Vector2i(-1, -1),
+	Vector2i(0, -1),
+	Vector2i(1, -1),
+	Vector2i(-1, 0),
+	Vector2i(1, 0),
+	Vector2i(-1, 1),
+	Vector2i(0, 1),
+	Vector2i(1, 1),
+};
+
 void AStarGrid2D::set_region(const Rect2i &p_region) {
 	ERR_FAIL_COND(p_region.size.x < 0 || p_region.size.y < 0);
 	if (p_region != region) {
@@ -127,13 +140,19 @@ void AStarGrid2D::update() {
 	}
 
 	points.clear();
+	points.reserve(region.size.x * region.size.y);
+	solid_mask.clear();
+	solid_mask.resize((region.size.x * region.size.y + 63) / 64);
+	memset(solid_mask.ptr(), 0, solid_mask.size() * sizeof(uint64_t));
+	jump_table.clear();
+	jump_table_dirty_region = region;
+	flow_field_version++;
 
 	const int32_t end_x = region.get_end().x;
 	const int32_t end_y = region.get_end().y;
 	const Vector2 half_cell_size = cell_size / 2;
 
 	for (int32_t y = region.position.y; y < end_y; y++) {
-		LocalVector<Point> line;
 		for (int32_t x = region.position.x; x < end_x; x++) {
 			Vector2 v = offset;
 			switch (cell_shape) {
@@ -149,9 +168,8 @@ void AStarGrid2D::update() {
 				default:
 					break;
 			}
-			line.push_back(Point(Vector2i(x, y), v));
+			points.push_back(Point(Vector2i(x, y), v));
 		}
-		points.push_back(line);
 	}
 
 	dirty = false;
@@ -177,9 +195,27 @@ bool AStarGrid2D::is_jumping_enabled() const {
 	return jumping_enabled;
 }
 
+void AStarGrid2D::set_jump_table_enabled(bool p_enabled) {
+	if (jump_table_enabled == p_enabled) {
+		return;
+	}
+
+	jump_table_enabled = p_enabled;
+	jump_table.clear();
+	jump_table_dirty_region = region;
+}
+
+bool AStarGrid2D::is_jump_table_enabled() const {
+	return jump_table_enabled;
+}
+
 void AStarGrid2D::set_diagonal_mode(DiagonalMode p_diagonal_mode) {
 	ERR_FAIL_INDEX((int)p_diagonal_mode, (int)DIAGONAL_MODE_MAX);
-	diagonal_mode = p_diagonal_mode;
+	if (diagonal_mode != p_diagonal_mode) {
+		diagonal_mode = p_diagonal_mode;
+		jump_table_dirty_region = region;
+		flow_field_version++;
+	}
 }
 
 AStarGrid2D::DiagonalMode AStarGrid2D::get_diagonal_mode() const {
@@ -188,7 +224,10 @@ AStarGrid2D::DiagonalMode AStarGrid2D::get_diagonal_mode() const {
 
 void AStarGrid2D::set_default_compute_heuristic(Heuristic p_heuristic) {
 	ERR_FAIL_INDEX((int)p_heuristic, (int)HEURISTIC_MAX);
-	default_compute_heuristic = p_heuristic;
+	if (default_compute_heuristic != p_heuristic) {
+		default_compute_heuristic = p_heuristic;
+		flow_field_version++;
+	}
 }
 
 AStarGrid2D::Heuristic AStarGrid2D::get_default_compute_heuristic() const {
@@ -207,13 +246,17 @@ AStarGrid2D::Heuristic AStarGrid2D::get_default_estimate_heuristic() const {
 void AStarGrid2D::set_point_solid(const Vector2i &p_id, bool p_solid) {
 	ERR_FAIL_COND_MSG(dirty, "Grid is not initialized. Call the update method.");
 	ERR_FAIL_COND_MSG(!is_in_boundsv(p_id), vformat("Can't set if point is disabled. Point %s out of bounds %s.", p_id, region));
-	_get_point_unchecked(p_id)->solid = p_solid;
+	if (_is_solid_unchecked(p_id.x, p_id.y) != p_solid) {
+		_set_solid_unchecked(p_id.x, p_id.y, p_solid);
+		_invalidate_jump_table(Rect2i(p_id, Size2i(1, 1)));
+		flow_field_version++;
+	}
 }
 
 bool AStarGrid2D::is_point_solid(const Vector2i &p_id) const {
 	ERR_FAIL_COND_V_MSG(dirty, false, "Grid is not initialized. Call the update method.");
 	ERR_FAIL_COND_V_MSG(!is_in_boundsv(p_id), false, vformat("Can't get if point is disabled. Point %s out of bounds %s.", p_id, region));
-	return _get_point_unchecked(p_id)->solid;
+	return _is_solid_unchecked(p_id.x, p_id.y);
 }
 
 void AStarGrid2D::set_point_weight_scale(const Vector2i &p_id, real_t p_weight_scale) {
@@ -221,6 +264,7 @@ void AStarGrid2D::set_point_weight_scale(const Vector2i &p_id, real_t p_weight_s
 	ERR_FAIL_COND_MSG(!is_in_boundsv(p_id), vformat("Can't set point's weight scale. Point %s out of bounds %s.", p_id, region));
 	ERR_FAIL_COND_MSG(p_weight_scale < 0.0, vformat("Can't set point's weight scale less than 0.0: %f.", p_weight_scale));
 	_get_point_unchecked(p_id)->weight_scale = p_weight_scale;
+	flow_field_version++;
 }
 
 real_t AStarGrid2D::get_point_weight_scale(const Vector2i &p_id) const {
@@ -238,9 +282,11 @@ void AStarGrid2D::fill_solid_region(const Rect2i &p_region, bool p_solid) {
 
 	for (int32_t y = safe_region.position.y; y < end_y; y++) {
 		for (int32_t x = safe_region.position.x; x < end_x; x++) {
-			_get_point_unchecked(x, y)->solid = p_solid;
+			_set_solid_unchecked(x, y, p_solid);
 		}
 	}
+	_invalidate_jump_table(safe_region);
+	flow_field_version++;
 }
 
 void AStarGrid2D::fill_weight_scale_region(const Rect2i &p_region, real_t p_weight_scale) {
@@ -256,10 +302,11 @@ void AStarGrid2D::fill_weight_scale_region(const Rect2i &p_region, real_t p_weig
 			_get_point_unchecked(x, y)->weight_scale = p_weight_scale;
 		}
 	}
+	flow_field_version++;
 }
 
 AStarGrid2D::Point *AStarGrid2D::_jump(Point *p_from, Point *p_to) {
-	if (!p_to || p_to->solid) {
+	if (!p_to || _is_point_solid(p_to)) {
 		return nullptr;
 	}
 	if (p_to == end) {
@@ -346,6 +393,236 @@ AStarGrid2D::Point *AStarGrid2D::_jump(Point *p_from, Point *p_to) {
 	return nullptr;
 }
 
+// The checks below mirror _jump(), so the jump table finds the same jump points.
+
+bool AStarGrid2D::_is_jump_forced(int32_t p_x, int32_t p_y, int32_t p_dx, int32_t p_dy) const {
+	if (diagonal_mode == DIAGONAL_MODE_ALWAYS || diagonal_mode == DIAGONAL_MODE_AT_LEAST_ONE_WALKABLE) {
+		if (p_dx != 0 && p_dy != 0) {
+			return (_is_walkable(p_x - p_dx, p_y + p_dy) && !_is_walkable(p_x - p_dx, p_y)) || (_is_walkable(p_x + p_dx, p_y - p_dy) && !_is_walkable(p_x, p_y - p_dy));
+		} else if (p_dx != 0) {
+			return (_is_walkable(p_x + p_dx, p_y + 1) && !_is_walkable(p_x, p_y + 1)) || (_is_walkable(p_x + p_dx, p_y - 1) && !_is_walkable(p_x, p_y - 1));
+		}
+		return (_is_walkable(p_x + 1, p_y + p_dy) && !_is_walkable(p_x + 1, p_y)) || (_is_walkable(p_x - 1, p_y + p_dy) && !_is_walkable(p_x - 1, p_y));
+	} else if (diagonal_mode == DIAGONAL_MODE_ONLY_IF_NO_OBSTACLES) {
+		if (p_dx != 0 && p_dy != 0) {
+			return (_is_walkable(p_x + p_dx, p_y + p_dy) && !_is_walkable(p_x, p_y + p_dy)) || !_is_walkable(p_x + p_dx, p_y);
+		} else if (p_dx != 0) {
+			return (_is_walkable(p_x, p_y + 1) && !_is_walkable(p_x - p_dx, p_y + 1)) || (_is_walkable(p_x, p_y - 1) && !_is_walkable(p_x - p_dx, p_y - 1));
+		}
+		return (_is_walkable(p_x + 1, p_y) && !_is_walkable(p_x + 1, p_y - p_dy)) || (_is_walkable(p_x - 1, p_y) && !_is_walkable(p_x - 1, p_y - p_dy));
+	}
+	// DIAGONAL_MODE_NEVER
+	if (p_dx != 0) {
+		return (_is_walkable(p_x, p_y - 1) && !_is_walkable(p_x - p_dx, p_y - 1)) || (_is_walkable(p_x, p_y + 1) && !_is_walkable(p_x - p_dx, p_y + 1));
+	}
+	return (_is_walkable(p_x - 1, p_y) && !_is_walkable(p_x - 1, p_y - p_dy)) || (_is_walkable(p_x + 1, p_y) && !_is_walkable(p_x + 1, p_y - p_dy));
+}
+
+bool AStarGrid2D::_can_jump_continue(int32_t p_x, int32_t p_y, int32_t p_dx, int32_t p_dy) const {
+	if (!_is_walkable(p_x + p_dx, p_y + p_dy)) {
+		return false;
+	}
+	if (p_dx == 0 || p_dy == 0) {
+		return true;
+	}
+	if (diagonal_mode == DIAGONAL_MODE_ALWAYS) {
+		return true;
+	} else if (diagonal_mode == DIAGONAL_MODE_AT_LEAST_ONE_WALKABLE) {
+		return _is_walkable(p_x + p_dx, p_y) || _is_walkable(p_x, p_y + p_dy);
+	}
+	return _is_walkable(p_x + p_dx, p_y) && _is_walkable(p_x, p_y + p_dy);
+}
+
+bool AStarGrid2D::_has_jump_sub_direction(int32_t p_dx, int32_t p_dy, int32_t p_sub_dx, int32_t p_sub_dy) const {
+	// Diagonal jumps also jump along their straight components, vertical jumps without diagonals also jump horizontally.
+	if (p_dx != 0 && p_dy != 0) {
+		return (p_sub_dx == p_dx && p_sub_dy == 0) || (p_sub_dx == 0 && p_sub_dy == p_dy);
+	}
+	return diagonal_mode == DIAGONAL_MODE_NEVER && p_dx == 0 && p_sub_dy == 0;
+}
+
+bool AStarGrid2D::_jump_table_has_jump_point(int32_t p_x, int32_t p_y, int32_t p_dx, int32_t p_dy) const {
+	if (!_is_walkable(p_x, p_y)) {
+		return false;
+	}
+	const uint32_t direction = _get_jump_direction(p_dx, p_dy);
+	int16_t value = _get_jump_table_value(p_x, p_y, direction);
+	while (value == JUMP_TABLE_SATURATED) {
+		p_x += p_dx * JUMP_TABLE_MAX_STEPS;
+		p_y += p_dy * JUMP_TABLE_MAX_STEPS;
+		value = _get_jump_table_value(p_x, p_y, direction);
+	}
+	return value >= 0;
+}
+
+int16_t AStarGrid2D::_compute_jump_table_value(int32_t p_x, int32_t p_y, int32_t p_dx, int32_t p_dy) const {
+	if (_is_solid_unchecked(p_x, p_y)) {
+		return -1;
+	}
+	if (_is_jump_forced(p_x, p_y, p_dx, p_dy)) {
+		return 0;
+	}
+	if (p_dx != 0 && p_dy != 0) {
+		if (_jump_table_has_jump_point(p_x + p_dx, p_y, p_dx, 0) || _jump_table_has_jump_point(p_x, p_y + p_dy, 0, p_dy)) {
+			return 0;
+		}
+	} else if (diagonal_mode == DIAGONAL_MODE_NEVER && p_dy != 0) {
+		if (_jump_table_has_jump_point(p_x + 1, p_y, 1, 0) || _jump_table_has_jump_point(p_x - 1, p_y, -1, 0)) {
+			return 0;
+		}
+	}
+	if (!_can_jump_continue(p_x, p_y, p_dx, p_dy)) {
+		return -2;
+	}
+
+	const int16_t next = _get_jump_table_value(p_x + p_dx, p_y + p_dy, _get_jump_direction(p_dx, p_dy));
+	if (next == JUMP_TABLE_SATURATED) {
+		return JUMP_TABLE_SATURATED;
+	} else if (next >= 0) {
+		return next + 1 < JUMP_TABLE_MAX_STEPS ? next + 1 : JUMP_TABLE_SATURATED;
+	}
+	return next - 1 >= -JUMP_TABLE_MAX_STEPS - 1 ? next - 1 : JUMP_TABLE_SATURATED;
+}
+
+void AStarGrid2D::_invalidate_jump_table(const Rect2i &p_region) {
+	if (jump_table_dirty_region.has_area()) {
+		jump_table_dirty_region = jump_table_dirty_region.merge(p_region);
+	} else {
+		jump_table_dirty_region = p_region;
+	}
+}
+
+void AStarGrid2D::_update_jump_table() {
+	const uint32_t table_size = region.size.x * region.size.y * 8;
+	if (jump_table.size() != table_size) {
+		jump_table.resize(table_size);
+		jump_table_dirty_region = region;
+	}
+	if (!jump_table_dirty_region.has_area()) {
+		return;
+	}
+
+	// A point only affects the jumps passing next to it, so only the values behind the dirty region in each direction change.
+	const Rect2i dirty_region = jump_table_dirty_region.grow(1).intersection(region);
+	jump_table_dirty_region = Rect2i();
+
+	// Straight directions first, the diagonal ones depend on them.
+	static const Vector2i directions[8] = {
+		Vector2i(1, 0),
+		Vector2i(-1, 0),
+		Vector2i(0, 1),
+		Vector2i(0, -1),
+		Vector2i(1, 1),
+		Vector2i(-1, 1),
+		Vector2i(1, -1),
+		Vector2i(-1, -1),
+	};
+	const uint32_t direction_count = diagonal_mode == DIAGONAL_MODE_NEVER ? 4 : 8;
+
+	for (uint32_t i = 0; i < direction_count; i++) {
+		const Vector2i &d = directions[i];
+		const uint32_t direction = _get_jump_direction(d.x, d.y);
+
+		int32_t begin_x = dirty_region.position.x;
+		int32_t end_x = dirty_region.get_end().x;
+		if (d.x > 0) {
+			begin_x = region.position.x;
+		} else if (d.x < 0) {
+			end_x = region.get_end().x;
+		} else if (diagonal_mode == DIAGONAL_MODE_NEVER) {
+			// Vertical jumps depend on the horizontal ones from their sides.
+			begin_x = region.position.x;
+			end_x = region.get_end().x;
+		}
+
+		int32_t begin_y = dirty_region.position.y;
+		int32_t end_y = dirty_region.get_end().y;
+		if (d.y > 0) {
+			begin_y = region.position.y;
+		} else if (d.y < 0) {
+			end_y = region.get_end().y;
+		}
+
+		// Walk against the direction so the next point along it is always up to date.
+		for (int32_t row = 0; row < end_y - begin_y; row++) {
+			const int32_t y = d.y > 0 ? end_y - 1 - row : begin_y + row;
+			for (int32_t column = 0; column < end_x - begin_x; column++) {
+				const int32_t x = d.x > 0 ? end_x - 1 - column : begin_x + column;
+				jump_table[_get_point_index(x, y) * 8 + direction] = _compute_jump_table_value(x, y, d.x, d.y);
+			}
+		}
+	}
+}
+
+int32_t AStarGrid2D::_get_jump_end_step(int32_t p_x, int32_t p_y, int32_t p_dx, int32_t p_dy, int32_t p_last_step) {
+	// The end point stops a jump when it is on the jump, or on a jump along a sub direction from it.
+	int32_t end_step = -1;
+	for (int axis = 0; axis < 2; axis++) {
+		// Step at which the jump reaches the end point's column (axis 0) or row (axis 1).
+		int32_t step;
+		if (axis == 0) {
+			if (p_dx == 0) {
+				continue;
+			}
+			step = (end->id.x - p_x) * p_dx;
+		} else {
+			if (p_dy == 0) {
+				continue;
+			}
+			step = (end->id.y - p_y) * p_dy;
+		}
+		if (step < 0 || step > p_last_step || (end_step >= 0 && step >= end_step)) {
+			continue;
+		}
+
+		const int32_t x = p_x + p_dx * step;
+		const int32_t y = p_y + p_dy * step;
+		const int32_t sub_dx = SIGN(end->id.x - x);
+		const int32_t sub_dy = SIGN(end->id.y - y);
+		if (sub_dx == 0 && sub_dy == 0) {
+			end_step = step;
+		} else if ((sub_dx == 0 || sub_dy == 0) && _has_jump_sub_direction(p_dx, p_dy, sub_dx, sub_dy) && _jump_precomputed(x + sub_dx, y + sub_dy, sub_dx, sub_dy) != nullptr) {
+			end_step = step;
+		}
+	}
+	return end_step;
+}
+
+AStarGrid2D::Point *AStarGrid2D::_jump_precomputed(int32_t p_x, int32_t p_y, int32_t p_dx, int32_t p_dy) {
+	if (!_is_walkable(p_x, p_y)) {
+		return nullptr;
+	}
+
+	const uint32_t direction = _get_jump_direction(p_dx, p_dy);
+	while (true) {
+		const int16_t value = _get_jump_table_value(p_x, p_y, direction);
+
+		int32_t jump_step = -1;
+		int32_t last_step; // Last step walked by the jump.
+		if (value == JUMP_TABLE_SATURATED) {
+			last_step = JUMP_TABLE_MAX_STEPS - 1;
+		} else if (value >= 0) {
+			jump_step = value;
+			last_step = value;
+		} else {
+			last_step = -value - 2;
+		}
+
+		const int32_t end_step = _get_jump_end_step(p_x, p_y, p_dx, p_dy, last_step);
+		if (end_step >= 0 && (jump_step < 0 || end_step < jump_step)) {
+			jump_step = end_step;
+		}
+		if (jump_step >= 0) {
+			return _get_point_unchecked(p_x + p_dx * jump_step, p_y + p_dy * jump_step);
+		}
+		if (value != JUMP_TABLE_SATURATED) {
+			return nullptr;
+		}
+		p_x += p_dx * JUMP_TABLE_MAX_STEPS;
+		p_y += p_dy * JUMP_TABLE_MAX_STEPS;
+	}
+}
+
 void AStarGrid2D::_get_nbors(Point *p_point, LocalVector<Point *> &r_nbors) {
 	bool ts0 = false, td0 = false,
 		 ts1 = false, td1 = false,
@@ -394,19 +671,19 @@ void AStarGrid2D::_get_nbors(Point *p_point, LocalVector<Point *> &r_nbors) {
 		}
 	}
 
-	if (top && !top->solid) {
+	if (top && !_is_point_solid(top)) {
 		r_nbors.push_back(top);
 		ts0 = true;
 	}
-	if (right && !right->solid) {
+	if (right && !_is_point_solid(right)) {
 		r_nbors.push_back(right);
 		ts1 = true;
 	}
-	if (bottom && !bottom->solid) {
+	if (bottom && !_is_point_solid(bottom)) {
 		r_nbors.push_back(bottom);
 		ts2 = true;
 	}
-	if (left && !left->solid) {
+	if (left && !_is_point_solid(left)) {
 		r_nbors.push_back(left);
 		ts3 = true;
 	}
@@ -436,16 +713,16 @@ void AStarGrid2D::_get_nbors(Point *p_point, LocalVector<Point *> &r_nbors) {
 			break;
 	}
 
-	if (td0 && (top_left && !top_left->solid)) {
+	if (td0 && (top_left && !_is_point_solid(top_left))) {
 		r_nbors.push_back(top_left);
 	}
-	if (td1 && (top_right && !top_right->solid)) {
+	if (td1 && (top_right && !_is_point_solid(top_right))) {
 		r_nbors.push_back(top_right);
 	}
-	if (td2 && (bottom_right && !bottom_right->solid)) {
+	if (td2 && (bottom_right && !_is_point_solid(bottom_right))) {
 		r_nbors.push_back(bottom_right);
 	}
-	if (td3 && (bottom_left && !bottom_left->solid)) {
+	if (td3 && (bottom_left && !_is_point_solid(bottom_left))) {
 		r_nbors.push_back(bottom_left);
 	}
 }
@@ -453,11 +730,23 @@ void AStarGrid2D::_get_nbors(Point *p_point, LocalVector<Point *> &r_nbors) {
 bool AStarGrid2D::_solve(Point *p_begin_point, Point *p_end_point) {
 	last_closest_point = nullptr;
 	pass++;
+	if (unlikely(pass == 0)) {
+		// The pass wrapped around, points marked in an old pass could look open or closed.
+		for (Point &point : points) {
+			point.open_pass = 0;
+			point.closed_pass = 0;
+		}
+		pass = 1;
+	}
 
-	if (p_end_point->solid) {
+	if (_is_point_solid(p_end_point)) {
 		return false;
 	}
 
+	if (jumping_enabled && jump_table_enabled) {
+		_update_jump_table();
+	}
+
 	bool found_route = false;
 
 	LocalVector<Point *> open_list;
@@ -465,8 +754,6 @@ bool AStarGrid2D::_solve(Point *p_begin_point, Point *p_end_point) {
 
 	p_begin_point->g_score = 0;
 	p_begin_point->f_score = _estimate_cost(p_begin_point->id, p_end_point->id);
-	p_begin_point->abs_g_score = 0;
-	p_begin_point->abs_f_score = _estimate_cost(p_begin_point->id, p_end_point->id);
 	open_list.push_back(p_begin_point);
 	end = p_end_point;
 
@@ -474,7 +761,8 @@ bool AStarGrid2D::_solve(Point *p_begin_point, Point *p_end_point) {
 		Point *p = open_list[0]; // The currently processed point.
 
 		// Find point closer to end_point, or same distance to end_point but closer to begin_point.
-		if (last_closest_point == nullptr || last_closest_point->abs_f_score > p->abs_f_score || (last_closest_point->abs_f_score >= p->abs_f_score && last_closest_point->abs_g_score > p->abs_g_score)) {
+		// The estimated distance to end_point is the difference between the f and g scores.
+		if (last_closest_point == nullptr || last_closest_point->f_score - last_closest_point->g_score > p->f_score - p->g_score || (last_closest_point->f_score - last_closest_point->g_score >= p->f_score - p->g_score && last_closest_point->g_score > p->g_score)) {
 			last_closest_point = p;
 		}
 
@@ -495,12 +783,12 @@ bool AStarGrid2D::_solve(Point *p_begin_point, Point *p_end_point) {
 
 			if (jumping_enabled) {
 				// TODO: Make it works with weight_scale.
-				e = _jump(p, e);
+				e = jump_table_enabled ? _jump_precomputed(e->id.x, e->id.y, e->id.x - p->id.x, e->id.y - p->id.y) : _jump(p, e);
 				if (!e || e->closed_pass == pass) {
 					continue;
 				}
 			} else {
-				if (e->solid || e->closed_pass == pass) {
+				if (_is_point_solid(e) || e->closed_pass == pass) {
 					continue;
 				}
 				weight_scale = e->weight_scale;
@@ -521,9 +809,6 @@ bool AStarGrid2D::_solve(Point *p_begin_point, Point *p_end_point) {
 			e->g_score = tentative_g_score;
 			e->f_score = e->g_score + _estimate_cost(e->id, p_end_point->id);
 
-			e->abs_g_score = tentative_g_score;
-			e->abs_f_score = e->f_score - e->g_score;
-
 			if (new_point) { // The position of the new points is already known.
 				sorter.push_heap(0, open_list.size() - 1, 0, e, open_list.ptr());
 			} else {
@@ -553,7 +838,12 @@ real_t AStarGrid2D::_compute_cost(const Vector2i &p_from_id, const Vector2i &p_t
 
 void AStarGrid2D::clear() {
 	points.clear();
+	solid_mask.clear();
+	jump_table.clear();
 	region = Rect2i();
+	jump_table_dirty_region = Rect2i();
+	flow_fields.clear();
+	flow_field_version++;
 }
 
 Vector2 AStarGrid2D::get_point_position(const Vector2i &p_id) const {
@@ -575,12 +865,13 @@ TypedArray<Dictionary> AStarGrid2D::get_point_data_in_region(const Rect2i &p_reg
 
 	for (int32_t y = start_y; y < end_y; y++) {
 		for (int32_t x = start_x; x < end_x; x++) {
-			const Point &p = points[y][x];
+			const Point &p = points[y * region.size.x + x];
+			const bool solid = _is_point_solid(&p);
 
 			Dictionary dict;
 			dict["id"] = p.id;
 			dict["position"] = p.pos;
-			dict["solid"] = p.solid;
+			dict["solid"] = solid;
 			dict["weight_scale"] = p.weight_scale;
 			data.push_back(dict);
 		}
@@ -693,6 +984,163 @@ TypedArray<Vector2i> AStarGrid2D::get_id_path(const Vector2i &p_from_id, const V
 	return path;
 }
 
+void AStarGrid2D::_compute_flow_field(const Vector2i &p_target, FlowField &r_flow_field) {
+	const uint32_t point_count = region.size.x * region.size.y;
+	r_flow_field.version = flow_field_version;
+	r_flow_field.costs.resize(point_count);
+	r_flow_field.directions.resize(point_count);
+	for (uint32_t i = 0; i < point_count; i++) {
+		r_flow_field.costs[i] = INFINITY;
+		r_flow_field.directions[i] = FLOW_FIELD_NO_DIRECTION;
+	}
+
+	if (!is_in_boundsv(p_target) || _is_solid_unchecked(p_target.x, p_target.y)) {
+		return;
+	}
+
+	// Dijkstra from the target, the neighbors of a point are also the points that can move to it.
+	LocalVector<FlowFieldNode> open_list;
+	SortArray<FlowFieldNode, SortFlowFieldNodes> sorter;
+	LocalVector<Point *> nbors;
+
+	const uint32_t target_index = _get_point_index(p_target.x, p_target.y);
+	r_flow_field.costs[target_index] = 0;
+	open_list.push_back({ 0, target_index });
+
+	while (!open_list.is_empty()) {
+		const FlowFieldNode node = open_list[0];
+		sorter.pop_heap(0, open_list.size(), open_list.ptr());
+		open_list.remove_at(open_list.size() - 1);
+		if (node.cost > r_flow_field.costs[node.index]) {
+			continue; // Already reached with a lower cost.
+		}
+
+		Point *p = _get_point_unchecked(region.position.x + node.index % region.size.x, region.position.y + node.index / region.size.x);
+
+		nbors.clear();
+		_get_nbors(p, nbors);
+
+		for (Point *e : nbors) {
+			// Moving from the neighbor enters this point.
+			const float cost = node.cost + _compute_cost(e->id, p->id) * p->weight_scale;
+			const uint32_t index = _get_point_index(e->id.x, e->id.y);
+			if (cost < r_flow_field.costs[index]) {
+				r_flow_field.costs[index] = cost;
+				r_flow_field.directions[index] = _get_jump_direction(p->id.x - e->id.x, p->id.y - e->id.y);
+				open_list.push_back({ cost, index });
+				sorter.push_heap(0, open_list.size() - 1, 0, open_list[open_list.size() - 1], open_list.ptr());
+			}
+		}
+	}
+}
+
+void AStarGrid2D::_update_flow_field_task(uint32_t p_index, FlowFieldUpdate *p_updates) {
+	_compute_flow_field(p_updates[p_index].target, *p_updates[p_index].flow_field);
+}
+
+AStarGrid2D::FlowField &AStarGrid2D::_get_cached_flow_field(const Vector2i &p_target, uint64_t p_keep_since) {
+	FlowField *flow_field = flow_fields.getptr(p_target);
+	if (!flow_field) {
+		// Fields used since p_keep_since are still referenced, the cache grows past the cap rather than freeing them.
+		while (flow_fields.size() >= FLOW_FIELD_CACHE_MAX) {
+			Vector2i least_recently_used;
+			uint64_t least_recent_use = UINT64_MAX;
+			for (const KeyValue<Vector2i, FlowField> &E : flow_fields) {
+				if (E.value.last_used < least_recent_use) {
+					least_recently_used = E.key;
+					least_recent_use = E.value.last_used;
+				}
+			}
+			if (least_recent_use >= p_keep_since) {
+				break;
+			}
+			flow_fields.erase(least_recently_used);
+		}
+		flow_field = &flow_fields[p_target];
+	}
+	flow_field->last_used = flow_field_tick;
+	return *flow_field;
+}
+
+const AStarGrid2D::FlowField &AStarGrid2D::_get_flow_field(const Vector2i &p_target) {
+	flow_field_tick++;
+	FlowField &flow_field = _get_cached_flow_field(p_target, flow_field_tick);
+	if (flow_field.version != flow_field_version) {
+		_compute_flow_field(p_target, flow_field);
+	}
+	return flow_field;
+}
+
+void AStarGrid2D::update_flow_fields(const TypedArray<Vector2i> &p_targets) {
+	ERR_FAIL_COND_MSG(dirty, "Grid is not initialized. Call the update method.");
+
+	flow_field_tick++;
+	LocalVector<FlowFieldUpdate> updates;
+	for (int i = 0; i < p_targets.size(); i++) {
+		const Vector2i target = p_targets[i];
+		ERR_CONTINUE_MSG(!is_in_boundsv(target), vformat("Can't update flow field. Point %s out of bounds %s.", target, region));
+		FlowField &flow_field = _get_cached_flow_field(target, flow_field_tick);
+		if (flow_field.version != flow_field_version) {
+			flow_field.version = flow_field_version; // Also skips duplicated targets.
+			updates.push_back({ target, &flow_field });
+		}
+	}
+
+	// Overridden cost functions are not safe to call from several threads at once.
+	if (updates.size() < 2 || GDVIRTUAL_IS_OVERRIDDEN(_compute_cost)) {
+		for (uint32_t i = 0; i < updates.size(); i++) {
+			_update_flow_field_task(i, updates.ptr());
+		}
+	} else {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &AStarGrid2D::_update_flow_field_task, updates.ptr(), updates.size(), -1, true, SNAME("AStarGrid2DFlowFields"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	}
+}
+
+PackedFloat32Array AStarGrid2D::get_flow_field_costs(const Vector2i &p_target) {
+	ERR_FAIL_COND_V_MSG(dirty, PackedFloat32Array(), "Grid is not initialized. Call the update method.");
+	ERR_FAIL_COND_V_MSG(!is_in_boundsv(p_target), PackedFloat32Array(), vformat("Can't get flow field. Point %s out of bounds %s.", p_target, region));
+
+	const FlowField &flow_field = _get_flow_field(p_target);
+
+	PackedFloat32Array costs;
+	costs.resize(flow_field.costs.size());
+	memcpy(costs.ptrw(), flow_field.costs.ptr(), flow_field.costs.size() * sizeof(float));
+	return costs;
+}
+
+PackedVector2Array AStarGrid2D::get_flow_field_directions(const Vector2i &p_target) {
+	ERR_FAIL_COND_V_MSG(dirty, PackedVector2Array(), "Grid is not initialized. Call the update method.");
+	ERR_FAIL_COND_V_MSG(!is_in_boundsv(p_target), PackedVector2Array(), vformat("Can't get flow field. Point %s out of bounds %s.", p_target, region));
+
+	const FlowField &flow_field = _get_flow_field(p_target);
+
+	PackedVector2Array directions;
+	directions.resize(flow_field.directions.size());
+	Vector2 *w = directions.ptrw();
+	for (uint32_t i = 0; i < flow_field.directions.size(); i++) {
+		const uint8_t direction = flow_field.directions[i];
+		w[i] = direction == FLOW_FIELD_NO_DIRECTION ? Vector2() : Vector2(neighbor_offsets[direction]);
+	}
+	return directions;
+}
+
+Vector2i AStarGrid2D::get_flow_field_next_point(const Vector2i &p_target, const Vector2i &p_id) {
+	ERR_FAIL_COND_V_MSG(dirty, p_id, "Grid is not initialized. Call the update method.");
+	ERR_FAIL_COND_V_MSG(!is_in_boundsv(p_target), p_id, vformat("Can't get flow field. Point %s out of bounds %s.", p_target, region));
+	ERR_FAIL_COND_V_MSG(!is_in_boundsv(p_id), p_id, vformat("Can't get flow field next point. Point %s out of bounds %s.", p_id, region));
+
+	const uint8_t direction = _get_flow_field(p_target).directions[_get_point_index(p_id.x, p_id.y)];
+	if (direction == FLOW_FIELD_NO_DIRECTION) {
+		return p_id;
+	}
+	return p_id + neighbor_offsets[direction];
+}
+
+void AStarGrid2D::clear_flow_fields() {
+	flow_fields.clear();
+}
+
 void AStarGrid2D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_region", "region"), &AStarGrid2D::set_region);
 	ClassDB::bind_method(D_METHOD("get_region"), &AStarGrid2D::get_region);
@@ -710,6 +1158,8 @@ void AStarGrid2D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("update"), &AStarGrid2D::update);
 	ClassDB::bind_method(D_METHOD("set_jumping_enabled", "enabled"), &AStarGrid2D::set_jumping_enabled);
 	ClassDB::bind_method(D_METHOD("is_jumping_enabled"), &AStarGrid2D::is_jumping_enabled);
+	ClassDB::bind_method(D_METHOD("set_jump_table_enabled", "enabled"), &AStarGrid2D::set_jump_table_enabled);
+	ClassDB::bind_method(D_METHOD("is_jump_table_enabled"), &AStarGrid2D::is_jump_table_enabled);
 	ClassDB::bind_method(D_METHOD("set_diagonal_mode", "mode"), &AStarGrid2D::set_diagonal_mode);
 	ClassDB::bind_method(D_METHOD("get_diagonal_mode"), &AStarGrid2D::get_diagonal_mode);
 	ClassDB::bind_method(D_METHOD("set_default_compute_heuristic", "heuristic"), &AStarGrid2D::set_default_compute_heuristic);
@@ -729,6 +1179,12 @@ void AStarGrid2D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_point_path", "from_id", "to_id", "allow_partial_path"), &AStarGrid2D::get_point_path, DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("get_id_path", "from_id", "to_id", "allow_partial_path"), &AStarGrid2D::get_id_path, DEFVAL(false));
 
+	ClassDB::bind_method(D_METHOD("update_flow_fields", "targets"), &AStarGrid2D::update_flow_fields);
+	ClassDB::bind_method(D_METHOD("get_flow_field_costs", "target"), &AStarGrid2D::get_flow_field_costs);
+	ClassDB::bind_method(D_METHOD("get_flow_field_directions", "target"), &AStarGrid2D::get_flow_field_directions);
+	ClassDB::bind_method(D_METHOD("get_flow_field_next_point", "target", "id"), &AStarGrid2D::get_flow_field_next_point);
+	ClassDB::bind_method(D_METHOD("clear_flow_fields"), &AStarGrid2D::clear_flow_fields);
+
 	GDVIRTUAL_BIND(_estimate_cost, "from_id", "end_id")
 	GDVIRTUAL_BIND(_compute_cost, "from_id", "to_id")
 
@@ -739,6 +1195,7 @@ void AStarGrid2D::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "cell_shape", PROPERTY_HINT_ENUM, "Square,IsometricRight,IsometricDown"), "set_cell_shape", "get_cell_shape");
 
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "jumping_enabled"), "set_jumping_enabled", "is_jumping_enabled");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "jump_table_enabled"), "set_jump_table_enabled", "is_jump_table_enabled");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "default_compute_heuristic", PROPERTY_HINT_ENUM, "Euclidean,Manhattan,Octile,Chebyshev"), "set_default_compute_heuristic", "get_default_compute_heuristic");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "default_estimate_heuristic", PROPERTY_HINT_ENUM, "Euclidean,Manhattan,Octile,Chebyshev"), "set_default_estimate_heuristic", "get_default_estimate_heuristic");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "diagonal_mode", PROPERTY_HINT_ENUM, "Never,Always,At Least One Walkable,Only If No Obstacles"), "set_diagonal_mode", "get_diagonal_mode");
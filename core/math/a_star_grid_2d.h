@@ -33,6 +33,7 @@
 
 #include "core/object/gdvirtual.gen.inc"
 #include "core/object/ref_counted.h"
+#include "core/templates/hash_map.h"
 #include "core/templates/list.h"
 #include "core/templates/local_vector.h"
 
@@ -71,27 +72,24 @@ private:
 	CellShape cell_shape = CELL_SHAPE_SQUARE;
 
 	bool jumping_enabled = false;
+	bool jump_table_enabled = false;
 	DiagonalMode diagonal_mode = DIAGONAL_MODE_ALWAYS;
 	Heuristic default_compute_heuristic = HEURISTIC_EUCLIDEAN;
 	Heuristic default_estimate_heuristic = HEURISTIC_EUCLIDEAN;
 
+	// Solidity is kept in `solid_mask`, and the passes are 32-bit, to keep points small on large grids.
 	struct Point {
 		Vector2i id;
 
-		bool solid = false;
 		Vector2 pos;
-		real_t weight_scale = 1.0;
 
 		// Used for pathfinding.
 		Point *prev_point = nullptr;
+		real_t weight_scale = 1.0;
 		real_t g_score = 0;
 		real_t f_score = 0;
-		uint64_t open_pass = 0;
-		uint64_t closed_pass = 0;
-
-		// Used for getting last_closest_point.
-		real_t abs_g_score = 0;
-		real_t abs_f_score = 0;
+		uint32_t open_pass = 0;
+		uint32_t closed_pass = 0;
 
 		Point() {}
 
@@ -111,41 +109,120 @@ private:
 		}
 	};
 
-	LocalVector<LocalVector<Point>> points;
+	LocalVector<Point> points; // Row by row, indexed with _get_point_index().
+	LocalVector<uint64_t> solid_mask; // One bit per point, row by row.
 	Point *end = nullptr;
 	Point *last_closest_point = nullptr;
 
-	uint64_t pass = 1;
+	uint32_t pass = 1;
+
+	// JPS+ table, for each point and direction the steps to the next jump point ignoring the end point.
+	// Positive values are the steps to the jump point, negative values are -2 minus the steps walked before the jump hits an obstacle.
+	static constexpr int16_t JUMP_TABLE_SATURATED = INT16_MIN; // No jump point in the next JUMP_TABLE_MAX_STEPS steps.
+	static constexpr int32_t JUMP_TABLE_MAX_STEPS = 16384;
+	LocalVector<int16_t> jump_table;
+	Rect2i jump_table_dirty_region;
+
+	// Cost to reach the target and direction to move in from every point.
+	static constexpr uint8_t FLOW_FIELD_NO_DIRECTION = UINT8_MAX;
+	struct FlowField {
+		uint64_t version = 0;
+		uint64_t last_used = 0;
+		LocalVector<float> costs;
+		LocalVector<uint8_t> directions;
+	};
+	struct FlowFieldUpdate {
+		Vector2i target;
+		FlowField *flow_field = nullptr;
+	};
+	struct FlowFieldNode {
+		float cost = 0;
+		uint32_t index = 0;
+	};
+	struct SortFlowFieldNodes {
+		_FORCE_INLINE_ bool operator()(const FlowFieldNode &A, const FlowFieldNode &B) const { // Returns true when the node A is worse than node B.
+			return A.cost > B.cost;
+		}
+	};
+	// Fields of the most recently used targets, the least recently used ones are freed past the cap.
+	static constexpr uint32_t FLOW_FIELD_CACHE_MAX = 32;
+	HashMap<Vector2i, FlowField> flow_fields;
+	uint64_t flow_field_version = 1; // Increased whenever the costs of the grid change.
+	uint64_t flow_field_tick = 0;
 
 private: // Internal routines.
+	_FORCE_INLINE_ uint32_t _get_point_index(int32_t p_x, int32_t p_y) const {
+		return (p_y - region.position.y) * region.size.x + (p_x - region.position.x);
+	}
+
+	_FORCE_INLINE_ bool _is_solid_unchecked(int32_t p_x, int32_t p_y) const {
+		const uint32_t index = _get_point_index(p_x, p_y);
+		return (solid_mask[index >> 6] >> (index & 63)) & 1;
+	}
+
+	_FORCE_INLINE_ bool _is_point_solid(const Point *p_point) const {
+		return _is_solid_unchecked(p_point->id.x, p_point->id.y);
+	}
+
+	_FORCE_INLINE_ void _set_solid_unchecked(int32_t p_x, int32_t p_y, bool p_solid) {
+		const uint32_t index = _get_point_index(p_x, p_y);
+		if (p_solid) {
+			solid_mask[index >> 6] |= uint64_t(1) << (index & 63);
+		} else {
+			solid_mask[index >> 6] &= ~(uint64_t(1) << (index & 63));
+		}
+	}
+
 	_FORCE_INLINE_ bool _is_walkable(int32_t p_x, int32_t p_y) const {
 		if (region.has_point(Vector2i(p_x, p_y))) {
-			return !points[p_y - region.position.y][p_x - region.position.x].solid;
+			return !_is_solid_unchecked(p_x, p_y);
 		}
 		return false;
 	}
 
 	_FORCE_INLINE_ Point *_get_point(int32_t p_x, int32_t p_y) {
 		if (region.has_point(Vector2i(p_x, p_y))) {
-			return &points[p_y - region.position.y][p_x - region.position.x];
+			return &points[_get_point_index(p_x, p_y)];
 		}
 		return nullptr;
 	}
 
 	_FORCE_INLINE_ Point *_get_point_unchecked(int32_t p_x, int32_t p_y) {
-		return &points[p_y - region.position.y][p_x - region.position.x];
+		return &points[_get_point_index(p_x, p_y)];
 	}
 
 	_FORCE_INLINE_ Point *_get_point_unchecked(const Vector2i &p_id) {
-		return &points[p_id.y - region.position.y][p_id.x - region.position.x];
+		return &points[_get_point_index(p_id.x, p_id.y)];
 	}
 
 	_FORCE_INLINE_ const Point *_get_point_unchecked(const Vector2i &p_id) const {
-		return &points[p_id.y - region.position.y][p_id.x - region.position.x];
+		return &points[_get_point_index(p_id.x, p_id.y)];
 	}
 
 	void _get_nbors(Point *p_point, LocalVector<Point *> &r_nbors);
 	Point *_jump(Point *p_from, Point *p_to);
+
+	_FORCE_INLINE_ static uint32_t _get_jump_direction(int32_t p_dx, int32_t p_dy) {
+		const uint32_t direction = (p_dy + 1) * 3 + (p_dx + 1);
+		return direction > 4 ? direction - 1 : direction;
+	}
+	_FORCE_INLINE_ int16_t _get_jump_table_value(int32_t p_x, int32_t p_y, uint32_t p_direction) const {
+		return jump_table[_get_point_index(p_x, p_y) * 8 + p_direction];
+	}
+	bool _is_jump_forced(int32_t p_x, int32_t p_y, int32_t p_dx, int32_t p_dy) const;
+	bool _can_jump_continue(int32_t p_x, int32_t p_y, int32_t p_dx, int32_t p_dy) const;
+	bool _has_jump_sub_direction(int32_t p_dx, int32_t p_dy, int32_t p_sub_dx, int32_t p_sub_dy) const;
+	bool _jump_table_has_jump_point(int32_t p_x, int32_t p_y, int32_t p_dx, int32_t p_dy) const;
+	int16_t _compute_jump_table_value(int32_t p_x, int32_t p_y, int32_t p_dx, int32_t p_dy) const;
+	void _invalidate_jump_table(const Rect2i &p_region);
+	void _update_jump_table();
+	int32_t _get_jump_end_step(int32_t p_x, int32_t p_y, int32_t p_dx, int32_t p_dy, int32_t p_last_step);
+	Point *_jump_precomputed(int32_t p_x, int32_t p_y, int32_t p_dx, int32_t p_dy);
+
+	void _compute_flow_field(const Vector2i &p_target, FlowField &r_flow_field);
+	void _update_flow_field_task(uint32_t p_index, FlowFieldUpdate *p_updates);
+	FlowField &_get_cached_flow_field(const Vector2i &p_target, uint64_t p_keep_since);
+	const FlowField &_get_flow_field(const Vector2i &p_target);
 	bool _solve(Point *p_begin_point, Point *p_end_point);
 
 protected:
@@ -188,6 +265,9 @@ public:
 	void set_jumping_enabled(bool p_enabled);
 	bool is_jumping_enabled() const;
 
+	void set_jump_table_enabled(bool p_enabled);
+	bool is_jump_table_enabled() const;
+
 	void set_diagonal_mode(DiagonalMode p_diagonal_mode);
 	DiagonalMode get_diagonal_mode() const;
 
@@ -212,6 +292,12 @@ public:
 	TypedArray<Dictionary> get_point_data_in_region(const Rect2i &p_region) const;
 	Vector<Vector2> get_point_path(const Vector2i &p_from, const Vector2i &p_to, bool p_allow_partial_path = false);
 	TypedArray<Vector2i> get_id_path(const Vector2i &p_from, const Vector2i &p_to, bool p_allow_partial_path = false);
+
+	void update_flow_fields(const TypedArray<Vector2i> &p_targets);
+	PackedFloat32Array get_flow_field_costs(const Vector2i &p_target);
+	PackedVector2Array get_flow_field_directions(const Vector2i &p_target);
+	Vector2i get_flow_field_next_point(const Vector2i &p_target, const Vector2i &p_id);
+	void clear_flow_fields();
 };
 
 VARIANT_ENUM_CAST(AStarGrid2D::DiagonalMode);
@@ -52,6 +52,7 @@
 // and pairable_mask is either 0 if static, or set to all if non static
 
 #include "bvh_tree.h"
+#include "core/object/worker_thread_pool.h"
 #include "core/os/mutex.h"
 
 #define BVHTREE_CLASS BVH_Tree<T, NUM_TREES, 2, MAX_ITEMS, USER_PAIR_TEST_FUNCTION, USER_CULL_TEST_FUNCTION, USE_PAIRS, BOUNDS, POINT>
@@ -71,6 +72,14 @@ public:
 		_thread_safe = p_enable;
 	}
 
+	// When enabled, the tree culls finding the pairing candidates of changed items are
+	// spread over the WorkerThreadPool. Pair / unpair callbacks are still sent from the
+	// calling thread in the same order as the serial path, so results are identical.
+	void params_set_threaded_pairing(bool p_enable) {
+		BVH_LOCKED_FUNCTION
+		_threaded_pairing = p_enable;
+	}
+
 	// these 2 are crucial for fine tuning, and can be applied manually
 	// see the variable declarations for more info.
 	void params_set_node_expansion(real_t p_value) {
@@ -381,6 +390,66 @@ public:
 		return params.result_count_overall;
 	}
 
+	// Same as cull_segment(), but without locking or touching shared cull state,
+	// r_hits is used as scratch instead. Can be called from several threads at once
+	// as long as nothing modifies the BVH meanwhile.
+	int cull_segment_concurrent(const POINT &p_from, const POINT &p_to, T **p_result_array, int p_result_max, const T *p_tester, LocalVector<uint32_t, uint32_t, true> &r_hits, uint32_t p_tree_collision_mask = 0xFFFFFFFF, int *p_subindex_array = nullptr) {
+		typename BVHTREE_CLASS::CullParams params;
+
+		params.result_count_overall = 0;
+		params.result_max = p_result_max;
+		params.result_array = p_result_array;
+		params.subindex_array = p_subindex_array;
+		params.tester = p_tester;
+		params.tree_collision_mask = p_tree_collision_mask;
+
+		params.segment.from = p_from;
+		params.segment.to = p_to;
+
+		tree.cull_segment_to(params, r_hits);
+
+		return params.result_count_overall;
+	}
+
+	// Culls with p_aabb swept along p_motion, which is much tighter than culling
+	// the merged start and end boxes when the motion is long and diagonal.
+	int cull_swept_aabb(const BOUNDS &p_aabb, const POINT &p_motion, T **p_result_array, int p_result_max, const T *p_tester, uint32_t p_tree_collision_mask = 0xFFFFFFFF, int *p_subindex_array = nullptr) {
+		BVH_LOCKED_FUNCTION
+		typename BVHTREE_CLASS::CullParams params;
+
+		params.result_count_overall = 0;
+		params.result_max = p_result_max;
+		params.result_array = p_result_array;
+		params.subindex_array = p_subindex_array;
+		params.tester = p_tester;
+		params.tree_collision_mask = p_tree_collision_mask;
+
+		params.sweep_half_extents = p_aabb.size * 0.5;
+		params.segment.from = p_aabb.position + params.sweep_half_extents;
+		params.segment.to = params.segment.from + p_motion;
+
+		tree.cull_swept_aabb(params);
+
+		return params.result_count_overall;
+	}
+
+	// Same as cull_aabb(), without locking or touching shared cull state, see cull_segment_concurrent().
+	int cull_aabb_concurrent(const BOUNDS &p_aabb, T **p_result_array, int p_result_max, const T *p_tester, LocalVector<uint32_t, uint32_t, true> &r_hits, uint32_t p_tree_collision_mask = 0xFFFFFFFF, int *p_subindex_array = nullptr) {
+		typename BVHTREE_CLASS::CullParams params;
+
+		params.result_count_overall = 0;
+		params.result_max = p_result_max;
+		params.result_array = p_result_array;
+		params.subindex_array = p_subindex_array;
+		params.tree_collision_mask = p_tree_collision_mask;
+		params.abb.from(p_aabb);
+		params.tester = p_tester;
+
+		tree.cull_aabb_to(params, r_hits, true);
+
+		return params.result_count_overall;
+	}
+
 	int cull_point(const POINT &p_point, T **p_result_array, int p_result_max, const T *p_tester, uint32_t p_tree_collision_mask = 0xFFFFFFFF, int *p_subindex_array = nullptr) {
 		BVH_LOCKED_FUNCTION
 		typename BVHTREE_CLASS::CullParams params;
@@ -435,7 +504,16 @@ private:
 			return;
 		}
 
-		BOUNDS bb;
+		// the culls only read the tree, so they can be done up front on threads,
+		// while the pairing itself (and callbacks) remains serial and in order
+		bool threaded = _threaded_pairing && changed_items.size() >= THREADED_PAIRING_MIN_ITEMS;
+		if (threaded) {
+			if (_pairing_hits.size() < changed_items.size()) {
+				_pairing_hits.resize(changed_items.size());
+			}
+			WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &BVH_Manager::_gather_pairing_hits, nullptr, changed_items.size(), -1, true, SNAME("BVHGatherPairingHits"));
+			WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+		}
 
 		typename BVHTREE_CLASS::CullParams params;
 
@@ -444,26 +522,33 @@ private:
 		params.result_array = nullptr;
 		params.subindex_array = nullptr;
 
-		for (const BVHHandle &h : changed_items) {
+		for (uint32_t item_index = 0; item_index < changed_items.size(); item_index++) {
+			const BVHHandle &h = changed_items[item_index];
+
 			// use the expanded aabb for pairing
 			const BOUNDS &expanded_aabb = tree._pairs[h.id()].expanded_aabb;
 			BVHABB_CLASS abb;
 			abb.from(expanded_aabb);
 
-			tree.item_fill_cullparams(h, params);
-
 			// find all the existing paired aabbs that are no longer
 			// paired, and send callbacks
 			_find_leavers(h, abb, p_full_check);
 
 			uint32_t changed_item_ref_id = h.id();
 
-			params.abb = abb;
+			const LocalVector<uint32_t, uint32_t, true> *hits = nullptr;
+			if (threaded) {
+				hits = &_pairing_hits[item_index];
+			} else {
+				tree.item_fill_cullparams(h, params);
+				params.abb = abb;
 
-			params.result_count_overall = 0; // might not be needed
-			tree.cull_aabb(params, false);
+				params.result_count_overall = 0; // might not be needed
+				tree.cull_aabb(params, false);
+				hits = &tree._cull_hits;
+			}
 
-			for (const uint32_t ref_id : tree._cull_hits) {
+			for (const uint32_t ref_id : *hits) {
 				// don't collide against ourself
 				if (ref_id == changed_item_ref_id) {
 					continue;
@@ -480,6 +565,22 @@ private:
 		_reset();
 	}
 
+	void _gather_pairing_hits(uint32_t p_index, void *p_userdata) {
+		const BVHHandle &h = changed_items[p_index];
+
+		typename BVHTREE_CLASS::CullParams params;
+
+		params.result_count_overall = 0;
+		params.result_max = INT_MAX;
+		params.result_array = nullptr;
+		params.subindex_array = nullptr;
+
+		tree.item_fill_cullparams(h, params);
+		params.abb.from(tree._pairs[h.id()].expanded_aabb);
+
+		tree.cull_aabb_to(params, _pairing_hits[p_index]);
+	}
+
 public:
 	void item_get_AABB(BVHHandle p_handle, BOUNDS &r_aabb) {
 		DEV_ASSERT(!p_handle.is_invalid());
@@ -773,6 +874,12 @@ private:
 	LocalVector<BVHHandle, uint32_t, true> changed_items;
 	uint32_t _tick = 1; // Start from 1 so items with 0 indicate never updated.
 
+	// below this number of changed items, the threading overhead outweighs the gain
+	static const uint32_t THREADED_PAIRING_MIN_ITEMS = 64;
+	bool _threaded_pairing = false;
+	// one list of cull hits per changed item, kept around to avoid reallocations
+	LocalVector<LocalVector<uint32_t, uint32_t, true>> _pairing_hits;
+
 	class BVHLockedFunction {
 	public:
 		BVHLockedFunction(Mutex *p_mutex, bool p_thread_safe) {
@@ -202,6 +202,16 @@ struct BVH_ABB {
 		return bb.intersects_segment(p_s.from, p_s.to);
 	}
 
+	// Whether a box with p_half_extents, moving with its center along the
+	// segment, touches this box at any point of the motion.
+	bool intersects_swept(const Segment &p_s, const POINT &p_half_extents) const {
+		BOUNDS bb;
+		to(bb);
+		bb.position -= p_half_extents;
+		bb.size += p_half_extents * 2;
+		return bb.intersects_segment(p_s.from, p_s.to);
+	}
+
 	bool intersects_point(const POINT &p_pt) const {
 		if (_any_lessthan(-p_pt, neg_max)) {
 			return false;
@@ -288,6 +288,7 @@ public:
 	// Methods
 	void clear();
 	bool is_empty() const { return (nullptr == bvh_root); }
+	AABB get_bounds() const { return bvh_root ? AABB(bvh_root->volume.min, bvh_root->volume.get_length()) : AABB(); }
 	void optimize_bottom_up();
 	void optimize_top_down(int bu_threshold = 128);
 	void optimize_incremental(int passes);
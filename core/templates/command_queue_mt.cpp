@@ -33,9 +33,137 @@
 #include "core/config/project_settings.h"
 #include "core/os/os.h"
 
+CommandQueueMT::Producer *CommandQueueMT::_register_producer(Thread::ID p_thread_id) {
+	MutexLock lock(mutex);
+	uint32_t count = producer_count.get();
+	if (count < MAX_PRODUCERS) {
+		Producer &producer = producers[count];
+		producer.thread_id.store(p_thread_id, std::memory_order_relaxed);
+		producer.state.store(PRODUCER_PUSHING, std::memory_order_relaxed);
+		producer.write_block = memnew(ProducerBlock);
+		producer.read_block = producer.write_block;
+		producer_count.set(count + 1);
+		return &producer;
+	}
+
+	// All slots are taken, most likely by threads that have exited already.
+	// Take over one that isn't being pushed to right now.
+	while (true) {
+		Producer &producer = producers[producer_steal_index];
+		producer_steal_index = (producer_steal_index + 1) % MAX_PRODUCERS;
+		uint32_t expected = PRODUCER_IDLE;
+		if (producer.state.compare_exchange_strong(expected, PRODUCER_PUSHING, std::memory_order_acquire)) {
+			producer.thread_id.store(p_thread_id, std::memory_order_relaxed);
+			return &producer;
+		}
+	}
+}
+
+CommandQueueMT::CommandBase *CommandQueueMT::_peek_producer(Producer *p_producer, uint64_t &r_sequence) {
+	while (true) {
+		ProducerBlock *block = p_producer->read_block;
+		uint32_t committed = block->committed.get();
+
+		if (p_producer->read_ofs < committed) {
+			uint64_t *header = (uint64_t *)&block->data[p_producer->read_ofs];
+			r_sequence = header[1];
+			return reinterpret_cast<CommandBase *>(header + 2);
+		}
+
+		ProducerBlock *next = block->next.load(std::memory_order_acquire);
+		if (!next) {
+			return nullptr;
+		}
+		if (block->committed.get() != committed) {
+			// The last commits to this block happened right before it was linked.
+			continue;
+		}
+		p_producer->read_block = next;
+		p_producer->read_ofs = 0;
+		ProducerBlock *expected = nullptr;
+		if (!p_producer->spare.compare_exchange_strong(expected, block, std::memory_order_release)) {
+			memdelete(block);
+		}
+	}
+}
+
+void CommandQueueMT::_flush_producers() {
+	if (unlikely(producers_flushing)) {
+		// Re-entrant call.
+		return;
+	}
+	producers_flushing = true;
+
+	CommandBase *heads[MAX_PRODUCERS] = {};
+	uint64_t sequences[MAX_PRODUCERS];
+
+	while (true) {
+		uint32_t count = producer_count.get();
+		uint32_t oldest = MAX_PRODUCERS;
+		for (uint32_t i = 0; i < count; i++) {
+			if (!heads[i]) {
+				heads[i] = _peek_producer(&producers[i], sequences[i]);
+			}
+			if (heads[i] && (oldest == MAX_PRODUCERS || sequences[i] < sequences[oldest])) {
+				oldest = i;
+			}
+		}
+		if (oldest == MAX_PRODUCERS) {
+			break;
+		}
+
+		// A producer that looked empty may have committed an older command in the
+		// meantime. Anything pushed after the oldest one was committed is newer,
+		// so a single re-check is enough.
+		bool found_older = false;
+		count = producer_count.get();
+		for (uint32_t i = 0; i < count; i++) {
+			if (!heads[i]) {
+				heads[i] = _peek_producer(&producers[i], sequences[i]);
+				if (heads[i] && sequences[i] < sequences[oldest]) {
+					found_older = true;
+				}
+			}
+		}
+		if (found_older) {
+			continue;
+		}
+
+		Producer &producer = producers[oldest];
+		CommandBase *cmd = heads[oldest];
+		heads[oldest] = nullptr;
+		uint64_t size = *((uint64_t *)cmd - 2);
+		cmd->call();
+		if (unlikely(cmd->sync)) {
+			{
+				MutexLock lock(mutex);
+				producer.sync_done++;
+			}
+			sync_cond_var.notify_all();
+		}
+		cmd->~CommandBase();
+		producer.read_ofs += size + PRODUCER_HEADER_SIZE;
+	}
+
+	producers_flushing = false;
+}
+
 CommandQueueMT::CommandQueueMT() {
 	command_mem.reserve(DEFAULT_COMMAND_MEM_SIZE_KB * 1024);
 }
 
 CommandQueueMT::~CommandQueueMT() {
+	uint32_t count = producer_count.get();
+	for (uint32_t i = 0; i < count; i++) {
+		ProducerBlock *block = producers[i].read_block;
+		while (block) {
+			ProducerBlock *next = block->next.load(std::memory_order_acquire);
+			memdelete(block);
+			block = next;
+		}
+		ProducerBlock *spare = producers[i].spare.load(std::memory_order_acquire);
+		if (spare) {
+			memdelete(spare);
+		}
+	}
 }
@@ -35,8 +35,10 @@
 #include "core/os/condition_variable.h"
 #include "core/os/memory.h"
 #include "core/os/mutex.h"
+#include "core/os/thread.h"
 #include "core/string/print_string.h"
 #include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
 #include "core/templates/simple_type.h"
 #include "core/typedefs.h"
 
@@ -251,14 +253,21 @@
 #define DECL_PUSH(N)                                                            \
 	template <typename T, typename M COMMA(N) COMMA_SEP_LIST(TYPE_PARAM, N)>    \
 	void push(T *p_instance, M p_method COMMA(N) COMMA_SEP_LIST(PARAM, N)) {    \
+		Producer *producer = _get_producer();                                   \
+		if (producer) {                                                         \
+			CMD_TYPE(N) *cmd = _producer_allocate<CMD_TYPE(N)>(producer);       \
+			cmd->instance = p_instance;                                         \
+			cmd->method = p_method;                                             \
+			SEMIC_SEP_LIST(CMD_ASSIGN_PARAM, N);                                \
+			_producer_commit(producer);                                         \
+			return;                                                             \
+		}                                                                       \
 		MutexLock mlock(mutex);                                                 \
 		CMD_TYPE(N) *cmd = allocate<CMD_TYPE(N)>();                             \
 		cmd->instance = p_instance;                                             \
 		cmd->method = p_method;                                                 \
 		SEMIC_SEP_LIST(CMD_ASSIGN_PARAM, N);                                    \
-		if (pump_task_id != WorkerThreadPool::INVALID_TASK_ID) {                \
-			WorkerThreadPool::get_singleton()->notify_yield_over(pump_task_id); \
-		}                                                                       \
+		_notify_pump();                                                         \
 	}
 
 #define CMD_RET_TYPE(N) CommandRet##N<T, M, COMMA_SEP_LIST(TYPE_ARG, N) COMMA(N) R>
@@ -266,15 +275,25 @@
 #define DECL_PUSH_AND_RET(N)                                                                   \
 	template <typename T, typename M, COMMA_SEP_LIST(TYPE_PARAM, N) COMMA(N) typename R>       \
 	void push_and_ret(T *p_instance, M p_method, COMMA_SEP_LIST(PARAM, N) COMMA(N) R *r_ret) { \
+		Producer *producer = _get_producer();                                                  \
+		if (producer) {                                                                        \
+			CMD_RET_TYPE(N) *cmd = _producer_allocate<CMD_RET_TYPE(N)>(producer);              \
+			cmd->instance = p_instance;                                                        \
+			cmd->method = p_method;                                                            \
+			SEMIC_SEP_LIST(CMD_ASSIGN_PARAM, N);                                               \
+			cmd->ret = r_ret;                                                                  \
+			uint32_t sync_goal = ++producer->sync_pushed;                                      \
+			_producer_commit(producer);                                                        \
+			_producer_wait_for_sync(producer, sync_goal);                                      \
+			return;                                                                            \
+		}                                                                                      \
 		MutexLock mlock(mutex);                                                                \
 		CMD_RET_TYPE(N) *cmd = allocate<CMD_RET_TYPE(N)>();                                    \
 		cmd->instance = p_instance;                                                            \
 		cmd->method = p_method;                                                                \
 		SEMIC_SEP_LIST(CMD_ASSIGN_PARAM, N);                                                   \
 		cmd->ret = r_ret;                                                                      \
-		if (pump_task_id != WorkerThreadPool::INVALID_TASK_ID) {                               \
-			WorkerThreadPool::get_singleton()->notify_yield_over(pump_task_id);                \
-		}                                                                                      \
+		_notify_pump();                                                                        \
 		sync_tail++;                                                                           \
 		_wait_for_sync(mlock);                                                                 \
 	}
@@ -284,14 +303,23 @@
 #define DECL_PUSH_AND_SYNC(N)                                                         \
 	template <typename T, typename M COMMA(N) COMMA_SEP_LIST(TYPE_PARAM, N)>          \
 	void push_and_sync(T *p_instance, M p_method COMMA(N) COMMA_SEP_LIST(PARAM, N)) { \
+		Producer *producer = _get_producer();                                         \
+		if (producer) {                                                               \
+			CMD_SYNC_TYPE(N) *cmd = _producer_allocate<CMD_SYNC_TYPE(N)>(producer);   \
+			cmd->instance = p_instance;                                               \
+			cmd->method = p_method;                                                   \
+			SEMIC_SEP_LIST(CMD_ASSIGN_PARAM, N);                                      \
+			uint32_t sync_goal = ++producer->sync_pushed;                             \
+			_producer_commit(producer);                                               \
+			_producer_wait_for_sync(producer, sync_goal);                             \
+			return;                                                                   \
+		}                                                                             \
 		MutexLock mlock(mutex);                                                       \
 		CMD_SYNC_TYPE(N) *cmd = allocate<CMD_SYNC_TYPE(N)>();                         \
 		cmd->instance = p_instance;                                                   \
 		cmd->method = p_method;                                                       \
 		SEMIC_SEP_LIST(CMD_ASSIGN_PARAM, N);                                          \
-		if (pump_task_id != WorkerThreadPool::INVALID_TASK_ID) {                      \
-			WorkerThreadPool::get_singleton()->notify_yield_over(pump_task_id);       \
-		}                                                                             \
+		_notify_pump();                                                               \
 		sync_tail++;                                                                  \
 		_wait_for_sync(mlock);                                                        \
 	}
@@ -333,7 +361,7 @@ class CommandQueueMT {
 	uint32_t sync_head = 0;
 	uint32_t sync_tail = 0;
 	uint32_t sync_awaiters = 0;
-	WorkerThreadPool::TaskID pump_task_id = WorkerThreadPool::INVALID_TASK_ID;
+	std::atomic<WorkerThreadPool::TaskID> pump_task_id = WorkerThreadPool::INVALID_TASK_ID;
 	uint64_t flush_read_ptr = 0;
 
 	template <typename T>
@@ -405,6 +433,165 @@ class CommandQueueMT {
 		_prevent_sync_wraparound();
 	}
 
+	/***** PER-PRODUCER QUEUES *****/
+
+	// With multiple producers enabled, every pushing thread gets its own chain
+	// of blocks it appends to without taking the mutex. Each command is stamped
+	// with a global sequence number when it is committed, and the consumer
+	// merges the chains by it. A command that was pushed after another one
+	// completed on some other thread (for example, one using an RID created
+	// there) is therefore always executed after it.
+	// There are MAX_PRODUCERS slots. When they are all taken, a thread takes
+	// over a slot that isn't being pushed to, so short-lived threads don't use
+	// them up. Commands left in the slot keep their place in the merge order.
+
+	static const uint32_t PRODUCER_BLOCK_SIZE = 16 * 1024;
+	static const uint32_t PRODUCER_HEADER_SIZE = 16; // Command size and sequence number.
+	static const uint32_t MAX_PRODUCERS = 32;
+
+	enum {
+		PRODUCER_IDLE,
+		PRODUCER_PUSHING,
+	};
+
+	struct ProducerBlock {
+		SafeNumeric<uint32_t> committed; // Bytes published to the consumer.
+		std::atomic<ProducerBlock *> next = nullptr;
+		alignas(8) uint8_t data[PRODUCER_BLOCK_SIZE];
+	};
+
+	struct Producer {
+		std::atomic<Thread::ID> thread_id = Thread::UNASSIGNED_ID;
+		// A thread may only write to the slot while it holds it in PRODUCER_PUSHING.
+		std::atomic<uint32_t> state = PRODUCER_IDLE;
+		// Touched by the thread holding the slot only.
+		ProducerBlock *write_block = nullptr;
+		uint32_t write_ofs = 0;
+		uint32_t sync_pushed = 0;
+		uint64_t *pending_header = nullptr;
+		// Touched by the consumer only.
+		ProducerBlock *read_block = nullptr;
+		uint32_t read_ofs = 0;
+		// Guarded by the mutex.
+		uint32_t sync_done = 0;
+		// A drained block handed back to the producer for reuse.
+		std::atomic<ProducerBlock *> spare = nullptr;
+	};
+
+	bool multiple_producers = false;
+	Producer producers[MAX_PRODUCERS];
+	SafeNumeric<uint32_t> producer_count;
+	SafeNumeric<uint64_t> command_sequence;
+	uint32_t producer_steal_index = 0;
+	bool producers_flushing = false;
+	std::atomic<bool> pump_waiting = false;
+
+	Producer *_register_producer(Thread::ID p_thread_id);
+
+	_FORCE_INLINE_ bool _producer_acquire(Producer *p_producer, Thread::ID p_thread_id) {
+		uint32_t expected = PRODUCER_IDLE;
+		if (!p_producer->state.compare_exchange_strong(expected, PRODUCER_PUSHING, std::memory_order_acquire)) {
+			// Another thread is taking over the slot.
+			return false;
+		}
+		if (p_producer->thread_id.load(std::memory_order_relaxed) != p_thread_id) {
+			p_producer->state.store(PRODUCER_IDLE, std::memory_order_release);
+			return false;
+		}
+		return true;
+	}
+
+	// Returns a slot held in PRODUCER_PUSHING, to be released by _producer_commit().
+	_FORCE_INLINE_ Producer *_get_producer() {
+		if (!multiple_producers) {
+			return nullptr;
+		}
+		Thread::ID caller_id = Thread::get_caller_id();
+		uint32_t count = producer_count.get();
+		for (uint32_t i = 0; i < count; i++) {
+			if (producers[i].thread_id.load(std::memory_order_relaxed) == caller_id && _producer_acquire(&producers[i], caller_id)) {
+				return &producers[i];
+			}
+		}
+		return _register_producer(caller_id);
+	}
+
+	template <typename T>
+	T *_producer_allocate(Producer *p_producer) {
+		uint32_t alloc_size = ((sizeof(T) + 8 - 1) & ~(8 - 1));
+		static_assert(sizeof(T) + PRODUCER_HEADER_SIZE <= PRODUCER_BLOCK_SIZE, "Command too large for a producer block.");
+		if (unlikely(p_producer->write_ofs + alloc_size + PRODUCER_HEADER_SIZE > PRODUCER_BLOCK_SIZE)) {
+			ProducerBlock *block = p_producer->spare.exchange(nullptr, std::memory_order_acquire);
+			if (!block) {
+				block = memnew(ProducerBlock);
+			}
+			block->committed.set(0);
+			block->next.store(nullptr, std::memory_order_relaxed);
+			// Everything in the current block was committed already, so the consumer
+			// can move on as soon as it sees the link.
+			p_producer->write_block->next.store(block, std::memory_order_release);
+			p_producer->write_block = block;
+			p_producer->write_ofs = 0;
+		}
+		uint64_t *header = (uint64_t *)&p_producer->write_block->data[p_producer->write_ofs];
+		header[0] = alloc_size;
+		p_producer->pending_header = header;
+		p_producer->write_ofs += alloc_size + PRODUCER_HEADER_SIZE;
+		return memnew_placement(header + 2, T);
+	}
+
+	// Notifying takes the mutex of the worker thread pool, so only wake the pump
+	// up while it waits in pump_yield(). Pairs with the fence there: either the
+	// pump sees the pushed command, or the pusher sees the pump waiting.
+	_FORCE_INLINE_ void _notify_pump() {
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (pump_waiting.load(std::memory_order_relaxed)) {
+			WorkerThreadPool::TaskID task_id = pump_task_id.load(std::memory_order_acquire);
+			if (task_id != WorkerThreadPool::INVALID_TASK_ID) {
+				WorkerThreadPool::get_singleton()->notify_yield_over(task_id);
+			}
+		}
+	}
+
+	_FORCE_INLINE_ void _producer_commit(Producer *p_producer) {
+		p_producer->pending_header[1] = command_sequence.increment();
+		p_producer->write_block->committed.set(p_producer->write_ofs);
+		p_producer->state.store(PRODUCER_IDLE, std::memory_order_release);
+		_notify_pump();
+	}
+
+	void _producer_wait_for_sync(Producer *p_producer, uint32_t p_goal) {
+		MutexLock lock(mutex);
+		while ((int32_t)(p_goal - p_producer->sync_done) > 0) {
+			sync_cond_var.wait(lock);
+		}
+	}
+
+	_FORCE_INLINE_ bool _producers_pending() const {
+		uint32_t count = producer_count.get();
+		for (uint32_t i = 0; i < count; i++) {
+			const Producer &p = producers[i];
+			if (p.read_block->committed.get() != p.read_ofs || p.read_block->next.load(std::memory_order_acquire)) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	CommandBase *_peek_producer(Producer *p_producer, uint64_t &r_sequence);
+	void _flush_producers();
+
+	_FORCE_INLINE_ bool _has_pending() const {
+		return command_mem.size() > 0 || (multiple_producers && _producers_pending());
+	}
+
+	_FORCE_INLINE_ void _flush_all() {
+		_flush();
+		if (multiple_producers) {
+			_flush_producers();
+		}
+	}
+
 	void _no_op() {}
 
 public:
@@ -421,13 +608,13 @@ public:
 	SPACE_SEP_LIST(DECL_PUSH_AND_SYNC, 15)
 
 	_FORCE_INLINE_ void flush_if_pending() {
-		if (unlikely(command_mem.size() > 0)) {
-			_flush();
+		if (unlikely(_has_pending())) {
+			_flush_all();
 		}
 	}
 
 	void flush_all() {
-		_flush();
+		_flush_all();
 	}
 
 	void sync() {
@@ -437,7 +624,23 @@ public:
 	void wait_and_flush() {
 		ERR_FAIL_COND(pump_task_id == WorkerThreadPool::INVALID_TASK_ID);
 		WorkerThreadPool::get_singleton()->wait_for_task_completion(pump_task_id);
-		_flush();
+		_flush_all();
+	}
+
+	// Yields the pump task until there are commands to flush. Call it from the
+	// pump instead of WorkerThreadPool::yield().
+	void pump_yield() {
+		pump_waiting.store(true, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		bool pending;
+		{
+			MutexLock lock(mutex);
+			pending = _has_pending();
+		}
+		if (!pending) {
+			WorkerThreadPool::get_singleton()->yield();
+		}
+		pump_waiting.store(false, std::memory_order_relaxed);
 	}
 
 	void set_pump_task_id(WorkerThreadPool::TaskID p_task_id) {
@@ -445,6 +648,13 @@ public:
 		pump_task_id = p_task_id;
 	}
 
+	// Lets every producer thread push without contending on the mutex. There
+	// must only ever be one consumer flushing at a time. Enable before any push.
+	void set_multiple_producers(bool p_enable) {
+		MutexLock lock(mutex);
+		multiple_producers = p_enable;
+	}
+
 	CommandQueueMT();
 	~CommandQueueMT();
 };
@@ -92,6 +92,11 @@ void Performance::_bind_methods() {
 	BIND_ENUM_CONSTANT(NAVIGATION_EDGE_CONNECTION_COUNT);
 	BIND_ENUM_CONSTANT(NAVIGATION_EDGE_FREE_COUNT);
 	BIND_ENUM_CONSTANT(NAVIGATION_OBSTACLE_COUNT);
+	BIND_ENUM_CONSTANT(NAVIGATION_POLYGON_SYNC_COUNT);
+	BIND_ENUM_CONSTANT(NAVIGATION_LINK_SYNC_COUNT);
+	BIND_ENUM_CONSTANT(NAVIGATION_PATH_QUERY_POLYGON_COUNT);
+	BIND_ENUM_CONSTANT(NAVIGATION_PATH_QUERY_CLUSTER_COUNT);
+	BIND_ENUM_CONSTANT(NAVIGATION_PATH_QUERY_RETRY_COUNT);
 	BIND_ENUM_CONSTANT(MONITOR_MAX);
 }
 
@@ -143,6 +148,11 @@ String Performance::get_monitor_name(Monitor p_monitor) const {
 		PNAME("navigation/edges_connected"),
 		PNAME("navigation/edges_free"),
 		PNAME("navigation/obstacles"),
+		PNAME("navigation/polygons_synced"),
+		PNAME("navigation/links_synced"),
+		PNAME("navigation/path_query_polygons"),
+		PNAME("navigation/path_query_clusters"),
+		PNAME("navigation/path_query_retries"),
 
 	};
 
@@ -229,6 +239,16 @@ double Performance::get_monitor(Monitor p_monitor) const {
 			return NavigationServer3D::get_singleton()->get_process_info(NavigationServer3D::INFO_EDGE_FREE_COUNT);
 		case NAVIGATION_OBSTACLE_COUNT:
 			return NavigationServer3D::get_singleton()->get_process_info(NavigationServer3D::INFO_OBSTACLE_COUNT);
+		case NAVIGATION_POLYGON_SYNC_COUNT:
+			return NavigationServer3D::get_singleton()->get_process_info(NavigationServer3D::INFO_POLYGON_SYNC_COUNT);
+		case NAVIGATION_LINK_SYNC_COUNT:
+			return NavigationServer3D::get_singleton()->get_process_info(NavigationServer3D::INFO_LINK_SYNC_COUNT);
+		case NAVIGATION_PATH_QUERY_POLYGON_COUNT:
+			return NavigationServer3D::get_singleton()->get_process_info(NavigationServer3D::INFO_PATH_QUERY_POLYGON_COUNT);
+		case NAVIGATION_PATH_QUERY_CLUSTER_COUNT:
+			return NavigationServer3D::get_singleton()->get_process_info(NavigationServer3D::INFO_PATH_QUERY_CLUSTER_COUNT);
+		case NAVIGATION_PATH_QUERY_RETRY_COUNT:
+			return NavigationServer3D::get_singleton()->get_process_info(NavigationServer3D::INFO_PATH_QUERY_RETRY_COUNT);
 
 		default: {
 		}
@@ -277,6 +297,11 @@ Performance::MonitorType Performance::get_monitor_type(Monitor p_monitor) const
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
 
 	};
 
@@ -101,6 +101,11 @@ public:
 		NAVIGATION_EDGE_CONNECTION_COUNT,
 		NAVIGATION_EDGE_FREE_COUNT,
 		NAVIGATION_OBSTACLE_COUNT,
+		NAVIGATION_POLYGON_SYNC_COUNT,
+		NAVIGATION_LINK_SYNC_COUNT,
+		NAVIGATION_PATH_QUERY_POLYGON_COUNT,
+		NAVIGATION_PATH_QUERY_CLUSTER_COUNT,
+		NAVIGATION_PATH_QUERY_RETRY_COUNT,
 		MONITOR_MAX
 	};
 
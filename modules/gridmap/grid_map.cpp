@@ -517,7 +517,6 @@ Vector3 GridMap::map_to_local(const Vector3i &p_map_position) const {
 void GridMap::_octant_transform(const OctantKey &p_key) {
 	ERR_FAIL_COND(!octant_map.has(p_key));
 	Octant &g = *octant_map[p_key];
-	PhysicsServer3D::get_singleton()->body_set_state(g.static_body, PhysicsServer3D::BODY_STATE_TRANSFORM, get_global_transform());
 
 	if (g.collision_debug_instance.is_valid()) {
 		RS::get_singleton()->instance_set_transform(g.collision_debug_instance, get_global_transform());
@@ -931,7 +930,29 @@ void GridMap::_notification(int p_what) {
 			if (new_xform == last_transform) {
 				break;
 			}
-			//update run
+			// Move the static bodies of all the octants with a single physics server call.
+			Vector<RID> bodies;
+			Vector<float> buffer;
+			bodies.resize(octant_map.size());
+			buffer.resize(octant_map.size() * 12);
+			RID *bodies_ptrw = bodies.ptrw();
+			float *buffer_ptrw = buffer.ptrw();
+			int body_index = 0;
+			for (const KeyValue<OctantKey, Octant *> &E : octant_map) {
+				bodies_ptrw[body_index] = E.value->static_body;
+				float *dataptr = &buffer_ptrw[body_index * 12];
+				for (int i = 0; i < 3; i++) {
+					dataptr[i * 4 + 0] = new_xform.basis.rows[i].x;
+					dataptr[i * 4 + 1] = new_xform.basis.rows[i].y;
+					dataptr[i * 4 + 2] = new_xform.basis.rows[i].z;
+					dataptr[i * 4 + 3] = new_xform.origin[i];
+				}
+				body_index++;
+			}
+			if (!bodies.is_empty()) {
+				PhysicsServer3D::get_singleton()->body_set_state_batch(bodies, PhysicsServer3D::BODY_STATE_TRANSFORM, buffer);
+			}
+
 			for (const KeyValue<OctantKey, Octant *> &E : octant_map) {
 				_octant_transform(E.key);
 			}
@@ -62,6 +62,8 @@ public:
 	virtual bool map_is_active(RID p_map) const override;
 	virtual void map_set_cell_size(RID p_map, real_t p_cell_size) override;
 	virtual real_t map_get_cell_size(RID p_map) const override;
+	virtual void map_set_use_avoidance_spatial_hash(RID p_map, bool p_enabled) override;
+	virtual bool map_get_use_avoidance_spatial_hash(RID p_map) const override;
 	virtual void map_set_use_edge_connections(RID p_map, bool p_enabled) override;
 	virtual bool map_get_use_edge_connections(RID p_map) const override;
 	virtual void map_set_edge_connection_margin(RID p_map, real_t p_connection_margin) override;
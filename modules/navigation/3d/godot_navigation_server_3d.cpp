@@ -195,6 +195,35 @@ float GodotNavigationServer3D::map_get_merge_rasterizer_cell_scale(RID p_map) co
 	return map->get_merge_rasterizer_cell_scale();
 }
 
+COMMAND_2(map_set_path_cluster_size, RID, p_map, int, p_cluster_size) {
+	NavMap *map = map_owner.get_or_null(p_map);
+	ERR_FAIL_NULL(map);
+	ERR_FAIL_COND_MSG(p_cluster_size < 0, "Path cluster size must be positive or 0 to disable the hierarchical path search.");
+
+	map->set_path_cluster_size(p_cluster_size);
+}
+
+int GodotNavigationServer3D::map_get_path_cluster_size(RID p_map) const {
+	NavMap *map = map_owner.get_or_null(p_map);
+	ERR_FAIL_NULL_V(map, 0);
+
+	return map->get_path_cluster_size();
+}
+
+COMMAND_2(map_set_use_avoidance_spatial_hash, RID, p_map, bool, p_enabled) {
+	NavMap *map = map_owner.get_or_null(p_map);
+	ERR_FAIL_NULL(map);
+
+	map->set_use_avoidance_spatial_hash(p_enabled);
+}
+
+bool GodotNavigationServer3D::map_get_use_avoidance_spatial_hash(RID p_map) const {
+	NavMap *map = map_owner.get_or_null(p_map);
+	ERR_FAIL_NULL_V(map, false);
+
+	return map->get_use_avoidance_spatial_hash();
+}
+
 COMMAND_2(map_set_use_edge_connections, RID, p_map, bool, p_enabled) {
 	NavMap *map = map_owner.get_or_null(p_map);
 	ERR_FAIL_NULL(map);
@@ -272,6 +301,13 @@ RID GodotNavigationServer3D::map_get_closest_point_owner(RID p_map, const Vector
 	return map->get_closest_point_owner(p_point);
 }
 
+Vector3 GodotNavigationServer3D::map_get_flow_field_next_position(RID p_map, const Vector3 &p_target, const Vector3 &p_from, uint32_t p_navigation_layers) const {
+	const NavMap *map = map_owner.get_or_null(p_map);
+	ERR_FAIL_NULL_V(map, Vector3());
+
+	return map->get_flow_field_next_position(p_target, p_from, p_navigation_layers);
+}
+
 TypedArray<RID> GodotNavigationServer3D::map_get_links(RID p_map) const {
 	TypedArray<RID> link_rids;
 	const NavMap *map = map_owner.get_or_null(p_map);
@@ -1308,6 +1344,11 @@ void GodotNavigationServer3D::process(real_t p_delta_time) {
 	int _new_pm_edge_connection_count = 0;
 	int _new_pm_edge_free_count = 0;
 	int _new_pm_obstacle_count = 0;
+	int _new_pm_polygon_sync_count = 0;
+	int _new_pm_link_sync_count = 0;
+	int _new_pm_path_query_polygon_count = 0;
+	int _new_pm_path_query_cluster_count = 0;
+	int _new_pm_path_query_retry_count = 0;
 
 	// In c++ we can't be sure that this is performed in the main thread
 	// even with mutable functions.
@@ -1326,6 +1367,11 @@ void GodotNavigationServer3D::process(real_t p_delta_time) {
 		_new_pm_edge_connection_count += active_maps[i]->get_pm_edge_connection_count();
 		_new_pm_edge_free_count += active_maps[i]->get_pm_edge_free_count();
 		_new_pm_obstacle_count += active_maps[i]->get_pm_obstacle_count();
+		_new_pm_polygon_sync_count += active_maps[i]->get_pm_polygon_sync_count();
+		_new_pm_link_sync_count += active_maps[i]->get_pm_link_sync_count();
+		_new_pm_path_query_polygon_count += active_maps[i]->get_pm_path_query_polygon_count();
+		_new_pm_path_query_cluster_count += active_maps[i]->get_pm_path_query_cluster_count();
+		_new_pm_path_query_retry_count += active_maps[i]->get_pm_path_query_retry_count();
 
 		// Emit a signal if a map changed.
 		const uint32_t new_map_iteration_id = active_maps[i]->get_iteration_id();
@@ -1344,6 +1390,62 @@ void GodotNavigationServer3D::process(real_t p_delta_time) {
 	pm_edge_connection_count = _new_pm_edge_connection_count;
 	pm_edge_free_count = _new_pm_edge_free_count;
 	pm_obstacle_count = _new_pm_obstacle_count;
+	pm_polygon_sync_count = _new_pm_polygon_sync_count;
+	pm_link_sync_count = _new_pm_link_sync_count;
+	pm_path_query_polygon_count = _new_pm_path_query_polygon_count;
+	pm_path_query_cluster_count = _new_pm_path_query_cluster_count;
+	pm_path_query_retry_count = _new_pm_path_query_retry_count;
+
+	_process_async_path_queries();
+}
+
+void GodotNavigationServer3D::query_path_async(const Ref<NavigationPathQueryParameters3D> &p_query_parameters, const Ref<NavigationPathQueryResult3D> &p_query_result, const Callable &p_callback) {
+	ERR_FAIL_COND(p_query_parameters.is_null());
+	ERR_FAIL_COND(p_query_result.is_null());
+
+	AsyncPathQuery query;
+	query.parameters = p_query_parameters->get_parameters();
+	query.query_result = p_query_result;
+	query.callback = p_callback;
+
+	MutexLock lock(async_path_queries_mutex);
+	async_path_queries[async_path_queries_pending].push_back(query);
+}
+
+void GodotNavigationServer3D::_process_async_path_queries() {
+	uint32_t processing;
+	{
+		MutexLock lock(async_path_queries_mutex);
+		processing = async_path_queries_pending;
+		async_path_queries_pending = 1 - async_path_queries_pending;
+	}
+
+	// Queries queued from the callbacks go to the other buffer and wait for the next step.
+	LocalVector<AsyncPathQuery> &queries = async_path_queries[processing];
+	if (queries.is_empty()) {
+		return;
+	}
+
+	// The maps are synced, so all queries can search them at the same time.
+	WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotNavigationServer3D::_process_async_path_query, queries.ptr(), queries.size(), -1, true, SNAME("NavigationServer3DPathQueries"));
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+
+	for (AsyncPathQuery &query : queries) {
+		query.query_result->set_path(query.result.path);
+		query.query_result->set_path_types(query.result.path_types);
+		query.query_result->set_path_rids(query.result.path_rids);
+		query.query_result->set_path_owner_ids(query.result.path_owner_ids);
+
+		if (query.callback.is_valid()) {
+			query.callback.call();
+		}
+	}
+	queries.clear();
+}
+
+void GodotNavigationServer3D::_process_async_path_query(uint32_t p_index, AsyncPathQuery *p_queries) {
+	AsyncPathQuery &query = p_queries[p_index];
+	query.result = _query_path(query.parameters);
 }
 
 void GodotNavigationServer3D::init() {
@@ -1581,6 +1683,21 @@ int GodotNavigationServer3D::get_process_info(ProcessInfo p_info) const {
 		case INFO_OBSTACLE_COUNT: {
 			return pm_obstacle_count;
 		} break;
+		case INFO_POLYGON_SYNC_COUNT: {
+			return pm_polygon_sync_count;
+		} break;
+		case INFO_LINK_SYNC_COUNT: {
+			return pm_link_sync_count;
+		} break;
+		case INFO_PATH_QUERY_POLYGON_COUNT: {
+			return pm_path_query_polygon_count;
+		} break;
+		case INFO_PATH_QUERY_CLUSTER_COUNT: {
+			return pm_path_query_cluster_count;
+		} break;
+		case INFO_PATH_QUERY_RETRY_COUNT: {
+			return pm_path_query_retry_count;
+		} break;
 	}
 
 	return 0;
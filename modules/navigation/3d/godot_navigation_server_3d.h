@@ -72,6 +72,19 @@ class GodotNavigationServer3D : public NavigationServer3D {
 
 	LocalVector<SetCommand *> commands;
 
+	struct AsyncPathQuery {
+		NavigationUtilities::PathQueryParameters parameters;
+		NavigationUtilities::PathQueryResult result;
+		Ref<NavigationPathQueryResult3D> query_result;
+		Callable callback;
+	};
+
+	/// Path queries waiting for the next process step, and the ones being processed.
+	/// The two buffers are swapped on process, so the pending queries are never copied.
+	Mutex async_path_queries_mutex;
+	LocalVector<AsyncPathQuery> async_path_queries[2];
+	uint32_t async_path_queries_pending = 0;
+
 	mutable RID_Owner<NavLink> link_owner;
 	mutable RID_Owner<NavMap> map_owner;
 	mutable RID_Owner<NavRegion> region_owner;
@@ -96,6 +109,11 @@ class GodotNavigationServer3D : public NavigationServer3D {
 	int pm_edge_connection_count = 0;
 	int pm_edge_free_count = 0;
 	int pm_obstacle_count = 0;
+	int pm_polygon_sync_count = 0;
+	int pm_link_sync_count = 0;
+	int pm_path_query_polygon_count = 0;
+	int pm_path_query_cluster_count = 0;
+	int pm_path_query_retry_count = 0;
 
 public:
 	GodotNavigationServer3D();
@@ -121,6 +139,12 @@ public:
 	COMMAND_2(map_set_merge_rasterizer_cell_scale, RID, p_map, float, p_value);
 	virtual float map_get_merge_rasterizer_cell_scale(RID p_map) const override;
 
+	COMMAND_2(map_set_path_cluster_size, RID, p_map, int, p_cluster_size);
+	virtual int map_get_path_cluster_size(RID p_map) const override;
+
+	COMMAND_2(map_set_use_avoidance_spatial_hash, RID, p_map, bool, p_enabled);
+	virtual bool map_get_use_avoidance_spatial_hash(RID p_map) const override;
+
 	COMMAND_2(map_set_use_edge_connections, RID, p_map, bool, p_enabled);
 	virtual bool map_get_use_edge_connections(RID p_map) const override;
 
@@ -136,6 +160,7 @@ public:
 	virtual Vector3 map_get_closest_point(RID p_map, const Vector3 &p_point) const override;
 	virtual Vector3 map_get_closest_point_normal(RID p_map, const Vector3 &p_point) const override;
 	virtual RID map_get_closest_point_owner(RID p_map, const Vector3 &p_point) const override;
+	virtual Vector3 map_get_flow_field_next_position(RID p_map, const Vector3 &p_target, const Vector3 &p_from, uint32_t p_navigation_layers = 1) const override;
 
 	virtual TypedArray<RID> map_get_links(RID p_map) const override;
 	virtual TypedArray<RID> map_get_regions(RID p_map) const override;
@@ -285,11 +310,15 @@ public:
 	virtual void sync() override;
 	virtual void finish() override;
 
+	virtual void query_path_async(const Ref<NavigationPathQueryParameters3D> &p_query_parameters, const Ref<NavigationPathQueryResult3D> &p_query_result, const Callable &p_callback) override;
 	virtual NavigationUtilities::PathQueryResult _query_path(const NavigationUtilities::PathQueryParameters &p_parameters) const override;
 
 	int get_process_info(ProcessInfo p_info) const override;
 
 private:
+	void _process_async_path_queries();
+	void _process_async_path_query(uint32_t p_index, AsyncPathQuery *p_queries);
+
 	void internal_free_agent(RID p_object);
 	void internal_free_obstacle(RID p_object);
 };
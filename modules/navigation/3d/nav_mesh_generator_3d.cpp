@@ -75,10 +75,63 @@ HashMap<WorkerThreadPool::TaskID, NavMeshGenerator3D::NavMeshGeneratorTask3D *>
 RID_Owner<NavMeshGenerator3D::NavMeshGeometryParser3D> NavMeshGenerator3D::generator_parser_owner;
 LocalVector<NavMeshGenerator3D::NavMeshGeometryParser3D *> NavMeshGenerator3D::generator_parsers;
 
+// Everything that changes the bake result of a tile.
+struct NavMeshBakeTileKey3D {
+	rcConfig config = {}; // Without the tile bounds.
+	Rect2i cells;
+	float baking_aabb_min_y = 0.0;
+	float baking_aabb_max_y = 0.0;
+	int sample_partition_type = 0;
+	bool filter_low_hanging_obstacles = false;
+	bool filter_ledge_spans = false;
+	bool filter_walkable_low_height_spans = false;
+	uint32_t triangle_count = 0;
+	uint32_t projected_obstruction_count = 0;
+	// Of the triangles and projected obstructions that overlap the tile.
+	uint32_t input_checksum[2] = {};
+
+	bool operator==(const NavMeshBakeTileKey3D &p_other) const {
+		return memcmp(&config, &p_other.config, sizeof(rcConfig)) == 0 &&
+				cells == p_other.cells &&
+				baking_aabb_min_y == p_other.baking_aabb_min_y &&
+				baking_aabb_max_y == p_other.baking_aabb_max_y &&
+				sample_partition_type == p_other.sample_partition_type &&
+				filter_low_hanging_obstacles == p_other.filter_low_hanging_obstacles &&
+				filter_ledge_spans == p_other.filter_ledge_spans &&
+				filter_walkable_low_height_spans == p_other.filter_walkable_low_height_spans &&
+				triangle_count == p_other.triangle_count &&
+				projected_obstruction_count == p_other.projected_obstruction_count &&
+				input_checksum[0] == p_other.input_checksum[0] &&
+				input_checksum[1] == p_other.input_checksum[1];
+	}
+
+	void add_input(const void *p_data, int p_size) {
+		// Two differently seeded hashes, so an accidental match needs a 64-bit collision.
+		input_checksum[0] = hash_murmur3_buffer(p_data, p_size, input_checksum[0]);
+		input_checksum[1] = hash_murmur3_buffer(p_data, p_size, input_checksum[1]);
+	}
+};
+
+// Baked tiles of the navigation meshes that use a tile size, reused by the next bake of the same navigation mesh.
+struct NavMeshBakedTile3D {
+	NavMeshBakeTileKey3D key;
+	Vector<Vector3> vertices;
+	Vector<Vector<int>> polygons;
+};
+static Mutex tile_cache_mutex;
+static HashMap<ObjectID, HashMap<Vector2i, NavMeshBakedTile3D>> tile_caches;
+// Tiles with source geometry that were not found in the cache, over all bakes.
+static uint64_t baked_tile_count = 0;
+
 NavMeshGenerator3D *NavMeshGenerator3D::get_singleton() {
 	return singleton;
 }
 
+uint64_t NavMeshGenerator3D::get_baked_tile_count() {
+	MutexLock tile_cache_lock(tile_cache_mutex);
+	return baked_tile_count;
+}
+
 NavMeshGenerator3D::NavMeshGenerator3D() {
 	ERR_FAIL_COND(singleton != nullptr);
 	singleton = this;
@@ -149,6 +202,9 @@ void NavMeshGenerator3D::cleanup() {
 		generator_parsers.clear();
 		generator_rid_rwlock.write_unlock();
 	}
+
+	MutexLock tile_cache_lock(tile_cache_mutex);
+	tile_caches.clear();
 }
 
 void NavMeshGenerator3D::finish() {
@@ -662,24 +718,7 @@ void NavMeshGenerator3D::generator_parse_source_geometry_data(const Ref<Navigati
 	}
 };
 
-void NavMeshGenerator3D::generator_bake_from_source_geometry_data(Ref<NavigationMesh> p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data) {
-	if (p_navigation_mesh.is_null() || p_source_geometry_data.is_null()) {
-		return;
-	}
-
-	Vector<float> source_geometry_vertices;
-	Vector<int> source_geometry_indices;
-	Vector<NavigationMeshSourceGeometryData3D::ProjectedObstruction> projected_obstructions;
-
-	p_source_geometry_data->get_data(
-			source_geometry_vertices,
-			source_geometry_indices,
-			projected_obstructions);
-
-	if (source_geometry_vertices.size() < 3 || source_geometry_indices.size() < 3) {
-		return;
-	}
-
+static bool _generator_bake_recast(const Ref<NavigationMesh> &p_navigation_mesh, const rcConfig &p_config, const float *p_vertices, int p_vertex_count, const int *p_triangles, int p_triangle_count, const Vector<NavigationMeshSourceGeometryData3D::ProjectedObstruction> &p_projected_obstructions, Vector<Vector3> &r_vertices, Vector<Vector<int>> &r_polygons) {
 	rcHeightfield *hf = nullptr;
 	rcCompactHeightfield *chf = nullptr;
 	rcContourSet *cset = nullptr;
@@ -690,113 +729,30 @@ void NavMeshGenerator3D::generator_bake_from_source_geometry_data(Ref<Navigation
 	// added to keep track of steps, no functionality right now
 	String bake_state = "";
 
-	bake_state = "Setting up Configuration..."; // step #1
-
-	const float *verts = source_geometry_vertices.ptr();
-	const int nverts = source_geometry_vertices.size() / 3;
-	const int *tris = source_geometry_indices.ptr();
-	const int ntris = source_geometry_indices.size() / 3;
-
-	float bmin[3], bmax[3];
-	rcCalcBounds(verts, nverts, bmin, bmax);
-
-	rcConfig cfg;
-	memset(&cfg, 0, sizeof(cfg));
-
-	cfg.cs = p_navigation_mesh->get_cell_size();
-	cfg.ch = p_navigation_mesh->get_cell_height();
-	if (p_navigation_mesh->get_border_size() > 0.0) {
-		cfg.borderSize = (int)Math::ceil(p_navigation_mesh->get_border_size() / cfg.cs);
-	}
-	cfg.walkableSlopeAngle = p_navigation_mesh->get_agent_max_slope();
-	cfg.walkableHeight = (int)Math::ceil(p_navigation_mesh->get_agent_height() / cfg.ch);
-	cfg.walkableClimb = (int)Math::floor(p_navigation_mesh->get_agent_max_climb() / cfg.ch);
-	cfg.walkableRadius = (int)Math::ceil(p_navigation_mesh->get_agent_radius() / cfg.cs);
-	cfg.maxEdgeLen = (int)(p_navigation_mesh->get_edge_max_length() / p_navigation_mesh->get_cell_size());
-	cfg.maxSimplificationError = p_navigation_mesh->get_edge_max_error();
-	cfg.minRegionArea = (int)(p_navigation_mesh->get_region_min_size() * p_navigation_mesh->get_region_min_size());
-	cfg.mergeRegionArea = (int)(p_navigation_mesh->get_region_merge_size() * p_navigation_mesh->get_region_merge_size());
-	cfg.maxVertsPerPoly = (int)p_navigation_mesh->get_vertices_per_polygon();
-	cfg.detailSampleDist = MAX(p_navigation_mesh->get_cell_size() * p_navigation_mesh->get_detail_sample_distance(), 0.1f);
-	cfg.detailSampleMaxError = p_navigation_mesh->get_cell_height() * p_navigation_mesh->get_detail_sample_max_error();
-
-	if (p_navigation_mesh->get_border_size() > 0.0 && Math::fmod(p_navigation_mesh->get_border_size(), p_navigation_mesh->get_cell_size()) != 0.0) {
-		WARN_PRINT("Property border_size is ceiled to cell_size voxel units and loses precision.");
-	}
-	if (!Math::is_equal_approx((float)cfg.walkableHeight * cfg.ch, p_navigation_mesh->get_agent_height())) {
-		WARN_PRINT("Property agent_height is ceiled to cell_height voxel units and loses precision.");
-	}
-	if (!Math::is_equal_approx((float)cfg.walkableClimb * cfg.ch, p_navigation_mesh->get_agent_max_climb())) {
-		WARN_PRINT("Property agent_max_climb is floored to cell_height voxel units and loses precision.");
-	}
-	if (!Math::is_equal_approx((float)cfg.walkableRadius * cfg.cs, p_navigation_mesh->get_agent_radius())) {
-		WARN_PRINT("Property agent_radius is ceiled to cell_size voxel units and loses precision.");
-	}
-	if (!Math::is_equal_approx((float)cfg.maxEdgeLen * cfg.cs, p_navigation_mesh->get_edge_max_length())) {
-		WARN_PRINT("Property edge_max_length is rounded to cell_size voxel units and loses precision.");
-	}
-	if (!Math::is_equal_approx((float)cfg.minRegionArea, p_navigation_mesh->get_region_min_size() * p_navigation_mesh->get_region_min_size())) {
-		WARN_PRINT("Property region_min_size is converted to int and loses precision.");
-	}
-	if (!Math::is_equal_approx((float)cfg.mergeRegionArea, p_navigation_mesh->get_region_merge_size() * p_navigation_mesh->get_region_merge_size())) {
-		WARN_PRINT("Property region_merge_size is converted to int and loses precision.");
-	}
-	if (!Math::is_equal_approx((float)cfg.maxVertsPerPoly, p_navigation_mesh->get_vertices_per_polygon())) {
-		WARN_PRINT("Property vertices_per_polygon is converted to int and loses precision.");
-	}
-	if (p_navigation_mesh->get_cell_size() * p_navigation_mesh->get_detail_sample_distance() < 0.1f) {
-		WARN_PRINT("Property detail_sample_distance is clamped to 0.1 world units as the resulting value from multiplying with cell_size is too low.");
-	}
-
-	cfg.bmin[0] = bmin[0];
-	cfg.bmin[1] = bmin[1];
-	cfg.bmin[2] = bmin[2];
-	cfg.bmax[0] = bmax[0];
-	cfg.bmax[1] = bmax[1];
-	cfg.bmax[2] = bmax[2];
-
-	AABB baking_aabb = p_navigation_mesh->get_filter_baking_aabb();
-	if (baking_aabb.has_volume()) {
-		Vector3 baking_aabb_offset = p_navigation_mesh->get_filter_baking_aabb_offset();
-		cfg.bmin[0] = baking_aabb.position[0] + baking_aabb_offset.x;
-		cfg.bmin[1] = baking_aabb.position[1] + baking_aabb_offset.y;
-		cfg.bmin[2] = baking_aabb.position[2] + baking_aabb_offset.z;
-		cfg.bmax[0] = cfg.bmin[0] + baking_aabb.size[0];
-		cfg.bmax[1] = cfg.bmin[1] + baking_aabb.size[1];
-		cfg.bmax[2] = cfg.bmin[2] + baking_aabb.size[2];
-	}
-
-	bake_state = "Calculating grid size..."; // step #2
-	rcCalcGridSize(cfg.bmin, cfg.bmax, cfg.cs, &cfg.width, &cfg.height);
-
-	// ~30000000 seems to be around sweetspot where Editor baking breaks
-	if ((cfg.width * cfg.height) > 30000000 && GLOBAL_GET("navigation/baking/use_crash_prevention_checks")) {
-		ERR_FAIL_MSG("Baking interrupted."
-					 "\nNavigationMesh baking process would likely crash the engine."
-					 "\nSource geometry is suspiciously big for the current Cell Size and Cell Height in the NavMesh Resource bake settings."
-					 "\nIf baking does not crash the engine or fail, the resulting NavigationMesh will create serious pathfinding performance issues."
-					 "\nIt is advised to increase Cell Size and/or Cell Height in the NavMesh Resource bake settings or reduce the size / scale of the source geometry."
-					 "\nIf you would like to try baking anyway, disable the 'navigation/baking/use_crash_prevention_checks' project setting.");
-		return;
-	}
+	const rcConfig &cfg = p_config;
+	const float *verts = p_vertices;
+	const int nverts = p_vertex_count;
+	const int *tris = p_triangles;
+	const int ntris = p_triangle_count;
+	const Vector<NavigationMeshSourceGeometryData3D::ProjectedObstruction> &projected_obstructions = p_projected_obstructions;
 
 	bake_state = "Creating heightfield..."; // step #3
 	hf = rcAllocHeightfield();
 
-	ERR_FAIL_NULL(hf);
-	ERR_FAIL_COND(!rcCreateHeightfield(&ctx, *hf, cfg.width, cfg.height, cfg.bmin, cfg.bmax, cfg.cs, cfg.ch));
+	ERR_FAIL_NULL_V(hf, false);
+	ERR_FAIL_COND_V(!rcCreateHeightfield(&ctx, *hf, cfg.width, cfg.height, cfg.bmin, cfg.bmax, cfg.cs, cfg.ch), false);
 
 	bake_state = "Marking walkable triangles..."; // step #4
 	{
 		Vector<unsigned char> tri_areas;
 		tri_areas.resize(ntris);
 
-		ERR_FAIL_COND(tri_areas.is_empty());
+		ERR_FAIL_COND_V(tri_areas.is_empty(), false);
 
 		memset(tri_areas.ptrw(), 0, ntris * sizeof(unsigned char));
 		rcMarkWalkableTriangles(&ctx, cfg.walkableSlopeAngle, verts, nverts, tris, ntris, tri_areas.ptrw());
 
-		ERR_FAIL_COND(!rcRasterizeTriangles(&ctx, verts, nverts, tris, tri_areas.ptr(), ntris, *hf, cfg.walkableClimb));
+		ERR_FAIL_COND_V(!rcRasterizeTriangles(&ctx, verts, nverts, tris, tri_areas.ptr(), ntris, *hf, cfg.walkableClimb), false);
 	}
 
 	if (p_navigation_mesh->get_filter_low_hanging_obstacles()) {
@@ -813,8 +769,8 @@ void NavMeshGenerator3D::generator_bake_from_source_geometry_data(Ref<Navigation
 
 	chf = rcAllocCompactHeightfield();
 
-	ERR_FAIL_NULL(chf);
-	ERR_FAIL_COND(!rcBuildCompactHeightfield(&ctx, cfg.walkableHeight, cfg.walkableClimb, *hf, *chf));
+	ERR_FAIL_NULL_V(chf, false);
+	ERR_FAIL_COND_V(!rcBuildCompactHeightfield(&ctx, cfg.walkableHeight, cfg.walkableClimb, *hf, *chf), false);
 
 	rcFreeHeightField(hf);
 	hf = nullptr;
@@ -838,7 +794,7 @@ void NavMeshGenerator3D::generator_bake_from_source_geometry_data(Ref<Navigation
 
 	bake_state = "Eroding walkable area..."; // step #6
 
-	ERR_FAIL_COND(!rcErodeWalkableArea(&ctx, cfg.walkableRadius, *chf));
+	ERR_FAIL_COND_V(!rcErodeWalkableArea(&ctx, cfg.walkableRadius, *chf), false);
 
 	// Carve obstacles to the eroded geometry. Those will NOT be affected by e.g. agent_radius because that step is already done.
 	if (!projected_obstructions.is_empty()) {
@@ -860,30 +816,30 @@ void NavMeshGenerator3D::generator_bake_from_source_geometry_data(Ref<Navigation
 	bake_state = "Partitioning..."; // step #7
 
 	if (p_navigation_mesh->get_sample_partition_type() == NavigationMesh::SAMPLE_PARTITION_WATERSHED) {
-		ERR_FAIL_COND(!rcBuildDistanceField(&ctx, *chf));
-		ERR_FAIL_COND(!rcBuildRegions(&ctx, *chf, cfg.borderSize, cfg.minRegionArea, cfg.mergeRegionArea));
+		ERR_FAIL_COND_V(!rcBuildDistanceField(&ctx, *chf), false);
+		ERR_FAIL_COND_V(!rcBuildRegions(&ctx, *chf, cfg.borderSize, cfg.minRegionArea, cfg.mergeRegionArea), false);
 	} else if (p_navigation_mesh->get_sample_partition_type() == NavigationMesh::SAMPLE_PARTITION_MONOTONE) {
-		ERR_FAIL_COND(!rcBuildRegionsMonotone(&ctx, *chf, cfg.borderSize, cfg.minRegionArea, cfg.mergeRegionArea));
+		ERR_FAIL_COND_V(!rcBuildRegionsMonotone(&ctx, *chf, cfg.borderSize, cfg.minRegionArea, cfg.mergeRegionArea), false);
 	} else {
-		ERR_FAIL_COND(!rcBuildLayerRegions(&ctx, *chf, cfg.borderSize, cfg.minRegionArea));
+		ERR_FAIL_COND_V(!rcBuildLayerRegions(&ctx, *chf, cfg.borderSize, cfg.minRegionArea), false);
 	}
 
 	bake_state = "Creating contours..."; // step #8
 
 	cset = rcAllocContourSet();
 
-	ERR_FAIL_NULL(cset);
-	ERR_FAIL_COND(!rcBuildContours(&ctx, *chf, cfg.maxSimplificationError, cfg.maxEdgeLen, *cset));
+	ERR_FAIL_NULL_V(cset, false);
+	ERR_FAIL_COND_V(!rcBuildContours(&ctx, *chf, cfg.maxSimplificationError, cfg.maxEdgeLen, *cset), false);
 
 	bake_state = "Creating polymesh..."; // step #9
 
 	poly_mesh = rcAllocPolyMesh();
-	ERR_FAIL_NULL(poly_mesh);
-	ERR_FAIL_COND(!rcBuildPolyMesh(&ctx, *cset, cfg.maxVertsPerPoly, *poly_mesh));
+	ERR_FAIL_NULL_V(poly_mesh, false);
+	ERR_FAIL_COND_V(!rcBuildPolyMesh(&ctx, *cset, cfg.maxVertsPerPoly, *poly_mesh), false);
 
 	detail_mesh = rcAllocPolyMeshDetail();
-	ERR_FAIL_NULL(detail_mesh);
-	ERR_FAIL_COND(!rcBuildPolyMeshDetail(&ctx, *poly_mesh, *chf, cfg.detailSampleDist, cfg.detailSampleMaxError, *detail_mesh));
+	ERR_FAIL_NULL_V(detail_mesh, false);
+	ERR_FAIL_COND_V(!rcBuildPolyMeshDetail(&ctx, *poly_mesh, *chf, cfg.detailSampleDist, cfg.detailSampleMaxError, *detail_mesh), false);
 
 	rcFreeCompactHeightfield(chf);
 	chf = nullptr;
@@ -892,9 +848,6 @@ void NavMeshGenerator3D::generator_bake_from_source_geometry_data(Ref<Navigation
 
 	bake_state = "Converting to native navigation mesh..."; // step #10
 
-	Vector<Vector3> nav_vertices;
-	Vector<Vector<int>> nav_polygons;
-
 	HashMap<Vector3, int> recast_vertex_to_native_index;
 	LocalVector<int> recast_index_to_native_index;
 	recast_index_to_native_index.resize(detail_mesh->nverts);
@@ -907,7 +860,7 @@ void NavMeshGenerator3D::generator_bake_from_source_geometry_data(Ref<Navigation
 			int new_index = recast_vertex_to_native_index.size();
 			recast_index_to_native_index[i] = new_index;
 			recast_vertex_to_native_index[vertex] = new_index;
-			nav_vertices.push_back(vertex);
+			r_vertices.push_back(vertex);
 		} else {
 			recast_index_to_native_index[i] = *existing_index_ptr;
 		}
@@ -931,12 +884,10 @@ void NavMeshGenerator3D::generator_bake_from_source_geometry_data(Ref<Navigation
 			nav_indices.write[1] = recast_index_to_native_index[index2];
 			nav_indices.write[2] = recast_index_to_native_index[index3];
 
-			nav_polygons.push_back(nav_indices);
+			r_polygons.push_back(nav_indices);
 		}
 	}
 
-	p_navigation_mesh->set_data(nav_vertices, nav_polygons);
-
 	bake_state = "Cleanup..."; // step #11
 
 	rcFreePolyMesh(poly_mesh);
@@ -944,6 +895,520 @@ void NavMeshGenerator3D::generator_bake_from_source_geometry_data(Ref<Navigation
 	rcFreePolyMeshDetail(detail_mesh);
 	detail_mesh = nullptr;
 
+	return true;
+}
+
+struct NavMeshBakeTile3D {
+	/// In world space multiples of the tile size.
+	Vector2i coords;
+	/// World space cells of the tile inside its border, cut to the bake area.
+	Rect2i cells;
+	rcConfig config;
+	/// Source geometry triangles that overlap the tile and its border, 3 vertex indices each.
+	LocalVector<int> triangles;
+	Vector<NavigationMeshSourceGeometryData3D::ProjectedObstruction> projected_obstructions;
+	NavMeshBakedTile3D baked;
+};
+
+struct NavMeshBakeTiles3D {
+	Ref<NavigationMesh> navigation_mesh;
+	const float *vertices = nullptr;
+	int vertex_count = 0;
+	LocalVector<NavMeshBakeTile3D> tiles;
+	/// Tiles with source geometry that were not found in the cache.
+	LocalVector<uint32_t> dirty_tiles;
+};
+
+static void _generator_bake_tile(void *p_userdata, uint32_t p_index) {
+	NavMeshBakeTiles3D *bake = static_cast<NavMeshBakeTiles3D *>(p_userdata);
+	NavMeshBakeTile3D &tile = bake->tiles[bake->dirty_tiles[p_index]];
+	_generator_bake_recast(bake->navigation_mesh, tile.config, bake->vertices, bake->vertex_count, tile.triangles.ptr(), tile.triangles.size() / 3, tile.projected_obstructions, tile.baked.vertices, tile.baked.polygons);
+}
+
+void NavMeshGenerator3D::generator_bake_tiles(const Ref<NavigationMesh> &p_navigation_mesh, const rcConfig &p_config, const Vector<float> &p_vertices, const Vector<int> &p_indices, const Vector<NavigationMeshSourceGeometryData3D::ProjectedObstruction> &p_projected_obstructions) {
+	const float cs = p_config.cs;
+	const int tile_cells = (int)Math::ceil(p_navigation_mesh->get_tile_size() / cs);
+	if (!Math::is_equal_approx((float)tile_cells * cs, p_navigation_mesh->get_tile_size())) {
+		WARN_PRINT("Property tile_size is ceiled to cell_size voxel units and loses precision.");
+	}
+
+	// The tiles are anchored to world space multiples of the tile size, so that growing the bake area
+	// doesn't move them. They cover the cells of the bake area inside the border, their own border
+	// makes the erosion and regions match across tile edges.
+	const int area_min_x = (int)Math::floor(p_config.bmin[0] / cs + p_config.borderSize);
+	const int area_min_z = (int)Math::floor(p_config.bmin[2] / cs + p_config.borderSize);
+	const int area_max_x = (int)Math::ceil(p_config.bmin[0] / cs + p_config.width - p_config.borderSize);
+	const int area_max_z = (int)Math::ceil(p_config.bmin[2] / cs + p_config.height - p_config.borderSize);
+	if (area_max_x <= area_min_x || area_max_z <= area_min_z) {
+		p_navigation_mesh->set_data(Vector<Vector3>(), Vector<Vector<int>>());
+		return;
+	}
+	const int tile_border = p_config.walkableRadius + 3;
+	const float tile_world_size = tile_cells * cs;
+	const float tile_world_border = tile_border * cs;
+	const Vector2i first_tile((int)Math::floor((double)area_min_x / tile_cells), (int)Math::floor((double)area_min_z / tile_cells));
+	const Vector2i last_tile((int)Math::floor((double)(area_max_x - 1) / tile_cells), (int)Math::floor((double)(area_max_z - 1) / tile_cells));
+	const int tiles_x = last_tile.x - first_tile.x + 1;
+	const int tiles_z = last_tile.y - first_tile.y + 1;
+
+	// Only a bake AABB limits the height of the tiles, otherwise they take it from their own triangles.
+	const bool use_baking_aabb = p_navigation_mesh->get_filter_baking_aabb().has_volume();
+
+	NavMeshBakeTiles3D bake;
+	bake.navigation_mesh = p_navigation_mesh;
+	bake.vertices = p_vertices.ptr();
+	bake.vertex_count = p_vertices.size() / 3;
+	bake.tiles.resize(tiles_x * tiles_z);
+
+	for (int z = 0; z < tiles_z; z++) {
+		for (int x = 0; x < tiles_x; x++) {
+			NavMeshBakeTile3D &tile = bake.tiles[z * tiles_x + x];
+			tile.coords = first_tile + Vector2i(x, z);
+
+			// Tiles on the edges of the bake area are cut to it.
+			const int tile_min_x = tile.coords.x * tile_cells;
+			const int tile_min_z = tile.coords.y * tile_cells;
+			tile.cells = Rect2i(MAX(area_min_x, tile_min_x), MAX(area_min_z, tile_min_z), 0, 0);
+			tile.cells.size = Size2i(MIN(area_max_x, tile_min_x + tile_cells), MIN(area_max_z, tile_min_z + tile_cells)) - tile.cells.position;
+
+			rcConfig &cfg = tile.config;
+			cfg = p_config;
+			cfg.tileSize = tile_cells;
+			cfg.borderSize = tile_border;
+			cfg.width = tile.cells.size.x + tile_border * 2;
+			cfg.height = tile.cells.size.y + tile_border * 2;
+			cfg.bmin[0] = (tile.cells.position.x - tile_border) * cs;
+			cfg.bmin[2] = (tile.cells.position.y - tile_border) * cs;
+			cfg.bmax[0] = cfg.bmin[0] + cfg.width * cs;
+			cfg.bmax[2] = cfg.bmin[2] + cfg.height * cs;
+			cfg.bmin[1] = FLT_MAX;
+			cfg.bmax[1] = -FLT_MAX;
+		}
+	}
+
+	// Bin the triangles into all the tiles whose border they overlap.
+	const float *verts = p_vertices.ptr();
+	const int *tris = p_indices.ptr();
+	const int ntris = p_indices.size() / 3;
+	const float tiles_origin_x = first_tile.x * tile_world_size;
+	const float tiles_origin_z = first_tile.y * tile_world_size;
+	for (int i = 0; i < ntris; i++) {
+		const float *a = &verts[tris[i * 3 + 0] * 3];
+		const float *b = &verts[tris[i * 3 + 1] * 3];
+		const float *c = &verts[tris[i * 3 + 2] * 3];
+		const float min_x = MIN(a[0], MIN(b[0], c[0]));
+		const float max_x = MAX(a[0], MAX(b[0], c[0]));
+		const float min_y = MIN(a[1], MIN(b[1], c[1]));
+		const float max_y = MAX(a[1], MAX(b[1], c[1]));
+		const float min_z = MIN(a[2], MIN(b[2], c[2]));
+		const float max_z = MAX(a[2], MAX(b[2], c[2]));
+
+		const int first_x = MAX(0, (int)Math::floor((min_x - tiles_origin_x - tile_world_border) / tile_world_size));
+		const int last_x = MIN(tiles_x - 1, (int)Math::floor((max_x - tiles_origin_x + tile_world_border) / tile_world_size));
+		const int first_z = MAX(0, (int)Math::floor((min_z - tiles_origin_z - tile_world_border) / tile_world_size));
+		const int last_z = MIN(tiles_z - 1, (int)Math::floor((max_z - tiles_origin_z + tile_world_border) / tile_world_size));
+		for (int z = first_z; z <= last_z; z++) {
+			for (int x = first_x; x <= last_x; x++) {
+				NavMeshBakeTile3D &tile = bake.tiles[z * tiles_x + x];
+				tile.triangles.push_back(tris[i * 3 + 0]);
+				tile.triangles.push_back(tris[i * 3 + 1]);
+				tile.triangles.push_back(tris[i * 3 + 2]);
+				tile.config.bmin[1] = MIN(tile.config.bmin[1], min_y);
+				tile.config.bmax[1] = MAX(tile.config.bmax[1], max_y);
+			}
+		}
+	}
+
+	for (NavMeshBakeTile3D &tile : bake.tiles) {
+		rcConfig &cfg = tile.config;
+		if (!tile.triangles.is_empty()) {
+			// Heights are sampled from the bottom of the tile, snapping it to world space multiples of
+			// the cell height keeps them on the same steps in all the tiles.
+			cfg.bmin[1] = Math::floor(cfg.bmin[1] / cfg.ch) * cfg.ch;
+			if (use_baking_aabb) {
+				cfg.bmin[1] = MAX(cfg.bmin[1], p_config.bmin[1]);
+				cfg.bmax[1] = MIN(cfg.bmax[1], p_config.bmax[1]);
+			}
+		}
+
+		// The tile bounds follow from the coordinates, the cells and the triangles, so they are not part of the key.
+		NavMeshBakeTileKey3D &key = tile.baked.key;
+		key.config = cfg;
+		memset(key.config.bmin, 0, sizeof(key.config.bmin));
+		memset(key.config.bmax, 0, sizeof(key.config.bmax));
+		key.cells = tile.cells;
+		if (use_baking_aabb) {
+			key.baking_aabb_min_y = p_config.bmin[1];
+			key.baking_aabb_max_y = p_config.bmax[1];
+		}
+		key.sample_partition_type = p_navigation_mesh->get_sample_partition_type();
+		key.filter_low_hanging_obstacles = p_navigation_mesh->get_filter_low_hanging_obstacles();
+		key.filter_ledge_spans = p_navigation_mesh->get_filter_ledge_spans();
+		key.filter_walkable_low_height_spans = p_navigation_mesh->get_filter_walkable_low_height_spans();
+		key.triangle_count = tile.triangles.size() / 3;
+		key.input_checksum[0] = HASH_MURMUR3_SEED;
+		key.input_checksum[1] = hash_murmur3_one_32(HASH_MURMUR3_SEED);
+		for (uint32_t i = 0; i < tile.triangles.size(); i++) {
+			key.add_input(&verts[tile.triangles[i] * 3], sizeof(float) * 3);
+		}
+
+		for (const NavigationMeshSourceGeometryData3D::ProjectedObstruction &projected_obstruction : p_projected_obstructions) {
+			if (projected_obstruction.vertices.is_empty() || projected_obstruction.vertices.size() % 3 != 0) {
+				continue;
+			}
+			const float *obstruction_verts = projected_obstruction.vertices.ptr();
+			float min_x = obstruction_verts[0];
+			float max_x = obstruction_verts[0];
+			float min_z = obstruction_verts[2];
+			float max_z = obstruction_verts[2];
+			for (int i = 3; i < projected_obstruction.vertices.size(); i += 3) {
+				min_x = MIN(min_x, obstruction_verts[i]);
+				max_x = MAX(max_x, obstruction_verts[i]);
+				min_z = MIN(min_z, obstruction_verts[i + 2]);
+				max_z = MAX(max_z, obstruction_verts[i + 2]);
+			}
+			if (max_x < cfg.bmin[0] || min_x > cfg.bmax[0] || max_z < cfg.bmin[2] || min_z > cfg.bmax[2]) {
+				continue;
+			}
+
+			tile.projected_obstructions.push_back(projected_obstruction);
+			key.projected_obstruction_count++;
+			key.add_input(obstruction_verts, projected_obstruction.vertices.size() * sizeof(float));
+			key.add_input(&projected_obstruction.elevation, sizeof(float));
+			key.add_input(&projected_obstruction.height, sizeof(float));
+			key.add_input(&projected_obstruction.carve, sizeof(bool));
+		}
+	}
+
+	const ObjectID navigation_mesh_id = p_navigation_mesh->get_instance_id();
+	{
+		MutexLock tile_cache_lock(tile_cache_mutex);
+
+		// Drop the caches of the navigation meshes that no longer exist.
+		LocalVector<ObjectID> freed_navigation_mesh_ids;
+		for (const KeyValue<ObjectID, HashMap<Vector2i, NavMeshBakedTile3D>> &E : tile_caches) {
+			if (ObjectDB::get_instance(E.key) == nullptr) {
+				freed_navigation_mesh_ids.push_back(E.key);
+			}
+		}
+		for (const ObjectID &freed_navigation_mesh_id : freed_navigation_mesh_ids) {
+			tile_caches.erase(freed_navigation_mesh_id);
+		}
+
+		const HashMap<Vector2i, NavMeshBakedTile3D> *cached_tiles = tile_caches.getptr(navigation_mesh_id);
+		for (uint32_t i = 0; i < bake.tiles.size(); i++) {
+			NavMeshBakeTile3D &tile = bake.tiles[i];
+			const NavMeshBakedTile3D *cached_tile = cached_tiles ? cached_tiles->getptr(tile.coords) : nullptr;
+			if (cached_tile && cached_tile->key == tile.baked.key) {
+				tile.baked = *cached_tile;
+			} else if (!tile.triangles.is_empty()) {
+				bake.dirty_tiles.push_back(i);
+			}
+		}
+		baked_tile_count += bake.dirty_tiles.size();
+	}
+
+	if (baking_use_multiple_threads && bake.dirty_tiles.size() > 1) {
+		// High priority, as the bake itself can already run on one of the low priority threads.
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_native_group_task(&_generator_bake_tile, &bake, bake.dirty_tiles.size(), -1, true, SNAME("NavMeshGeneratorBakeTiles3D"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	} else {
+		for (uint32_t i = 0; i < bake.dirty_tiles.size(); i++) {
+			_generator_bake_tile(&bake, i);
+		}
+	}
+
+	// Merge the tiles. Neighboring tiles compute the vertices on their shared seam from different
+	// origins and sample their heights separately, so seam vertices are snapped onto the seam and
+	// welded by their position along it when their heights are within the agent climb. Other
+	// vertices are merged by position.
+	const float seam_tolerance = cs * 0.25f;
+	const float climb_tolerance = MAX(p_config.walkableClimb, 1) * p_config.ch;
+
+	Vector<Vector3> nav_vertices;
+	Vector<Vector<int>> nav_polygons;
+	HashMap<Vector3, int> vertex_to_index;
+	// Per merged vertex, the cell column of the x seam and the cell row of the z seam it is on, or NO_SEAM.
+	constexpr int NO_SEAM = INT32_MIN;
+	LocalVector<int> vertex_seam_x;
+	LocalVector<int> vertex_seam_z;
+	// Seam vertices by seam (axis, cell) and cell along the seam, to weld them.
+	HashMap<Vector3i, LocalVector<int>> seam_cell_to_indices;
+	// Seam vertices by seam (axis, cell), to split polygon edges that end in T-junctions.
+	HashMap<Vector2i, LocalVector<int>> seam_to_indices;
+	LocalVector<int> tile_index_to_index;
+
+	for (const NavMeshBakeTile3D &tile : bake.tiles) {
+		tile_index_to_index.resize(tile.baked.vertices.size());
+		for (int i = 0; i < tile.baked.vertices.size(); i++) {
+			Vector3 vertex = tile.baked.vertices[i];
+
+			const float cell_x = vertex.x / cs;
+			const float cell_z = vertex.z / cs;
+			int seam_x = (int)Math::round(cell_x);
+			int seam_z = (int)Math::round(cell_z);
+			if (Math::abs(cell_x - seam_x) * cs > seam_tolerance || seam_x % tile_cells != 0 || seam_x <= area_min_x || seam_x >= area_max_x) {
+				seam_x = NO_SEAM;
+			}
+			if (Math::abs(cell_z - seam_z) * cs > seam_tolerance || seam_z % tile_cells != 0 || seam_z <= area_min_z || seam_z >= area_max_z) {
+				seam_z = NO_SEAM;
+			}
+
+			if (seam_x == NO_SEAM && seam_z == NO_SEAM) {
+				const int *existing_index_ptr = vertex_to_index.getptr(vertex);
+				if (existing_index_ptr) {
+					tile_index_to_index[i] = *existing_index_ptr;
+				} else {
+					const int new_index = nav_vertices.size();
+					tile_index_to_index[i] = new_index;
+					vertex_to_index.insert(vertex, new_index);
+					nav_vertices.push_back(vertex);
+					vertex_seam_x.push_back(NO_SEAM);
+					vertex_seam_z.push_back(NO_SEAM);
+				}
+				continue;
+			}
+
+			if (seam_x != NO_SEAM) {
+				vertex.x = seam_x * cs;
+			}
+			if (seam_z != NO_SEAM) {
+				vertex.z = seam_z * cs;
+			}
+
+			// Corners are welded on the x seam, both tiles see them on both seams.
+			const Vector3i seam_cell = seam_x != NO_SEAM ? Vector3i(0, seam_x, (int)Math::round(cell_z)) : Vector3i(1, seam_z, (int)Math::round(cell_x));
+			int index = -1;
+			for (int cell_offset = -1; cell_offset <= 1 && index == -1; cell_offset++) {
+				const LocalVector<int> *cell_indices = seam_cell_to_indices.getptr(seam_cell + Vector3i(0, 0, cell_offset));
+				if (!cell_indices) {
+					continue;
+				}
+				for (const int cell_index : *cell_indices) {
+					const Vector3 &other = nav_vertices[cell_index];
+					if (Math::abs(other.x - vertex.x) <= seam_tolerance && Math::abs(other.z - vertex.z) <= seam_tolerance && Math::abs(other.y - vertex.y) <= climb_tolerance) {
+						index = cell_index;
+						break;
+					}
+				}
+			}
+
+			if (index == -1) {
+				index = nav_vertices.size();
+				nav_vertices.push_back(vertex);
+				vertex_seam_x.push_back(seam_x);
+				vertex_seam_z.push_back(seam_z);
+				seam_cell_to_indices[seam_cell].push_back(index);
+				if (seam_x != NO_SEAM) {
+					seam_to_indices[Vector2i(0, seam_x)].push_back(index);
+				}
+				if (seam_z != NO_SEAM) {
+					seam_to_indices[Vector2i(1, seam_z)].push_back(index);
+				}
+			}
+			tile_index_to_index[i] = index;
+		}
+
+		for (const Vector<int> &tile_polygon : tile.baked.polygons) {
+			Vector<int> polygon;
+			for (int i = 0; i < tile_polygon.size(); i++) {
+				const int index = tile_index_to_index[tile_polygon[i]];
+				// Welding can collapse an edge along the seam.
+				if (polygon.is_empty() || (polygon[polygon.size() - 1] != index && (i < tile_polygon.size() - 1 || polygon[0] != index))) {
+					polygon.push_back(index);
+				}
+			}
+			if (polygon.size() >= 3) {
+				nav_polygons.push_back(polygon);
+			}
+		}
+	}
+
+	// A polygon edge on a seam can span several edges of the neighboring tile, add the vertices of
+	// the other side to it so the edges match exactly and the polygons connect.
+	const Vector3 *nav_vertices_ptr = nav_vertices.ptr();
+	LocalVector<Pair<float, int>> split_vertices;
+	for (Vector<int> &polygon : nav_polygons) {
+		Vector<int> split_polygon;
+		for (int i = 0; i < polygon.size(); i++) {
+			const int index_a = polygon[i];
+			const int index_b = polygon[(i + 1) % polygon.size()];
+			split_polygon.push_back(index_a);
+
+			Vector2i seam;
+			if (vertex_seam_x[index_a] != NO_SEAM && vertex_seam_x[index_a] == vertex_seam_x[index_b]) {
+				seam = Vector2i(0, vertex_seam_x[index_a]);
+			} else if (vertex_seam_z[index_a] != NO_SEAM && vertex_seam_z[index_a] == vertex_seam_z[index_b]) {
+				seam = Vector2i(1, vertex_seam_z[index_a]);
+			} else {
+				continue;
+			}
+
+			const Vector3 &a = nav_vertices_ptr[index_a];
+			const Vector3 &b = nav_vertices_ptr[index_b];
+			const float along_a = seam.x == 0 ? a.z : a.x;
+			const float along_b = seam.x == 0 ? b.z : b.x;
+			const float edge_length = along_b - along_a;
+			if (Math::abs(edge_length) <= seam_tolerance * 2.0f) {
+				continue;
+			}
+
+			split_vertices.clear();
+			for (const int index_c : seam_to_indices[seam]) {
+				const Vector3 &c = nav_vertices_ptr[index_c];
+				const float t = ((seam.x == 0 ? c.z : c.x) - along_a) / edge_length;
+				if (t * Math::abs(edge_length) <= seam_tolerance || (1.0f - t) * Math::abs(edge_length) <= seam_tolerance) {
+					continue;
+				}
+				if (Math::abs(c.y - Math::lerp(a.y, b.y, t)) > climb_tolerance) {
+					continue;
+				}
+				split_vertices.push_back(Pair<float, int>(t, index_c));
+			}
+			split_vertices.sort_custom<PairSort<float, int>>();
+			for (const Pair<float, int> &split_vertex : split_vertices) {
+				split_polygon.push_back(split_vertex.second);
+			}
+		}
+		if (split_polygon.size() != polygon.size()) {
+			polygon = split_polygon;
+		}
+	}
+
+	p_navigation_mesh->set_data(nav_vertices, nav_polygons);
+
+	MutexLock tile_cache_lock(tile_cache_mutex);
+	HashMap<Vector2i, NavMeshBakedTile3D> &cached_tiles = tile_caches[navigation_mesh_id];
+	cached_tiles.clear();
+	for (const NavMeshBakeTile3D &tile : bake.tiles) {
+		cached_tiles.insert(tile.coords, tile.baked);
+	}
+}
+
+void NavMeshGenerator3D::generator_bake_from_source_geometry_data(Ref<NavigationMesh> p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data) {
+	if (p_navigation_mesh.is_null() || p_source_geometry_data.is_null()) {
+		return;
+	}
+
+	Vector<float> source_geometry_vertices;
+	Vector<int> source_geometry_indices;
+	Vector<NavigationMeshSourceGeometryData3D::ProjectedObstruction> projected_obstructions;
+
+	p_source_geometry_data->get_data(
+			source_geometry_vertices,
+			source_geometry_indices,
+			projected_obstructions);
+
+	if (source_geometry_vertices.size() < 3 || source_geometry_indices.size() < 3) {
+		return;
+	}
+
+	// added to keep track of steps, no functionality right now
+	String bake_state = "";
+
+	bake_state = "Setting up Configuration..."; // step #1
+
+	const float *verts = source_geometry_vertices.ptr();
+	const int nverts = source_geometry_vertices.size() / 3;
+	const int *tris = source_geometry_indices.ptr();
+	const int ntris = source_geometry_indices.size() / 3;
+
+	float bmin[3], bmax[3];
+	rcCalcBounds(verts, nverts, bmin, bmax);
+
+	rcConfig cfg;
+	memset(&cfg, 0, sizeof(cfg));
+
+	cfg.cs = p_navigation_mesh->get_cell_size();
+	cfg.ch = p_navigation_mesh->get_cell_height();
+	if (p_navigation_mesh->get_border_size() > 0.0) {
+		cfg.borderSize = (int)Math::ceil(p_navigation_mesh->get_border_size() / cfg.cs);
+	}
+	cfg.walkableSlopeAngle = p_navigation_mesh->get_agent_max_slope();
+	cfg.walkableHeight = (int)Math::ceil(p_navigation_mesh->get_agent_height() / cfg.ch);
+	cfg.walkableClimb = (int)Math::floor(p_navigation_mesh->get_agent_max_climb() / cfg.ch);
+	cfg.walkableRadius = (int)Math::ceil(p_navigation_mesh->get_agent_radius() / cfg.cs);
+	cfg.maxEdgeLen = (int)(p_navigation_mesh->get_edge_max_length() / p_navigation_mesh->get_cell_size());
+	cfg.maxSimplificationError = p_navigation_mesh->get_edge_max_error();
+	cfg.minRegionArea = (int)(p_navigation_mesh->get_region_min_size() * p_navigation_mesh->get_region_min_size());
+	cfg.mergeRegionArea = (int)(p_navigation_mesh->get_region_merge_size() * p_navigation_mesh->get_region_merge_size());
+	cfg.maxVertsPerPoly = (int)p_navigation_mesh->get_vertices_per_polygon();
+	cfg.detailSampleDist = MAX(p_navigation_mesh->get_cell_size() * p_navigation_mesh->get_detail_sample_distance(), 0.1f);
+	cfg.detailSampleMaxError = p_navigation_mesh->get_cell_height() * p_navigation_mesh->get_detail_sample_max_error();
+
+	if (p_navigation_mesh->get_border_size() > 0.0 && Math::fmod(p_navigation_mesh->get_border_size(), p_navigation_mesh->get_cell_size()) != 0.0) {
+		WARN_PRINT("Property border_size is ceiled to cell_size voxel units and loses precision.");
+	}
+	if (!Math::is_equal_approx((float)cfg.walkableHeight * cfg.ch, p_navigation_mesh->get_agent_height())) {
+		WARN_PRINT("Property agent_height is ceiled to cell_height voxel units and loses precision.");
+	}
+	if (!Math::is_equal_approx((float)cfg.walkableClimb * cfg.ch, p_navigation_mesh->get_agent_max_climb())) {
+		WARN_PRINT("Property agent_max_climb is floored to cell_height voxel units and loses precision.");
+	}
+	if (!Math::is_equal_approx((float)cfg.walkableRadius * cfg.cs, p_navigation_mesh->get_agent_radius())) {
+		WARN_PRINT("Property agent_radius is ceiled to cell_size voxel units and loses precision.");
+	}
+	if (!Math::is_equal_approx((float)cfg.maxEdgeLen * cfg.cs, p_navigation_mesh->get_edge_max_length())) {
+		WARN_PRINT("Property edge_max_length is rounded to cell_size voxel units and loses precision.");
+	}
+	if (!Math::is_equal_approx((float)cfg.minRegionArea, p_navigation_mesh->get_region_min_size() * p_navigation_mesh->get_region_min_size())) {
+		WARN_PRINT("Property region_min_size is converted to int and loses precision.");
+	}
+	if (!Math::is_equal_approx((float)cfg.mergeRegionArea, p_navigation_mesh->get_region_merge_size() * p_navigation_mesh->get_region_merge_size())) {
+		WARN_PRINT("Property region_merge_size is converted to int and loses precision.");
+	}
+	if (!Math::is_equal_approx((float)cfg.maxVertsPerPoly, p_navigation_mesh->get_vertices_per_polygon())) {
+		WARN_PRINT("Property vertices_per_polygon is converted to int and loses precision.");
+	}
+	if (p_navigation_mesh->get_cell_size() * p_navigation_mesh->get_detail_sample_distance() < 0.1f) {
+		WARN_PRINT("Property detail_sample_distance is clamped to 0.1 world units as the resulting value from multiplying with cell_size is too low.");
+	}
+
+	cfg.bmin[0] = bmin[0];
+	cfg.bmin[1] = bmin[1];
+	cfg.bmin[2] = bmin[2];
+	cfg.bmax[0] = bmax[0];
+	cfg.bmax[1] = bmax[1];
+	cfg.bmax[2] = bmax[2];
+
+	AABB baking_aabb = p_navigation_mesh->get_filter_baking_aabb();
+	if (baking_aabb.has_volume()) {
+		Vector3 baking_aabb_offset = p_navigation_mesh->get_filter_baking_aabb_offset();
+		cfg.bmin[0] = baking_aabb.position[0] + baking_aabb_offset.x;
+		cfg.bmin[1] = baking_aabb.position[1] + baking_aabb_offset.y;
+		cfg.bmin[2] = baking_aabb.position[2] + baking_aabb_offset.z;
+		cfg.bmax[0] = cfg.bmin[0] + baking_aabb.size[0];
+		cfg.bmax[1] = cfg.bmin[1] + baking_aabb.size[1];
+		cfg.bmax[2] = cfg.bmin[2] + baking_aabb.size[2];
+	}
+
+	bake_state = "Calculating grid size..."; // step #2
+	rcCalcGridSize(cfg.bmin, cfg.bmax, cfg.cs, &cfg.width, &cfg.height);
+
+	// ~30000000 seems to be around sweetspot where Editor baking breaks
+	if ((cfg.width * cfg.height) > 30000000 && GLOBAL_GET("navigation/baking/use_crash_prevention_checks")) {
+		ERR_FAIL_MSG("Baking interrupted."
+					 "\nNavigationMesh baking process would likely crash the engine."
+					 "\nSource geometry is suspiciously big for the current Cell Size and Cell Height in the NavMesh Resource bake settings."
+					 "\nIf baking does not crash the engine or fail, the resulting NavigationMesh will create serious pathfinding performance issues."
+					 "\nIt is advised to increase Cell Size and/or Cell Height in the NavMesh Resource bake settings or reduce the size / scale of the source geometry."
+					 "\nIf you would like to try baking anyway, disable the 'navigation/baking/use_crash_prevention_checks' project setting.");
+		return;
+	}
+
+	if (p_navigation_mesh->get_tile_size() > 0.0) {
+		generator_bake_tiles(p_navigation_mesh, cfg, source_geometry_vertices, source_geometry_indices, projected_obstructions);
+		return;
+	}
+
+	Vector<Vector3> nav_vertices;
+	Vector<Vector<int>> nav_polygons;
+	if (!_generator_bake_recast(p_navigation_mesh, cfg, verts, nverts, tris, ntris, projected_obstructions, nav_vertices, nav_polygons)) {
+		return;
+	}
+
+	p_navigation_mesh->set_data(nav_vertices, nav_polygons);
+
 	bake_state = "Baking finished."; // step #12
 }
 
@@ -35,6 +35,7 @@
 #include "../nav_base.h"
 
 #include "core/math/geometry_3d.h"
+#include "core/templates/sort_array.h"
 
 #define THREE_POINTS_CROSS_PRODUCT(m_a, m_b, m_c) (((m_c) - (m_a)).cross((m_b) - (m_a)))
 
@@ -49,6 +50,448 @@
 		r_path_owners->push_back(poly->owner->get_owner_id()); \
 	}
 
+struct PolygonBVHCenterComparator {
+	/// Centers of the sorted indices, starting at index `offset`.
+	const Vector3 *centers = nullptr;
+	uint32_t offset = 0;
+	int axis = 0;
+
+	_FORCE_INLINE_ bool operator()(uint32_t p_a, uint32_t p_b) const {
+		return centers[p_a - offset][axis] < centers[p_b - offset][axis];
+	}
+};
+
+struct PolygonBVHBuildTask {
+	uint32_t node = 0;
+	uint32_t first = 0;
+	uint32_t count = 0;
+};
+
+static _FORCE_INLINE_ real_t _aabb_distance_squared_to(const AABB &p_aabb, const Vector3 &p_point) {
+	return p_point.clamp(p_aabb.position, p_aabb.position + p_aabb.size).distance_squared_to(p_point);
+}
+
+// Ties are resolved in favor of the polygon with the lowest index, so the results match a linear scan over the polygons.
+static _FORCE_INLINE_ bool _is_closer(real_t p_distance, uint32_t p_index, real_t p_closest_distance, uint32_t p_closest_index) {
+	return p_distance < p_closest_distance || (p_distance == p_closest_distance && p_index < p_closest_index);
+}
+
+// Branch and bound search for the polygon face closest to `p_point`, at most `sqrt(p_max_distance_squared)` away.
+// When `p_filter_layers` is set, only polygons of regions with layers compatible with `p_navigation_layers` are considered.
+static const gd::Polygon *_polygons_bvh_get_closest(const LocalVector<gd::Polygon> &p_polygons, const gd::PolygonBVH &p_bvh, const Vector3 &p_point, bool p_filter_layers, uint32_t p_navigation_layers, Vector3 &r_point, Vector3 *r_normal, real_t p_max_distance_squared = FLT_MAX) {
+	const gd::Polygon *closest_polygon = nullptr;
+	uint32_t closest_index = UINT32_MAX; // Any index wins a tie against the maximum distance.
+	real_t closest_distance_squared = p_max_distance_squared;
+
+	if (p_bvh.nodes.is_empty()) {
+		return nullptr;
+	}
+
+	uint32_t stack[gd::PolygonBVH::STACK_SIZE];
+	uint32_t stack_size = 0;
+	stack[stack_size++] = 0;
+
+	while (stack_size > 0) {
+		const gd::PolygonBVH::Node &node = p_bvh.nodes[stack[--stack_size]];
+		if (_aabb_distance_squared_to(node.aabb, p_point) > closest_distance_squared) {
+			continue;
+		}
+
+		if (!node.is_leaf()) {
+			ERR_FAIL_COND_V_MSG(stack_size + 2 > gd::PolygonBVH::STACK_SIZE, closest_polygon, "Navigation polygon BVH is too deep to be traversed.");
+			// Push the farthest child first so the nearest one is visited first and tightens the bound sooner.
+			const uint32_t child_a = node.first;
+			const uint32_t child_b = node.first + 1;
+			if (_aabb_distance_squared_to(p_bvh.nodes[child_a].aabb, p_point) < _aabb_distance_squared_to(p_bvh.nodes[child_b].aabb, p_point)) {
+				stack[stack_size++] = child_b;
+				stack[stack_size++] = child_a;
+			} else {
+				stack[stack_size++] = child_a;
+				stack[stack_size++] = child_b;
+			}
+			continue;
+		}
+
+		for (uint32_t i = node.first; i < node.first + node.count; i++) {
+			const uint32_t polygon_index = p_bvh.polygon_indices[i];
+			const gd::Polygon &polygon = p_polygons[polygon_index];
+
+			// Only consider the polygon if it in a region with compatible layers.
+			if (p_filter_layers && (p_navigation_layers & polygon.owner->get_navigation_layers()) == 0) {
+				continue;
+			}
+			if (_aabb_distance_squared_to(p_bvh.polygon_aabbs[polygon_index], p_point) > closest_distance_squared) {
+				continue;
+			}
+
+			for (size_t point_id = 2; point_id < polygon.points.size(); point_id++) {
+				const Face3 face(polygon.points[0].pos, polygon.points[point_id - 1].pos, polygon.points[point_id].pos);
+				const Vector3 closest_point_on_face = face.get_closest_point_to(p_point);
+				const real_t distance_squared_to_point = closest_point_on_face.distance_squared_to(p_point);
+				if (_is_closer(distance_squared_to_point, polygon_index, closest_distance_squared, closest_index)) {
+					closest_polygon = &polygon;
+					closest_index = polygon_index;
+					closest_distance_squared = distance_squared_to_point;
+					r_point = closest_point_on_face;
+					if (r_normal) {
+						*r_normal = face.get_plane().normal;
+					}
+				}
+			}
+		}
+	}
+
+	return closest_polygon;
+}
+
+// Builds the subtree of the polygons in `p_range`, in the nodes reserved for that range.
+static void _polygons_build_bvh_subtree(const LocalVector<gd::Polygon> &p_polygons, gd::PolygonBVH &r_bvh, const gd::PolygonRange &p_range, LocalVector<Vector3> &r_centers) {
+	const uint32_t polygon_count = p_range.end - p_range.begin;
+	r_centers.resize(polygon_count);
+
+	for (uint32_t i = p_range.begin; i < p_range.end; i++) {
+		const gd::Polygon &polygon = p_polygons[i];
+		AABB aabb;
+		if (!polygon.points.is_empty()) {
+			aabb.position = polygon.points[0].pos;
+			for (uint32_t point_id = 1; point_id < polygon.points.size(); point_id++) {
+				aabb.expand_to(polygon.points[point_id].pos);
+			}
+		}
+		r_bvh.polygon_aabbs[i] = aabb;
+		r_centers[i - p_range.begin] = aabb.get_center();
+		r_bvh.polygon_indices[i] = i;
+	}
+
+	LocalVector<PolygonBVHBuildTask> tasks;
+	const uint32_t root = 1 + p_range.begin;
+	uint32_t next_node = root + 1;
+	tasks.push_back({ root, p_range.begin, polygon_count });
+
+	SortArray<uint32_t, PolygonBVHCenterComparator> sorter;
+	sorter.compare.centers = r_centers.ptr();
+	sorter.compare.offset = p_range.begin;
+
+	while (!tasks.is_empty()) {
+		const PolygonBVHBuildTask task = tasks[tasks.size() - 1];
+		tasks.remove_at(tasks.size() - 1);
+
+		const uint32_t *indices = r_bvh.polygon_indices.ptr() + task.first;
+		AABB aabb = r_bvh.polygon_aabbs[indices[0]];
+		AABB center_bounds(r_centers[indices[0] - p_range.begin], Vector3());
+		for (uint32_t i = 1; i < task.count; i++) {
+			aabb.merge_with(r_bvh.polygon_aabbs[indices[i]]);
+			center_bounds.expand_to(r_centers[indices[i] - p_range.begin]);
+		}
+		r_bvh.nodes[task.node].aabb = aabb;
+
+		if (task.count <= gd::PolygonBVH::LEAF_SIZE) {
+			r_bvh.nodes[task.node].first = task.first;
+			r_bvh.nodes[task.node].count = task.count;
+			continue;
+		}
+
+		// Split at the median polygon center along the longest axis, which keeps the tree balanced.
+		// Both halves keep at least two polygons, so the subtree never has more nodes than polygons.
+		const uint32_t half = task.count / 2;
+		sorter.compare.axis = center_bounds.get_longest_axis_index();
+		sorter.nth_element(task.first, task.first + task.count, task.first + half, r_bvh.polygon_indices.ptr());
+
+		const uint32_t child = next_node;
+		next_node += 2;
+		DEV_ASSERT(next_node <= 1 + p_range.end);
+		r_bvh.nodes[task.node].first = child;
+		r_bvh.nodes[task.node].count = 0;
+
+		tasks.push_back({ child, task.first, half });
+		tasks.push_back({ child + 1, task.first + half, task.count - half });
+	}
+}
+
+// Rebuilds the top-level tree over the subtree roots, after the subtree nodes.
+static void _polygons_build_bvh_top(gd::PolygonBVH &r_bvh, uint32_t p_polygon_count) {
+	const uint32_t subtree_count = r_bvh.subtrees.size();
+	if (subtree_count == 0) {
+		r_bvh.nodes.clear();
+		return;
+	}
+	r_bvh.nodes.resize(1 + p_polygon_count);
+
+	LocalVector<uint32_t> subtree_indices;
+	LocalVector<Vector3> centers;
+	subtree_indices.resize(subtree_count);
+	centers.resize(subtree_count);
+	for (uint32_t i = 0; i < subtree_count; i++) {
+		subtree_indices[i] = i;
+		centers[i] = r_bvh.nodes[1 + r_bvh.subtrees[i].begin].aabb.get_center();
+	}
+
+	LocalVector<PolygonBVHBuildTask> tasks;
+	tasks.push_back({ 0, 0, subtree_count });
+
+	SortArray<uint32_t, PolygonBVHCenterComparator> sorter;
+	sorter.compare.centers = centers.ptr();
+
+	while (!tasks.is_empty()) {
+		const PolygonBVHBuildTask task = tasks[tasks.size() - 1];
+		tasks.remove_at(tasks.size() - 1);
+
+		const uint32_t *indices = subtree_indices.ptr() + task.first;
+		if (task.count == 1) {
+			// A copy of the subtree root has the same children.
+			r_bvh.nodes[task.node] = r_bvh.nodes[1 + r_bvh.subtrees[indices[0]].begin];
+			continue;
+		}
+
+		AABB aabb = r_bvh.nodes[1 + r_bvh.subtrees[indices[0]].begin].aabb;
+		AABB center_bounds(centers[indices[0]], Vector3());
+		for (uint32_t i = 1; i < task.count; i++) {
+			aabb.merge_with(r_bvh.nodes[1 + r_bvh.subtrees[indices[i]].begin].aabb);
+			center_bounds.expand_to(centers[indices[i]]);
+		}
+		r_bvh.nodes[task.node].aabb = aabb;
+
+		const uint32_t half = task.count / 2;
+		sorter.compare.axis = center_bounds.get_longest_axis_index();
+		sorter.nth_element(task.first, task.first + task.count, task.first + half, subtree_indices.ptr());
+
+		const uint32_t child = r_bvh.nodes.size();
+		r_bvh.nodes.resize(child + 2);
+		r_bvh.nodes[task.node].first = child;
+		r_bvh.nodes[task.node].count = 0;
+
+		tasks.push_back({ child, task.first, half });
+		tasks.push_back({ child + 1, task.first + half, task.count - half });
+	}
+}
+
+void NavMeshQueries3D::polygons_build_bvh(const LocalVector<gd::Polygon> &p_polygons, gd::PolygonBVH &r_bvh) {
+	r_bvh.clear();
+
+	const uint32_t polygon_count = p_polygons.size();
+	if (polygon_count == 0) {
+		return;
+	}
+
+	r_bvh.polygon_aabbs.resize(polygon_count);
+	r_bvh.polygon_indices.resize(polygon_count);
+	r_bvh.nodes.resize(1 + polygon_count);
+
+	// Each run of polygons with the same owner is the range of a region.
+	// Skip the unused polygons left by the map between regions.
+	LocalVector<Vector3> centers;
+	uint32_t begin = 0;
+	while (begin < polygon_count) {
+		const NavBase *owner = p_polygons[begin].owner;
+		uint32_t end = begin + 1;
+		while (end < polygon_count && p_polygons[end].owner == owner) {
+			end++;
+		}
+		if (owner) {
+			const gd::PolygonRange range = { begin, end };
+			_polygons_build_bvh_subtree(p_polygons, r_bvh, range, centers);
+			r_bvh.subtrees.push_back(range);
+		}
+		begin = end;
+	}
+
+	_polygons_build_bvh_top(r_bvh, polygon_count);
+}
+
+void NavMeshQueries3D::polygons_update_bvh(const LocalVector<gd::Polygon> &p_polygons, gd::PolygonBVH &r_bvh, const LocalVector<gd::PolygonRange> &p_released_ranges, const LocalVector<gd::PolygonRange> &p_synced_ranges) {
+	// The released ranges are holes now, or were overwritten by the synced ranges.
+	for (uint32_t i = 0; i < r_bvh.subtrees.size();) {
+		bool released = false;
+		for (const gd::PolygonRange &range : p_released_ranges) {
+			if (r_bvh.subtrees[i].begin >= range.begin && r_bvh.subtrees[i].begin < range.end) {
+				released = true;
+				break;
+			}
+		}
+		if (released) {
+			r_bvh.subtrees.remove_at_unordered(i);
+		} else {
+			i++;
+		}
+	}
+
+	const uint32_t polygon_count = p_polygons.size();
+	r_bvh.polygon_aabbs.resize(polygon_count);
+	r_bvh.polygon_indices.resize(polygon_count);
+	r_bvh.nodes.resize(1 + polygon_count);
+
+	LocalVector<Vector3> centers;
+	for (const gd::PolygonRange &range : p_synced_ranges) {
+		if (range.end > range.begin) {
+			_polygons_build_bvh_subtree(p_polygons, r_bvh, range, centers);
+			r_bvh.subtrees.push_back(range);
+		}
+	}
+
+	_polygons_build_bvh_top(r_bvh, polygon_count);
+}
+
+// Splits the subtree range in clusters of about `r_clusters.cluster_size` polygons and appends the new cluster indices.
+// The BVH build splits the polygons at the median of their centers,
+// so consecutive polygon indices of a BVH subtree are spatially close.
+static void _polygon_clusters_add_range(const gd::PolygonBVH &p_bvh, const gd::PolygonRange &p_range, gd::PolygonClusterGraph &r_clusters, LocalVector<uint32_t> &r_cluster_indices) {
+	const uint32_t count = p_range.end - p_range.begin;
+	const uint32_t run_count = (count + r_clusters.cluster_size - 1) / r_clusters.cluster_size;
+	for (uint32_t run = 0; run < run_count; run++) {
+		uint32_t cluster_index;
+		if (r_clusters.free_clusters.is_empty()) {
+			cluster_index = r_clusters.clusters.size();
+			r_clusters.clusters.push_back(gd::PolygonClusterGraph::Cluster());
+		} else {
+			cluster_index = r_clusters.free_clusters[r_clusters.free_clusters.size() - 1];
+			r_clusters.free_clusters.resize(r_clusters.free_clusters.size() - 1);
+		}
+
+		gd::PolygonClusterGraph::Cluster &cluster = r_clusters.clusters[cluster_index];
+		cluster.range = { p_range.begin + run * count / run_count, p_range.begin + (run + 1) * count / run_count };
+
+		Vector3 center;
+		for (uint32_t i = cluster.range.begin; i < cluster.range.end; i++) {
+			const uint32_t polygon_index = p_bvh.polygon_indices[i];
+			r_clusters.polygon_clusters[polygon_index] = cluster_index;
+			center += p_bvh.polygon_aabbs[polygon_index].get_center();
+		}
+		cluster.center = center / (cluster.range.end - cluster.range.begin);
+		r_cluster_indices.push_back(cluster_index);
+	}
+}
+
+// Collects the neighbors of the cluster from the connections of its polygons.
+// Returns true when some of them are connected through navigation links.
+static bool _polygon_clusters_update_neighbors(const LocalVector<gd::Polygon> &p_polygons, const gd::PolygonBVH &p_bvh, uint32_t p_cluster_index, gd::PolygonClusterGraph &r_clusters, LocalVector<uint32_t> &r_scratch) {
+	const uint32_t polygon_count = p_polygons.size();
+	gd::PolygonClusterGraph::Cluster &cluster = r_clusters.clusters[p_cluster_index];
+
+	bool has_links = false;
+	r_scratch.clear();
+	for (uint32_t i = cluster.range.begin; i < cluster.range.end; i++) {
+		for (const gd::Edge &edge : p_polygons[p_bvh.polygon_indices[i]].edges) {
+			for (const gd::Edge::Connection &connection : edge.connections) {
+				if (connection.polygon->id < polygon_count) {
+					r_scratch.push_back(r_clusters.polygon_clusters[connection.polygon->id]);
+					continue;
+				}
+				// Link polygons are not clustered, they connect the clusters of the polygons at both ends.
+				has_links = true;
+				for (const gd::Edge &link_edge : connection.polygon->edges) {
+					for (const gd::Edge::Connection &link_connection : link_edge.connections) {
+						if (link_connection.polygon->id < polygon_count) {
+							r_scratch.push_back(r_clusters.polygon_clusters[link_connection.polygon->id]);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	r_scratch.sort();
+
+	cluster.neighbors.clear();
+	for (uint32_t i = 0; i < r_scratch.size(); i++) {
+		const uint32_t neighbor = r_scratch[i];
+		if (neighbor == p_cluster_index || neighbor == UINT32_MAX || (i > 0 && neighbor == r_scratch[i - 1])) {
+			continue;
+		}
+		cluster.neighbors.push_back(neighbor);
+	}
+	return has_links;
+}
+
+void NavMeshQueries3D::polygons_build_clusters(const LocalVector<gd::Polygon> &p_polygons, const gd::PolygonBVH &p_bvh, uint32_t p_cluster_size, gd::PolygonClusterGraph &r_clusters) {
+	r_clusters.clear();
+	r_clusters.cluster_size = p_cluster_size;
+	if (p_cluster_size == 0) {
+		return;
+	}
+
+	r_clusters.polygon_clusters.resize(p_polygons.size());
+	for (uint32_t &polygon_cluster : r_clusters.polygon_clusters) {
+		polygon_cluster = UINT32_MAX;
+	}
+
+	LocalVector<uint32_t> new_clusters;
+	for (const gd::PolygonRange &subtree : p_bvh.subtrees) {
+		_polygon_clusters_add_range(p_bvh, subtree, r_clusters, new_clusters);
+	}
+
+	LocalVector<uint32_t> scratch;
+	for (uint32_t cluster_index = 0; cluster_index < r_clusters.clusters.size(); cluster_index++) {
+		if (_polygon_clusters_update_neighbors(p_polygons, p_bvh, cluster_index, r_clusters, scratch)) {
+			r_clusters.link_clusters.push_back(cluster_index);
+		}
+	}
+}
+
+void NavMeshQueries3D::polygons_update_clusters(const LocalVector<gd::Polygon> &p_polygons, const gd::PolygonBVH &p_bvh, gd::PolygonClusterGraph &r_clusters, const LocalVector<gd::PolygonRange> &p_released_ranges, const LocalVector<gd::PolygonRange> &p_synced_ranges, const LocalVector<gd::PolygonRange> &p_reconnected_ranges, const LocalVector<uint32_t> &p_link_connected_polygons) {
+	if (r_clusters.cluster_size == 0) {
+		return;
+	}
+
+	const uint32_t old_polygon_count = r_clusters.polygon_clusters.size();
+	r_clusters.polygon_clusters.resize(p_polygons.size());
+	for (uint32_t i = old_polygon_count; i < r_clusters.polygon_clusters.size(); i++) {
+		r_clusters.polygon_clusters[i] = UINT32_MAX;
+	}
+
+	// A cluster never spans two regions, so the clusters of the released ranges are released as a whole.
+	for (const gd::PolygonRange &range : p_released_ranges) {
+		for (uint32_t i = range.begin; i < range.end && i < old_polygon_count; i++) {
+			const uint32_t cluster_index = r_clusters.polygon_clusters[i];
+			r_clusters.polygon_clusters[i] = UINT32_MAX;
+			if (cluster_index == UINT32_MAX) {
+				continue;
+			}
+			gd::PolygonClusterGraph::Cluster &cluster = r_clusters.clusters[cluster_index];
+			if (cluster.range.end > cluster.range.begin) {
+				cluster.range = gd::PolygonRange();
+				cluster.neighbors.clear();
+				r_clusters.free_clusters.push_back(cluster_index);
+			}
+		}
+	}
+
+	// The new clusters, the clusters of the regions with changed connections, and the clusters around links need their neighbors again.
+	LocalVector<uint32_t> dirty_clusters;
+	for (const gd::PolygonRange &range : p_synced_ranges) {
+		_polygon_clusters_add_range(p_bvh, range, r_clusters, dirty_clusters);
+	}
+	for (const gd::PolygonRange &range : p_reconnected_ranges) {
+		for (uint32_t i = range.begin; i < range.end; i++) {
+			const uint32_t cluster_index = r_clusters.polygon_clusters[i];
+			if (cluster_index != UINT32_MAX && (dirty_clusters.is_empty() || dirty_clusters[dirty_clusters.size() - 1] != cluster_index)) {
+				dirty_clusters.push_back(cluster_index);
+			}
+		}
+	}
+	for (uint32_t cluster_index : r_clusters.link_clusters) {
+		dirty_clusters.push_back(cluster_index);
+	}
+	for (uint32_t polygon_index : p_link_connected_polygons) {
+		if (polygon_index < r_clusters.polygon_clusters.size() && r_clusters.polygon_clusters[polygon_index] != UINT32_MAX) {
+			dirty_clusters.push_back(r_clusters.polygon_clusters[polygon_index]);
+		}
+	}
+	dirty_clusters.sort();
+
+	r_clusters.link_clusters.clear();
+	LocalVector<uint32_t> scratch;
+	for (uint32_t i = 0; i < dirty_clusters.size(); i++) {
+		const uint32_t cluster_index = dirty_clusters[i];
+		const gd::PolygonClusterGraph::Cluster &cluster = r_clusters.clusters[cluster_index];
+		if ((i > 0 && cluster_index == dirty_clusters[i - 1]) || cluster.range.end == cluster.range.begin) {
+			continue;
+		}
+		if (_polygon_clusters_update_neighbors(p_polygons, p_bvh, cluster_index, r_clusters, scratch)) {
+			r_clusters.link_clusters.push_back(cluster_index);
+		}
+	}
+}
+
 Vector3 NavMeshQueries3D::polygons_get_random_point(const LocalVector<gd::Polygon> &p_polygons, uint32_t p_navigation_layers, bool p_uniformly) {
 	const LocalVector<gd::Polygon> &region_polygons = p_polygons;
 
@@ -127,7 +570,207 @@ Vector3 NavMeshQueries3D::polygons_get_random_point(const LocalVector<gd::Polygo
 	}
 }
 
-Vector<Vector3> NavMeshQueries3D::polygons_get_path(const LocalVector<gd::Polygon> &p_polygons, Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_navigation_layers, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners, const Vector3 &p_map_up, uint32_t p_link_polygons_size) {
+// Routes from the begin to the end polygon over the cluster graph and marks the clusters that the polygon search may visit.
+// Returns false when the polygon search should not be restricted.
+static bool _polygon_clusters_build_corridor(const gd::PolygonClusterGraph &p_clusters, const gd::Polygon *p_begin_poly, const gd::Polygon *p_end_poly, const Vector3 &p_end_point, gd::PathQuerySlot &r_query_slot) {
+	if (p_clusters.clusters.is_empty()) {
+		return false;
+	}
+
+	const uint32_t begin_cluster = p_clusters.polygon_clusters[p_begin_poly->id];
+	const uint32_t end_cluster = p_clusters.polygon_clusters[p_end_poly->id];
+	if (begin_cluster == end_cluster || begin_cluster == UINT32_MAX || end_cluster == UINT32_MAX) {
+		return false;
+	}
+
+	r_query_slot.begin_clusters(p_clusters.clusters.size());
+	const uint32_t generation = r_query_slot.cluster_generation;
+	LocalVector<gd::ClusterSearchNode> &cluster_nodes = r_query_slot.cluster_nodes;
+
+	gd::ClusterSearchNode &begin_node = cluster_nodes[begin_cluster];
+	begin_node = gd::ClusterSearchNode();
+	begin_node.cluster = begin_cluster;
+	begin_node.generation = generation;
+	begin_node.distance_to_destination = p_clusters.clusters[begin_cluster].center.distance_to(p_end_point);
+	r_query_slot.traversable_clusters.push(&begin_node);
+
+	bool found_route = false;
+	while (!r_query_slot.traversable_clusters.is_empty()) {
+		gd::ClusterSearchNode *node = r_query_slot.traversable_clusters.pop();
+		r_query_slot.expanded_cluster_count++;
+		if (node->cluster == end_cluster) {
+			found_route = true;
+			break;
+		}
+
+		const gd::PolygonClusterGraph::Cluster &cluster = p_clusters.clusters[node->cluster];
+		for (const uint32_t neighbor : cluster.neighbors) {
+			const Vector3 &neighbor_center = p_clusters.clusters[neighbor].center;
+			const real_t traveled_distance = node->traveled_distance + cluster.center.distance_to(neighbor_center);
+
+			gd::ClusterSearchNode &neighbor_node = cluster_nodes[neighbor];
+			if (neighbor_node.generation == generation) {
+				if (neighbor_node.heap_index < r_query_slot.traversable_clusters.size() && traveled_distance < neighbor_node.traveled_distance) {
+					neighbor_node.back_cluster = node->cluster;
+					neighbor_node.traveled_distance = traveled_distance;
+					r_query_slot.traversable_clusters.shift(neighbor_node.heap_index);
+				}
+			} else {
+				neighbor_node = gd::ClusterSearchNode();
+				neighbor_node.cluster = neighbor;
+				neighbor_node.generation = generation;
+				neighbor_node.back_cluster = node->cluster;
+				neighbor_node.traveled_distance = traveled_distance;
+				neighbor_node.distance_to_destination = neighbor_center.distance_to(p_end_point);
+				r_query_slot.traversable_clusters.push(&neighbor_node);
+			}
+		}
+	}
+
+	if (!found_route) {
+		// Let the polygon search find the closest reachable polygon instead.
+		return false;
+	}
+
+	// The corridor holds the clusters of the route and their direct neighbors,
+	// so the polygon search can still cut corners between clusters.
+	uint32_t cluster_index = end_cluster;
+	while (cluster_index != UINT32_MAX) {
+		r_query_slot.cluster_corridor[cluster_index] = generation;
+		const gd::PolygonClusterGraph::Cluster &cluster = p_clusters.clusters[cluster_index];
+		for (const uint32_t neighbor : cluster.neighbors) {
+			r_query_slot.cluster_corridor[neighbor] = generation;
+		}
+		cluster_index = cluster_nodes[cluster_index].back_cluster;
+	}
+
+	return true;
+}
+
+void NavMeshQueries3D::polygons_build_flow_field(const LocalVector<gd::Polygon> &p_polygons, uint32_t p_link_polygons_size, uint32_t p_target_polygon, uint32_t p_navigation_layers, gd::PolygonFlowField &r_flow_field) {
+	const uint32_t region_polygon_count = p_polygons.size();
+	const uint32_t polygon_count = region_polygon_count + p_link_polygons_size;
+
+	r_flow_field.target_polygon = p_target_polygon;
+	r_flow_field.navigation_layers = p_navigation_layers;
+	r_flow_field.costs.resize(polygon_count);
+	r_flow_field.next_polygons.resize(polygon_count);
+	r_flow_field.next_positions.resize(polygon_count);
+	for (uint32_t i = 0; i < polygon_count; i++) {
+		r_flow_field.costs[i] = FLT_MAX;
+		r_flow_field.next_polygons[i] = UINT32_MAX;
+	}
+
+	ERR_FAIL_UNSIGNED_INDEX(p_target_polygon, region_polygon_count);
+
+	// Link polygons are only reachable through the connections of the region polygons.
+	LocalVector<const gd::Polygon *> sources;
+	sources.reserve(region_polygon_count);
+	for (const gd::Polygon &polygon : p_polygons) {
+		if (polygon.owner) { // Skips the holes left by removed regions.
+			sources.push_back(&polygon);
+		}
+	}
+	LocalVector<bool> link_polygon_found;
+	link_polygon_found.resize(p_link_polygons_size);
+	for (uint32_t i = 0; i < link_polygon_found.size(); i++) {
+		link_polygon_found[i] = false;
+	}
+
+	// Connections lead away from a polygon, searching from the target needs the ones leading into it.
+	LocalVector<uint32_t> incoming_offsets;
+	incoming_offsets.resize(polygon_count + 1);
+	for (uint32_t i = 0; i < incoming_offsets.size(); i++) {
+		incoming_offsets[i] = 0;
+	}
+	for (uint32_t i = 0; i < sources.size(); i++) {
+		for (const gd::Edge &edge : sources[i]->edges) {
+			for (const gd::Edge::Connection &connection : edge.connections) {
+				const uint32_t to_id = connection.polygon->id;
+				incoming_offsets[to_id + 1]++;
+				if (to_id >= region_polygon_count && !link_polygon_found[to_id - region_polygon_count]) {
+					link_polygon_found[to_id - region_polygon_count] = true;
+					sources.push_back(connection.polygon);
+				}
+			}
+		}
+	}
+	for (uint32_t i = 0; i < polygon_count; i++) {
+		incoming_offsets[i + 1] += incoming_offsets[i];
+	}
+
+	LocalVector<const gd::Polygon *> polygons_by_id;
+	polygons_by_id.resize(polygon_count);
+	for (uint32_t i = 0; i < polygons_by_id.size(); i++) {
+		polygons_by_id[i] = nullptr;
+	}
+	LocalVector<Vector3> centers;
+	centers.resize(polygon_count);
+	LocalVector<uint32_t> incoming_polygons;
+	LocalVector<Vector3> incoming_gateways;
+	incoming_polygons.resize(incoming_offsets[polygon_count]);
+	incoming_gateways.resize(incoming_offsets[polygon_count]);
+	LocalVector<uint32_t> incoming_counts;
+	incoming_counts.resize(polygon_count);
+	for (uint32_t i = 0; i < incoming_counts.size(); i++) {
+		incoming_counts[i] = 0;
+	}
+	for (const gd::Polygon *polygon : sources) {
+		polygons_by_id[polygon->id] = polygon;
+
+		Vector3 center;
+		for (const gd::Point &point : polygon->points) {
+			center += point.pos;
+		}
+		centers[polygon->id] = center / MAX(1u, polygon->points.size());
+
+		for (const gd::Edge &edge : polygon->edges) {
+			for (const gd::Edge::Connection &connection : edge.connections) {
+				const uint32_t to_id = connection.polygon->id;
+				const uint32_t index = incoming_offsets[to_id] + incoming_counts[to_id]++;
+				incoming_polygons[index] = polygon->id;
+				incoming_gateways[index] = (connection.pathway_start + connection.pathway_end) * 0.5;
+			}
+		}
+	}
+
+	// Dijkstra from the target, using the same travel and enter costs as the path queries.
+	gd::Heap<gd::FlowFieldSearchNode, gd::FlowFieldSearchNodeCostGreaterThan> open_nodes;
+	r_flow_field.costs[p_target_polygon] = 0.0;
+	r_flow_field.next_positions[p_target_polygon] = centers[p_target_polygon];
+	open_nodes.push({ 0.0, p_target_polygon });
+
+	while (!open_nodes.is_empty()) {
+		const gd::FlowFieldSearchNode node = open_nodes.pop();
+		if (node.cost > r_flow_field.costs[node.polygon]) {
+			continue; // Already reached with a lower cost.
+		}
+
+		const NavBase *owner = polygons_by_id[node.polygon]->owner;
+		for (uint32_t i = incoming_offsets[node.polygon]; i < incoming_offsets[node.polygon + 1]; i++) {
+			const uint32_t from_id = incoming_polygons[i];
+			const NavBase *from_owner = polygons_by_id[from_id]->owner;
+			if ((p_navigation_layers & from_owner->get_navigation_layers()) == 0) {
+				continue;
+			}
+
+			const Vector3 &gateway = incoming_gateways[i];
+			real_t cost = node.cost + centers[from_id].distance_to(gateway) * from_owner->get_travel_cost() + gateway.distance_to(centers[node.polygon]) * owner->get_travel_cost();
+			if (from_owner->get_self() != owner->get_self()) {
+				cost += owner->get_enter_cost();
+			}
+
+			if (cost < r_flow_field.costs[from_id]) {
+				r_flow_field.costs[from_id] = cost;
+				r_flow_field.next_polygons[from_id] = node.polygon;
+				r_flow_field.next_positions[from_id] = gateway;
+				open_nodes.push({ cost, from_id });
+			}
+		}
+	}
+}
+
+Vector<Vector3> NavMeshQueries3D::polygons_get_path(const LocalVector<gd::Polygon> &p_polygons, const gd::PolygonBVH &p_bvh, const gd::PolygonClusterGraph &p_clusters, Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_navigation_layers, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners, const Vector3 &p_map_up, uint32_t p_link_polygons_size, gd::PathQuerySlot &r_query_slot) {
 	// Clear metadata outputs.
 	if (r_path_types) {
 		r_path_types->clear();
@@ -140,40 +783,11 @@ Vector<Vector3> NavMeshQueries3D::polygons_get_path(const LocalVector<gd::Polygo
 	}
 
 	// Find the start poly and the end poly on this map.
-	const gd::Polygon *begin_poly = nullptr;
-	const gd::Polygon *end_poly = nullptr;
 	Vector3 begin_point;
 	Vector3 end_point;
-	real_t begin_d = FLT_MAX;
+	const gd::Polygon *begin_poly = _polygons_bvh_get_closest(p_polygons, p_bvh, p_origin, true, p_navigation_layers, begin_point, nullptr);
+	const gd::Polygon *end_poly = _polygons_bvh_get_closest(p_polygons, p_bvh, p_destination, true, p_navigation_layers, end_point, nullptr);
 	real_t end_d = FLT_MAX;
-	// Find the initial poly and the end poly on this map.
-	for (const gd::Polygon &p : p_polygons) {
-		// Only consider the polygon if it in a region with compatible layers.
-		if ((p_navigation_layers & p.owner->get_navigation_layers()) == 0) {
-			continue;
-		}
-
-		// For each face check the distance between the origin/destination
-		for (size_t point_id = 2; point_id < p.points.size(); point_id++) {
-			const Face3 face(p.points[0].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
-
-			Vector3 point = face.get_closest_point_to(p_origin);
-			real_t distance_to_point = point.distance_to(p_origin);
-			if (distance_to_point < begin_d) {
-				begin_d = distance_to_point;
-				begin_poly = &p;
-				begin_point = point;
-			}
-
-			point = face.get_closest_point_to(p_destination);
-			distance_to_point = point.distance_to(p_destination);
-			if (distance_to_point < end_d) {
-				end_d = distance_to_point;
-				end_poly = &p;
-				end_point = point;
-			}
-		}
-	}
 
 	// Check for trivial cases
 	if (!begin_poly || !end_poly) {
@@ -205,22 +819,28 @@ Vector<Vector3> NavMeshQueries3D::polygons_get_path(const LocalVector<gd::Polygo
 		return path;
 	}
 
-	// List of all reachable navigation polys.
-	LocalVector<gd::NavigationPoly> navigation_polys;
-	navigation_polys.resize(p_polygons.size() + p_link_polygons_size);
+	// List of all reachable navigation polys, reused from previous queries.
+	// Only the polys of the current generation have been visited by this search.
+	r_query_slot.begin(p_polygons.size() + p_link_polygons_size);
+	LocalVector<gd::NavigationPoly> &navigation_polys = r_query_slot.navigation_polys;
 
 	// Initialize the matching navigation polygon.
 	gd::NavigationPoly &begin_navigation_poly = navigation_polys[begin_poly->id];
+	begin_navigation_poly = gd::NavigationPoly();
+	begin_navigation_poly.generation = r_query_slot.generation;
 	begin_navigation_poly.poly = begin_poly;
 	begin_navigation_poly.entry = begin_point;
 	begin_navigation_poly.back_navigation_edge_pathway_start = begin_point;
 	begin_navigation_poly.back_navigation_edge_pathway_end = begin_point;
 
 	// Heap of polygons to travel next.
-	gd::Heap<gd::NavigationPoly *, gd::NavPolyTravelCostGreaterThan, gd::NavPolyHeapIndexer>
-			traversable_polys;
+	gd::Heap<gd::NavigationPoly *, gd::NavPolyTravelCostGreaterThan, gd::NavPolyHeapIndexer> &traversable_polys = r_query_slot.traversable_polys;
 	traversable_polys.reserve(p_polygons.size() * 0.25);
 
+	// Long searches first route over the cluster graph and then only visit the polygons in the resulting corridor.
+	bool use_corridor = _polygon_clusters_build_corridor(p_clusters, begin_poly, end_poly, end_point, r_query_slot);
+	const uint32_t clustered_polygon_count = p_clusters.polygon_clusters.size();
+
 	// This is an implementation of the A* algorithm.
 	int least_cost_id = begin_poly->id;
 	int prev_least_cost_id = -1;
@@ -231,6 +851,8 @@ Vector<Vector3> NavMeshQueries3D::polygons_get_path(const LocalVector<gd::Polygo
 	bool is_reachable = true;
 
 	while (true) {
+		r_query_slot.expanded_polygon_count++;
+
 		// Takes the current least_cost_poly neighbors (iterating over its edges) and compute the traveled_distance.
 		for (const gd::Edge &edge : navigation_polys[least_cost_id].poly->edges) {
 			// Iterate over connections in this edge, then compute the new optimized travel distance assigned to this polygon.
@@ -242,6 +864,14 @@ Vector<Vector3> NavMeshQueries3D::polygons_get_path(const LocalVector<gd::Polygo
 					continue;
 				}
 
+				// Link polygons are not clustered and always part of the corridor.
+				if (use_corridor && connection.polygon->id < clustered_polygon_count) {
+					const uint32_t cluster = p_clusters.polygon_clusters[connection.polygon->id];
+					if (cluster != UINT32_MAX && r_query_slot.cluster_corridor[cluster] != r_query_slot.cluster_generation) {
+						continue;
+					}
+				}
+
 				const gd::NavigationPoly &least_cost_poly = navigation_polys[least_cost_id];
 				real_t poly_enter_cost = 0.0;
 				real_t poly_travel_cost = least_cost_poly.poly->owner->get_travel_cost();
@@ -257,7 +887,7 @@ Vector<Vector3> NavMeshQueries3D::polygons_get_path(const LocalVector<gd::Polygo
 
 				// Check if the neighbor polygon has already been processed.
 				gd::NavigationPoly &neighbor_poly = navigation_polys[connection.polygon->id];
-				if (neighbor_poly.poly != nullptr) {
+				if (neighbor_poly.generation == r_query_slot.generation) {
 					// If the neighbor polygon hasn't been traversed yet and the new path leading to
 					// it is shorter, update the polygon.
 					if (neighbor_poly.traversable_poly_index < traversable_polys.size() &&
@@ -277,6 +907,7 @@ Vector<Vector3> NavMeshQueries3D::polygons_get_path(const LocalVector<gd::Polygo
 					}
 				} else {
 					// Initialize the matching navigation polygon.
+					neighbor_poly.generation = r_query_slot.generation;
 					neighbor_poly.poly = connection.polygon;
 					neighbor_poly.back_navigation_poly_id = least_cost_id;
 					neighbor_poly.back_navigation_edge = connection.edge;
@@ -297,6 +928,24 @@ Vector<Vector3> NavMeshQueries3D::polygons_get_path(const LocalVector<gd::Polygo
 		// When the heap of traversable polygons is empty at this point it means the end polygon is
 		// unreachable.
 		if (traversable_polys.is_empty()) {
+			if (use_corridor) {
+				// The corridor ignores navigation layers and travel costs, so it can miss the route.
+				// Search again without it before giving up on the end polygon.
+				use_corridor = false;
+				r_query_slot.corridor_retry_count++;
+
+				r_query_slot.next_generation();
+				navigation_polys[begin_poly->id].generation = r_query_slot.generation;
+
+				least_cost_id = begin_poly->id;
+				prev_least_cost_id = -1;
+
+				reachable_end = nullptr;
+				distance_to_reachable_end = FLT_MAX;
+
+				continue;
+			}
+
 			// Thus use the further reachable polygon
 			ERR_BREAK_MSG(is_reachable == false, "It's not expect to not find the most reachable polygons");
 			is_reachable = false;
@@ -358,10 +1007,9 @@ Vector<Vector3> NavMeshQueries3D::polygons_get_path(const LocalVector<gd::Polygo
 				return path;
 			}
 
-			for (gd::NavigationPoly &nav_poly : navigation_polys) {
-				nav_poly.poly = nullptr;
-			}
-			navigation_polys[begin_poly->id].poly = begin_poly;
+			// Start a new generation so all the polygons are unvisited again.
+			r_query_slot.next_generation();
+			navigation_polys[begin_poly->id].generation = r_query_slot.generation;
 
 			least_cost_id = begin_poly->id;
 			prev_least_cost_id = -1;
@@ -579,46 +1227,108 @@ Vector<Vector3> NavMeshQueries3D::polygons_get_path(const LocalVector<gd::Polygo
 	return path;
 }
 
-Vector3 NavMeshQueries3D::polygons_get_closest_point_to_segment(const LocalVector<gd::Polygon> &p_polygons, const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision) {
-	bool use_collision = p_use_collision;
+Vector3 NavMeshQueries3D::polygons_get_closest_point_to_segment(const LocalVector<gd::Polygon> &p_polygons, const gd::PolygonBVH &p_bvh, const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision) {
 	Vector3 closest_point;
 	real_t closest_point_distance = FLT_MAX;
+	uint32_t closest_index = UINT32_MAX;
 
-	for (const gd::Polygon &polygon : p_polygons) {
-		// For each face check the distance to the segment.
-		for (size_t point_id = 2; point_id < polygon.points.size(); point_id += 1) {
-			const Face3 face(polygon.points[0].pos, polygon.points[point_id - 1].pos, polygon.points[point_id].pos);
-			Vector3 intersection_point;
-			if (face.intersects_segment(p_from, p_to, &intersection_point)) {
-				const real_t d = p_from.distance_to(intersection_point);
-				if (!use_collision) {
-					closest_point = intersection_point;
-					use_collision = true;
-					closest_point_distance = d;
-				} else if (closest_point_distance > d) {
-					closest_point = intersection_point;
-					closest_point_distance = d;
+	if (p_bvh.nodes.is_empty()) {
+		return closest_point;
+	}
+
+	uint32_t stack[gd::PolygonBVH::STACK_SIZE];
+	uint32_t stack_size = 0;
+
+	// First look for the closest intersection between the segment and a face, only visiting nodes crossed by the segment.
+	bool use_collision = false;
+	stack[stack_size++] = 0;
+	while (stack_size > 0) {
+		const gd::PolygonBVH::Node &node = p_bvh.nodes[stack[--stack_size]];
+		if (!node.aabb.intersects_segment(p_from, p_to)) {
+			continue;
+		}
+
+		if (!node.is_leaf()) {
+			ERR_FAIL_COND_V_MSG(stack_size + 2 > gd::PolygonBVH::STACK_SIZE, closest_point, "Navigation polygon BVH is too deep to be traversed.");
+			stack[stack_size++] = node.first;
+			stack[stack_size++] = node.first + 1;
+			continue;
+		}
+
+		for (uint32_t i = node.first; i < node.first + node.count; i++) {
+			const uint32_t polygon_index = p_bvh.polygon_indices[i];
+			const gd::Polygon &polygon = p_polygons[polygon_index];
+
+			for (size_t point_id = 2; point_id < polygon.points.size(); point_id += 1) {
+				const Face3 face(polygon.points[0].pos, polygon.points[point_id - 1].pos, polygon.points[point_id].pos);
+				Vector3 intersection_point;
+				if (face.intersects_segment(p_from, p_to, &intersection_point)) {
+					const real_t d = p_from.distance_to(intersection_point);
+					if (_is_closer(d, polygon_index, closest_point_distance, closest_index)) {
+						closest_point = intersection_point;
+						closest_point_distance = d;
+						closest_index = polygon_index;
+						use_collision = true;
+					}
 				}
 			}
-			// If segment does not itersect face, check the distance from segment's endpoints.
-			else if (!use_collision) {
+		}
+	}
+
+	if (use_collision || p_use_collision) {
+		return closest_point;
+	}
+
+	// Without intersection, find the face closest to the segment.
+	// Nodes are only visited if their bounds grown by the current closest distance still touch the segment.
+	const Vector3 segment_center = (p_from + p_to) * 0.5;
+	stack[stack_size++] = 0;
+	while (stack_size > 0) {
+		const gd::PolygonBVH::Node &node = p_bvh.nodes[stack[--stack_size]];
+		if (closest_point_distance != FLT_MAX && !node.aabb.grow(closest_point_distance).intersects_segment(p_from, p_to)) {
+			continue;
+		}
+
+		if (!node.is_leaf()) {
+			ERR_FAIL_COND_V_MSG(stack_size + 2 > gd::PolygonBVH::STACK_SIZE, closest_point, "Navigation polygon BVH is too deep to be traversed.");
+			const uint32_t child_a = node.first;
+			const uint32_t child_b = node.first + 1;
+			if (_aabb_distance_squared_to(p_bvh.nodes[child_a].aabb, segment_center) < _aabb_distance_squared_to(p_bvh.nodes[child_b].aabb, segment_center)) {
+				stack[stack_size++] = child_b;
+				stack[stack_size++] = child_a;
+			} else {
+				stack[stack_size++] = child_a;
+				stack[stack_size++] = child_b;
+			}
+			continue;
+		}
+
+		for (uint32_t i = node.first; i < node.first + node.count; i++) {
+			const uint32_t polygon_index = p_bvh.polygon_indices[i];
+			const gd::Polygon &polygon = p_polygons[polygon_index];
+
+			// For each face check the distance from segment's endpoints.
+			for (size_t point_id = 2; point_id < polygon.points.size(); point_id += 1) {
+				const Face3 face(polygon.points[0].pos, polygon.points[point_id - 1].pos, polygon.points[point_id].pos);
+
 				const Vector3 p_from_closest = face.get_closest_point_to(p_from);
 				const real_t d_p_from = p_from.distance_to(p_from_closest);
-				if (closest_point_distance > d_p_from) {
+				if (_is_closer(d_p_from, polygon_index, closest_point_distance, closest_index)) {
 					closest_point = p_from_closest;
 					closest_point_distance = d_p_from;
+					closest_index = polygon_index;
 				}
 
 				const Vector3 p_to_closest = face.get_closest_point_to(p_to);
 				const real_t d_p_to = p_to.distance_to(p_to_closest);
-				if (closest_point_distance > d_p_to) {
+				if (_is_closer(d_p_to, polygon_index, closest_point_distance, closest_index)) {
 					closest_point = p_to_closest;
 					closest_point_distance = d_p_to;
+					closest_index = polygon_index;
 				}
 			}
-		}
-		// Finally, check for a case when shortest distance is between some point located on a face's edge and some point located on a line segment.
-		if (!use_collision) {
+
+			// Finally, check for a case when shortest distance is between some point located on a face's edge and some point located on a line segment.
 			for (size_t point_id = 0; point_id < polygon.points.size(); point_id += 1) {
 				Vector3 a, b;
 
@@ -631,9 +1341,10 @@ Vector3 NavMeshQueries3D::polygons_get_closest_point_to_segment(const LocalVecto
 						b);
 
 				const real_t d = a.distance_to(b);
-				if (d < closest_point_distance) {
+				if (_is_closer(d, polygon_index, closest_point_distance, closest_index)) {
 					closest_point_distance = d;
 					closest_point = b;
+					closest_index = polygon_index;
 				}
 			}
 		}
@@ -642,42 +1353,42 @@ Vector3 NavMeshQueries3D::polygons_get_closest_point_to_segment(const LocalVecto
 	return closest_point;
 }
 
-Vector3 NavMeshQueries3D::polygons_get_closest_point(const LocalVector<gd::Polygon> &p_polygons, const Vector3 &p_point) {
-	gd::ClosestPointQueryResult cp = polygons_get_closest_point_info(p_polygons, p_point);
+Vector3 NavMeshQueries3D::polygons_get_closest_point(const LocalVector<gd::Polygon> &p_polygons, const gd::PolygonBVH &p_bvh, const Vector3 &p_point) {
+	gd::ClosestPointQueryResult cp = polygons_get_closest_point_info(p_polygons, p_bvh, p_point);
 	return cp.point;
 }
 
-Vector3 NavMeshQueries3D::polygons_get_closest_point_normal(const LocalVector<gd::Polygon> &p_polygons, const Vector3 &p_point) {
-	gd::ClosestPointQueryResult cp = polygons_get_closest_point_info(p_polygons, p_point);
+Vector3 NavMeshQueries3D::polygons_get_closest_point_normal(const LocalVector<gd::Polygon> &p_polygons, const gd::PolygonBVH &p_bvh, const Vector3 &p_point) {
+	gd::ClosestPointQueryResult cp = polygons_get_closest_point_info(p_polygons, p_bvh, p_point);
 	return cp.normal;
 }
 
-gd::ClosestPointQueryResult NavMeshQueries3D::polygons_get_closest_point_info(const LocalVector<gd::Polygon> &p_polygons, const Vector3 &p_point) {
+gd::ClosestPointQueryResult NavMeshQueries3D::polygons_get_closest_point_info(const LocalVector<gd::Polygon> &p_polygons, const gd::PolygonBVH &p_bvh, const Vector3 &p_point) {
 	gd::ClosestPointQueryResult result;
-	real_t closest_point_distance_squared = FLT_MAX;
 
-	for (const gd::Polygon &polygon : p_polygons) {
-		for (size_t point_id = 2; point_id < polygon.points.size(); point_id += 1) {
-			const Face3 face(polygon.points[0].pos, polygon.points[point_id - 1].pos, polygon.points[point_id].pos);
-			const Vector3 closest_point_on_face = face.get_closest_point_to(p_point);
-			const real_t distance_squared_to_point = closest_point_on_face.distance_squared_to(p_point);
-			if (distance_squared_to_point < closest_point_distance_squared) {
-				result.point = closest_point_on_face;
-				result.normal = face.get_plane().normal;
-				result.owner = polygon.owner->get_self();
-				closest_point_distance_squared = distance_squared_to_point;
-			}
-		}
+	const gd::Polygon *closest_polygon = _polygons_bvh_get_closest(p_polygons, p_bvh, p_point, false, 0, result.point, &result.normal);
+	if (closest_polygon) {
+		result.owner = closest_polygon->owner->get_self();
 	}
 
 	return result;
 }
 
-RID NavMeshQueries3D::polygons_get_closest_point_owner(const LocalVector<gd::Polygon> &p_polygons, const Vector3 &p_point) {
-	gd::ClosestPointQueryResult cp = polygons_get_closest_point_info(p_polygons, p_point);
+RID NavMeshQueries3D::polygons_get_closest_point_owner(const LocalVector<gd::Polygon> &p_polygons, const gd::PolygonBVH &p_bvh, const Vector3 &p_point) {
+	gd::ClosestPointQueryResult cp = polygons_get_closest_point_info(p_polygons, p_bvh, p_point);
 	return cp.owner;
 }
 
+uint32_t NavMeshQueries3D::polygons_get_closest_polygon(const LocalVector<gd::Polygon> &p_polygons, const gd::PolygonBVH &p_bvh, const Vector3 &p_point, uint32_t p_navigation_layers, Vector3 &r_point) {
+	const gd::Polygon *closest_polygon = _polygons_bvh_get_closest(p_polygons, p_bvh, p_point, true, p_navigation_layers, r_point, nullptr);
+	return closest_polygon ? closest_polygon - p_polygons.ptr() : UINT32_MAX;
+}
+
+uint32_t NavMeshQueries3D::polygons_get_closest_polygon_in_radius(const LocalVector<gd::Polygon> &p_polygons, const gd::PolygonBVH &p_bvh, const Vector3 &p_point, real_t p_radius, Vector3 &r_point) {
+	const gd::Polygon *closest_polygon = _polygons_bvh_get_closest(p_polygons, p_bvh, p_point, false, 0, r_point, nullptr, p_radius * p_radius);
+	return closest_polygon ? closest_polygon - p_polygons.ptr() : UINT32_MAX;
+}
+
 void NavMeshQueries3D::clip_path(const LocalVector<gd::NavigationPoly> &p_navigation_polys, Vector<Vector3> &path, const gd::NavigationPoly *from_poly, const Vector3 &p_to_point, const gd::NavigationPoly *p_to_poly, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners, const Vector3 &p_map_up) {
 	Vector3 from = path[path.size() - 1];
 
@@ -37,14 +37,23 @@
 
 class NavMeshQueries3D {
 public:
+	static void polygons_build_bvh(const LocalVector<gd::Polygon> &p_polygons, gd::PolygonBVH &r_bvh);
+	static void polygons_update_bvh(const LocalVector<gd::Polygon> &p_polygons, gd::PolygonBVH &r_bvh, const LocalVector<gd::PolygonRange> &p_released_ranges, const LocalVector<gd::PolygonRange> &p_synced_ranges);
+	static void polygons_build_clusters(const LocalVector<gd::Polygon> &p_polygons, const gd::PolygonBVH &p_bvh, uint32_t p_cluster_size, gd::PolygonClusterGraph &r_clusters);
+	static void polygons_update_clusters(const LocalVector<gd::Polygon> &p_polygons, const gd::PolygonBVH &p_bvh, gd::PolygonClusterGraph &r_clusters, const LocalVector<gd::PolygonRange> &p_released_ranges, const LocalVector<gd::PolygonRange> &p_synced_ranges, const LocalVector<gd::PolygonRange> &p_reconnected_ranges, const LocalVector<uint32_t> &p_link_connected_polygons);
+
 	static Vector3 polygons_get_random_point(const LocalVector<gd::Polygon> &p_polygons, uint32_t p_navigation_layers, bool p_uniformly);
 
-	static Vector<Vector3> polygons_get_path(const LocalVector<gd::Polygon> &p_polygons, Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_navigation_layers, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners, const Vector3 &p_map_up, uint32_t p_link_polygons_size);
-	static Vector3 polygons_get_closest_point_to_segment(const LocalVector<gd::Polygon> &p_polygons, const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision);
-	static Vector3 polygons_get_closest_point(const LocalVector<gd::Polygon> &p_polygons, const Vector3 &p_point);
-	static Vector3 polygons_get_closest_point_normal(const LocalVector<gd::Polygon> &p_polygons, const Vector3 &p_point);
-	static gd::ClosestPointQueryResult polygons_get_closest_point_info(const LocalVector<gd::Polygon> &p_polygons, const Vector3 &p_point);
-	static RID polygons_get_closest_point_owner(const LocalVector<gd::Polygon> &p_polygons, const Vector3 &p_point);
+	static void polygons_build_flow_field(const LocalVector<gd::Polygon> &p_polygons, uint32_t p_link_polygons_size, uint32_t p_target_polygon, uint32_t p_navigation_layers, gd::PolygonFlowField &r_flow_field);
+
+	static Vector<Vector3> polygons_get_path(const LocalVector<gd::Polygon> &p_polygons, const gd::PolygonBVH &p_bvh, const gd::PolygonClusterGraph &p_clusters, Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_navigation_layers, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners, const Vector3 &p_map_up, uint32_t p_link_polygons_size, gd::PathQuerySlot &r_query_slot);
+	static Vector3 polygons_get_closest_point_to_segment(const LocalVector<gd::Polygon> &p_polygons, const gd::PolygonBVH &p_bvh, const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision);
+	static Vector3 polygons_get_closest_point(const LocalVector<gd::Polygon> &p_polygons, const gd::PolygonBVH &p_bvh, const Vector3 &p_point);
+	static Vector3 polygons_get_closest_point_normal(const LocalVector<gd::Polygon> &p_polygons, const gd::PolygonBVH &p_bvh, const Vector3 &p_point);
+	static gd::ClosestPointQueryResult polygons_get_closest_point_info(const LocalVector<gd::Polygon> &p_polygons, const gd::PolygonBVH &p_bvh, const Vector3 &p_point);
+	static RID polygons_get_closest_point_owner(const LocalVector<gd::Polygon> &p_polygons, const gd::PolygonBVH &p_bvh, const Vector3 &p_point);
+	static uint32_t polygons_get_closest_polygon(const LocalVector<gd::Polygon> &p_polygons, const gd::PolygonBVH &p_bvh, const Vector3 &p_point, uint32_t p_navigation_layers, Vector3 &r_point);
+	static uint32_t polygons_get_closest_polygon_in_radius(const LocalVector<gd::Polygon> &p_polygons, const gd::PolygonBVH &p_bvh, const Vector3 &p_point, real_t p_radius, Vector3 &r_point);
 
 	static void clip_path(const LocalVector<gd::NavigationPoly> &p_navigation_polys, Vector<Vector3> &path, const gd::NavigationPoly *from_poly, const Vector3 &p_to_point, const gd::NavigationPoly *p_to_poly, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners, const Vector3 &p_map_up);
 };
@@ -39,6 +39,7 @@
 
 #include "core/config/project_settings.h"
 #include "core/object/worker_thread_pool.h"
+#include "core/templates/hash_set.h"
 
 #include <Obstacle2d.h>
 
@@ -86,12 +87,31 @@ void NavMap::set_merge_rasterizer_cell_scale(float p_value) {
 	regenerate_polygons = true;
 }
 
+void NavMap::set_path_cluster_size(uint32_t p_cluster_size) {
+	if (path_cluster_size == p_cluster_size) {
+		return;
+	}
+	path_cluster_size = p_cluster_size;
+	regenerate_links = true;
+}
+
+void NavMap::set_use_avoidance_spatial_hash(bool p_enabled) {
+	if (use_avoidance_spatial_hash == p_enabled) {
+		return;
+	}
+	use_avoidance_spatial_hash = p_enabled;
+	avoidance_spatial_hash_2d = AvoidanceSpatialHash();
+	avoidance_spatial_hash_3d = AvoidanceSpatialHash();
+	agents_dirty = true;
+}
+
 void NavMap::set_use_edge_connections(bool p_enabled) {
 	if (use_edge_connections == p_enabled) {
 		return;
 	}
 	use_edge_connections = p_enabled;
 	regenerate_links = true;
+	regenerate_connections = true;
 }
 
 void NavMap::set_edge_connection_margin(real_t p_edge_connection_margin) {
@@ -100,6 +120,7 @@ void NavMap::set_edge_connection_margin(real_t p_edge_connection_margin) {
 	}
 	edge_connection_margin = p_edge_connection_margin;
 	regenerate_links = true;
+	regenerate_connections = true;
 }
 
 void NavMap::set_link_connection_radius(real_t p_link_connection_radius) {
@@ -107,6 +128,7 @@ void NavMap::set_link_connection_radius(real_t p_link_connection_radius) {
 		return;
 	}
 	link_connection_radius = p_link_connection_radius;
+	link_sync_states.clear();
 	regenerate_links = true;
 }
 
@@ -130,9 +152,64 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 		return Vector<Vector3>();
 	}
 
-	return NavMeshQueries3D::polygons_get_path(
-			polygons, p_origin, p_destination, p_optimize, p_navigation_layers,
-			r_path_types, r_path_rids, r_path_owners, up, link_polygons.size());
+	gd::PathQuerySlot *query_slot = _acquire_path_query_slot();
+	Vector<Vector3> path = NavMeshQueries3D::polygons_get_path(
+			polygons, polygons_bvh, polygon_clusters, p_origin, p_destination, p_optimize, p_navigation_layers,
+			r_path_types, r_path_rids, r_path_owners, up, link_polygons.size(), *query_slot);
+	_release_path_query_slot(query_slot);
+
+	return path;
+}
+
+gd::PathQuerySlot *NavMap::_acquire_path_query_slot() const {
+	gd::PathQuerySlot *slot = nullptr;
+	{
+		MutexLock lock(path_query_slots_mutex);
+		if (!path_query_slots.is_empty()) {
+			slot = path_query_slots[path_query_slots.size() - 1];
+			path_query_slots.resize(path_query_slots.size() - 1);
+		}
+	}
+
+	if (!slot) {
+		slot = memnew(gd::PathQuerySlot);
+	}
+	slot->used = true;
+	return slot;
+}
+
+void NavMap::_release_path_query_slot(gd::PathQuerySlot *p_slot) const {
+	MutexLock lock(path_query_slots_mutex);
+	path_query_slots.push_back(p_slot);
+}
+
+void NavMap::_trim_path_query_slots() {
+	// Called from sync(), so no query is running and every slot is free.
+	MutexLock lock(path_query_slots_mutex);
+
+	const uint32_t polygon_count = polygons.size() + link_polygons.size();
+	const uint32_t cluster_count = polygon_clusters.clusters.size();
+	pm_path_query_polygon_count = 0;
+	pm_path_query_cluster_count = 0;
+	pm_path_query_retry_count = 0;
+	for (uint32_t i = 0; i < path_query_slots.size();) {
+		gd::PathQuerySlot *slot = path_query_slots[i];
+		pm_path_query_polygon_count += slot->expanded_polygon_count;
+		pm_path_query_cluster_count += slot->expanded_cluster_count;
+		pm_path_query_retry_count += slot->corridor_retry_count;
+		slot->expanded_polygon_count = 0;
+		slot->expanded_cluster_count = 0;
+		slot->corridor_retry_count = 0;
+
+		// Keep only as many slots as queries ran at once since the last sync, and drop the ones sized for a bigger map.
+		if (slot->used && slot->navigation_polys.size() <= polygon_count && slot->cluster_nodes.size() <= cluster_count) {
+			slot->used = false;
+			i++;
+		} else {
+			memdelete(slot);
+			path_query_slots.remove_at_unordered(i);
+		}
+	}
 }
 
 Vector3 NavMap::get_closest_point_to_segment(const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision) const {
@@ -142,7 +219,7 @@ Vector3 NavMap::get_closest_point_to_segment(const Vector3 &p_from, const Vector
 		return Vector3();
 	}
 
-	return NavMeshQueries3D::polygons_get_closest_point_to_segment(polygons, p_from, p_to, p_use_collision);
+	return NavMeshQueries3D::polygons_get_closest_point_to_segment(polygons, polygons_bvh, p_from, p_to, p_use_collision);
 }
 
 Vector3 NavMap::get_closest_point(const Vector3 &p_point) const {
@@ -152,7 +229,7 @@ Vector3 NavMap::get_closest_point(const Vector3 &p_point) const {
 		return Vector3();
 	}
 
-	return NavMeshQueries3D::polygons_get_closest_point(polygons, p_point);
+	return NavMeshQueries3D::polygons_get_closest_point(polygons, polygons_bvh, p_point);
 }
 
 Vector3 NavMap::get_closest_point_normal(const Vector3 &p_point) const {
@@ -162,7 +239,7 @@ Vector3 NavMap::get_closest_point_normal(const Vector3 &p_point) const {
 		return Vector3();
 	}
 
-	return NavMeshQueries3D::polygons_get_closest_point_normal(polygons, p_point);
+	return NavMeshQueries3D::polygons_get_closest_point_normal(polygons, polygons_bvh, p_point);
 }
 
 RID NavMap::get_closest_point_owner(const Vector3 &p_point) const {
@@ -172,13 +249,77 @@ RID NavMap::get_closest_point_owner(const Vector3 &p_point) const {
 		return RID();
 	}
 
-	return NavMeshQueries3D::polygons_get_closest_point_owner(polygons, p_point);
+	return NavMeshQueries3D::polygons_get_closest_point_owner(polygons, polygons_bvh, p_point);
 }
 
 gd::ClosestPointQueryResult NavMap::get_closest_point_info(const Vector3 &p_point) const {
 	RWLockRead read_lock(map_rwlock);
 
-	return NavMeshQueries3D::polygons_get_closest_point_info(polygons, p_point);
+	return NavMeshQueries3D::polygons_get_closest_point_info(polygons, polygons_bvh, p_point);
+}
+
+Vector3 NavMap::get_flow_field_next_position(const Vector3 &p_target, const Vector3 &p_from, uint32_t p_navigation_layers) const {
+	RWLockRead read_lock(map_rwlock);
+	if (iteration_id == 0) {
+		NAVMAP_ITERATION_ZERO_ERROR_MSG();
+		return Vector3();
+	}
+
+	Vector3 from_point;
+	const uint32_t from_polygon = NavMeshQueries3D::polygons_get_closest_polygon(polygons, polygons_bvh, p_from, p_navigation_layers, from_point);
+	if (from_polygon == UINT32_MAX) {
+		return p_from;
+	}
+	Vector3 target_point;
+	const uint32_t target_polygon = NavMeshQueries3D::polygons_get_closest_polygon(polygons, polygons_bvh, p_target, p_navigation_layers, target_point);
+	if (target_polygon == UINT32_MAX) {
+		return from_point;
+	}
+	if (target_polygon == from_polygon) {
+		return target_point;
+	}
+
+	MutexLock lock(flow_fields_mutex);
+	const gd::PolygonFlowField &flow_field = _get_flow_field(target_polygon, p_navigation_layers);
+	uint32_t next_polygon = flow_field.next_polygons[from_polygon];
+	if (next_polygon == UINT32_MAX) {
+		return from_point;
+	}
+
+	Vector3 next_position = flow_field.next_positions[from_polygon];
+	// Links are crossed at once, so once at the start of one the agent is sent to its end.
+	while (next_polygon != UINT32_MAX && next_polygon >= polygons.size() && from_point.distance_to(next_position) <= link_connection_radius) {
+		next_position = flow_field.next_positions[next_polygon];
+		next_polygon = flow_field.next_polygons[next_polygon];
+	}
+	return next_position;
+}
+
+const gd::PolygonFlowField &NavMap::_get_flow_field(uint32_t p_target_polygon, uint32_t p_navigation_layers) const {
+	flow_field_tick++;
+
+	uint32_t least_recently_used = 0;
+	for (uint32_t i = 0; i < flow_fields.size(); i++) {
+		gd::PolygonFlowField &flow_field = flow_fields[i];
+		if (flow_field.target_polygon == p_target_polygon && flow_field.navigation_layers == p_navigation_layers && flow_field.iteration_id == iteration_id) {
+			flow_field.last_used = flow_field_tick;
+			return flow_field;
+		}
+		if (flow_field.last_used < flow_fields[least_recently_used].last_used) {
+			least_recently_used = i;
+		}
+	}
+
+	if (flow_fields.size() < FLOW_FIELD_CACHE_MAX) {
+		least_recently_used = flow_fields.size();
+		flow_fields.resize(flow_fields.size() + 1);
+	}
+
+	gd::PolygonFlowField &flow_field = flow_fields[least_recently_used];
+	NavMeshQueries3D::polygons_build_flow_field(polygons, link_polygons.size(), p_target_polygon, p_navigation_layers, flow_field);
+	flow_field.iteration_id = iteration_id;
+	flow_field.last_used = flow_field_tick;
+	return flow_field;
 }
 
 void NavMap::add_region(NavRegion *p_region) {
@@ -203,6 +344,7 @@ void NavMap::remove_link(NavLink *p_link) {
 	int64_t link_index = links.find(p_link);
 	if (link_index >= 0) {
 		links.remove_at_unordered(link_index);
+		link_sync_states.erase(p_link);
 		regenerate_links = true;
 	}
 }
@@ -366,6 +508,8 @@ void NavMap::sync() {
 	int _new_pm_edge_connection_count = pm_edge_connection_count;
 	int _new_pm_edge_free_count = pm_edge_free_count;
 	int _new_pm_obstacle_count = obstacles.size();
+	int _new_pm_polygon_sync_count = 0;
+	int _new_pm_link_sync_count = 0;
 
 	// Check if we need to update the links.
 	if (regenerate_polygons) {
@@ -375,60 +519,401 @@ void NavMap::sync() {
 		regenerate_links = true;
 	}
 
+	// Only the changed regions and the ones that were not synced yet need to be processed.
+	LocalVector<NavRegion *> dirty_regions;
 	for (NavRegion *region : regions) {
-		if (region->sync()) {
+		if (region->sync() || (region->get_enabled() && !region_sync_states.has(region))) {
+			dirty_regions.push_back(region);
 			regenerate_links = true;
 		}
 	}
 
 	for (NavLink *link : links) {
 		if (link->check_dirty()) {
+			link_sync_states.erase(link);
 			regenerate_links = true;
 		}
 	}
 
 	if (regenerate_links) {
-		_new_pm_polygon_count = 0;
+		PolygonSyncRanges sync_ranges;
+		_new_pm_polygon_sync_count = _sync_regions(dirty_regions, sync_ranges);
+		_new_pm_link_sync_count = _sync_links();
+		if (sync_ranges.full_rebuild || polygon_clusters.cluster_size != path_cluster_size) {
+			NavMeshQueries3D::polygons_build_clusters(polygons, polygons_bvh, path_cluster_size, polygon_clusters);
+		} else {
+			// Only the clusters of the changed regions and around the links are rebuilt.
+			NavMeshQueries3D::polygons_update_clusters(polygons, polygons_bvh, polygon_clusters, sync_ranges.released, sync_ranges.synced, sync_ranges.reconnected, link_connected_polygons);
+		}
+
+		_new_pm_polygon_count = polygons.size() - polygon_hole_count;
 		_new_pm_edge_count = 0;
 		_new_pm_edge_merge_count = 0;
 		_new_pm_edge_connection_count = 0;
 		_new_pm_edge_free_count = 0;
 
-		// Remove regions connections.
+		int border_merge_count = 0;
+		for (const KeyValue<NavRegion *, RegionSyncState> &E : region_sync_states) {
+			_new_pm_edge_count += E.value.edge_count;
+			_new_pm_edge_merge_count += E.value.edge_merge_count;
+			_new_pm_edge_free_count += E.value.border_free_count;
+			_new_pm_edge_connection_count += E.value.border_connection_count;
+			border_merge_count += E.value.border_merge_count;
+		}
+		// Edges merged between two regions are border edges of both.
+		_new_pm_edge_count -= border_merge_count / 2;
+		_new_pm_edge_merge_count += border_merge_count / 2;
+
+		// Some code treats 0 as a failure case, so we avoid returning 0 and modulo wrap UINT32_MAX manually.
+		iteration_id = iteration_id % UINT32_MAX + 1;
+
+		// Fields from the previous iteration point to polygons that may have changed.
+		MutexLock lock(flow_fields_mutex);
+		flow_fields.clear();
+	}
+
+	// Do we have modified obstacle positions?
+	for (NavObstacle *obstacle : obstacles) {
+		if (obstacle->check_dirty()) {
+			obstacles_dirty = true;
+		}
+	}
+	// Do we have modified agent arrays?
+	for (NavAgent *agent : agents) {
+		if (agent->check_dirty()) {
+			agents_dirty = true;
+		}
+	}
+
+	// Update avoidance worlds.
+	if (obstacles_dirty || agents_dirty) {
+		_update_rvo_simulation();
+	}
+
+	_trim_path_query_slots();
+
+	regenerate_polygons = false;
+	regenerate_links = false;
+	regenerate_connections = false;
+	obstacles_dirty = false;
+	agents_dirty = false;
+
+	// Performance Monitor.
+	pm_region_count = _new_pm_region_count;
+	pm_agent_count = _new_pm_agent_count;
+	pm_link_count = _new_pm_link_count;
+	pm_polygon_count = _new_pm_polygon_count;
+	pm_edge_count = _new_pm_edge_count;
+	pm_edge_merge_count = _new_pm_edge_merge_count;
+	pm_edge_connection_count = _new_pm_edge_connection_count;
+	pm_edge_free_count = _new_pm_edge_free_count;
+	pm_obstacle_count = _new_pm_obstacle_count;
+	pm_polygon_sync_count = _new_pm_polygon_sync_count;
+	pm_link_sync_count = _new_pm_link_sync_count;
+}
+
+static gd::Edge::Connection _get_polygon_edge_connection(gd::Polygon &p_polygon, uint32_t p_edge) {
+	gd::Edge::Connection connection;
+	connection.polygon = &p_polygon;
+	connection.edge = p_edge;
+	connection.pathway_start = p_polygon.points[p_edge].pos;
+	connection.pathway_end = p_polygon.points[(p_edge + 1) % p_polygon.points.size()].pos;
+	return connection;
+}
+
+// Checks if the two free edges are close enough to be connected and computes the pathway from `p_edge` to `p_other_edge`.
+static bool _get_edge_proximity_connection(const gd::Edge::Connection &p_edge, const gd::Edge::Connection &p_other_edge, real_t p_edge_connection_margin, gd::Edge::Connection &r_connection) {
+	Vector3 edge_p1 = p_edge.polygon->points[p_edge.edge].pos;
+	Vector3 edge_p2 = p_edge.polygon->points[(p_edge.edge + 1) % p_edge.polygon->points.size()].pos;
+
+	Vector3 other_edge_p1 = p_other_edge.polygon->points[p_other_edge.edge].pos;
+	Vector3 other_edge_p2 = p_other_edge.polygon->points[(p_other_edge.edge + 1) % p_other_edge.polygon->points.size()].pos;
+
+	// Compute the projection of the opposite edge on the current one
+	Vector3 edge_vector = edge_p2 - edge_p1;
+	real_t projected_p1_ratio = edge_vector.dot(other_edge_p1 - edge_p1) / (edge_vector.length_squared());
+	real_t projected_p2_ratio = edge_vector.dot(other_edge_p2 - edge_p1) / (edge_vector.length_squared());
+	if ((projected_p1_ratio < 0.0 && projected_p2_ratio < 0.0) || (projected_p1_ratio > 1.0 && projected_p2_ratio > 1.0)) {
+		return false;
+	}
+
+	// Check if the two edges are close to each other enough and compute a pathway between the two regions.
+	Vector3 self1 = edge_vector * CLAMP(projected_p1_ratio, 0.0, 1.0) + edge_p1;
+	Vector3 other1;
+	if (projected_p1_ratio >= 0.0 && projected_p1_ratio <= 1.0) {
+		other1 = other_edge_p1;
+	} else {
+		other1 = other_edge_p1.lerp(other_edge_p2, (1.0 - projected_p1_ratio) / (projected_p2_ratio - projected_p1_ratio));
+	}
+	if (other1.distance_to(self1) > p_edge_connection_margin) {
+		return false;
+	}
+
+	Vector3 self2 = edge_vector * CLAMP(projected_p2_ratio, 0.0, 1.0) + edge_p1;
+	Vector3 other2;
+	if (projected_p2_ratio >= 0.0 && projected_p2_ratio <= 1.0) {
+		other2 = other_edge_p2;
+	} else {
+		other2 = other_edge_p1.lerp(other_edge_p2, (0.0 - projected_p1_ratio) / (projected_p2_ratio - projected_p1_ratio));
+	}
+	if (other2.distance_to(self2) > p_edge_connection_margin) {
+		return false;
+	}
+
+	// The edges can now be connected.
+	r_connection = p_other_edge;
+	r_connection.pathway_start = (self1 + other1) / 2.0;
+	r_connection.pathway_end = (self2 + other2) / 2.0;
+	return true;
+}
+
+static _FORCE_INLINE_ uint64_t _get_polygon_edge_id(uint32_t p_polygon_index, uint32_t p_edge) {
+	return ((uint64_t)p_polygon_index << 32) | p_edge;
+}
+
+static _FORCE_INLINE_ void _add_region_neighbor(LocalVector<NavRegion *> &r_neighbors, NavRegion *p_region) {
+	if (!r_neighbors.has(p_region)) {
+		r_neighbors.push_back(p_region);
+	}
+}
+
+// Takes `p_count` polygons from the first hole large enough, or appends them after the `r_polygon_count` polygons.
+static uint32_t _take_polygon_range(LocalVector<gd::PolygonRange> &r_holes, uint32_t &r_polygon_count, uint32_t p_count) {
+	for (uint32_t i = 0; i < r_holes.size(); i++) {
+		gd::PolygonRange &hole = r_holes[i];
+		if (hole.end - hole.begin >= p_count) {
+			const uint32_t begin = hole.begin;
+			hole.begin += p_count;
+			if (hole.begin == hole.end) {
+				r_holes.remove_at(i);
+			}
+			return begin;
+		}
+	}
+
+	const uint32_t begin = r_polygon_count;
+	r_polygon_count += p_count;
+	return begin;
+}
+
+static void _add_polygon_hole(LocalVector<gd::PolygonRange> &r_holes, const gd::PolygonRange &p_range) {
+	uint32_t i = 0;
+	while (i < r_holes.size() && r_holes[i].begin < p_range.begin) {
+		i++;
+	}
+	r_holes.insert(i, p_range);
+
+	if (i + 1 < r_holes.size() && r_holes[i].end == r_holes[i + 1].begin) {
+		r_holes[i].end = r_holes[i + 1].end;
+		r_holes.remove_at(i + 1);
+	}
+	if (i > 0 && r_holes[i - 1].end == r_holes[i].begin) {
+		r_holes[i - 1].end = r_holes[i].end;
+		r_holes.remove_at(i);
+	}
+}
+
+uint32_t NavMap::_sync_regions(const LocalVector<NavRegion *> &p_dirty_regions, PolygonSyncRanges &r_ranges) {
+	HashSet<NavRegion *> dirty_regions;
+	for (NavRegion *region : p_dirty_regions) {
+		dirty_regions.insert(region);
+	}
+
+	HashSet<NavRegion *> current_regions;
+	for (NavRegion *region : regions) {
+		current_regions.insert(region);
+	}
+
+	LocalVector<NavRegion *> removed_regions;
+	for (const KeyValue<NavRegion *, RegionSyncState> &E : region_sync_states) {
+		if (!current_regions.has(E.key)) {
+			removed_regions.push_back(E.key);
+		}
+	}
+
+	// Unchanged regions keep their polygon range, so the connections pointing to them stay valid.
+	// Fall back to a full rebuild when the map settings changed, when the polygons would be reallocated, or when they contain too many holes.
+	bool full_rebuild = regenerate_polygons || regenerate_connections || polygons.is_empty();
+	if (!full_rebuild) {
+		// Replay the range allocations of the sync below.
+		LocalVector<gd::PolygonRange> holes = polygon_holes;
+		uint32_t polygon_count = polygons.size();
+		for (NavRegion *region : removed_regions) {
+			const RegionSyncState &state = region_sync_states[region];
+			if (state.polygon_count > 0) {
+				_add_polygon_hole(holes, { state.polygon_offset, state.polygon_offset + state.polygon_count });
+			}
+		}
+		for (NavRegion *region : p_dirty_regions) {
+			HashMap<NavRegion *, RegionSyncState>::ConstIterator state = region_sync_states.find(region);
+			if (state && state->value.polygon_count > 0) {
+				_add_polygon_hole(holes, { state->value.polygon_offset, state->value.polygon_offset + state->value.polygon_count });
+			}
+			const uint32_t new_count = region->get_enabled() ? region->get_polygons().size() : 0;
+			if (new_count > 0) {
+				_take_polygon_range(holes, polygon_count, new_count);
+			}
+		}
+
+		uint32_t hole_count = 0;
+		for (const gd::PolygonRange &hole : holes) {
+			hole_count += hole.end - hole.begin;
+		}
+		full_rebuild = polygon_count > polygons.get_capacity() || hole_count > polygon_count / 2;
+	}
+
+	if (full_rebuild) {
+		polygons.clear();
+		polygon_hole_count = 0;
+		polygon_holes.clear();
+		region_sync_states.clear();
+		region_border_edges.clear();
 		region_external_connections.clear();
+		link_connected_polygons.clear();
+		link_sync_states.clear();
+		link_dirty_bounds.clear();
+		removed_regions.clear();
+		dirty_regions.clear();
+
+		uint32_t polygon_count = 0;
 		for (NavRegion *region : regions) {
-			region_external_connections[region] = LocalVector<gd::Edge::Connection>();
+			if (region->get_enabled()) {
+				dirty_regions.insert(region);
+				polygon_count += region->get_polygons().size();
+			}
 		}
+		polygons.reserve(polygon_count);
+	}
 
-		// Resize the polygon count.
-		int polygon_count = 0;
-		for (const NavRegion *region : regions) {
-			if (!region->get_enabled()) {
-				continue;
+	r_ranges.full_rebuild = full_rebuild;
+	LocalVector<gd::PolygonRange> &released_ranges = r_ranges.released;
+	LocalVector<gd::PolygonRange> &synced_ranges = r_ranges.synced;
+	HashSet<NavRegion *> affected_regions;
+	LocalVector<gd::EdgeKey> touched_keys;
+	uint32_t polygon_sync_count = 0;
+
+	// Links near the changed polygons need to search for their polygons again.
+	auto add_link_dirty_bounds = [&](uint32_t p_begin, uint32_t p_end) {
+		AABB bounds;
+		bool has_points = false;
+		for (uint32_t i = p_begin; i < p_end; i++) {
+			for (const gd::Point &point : polygons[i].points) {
+				if (has_points) {
+					bounds.expand_to(point.pos);
+				} else {
+					bounds.position = point.pos;
+					has_points = true;
+				}
 			}
-			polygon_count += region->get_polygons().size();
 		}
-		polygons.resize(polygon_count);
+		if (has_points) {
+			link_dirty_bounds.push_back(bounds);
+		}
+	};
 
-		// Copy all region polygons in the map.
-		polygon_count = 0;
-		for (const NavRegion *region : regions) {
-			if (!region->get_enabled()) {
-				continue;
+	// Clears the polygon range of the region and removes its border edges, the neighbor regions need to drop their connections to it.
+	auto release_region = [&](NavRegion *p_region, RegionSyncState &r_state) {
+		for (NavRegion *neighbor : r_state.neighbors) {
+			affected_regions.insert(neighbor);
+		}
+
+		for (uint32_t i = 0; i < r_state.border_edges.size(); i++) {
+			const gd::EdgeKey &key = r_state.border_edges[i].key;
+			HashMap<gd::EdgeKey, LocalVector<RegionBorderEdgeRef>, gd::EdgeKey>::Iterator refs = region_border_edges.find(key);
+			if (refs) {
+				LocalVector<RegionBorderEdgeRef> &key_refs = refs->value;
+				for (uint32_t j = 0; j < key_refs.size(); j++) {
+					if (key_refs[j].region == p_region && key_refs[j].index == i) {
+						key_refs.remove_at(j);
+						break;
+					}
+				}
+				if (key_refs.is_empty()) {
+					region_border_edges.remove(refs);
+				}
 			}
-			const LocalVector<gd::Polygon> &polygons_source = region->get_polygons();
-			for (uint32_t n = 0; n < polygons_source.size(); n++) {
-				polygons[polygon_count] = polygons_source[n];
-				polygons[polygon_count].id = polygon_count;
-				polygon_count++;
+			touched_keys.push_back(key);
+		}
+
+		add_link_dirty_bounds(r_state.polygon_offset, r_state.polygon_offset + r_state.polygon_count);
+		for (uint32_t i = r_state.polygon_offset; i < r_state.polygon_offset + r_state.polygon_count; i++) {
+			polygons[i] = gd::Polygon();
+		}
+		if (r_state.polygon_count > 0) {
+			polygon_hole_count += r_state.polygon_count;
+			released_ranges.push_back({ r_state.polygon_offset, r_state.polygon_offset + r_state.polygon_count });
+			_add_polygon_hole(polygon_holes, released_ranges[released_ranges.size() - 1]);
+		}
+
+		region_external_connections.erase(p_region);
+		r_state.edge_count = 0;
+		r_state.edge_merge_count = 0;
+		r_state.border_edges.clear();
+		r_state.neighbors.clear();
+	};
+
+	auto is_released = [&](uint32_t p_polygon_index) {
+		for (const gd::PolygonRange &range : released_ranges) {
+			if (p_polygon_index >= range.begin && p_polygon_index < range.end) {
+				return true;
+			}
+		}
+		return false;
+	};
+
+	auto is_map_polygon = [&](const gd::Polygon *p_polygon) {
+		return p_polygon >= polygons.ptr() && p_polygon < polygons.ptr() + polygons.size();
+	};
+
+	for (NavRegion *region : removed_regions) {
+		release_region(region, region_sync_states[region]);
+		region_sync_states.erase(region);
+	}
+
+	// Copy the polygons of the changed regions and merge their inner edges.
+	for (NavRegion *region : regions) {
+		if (!dirty_regions.has(region)) {
+			continue;
+		}
+
+		HashMap<NavRegion *, RegionSyncState>::Iterator state_it = region_sync_states.find(region);
+		if (state_it) {
+			release_region(region, state_it->value);
+		}
+
+		if (!region->get_enabled()) {
+			if (state_it) {
+				region_sync_states.remove(state_it);
 			}
+			continue;
 		}
 
-		_new_pm_polygon_count = polygon_count;
+		const LocalVector<gd::Polygon> &polygons_source = region->get_polygons();
+		const uint32_t polygon_count = polygons_source.size();
+
+		RegionSyncState &state = state_it ? state_it->value : region_sync_states.insert(region, RegionSyncState())->value;
+		uint32_t new_size = polygons.size();
+		state.polygon_offset = polygon_count > 0 ? _take_polygon_range(polygon_holes, new_size, polygon_count) : new_size;
+		if (new_size > polygons.size()) {
+			polygons.resize(new_size);
+		} else {
+			polygon_hole_count -= polygon_count;
+		}
+		state.polygon_count = polygon_count;
+		synced_ranges.push_back({ state.polygon_offset, state.polygon_offset + polygon_count });
+		polygon_sync_count += polygon_count;
+
+		for (uint32_t n = 0; n < polygon_count; n++) {
+			const uint32_t polygon_index = state.polygon_offset + n;
+			polygons[polygon_index] = polygons_source[n];
+			polygons[polygon_index].id = polygon_index;
+		}
+		add_link_dirty_bounds(state.polygon_offset, state.polygon_offset + polygon_count);
 
-		// Group all edges per key.
+		// Group the region edges per key.
 		HashMap<gd::EdgeKey, Vector<gd::Edge::Connection>, gd::EdgeKey> connections;
-		for (gd::Polygon &poly : polygons) {
+		for (uint32_t n = 0; n < polygon_count; n++) {
+			gd::Polygon &poly = polygons[state.polygon_offset + n];
 			for (uint32_t p = 0; p < poly.points.size(); p++) {
 				int next_point = (p + 1) % poly.points.size();
 				gd::EdgeKey ek(poly.points[p].key, poly.points[next_point].key);
@@ -436,16 +921,11 @@ void NavMap::sync() {
 				HashMap<gd::EdgeKey, Vector<gd::Edge::Connection>, gd::EdgeKey>::Iterator connection = connections.find(ek);
 				if (!connection) {
 					connections[ek] = Vector<gd::Edge::Connection>();
-					_new_pm_edge_count += 1;
+					state.edge_count += 1;
 				}
 				if (connections[ek].size() <= 1) {
 					// Add the polygon/edge tuple to this key.
-					gd::Edge::Connection new_connection;
-					new_connection.polygon = &poly;
-					new_connection.edge = p;
-					new_connection.pathway_start = poly.points[p].pos;
-					new_connection.pathway_end = poly.points[next_point].pos;
-					connections[ek].push_back(new_connection);
+					connections[ek].push_back(_get_polygon_edge_connection(poly, p));
 				} else {
 					// The edge is already connected with another edge, skip.
 					ERR_PRINT_ONCE("Navigation map synchronization error. Attempted to merge a navigation mesh polygon edge with another already-merged edge. This is usually caused by crossing edges, overlapping polygons, or a mismatch of the NavigationMesh / NavigationPolygon baked 'cell_size' and navigation map 'cell_size'. If you're certain none of above is the case, change 'navigation/3d/merge_rasterizer_cell_scale' to 0.001.");
@@ -453,7 +933,7 @@ void NavMap::sync() {
 			}
 		}
 
-		Vector<gd::Edge::Connection> free_edges;
+		const bool connectable = use_edge_connections && region->get_use_edge_connections();
 		for (KeyValue<gd::EdgeKey, Vector<gd::Edge::Connection>> &E : connections) {
 			if (E.value.size() == 2) {
 				// Connect edge that are shared in different polygons.
@@ -462,226 +942,377 @@ void NavMap::sync() {
 				c1.polygon->edges[c1.edge].connections.push_back(c2);
 				c2.polygon->edges[c2.edge].connections.push_back(c1);
 				// Note: The pathway_start/end are full for those connection and do not need to be modified.
-				_new_pm_edge_merge_count += 1;
+				state.edge_merge_count += 1;
 			} else {
 				CRASH_COND_MSG(E.value.size() != 1, vformat("Number of connection != 1. Found: %d", E.value.size()));
-				if (use_edge_connections && E.value[0].polygon->owner->get_use_edge_connections()) {
-					free_edges.push_back(E.value[0]);
-				}
+				// The edge may be merged or connected with the edge of another region.
+				RegionBorderEdge border_edge;
+				border_edge.key = E.key;
+				border_edge.polygon = E.value[0].polygon->id - state.polygon_offset;
+				border_edge.edge = E.value[0].edge;
+				border_edge.connectable = connectable;
+				state.border_edges.push_back(border_edge);
 			}
 		}
 
-		// Find the compatible near edges.
-		//
-		// Note:
-		// Considering that the edges must be compatible (for obvious reasons)
-		// to be connected, create new polygons to remove that small gap is
-		// not really useful and would result in wasteful computation during
-		// connection, integration and path finding.
-		_new_pm_edge_free_count = free_edges.size();
+		for (uint32_t i = 0; i < state.border_edges.size(); i++) {
+			const gd::EdgeKey &key = state.border_edges[i].key;
+			region_border_edges[key].push_back({ region, i });
+			touched_keys.push_back(key);
+		}
+	}
 
-		for (int i = 0; i < free_edges.size(); i++) {
-			const gd::Edge::Connection &free_edge = free_edges[i];
-			Vector3 edge_p1 = free_edge.polygon->points[free_edge.edge].pos;
-			Vector3 edge_p2 = free_edge.polygon->points[(free_edge.edge + 1) % free_edge.polygon->points.size()].pos;
+	// Link polygons are rebuilt on each sync, remove the connections leading to them.
+	for (uint32_t polygon_index : link_connected_polygons) {
+		if (polygon_index >= polygons.size() || is_released(polygon_index) || polygons[polygon_index].edges.is_empty()) {
+			continue;
+		}
+		Vector<gd::Edge::Connection> &connections = polygons[polygon_index].edges[0].connections;
+		for (int i = connections.size() - 1; i >= 0; i--) {
+			if (!is_map_polygon(connections[i].polygon)) {
+				connections.remove_at(i);
+			}
+		}
+	}
+	link_connected_polygons.clear();
+
+	// Update the merge state of the border edges sharing a key with an added or removed edge.
+	// The first two edges of a key are merged, unchanged regions need to be reconnected when the state of one of their edges changes.
+	HashSet<gd::EdgeKey, gd::EdgeKey> processed_keys;
+	HashSet<uint64_t> refreshed_edges;
+	for (const gd::EdgeKey &key : touched_keys) {
+		if (processed_keys.has(key)) {
+			continue;
+		}
+		processed_keys.insert(key);
 
-			for (int j = 0; j < free_edges.size(); j++) {
-				const gd::Edge::Connection &other_edge = free_edges[j];
-				if (i == j || free_edge.polygon->owner == other_edge.polygon->owner) {
-					continue;
+		HashMap<gd::EdgeKey, LocalVector<RegionBorderEdgeRef>, gd::EdgeKey>::Iterator refs = region_border_edges.find(key);
+		if (!refs) {
+			continue;
+		}
+
+		bool has_new_edge = false;
+		for (uint32_t i = 0; i < refs->value.size(); i++) {
+			const RegionBorderEdgeRef &ref = refs->value[i];
+			RegionSyncState &state = region_sync_states[ref.region];
+			RegionBorderEdge &border_edge = state.border_edges[ref.index];
+			const bool merged = refs->value.size() >= 2 && i < 2;
+			if (dirty_regions.has(ref.region)) {
+				border_edge.merged = merged;
+				has_new_edge = true;
+			} else if (border_edge.merged != merged) {
+				border_edge.merged = merged;
+				refreshed_edges.insert(_get_polygon_edge_id(state.polygon_offset + border_edge.polygon, border_edge.edge));
+				affected_regions.insert(ref.region);
+				for (NavRegion *neighbor : state.neighbors) {
+					affected_regions.insert(neighbor);
 				}
+			}
+		}
 
-				Vector3 other_edge_p1 = other_edge.polygon->points[other_edge.edge].pos;
-				Vector3 other_edge_p2 = other_edge.polygon->points[(other_edge.edge + 1) % other_edge.polygon->points.size()].pos;
+		if (has_new_edge && refs->value.size() > 2) {
+			ERR_PRINT_ONCE("Navigation map synchronization error. Attempted to merge a navigation mesh polygon edge with another already-merged edge. This is usually caused by crossing edges, overlapping polygons, or a mismatch of the NavigationMesh / NavigationPolygon baked 'cell_size' and navigation map 'cell_size'. If you're certain none of above is the case, change 'navigation/3d/merge_rasterizer_cell_scale' to 0.001.");
+		}
+	}
 
-				// Compute the projection of the opposite edge on the current one
-				Vector3 edge_vector = edge_p2 - edge_p1;
-				real_t projected_p1_ratio = edge_vector.dot(other_edge_p1 - edge_p1) / (edge_vector.length_squared());
-				real_t projected_p2_ratio = edge_vector.dot(other_edge_p2 - edge_p1) / (edge_vector.length_squared());
-				if ((projected_p1_ratio < 0.0 && projected_p2_ratio < 0.0) || (projected_p1_ratio > 1.0 && projected_p2_ratio > 1.0)) {
-					continue;
-				}
+	// Remove the connections of the unchanged regions that lead to released polygons or to edges that changed state.
+	for (NavRegion *region : affected_regions) {
+		if (dirty_regions.has(region)) {
+			continue;
+		}
+		HashMap<NavRegion *, RegionSyncState>::Iterator state_it = region_sync_states.find(region);
+		if (!state_it) {
+			continue;
+		}
+		RegionSyncState &state = state_it->value;
 
-				// Check if the two edges are close to each other enough and compute a pathway between the two regions.
-				Vector3 self1 = edge_vector * CLAMP(projected_p1_ratio, 0.0, 1.0) + edge_p1;
-				Vector3 other1;
-				if (projected_p1_ratio >= 0.0 && projected_p1_ratio <= 1.0) {
-					other1 = other_edge_p1;
-				} else {
-					other1 = other_edge_p1.lerp(other_edge_p2, (1.0 - projected_p1_ratio) / (projected_p2_ratio - projected_p1_ratio));
-				}
-				if (other1.distance_to(self1) > edge_connection_margin) {
-					continue;
-				}
+		auto is_stale = [&](const gd::Edge::Connection &p_connection) {
+			if (!is_map_polygon(p_connection.polygon)) {
+				return true;
+			}
+			const uint32_t polygon_index = p_connection.polygon - polygons.ptr();
+			return is_released(polygon_index) || (p_connection.edge >= 0 && refreshed_edges.has(_get_polygon_edge_id(polygon_index, p_connection.edge)));
+		};
+
+		uint32_t last_polygon = UINT32_MAX;
+		for (RegionBorderEdge &border_edge : state.border_edges) {
+			const uint32_t polygon_index = state.polygon_offset + border_edge.polygon;
+			if (polygon_index != last_polygon) {
+				last_polygon = polygon_index;
+				polygon_sync_count += 1;
+			}
 
-				Vector3 self2 = edge_vector * CLAMP(projected_p2_ratio, 0.0, 1.0) + edge_p1;
-				Vector3 other2;
-				if (projected_p2_ratio >= 0.0 && projected_p2_ratio <= 1.0) {
-					other2 = other_edge_p2;
-				} else {
-					other2 = other_edge_p1.lerp(other_edge_p2, (0.0 - projected_p1_ratio) / (projected_p2_ratio - projected_p1_ratio));
+			Vector<gd::Edge::Connection> &connections = polygons[polygon_index].edges[border_edge.edge].connections;
+			if (refreshed_edges.has(_get_polygon_edge_id(polygon_index, border_edge.edge))) {
+				connections.clear();
+				border_edge.connections.clear();
+				continue;
+			}
+
+			for (int i = connections.size() - 1; i >= 0; i--) {
+				if (is_stale(connections[i])) {
+					connections.remove_at(i);
 				}
-				if (other2.distance_to(self2) > edge_connection_margin) {
-					continue;
+			}
+			for (int64_t i = int64_t(border_edge.connections.size()) - 1; i >= 0; i--) {
+				if (is_stale(border_edge.connections[i])) {
+					border_edge.connections.remove_at(i);
 				}
-
-				// The edges can now be connected.
-				gd::Edge::Connection new_connection = other_edge;
-				new_connection.pathway_start = (self1 + other1) / 2.0;
-				new_connection.pathway_end = (self2 + other2) / 2.0;
-				free_edge.polygon->edges[free_edge.edge].connections.push_back(new_connection);
-
-				// Add the connection to the region_connection map.
-				region_external_connections[(NavRegion *)free_edge.polygon->owner].push_back(new_connection);
-				_new_pm_edge_connection_count += 1;
 			}
 		}
 
-		uint32_t link_poly_idx = 0;
-		link_polygons.resize(links.size());
-
-		// Search for polygons within range of a nav link.
-		for (const NavLink *link : links) {
-			if (!link->get_enabled()) {
-				continue;
+		for (int64_t i = int64_t(state.neighbors.size()) - 1; i >= 0; i--) {
+			if (!region_sync_states.has(state.neighbors[i])) {
+				state.neighbors.remove_at_unordered(i);
 			}
-			const Vector3 start = link->get_start_position();
-			const Vector3 end = link->get_end_position();
+		}
+	}
 
-			gd::Polygon *closest_start_polygon = nullptr;
-			real_t closest_start_distance = link_connection_radius;
-			Vector3 closest_start_point;
+	// Regions that need their border counts and external connections updated.
+	HashSet<NavRegion *> changed_regions;
+	for (NavRegion *region : dirty_regions) {
+		changed_regions.insert(region);
+	}
+	for (NavRegion *region : affected_regions) {
+		changed_regions.insert(region);
+	}
 
-			gd::Polygon *closest_end_polygon = nullptr;
-			real_t closest_end_distance = link_connection_radius;
-			Vector3 closest_end_point;
+	// Merge the border edges shared with another region when one of them is new or changed state.
+	for (const gd::EdgeKey &key : processed_keys) {
+		HashMap<gd::EdgeKey, LocalVector<RegionBorderEdgeRef>, gd::EdgeKey>::Iterator refs = region_border_edges.find(key);
+		if (!refs || refs->value.size() < 2) {
+			continue;
+		}
+
+		const RegionBorderEdgeRef &ref_a = refs->value[0];
+		const RegionBorderEdgeRef &ref_b = refs->value[1];
+		RegionSyncState &state_a = region_sync_states[ref_a.region];
+		RegionSyncState &state_b = region_sync_states[ref_b.region];
+		const RegionBorderEdge &border_edge_a = state_a.border_edges[ref_a.index];
+		const RegionBorderEdge &border_edge_b = state_b.border_edges[ref_b.index];
+		const uint32_t polygon_index_a = state_a.polygon_offset + border_edge_a.polygon;
+		const uint32_t polygon_index_b = state_b.polygon_offset + border_edge_b.polygon;
+
+		if (!dirty_regions.has(ref_a.region) && !dirty_regions.has(ref_b.region) &&
+				!refreshed_edges.has(_get_polygon_edge_id(polygon_index_a, border_edge_a.edge)) &&
+				!refreshed_edges.has(_get_polygon_edge_id(polygon_index_b, border_edge_b.edge))) {
+			// Both edges were already merged together.
+			continue;
+		}
 
-			// Create link to any polygons within the search radius of the start point.
-			for (uint32_t start_index = 0; start_index < polygons.size(); start_index++) {
-				gd::Polygon &start_poly = polygons[start_index];
+		gd::Polygon &polygon_a = polygons[polygon_index_a];
+		gd::Polygon &polygon_b = polygons[polygon_index_b];
+		polygon_a.edges[border_edge_a.edge].connections.push_back(_get_polygon_edge_connection(polygon_b, border_edge_b.edge));
+		polygon_b.edges[border_edge_b.edge].connections.push_back(_get_polygon_edge_connection(polygon_a, border_edge_a.edge));
 
-				// For each face check the distance to the start
-				for (uint32_t start_point_id = 2; start_point_id < start_poly.points.size(); start_point_id += 1) {
-					const Face3 start_face(start_poly.points[0].pos, start_poly.points[start_point_id - 1].pos, start_poly.points[start_point_id].pos);
-					const Vector3 start_point = start_face.get_closest_point_to(start);
-					const real_t start_distance = start_point.distance_to(start);
+		_add_region_neighbor(state_a.neighbors, ref_b.region);
+		_add_region_neighbor(state_b.neighbors, ref_a.region);
+	}
 
-					// Pick the polygon that is within our radius and is closer than anything we've seen yet.
-					if (start_distance <= link_connection_radius && start_distance < closest_start_distance) {
-						closest_start_distance = start_distance;
-						closest_start_point = start_point;
-						closest_start_polygon = &start_poly;
-					}
+	// Find the compatible near edges.
+	//
+	// Note:
+	// Considering that the edges must be compatible (for obvious reasons)
+	// to be connected, create new polygons to remove that small gap is
+	// not really useful and would result in wasteful computation during
+	// connection, integration and path finding.
+	//
+	// Only the pairs with at least one new or changed edge are computed, the others are still connected from previous syncs.
+	if (use_edge_connections) {
+		struct FreeEdge {
+			NavRegion *region = nullptr;
+			RegionSyncState *state = nullptr;
+			RegionBorderEdge *border_edge = nullptr;
+			gd::Edge::Connection connection;
+			bool is_new = false;
+		};
+
+		LocalVector<FreeEdge> free_edges;
+		bool has_new_free_edge = false;
+		for (KeyValue<NavRegion *, RegionSyncState> &E : region_sync_states) {
+			const bool region_dirty = dirty_regions.has(E.key);
+			for (RegionBorderEdge &border_edge : E.value.border_edges) {
+				if (!border_edge.connectable || border_edge.merged) {
+					continue;
 				}
+				const uint32_t polygon_index = E.value.polygon_offset + border_edge.polygon;
+				FreeEdge free_edge;
+				free_edge.region = E.key;
+				free_edge.state = &E.value;
+				free_edge.border_edge = &border_edge;
+				free_edge.connection = _get_polygon_edge_connection(polygons[polygon_index], border_edge.edge);
+				free_edge.is_new = region_dirty || refreshed_edges.has(_get_polygon_edge_id(polygon_index, border_edge.edge));
+				has_new_free_edge |= free_edge.is_new;
+				free_edges.push_back(free_edge);
 			}
+		}
 
-			// Find any polygons within the search radius of the end point.
-			for (gd::Polygon &end_poly : polygons) {
-				// For each face check the distance to the end
-				for (uint32_t end_point_id = 2; end_point_id < end_poly.points.size(); end_point_id += 1) {
-					const Face3 end_face(end_poly.points[0].pos, end_poly.points[end_point_id - 1].pos, end_poly.points[end_point_id].pos);
-					const Vector3 end_point = end_face.get_closest_point_to(end);
-					const real_t end_distance = end_point.distance_to(end);
-
-					// Pick the polygon that is within our radius and is closer than anything we've seen yet.
-					if (end_distance <= link_connection_radius && end_distance < closest_end_distance) {
-						closest_end_distance = end_distance;
-						closest_end_point = end_point;
-						closest_end_polygon = &end_poly;
-					}
-				}
+		auto add_connection = [&](FreeEdge &r_from, const FreeEdge &p_to, const gd::Edge::Connection &p_connection) {
+			r_from.connection.polygon->edges[r_from.connection.edge].connections.push_back(p_connection);
+			r_from.border_edge->connections.push_back(p_connection);
+			_add_region_neighbor(r_from.state->neighbors, p_to.region);
+			_add_region_neighbor(p_to.state->neighbors, r_from.region);
+			changed_regions.insert(r_from.region);
+		};
+
+		for (uint32_t i = 0; has_new_free_edge && i < free_edges.size(); i++) {
+			FreeEdge &free_edge = free_edges[i];
+			if (!free_edge.is_new) {
+				continue;
 			}
 
-			// If we have both a start and end point, then create a synthetic polygon to route through.
-			if (closest_start_polygon && closest_end_polygon) {
-				gd::Polygon &new_polygon = link_polygons[link_poly_idx++];
-				new_polygon.id = polygon_count++;
-				new_polygon.owner = link;
-
-				new_polygon.edges.clear();
-				new_polygon.edges.resize(4);
-				new_polygon.points.clear();
-				new_polygon.points.reserve(4);
-
-				// Build a set of vertices that create a thin polygon going from the start to the end point.
-				new_polygon.points.push_back({ closest_start_point, get_point_key(closest_start_point) });
-				new_polygon.points.push_back({ closest_start_point, get_point_key(closest_start_point) });
-				new_polygon.points.push_back({ closest_end_point, get_point_key(closest_end_point) });
-				new_polygon.points.push_back({ closest_end_point, get_point_key(closest_end_point) });
-
-				// Setup connections to go forward in the link.
-				{
-					gd::Edge::Connection entry_connection;
-					entry_connection.polygon = &new_polygon;
-					entry_connection.edge = -1;
-					entry_connection.pathway_start = new_polygon.points[0].pos;
-					entry_connection.pathway_end = new_polygon.points[1].pos;
-					closest_start_polygon->edges[0].connections.push_back(entry_connection);
-
-					gd::Edge::Connection exit_connection;
-					exit_connection.polygon = closest_end_polygon;
-					exit_connection.edge = -1;
-					exit_connection.pathway_start = new_polygon.points[2].pos;
-					exit_connection.pathway_end = new_polygon.points[3].pos;
-					new_polygon.edges[2].connections.push_back(exit_connection);
+			for (uint32_t j = 0; j < free_edges.size(); j++) {
+				FreeEdge &other_edge = free_edges[j];
+				if (i == j || free_edge.region == other_edge.region) {
+					continue;
 				}
 
-				// If the link is bi-directional, create connections from the end to the start.
-				if (link->is_bidirectional()) {
-					gd::Edge::Connection entry_connection;
-					entry_connection.polygon = &new_polygon;
-					entry_connection.edge = -1;
-					entry_connection.pathway_start = new_polygon.points[2].pos;
-					entry_connection.pathway_end = new_polygon.points[3].pos;
-					closest_end_polygon->edges[0].connections.push_back(entry_connection);
-
-					gd::Edge::Connection exit_connection;
-					exit_connection.polygon = closest_start_polygon;
-					exit_connection.edge = -1;
-					exit_connection.pathway_start = new_polygon.points[0].pos;
-					exit_connection.pathway_end = new_polygon.points[1].pos;
-					new_polygon.edges[0].connections.push_back(exit_connection);
+				gd::Edge::Connection new_connection;
+				if (_get_edge_proximity_connection(free_edge.connection, other_edge.connection, edge_connection_margin, new_connection)) {
+					add_connection(free_edge, other_edge, new_connection);
+				}
+				// New edges compute their own connections.
+				if (!other_edge.is_new && _get_edge_proximity_connection(other_edge.connection, free_edge.connection, edge_connection_margin, new_connection)) {
+					add_connection(other_edge, free_edge, new_connection);
 				}
 			}
 		}
-
-		// Some code treats 0 as a failure case, so we avoid returning 0 and modulo wrap UINT32_MAX manually.
-		iteration_id = iteration_id % UINT32_MAX + 1;
 	}
 
-	// Do we have modified obstacle positions?
-	for (NavObstacle *obstacle : obstacles) {
-		if (obstacle->check_dirty()) {
-			obstacles_dirty = true;
+	for (NavRegion *region : changed_regions) {
+		HashMap<NavRegion *, RegionSyncState>::Iterator state_it = region_sync_states.find(region);
+		if (!state_it) {
+			continue;
 		}
-	}
-	// Do we have modified agent arrays?
-	for (NavAgent *agent : agents) {
-		if (agent->check_dirty()) {
-			agents_dirty = true;
+		RegionSyncState &state = state_it->value;
+		if (!dirty_regions.has(region) && state.polygon_count > 0) {
+			r_ranges.reconnected.push_back({ state.polygon_offset, state.polygon_offset + state.polygon_count });
 		}
+
+		// Add the connections to the region_connection map.
+		LocalVector<gd::Edge::Connection> &external_connections = region_external_connections[region];
+		external_connections.clear();
+		state.border_merge_count = 0;
+		state.border_free_count = 0;
+		for (const RegionBorderEdge &border_edge : state.border_edges) {
+			if (border_edge.merged) {
+				state.border_merge_count += 1;
+			} else if (border_edge.connectable) {
+				state.border_free_count += 1;
+			}
+			for (const gd::Edge::Connection &connection : border_edge.connections) {
+				external_connections.push_back(connection);
+			}
+		}
+		state.border_connection_count = external_connections.size();
 	}
 
-	// Update avoidance worlds.
-	if (obstacles_dirty || agents_dirty) {
-		_update_rvo_simulation();
+	if (full_rebuild) {
+		NavMeshQueries3D::polygons_build_bvh(polygons, polygons_bvh);
+	} else if (!released_ranges.is_empty() || !synced_ranges.is_empty()) {
+		// Only the subtrees of the released and copied ranges change.
+		NavMeshQueries3D::polygons_update_bvh(polygons, polygons_bvh, released_ranges, synced_ranges);
 	}
 
-	regenerate_polygons = false;
-	regenerate_links = false;
-	obstacles_dirty = false;
-	agents_dirty = false;
+	return polygon_sync_count;
+}
 
-	// Performance Monitor.
-	pm_region_count = _new_pm_region_count;
-	pm_agent_count = _new_pm_agent_count;
-	pm_link_count = _new_pm_link_count;
-	pm_polygon_count = _new_pm_polygon_count;
-	pm_edge_count = _new_pm_edge_count;
-	pm_edge_merge_count = _new_pm_edge_merge_count;
-	pm_edge_connection_count = _new_pm_edge_connection_count;
-	pm_edge_free_count = _new_pm_edge_free_count;
-	pm_obstacle_count = _new_pm_obstacle_count;
+uint32_t NavMap::_sync_links() {
+	uint32_t link_sync_count = 0;
+	uint32_t polygon_count = polygons.size();
+	uint32_t link_poly_idx = 0;
+	link_polygons.resize(links.size());
+
+	// Search for polygons within range of a nav link.
+	for (const NavLink *link : links) {
+		if (!link->get_enabled()) {
+			continue;
+		}
+		const Vector3 start = link->get_start_position();
+		const Vector3 end = link->get_end_position();
+
+		// Reuse the polygons found by the previous sync, unless polygons within range of the link changed.
+		LinkSyncState *link_state = link_sync_states.getptr(link);
+		if (link_state) {
+			const AABB start_bounds = AABB(start, Vector3()).grow(link_connection_radius);
+			const AABB end_bounds = AABB(end, Vector3()).grow(link_connection_radius);
+			for (const AABB &dirty_bounds : link_dirty_bounds) {
+				if (dirty_bounds.intersects_inclusive(start_bounds) || dirty_bounds.intersects_inclusive(end_bounds)) {
+					link_state = nullptr;
+					break;
+				}
+			}
+		}
+		if (!link_state) {
+			link_state = &link_sync_states[link];
+			link_state->start_polygon = NavMeshQueries3D::polygons_get_closest_polygon_in_radius(polygons, polygons_bvh, start, link_connection_radius, link_state->start_point);
+			link_state->end_polygon = NavMeshQueries3D::polygons_get_closest_polygon_in_radius(polygons, polygons_bvh, end, link_connection_radius, link_state->end_point);
+			link_sync_count++;
+		}
+
+		gd::Polygon *closest_start_polygon = link_state->start_polygon != UINT32_MAX ? &polygons[link_state->start_polygon] : nullptr;
+		const Vector3 closest_start_point = link_state->start_point;
+
+		gd::Polygon *closest_end_polygon = link_state->end_polygon != UINT32_MAX ? &polygons[link_state->end_polygon] : nullptr;
+		const Vector3 closest_end_point = link_state->end_point;
+
+		// If we have both a start and end point, then create a synthetic polygon to route through.
+		if (closest_start_polygon && closest_end_polygon) {
+			gd::Polygon &new_polygon = link_polygons[link_poly_idx++];
+			new_polygon.id = polygon_count++;
+			new_polygon.owner = link;
+
+			new_polygon.edges.clear();
+			new_polygon.edges.resize(4);
+			new_polygon.points.clear();
+			new_polygon.points.reserve(4);
+
+			// Build a set of vertices that create a thin polygon going from the start to the end point.
+			new_polygon.points.push_back({ closest_start_point, get_point_key(closest_start_point) });
+			new_polygon.points.push_back({ closest_start_point, get_point_key(closest_start_point) });
+			new_polygon.points.push_back({ closest_end_point, get_point_key(closest_end_point) });
+			new_polygon.points.push_back({ closest_end_point, get_point_key(closest_end_point) });
+
+			// Setup connections to go forward in the link.
+			{
+				gd::Edge::Connection entry_connection;
+				entry_connection.polygon = &new_polygon;
+				entry_connection.edge = -1;
+				entry_connection.pathway_start = new_polygon.points[0].pos;
+				entry_connection.pathway_end = new_polygon.points[1].pos;
+				closest_start_polygon->edges[0].connections.push_back(entry_connection);
+				link_connected_polygons.push_back(closest_start_polygon->id);
+
+				gd::Edge::Connection exit_connection;
+				exit_connection.polygon = closest_end_polygon;
+				exit_connection.edge = -1;
+				exit_connection.pathway_start = new_polygon.points[2].pos;
+				exit_connection.pathway_end = new_polygon.points[3].pos;
+				new_polygon.edges[2].connections.push_back(exit_connection);
+			}
+
+			// If the link is bi-directional, create connections from the end to the start.
+			if (link->is_bidirectional()) {
+				gd::Edge::Connection entry_connection;
+				entry_connection.polygon = &new_polygon;
+				entry_connection.edge = -1;
+				entry_connection.pathway_start = new_polygon.points[2].pos;
+				entry_connection.pathway_end = new_polygon.points[3].pos;
+				closest_end_polygon->edges[0].connections.push_back(entry_connection);
+				link_connected_polygons.push_back(closest_end_polygon->id);
+
+				gd::Edge::Connection exit_connection;
+				exit_connection.polygon = closest_start_polygon;
+				exit_connection.edge = -1;
+				exit_connection.pathway_start = new_polygon.points[0].pos;
+				exit_connection.pathway_end = new_polygon.points[1].pos;
+				new_polygon.edges[0].connections.push_back(exit_connection);
+			}
+		}
+	}
+
+	link_dirty_bounds.clear();
+	return link_sync_count;
 }
 
 void NavMap::_update_rvo_obstacles_tree_2d() {
@@ -782,25 +1413,199 @@ void NavMap::_update_rvo_agents_tree_3d() {
 	rvo_simulation_3d.kdTree_->buildAgentTree(raw_agents);
 }
 
+void NavMap::_update_avoidance_spatial_hash(AvoidanceSpatialHash &r_spatial_hash, const LocalVector<NavAgent *> &p_agents, bool p_use_3d) {
+	const uint32_t agent_count = p_agents.size();
+
+	bool agents_changed = r_spatial_hash.agents.size() != agent_count;
+	for (uint32_t i = 0; !agents_changed && i < agent_count; i++) {
+		agents_changed = r_spatial_hash.agents[i] != p_agents[i];
+	}
+
+	if (agents_changed) {
+		r_spatial_hash.agents = p_agents;
+		r_spatial_hash.cells.clear();
+		r_spatial_hash.agent_cells.resize(agent_count);
+		r_spatial_hash.agent_cell_slots.resize(agent_count);
+
+		// Cells about the size of the neighbor distance keep the searched cells around an agent few and small.
+		real_t neighbor_distance_sum = 0.0;
+		for (NavAgent *agent : p_agents) {
+			neighbor_distance_sum += p_use_3d ? agent->get_rvo_agent_3d()->neighborDist_ : agent->get_rvo_agent_2d()->neighborDist_;
+		}
+		r_spatial_hash.cell_size = agent_count > 0 ? MAX(real_t(0.1), neighbor_distance_sum / agent_count) : real_t(1.0);
+	}
+
+	r_spatial_hash.new_agent_cells.resize(agent_count);
+	if (use_threads && avoidance_use_multiple_threads) {
+		WorkerThreadPool::GroupID group_task = p_use_3d
+				? WorkerThreadPool::get_singleton()->add_template_group_task(this, &NavMap::_compute_avoidance_agent_cell_3d, &r_spatial_hash, agent_count, -1, true, SNAME("RVOAvoidanceSpatialHash3D"))
+				: WorkerThreadPool::get_singleton()->add_template_group_task(this, &NavMap::_compute_avoidance_agent_cell_2d, &r_spatial_hash, agent_count, -1, true, SNAME("RVOAvoidanceSpatialHash2D"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	} else {
+		for (uint32_t i = 0; i < agent_count; i++) {
+			if (p_use_3d) {
+				_compute_avoidance_agent_cell_3d(i, &r_spatial_hash);
+			} else {
+				_compute_avoidance_agent_cell_2d(i, &r_spatial_hash);
+			}
+		}
+	}
+
+	for (uint32_t i = 0; i < agent_count; i++) {
+		const Vector3i &new_cell = r_spatial_hash.new_agent_cells[i];
+		if (!agents_changed) {
+			const Vector3i &cell = r_spatial_hash.agent_cells[i];
+			if (cell == new_cell) {
+				continue;
+			}
+
+			// Swap remove the agent from its previous cell.
+			LocalVector<uint32_t> &cell_agents = r_spatial_hash.cells[cell];
+			const uint32_t slot = r_spatial_hash.agent_cell_slots[i];
+			const uint32_t last_agent = cell_agents[cell_agents.size() - 1];
+			cell_agents[slot] = last_agent;
+			r_spatial_hash.agent_cell_slots[last_agent] = slot;
+			cell_agents.remove_at(cell_agents.size() - 1);
+			if (cell_agents.is_empty()) {
+				r_spatial_hash.cells.erase(cell);
+			}
+		}
+
+		LocalVector<uint32_t> &new_cell_agents = r_spatial_hash.cells[new_cell];
+		r_spatial_hash.agent_cells[i] = new_cell;
+		r_spatial_hash.agent_cell_slots[i] = new_cell_agents.size();
+		new_cell_agents.push_back(i);
+	}
+}
+
+void NavMap::_compute_avoidance_agent_cell_2d(uint32_t p_index, AvoidanceSpatialHash *p_spatial_hash) {
+	const RVO2D::Vector2 &position = p_spatial_hash->agents[p_index]->get_rvo_agent_2d()->position_;
+	p_spatial_hash->new_agent_cells[p_index] = Vector3i(
+			Math::floor(position.x() / p_spatial_hash->cell_size),
+			0,
+			Math::floor(position.y() / p_spatial_hash->cell_size));
+}
+
+void NavMap::_compute_avoidance_agent_cell_3d(uint32_t p_index, AvoidanceSpatialHash *p_spatial_hash) {
+	const RVO3D::Vector3 &position = p_spatial_hash->agents[p_index]->get_rvo_agent_3d()->position_;
+	p_spatial_hash->new_agent_cells[p_index] = Vector3i(
+			Math::floor(position.x() / p_spatial_hash->cell_size),
+			Math::floor(position.y() / p_spatial_hash->cell_size),
+			Math::floor(position.z() / p_spatial_hash->cell_size));
+}
+
+void NavMap::_compute_avoidance_agent_neighbors_2d(uint32_t p_index) {
+	const AvoidanceSpatialHash &spatial_hash = avoidance_spatial_hash_2d;
+	RVO2D::Agent2D *rvo_agent = spatial_hash.agents[p_index]->get_rvo_agent_2d();
+
+	// Obstacles still come from the RVO obstacle tree, same as in `RVO2D::Agent2D::computeNeighbors()`.
+	rvo_agent->obstacleNeighbors_.clear();
+	rvo_simulation_2d.kdTree_->computeObstacleNeighbors(rvo_agent, RVO2D::sqr(rvo_agent->timeHorizonObst_ * rvo_agent->maxSpeed_ + rvo_agent->radius_));
+
+	rvo_agent->agentNeighbors_.clear();
+	if (rvo_agent->maxNeighbors_ == 0) {
+		return;
+	}
+
+	// The cells are from the last update, agents move while the neighbors of the others are searched.
+	const Vector3i &cell = spatial_hash.agent_cells[p_index];
+	const int range = Math::ceil(rvo_agent->neighborDist_ / spatial_hash.cell_size);
+	float range_sq = RVO2D::sqr(rvo_agent->neighborDist_);
+
+	if (uint64_t(range * 2 + 1) * uint64_t(range * 2 + 1) >= spatial_hash.cells.size()) {
+		// Fewer cells exist than would be searched.
+		for (const KeyValue<Vector3i, LocalVector<uint32_t>> &E : spatial_hash.cells) {
+			for (uint32_t agent_index : E.value) {
+				rvo_agent->insertAgentNeighbor(spatial_hash.agents[agent_index]->get_rvo_agent_2d(), range_sq);
+			}
+		}
+		return;
+	}
+
+	for (int z = cell.z - range; z <= cell.z + range; z++) {
+		for (int x = cell.x - range; x <= cell.x + range; x++) {
+			const LocalVector<uint32_t> *cell_agents = spatial_hash.cells.getptr(Vector3i(x, 0, z));
+			if (!cell_agents) {
+				continue;
+			}
+			for (uint32_t agent_index : *cell_agents) {
+				rvo_agent->insertAgentNeighbor(spatial_hash.agents[agent_index]->get_rvo_agent_2d(), range_sq);
+			}
+		}
+	}
+}
+
+void NavMap::_compute_avoidance_agent_neighbors_3d(uint32_t p_index) {
+	const AvoidanceSpatialHash &spatial_hash = avoidance_spatial_hash_3d;
+	RVO3D::Agent3D *rvo_agent = spatial_hash.agents[p_index]->get_rvo_agent_3d();
+
+	rvo_agent->agentNeighbors_.clear();
+	if (rvo_agent->maxNeighbors_ == 0) {
+		return;
+	}
+
+	const Vector3i &cell = spatial_hash.agent_cells[p_index];
+	const int range = Math::ceil(rvo_agent->neighborDist_ / spatial_hash.cell_size);
+	float range_sq = rvo_agent->neighborDist_ * rvo_agent->neighborDist_;
+
+	const uint64_t range_cell_count = uint64_t(range * 2 + 1) * uint64_t(range * 2 + 1) * uint64_t(range * 2 + 1);
+	if (range_cell_count >= spatial_hash.cells.size()) {
+		// Fewer cells exist than would be searched.
+		for (const KeyValue<Vector3i, LocalVector<uint32_t>> &E : spatial_hash.cells) {
+			for (uint32_t agent_index : E.value) {
+				rvo_agent->insertAgentNeighbor(spatial_hash.agents[agent_index]->get_rvo_agent_3d(), range_sq);
+			}
+		}
+		return;
+	}
+
+	for (int z = cell.z - range; z <= cell.z + range; z++) {
+		for (int y = cell.y - range; y <= cell.y + range; y++) {
+			for (int x = cell.x - range; x <= cell.x + range; x++) {
+				const LocalVector<uint32_t> *cell_agents = spatial_hash.cells.getptr(Vector3i(x, y, z));
+				if (!cell_agents) {
+					continue;
+				}
+				for (uint32_t agent_index : *cell_agents) {
+					rvo_agent->insertAgentNeighbor(spatial_hash.agents[agent_index]->get_rvo_agent_3d(), range_sq);
+				}
+			}
+		}
+	}
+}
+
 void NavMap::_update_rvo_simulation() {
 	if (obstacles_dirty) {
 		_update_rvo_obstacles_tree_2d();
 	}
 	if (agents_dirty) {
-		_update_rvo_agents_tree_2d();
-		_update_rvo_agents_tree_3d();
+		if (use_avoidance_spatial_hash) {
+			_update_avoidance_spatial_hash(avoidance_spatial_hash_2d, active_2d_avoidance_agents, false);
+			_update_avoidance_spatial_hash(avoidance_spatial_hash_3d, active_3d_avoidance_agents, true);
+		} else {
+			_update_rvo_agents_tree_2d();
+			_update_rvo_agents_tree_3d();
+		}
 	}
 }
 
 void NavMap::compute_single_avoidance_step_2d(uint32_t index, NavAgent **agent) {
-	(*(agent + index))->get_rvo_agent_2d()->computeNeighbors(&rvo_simulation_2d);
+	if (use_avoidance_spatial_hash) {
+		_compute_avoidance_agent_neighbors_2d(index);
+	} else {
+		(*(agent + index))->get_rvo_agent_2d()->computeNeighbors(&rvo_simulation_2d);
+	}
 	(*(agent + index))->get_rvo_agent_2d()->computeNewVelocity(&rvo_simulation_2d);
 	(*(agent + index))->get_rvo_agent_2d()->update(&rvo_simulation_2d);
 	(*(agent + index))->update();
 }
 
 void NavMap::compute_single_avoidance_step_3d(uint32_t index, NavAgent **agent) {
-	(*(agent + index))->get_rvo_agent_3d()->computeNeighbors(&rvo_simulation_3d);
+	if (use_avoidance_spatial_hash) {
+		_compute_avoidance_agent_neighbors_3d(index);
+	} else {
+		(*(agent + index))->get_rvo_agent_3d()->computeNeighbors(&rvo_simulation_3d);
+	}
 	(*(agent + index))->get_rvo_agent_3d()->computeNewVelocity(&rvo_simulation_3d);
 	(*(agent + index))->get_rvo_agent_3d()->update(&rvo_simulation_3d);
 	(*(agent + index))->update();
@@ -817,11 +1622,8 @@ void NavMap::step(real_t p_deltatime) {
 			WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &NavMap::compute_single_avoidance_step_2d, active_2d_avoidance_agents.ptr(), active_2d_avoidance_agents.size(), -1, true, SNAME("RVOAvoidanceAgents2D"));
 			WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
 		} else {
-			for (NavAgent *agent : active_2d_avoidance_agents) {
-				agent->get_rvo_agent_2d()->computeNeighbors(&rvo_simulation_2d);
-				agent->get_rvo_agent_2d()->computeNewVelocity(&rvo_simulation_2d);
-				agent->get_rvo_agent_2d()->update(&rvo_simulation_2d);
-				agent->update();
+			for (uint32_t i = 0; i < active_2d_avoidance_agents.size(); i++) {
+				compute_single_avoidance_step_2d(i, active_2d_avoidance_agents.ptr());
 			}
 		}
 	}
@@ -831,11 +1633,8 @@ void NavMap::step(real_t p_deltatime) {
 			WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &NavMap::compute_single_avoidance_step_3d, active_3d_avoidance_agents.ptr(), active_3d_avoidance_agents.size(), -1, true, SNAME("RVOAvoidanceAgents3D"));
 			WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
 		} else {
-			for (NavAgent *agent : active_3d_avoidance_agents) {
-				agent->get_rvo_agent_3d()->computeNeighbors(&rvo_simulation_3d);
-				agent->get_rvo_agent_3d()->computeNewVelocity(&rvo_simulation_3d);
-				agent->get_rvo_agent_3d()->update(&rvo_simulation_3d);
-				agent->update();
+			for (uint32_t i = 0; i < active_3d_avoidance_agents.size(); i++) {
+				compute_single_avoidance_step_3d(i, active_3d_avoidance_agents.ptr());
 			}
 		}
 	}
@@ -896,4 +1695,7 @@ NavMap::NavMap() {
 }
 
 NavMap::~NavMap() {
+	for (gd::PathQuerySlot *slot : path_query_slots) {
+		memdelete(slot);
+	}
 }
@@ -36,6 +36,7 @@
 
 #include "core/math/math_defs.h"
 #include "core/object/worker_thread_pool.h"
+#include "core/os/mutex.h"
 #include "servers/navigation/navigation_globals.h"
 
 #include <KdTree2d.h>
@@ -74,6 +75,8 @@ class NavMap : public NavRid {
 
 	bool regenerate_polygons = true;
 	bool regenerate_links = true;
+	/// Set when a map setting invalidates the connections between all regions.
+	bool regenerate_connections = true;
 
 	/// Map regions
 	LocalVector<NavRegion *> regions;
@@ -83,7 +86,92 @@ class NavMap : public NavRid {
 	LocalVector<gd::Polygon> link_polygons;
 
 	/// Map polygons
+	/// Each region owns a contiguous range of polygons that is kept between syncs while the region is unchanged.
+	/// Ranges released by changed or removed regions are left as holes (polygons without owner).
+	/// Holes are reused by the next ranges that fit in them, before appending new polygons.
 	LocalVector<gd::Polygon> polygons;
+	uint32_t polygon_hole_count = 0;
+	/// Holes sorted by position, adjacent holes are merged.
+	LocalVector<gd::PolygonRange> polygon_holes;
+	/// Spatial index over `polygons` used by the closest point and path queries.
+	gd::PolygonBVH polygons_bvh;
+
+	/// Number of polygons grouped in a cluster of the hierarchical path search, 0 disables it.
+	uint32_t path_cluster_size = 0;
+	gd::PolygonClusterGraph polygon_clusters;
+
+	/// Region edge that was not merged with another edge of the same region.
+	struct RegionBorderEdge {
+		gd::EdgeKey key;
+		/// Index of the polygon in the region range.
+		uint32_t polygon = 0;
+		uint32_t edge = 0;
+		/// Merged by key with the edge of another region.
+		bool merged = false;
+		/// Can be connected to the edges of other regions by proximity.
+		bool connectable = false;
+		/// Connections to other regions made by edge proximity from this edge.
+		LocalVector<gd::Edge::Connection> connections;
+	};
+
+	/// Cached region data used to only process the changed regions and their borders on sync.
+	struct RegionSyncState {
+		uint32_t polygon_offset = 0;
+		uint32_t polygon_count = 0;
+		/// Number of distinct edges and of edges merged inside the region.
+		uint32_t edge_count = 0;
+		uint32_t edge_merge_count = 0;
+		/// Number of border edges merged with another region, free to connect by proximity, and of proximity connections.
+		uint32_t border_merge_count = 0;
+		uint32_t border_free_count = 0;
+		uint32_t border_connection_count = 0;
+		LocalVector<RegionBorderEdge> border_edges;
+		/// Regions with connections from or to this one.
+		LocalVector<NavRegion *> neighbors;
+	};
+
+	/// Polygon ranges changed by a region sync, used to update the BVH and the clusters.
+	struct PolygonSyncRanges {
+		bool full_rebuild = false;
+		LocalVector<gd::PolygonRange> released;
+		LocalVector<gd::PolygonRange> synced;
+		/// Ranges of the regions whose connections changed.
+		LocalVector<gd::PolygonRange> reconnected;
+	};
+
+	struct RegionBorderEdgeRef {
+		NavRegion *region = nullptr;
+		uint32_t index = 0;
+	};
+
+	HashMap<NavRegion *, RegionSyncState> region_sync_states;
+	/// Border edges of all the regions grouped by key, kept between syncs.
+	HashMap<gd::EdgeKey, LocalVector<RegionBorderEdgeRef>, gd::EdgeKey> region_border_edges;
+	/// Polygons that hold connections to link polygons.
+	LocalVector<uint32_t> link_connected_polygons;
+
+	struct LinkSyncState {
+		uint32_t start_polygon = UINT32_MAX;
+		uint32_t end_polygon = UINT32_MAX;
+		Vector3 start_point;
+		Vector3 end_point;
+	};
+
+	/// Polygons the links connect to, searched again only when the link or the polygons near it changed.
+	HashMap<const NavLink *, LinkSyncState> link_sync_states;
+	/// Bounds of the polygons added or removed since the last link sync.
+	LocalVector<AABB> link_dirty_bounds;
+
+	/// Search data reused by the path queries that are not running.
+	/// Created when more queries run at once than there are free slots, freed on sync when unused.
+	mutable LocalVector<gd::PathQuerySlot *> path_query_slots;
+	mutable Mutex path_query_slots_mutex;
+
+	/// Flow fields of the recently queried targets, the least recently used one is replaced once full.
+	static constexpr uint32_t FLOW_FIELD_CACHE_MAX = 8;
+	mutable LocalVector<gd::PolygonFlowField> flow_fields;
+	mutable uint64_t flow_field_tick = 0;
+	mutable Mutex flow_fields_mutex;
 
 	/// RVO avoidance worlds
 	RVO2D::RVOSimulator2D rvo_simulation_2d;
@@ -96,6 +184,22 @@ class NavMap : public NavRid {
 	/// dirty flag when one of the agent's arrays are modified
 	bool agents_dirty = true;
 
+	/// Uniform grid of avoidance agents that replaces the RVO agent trees for the neighbor search when enabled.
+	/// Only the agents that moved to another cell are updated unless the avoidance agents changed.
+	struct AvoidanceSpatialHash {
+		real_t cell_size = 1.0;
+		/// Cells hold the indices of their agents in `agents`.
+		HashMap<Vector3i, LocalVector<uint32_t>> cells;
+		LocalVector<NavAgent *> agents;
+		LocalVector<Vector3i> agent_cells;
+		/// Index of each agent in the agent list of its cell.
+		LocalVector<uint32_t> agent_cell_slots;
+		LocalVector<Vector3i> new_agent_cells;
+	};
+	bool use_avoidance_spatial_hash = false;
+	AvoidanceSpatialHash avoidance_spatial_hash_2d;
+	AvoidanceSpatialHash avoidance_spatial_hash_3d;
+
 	/// All the Agents (even the controlled one)
 	LocalVector<NavAgent *> agents;
 
@@ -125,6 +229,12 @@ class NavMap : public NavRid {
 	int pm_edge_connection_count = 0;
 	int pm_edge_free_count = 0;
 	int pm_obstacle_count = 0;
+	int pm_polygon_sync_count = 0;
+	int pm_link_sync_count = 0;
+	// Counted by the path queries between the last two syncs.
+	int pm_path_query_polygon_count = 0;
+	int pm_path_query_cluster_count = 0;
+	int pm_path_query_retry_count = 0;
 
 	HashMap<NavRegion *, LocalVector<gd::Edge::Connection>> region_external_connections;
 
@@ -152,6 +262,16 @@ public:
 		return merge_rasterizer_cell_scale;
 	}
 
+	void set_path_cluster_size(uint32_t p_cluster_size);
+	uint32_t get_path_cluster_size() const {
+		return path_cluster_size;
+	}
+
+	void set_use_avoidance_spatial_hash(bool p_enabled);
+	bool get_use_avoidance_spatial_hash() const {
+		return use_avoidance_spatial_hash;
+	}
+
 	void set_use_edge_connections(bool p_enabled);
 	bool get_use_edge_connections() const {
 		return use_edge_connections;
@@ -175,6 +295,7 @@ public:
 	Vector3 get_closest_point_normal(const Vector3 &p_point) const;
 	gd::ClosestPointQueryResult get_closest_point_info(const Vector3 &p_point) const;
 	RID get_closest_point_owner(const Vector3 &p_point) const;
+	Vector3 get_flow_field_next_position(const Vector3 &p_target, const Vector3 &p_from, uint32_t p_navigation_layers) const;
 
 	void add_region(NavRegion *p_region);
 	void remove_region(NavRegion *p_region);
@@ -221,12 +342,24 @@ public:
 	int get_pm_edge_connection_count() const { return pm_edge_connection_count; }
 	int get_pm_edge_free_count() const { return pm_edge_free_count; }
 	int get_pm_obstacle_count() const { return pm_obstacle_count; }
+	int get_pm_polygon_sync_count() const { return pm_polygon_sync_count; }
+	int get_pm_link_sync_count() const { return pm_link_sync_count; }
+	int get_pm_path_query_polygon_count() const { return pm_path_query_polygon_count; }
+	int get_pm_path_query_cluster_count() const { return pm_path_query_cluster_count; }
+	int get_pm_path_query_retry_count() const { return pm_path_query_retry_count; }
 
 	int get_region_connections_count(NavRegion *p_region) const;
 	Vector3 get_region_connection_pathway_start(NavRegion *p_region, int p_connection_id) const;
 	Vector3 get_region_connection_pathway_end(NavRegion *p_region, int p_connection_id) const;
 
 private:
+	uint32_t _sync_regions(const LocalVector<NavRegion *> &p_dirty_regions, PolygonSyncRanges &r_ranges);
+	gd::PathQuerySlot *_acquire_path_query_slot() const;
+	void _release_path_query_slot(gd::PathQuerySlot *p_slot) const;
+	void _trim_path_query_slots();
+	const gd::PolygonFlowField &_get_flow_field(uint32_t p_target_polygon, uint32_t p_navigation_layers) const;
+	uint32_t _sync_links();
+
 	void compute_single_step(uint32_t index, NavAgent **agent);
 
 	void compute_single_avoidance_step_2d(uint32_t index, NavAgent **agent);
@@ -236,6 +369,11 @@ private:
 	void _update_rvo_obstacles_tree_2d();
 	void _update_rvo_agents_tree_2d();
 	void _update_rvo_agents_tree_3d();
+	void _update_avoidance_spatial_hash(AvoidanceSpatialHash &r_spatial_hash, const LocalVector<NavAgent *> &p_agents, bool p_use_3d);
+	void _compute_avoidance_agent_cell_2d(uint32_t p_index, AvoidanceSpatialHash *p_spatial_hash);
+	void _compute_avoidance_agent_cell_3d(uint32_t p_index, AvoidanceSpatialHash *p_spatial_hash);
+	void _compute_avoidance_agent_neighbors_2d(uint32_t p_index);
+	void _compute_avoidance_agent_neighbors_3d(uint32_t p_index);
 
 	void _update_merge_rasterizer_cell_dimensions();
 };
@@ -31,6 +31,7 @@
 #ifndef NAV_UTILS_H
 #define NAV_UTILS_H
 
+#include "core/math/aabb.h"
 #include "core/math/vector3.h"
 #include "core/templates/hash_map.h"
 #include "core/templates/hashfuncs.h"
@@ -120,6 +121,9 @@ struct NavigationPoly {
 	/// Index in the heap of traversable polygons.
 	uint32_t traversable_poly_index = UINT32_MAX;
 
+	/// Generation of the query slot search that visited this poly.
+	uint32_t generation = 0;
+
 	/// Those 4 variables are used to travel the path backwards.
 	int back_navigation_poly_id = -1;
 	int back_navigation_edge = -1;
@@ -175,6 +179,127 @@ struct ClosestPointQueryResult {
 	RID owner;
 };
 
+/// Range of map polygons, from `begin` to `end - 1`.
+struct PolygonRange {
+	uint32_t begin = 0;
+	uint32_t end = 0;
+};
+
+/// Bounding volume hierarchy over the polygons of a map.
+/// Used to find the polygons near a point or a segment without scanning all of them.
+/// Each region's polygon range has its own subtree, so a map sync only rebuilds the subtrees of the changed regions
+/// and the small top-level tree over the subtree roots.
+struct PolygonBVH {
+	/// Maximum number of polygons referenced by a leaf.
+	static const uint32_t LEAF_SIZE = 4;
+	/// Enough traversal stack for any tree built from median splits, traversals stop with an error past it.
+	static const uint32_t STACK_SIZE = 64;
+
+	struct Node {
+		AABB aabb;
+		/// Leaves reference `count` entries of `polygon_indices` starting at `first`.
+		/// Inner nodes have a `count` of 0 and their two children at `first` and `first + 1`.
+		uint32_t first = 0;
+		uint32_t count = 0;
+
+		bool is_leaf() const { return count > 0; }
+	};
+
+	/// Node 0 is the root. The subtree of a polygon range uses the nodes from `1 + begin` to `end`,
+	/// which is enough for any subtree built from median splits. The top-level nodes follow the subtree nodes.
+	LocalVector<Node> nodes;
+	/// Indices of the polygons of each subtree range, in the order of the subtree leaves.
+	LocalVector<uint32_t> polygon_indices;
+	/// Bounds of each polygon, indexed like the map polygons.
+	LocalVector<AABB> polygon_aabbs;
+	/// Polygon ranges that have a subtree.
+	LocalVector<PolygonRange> subtrees;
+
+	void clear() {
+		nodes.clear();
+		polygon_indices.clear();
+		polygon_aabbs.clear();
+		subtrees.clear();
+	}
+};
+
+/// Coarse graph of polygon clusters used to route long path queries before searching the polygons.
+/// Clusters are runs of spatially close polygons taken in BVH order, connected when any of their polygons are.
+struct PolygonClusterGraph {
+	struct Cluster {
+		Vector3 center;
+		/// Polygons of the cluster in `PolygonBVH::polygon_indices`, empty for released clusters.
+		PolygonRange range;
+		LocalVector<uint32_t> neighbors;
+	};
+
+	uint32_t cluster_size = 0;
+	/// Cluster of each map polygon, `UINT32_MAX` for polygons that are not part of any cluster.
+	LocalVector<uint32_t> polygon_clusters;
+	LocalVector<Cluster> clusters;
+	/// Released clusters, reused by the clusters of the next synced regions.
+	LocalVector<uint32_t> free_clusters;
+	/// Clusters with neighbors through navigation links, their neighbors are updated on every link sync.
+	LocalVector<uint32_t> link_clusters;
+
+	void clear() {
+		cluster_size = 0;
+		polygon_clusters.clear();
+		clusters.clear();
+		free_clusters.clear();
+		link_clusters.clear();
+	}
+};
+
+/// Cost to reach a target polygon from every polygon of a map, and the polygon to move to next.
+struct PolygonFlowField {
+	uint32_t target_polygon = UINT32_MAX;
+	uint32_t navigation_layers = 0;
+	/// Map iteration the field was built for.
+	uint32_t iteration_id = 0;
+	uint64_t last_used = 0;
+
+	LocalVector<real_t> costs;
+	/// Next polygon towards the target, `UINT32_MAX` if the target can't be reached.
+	LocalVector<uint32_t> next_polygons;
+	/// Middle of the gateway leading to the next polygon.
+	LocalVector<Vector3> next_positions;
+};
+
+struct FlowFieldSearchNode {
+	real_t cost = 0.0;
+	uint32_t polygon = UINT32_MAX;
+};
+
+struct FlowFieldSearchNodeCostGreaterThan {
+	bool operator()(const FlowFieldSearchNode &p_node_a, const FlowFieldSearchNode &p_node_b) const {
+		return p_node_a.cost > p_node_b.cost;
+	}
+};
+
+struct ClusterSearchNode {
+	uint32_t cluster = UINT32_MAX;
+	/// Index in the heap of clusters to visit.
+	uint32_t heap_index = UINT32_MAX;
+	/// Generation of the query slot search that visited this cluster.
+	uint32_t generation = 0;
+	uint32_t back_cluster = UINT32_MAX;
+	real_t traveled_distance = 0.0;
+	real_t distance_to_destination = 0.0;
+};
+
+struct ClusterSearchNodeCostGreaterThan {
+	bool operator()(const ClusterSearchNode *p_node_a, const ClusterSearchNode *p_node_b) const {
+		return p_node_a->traveled_distance + p_node_a->distance_to_destination > p_node_b->traveled_distance + p_node_b->distance_to_destination;
+	}
+};
+
+struct ClusterSearchNodeHeapIndexer {
+	void operator()(ClusterSearchNode *p_node, uint32_t p_heap_index) const {
+		p_node->heap_index = p_heap_index;
+	}
+};
+
 template <typename T>
 struct NoopIndexer {
 	void operator()(const T &p_value, uint32_t p_index) {}
@@ -298,6 +423,68 @@ private:
 		}
 	}
 };
+
+/// Reusable search data of the path queries.
+/// Kept between queries so the navigation polys don't need to be reallocated or cleared for each of them.
+struct PathQuerySlot {
+	LocalVector<NavigationPoly> navigation_polys;
+	Heap<NavigationPoly *, NavPolyTravelCostGreaterThan, NavPolyHeapIndexer> traversable_polys;
+	/// Navigation polys from another generation were not visited by the current search.
+	uint32_t generation = 0;
+	/// Whether a query used this slot since the last map sync.
+	bool used = false;
+
+	/// Work done by the queries that used this slot since the last map sync, for the performance monitors.
+	uint32_t expanded_polygon_count = 0;
+	uint32_t expanded_cluster_count = 0;
+	uint32_t corridor_retry_count = 0;
+
+	LocalVector<ClusterSearchNode> cluster_nodes;
+	Heap<ClusterSearchNode *, ClusterSearchNodeCostGreaterThan, ClusterSearchNodeHeapIndexer> traversable_clusters;
+	/// Clusters marked with the current cluster generation are part of the search corridor.
+	LocalVector<uint32_t> cluster_corridor;
+	uint32_t cluster_generation = 0;
+
+	void begin(uint32_t p_polygon_count) {
+		// Clear the heap first, it may still point to the navigation polys of the previous query.
+		traversable_polys.clear();
+		if (navigation_polys.size() < p_polygon_count) {
+			navigation_polys.resize(p_polygon_count);
+		}
+		next_generation();
+	}
+
+	void next_generation() {
+		generation++;
+		if (unlikely(generation == 0)) {
+			// Wrapped around, old generations could be mistaken for the current one.
+			for (NavigationPoly &navigation_poly : navigation_polys) {
+				navigation_poly.generation = 0;
+			}
+			generation = 1;
+		}
+	}
+
+	void begin_clusters(uint32_t p_cluster_count) {
+		traversable_clusters.clear();
+		if (cluster_nodes.size() < p_cluster_count) {
+			cluster_nodes.resize(p_cluster_count);
+			cluster_corridor.resize(p_cluster_count);
+			for (uint32_t i = 0; i < p_cluster_count; i++) {
+				cluster_corridor[i] = 0;
+			}
+		}
+		cluster_generation++;
+		if (unlikely(cluster_generation == 0)) {
+			for (uint32_t i = 0; i < cluster_nodes.size(); i++) {
+				cluster_nodes[i].generation = 0;
+				cluster_corridor[i] = 0;
+			}
+			cluster_generation = 1;
+		}
+	}
+};
+
 } // namespace gd
 
 #endif // NAV_UTILS_H
@@ -0,0 +1,138 @@
+/**************************************************************************/
+/*  test_raycast_occlusion_cull.cpp                                       */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "test_raycast_occlusion_cull.h"
+
+#include "../raycast_occlusion_cull.h"
+
+#include "core/math/random_pcg.h"
+#include "core/os/os.h"
+#include "servers/rendering/renderer_scene_occlusion_cull_raster.h"
+
+namespace TestRaycastOcclusionCull {
+
+constexpr int FRAME_COUNT = 20;
+
+// A city block of box occluders in front of the camera, with small instances scattered between and behind them.
+static OcclusionCullBenchmark _benchmark(RendererSceneOcclusionCull &r_occlusion_cull) {
+	const RID scenario = RID::from_uint64(1);
+	const RID buffer = RID::from_uint64(2);
+	const int grid_size = 20;
+	const int instance_count = 10000;
+
+	RID box = r_occlusion_cull.occluder_allocate();
+	r_occlusion_cull.occluder_initialize(box);
+	const PackedVector3Array vertices = {
+		Vector3(-1, 0, -1), Vector3(1, 0, -1), Vector3(1, 0, 1), Vector3(-1, 0, 1),
+		Vector3(-1, 4, -1), Vector3(1, 4, -1), Vector3(1, 4, 1), Vector3(-1, 4, 1)
+	};
+	const PackedInt32Array indices = {
+		0, 2, 1, 0, 3, 2, // Bottom.
+		4, 5, 6, 4, 6, 7, // Top.
+		0, 1, 5, 0, 5, 4, // Back.
+		3, 7, 6, 3, 6, 2, // Front.
+		0, 4, 7, 0, 7, 3, // Left.
+		1, 2, 6, 1, 6, 5 // Right.
+	};
+	r_occlusion_cull.occluder_set_mesh(box, vertices, indices);
+
+	r_occlusion_cull.add_scenario(scenario);
+	r_occlusion_cull.add_buffer(buffer);
+	r_occlusion_cull.buffer_set_scenario(buffer, scenario);
+	r_occlusion_cull.buffer_set_size(buffer, Vector2i(256, 144));
+
+	for (int z = 0; z < grid_size; z++) {
+		for (int x = 0; x < grid_size; x++) {
+			const Vector3 position = Vector3((x - grid_size / 2) * 5.0, 0, -5.0 - z * 5.0);
+			r_occlusion_cull.scenario_set_instance(scenario, RID::from_uint64(100 + z * grid_size + x), box, Transform3D(Basis(), position), true);
+		}
+	}
+
+	Projection projection;
+	projection.set_perspective(75.0, 16.0 / 9.0, 0.05, 200.0);
+	const Transform3D cam_transform = Transform3D(Basis(), Vector3(0, 2, 0));
+	const Transform3D cam_inv_transform = cam_transform.affine_inverse();
+
+	// The raycast backend commits its scene on a thread and picks it up on a later update.
+	r_occlusion_cull.buffer_update(buffer, cam_transform, projection, false);
+	OS::get_singleton()->delay_usec(200000);
+	r_occlusion_cull.buffer_update(buffer, cam_transform, projection, false);
+
+	OcclusionCullBenchmark result;
+	uint64_t begin_usec = OS::get_singleton()->get_ticks_usec();
+	for (int frame = 0; frame < FRAME_COUNT; frame++) {
+		r_occlusion_cull.buffer_update(buffer, cam_transform, projection, false);
+	}
+	result.update_usec = (OS::get_singleton()->get_ticks_usec() - begin_usec) / FRAME_COUNT;
+
+	RandomPCG rng(1234);
+	LocalVector<AABB> aabbs;
+	aabbs.resize(instance_count);
+	for (AABB &aabb : aabbs) {
+		aabb = AABB(Vector3(rng.random(-50.0f, 50.0f), rng.random(0.0f, 3.0f), rng.random(-105.0f, -5.0f)), Vector3(0.5, 0.5, 0.5));
+	}
+
+	RendererSceneOcclusionCull::HZBuffer *hz_buffer = r_occlusion_cull.buffer_get_ptr(buffer);
+	begin_usec = OS::get_singleton()->get_ticks_usec();
+	for (int frame = 0; frame < FRAME_COUNT; frame++) {
+		result.culled_count = 0;
+		for (const AABB &aabb : aabbs) {
+			const Vector3 end = aabb.get_end();
+			const real_t bounds[6] = { aabb.position.x, aabb.position.y, aabb.position.z, end.x, end.y, end.z };
+			uint64_t occlusion_timeout = 0;
+			if (hz_buffer->is_occluded(bounds, cam_transform.origin, cam_inv_transform, projection, projection.get_z_near(), occlusion_timeout)) {
+				result.culled_count++;
+			}
+		}
+	}
+	result.cull_usec = (OS::get_singleton()->get_ticks_usec() - begin_usec) / FRAME_COUNT;
+	result.tested_count = instance_count;
+
+	for (int i = 0; i < grid_size * grid_size; i++) {
+		r_occlusion_cull.scenario_remove_instance(scenario, RID::from_uint64(100 + i));
+	}
+	r_occlusion_cull.remove_buffer(buffer);
+	r_occlusion_cull.remove_scenario(scenario);
+	r_occlusion_cull.free_occluder(box);
+
+	return result;
+}
+
+OcclusionCullBenchmark benchmark_raycast_occlusion_cull() {
+	RaycastOcclusionCull occlusion_cull;
+	return _benchmark(occlusion_cull);
+}
+
+OcclusionCullBenchmark benchmark_raster_occlusion_cull() {
+	RendererSceneOcclusionCullRaster occlusion_cull;
+	return _benchmark(occlusion_cull);
+}
+
+} // namespace TestRaycastOcclusionCull
@@ -0,0 +1,66 @@
+/**************************************************************************/
+/*  test_raycast_occlusion_cull.h                                         */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_RAYCAST_OCCLUSION_CULL_H
+#define TEST_RAYCAST_OCCLUSION_CULL_H
+
+#include "core/string/print_string.h"
+#include "core/variant/variant.h"
+
+#include "tests/test_macros.h"
+
+namespace TestRaycastOcclusionCull {
+
+struct OcclusionCullBenchmark {
+	uint32_t culled_count = 0;
+	uint32_t tested_count = 0;
+	uint64_t update_usec = 0;
+	uint64_t cull_usec = 0;
+};
+
+// Both backends are singletons, so each one runs on its own in the same scene.
+OcclusionCullBenchmark benchmark_raycast_occlusion_cull();
+OcclusionCullBenchmark benchmark_raster_occlusion_cull();
+
+// Run with: godot --test --test-case="*[Benchmark]*" --no-skip
+TEST_CASE("[RaycastOcclusionCull][Benchmark] Raycast and software rasterizer backends on the same scene" * doctest::skip()) {
+	const OcclusionCullBenchmark raycast = benchmark_raycast_occlusion_cull();
+	const OcclusionCullBenchmark raster = benchmark_raster_occlusion_cull();
+
+	print_line(vformat("[Benchmark] Raycast: %d of %d culled, %.3f ms per buffer update, %.3f ms per cull pass", raycast.culled_count, raycast.tested_count, raycast.update_usec / 1000.0, raycast.cull_usec / 1000.0));
+	print_line(vformat("[Benchmark] Software rasterizer: %d of %d culled, %.3f ms per buffer update, %.3f ms per cull pass", raster.culled_count, raster.tested_count, raster.update_usec / 1000.0, raster.cull_usec / 1000.0));
+
+	CHECK_GT(raycast.culled_count, 0);
+	CHECK_GT(raster.culled_count, 0);
+}
+
+} // namespace TestRaycastOcclusionCull
+
+#endif // TEST_RAYCAST_OCCLUSION_CULL_H
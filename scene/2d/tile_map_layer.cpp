@@ -735,8 +735,10 @@ void TileMapLayer::_physics_notification(int p_what) {
 
 	switch (p_what) {
 		case NOTIFICATION_TRANSFORM_CHANGED:
-			// Move the collisison shapes along with the TileMap.
+			// Move the collisison shapes along with the TileMap, with a single physics server call.
 			if (is_inside_tree() && tile_set.is_valid()) {
+				LocalVector<RID> bodies;
+				LocalVector<float> buffer;
 				for (KeyValue<Vector2i, CellData> &kv : tile_map_layer_data) {
 					const CellData &cell_data = kv.value;
 
@@ -744,10 +746,19 @@ void TileMapLayer::_physics_notification(int p_what) {
 						if (body.is_valid()) {
 							Transform2D xform(0, tile_set->map_to_local(kv.key));
 							xform = gl_transform * xform;
-							ps->body_set_state(body, PhysicsServer2D::BODY_STATE_TRANSFORM, xform);
+							bodies.push_back(body);
+							buffer.push_back(xform.columns[0].x);
+							buffer.push_back(xform.columns[1].x);
+							buffer.push_back(xform.columns[2].x);
+							buffer.push_back(xform.columns[0].y);
+							buffer.push_back(xform.columns[1].y);
+							buffer.push_back(xform.columns[2].y);
 						}
 					}
 				}
+				if (!bodies.is_empty()) {
+					ps->body_set_state_batch(Vector<RID>(bodies), PhysicsServer2D::BODY_STATE_TRANSFORM, Vector<float>(buffer));
+				}
 			}
 			break;
 		case NOTIFICATION_ENTER_TREE:
@@ -237,6 +237,9 @@ public:
 	EXBIND1RC(Vector<Vector2>, space_get_contacts, RID)
 	EXBIND1RC(int, space_get_contact_count, RID)
 
+	EXBIND1RC(PackedByteArray, space_save_snapshot, RID)
+	EXBIND2R(Error, space_restore_snapshot, RID, const PackedByteArray &)
+
 	/* AREA API */
 
 	//EXBIND0RID(area);
@@ -332,6 +335,14 @@ public:
 	EXBIND3(body_set_state, RID, BodyState, const Variant &)
 	EXBIND2RC(Variant, body_get_state, RID, BodyState)
 
+	GDVIRTUAL3(_body_set_state_batch, const Vector<RID> &, BodyState, const Vector<float> &)
+	virtual void body_set_state_batch(const Vector<RID> &p_bodies, BodyState p_state, const Vector<float> &p_buffer) override {
+		if (!GDVIRTUAL_CALL(_body_set_state_batch, p_bodies, p_state, p_buffer)) {
+			// Optional, extensions that don't batch states set them one by one through _body_set_state().
+			PhysicsServer2D::body_set_state_batch(p_bodies, p_state, p_buffer);
+		}
+	}
+
 	EXBIND2(body_apply_central_impulse, RID, const Vector2 &)
 	EXBIND2(body_apply_torque_impulse, RID, real_t)
 	EXBIND3(body_apply_impulse, RID, const Vector2 &, const Vector2 &)
@@ -130,8 +130,10 @@ protected:
 	bool is_body_excluded_from_query(const RID &p_body) const;
 
 	GDVIRTUAL9R(bool, _intersect_ray, const Vector3 &, const Vector3 &, uint32_t, bool, bool, bool, bool, bool, GDExtensionPtr<PhysicsServer3DExtensionRayResult>)
+	GDVIRTUAL11R(int, _intersect_rays, GDExtensionConstPtr<const Vector3>, GDExtensionConstPtr<const Vector3>, int, uint32_t, bool, bool, bool, bool, bool, GDExtensionPtr<PhysicsServer3DExtensionRayResult>, GDExtensionPtr<bool>)
 	GDVIRTUAL6R(int, _intersect_point, const Vector3 &, uint32_t, bool, bool, GDExtensionPtr<PhysicsServer3DExtensionShapeResult>, int)
 	GDVIRTUAL9R(int, _intersect_shape, RID, const Transform3D &, const Vector3 &, real_t, uint32_t, bool, bool, GDExtensionPtr<PhysicsServer3DExtensionShapeResult>, int)
+	GDVIRTUAL11R(int, _intersect_shapes, RID, GDExtensionConstPtr<const Transform3D>, int, const Vector3 &, real_t, uint32_t, bool, bool, GDExtensionPtr<PhysicsServer3DExtensionShapeResult>, int, GDExtensionPtr<int>)
 	GDVIRTUAL10R(bool, _cast_motion, RID, const Transform3D &, const Vector3 &, real_t, uint32_t, bool, bool, GDExtensionPtr<real_t>, GDExtensionPtr<real_t>, GDExtensionPtr<PhysicsServer3DExtensionShapeRestInfo>)
 	GDVIRTUAL10R(bool, _collide_shape, RID, const Transform3D &, const Vector3 &, real_t, uint32_t, bool, bool, GDExtensionPtr<Vector3>, int, GDExtensionPtr<int>)
 	GDVIRTUAL8R(bool, _rest_info, RID, const Transform3D &, const Vector3 &, real_t, uint32_t, bool, bool, GDExtensionPtr<PhysicsServer3DExtensionShapeRestInfo>)
@@ -145,6 +147,17 @@ public:
 		exclude = nullptr;
 		return ret;
 	}
+	virtual int intersect_rays(const RayParameters &p_parameters, const Vector3 *p_from, const Vector3 *p_to, int p_count, RayResult *r_results, bool *r_collided) override {
+		exclude = &p_parameters.exclude;
+		int ret = 0;
+		bool called = GDVIRTUAL_CALL(_intersect_rays, p_from, p_to, p_count, p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas, p_parameters.hit_from_inside, p_parameters.hit_back_faces, p_parameters.pick_ray, r_results, r_collided, ret);
+		exclude = nullptr;
+		if (!called) {
+			// Optional, extensions that don't batch rays cast them one by one through _intersect_ray().
+			return PhysicsDirectSpaceState3D::intersect_rays(p_parameters, p_from, p_to, p_count, r_results, r_collided);
+		}
+		return ret;
+	}
 	virtual int intersect_point(const PointParameters &p_parameters, ShapeResult *r_results, int p_result_max) override {
 		exclude = &p_parameters.exclude;
 		int ret = false;
@@ -159,6 +172,17 @@ public:
 		exclude = nullptr;
 		return ret;
 	}
+	virtual int intersect_shapes(const ShapeParameters &p_parameters, const Transform3D *p_transforms, int p_count, ShapeResult *r_results, int p_result_max, int *r_result_counts) override {
+		exclude = &p_parameters.exclude;
+		int ret = 0;
+		bool called = GDVIRTUAL_CALL(_intersect_shapes, p_parameters.shape_rid, p_transforms, p_count, p_parameters.motion, p_parameters.margin, p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas, r_results, p_result_max, r_result_counts, ret);
+		exclude = nullptr;
+		if (!called) {
+			// Optional, extensions that don't batch shape queries run them one by one through _intersect_shape().
+			return PhysicsDirectSpaceState3D::intersect_shapes(p_parameters, p_transforms, p_count, r_results, p_result_max, r_result_counts);
+		}
+		return ret;
+	}
 	virtual bool cast_motion(const ShapeParameters &p_parameters, real_t &p_closest_safe, real_t &p_closest_unsafe, ShapeRestInfo *r_info = nullptr) override {
 		exclude = &p_parameters.exclude;
 		bool ret = false;
@@ -243,6 +267,9 @@ public:
 	EXBIND1RC(Vector<Vector3>, space_get_contacts, RID)
 	EXBIND1RC(int, space_get_contact_count, RID)
 
+	EXBIND1RC(PackedByteArray, space_save_snapshot, RID)
+	EXBIND2R(Error, space_restore_snapshot, RID, const PackedByteArray &)
+
 	/* AREA API */
 
 	//EXBIND0RID(area);
@@ -333,6 +360,14 @@ public:
 	EXBIND3(body_set_state, RID, BodyState, const Variant &)
 	EXBIND2RC(Variant, body_get_state, RID, BodyState)
 
+	GDVIRTUAL3(_body_set_state_batch, const Vector<RID> &, BodyState, const Vector<float> &)
+	virtual void body_set_state_batch(const Vector<RID> &p_bodies, BodyState p_state, const Vector<float> &p_buffer) override {
+		if (!GDVIRTUAL_CALL(_body_set_state_batch, p_bodies, p_state, p_buffer)) {
+			// Optional, extensions that don't batch states set them one by one through _body_set_state().
+			PhysicsServer3D::body_set_state_batch(p_bodies, p_state, p_buffer);
+		}
+	}
+
 	EXBIND2(body_apply_central_impulse, RID, const Vector3 &)
 	EXBIND3(body_apply_impulse, RID, const Vector3 &, const Vector3 &)
 	EXBIND2(body_apply_torque_impulse, RID, const Vector3 &)
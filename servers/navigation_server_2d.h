@@ -75,6 +75,10 @@ public:
 	/// Returns the map cell size.
 	virtual real_t map_get_cell_size(RID p_map) const = 0;
 
+	/// Set whether the avoidance agents search their neighbors with a spatial hash instead of a tree.
+	virtual void map_set_use_avoidance_spatial_hash(RID p_map, bool p_enabled) = 0;
+	virtual bool map_get_use_avoidance_spatial_hash(RID p_map) const = 0;
+
 	virtual void map_set_use_edge_connections(RID p_map, bool p_enabled) = 0;
 	virtual bool map_get_use_edge_connections(RID p_map) const = 0;
 
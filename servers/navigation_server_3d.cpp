@@ -50,6 +50,10 @@ void NavigationServer3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("map_get_cell_height", "map"), &NavigationServer3D::map_get_cell_height);
 	ClassDB::bind_method(D_METHOD("map_set_merge_rasterizer_cell_scale", "map", "scale"), &NavigationServer3D::map_set_merge_rasterizer_cell_scale);
 	ClassDB::bind_method(D_METHOD("map_get_merge_rasterizer_cell_scale", "map"), &NavigationServer3D::map_get_merge_rasterizer_cell_scale);
+	ClassDB::bind_method(D_METHOD("map_set_path_cluster_size", "map", "cluster_size"), &NavigationServer3D::map_set_path_cluster_size);
+	ClassDB::bind_method(D_METHOD("map_get_path_cluster_size", "map"), &NavigationServer3D::map_get_path_cluster_size);
+	ClassDB::bind_method(D_METHOD("map_set_use_avoidance_spatial_hash", "map", "enabled"), &NavigationServer3D::map_set_use_avoidance_spatial_hash);
+	ClassDB::bind_method(D_METHOD("map_get_use_avoidance_spatial_hash", "map"), &NavigationServer3D::map_get_use_avoidance_spatial_hash);
 	ClassDB::bind_method(D_METHOD("map_set_use_edge_connections", "map", "enabled"), &NavigationServer3D::map_set_use_edge_connections);
 	ClassDB::bind_method(D_METHOD("map_get_use_edge_connections", "map"), &NavigationServer3D::map_get_use_edge_connections);
 	ClassDB::bind_method(D_METHOD("map_set_edge_connection_margin", "map", "margin"), &NavigationServer3D::map_set_edge_connection_margin);
@@ -61,6 +65,7 @@ void NavigationServer3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("map_get_closest_point", "map", "to_point"), &NavigationServer3D::map_get_closest_point);
 	ClassDB::bind_method(D_METHOD("map_get_closest_point_normal", "map", "to_point"), &NavigationServer3D::map_get_closest_point_normal);
 	ClassDB::bind_method(D_METHOD("map_get_closest_point_owner", "map", "to_point"), &NavigationServer3D::map_get_closest_point_owner);
+	ClassDB::bind_method(D_METHOD("map_get_flow_field_next_position", "map", "target", "from", "navigation_layers"), &NavigationServer3D::map_get_flow_field_next_position, DEFVAL(1));
 
 	ClassDB::bind_method(D_METHOD("map_get_links", "map"), &NavigationServer3D::map_get_links);
 	ClassDB::bind_method(D_METHOD("map_get_regions", "map"), &NavigationServer3D::map_get_regions);
@@ -73,6 +78,7 @@ void NavigationServer3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("map_get_random_point", "map", "navigation_layers", "uniformly"), &NavigationServer3D::map_get_random_point);
 
 	ClassDB::bind_method(D_METHOD("query_path", "parameters", "result"), &NavigationServer3D::query_path);
+	ClassDB::bind_method(D_METHOD("query_path_async", "parameters", "result", "callback"), &NavigationServer3D::query_path_async);
 
 	ClassDB::bind_method(D_METHOD("region_create"), &NavigationServer3D::region_create);
 	ClassDB::bind_method(D_METHOD("region_set_enabled", "region", "enabled"), &NavigationServer3D::region_set_enabled);
@@ -218,6 +224,11 @@ void NavigationServer3D::_bind_methods() {
 	BIND_ENUM_CONSTANT(INFO_EDGE_CONNECTION_COUNT);
 	BIND_ENUM_CONSTANT(INFO_EDGE_FREE_COUNT);
 	BIND_ENUM_CONSTANT(INFO_OBSTACLE_COUNT);
+	BIND_ENUM_CONSTANT(INFO_POLYGON_SYNC_COUNT);
+	BIND_ENUM_CONSTANT(INFO_LINK_SYNC_COUNT);
+	BIND_ENUM_CONSTANT(INFO_PATH_QUERY_POLYGON_COUNT);
+	BIND_ENUM_CONSTANT(INFO_PATH_QUERY_CLUSTER_COUNT);
+	BIND_ENUM_CONSTANT(INFO_PATH_QUERY_RETRY_COUNT);
 }
 
 NavigationServer3D *NavigationServer3D::get_singleton() {
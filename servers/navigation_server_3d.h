@@ -87,6 +87,14 @@ public:
 	virtual void map_set_merge_rasterizer_cell_scale(RID p_map, float p_value) = 0;
 	virtual float map_get_merge_rasterizer_cell_scale(RID p_map) const = 0;
 
+	/// Set the number of polygons grouped in a cluster of the hierarchical path search.
+	virtual void map_set_path_cluster_size(RID p_map, int p_cluster_size) = 0;
+	virtual int map_get_path_cluster_size(RID p_map) const = 0;
+
+	/// Set whether the avoidance agents search their neighbors with a spatial hash instead of a tree.
+	virtual void map_set_use_avoidance_spatial_hash(RID p_map, bool p_enabled) = 0;
+	virtual bool map_get_use_avoidance_spatial_hash(RID p_map) const = 0;
+
 	virtual void map_set_use_edge_connections(RID p_map, bool p_enabled) = 0;
 	virtual bool map_get_use_edge_connections(RID p_map) const = 0;
 
@@ -109,6 +117,7 @@ public:
 	virtual Vector3 map_get_closest_point(RID p_map, const Vector3 &p_point) const = 0;
 	virtual Vector3 map_get_closest_point_normal(RID p_map, const Vector3 &p_point) const = 0;
 	virtual RID map_get_closest_point_owner(RID p_map, const Vector3 &p_point) const = 0;
+	virtual Vector3 map_get_flow_field_next_position(RID p_map, const Vector3 &p_target, const Vector3 &p_from, uint32_t p_navigation_layers = 1) const = 0;
 
 	virtual TypedArray<RID> map_get_links(RID p_map) const = 0;
 	virtual TypedArray<RID> map_get_regions(RID p_map) const = 0;
@@ -342,6 +351,9 @@ public:
 	/// Returns a customized navigation path using a query parameters object
 	virtual void query_path(const Ref<NavigationPathQueryParameters3D> &p_query_parameters, Ref<NavigationPathQueryResult3D> p_query_result) const;
 
+	/// Queues a path query that is resolved with all other queued queries on the next process step.
+	virtual void query_path_async(const Ref<NavigationPathQueryParameters3D> &p_query_parameters, const Ref<NavigationPathQueryResult3D> &p_query_result, const Callable &p_callback) = 0;
+
 	virtual NavigationUtilities::PathQueryResult _query_path(const NavigationUtilities::PathQueryParameters &p_parameters) const = 0;
 
 #ifndef _3D_DISABLED
@@ -370,6 +382,11 @@ public:
 		INFO_EDGE_CONNECTION_COUNT,
 		INFO_EDGE_FREE_COUNT,
 		INFO_OBSTACLE_COUNT,
+		INFO_POLYGON_SYNC_COUNT,
+		INFO_LINK_SYNC_COUNT,
+		INFO_PATH_QUERY_POLYGON_COUNT,
+		INFO_PATH_QUERY_CLUSTER_COUNT,
+		INFO_PATH_QUERY_RETRY_COUNT,
 	};
 
 	virtual int get_process_info(ProcessInfo p_info) const = 0;
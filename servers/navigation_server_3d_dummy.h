@@ -49,6 +49,10 @@ public:
 	real_t map_get_cell_height(RID p_map) const override { return 0; }
 	void map_set_merge_rasterizer_cell_scale(RID p_map, float p_value) override {}
 	float map_get_merge_rasterizer_cell_scale(RID p_map) const override { return 1.0; }
+	void map_set_path_cluster_size(RID p_map, int p_cluster_size) override {}
+	int map_get_path_cluster_size(RID p_map) const override { return 0; }
+	void map_set_use_avoidance_spatial_hash(RID p_map, bool p_enabled) override {}
+	bool map_get_use_avoidance_spatial_hash(RID p_map) const override { return false; }
 	void map_set_use_edge_connections(RID p_map, bool p_enabled) override {}
 	bool map_get_use_edge_connections(RID p_map) const override { return false; }
 	void map_set_edge_connection_margin(RID p_map, real_t p_connection_margin) override {}
@@ -60,6 +64,7 @@ public:
 	Vector3 map_get_closest_point(RID p_map, const Vector3 &p_point) const override { return Vector3(); }
 	Vector3 map_get_closest_point_normal(RID p_map, const Vector3 &p_point) const override { return Vector3(); }
 	RID map_get_closest_point_owner(RID p_map, const Vector3 &p_point) const override { return RID(); }
+	Vector3 map_get_flow_field_next_position(RID p_map, const Vector3 &p_target, const Vector3 &p_from, uint32_t p_navigation_layers = 1) const override { return Vector3(); }
 	Vector3 map_get_random_point(RID p_map, uint32_t p_navigation_layers, bool p_uniformly) const override { return Vector3(); }
 	TypedArray<RID> map_get_links(RID p_map) const override { return TypedArray<RID>(); }
 	TypedArray<RID> map_get_regions(RID p_map) const override { return TypedArray<RID>(); }
@@ -194,6 +199,7 @@ public:
 	void sync() override {}
 	void finish() override {}
 
+	void query_path_async(const Ref<NavigationPathQueryParameters3D> &p_query_parameters, const Ref<NavigationPathQueryResult3D> &p_query_result, const Callable &p_callback) override {}
 	NavigationUtilities::PathQueryResult _query_path(const NavigationUtilities::PathQueryParameters &p_parameters) const override { return NavigationUtilities::PathQueryResult(); }
 	int get_process_info(ProcessInfo p_info) const override { return 0; }
 
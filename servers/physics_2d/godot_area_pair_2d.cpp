@@ -31,6 +31,39 @@
 #include "godot_area_pair_2d.h"
 #include "godot_collision_solver_2d.h"
 
+bool GodotAreaPair2D::_has_space_override() const {
+	if ((int)area->get_param(PhysicsServer2D::AREA_PARAM_GRAVITY_OVERRIDE_MODE) != PhysicsServer2D::AREA_SPACE_OVERRIDE_DISABLED) {
+		return true;
+	} else if ((int)area->get_param(PhysicsServer2D::AREA_PARAM_LINEAR_DAMP_OVERRIDE_MODE) != PhysicsServer2D::AREA_SPACE_OVERRIDE_DISABLED) {
+		return true;
+	} else if ((int)area->get_param(PhysicsServer2D::AREA_PARAM_ANGULAR_DAMP_OVERRIDE_MODE) != PhysicsServer2D::AREA_SPACE_OVERRIDE_DISABLED) {
+		return true;
+	}
+	return false;
+}
+
+void GodotAreaPair2D::_apply_collision() {
+	if (colliding) {
+		if (has_space_override) {
+			body_has_attached_area = true;
+			body->add_area(area);
+		}
+
+		if (area->has_monitor_callback()) {
+			area->add_body_to_query(body, body_shape, area_shape);
+		}
+	} else {
+		if (has_space_override) {
+			body_has_attached_area = false;
+			body->remove_area(area);
+		}
+
+		if (area->has_monitor_callback()) {
+			area->remove_body_from_query(body, body_shape, area_shape);
+		}
+	}
+}
+
 bool GodotAreaPair2D::setup(real_t p_step) {
 	bool result = false;
 	if (area->collides_with(body) && GodotCollisionSolver2D::solve(body->get_shape(body_shape), body->get_transform() * body->get_shape_transform(body_shape), Vector2(), area->get_shape(area_shape), area->get_transform() * area->get_shape_transform(area_shape), Vector2(), nullptr, this)) {
@@ -40,13 +73,7 @@ bool GodotAreaPair2D::setup(real_t p_step) {
 	process_collision = false;
 	has_space_override = false;
 	if (result != colliding) {
-		if ((int)area->get_param(PhysicsServer2D::AREA_PARAM_GRAVITY_OVERRIDE_MODE) != PhysicsServer2D::AREA_SPACE_OVERRIDE_DISABLED) {
-			has_space_override = true;
-		} else if ((int)area->get_param(PhysicsServer2D::AREA_PARAM_LINEAR_DAMP_OVERRIDE_MODE) != PhysicsServer2D::AREA_SPACE_OVERRIDE_DISABLED) {
-			has_space_override = true;
-		} else if ((int)area->get_param(PhysicsServer2D::AREA_PARAM_ANGULAR_DAMP_OVERRIDE_MODE) != PhysicsServer2D::AREA_SPACE_OVERRIDE_DISABLED) {
-			has_space_override = true;
-		}
+		has_space_override = _has_space_override();
 		process_collision = has_space_override;
 
 		if (area->has_monitor_callback()) {
@@ -64,25 +91,7 @@ bool GodotAreaPair2D::pre_solve(real_t p_step) {
 		return false;
 	}
 
-	if (colliding) {
-		if (has_space_override) {
-			body_has_attached_area = true;
-			body->add_area(area);
-		}
-
-		if (area->has_monitor_callback()) {
-			area->add_body_to_query(body, body_shape, area_shape);
-		}
-	} else {
-		if (has_space_override) {
-			body_has_attached_area = false;
-			body->remove_area(area);
-		}
-
-		if (area->has_monitor_callback()) {
-			area->remove_body_from_query(body, body_shape, area_shape);
-		}
-	}
+	_apply_collision();
 
 	return false; // Never do any post solving.
 }
@@ -91,6 +100,28 @@ void GodotAreaPair2D::solve(real_t p_step) {
 	// Nothing to do.
 }
 
+uint64_t GodotAreaPair2D::get_order_key() const {
+	return ((uint64_t)hash_murmur3_one_64(area->get_self().get_id(), area_shape) << 32) | hash_murmur3_one_64(body->get_self().get_id(), body_shape);
+}
+
+void GodotAreaPair2D::save_snapshot(Snapshot &r_snapshot) const {
+	r_snapshot.id_A = body->get_self().get_id();
+	r_snapshot.id_B = area->get_self().get_id();
+	r_snapshot.shape_A = body_shape;
+	r_snapshot.shape_B = area_shape;
+	r_snapshot.colliding = colliding;
+}
+
+void GodotAreaPair2D::load_snapshot(bool p_colliding) {
+	process_collision = false;
+	if (p_colliding == colliding) {
+		return;
+	}
+	colliding = p_colliding;
+	has_space_override = _has_space_override();
+	_apply_collision();
+}
+
 GodotAreaPair2D::GodotAreaPair2D(GodotBody2D *p_body, int p_body_shape, GodotArea2D *p_area, int p_area_shape) {
 	body = p_body;
 	area = p_area;
@@ -174,6 +205,47 @@ void GodotArea2Pair2D::solve(real_t p_step) {
 	// Nothing to do.
 }
 
+uint64_t GodotArea2Pair2D::get_order_key() const {
+	return ((uint64_t)hash_murmur3_one_64(area_a->get_self().get_id(), shape_a) << 32) | hash_murmur3_one_64(area_b->get_self().get_id(), shape_b);
+}
+
+void GodotArea2Pair2D::save_snapshot(Snapshot &r_snapshot) const {
+	r_snapshot.id_A = area_a->get_self().get_id();
+	r_snapshot.id_B = area_b->get_self().get_id();
+	r_snapshot.shape_A = shape_a;
+	r_snapshot.shape_B = shape_b;
+	r_snapshot.colliding = (colliding_a ? COLLIDING_A : 0) | (colliding_b ? COLLIDING_B : 0);
+}
+
+void GodotArea2Pair2D::load_snapshot(uint32_t p_colliding) {
+	process_collision_a = false;
+	process_collision_b = false;
+
+	bool result_a = p_colliding & COLLIDING_A;
+	if (result_a != colliding_a) {
+		if (area_a->has_area_monitor_callback() && area_b_monitorable) {
+			if (result_a) {
+				area_a->add_area_to_query(area_b, shape_b, shape_a);
+			} else {
+				area_a->remove_area_from_query(area_b, shape_b, shape_a);
+			}
+		}
+		colliding_a = result_a;
+	}
+
+	bool result_b = p_colliding & COLLIDING_B;
+	if (result_b != colliding_b) {
+		if (area_b->has_area_monitor_callback() && area_a_monitorable) {
+			if (result_b) {
+				area_b->add_area_to_query(area_a, shape_a, shape_b);
+			} else {
+				area_b->remove_area_from_query(area_a, shape_a, shape_b);
+			}
+		}
+		colliding_b = result_b;
+	}
+}
+
 GodotArea2Pair2D::GodotArea2Pair2D(GodotArea2D *p_area_a, int p_shape_a, GodotArea2D *p_area_b, int p_shape_b) {
 	area_a = p_area_a;
 	area_b = p_area_b;
@@ -45,11 +45,30 @@ class GodotAreaPair2D : public GodotConstraint2D {
 	bool process_collision = false;
 	bool body_has_attached_area = false;
 
+	bool _has_space_override() const;
+	void _apply_collision();
+
 public:
+	// Overlap state, copied as a flat record by space snapshots. A is the body, B the area.
+	struct Snapshot {
+		uint64_t id_A = 0;
+		uint64_t id_B = 0;
+		int32_t shape_A = 0;
+		int32_t shape_B = 0;
+		uint32_t colliding = 0;
+	};
+
 	virtual bool setup(real_t p_step) override;
 	virtual bool pre_solve(real_t p_step) override;
 	virtual void solve(real_t p_step) override;
 
+	virtual uint64_t get_order_key() const override;
+	virtual bool is_area_pair() const override { return true; }
+
+	void save_snapshot(Snapshot &r_snapshot) const;
+	// Applies the enter or exit change right away instead of in the next pre-solve.
+	void load_snapshot(bool p_colliding);
+
 	GodotAreaPair2D(GodotBody2D *p_body, int p_body_shape, GodotArea2D *p_area, int p_area_shape);
 	~GodotAreaPair2D();
 };
@@ -67,10 +86,32 @@ class GodotArea2Pair2D : public GodotConstraint2D {
 	bool area_b_monitorable;
 
 public:
+	enum {
+		COLLIDING_A = 1,
+		COLLIDING_B = 2,
+	};
+
+	// Overlap state, copied as a flat record by space snapshots. Colliding combines COLLIDING_A and COLLIDING_B.
+	struct Snapshot {
+		uint64_t id_A = 0;
+		uint64_t id_B = 0;
+		int32_t shape_A = 0;
+		int32_t shape_B = 0;
+		uint32_t colliding = 0;
+	};
+
 	virtual bool setup(real_t p_step) override;
 	virtual bool pre_solve(real_t p_step) override;
 	virtual void solve(real_t p_step) override;
 
+	virtual uint64_t get_order_key() const override;
+
+	_FORCE_INLINE_ GodotArea2D *get_area_a() const { return area_a; }
+
+	void save_snapshot(Snapshot &r_snapshot) const;
+	// Applies the enter and exit changes right away instead of in the next pre-solve.
+	void load_snapshot(uint32_t p_colliding);
+
 	GodotArea2Pair2D(GodotArea2D *p_area_a, int p_shape_a, GodotArea2D *p_area_b, int p_shape_b);
 	~GodotArea2Pair2D();
 };
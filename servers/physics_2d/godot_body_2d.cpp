@@ -248,10 +248,38 @@ Variant GodotBody2D::get_param(PhysicsServer2D::BodyParameter p_param) const {
 	return 0;
 }
 
+void GodotBody2D::add_constraint(GodotConstraint2D *p_constraint, int p_pos) {
+	constraint_list.push_back({ p_constraint, p_pos });
+	if (get_space()) {
+		get_space()->island_add_constraint(p_constraint, island);
+	}
+}
+
+void GodotBody2D::remove_constraint(GodotConstraint2D *p_constraint, int p_pos) {
+	constraint_list.erase({ p_constraint, p_pos });
+	GodotSpace2D::island_remove_constraint(p_constraint);
+}
+
+void GodotBody2D::clear_constraint_list() {
+	for (const Pair<GodotConstraint2D *, int> &E : constraint_list) {
+		GodotSpace2D::island_remove_constraint(E.first);
+	}
+	constraint_list.clear();
+}
+
 void GodotBody2D::set_mode(PhysicsServer2D::BodyMode p_mode) {
 	PhysicsServer2D::BodyMode prev = mode;
 	mode = p_mode;
 
+	if (get_space()) {
+		// Static bodies don't connect islands.
+		if (p_mode == PhysicsServer2D::BODY_MODE_STATIC) {
+			get_space()->island_remove_body(this);
+		} else {
+			get_space()->island_add_body(this);
+		}
+	}
+
 	switch (p_mode) {
 		//CLEAR UP EVERYTHING IN CASE IT NOT WORKS!
 		case PhysicsServer2D::BODY_MODE_STATIC:
@@ -388,6 +416,45 @@ Variant GodotBody2D::get_state(PhysicsServer2D::BodyState p_state) const {
 	return Variant();
 }
 
+void GodotBody2D::save_snapshot(Snapshot &r_snapshot) const {
+	r_snapshot.id = get_self().get_id();
+	r_snapshot.transform = get_transform();
+	r_snapshot.inv_transform = get_inv_transform();
+	r_snapshot.new_transform = new_transform;
+	r_snapshot.linear_velocity = linear_velocity;
+	r_snapshot.prev_linear_velocity = prev_linear_velocity;
+	r_snapshot.applied_force = applied_force;
+	r_snapshot.constant_force = constant_force;
+	r_snapshot.angular_velocity = angular_velocity;
+	r_snapshot.prev_angular_velocity = prev_angular_velocity;
+	r_snapshot.applied_torque = applied_torque;
+	r_snapshot.constant_torque = constant_torque;
+	r_snapshot.still_time = still_time;
+	r_snapshot.active = active;
+	r_snapshot.first_time_kinematic = first_time_kinematic;
+}
+
+void GodotBody2D::load_snapshot(const Snapshot &p_snapshot) {
+	// The inverse transform is restored as saved instead of being recomputed, so following steps match bit for bit.
+	_set_transform(p_snapshot.transform);
+	_set_inv_transform(p_snapshot.inv_transform);
+	_update_transform_dependent();
+
+	new_transform = p_snapshot.new_transform;
+	linear_velocity = p_snapshot.linear_velocity;
+	prev_linear_velocity = p_snapshot.prev_linear_velocity;
+	applied_force = p_snapshot.applied_force;
+	constant_force = p_snapshot.constant_force;
+	angular_velocity = p_snapshot.angular_velocity;
+	prev_angular_velocity = p_snapshot.prev_angular_velocity;
+	applied_torque = p_snapshot.applied_torque;
+	constant_torque = p_snapshot.constant_torque;
+	still_time = p_snapshot.still_time;
+	first_time_kinematic = p_snapshot.first_time_kinematic;
+
+	set_active(p_snapshot.active);
+}
+
 void GodotBody2D::set_space(GodotSpace2D *p_space) {
 	if (get_space()) {
 		wakeup_neighbours();
@@ -401,11 +468,13 @@ void GodotBody2D::set_space(GodotSpace2D *p_space) {
 		if (direct_state_query_list.in_list()) {
 			get_space()->body_remove_from_state_query_list(&direct_state_query_list);
 		}
+		get_space()->island_remove_body(this);
 	}
 
 	_set_space(p_space);
 
 	if (get_space()) {
+		get_space()->island_add_body(this);
 		_mass_properties_changed();
 
 		if (active && !active_list.in_list()) {
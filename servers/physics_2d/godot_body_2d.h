@@ -39,6 +39,7 @@
 #include "core/templates/vset.h"
 
 class GodotConstraint2D;
+struct GodotIsland2D;
 class GodotPhysicsDirectBodyState2D;
 
 class GodotBody2D : public GodotCollisionObject2D {
@@ -150,7 +151,7 @@ class GodotBody2D : public GodotCollisionObject2D {
 
 	GodotPhysicsDirectBodyState2D *direct_state = nullptr;
 
-	uint64_t island_step = 0;
+	GodotIsland2D *island = nullptr;
 
 	void _update_transform_dependent();
 
@@ -199,13 +200,13 @@ public:
 	_FORCE_INLINE_ bool has_exception(const RID &p_exception) const { return exceptions.has(p_exception); }
 	_FORCE_INLINE_ const VSet<RID> &get_exceptions() const { return exceptions; }
 
-	_FORCE_INLINE_ uint64_t get_island_step() const { return island_step; }
-	_FORCE_INLINE_ void set_island_step(uint64_t p_step) { island_step = p_step; }
+	_FORCE_INLINE_ GodotIsland2D *get_island() const { return island; }
+	_FORCE_INLINE_ void set_island(GodotIsland2D *p_island) { island = p_island; }
 
-	_FORCE_INLINE_ void add_constraint(GodotConstraint2D *p_constraint, int p_pos) { constraint_list.push_back({ p_constraint, p_pos }); }
-	_FORCE_INLINE_ void remove_constraint(GodotConstraint2D *p_constraint, int p_pos) { constraint_list.erase({ p_constraint, p_pos }); }
+	void add_constraint(GodotConstraint2D *p_constraint, int p_pos);
+	void remove_constraint(GodotConstraint2D *p_constraint, int p_pos);
 	const List<Pair<GodotConstraint2D *, int>> &get_constraint_list() const { return constraint_list; }
-	_FORCE_INLINE_ void clear_constraint_list() { constraint_list.clear(); }
+	void clear_constraint_list();
 
 	_FORCE_INLINE_ void set_omit_force_integration(bool p_omit_force_integration) { omit_force_integration = p_omit_force_integration; }
 	_FORCE_INLINE_ bool get_omit_force_integration() const { return omit_force_integration; }
@@ -300,6 +301,28 @@ public:
 	void set_state(PhysicsServer2D::BodyState p_state, const Variant &p_variant);
 	Variant get_state(PhysicsServer2D::BodyState p_state) const;
 
+	// Dynamic state carried between steps, copied as a flat record by space snapshots.
+	struct Snapshot {
+		uint64_t id = 0;
+		Transform2D transform;
+		Transform2D inv_transform;
+		Transform2D new_transform;
+		Vector2 linear_velocity;
+		Vector2 prev_linear_velocity;
+		Vector2 applied_force;
+		Vector2 constant_force;
+		real_t angular_velocity = 0.0;
+		real_t prev_angular_velocity = 0.0;
+		real_t applied_torque = 0.0;
+		real_t constant_torque = 0.0;
+		real_t still_time = 0.0;
+		bool active = false;
+		bool first_time_kinematic = false;
+	};
+
+	void save_snapshot(Snapshot &r_snapshot) const;
+	void load_snapshot(const Snapshot &p_snapshot);
+
 	_FORCE_INLINE_ void set_continuous_collision_detection_mode(PhysicsServer2D::CCDMode p_mode) { continuous_cd_mode = p_mode; }
 	_FORCE_INLINE_ PhysicsServer2D::CCDMode get_continuous_collision_detection_mode() const { return continuous_cd_mode; }
 
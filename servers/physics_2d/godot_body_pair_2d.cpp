@@ -591,6 +591,37 @@ void GodotBodyPair2D::solve(real_t p_step) {
 	}
 }
 
+void GodotBodyPair2D::save_snapshot(Snapshot &r_snapshot) const {
+	r_snapshot.id_A = A->get_self().get_id();
+	r_snapshot.id_B = B->get_self().get_id();
+	r_snapshot.shape_A = shape_A;
+	r_snapshot.shape_B = shape_B;
+	r_snapshot.contact_count = contact_count;
+	r_snapshot.sep_axis = sep_axis;
+	r_snapshot.collided = collided;
+	r_snapshot.oneway_disabled = oneway_disabled;
+	for (int i = 0; i < contact_count; i++) {
+		r_snapshot.contacts[i] = contacts[i];
+	}
+}
+
+void GodotBodyPair2D::load_snapshot(const Snapshot &p_snapshot) {
+	contact_count = CLAMP(p_snapshot.contact_count, 0, (int)MAX_CONTACTS);
+	sep_axis = p_snapshot.sep_axis;
+	collided = p_snapshot.collided;
+	oneway_disabled = p_snapshot.oneway_disabled;
+	for (int i = 0; i < contact_count; i++) {
+		contacts[i] = p_snapshot.contacts[i];
+	}
+}
+
+void GodotBodyPair2D::reset_contacts() {
+	contact_count = 0;
+	sep_axis = Vector2();
+	collided = false;
+	oneway_disabled = false;
+}
+
 GodotBodyPair2D::GodotBodyPair2D(GodotBody2D *p_A, int p_shape_A, GodotBody2D *p_B, int p_shape_B) :
 		GodotConstraint2D(_arr, 2) {
 	A = p_A;
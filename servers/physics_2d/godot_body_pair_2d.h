@@ -90,10 +90,35 @@ class GodotBodyPair2D : public GodotConstraint2D {
 	_FORCE_INLINE_ void _contact_added_callback(const Vector2 &p_point_A, const Vector2 &p_point_B);
 
 public:
+	// Contact state kept between steps, copied as a flat record by space snapshots.
+	struct Snapshot {
+		uint64_t id_A = 0;
+		uint64_t id_B = 0;
+		int32_t shape_A = 0;
+		int32_t shape_B = 0;
+		int32_t contact_count = 0;
+		Vector2 sep_axis;
+		bool collided = false;
+		bool oneway_disabled = false;
+		Contact contacts[MAX_CONTACTS];
+	};
+
+	_FORCE_INLINE_ GodotBody2D *get_body_A() const { return A; }
+	_FORCE_INLINE_ GodotBody2D *get_body_B() const { return B; }
+	_FORCE_INLINE_ int get_shape_A() const { return shape_A; }
+	_FORCE_INLINE_ int get_shape_B() const { return shape_B; }
+
+	void save_snapshot(Snapshot &r_snapshot) const;
+	void load_snapshot(const Snapshot &p_snapshot);
+	void reset_contacts();
+
 	virtual bool setup(real_t p_step) override;
 	virtual bool pre_solve(real_t p_step) override;
 	virtual void solve(real_t p_step) override;
 
+	virtual uint64_t get_order_key() const override { return ((uint64_t)shape_A << 32) | (uint32_t)shape_B; }
+	virtual bool is_body_pair() const override { return true; }
+
 	GodotBodyPair2D(GodotBody2D *p_A, int p_shape_A, GodotBody2D *p_B, int p_shape_B);
 	~GodotBodyPair2D();
 };
@@ -63,6 +63,9 @@ public:
 	virtual void set_pair_callback(PairCallback p_pair_callback, void *p_userdata) = 0;
 	virtual void set_unpair_callback(UnpairCallback p_unpair_callback, void *p_userdata) = 0;
 
+	// Margin added around AABBs when pairing, so small motions don't unpair and pair the same objects again.
+	virtual void set_pairing_expansion(real_t p_expansion) = 0;
+
 	virtual void update() = 0;
 
 	virtual ~GodotBroadPhase2D();
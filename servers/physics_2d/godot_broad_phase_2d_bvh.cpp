@@ -109,6 +109,10 @@ void GodotBroadPhase2DBVH::set_unpair_callback(UnpairCallback p_unpair_callback,
 	unpair_userdata = p_userdata;
 }
 
+void GodotBroadPhase2DBVH::set_pairing_expansion(real_t p_expansion) {
+	bvh.params_set_pairing_expansion(p_expansion);
+}
+
 void GodotBroadPhase2DBVH::update() {
 	bvh.update();
 }
@@ -92,6 +92,8 @@ public:
 	virtual void set_pair_callback(PairCallback p_pair_callback, void *p_userdata) override;
 	virtual void set_unpair_callback(UnpairCallback p_unpair_callback, void *p_userdata) override;
 
+	virtual void set_pairing_expansion(real_t p_expansion) override;
+
 	virtual void update() override;
 
 	static GodotBroadPhase2D *_create();
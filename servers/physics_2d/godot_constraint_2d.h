@@ -33,10 +33,14 @@
 
 #include "godot_body_2d.h"
 
+struct GodotIsland2D;
+
 class GodotConstraint2D {
 	GodotBody2D **_body_ptr;
 	int _body_count;
 	uint64_t island_step = 0;
+	GodotIsland2D *island = nullptr;
+	uint32_t island_index = 0;
 	bool disabled_collisions_between_bodies = true;
 
 	RID self;
@@ -54,6 +58,13 @@ public:
 	_FORCE_INLINE_ uint64_t get_island_step() const { return island_step; }
 	_FORCE_INLINE_ void set_island_step(uint64_t p_step) { island_step = p_step; }
 
+	_FORCE_INLINE_ GodotIsland2D *get_island() const { return island; }
+	_FORCE_INLINE_ uint32_t get_island_index() const { return island_index; }
+	_FORCE_INLINE_ void set_island(GodotIsland2D *p_island, uint32_t p_index) {
+		island = p_island;
+		island_index = p_index;
+	}
+
 	_FORCE_INLINE_ GodotBody2D **get_body_ptr() const { return _body_ptr; }
 	_FORCE_INLINE_ int get_body_count() const { return _body_count; }
 
@@ -64,6 +75,12 @@ public:
 	virtual bool pre_solve(real_t p_step) = 0;
 	virtual void solve(real_t p_step) = 0;
 
+	// Sorts constraints between the same bodies when islands are solved deterministically.
+	virtual uint64_t get_order_key() const { return self.get_id(); }
+	virtual bool is_body_pair() const { return false; }
+	virtual bool is_area_pair() const { return false; }
+	virtual bool is_joint() const { return false; }
+
 	virtual ~GodotConstraint2D() {}
 };
 
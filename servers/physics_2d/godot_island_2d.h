@@ -0,0 +1,77 @@
+/**************************************************************************/
+/*  godot_island_2d.h                                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GODOT_ISLAND_2D_H
+#define GODOT_ISLAND_2D_H
+
+#include "godot_body_2d.h"
+#include "godot_constraint_2d.h"
+
+#include "core/templates/local_vector.h"
+
+class GodotSpace2D;
+
+// Bodies connected by constraints, kept by the space across steps. Adding a constraint merges the islands
+// of its bodies, removing one only marks its island dirty so GodotStep2D floods it again before solving.
+// Static bodies and bodies from other spaces don't connect islands, kinematic ones do.
+struct GodotIsland2D {
+	LocalVector<GodotBody2D *> bodies;
+	LocalVector<GodotConstraint2D *> constraints;
+
+	GodotSpace2D *space = nullptr;
+	// Last step the island had an active body.
+	uint64_t step = 0;
+	bool dirty = false;
+	// Constraints are in deterministic order.
+	bool sorted = false;
+
+	_FORCE_INLINE_ void add_body(GodotBody2D *p_body) {
+		p_body->set_island(this);
+		bodies.push_back(p_body);
+	}
+
+	_FORCE_INLINE_ void add_constraint(GodotConstraint2D *p_constraint) {
+		p_constraint->set_island(this, constraints.size());
+		constraints.push_back(p_constraint);
+		sorted = false;
+	}
+
+	_FORCE_INLINE_ void remove_constraint(GodotConstraint2D *p_constraint) {
+		uint32_t index = p_constraint->get_island_index();
+		constraints.remove_at_unordered(index);
+		if (index < constraints.size()) {
+			constraints[index]->set_island(this, index);
+		}
+		p_constraint->set_island(nullptr, 0);
+		sorted = false;
+	}
+};
+
+#endif // GODOT_ISLAND_2D_H
@@ -256,6 +256,19 @@ void GodotPinJoint2D::solve(real_t p_step) {
 	P += impulse;
 }
 
+void GodotPinJoint2D::save_snapshot(Snapshot &r_snapshot) const {
+	GodotJoint2D::save_snapshot(r_snapshot);
+	r_snapshot.impulses[0] = P.x;
+	r_snapshot.impulses[1] = P.y;
+	r_snapshot.impulses[2] = j_acc;
+}
+
+void GodotPinJoint2D::load_snapshot(const Snapshot &p_snapshot) {
+	P.x = p_snapshot.impulses[0];
+	P.y = p_snapshot.impulses[1];
+	j_acc = p_snapshot.impulses[2];
+}
+
 void GodotPinJoint2D::set_param(PhysicsServer2D::PinJointParam p_param, real_t p_value) {
 	switch (p_param) {
 		case PhysicsServer2D::PIN_JOINT_SOFTNESS: {
@@ -470,6 +483,17 @@ void GodotGrooveJoint2D::solve(real_t p_step) {
 	}
 }
 
+void GodotGrooveJoint2D::save_snapshot(Snapshot &r_snapshot) const {
+	GodotJoint2D::save_snapshot(r_snapshot);
+	r_snapshot.impulses[0] = jn_acc.x;
+	r_snapshot.impulses[1] = jn_acc.y;
+}
+
+void GodotGrooveJoint2D::load_snapshot(const Snapshot &p_snapshot) {
+	jn_acc.x = p_snapshot.impulses[0];
+	jn_acc.y = p_snapshot.impulses[1];
+}
+
 GodotGrooveJoint2D::GodotGrooveJoint2D(const Vector2 &p_a_groove1, const Vector2 &p_a_groove2, const Vector2 &p_b_anchor, GodotBody2D *p_body_a, GodotBody2D *p_body_b) :
 		GodotJoint2D(_arr, 2) {
 	A = p_body_a;
@@ -44,6 +44,16 @@ protected:
 	bool dynamic_B = false;
 
 public:
+	enum {
+		MAX_SNAPSHOT_IMPULSES = 3,
+	};
+
+	// Impulses accumulated by the solver, copied as a flat record by space snapshots.
+	struct Snapshot {
+		uint64_t id = 0;
+		real_t impulses[MAX_SNAPSHOT_IMPULSES] = {};
+	};
+
 	_FORCE_INLINE_ void set_max_force(real_t p_force) { max_force = p_force; }
 	_FORCE_INLINE_ real_t get_max_force() const { return max_force; }
 
@@ -60,6 +70,11 @@ public:
 	void copy_settings_from(GodotJoint2D *p_joint);
 
 	virtual PhysicsServer2D::JointType get_type() const { return PhysicsServer2D::JOINT_TYPE_MAX; }
+	virtual bool is_joint() const override { return true; }
+
+	virtual void save_snapshot(Snapshot &r_snapshot) const { r_snapshot.id = get_self().get_id(); }
+	virtual void load_snapshot(const Snapshot &p_snapshot) {}
+
 	GodotJoint2D(GodotBody2D **p_body_ptr = nullptr, int p_body_count = 0) :
 			GodotConstraint2D(p_body_ptr, p_body_count) {}
 
@@ -109,6 +124,9 @@ public:
 	virtual bool pre_solve(real_t p_step) override;
 	virtual void solve(real_t p_step) override;
 
+	virtual void save_snapshot(Snapshot &r_snapshot) const override;
+	virtual void load_snapshot(const Snapshot &p_snapshot) override;
+
 	void set_param(PhysicsServer2D::PinJointParam p_param, real_t p_value);
 	real_t get_param(PhysicsServer2D::PinJointParam p_param) const;
 
@@ -149,6 +167,9 @@ public:
 	virtual bool pre_solve(real_t p_step) override;
 	virtual void solve(real_t p_step) override;
 
+	virtual void save_snapshot(Snapshot &r_snapshot) const override;
+	virtual void load_snapshot(const Snapshot &p_snapshot) override;
+
 	GodotGrooveJoint2D(const Vector2 &p_a_groove1, const Vector2 &p_a_groove2, const Vector2 &p_b_anchor, GodotBody2D *p_body_a, GodotBody2D *p_body_b);
 };
 
@@ -31,6 +31,7 @@
 #include "godot_space_2d.h"
 
 #include "godot_collision_solver_2d.h"
+#include "godot_joints_2d.h"
 #include "godot_physics_server_2d.h"
 
 #include "core/os/os.h"
@@ -1034,7 +1035,20 @@ void *GodotSpace2D::_broadphase_pair(GodotCollisionObject2D *A, int p_subindex_A
 		}
 
 	} else {
+		if (self->deterministic && A->get_self().get_id() > B->get_self().get_id()) {
+			// Contacts are generated from A's side, don't let the pairing order decide which body it is.
+			SWAP(A, B);
+			SWAP(p_subindex_A, p_subindex_B);
+		}
+
 		GodotBodyPair2D *b = memnew(GodotBodyPair2D(static_cast<GodotBody2D *>(A), p_subindex_A, static_cast<GodotBody2D *>(B), p_subindex_B));
+
+		if (!self->pending_pair_snapshots.is_empty()) {
+			const GodotBodyPair2D::Snapshot *snapshot = self->_find_pending_pair_snapshot(b);
+			if (snapshot) {
+				b->load_snapshot(*snapshot);
+			}
+		}
 		return b;
 	}
 }
@@ -1116,6 +1130,126 @@ const SelfList<GodotArea2D>::List &GodotSpace2D::get_moved_area_list() const {
 	return area_moved_list;
 }
 
+void GodotSpace2D::_island_mark_dirty(GodotIsland2D *p_island) {
+	if (!p_island->dirty) {
+		p_island->dirty = true;
+		dirty_islands.push_back(p_island);
+	}
+}
+
+void GodotSpace2D::_island_free(GodotIsland2D *p_island) {
+	if (p_island->dirty) {
+		dirty_islands.erase(p_island);
+	}
+	for (GodotConstraint2D *constraint : p_island->constraints) {
+		constraint->set_island(nullptr, 0);
+	}
+	island_allocator.free(p_island);
+}
+
+GodotIsland2D *GodotSpace2D::_island_merge(GodotIsland2D *p_island_a, GodotIsland2D *p_island_b) {
+	if (p_island_a == p_island_b) {
+		return p_island_a;
+	}
+
+	// Union by size, only the members of the smaller island are moved.
+	if (p_island_a->bodies.size() + p_island_a->constraints.size() < p_island_b->bodies.size() + p_island_b->constraints.size()) {
+		SWAP(p_island_a, p_island_b);
+	}
+
+	for (GodotBody2D *body : p_island_b->bodies) {
+		p_island_a->add_body(body);
+	}
+	for (GodotConstraint2D *constraint : p_island_b->constraints) {
+		p_island_a->add_constraint(constraint);
+	}
+	p_island_b->constraints.clear();
+
+	if (p_island_b->dirty) {
+		_island_mark_dirty(p_island_a);
+	}
+	_island_free(p_island_b);
+
+	return p_island_a;
+}
+
+GodotIsland2D *GodotSpace2D::island_create() {
+	GodotIsland2D *island = island_allocator.alloc();
+	island->space = this;
+	return island;
+}
+
+void GodotSpace2D::island_add_body(GodotBody2D *p_body) {
+	if (p_body->get_island() || p_body->get_mode() == PhysicsServer2D::BODY_MODE_STATIC) {
+		return; // Static bodies don't connect islands.
+	}
+
+	island_create()->add_body(p_body);
+	for (const Pair<GodotConstraint2D *, int> &E : p_body->get_constraint_list()) {
+		island_add_constraint(E.first, p_body->get_island());
+	}
+}
+
+void GodotSpace2D::island_remove_body(GodotBody2D *p_body) {
+	GodotIsland2D *island = p_body->get_island();
+	if (!island) {
+		return;
+	}
+
+	for (const Pair<GodotConstraint2D *, int> &E : p_body->get_constraint_list()) {
+		island_remove_constraint(E.first);
+	}
+	island->bodies.erase(p_body);
+	p_body->set_island(nullptr);
+
+	if (island->bodies.is_empty()) {
+		_island_free(island);
+	} else {
+		// The remaining bodies may not be connected anymore.
+		_island_mark_dirty(island);
+	}
+}
+
+void GodotSpace2D::island_add_constraint(GodotConstraint2D *p_constraint, GodotIsland2D *p_island) {
+	// Called by every body the constraint connects with the island of that body,
+	// which is null for static bodies as they don't connect islands.
+	GodotIsland2D *island = p_constraint->get_island();
+	if (!p_island || (island && island->space != this)) {
+		return;
+	}
+
+	if (island) {
+		_island_merge(island, p_island);
+	} else {
+		p_island->add_constraint(p_constraint);
+	}
+}
+
+void GodotSpace2D::island_remove_constraint(GodotConstraint2D *p_constraint) {
+	GodotIsland2D *island = p_constraint->get_island();
+	if (!island) {
+		return;
+	}
+
+	// The bodies it connected may now be split, the island is flooded again before the next solve.
+	island->remove_constraint(p_constraint);
+	island->space->_island_mark_dirty(island);
+}
+
+void GodotSpace2D::island_dissolve_dirty(LocalVector<GodotBody2D *> &r_bodies) {
+	for (GodotIsland2D *island : dirty_islands) {
+		for (GodotBody2D *body : island->bodies) {
+			body->set_island(nullptr);
+			r_bodies.push_back(body);
+		}
+		for (GodotConstraint2D *constraint : island->constraints) {
+			constraint->set_island(nullptr, 0);
+		}
+		island_allocator.free(island);
+	}
+	dirty_islands.clear();
+}
+
 void GodotSpace2D::call_queries() {
 	while (state_query_list.first()) {
 		GodotBody2D *b = state_query_list.first()->self();
@@ -1141,6 +1275,279 @@ void GodotSpace2D::setup() {
 
 void GodotSpace2D::update() {
 	broadphase->update();
+
+	// Pairs missing from a restored snapshot have been created by now.
+	pending_pair_snapshots.clear();
+}
+
+struct GodotBody2DSnapshotComparator {
+	_FORCE_INLINE_ bool operator()(const GodotBody2D::Snapshot &p_a, const GodotBody2D::Snapshot &p_b) const {
+		return p_a.id < p_b.id;
+	}
+};
+
+struct GodotJoint2DSnapshotComparator {
+	_FORCE_INLINE_ bool operator()(const GodotJoint2D::Snapshot &p_a, const GodotJoint2D::Snapshot &p_b) const {
+		return p_a.id < p_b.id;
+	}
+};
+
+// Records of body pairs, area pairs and area to area pairs are all keyed by their two objects and shapes.
+template <typename T>
+static _FORCE_INLINE_ int _compare_pair_snapshot(const T &p_snapshot, uint64_t p_id_A, int p_shape_A, uint64_t p_id_B, int p_shape_B) {
+	if (p_snapshot.id_A != p_id_A) {
+		return p_snapshot.id_A < p_id_A ? -1 : 1;
+	}
+	if (p_snapshot.shape_A != p_shape_A) {
+		return p_snapshot.shape_A < p_shape_A ? -1 : 1;
+	}
+	if (p_snapshot.id_B != p_id_B) {
+		return p_snapshot.id_B < p_id_B ? -1 : 1;
+	}
+	if (p_snapshot.shape_B != p_shape_B) {
+		return p_snapshot.shape_B < p_shape_B ? -1 : 1;
+	}
+	return 0;
+}
+
+template <typename T>
+struct GodotPair2DSnapshotComparator {
+	_FORCE_INLINE_ bool operator()(const T &p_a, const T &p_b) const {
+		return _compare_pair_snapshot(p_a, p_b.id_A, p_b.shape_A, p_b.id_B, p_b.shape_B) < 0;
+	}
+};
+
+template <typename T>
+static const T *_find_pair_snapshot(const LocalVector<T> &p_snapshots, uint64_t p_id_A, int p_shape_A, uint64_t p_id_B, int p_shape_B) {
+	uint32_t low = 0;
+	uint32_t high = p_snapshots.size();
+	while (low < high) {
+		uint32_t middle = (low + high) / 2;
+		int compare = _compare_pair_snapshot(p_snapshots[middle], p_id_A, p_shape_A, p_id_B, p_shape_B);
+		if (compare == 0) {
+			return &p_snapshots[middle];
+		} else if (compare < 0) {
+			low = middle + 1;
+		} else {
+			high = middle;
+		}
+	}
+
+	return nullptr;
+}
+
+// Records are cleared first so the padding bytes are the same in every snapshot.
+template <typename T>
+static _FORCE_INLINE_ T &_push_snapshot_record(LocalVector<T> &r_records) {
+	r_records.resize(r_records.size() + 1);
+	T &record = r_records[r_records.size() - 1];
+	memset((void *)&record, 0, sizeof(T));
+	return record;
+}
+
+template <typename T>
+static _FORCE_INLINE_ void _write_snapshot_records(uint8_t *&r_w, const LocalVector<T> &p_records) {
+	if (p_records.size() > 0) {
+		memcpy(r_w, (const void *)p_records.ptr(), p_records.size() * sizeof(T));
+		r_w += p_records.size() * sizeof(T);
+	}
+}
+
+template <typename T>
+static _FORCE_INLINE_ void _read_snapshot_records(const uint8_t *&r_r, uint32_t p_count, LocalVector<T> &r_records) {
+	r_records.resize(p_count);
+	if (p_count > 0) {
+		memcpy((void *)r_records.ptr(), r_r, p_count * sizeof(T));
+		r_r += p_count * sizeof(T);
+	}
+}
+
+const GodotBodyPair2D::Snapshot *GodotSpace2D::_find_pending_pair_snapshot(const GodotBodyPair2D *p_pair) const {
+	return _find_pair_snapshot(pending_pair_snapshots, p_pair->get_body_A()->get_self().get_id(), p_pair->get_shape_A(), p_pair->get_body_B()->get_self().get_id(), p_pair->get_shape_B());
+}
+
+Vector<uint8_t> GodotSpace2D::save_snapshot() const {
+	LocalVector<GodotBody2D::Snapshot> body_snapshots;
+	LocalVector<GodotBodyPair2D::Snapshot> pair_snapshots;
+	LocalVector<GodotJoint2D::Snapshot> joint_snapshots;
+	LocalVector<GodotAreaPair2D::Snapshot> area_pair_snapshots;
+	LocalVector<GodotArea2Pair2D::Snapshot> area2_pair_snapshots;
+
+	for (const GodotCollisionObject2D *E : objects) {
+		if (E->get_type() == GodotCollisionObject2D::TYPE_AREA) {
+			// Areas only hold their pairs with bodies and with other areas.
+			for (const GodotConstraint2D *C : static_cast<const GodotArea2D *>(E)->get_constraints()) {
+				if (C->is_area_pair()) {
+					static_cast<const GodotAreaPair2D *>(C)->save_snapshot(_push_snapshot_record(area_pair_snapshots));
+				} else if (static_cast<const GodotArea2Pair2D *>(C)->get_area_a() == E) {
+					// Pairs of areas are in the constraints of both, only save them from the first one.
+					static_cast<const GodotArea2Pair2D *>(C)->save_snapshot(_push_snapshot_record(area2_pair_snapshots));
+				}
+			}
+			continue;
+		}
+		const GodotBody2D *body = static_cast<const GodotBody2D *>(E);
+		body->save_snapshot(_push_snapshot_record(body_snapshots));
+
+		for (const Pair<GodotConstraint2D *, int> &C : body->get_constraint_list()) {
+			// Pairs and joints are in the lists of all their bodies, only save them from the first one.
+			if (C.second != 0) {
+				continue;
+			}
+			if (C.first->is_body_pair()) {
+				static_cast<const GodotBodyPair2D *>(C.first)->save_snapshot(_push_snapshot_record(pair_snapshots));
+			} else if (C.first->is_joint()) {
+				static_cast<const GodotJoint2D *>(C.first)->save_snapshot(_push_snapshot_record(joint_snapshots));
+			}
+		}
+	}
+
+	body_snapshots.sort_custom<GodotBody2DSnapshotComparator>();
+	pair_snapshots.sort_custom<GodotPair2DSnapshotComparator<GodotBodyPair2D::Snapshot>>();
+	joint_snapshots.sort_custom<GodotJoint2DSnapshotComparator>();
+	area_pair_snapshots.sort_custom<GodotPair2DSnapshotComparator<GodotAreaPair2D::Snapshot>>();
+	area2_pair_snapshots.sort_custom<GodotPair2DSnapshotComparator<GodotArea2Pair2D::Snapshot>>();
+
+	SnapshotHeader header;
+	header.magic = SNAPSHOT_MAGIC;
+	header.version = SNAPSHOT_VERSION;
+	header.body_count = body_snapshots.size();
+	header.pair_count = pair_snapshots.size();
+	header.joint_count = joint_snapshots.size();
+	header.area_pair_count = area_pair_snapshots.size();
+	header.area2_pair_count = area2_pair_snapshots.size();
+
+	Vector<uint8_t> snapshot;
+	snapshot.resize(sizeof(SnapshotHeader) + header.body_count * sizeof(GodotBody2D::Snapshot) + header.pair_count * sizeof(GodotBodyPair2D::Snapshot) + header.joint_count * sizeof(GodotJoint2D::Snapshot) + header.area_pair_count * sizeof(GodotAreaPair2D::Snapshot) + header.area2_pair_count * sizeof(GodotArea2Pair2D::Snapshot));
+
+	uint8_t *w = snapshot.ptrw();
+	memcpy(w, &header, sizeof(SnapshotHeader));
+	w += sizeof(SnapshotHeader);
+	_write_snapshot_records(w, body_snapshots);
+	_write_snapshot_records(w, pair_snapshots);
+	_write_snapshot_records(w, joint_snapshots);
+	_write_snapshot_records(w, area_pair_snapshots);
+	_write_snapshot_records(w, area2_pair_snapshots);
+
+	return snapshot;
+}
+
+Error GodotSpace2D::restore_snapshot(const Vector<uint8_t> &p_snapshot) {
+	ERR_FAIL_COND_V_MSG(locked, ERR_LOCKED, "Can't restore a snapshot while the space is being stepped.");
+	ERR_FAIL_COND_V(p_snapshot.size() < (int64_t)sizeof(SnapshotHeader), ERR_INVALID_DATA);
+
+	const uint8_t *r = p_snapshot.ptr();
+
+	SnapshotHeader header;
+	memcpy(&header, r, sizeof(SnapshotHeader));
+	r += sizeof(SnapshotHeader);
+
+	ERR_FAIL_COND_V_MSG(header.magic != SNAPSHOT_MAGIC || header.version != SNAPSHOT_VERSION, ERR_INVALID_DATA, "Invalid or incompatible physics space snapshot.");
+	ERR_FAIL_COND_V(p_snapshot.size() != (int64_t)(sizeof(SnapshotHeader) + (uint64_t)header.body_count * sizeof(GodotBody2D::Snapshot) + (uint64_t)header.pair_count * sizeof(GodotBodyPair2D::Snapshot) + (uint64_t)header.joint_count * sizeof(GodotJoint2D::Snapshot) + (uint64_t)header.area_pair_count * sizeof(GodotAreaPair2D::Snapshot) + (uint64_t)header.area2_pair_count * sizeof(GodotArea2Pair2D::Snapshot)), ERR_INVALID_DATA);
+
+	LocalVector<GodotBody2D::Snapshot> body_snapshots;
+	LocalVector<GodotJoint2D::Snapshot> joint_snapshots;
+	LocalVector<GodotAreaPair2D::Snapshot> area_pair_snapshots;
+	LocalVector<GodotArea2Pair2D::Snapshot> area2_pair_snapshots;
+	_read_snapshot_records(r, header.body_count, body_snapshots);
+	_read_snapshot_records(r, header.pair_count, pending_pair_snapshots);
+	_read_snapshot_records(r, header.joint_count, joint_snapshots);
+	_read_snapshot_records(r, header.area_pair_count, area_pair_snapshots);
+	_read_snapshot_records(r, header.area2_pair_count, area2_pair_snapshots);
+
+	HashMap<uint64_t, GodotBody2D *> bodies;
+	HashMap<uint64_t, GodotJoint2D *> joints;
+	LocalVector<GodotArea2D *> areas;
+	for (GodotCollisionObject2D *E : objects) {
+		if (E->get_type() == GodotCollisionObject2D::TYPE_AREA) {
+			areas.push_back(static_cast<GodotArea2D *>(E));
+			continue;
+		}
+		GodotBody2D *body = static_cast<GodotBody2D *>(E);
+		bodies.insert(body->get_self().get_id(), body);
+		for (const Pair<GodotConstraint2D *, int> &C : body->get_constraint_list()) {
+			if (C.second == 0 && C.first->is_joint()) {
+				joints.insert(C.first->get_self().get_id(), static_cast<GodotJoint2D *>(C.first));
+			}
+		}
+	}
+
+	// Bodies and joints freed or moved to another space since the snapshot was saved are skipped.
+	for (const GodotBody2D::Snapshot &body_snapshot : body_snapshots) {
+		GodotBody2D **body = bodies.getptr(body_snapshot.id);
+		if (body) {
+			(*body)->load_snapshot(body_snapshot);
+		}
+	}
+	for (const GodotJoint2D::Snapshot &joint_snapshot : joint_snapshots) {
+		GodotJoint2D **joint = joints.getptr(joint_snapshot.id);
+		if (joint) {
+			(*joint)->load_snapshot(joint_snapshot);
+		}
+	}
+
+	pending_pair_snapshots.sort_custom<GodotPair2DSnapshotComparator<GodotBodyPair2D::Snapshot>>();
+	area_pair_snapshots.sort_custom<GodotPair2DSnapshotComparator<GodotAreaPair2D::Snapshot>>();
+	area2_pair_snapshots.sort_custom<GodotPair2DSnapshotComparator<GodotArea2Pair2D::Snapshot>>();
+
+	// Pair the bodies at their restored transforms, new pairs get their state from the pending list.
+	broadphase->update();
+
+	for (const KeyValue<uint64_t, GodotBody2D *> &E : bodies) {
+		for (const Pair<GodotConstraint2D *, int> &C : E.value->get_constraint_list()) {
+			if (C.second != 0 || !C.first->is_body_pair()) {
+				continue;
+			}
+			GodotBodyPair2D *pair = static_cast<GodotBodyPair2D *>(C.first);
+			const GodotBodyPair2D::Snapshot *pair_snapshot = _find_pending_pair_snapshot(pair);
+			if (pair_snapshot) {
+				pair->load_snapshot(*pair_snapshot);
+			} else {
+				pair->reset_contacts();
+			}
+		}
+	}
+
+	// Overlaps missing from the snapshot weren't there when it was saved, monitors get the enter and
+	// exit changes at the next step. The keys of the current pairs are taken from their own records.
+	for (GodotArea2D *area_object : areas) {
+		for (GodotConstraint2D *C : area_object->get_constraints()) {
+			if (C->is_area_pair()) {
+				GodotAreaPair2D *area_pair = static_cast<GodotAreaPair2D *>(C);
+				GodotAreaPair2D::Snapshot key;
+				area_pair->save_snapshot(key);
+				const GodotAreaPair2D::Snapshot *area_pair_snapshot = _find_pair_snapshot(area_pair_snapshots, key.id_A, key.shape_A, key.id_B, key.shape_B);
+				area_pair->load_snapshot(area_pair_snapshot && area_pair_snapshot->colliding);
+				continue;
+			}
+
+			GodotArea2Pair2D *area2_pair = static_cast<GodotArea2Pair2D *>(C);
+			if (area2_pair->get_area_a() != area_object) {
+				continue;
+			}
+			GodotArea2Pair2D::Snapshot key;
+			area2_pair->save_snapshot(key);
+			uint32_t colliding = 0;
+			const GodotArea2Pair2D::Snapshot *area2_pair_snapshot = _find_pair_snapshot(area2_pair_snapshots, key.id_A, key.shape_A, key.id_B, key.shape_B);
+			if (area2_pair_snapshot) {
+				colliding = area2_pair_snapshot->colliding;
+			} else {
+				// The broadphase may have paired the areas the other way around this time.
+				area2_pair_snapshot = _find_pair_snapshot(area2_pair_snapshots, key.id_B, key.shape_B, key.id_A, key.shape_A);
+				if (area2_pair_snapshot) {
+					if (area2_pair_snapshot->colliding & GodotArea2Pair2D::COLLIDING_A) {
+						colliding |= GodotArea2Pair2D::COLLIDING_B;
+					}
+					if (area2_pair_snapshot->colliding & GodotArea2Pair2D::COLLIDING_B) {
+						colliding |= GodotArea2Pair2D::COLLIDING_A;
+					}
+				}
+			}
+			area2_pair->load_snapshot(colliding);
+		}
+	}
+
+	return OK;
 }
 
 void GodotSpace2D::set_param(PhysicsServer2D::SpaceParameter p_param, real_t p_value) {
@@ -1225,10 +1632,15 @@ GodotSpace2D::GodotSpace2D() {
 	contact_max_allowed_penetration = GLOBAL_GET("physics/2d/solver/contact_max_allowed_penetration");
 	contact_bias = GLOBAL_GET("physics/2d/solver/default_contact_bias");
 	constraint_bias = GLOBAL_GET("physics/2d/solver/default_constraint_bias");
+	deterministic = GLOBAL_GET("physics/2d/solver/deterministic");
 
 	broadphase = GodotBroadPhase2D::create_func();
 	broadphase->set_pair_callback(_broadphase_pair, this);
 	broadphase->set_unpair_callback(_broadphase_unpair, this);
+	if (deterministic) {
+		// Expanded pairing AABBs keep pairs alive depending on past motion, which a snapshot doesn't capture.
+		broadphase->set_pairing_expansion(0.0);
+	}
 
 	direct_access = memnew(GodotPhysicsDirectSpaceState2D);
 	direct_access->space = this;
@@ -37,9 +37,12 @@
 #include "godot_body_pair_2d.h"
 #include "godot_broad_phase_2d.h"
 #include "godot_collision_object_2d.h"
+#include "godot_island_2d.h"
 
 #include "core/config/project_settings.h"
 #include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/paged_allocator.h"
 #include "core/typedefs.h"
 
 class GodotPhysicsDirectSpaceState2D : public PhysicsDirectSpaceState2D {
@@ -121,8 +124,41 @@ private:
 
 	int island_count = 0;
 	int active_objects = 0;
+
+	// Islands are kept across steps and patched as constraints come and go, see GodotIsland2D.
+	PagedAllocator<GodotIsland2D> island_allocator;
+	LocalVector<GodotIsland2D *> dirty_islands;
+
+	void _island_mark_dirty(GodotIsland2D *p_island);
+	void _island_free(GodotIsland2D *p_island);
+	GodotIsland2D *_island_merge(GodotIsland2D *p_island_a, GodotIsland2D *p_island_b);
 	int collision_pairs = 0;
 
+	// Deterministic mode pairs on exact AABBs, keeps body pairs in the same order and sorts the islands,
+	// so the same state stepped again gives bit-identical results.
+	bool deterministic = false;
+
+	enum {
+		SNAPSHOT_MAGIC = 0x32535347, // "GSS2"
+		SNAPSHOT_VERSION = 2,
+	};
+
+	struct SnapshotHeader {
+		uint32_t magic = 0;
+		uint32_t version = 0;
+		uint32_t body_count = 0;
+		uint32_t pair_count = 0;
+		uint32_t joint_count = 0;
+		uint32_t area_pair_count = 0;
+		uint32_t area2_pair_count = 0;
+	};
+
+	// Pair states of the last restored snapshot, sorted by bodies and shapes. Pairs that didn't exist yet
+	// when the snapshot was restored get their state when created in the next broadphase update.
+	LocalVector<GodotBodyPair2D::Snapshot> pending_pair_snapshots;
+
+	const GodotBodyPair2D::Snapshot *_find_pending_pair_snapshot(const GodotBodyPair2D *p_pair) const;
+
 	int _cull_aabb_for_body(GodotBody2D *p_body, const Rect2 &p_aabb);
 
 	Vector<Vector2> contact_debug;
@@ -168,10 +204,15 @@ public:
 	_FORCE_INLINE_ real_t get_body_angular_velocity_sleep_threshold() const { return body_angular_velocity_sleep_threshold; }
 	_FORCE_INLINE_ real_t get_body_time_to_sleep() const { return body_time_to_sleep; }
 
+	_FORCE_INLINE_ bool is_deterministic() const { return deterministic; }
+
 	void update();
 	void setup();
 	void call_queries();
 
+	Vector<uint8_t> save_snapshot() const;
+	Error restore_snapshot(const Vector<uint8_t> &p_snapshot);
+
 	bool is_locked() const;
 	void lock();
 	void unlock();
@@ -185,6 +226,15 @@ public:
 	void set_island_count(int p_island_count) { island_count = p_island_count; }
 	int get_island_count() const { return island_count; }
 
+	void island_add_body(GodotBody2D *p_body);
+	void island_remove_body(GodotBody2D *p_body);
+	void island_add_constraint(GodotConstraint2D *p_constraint, GodotIsland2D *p_island);
+	// Static because the constraint may be removed by a body that already left the space of its island.
+	static void island_remove_constraint(GodotConstraint2D *p_constraint);
+	GodotIsland2D *island_create();
+	// Frees the dirty islands and returns their bodies, which have no island until they are flooded again.
+	void island_dissolve_dirty(LocalVector<GodotBody2D *> &r_bodies);
+
 	void set_active_objects(int p_active_objects) { active_objects = p_active_objects; }
 	int get_active_objects() const { return active_objects; }
 
@@ -33,45 +33,93 @@
 #include "core/object/worker_thread_pool.h"
 #include "core/os/os.h"
 
-#define BODY_ISLAND_COUNT_RESERVE 128
-#define BODY_ISLAND_SIZE_RESERVE 512
 #define ISLAND_COUNT_RESERVE 128
-#define ISLAND_SIZE_RESERVE 512
 #define CONSTRAINT_COUNT_RESERVE 1024
 
-void GodotStep2D::_populate_island(GodotBody2D *p_body, LocalVector<GodotBody2D *> &p_body_island, LocalVector<GodotConstraint2D *> &p_constraint_island) {
-	p_body->set_island_step(_step);
-
-	if (p_body->get_mode() > PhysicsServer2D::BODY_MODE_KINEMATIC) {
-		// Only rigid bodies are tested for activation.
-		p_body_island.push_back(p_body);
-	}
-
-	for (const Pair<GodotConstraint2D *, int> &E : p_body->get_constraint_list()) {
-		GodotConstraint2D *constraint = const_cast<GodotConstraint2D *>(E.first);
-		if (constraint->get_island_step() == _step) {
-			continue; // Already processed.
+struct GodotConstraint2DOrderComparator {
+	_FORCE_INLINE_ bool operator()(const GodotConstraint2D *p_a, const GodotConstraint2D *p_b) const {
+		if (p_a->get_body_count() != p_b->get_body_count()) {
+			return p_a->get_body_count() < p_b->get_body_count();
 		}
-		constraint->set_island_step(_step);
-		p_constraint_island.push_back(constraint);
-		all_constraints.push_back(constraint);
-
-		for (int i = 0; i < constraint->get_body_count(); i++) {
-			if (i == E.second) {
-				continue;
+		for (int i = 0; i < p_a->get_body_count(); i++) {
+			uint64_t id_a = p_a->get_body_ptr()[i]->get_self().get_id();
+			uint64_t id_b = p_b->get_body_ptr()[i]->get_self().get_id();
+			if (id_a != id_b) {
+				return id_a < id_b;
 			}
-			GodotBody2D *other_body = constraint->get_body_ptr()[i];
-			if (other_body->get_island_step() == _step) {
+		}
+		return p_a->get_order_key() < p_b->get_order_key();
+	}
+};
+
+void GodotStep2D::_populate_island(GodotSpace2D *p_space, GodotIsland2D *p_island) {
+	// Iterative flood fill from the bodies already on the stack,
+	// so long chains of connected bodies can't overflow the call stack.
+	while (!island_body_stack.is_empty()) {
+		GodotBody2D *body = island_body_stack[island_body_stack.size() - 1];
+		island_body_stack.remove_at(island_body_stack.size() - 1);
+
+		for (const Pair<GodotConstraint2D *, int> &E : body->get_constraint_list()) {
+			GodotConstraint2D *constraint = const_cast<GodotConstraint2D *>(E.first);
+			if (constraint->get_island()) {
 				continue; // Already processed.
 			}
-			if (other_body->get_mode() == PhysicsServer2D::BODY_MODE_STATIC) {
-				continue; // Static bodies don't connect islands.
+			p_island->add_constraint(constraint);
+
+			for (int i = 0; i < constraint->get_body_count(); i++) {
+				if (i == E.second) {
+					continue;
+				}
+				GodotBody2D *other_body = constraint->get_body_ptr()[i];
+				if (other_body->get_island()) {
+					continue; // Already processed.
+				}
+				if (other_body->get_mode() == PhysicsServer2D::BODY_MODE_STATIC || other_body->get_space() != p_space) {
+					continue; // Static bodies and bodies from other spaces don't connect islands.
+				}
+				p_island->add_body(other_body);
+				island_body_stack.push_back(other_body);
 			}
-			_populate_island(other_body, p_body_island, p_constraint_island);
 		}
 	}
 }
 
+void GodotStep2D::_update_islands(GodotSpace2D *p_space) {
+	// Islands are merged as soon as a constraint connects them, only the ones that lost a constraint
+	// or a body are flooded again here, as they may have split.
+	island_body_seeds.clear();
+	p_space->island_dissolve_dirty(island_body_seeds);
+
+	for (GodotBody2D *body : island_body_seeds) {
+		if (body->get_island()) {
+			continue; // Reached from another seed.
+		}
+		GodotIsland2D *island = p_space->island_create();
+		island->add_body(body);
+		island_body_stack.push_back(body);
+		_populate_island(p_space, island);
+	}
+}
+
+void GodotStep2D::_activate_island(GodotSpace2D *p_space, GodotIsland2D *p_island) {
+	if (!p_island || p_island->step == _step) {
+		return;
+	}
+	p_island->step = _step;
+
+	if (p_space->is_deterministic() && !p_island->sorted) {
+		// The order of the constraints depends on the order they were added in and islands were merged in,
+		// sort them so they are always solved in the same order.
+		p_island->constraints.sort_custom<GodotConstraint2DOrderComparator>();
+		for (uint32_t i = 0; i < p_island->constraints.size(); i++) {
+			p_island->constraints[i]->set_island(p_island, i);
+		}
+		p_island->sorted = true;
+	}
+
+	active_islands.push_back(p_island);
+}
+
 void GodotStep2D::_setup_constraint(uint32_t p_constraint_index, void *p_userdata) {
 	GodotConstraint2D *constraint = all_constraints[p_constraint_index];
 	constraint->setup(delta);
@@ -101,12 +149,15 @@ void GodotStep2D::_solve_island(uint32_t p_island_index, void *p_userdata) const
 	}
 }
 
-void GodotStep2D::_check_suspend(LocalVector<GodotBody2D *> &p_body_island) const {
+void GodotStep2D::_check_suspend(const GodotIsland2D *p_island) const {
 	bool can_sleep = true;
 
-	uint32_t body_count = p_body_island.size();
+	uint32_t body_count = p_island->bodies.size();
 	for (uint32_t body_index = 0; body_index < body_count; ++body_index) {
-		GodotBody2D *body = p_body_island[body_index];
+		GodotBody2D *body = p_island->bodies[body_index];
+		if (body->get_mode() <= PhysicsServer2D::BODY_MODE_KINEMATIC) {
+			continue; // Only rigid bodies are tested for activation.
+		}
 
 		if (!body->sleep_test(delta)) {
 			can_sleep = false;
@@ -115,7 +166,10 @@ void GodotStep2D::_check_suspend(LocalVector<GodotBody2D *> &p_body_island) cons
 
 	// Put all to sleep or wake up everyone.
 	for (uint32_t body_index = 0; body_index < body_count; ++body_index) {
-		GodotBody2D *body = p_body_island[body_index];
+		GodotBody2D *body = p_island->bodies[body_index];
+		if (body->get_mode() <= PhysicsServer2D::BODY_MODE_KINEMATIC) {
+			continue;
+		}
 
 		bool active = body->is_active();
 
@@ -162,10 +216,41 @@ void GodotStep2D::step(GodotSpace2D *p_space, real_t p_delta) {
 		profile_begtime = profile_endtime;
 	}
 
-	/* GENERATE CONSTRAINT ISLANDS FOR MOVING AREAS */
+	/* GENERATE CONSTRAINT ISLANDS FOR ACTIVE RIGID BODIES */
+
+	_update_islands(p_space);
+
+	// Islands are kept across steps, only the ones with an active body are solved.
+	active_islands.clear();
 
+	b = body_list->first();
+	while (b) {
+		_activate_island(p_space, b->self()->get_island());
+		b = b->next();
+	}
+
+	// The constraints are copied because solving modifies the islands.
 	uint32_t island_count = 0;
 
+	for (const GodotIsland2D *island : active_islands) {
+		if (island->constraints.is_empty()) {
+			continue;
+		}
+		++island_count;
+		if (constraint_islands.size() < island_count) {
+			constraint_islands.resize(island_count);
+		}
+		LocalVector<GodotConstraint2D *> &constraint_island = constraint_islands[island_count - 1];
+		constraint_island = island->constraints;
+
+		for (GodotConstraint2D *constraint : constraint_island) {
+			constraint->set_island_step(_step);
+			all_constraints.push_back(constraint);
+		}
+	}
+
+	/* GENERATE CONSTRAINT ISLANDS FOR MOVING AREAS */
+
 	const SelfList<GodotArea2D>::List &aml = p_space->get_moved_area_list();
 
 	while (aml.first()) {
@@ -190,45 +275,6 @@ void GodotStep2D::step(GodotSpace2D *p_space, real_t p_delta) {
 		p_space->area_remove_from_moved_list((SelfList<GodotArea2D> *)aml.first()); //faster to remove here
 	}
 
-	/* GENERATE CONSTRAINT ISLANDS FOR ACTIVE RIGID BODIES */
-
-	b = body_list->first();
-
-	uint32_t body_island_count = 0;
-
-	while (b) {
-		GodotBody2D *body = b->self();
-
-		if (body->get_island_step() != _step) {
-			++body_island_count;
-			if (body_islands.size() < body_island_count) {
-				body_islands.resize(body_island_count);
-			}
-			LocalVector<GodotBody2D *> &body_island = body_islands[body_island_count - 1];
-			body_island.clear();
-			body_island.reserve(BODY_ISLAND_SIZE_RESERVE);
-
-			++island_count;
-			if (constraint_islands.size() < island_count) {
-				constraint_islands.resize(island_count);
-			}
-			LocalVector<GodotConstraint2D *> &constraint_island = constraint_islands[island_count - 1];
-			constraint_island.clear();
-			constraint_island.reserve(ISLAND_SIZE_RESERVE);
-
-			_populate_island(body, body_island, constraint_island);
-
-			if (body_island.is_empty()) {
-				--body_island_count;
-			}
-
-			if (constraint_island.is_empty()) {
-				--island_count;
-			}
-		}
-		b = b->next();
-	}
-
 	p_space->set_island_count((int)island_count);
 
 	{ //profile
@@ -280,8 +326,8 @@ void GodotStep2D::step(GodotSpace2D *p_space, real_t p_delta) {
 
 	/* SLEEP / WAKE UP ISLANDS */
 
-	for (uint32_t island_index = 0; island_index < body_island_count; ++island_index) {
-		_check_suspend(body_islands[island_index]);
+	for (const GodotIsland2D *island : active_islands) {
+		_check_suspend(island);
 	}
 
 	{ //profile
@@ -297,8 +343,8 @@ void GodotStep2D::step(GodotSpace2D *p_space, real_t p_delta) {
 }
 
 GodotStep2D::GodotStep2D() {
-	body_islands.reserve(BODY_ISLAND_COUNT_RESERVE);
 	constraint_islands.reserve(ISLAND_COUNT_RESERVE);
+	active_islands.reserve(ISLAND_COUNT_RESERVE);
 	all_constraints.reserve(CONSTRAINT_COUNT_RESERVE);
 }
 
@@ -41,15 +41,23 @@ class GodotStep2D {
 	int iterations = 0;
 	real_t delta = 0.0;
 
-	LocalVector<LocalVector<GodotBody2D *>> body_islands;
 	LocalVector<LocalVector<GodotConstraint2D *>> constraint_islands;
 	LocalVector<GodotConstraint2D *> all_constraints;
 
-	void _populate_island(GodotBody2D *p_body, LocalVector<GodotBody2D *> &p_body_island, LocalVector<GodotConstraint2D *> &p_constraint_island);
+	// Islands with an active body in the current step.
+	LocalVector<GodotIsland2D *> active_islands;
+
+	// Bodies of the dirty islands, and the bodies left to visit while populating an island.
+	LocalVector<GodotBody2D *> island_body_seeds;
+	LocalVector<GodotBody2D *> island_body_stack;
+
+	void _populate_island(GodotSpace2D *p_space, GodotIsland2D *p_island);
+	void _update_islands(GodotSpace2D *p_space);
+	void _activate_island(GodotSpace2D *p_space, GodotIsland2D *p_island);
 	void _setup_constraint(uint32_t p_constraint_index, void *p_userdata = nullptr);
 	void _pre_solve_island(LocalVector<GodotConstraint2D *> &p_constraint_island) const;
 	void _solve_island(uint32_t p_island_index, void *p_userdata = nullptr) const;
-	void _check_suspend(LocalVector<GodotBody2D *> &p_body_island) const;
+	void _check_suspend(const GodotIsland2D *p_island) const;
 
 public:
 	void step(GodotSpace2D *p_space, real_t p_delta);
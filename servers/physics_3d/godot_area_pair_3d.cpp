@@ -32,37 +32,25 @@
 
 #include "godot_collision_solver_3d.h"
 
-bool GodotAreaPair3D::setup(real_t p_step) {
-	bool result = false;
-	if (area->collides_with(body) && GodotCollisionSolver3D::solve_static(body->get_shape(body_shape), body->get_transform() * body->get_shape_transform(body_shape), area->get_shape(area_shape), area->get_transform() * area->get_shape_transform(area_shape), nullptr, this)) {
-		result = true;
-	}
-
-	process_collision = false;
-	has_space_override = false;
-	if (result != colliding) {
-		if ((int)area->get_param(PhysicsServer3D::AREA_PARAM_GRAVITY_OVERRIDE_MODE) != PhysicsServer3D::AREA_SPACE_OVERRIDE_DISABLED) {
-			has_space_override = true;
-		} else if ((int)area->get_param(PhysicsServer3D::AREA_PARAM_LINEAR_DAMP_OVERRIDE_MODE) != PhysicsServer3D::AREA_SPACE_OVERRIDE_DISABLED) {
-			has_space_override = true;
-		} else if ((int)area->get_param(PhysicsServer3D::AREA_PARAM_ANGULAR_DAMP_OVERRIDE_MODE) != PhysicsServer3D::AREA_SPACE_OVERRIDE_DISABLED) {
-			has_space_override = true;
-		}
-		process_collision = has_space_override;
-
-		if (area->has_monitor_callback()) {
-			process_collision = true;
-		}
-
-		colliding = result;
-	}
-
-	return process_collision;
+bool GodotAreaPair3D::test_collision() const {
+	return area->collides_with(body) && GodotCollisionSolver3D::solve_static(body->get_shape(body_shape), body->get_transform() * body->get_shape_transform(body_shape), area->get_shape(area_shape), area->get_transform() * area->get_shape_transform(area_shape), nullptr, nullptr);
 }
 
-bool GodotAreaPair3D::pre_solve(real_t p_step) {
-	if (!process_collision) {
-		return false;
+void GodotAreaPair3D::update_collision(bool p_colliding) {
+	tested = true;
+	tested_body_version = body->get_transform_version();
+	if (p_colliding == colliding) {
+		return;
+	}
+	colliding = p_colliding;
+
+	bool has_space_override = false;
+	if ((int)area->get_param(PhysicsServer3D::AREA_PARAM_GRAVITY_OVERRIDE_MODE) != PhysicsServer3D::AREA_SPACE_OVERRIDE_DISABLED) {
+		has_space_override = true;
+	} else if ((int)area->get_param(PhysicsServer3D::AREA_PARAM_LINEAR_DAMP_OVERRIDE_MODE) != PhysicsServer3D::AREA_SPACE_OVERRIDE_DISABLED) {
+		has_space_override = true;
+	} else if ((int)area->get_param(PhysicsServer3D::AREA_PARAM_ANGULAR_DAMP_OVERRIDE_MODE) != PhysicsServer3D::AREA_SPACE_OVERRIDE_DISABLED) {
+		has_space_override = true;
 	}
 
 	if (colliding) {
@@ -84,12 +72,19 @@ bool GodotAreaPair3D::pre_solve(real_t p_step) {
 			area->remove_body_from_query(body, body_shape, area_shape);
 		}
 	}
+}
 
-	return false; // Never do any post solving.
+void GodotAreaPair3D::save_snapshot(Snapshot &r_snapshot) const {
+	r_snapshot.id_A = body->get_self().get_id();
+	r_snapshot.id_B = area->get_self().get_id();
+	r_snapshot.shape_A = body_shape;
+	r_snapshot.shape_B = area_shape;
+	r_snapshot.colliding = colliding;
 }
 
-void GodotAreaPair3D::solve(real_t p_step) {
-	// Nothing to do.
+void GodotAreaPair3D::load_snapshot(bool p_colliding) {
+	update_collision(p_colliding);
+	tested = false;
 }
 
 GodotAreaPair3D::GodotAreaPair3D(GodotBody3D *p_body, int p_body_shape, GodotArea3D *p_area, int p_area_shape) {
@@ -97,8 +92,6 @@ GodotAreaPair3D::GodotAreaPair3D(GodotBody3D *p_body, int p_body_shape, GodotAre
 	area = p_area;
 	body_shape = p_body_shape;
 	area_shape = p_area_shape;
-	body->add_constraint(this, 0);
-	area->add_constraint(this);
 	if (p_body->get_mode() == PhysicsServer3D::BODY_MODE_KINEMATIC) {
 		p_body->set_active(true);
 	}
@@ -114,65 +107,63 @@ GodotAreaPair3D::~GodotAreaPair3D() {
 			area->remove_body_from_query(body, body_shape, area_shape);
 		}
 	}
-	body->remove_constraint(this);
-	area->remove_constraint(this);
 }
 
 ////////////////////////////////////////////////////
 
-bool GodotArea2Pair3D::setup(real_t p_step) {
-	bool result_a = area_a->collides_with(area_b);
-	bool result_b = area_b->collides_with(area_a);
-	if ((result_a || result_b) && !GodotCollisionSolver3D::solve_static(area_a->get_shape(shape_a), area_a->get_transform() * area_a->get_shape_transform(shape_a), area_b->get_shape(shape_b), area_b->get_transform() * area_b->get_shape_transform(shape_b), nullptr, this)) {
-		result_a = false;
-		result_b = false;
+uint32_t GodotArea2Pair3D::test_collision() const {
+	uint32_t result = 0;
+	if (area_a->collides_with(area_b)) {
+		result |= COLLIDING_A;
+	}
+	if (area_b->collides_with(area_a)) {
+		result |= COLLIDING_B;
+	}
+	if (result && !GodotCollisionSolver3D::solve_static(area_a->get_shape(shape_a), area_a->get_transform() * area_a->get_shape_transform(shape_a), area_b->get_shape(shape_b), area_b->get_transform() * area_b->get_shape_transform(shape_b), nullptr, nullptr)) {
+		result = 0;
 	}
+	return result;
+}
 
-	bool process_collision = false;
+void GodotArea2Pair3D::update_collision(uint32_t p_colliding) {
+	tested = true;
 
-	process_collision_a = false;
+	bool result_a = p_colliding & COLLIDING_A;
 	if (result_a != colliding_a) {
 		if (area_a->has_area_monitor_callback() && area_b_monitorable) {
-			process_collision_a = true;
-			process_collision = true;
+			if (result_a) {
+				area_a->add_area_to_query(area_b, shape_b, shape_a);
+			} else {
+				area_a->remove_area_from_query(area_b, shape_b, shape_a);
+			}
 		}
 		colliding_a = result_a;
 	}
 
-	process_collision_b = false;
+	bool result_b = p_colliding & COLLIDING_B;
 	if (result_b != colliding_b) {
 		if (area_b->has_area_monitor_callback() && area_a_monitorable) {
-			process_collision_b = true;
-			process_collision = true;
+			if (result_b) {
+				area_b->add_area_to_query(area_a, shape_a, shape_b);
+			} else {
+				area_b->remove_area_from_query(area_a, shape_a, shape_b);
+			}
 		}
 		colliding_b = result_b;
 	}
-
-	return process_collision;
 }
 
-bool GodotArea2Pair3D::pre_solve(real_t p_step) {
-	if (process_collision_a) {
-		if (colliding_a) {
-			area_a->add_area_to_query(area_b, shape_b, shape_a);
-		} else {
-			area_a->remove_area_from_query(area_b, shape_b, shape_a);
-		}
-	}
-
-	if (process_collision_b) {
-		if (colliding_b) {
-			area_b->add_area_to_query(area_a, shape_a, shape_b);
-		} else {
-			area_b->remove_area_from_query(area_a, shape_a, shape_b);
-		}
-	}
-
-	return false; // Never do any post solving.
+void GodotArea2Pair3D::save_snapshot(Snapshot &r_snapshot) const {
+	r_snapshot.id_A = area_a->get_self().get_id();
+	r_snapshot.id_B = area_b->get_self().get_id();
+	r_snapshot.shape_A = shape_a;
+	r_snapshot.shape_B = shape_b;
+	r_snapshot.colliding = (colliding_a ? COLLIDING_A : 0) | (colliding_b ? COLLIDING_B : 0);
 }
 
-void GodotArea2Pair3D::solve(real_t p_step) {
-	// Nothing to do.
+void GodotArea2Pair3D::load_snapshot(uint32_t p_colliding) {
+	update_collision(p_colliding);
+	tested = false;
 }
 
 GodotArea2Pair3D::GodotArea2Pair3D(GodotArea3D *p_area_a, int p_shape_a, GodotArea3D *p_area_b, int p_shape_b) {
@@ -182,8 +173,6 @@ GodotArea2Pair3D::GodotArea2Pair3D(GodotArea3D *p_area_a, int p_shape_a, GodotAr
 	shape_b = p_shape_b;
 	area_a_monitorable = area_a->is_monitorable();
 	area_b_monitorable = area_b->is_monitorable();
-	area_a->add_constraint(this);
-	area_b->add_constraint(this);
 }
 
 GodotArea2Pair3D::~GodotArea2Pair3D() {
@@ -198,9 +187,6 @@ GodotArea2Pair3D::~GodotArea2Pair3D() {
 			area_b->remove_area_from_query(area_a, shape_a, shape_b);
 		}
 	}
-
-	area_a->remove_constraint(this);
-	area_b->remove_constraint(this);
 }
 
 ////////////////////////////////////////////////////
@@ -270,6 +256,10 @@ void GodotAreaSoftBodyPair3D::solve(real_t p_step) {
 	// Nothing to do.
 }
 
+uint64_t GodotAreaSoftBodyPair3D::get_order_key() const {
+	return ((uint64_t)hash_murmur3_one_64(area->get_self().get_id(), area_shape) << 32) | hash_murmur3_one_64(soft_body->get_self().get_id(), soft_body_shape);
+}
+
 GodotAreaSoftBodyPair3D::GodotAreaSoftBodyPair3D(GodotSoftBody3D *p_soft_body, int p_soft_body_shape, GodotArea3D *p_area, int p_area_shape) {
 	soft_body = p_soft_body;
 	area = p_area;
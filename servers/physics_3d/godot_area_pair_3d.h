@@ -36,41 +36,88 @@
 #include "godot_constraint_3d.h"
 #include "godot_soft_body_3d.h"
 
-class GodotAreaPair3D : public GodotConstraint3D {
+// Overlaps between areas and bodies aren't solved, so unlike the other pairs they aren't constraints.
+// The space keeps them in flat lists, and GodotStep3D tests all the pairs that may have changed in one
+// batch per step before applying the enter and exit changes.
+class GodotAreaPair3D {
 	GodotBody3D *body = nullptr;
 	GodotArea3D *area = nullptr;
 	int body_shape;
 	int area_shape;
+	uint32_t index = 0;
+	// Transform version of the body when last tested, sleeping and static bodies can be moved too.
+	uint32_t tested_body_version = 0;
 	bool colliding = false;
-	bool process_collision = false;
-	bool has_space_override = false;
+	bool tested = false;
 	bool body_has_attached_area = false;
 
 public:
-	virtual bool setup(real_t p_step) override;
-	virtual bool pre_solve(real_t p_step) override;
-	virtual void solve(real_t p_step) override;
+	// Overlap state, copied as a flat record by space snapshots. A is the body, B the area.
+	struct Snapshot {
+		uint64_t id_A = 0;
+		uint64_t id_B = 0;
+		int32_t shape_A = 0;
+		int32_t shape_B = 0;
+		uint32_t colliding = 0;
+	};
+
+	_FORCE_INLINE_ void set_index(uint32_t p_index) { index = p_index; }
+	_FORCE_INLINE_ uint32_t get_index() const { return index; }
+
+	// Only moving bodies and areas can change the overlap, new pairs are always tested once.
+	_FORCE_INLINE_ bool needs_test() const { return !tested || body->get_transform_version() != tested_body_version || area->is_moved(); }
+
+	// Can run on several threads at once, the results are applied afterwards with update_collision().
+	bool test_collision() const;
+	void update_collision(bool p_colliding);
+
+	void save_snapshot(Snapshot &r_snapshot) const;
+	// Applies the enter or exit change right away, the pair is tested again in the next step.
+	void load_snapshot(bool p_colliding);
 
 	GodotAreaPair3D(GodotBody3D *p_body, int p_body_shape, GodotArea3D *p_area, int p_area_shape);
 	~GodotAreaPair3D();
 };
 
-class GodotArea2Pair3D : public GodotConstraint3D {
+class GodotArea2Pair3D {
 	GodotArea3D *area_a = nullptr;
 	GodotArea3D *area_b = nullptr;
 	int shape_a;
 	int shape_b;
+	uint32_t index = 0;
 	bool colliding_a = false;
 	bool colliding_b = false;
-	bool process_collision_a = false;
-	bool process_collision_b = false;
+	bool tested = false;
 	bool area_a_monitorable;
 	bool area_b_monitorable;
 
 public:
-	virtual bool setup(real_t p_step) override;
-	virtual bool pre_solve(real_t p_step) override;
-	virtual void solve(real_t p_step) override;
+	enum {
+		COLLIDING_A = 1,
+		COLLIDING_B = 2,
+	};
+
+	// Overlap state, copied as a flat record by space snapshots. Colliding is the result of test_collision().
+	struct Snapshot {
+		uint64_t id_A = 0;
+		uint64_t id_B = 0;
+		int32_t shape_A = 0;
+		int32_t shape_B = 0;
+		uint32_t colliding = 0;
+	};
+
+	_FORCE_INLINE_ void set_index(uint32_t p_index) { index = p_index; }
+	_FORCE_INLINE_ uint32_t get_index() const { return index; }
+
+	_FORCE_INLINE_ bool needs_test() const { return !tested || area_a->is_moved() || area_b->is_moved(); }
+
+	// Returns a combination of COLLIDING_A and COLLIDING_B, for each area monitoring the other.
+	uint32_t test_collision() const;
+	void update_collision(uint32_t p_colliding);
+
+	void save_snapshot(Snapshot &r_snapshot) const;
+	// Applies the enter and exit changes right away, the pair is tested again in the next step.
+	void load_snapshot(uint32_t p_colliding);
 
 	GodotArea2Pair3D(GodotArea3D *p_area_a, int p_shape_a, GodotArea3D *p_area_b, int p_shape_b);
 	~GodotArea2Pair3D();
@@ -91,6 +138,8 @@ public:
 	virtual bool pre_solve(real_t p_step) override;
 	virtual void solve(real_t p_step) override;
 
+	virtual uint64_t get_order_key() const override;
+
 	GodotAreaSoftBodyPair3D(GodotSoftBody3D *p_sof_body, int p_soft_body_shape, GodotArea3D *p_area, int p_area_shape);
 	~GodotAreaSoftBodyPair3D();
 };
@@ -49,7 +49,7 @@ void GodotBody3D::_update_transform_dependent() {
 	Basis tbt = tb.transposed();
 	Basis diag;
 	diag.scale(_inv_inertia);
-	_inv_inertia_tensor = tb * diag * tbt;
+	_inv_inertia_tensor_ref() = tb * diag * tbt;
 }
 
 void GodotBody3D::update_mass_properties() {
@@ -295,10 +295,38 @@ Variant GodotBody3D::get_param(PhysicsServer3D::BodyParameter p_param) const {
 	return 0;
 }
 
+void GodotBody3D::add_constraint(GodotConstraint3D *p_constraint, int p_pos) {
+	constraint_map[p_constraint] = p_pos;
+	if (get_space()) {
+		get_space()->island_add_constraint(p_constraint, island);
+	}
+}
+
+void GodotBody3D::remove_constraint(GodotConstraint3D *p_constraint) {
+	constraint_map.erase(p_constraint);
+	GodotSpace3D::island_remove_constraint(p_constraint);
+}
+
+void GodotBody3D::clear_constraint_map() {
+	for (const KeyValue<GodotConstraint3D *, int> &E : constraint_map) {
+		GodotSpace3D::island_remove_constraint(E.key);
+	}
+	constraint_map.clear();
+}
+
 void GodotBody3D::set_mode(PhysicsServer3D::BodyMode p_mode) {
 	PhysicsServer3D::BodyMode prev = mode;
 	mode = p_mode;
 
+	if (get_space()) {
+		// Static bodies don't connect islands.
+		if (p_mode == PhysicsServer3D::BODY_MODE_STATIC) {
+			get_space()->island_remove_body(this);
+		} else {
+			get_space()->island_add_body(this);
+		}
+	}
+
 	switch (p_mode) {
 		case PhysicsServer3D::BODY_MODE_STATIC:
 		case PhysicsServer3D::BODY_MODE_KINEMATIC: {
@@ -437,6 +465,45 @@ Variant GodotBody3D::get_state(PhysicsServer3D::BodyState p_state) const {
 	return Variant();
 }
 
+void GodotBody3D::save_snapshot(Snapshot &r_snapshot) const {
+	r_snapshot.id = get_self().get_id();
+	r_snapshot.transform = get_transform();
+	r_snapshot.inv_transform = get_inv_transform();
+	r_snapshot.new_transform = new_transform;
+	r_snapshot.linear_velocity = linear_velocity;
+	r_snapshot.angular_velocity = angular_velocity;
+	r_snapshot.prev_linear_velocity = prev_linear_velocity;
+	r_snapshot.prev_angular_velocity = prev_angular_velocity;
+	r_snapshot.applied_force = applied_force;
+	r_snapshot.applied_torque = applied_torque;
+	r_snapshot.constant_force = constant_force;
+	r_snapshot.constant_torque = constant_torque;
+	r_snapshot.still_time = still_time;
+	r_snapshot.active = active;
+	r_snapshot.first_time_kinematic = first_time_kinematic;
+}
+
+void GodotBody3D::load_snapshot(const Snapshot &p_snapshot) {
+	// The inverse transform is restored as saved instead of being recomputed, so following steps match bit for bit.
+	_set_transform(p_snapshot.transform);
+	_set_inv_transform(p_snapshot.inv_transform);
+	_update_transform_dependent();
+
+	new_transform = p_snapshot.new_transform;
+	linear_velocity = p_snapshot.linear_velocity;
+	angular_velocity = p_snapshot.angular_velocity;
+	prev_linear_velocity = p_snapshot.prev_linear_velocity;
+	prev_angular_velocity = p_snapshot.prev_angular_velocity;
+	applied_force = p_snapshot.applied_force;
+	applied_torque = p_snapshot.applied_torque;
+	constant_force = p_snapshot.constant_force;
+	constant_torque = p_snapshot.constant_torque;
+	still_time = p_snapshot.still_time;
+	first_time_kinematic = p_snapshot.first_time_kinematic;
+
+	set_active(p_snapshot.active);
+}
+
 void GodotBody3D::set_space(GodotSpace3D *p_space) {
 	if (get_space()) {
 		if (mass_properties_update_list.in_list()) {
@@ -448,11 +515,13 @@ void GodotBody3D::set_space(GodotSpace3D *p_space) {
 		if (direct_state_query_list.in_list()) {
 			get_space()->body_remove_from_state_query_list(&direct_state_query_list);
 		}
+		get_space()->island_remove_body(this);
 	}
 
 	_set_space(p_space);
 
 	if (get_space()) {
+		get_space()->island_add_body(this);
 		_mass_properties_changed();
 
 		if (active && !active_list.in_list()) {
@@ -473,12 +542,12 @@ bool GodotBody3D::is_axis_locked(PhysicsServer3D::BodyAxis p_axis) const {
 	return locked_axis & p_axis;
 }
 
-void GodotBody3D::integrate_forces(real_t p_step) {
+bool GodotBody3D::integrate_forces(real_t p_step) {
 	if (mode == PhysicsServer3D::BODY_MODE_STATIC) {
-		return;
+		return false;
 	}
 
-	ERR_FAIL_NULL(get_space());
+	ERR_FAIL_NULL_V(get_space(), false);
 
 	int ac = areas.size();
 
@@ -566,7 +635,7 @@ void GodotBody3D::integrate_forces(real_t p_step) {
 	// Add default gravity and damping from space area.
 	if (!stopped) {
 		GodotArea3D *default_area = get_space()->get_default_area();
-		ERR_FAIL_NULL(default_area);
+		ERR_FAIL_NULL_V(default_area, false);
 
 		if (!gravity_done) {
 			Vector3 default_gravity;
@@ -608,13 +677,9 @@ void GodotBody3D::integrate_forces(real_t p_step) {
 	prev_linear_velocity = linear_velocity;
 	prev_angular_velocity = angular_velocity;
 
-	Vector3 motion;
-	bool do_motion = false;
-
 	if (mode == PhysicsServer3D::BODY_MODE_KINEMATIC) {
 		//compute motion, angular and etc. velocities from prev transform
-		motion = new_transform.origin - get_transform().origin;
-		do_motion = true;
+		Vector3 motion = new_transform.origin - get_transform().origin;
 		linear_velocity = constant_linear_velocity + motion / p_step;
 
 		//compute a FAKE angular velocity, not so easy
@@ -625,43 +690,51 @@ void GodotBody3D::integrate_forces(real_t p_step) {
 		rot.get_axis_angle(axis, angle);
 		axis.normalize();
 		angular_velocity = constant_angular_velocity + axis * (angle / p_step);
-	} else {
-		if (!omit_force_integration) {
-			//overridden by direct state query
 
-			Vector3 force = gravity * mass + applied_force + constant_force;
-			Vector3 torque = applied_torque + constant_torque;
+		return false;
+	}
 
-			real_t damp = 1.0 - p_step * total_linear_damp;
+	//overridden by direct state query
+	return !omit_force_integration;
+}
 
-			if (damp < 0) { // reached zero in the given time
-				damp = 0;
-			}
+void GodotBody3D::apply_forces(real_t p_step) {
+	Vector3 force = gravity * mass + applied_force + constant_force;
+	Vector3 torque = applied_torque + constant_torque;
 
-			real_t angular_damp_new = 1.0 - p_step * total_angular_damp;
+	real_t damp = 1.0 - p_step * total_linear_damp;
 
-			if (angular_damp_new < 0) { // reached zero in the given time
-				angular_damp_new = 0;
-			}
+	if (damp < 0) { // reached zero in the given time
+		damp = 0;
+	}
 
-			linear_velocity *= damp;
-			angular_velocity *= angular_damp_new;
+	real_t angular_damp_new = 1.0 - p_step * total_angular_damp;
 
-			linear_velocity += _inv_mass * force * p_step;
-			angular_velocity += _inv_inertia_tensor.xform(torque) * p_step;
-		}
+	if (angular_damp_new < 0) { // reached zero in the given time
+		angular_damp_new = 0;
+	}
 
-		if (continuous_cd) {
-			motion = linear_velocity * p_step;
-			do_motion = true;
-		}
+	linear_velocity *= damp;
+	angular_velocity *= angular_damp_new;
+
+	linear_velocity += _inv_mass * force * p_step;
+	angular_velocity += _inv_inertia_tensor.xform(torque) * p_step;
+}
+
+void GodotBody3D::finish_integrate_forces(real_t p_step) {
+	if (mode == PhysicsServer3D::BODY_MODE_STATIC) {
+		return;
 	}
 
-	applied_force = Vector3();
-	applied_torque = Vector3();
+	Vector3 motion;
+	bool do_motion = false;
+
+	if (mode == PhysicsServer3D::BODY_MODE_KINEMATIC) {
+		motion = new_transform.origin - get_transform().origin;
+		do_motion = true;
+	}
 
-	biased_angular_velocity = Vector3();
-	biased_linear_velocity = Vector3();
+	reset_biased_velocities();
 
 	if (do_motion) { //shapes temporarily extend for raycast
 		_update_shapes_with_motion(motion);
@@ -677,7 +750,8 @@ void GodotBody3D::integrate_velocities(real_t p_step) {
 
 	ERR_FAIL_NULL(get_space());
 
-	if (fi_callback_data || body_state_callback.is_valid()) {
+	// Can be called once per solver substep.
+	if ((fi_callback_data || body_state_callback.is_valid()) && !direct_state_query_list.in_list()) {
 		get_space()->body_add_to_state_query_list(&direct_state_query_list);
 	}
 
@@ -736,6 +810,69 @@ void GodotBody3D::integrate_velocities(real_t p_step) {
 	_update_transform_dependent();
 }
 
+void GodotBody3D::acquire_states(GodotBodyStates3D *p_states, bool p_apply_forces) {
+	ERR_FAIL_NULL(p_states);
+	ERR_FAIL_COND_MSG(states, "Body already has a slot in body states.");
+
+	if (p_apply_forces) {
+		ERR_FAIL_COND_MSG(p_states->force_count != p_states->bodies.size(), "Bodies with forces must be added to the body states first.");
+		p_states->force.push_back(gravity * mass + applied_force + constant_force);
+		p_states->torque.push_back(applied_torque + constant_torque);
+		p_states->linear_damp.push_back(total_linear_damp);
+		p_states->angular_damp.push_back(total_angular_damp);
+		p_states->force_count++;
+	}
+
+	state_slot = p_states->bodies.size();
+	p_states->bodies.push_back(this);
+
+	p_states->inv_mass.push_back(_inv_mass);
+	p_states->inv_inertia_tensor.push_back(_inv_inertia_tensor);
+	p_states->center_of_mass_local.push_back(center_of_mass_local);
+	p_states->locked_axes.push_back(locked_axis);
+
+	p_states->transform.push_back(get_transform());
+	p_states->linear_velocity.push_back(linear_velocity);
+	p_states->angular_velocity.push_back(angular_velocity);
+	p_states->biased_linear_velocity.push_back(biased_linear_velocity);
+	p_states->biased_angular_velocity.push_back(biased_angular_velocity);
+
+	states = p_states;
+}
+
+void GodotBody3D::release_states() {
+	ERR_FAIL_NULL(states);
+
+	linear_velocity = states->linear_velocity[state_slot];
+	angular_velocity = states->angular_velocity[state_slot];
+	biased_linear_velocity = states->biased_linear_velocity[state_slot];
+	biased_angular_velocity = states->biased_angular_velocity[state_slot];
+	_inv_inertia_tensor = states->inv_inertia_tensor[state_slot];
+
+	states = nullptr;
+	state_slot = 0;
+}
+
+void GodotBody3D::set_integrated_transform(const Transform3D &p_transform) {
+	ERR_FAIL_NULL(get_space());
+
+	// Can be called once per solver substep.
+	if ((fi_callback_data || body_state_callback.is_valid()) && !direct_state_query_list.in_list()) {
+		get_space()->body_add_to_state_query_list(&direct_state_query_list);
+	}
+
+	for (int i = 0; i < 3; i++) {
+		if (is_axis_locked((PhysicsServer3D::BodyAxis)(1 << i))) {
+			new_transform.origin[i] = get_transform().origin[i];
+		}
+	}
+
+	_set_transform(p_transform);
+	_set_inv_transform(get_transform().inverse());
+
+	_update_transform_dependent();
+}
+
 void GodotBody3D::wakeup_neighbours() {
 	for (const KeyValue<GodotConstraint3D *, int> &E : constraint_map) {
 		const GodotConstraint3D *c = E.key;
@@ -32,11 +32,13 @@
 #define GODOT_BODY_3D_H
 
 #include "godot_area_3d.h"
+#include "godot_body_states_3d.h"
 #include "godot_collision_object_3d.h"
 
 #include "core/templates/vset.h"
 
 class GodotConstraint3D;
+struct GodotIsland3D;
 class GodotPhysicsDirectBodyState3D;
 
 class GodotBody3D : public GodotCollisionObject3D {
@@ -144,7 +146,24 @@ class GodotBody3D : public GodotCollisionObject3D {
 
 	GodotPhysicsDirectBodyState3D *direct_state = nullptr;
 
-	uint64_t island_step = 0;
+	GodotIsland3D *island = nullptr;
+
+	// While the body has a slot in the body states of a step, they hold its velocities, inverse mass and
+	// inverse inertia tensor instead of the members.
+	GodotBodyStates3D *states = nullptr;
+	uint32_t state_slot = 0;
+
+	_FORCE_INLINE_ Vector3 &_linear_velocity_ref() { return states ? states->linear_velocity[state_slot] : linear_velocity; }
+	_FORCE_INLINE_ const Vector3 &_linear_velocity_ref() const { return states ? states->linear_velocity[state_slot] : linear_velocity; }
+	_FORCE_INLINE_ Vector3 &_angular_velocity_ref() { return states ? states->angular_velocity[state_slot] : angular_velocity; }
+	_FORCE_INLINE_ const Vector3 &_angular_velocity_ref() const { return states ? states->angular_velocity[state_slot] : angular_velocity; }
+	_FORCE_INLINE_ Vector3 &_biased_linear_velocity_ref() { return states ? states->biased_linear_velocity[state_slot] : biased_linear_velocity; }
+	_FORCE_INLINE_ const Vector3 &_biased_linear_velocity_ref() const { return states ? states->biased_linear_velocity[state_slot] : biased_linear_velocity; }
+	_FORCE_INLINE_ Vector3 &_biased_angular_velocity_ref() { return states ? states->biased_angular_velocity[state_slot] : biased_angular_velocity; }
+	_FORCE_INLINE_ const Vector3 &_biased_angular_velocity_ref() const { return states ? states->biased_angular_velocity[state_slot] : biased_angular_velocity; }
+	_FORCE_INLINE_ real_t _inv_mass_value() const { return states ? states->inv_mass[state_slot] : _inv_mass; }
+	_FORCE_INLINE_ Basis &_inv_inertia_tensor_ref() { return states ? states->inv_inertia_tensor[state_slot] : _inv_inertia_tensor; }
+	_FORCE_INLINE_ const Basis &_inv_inertia_tensor_ref() const { return states ? states->inv_inertia_tensor[state_slot] : _inv_inertia_tensor; }
 
 	void _update_transform_dependent();
 
@@ -192,13 +211,13 @@ public:
 	_FORCE_INLINE_ bool has_exception(const RID &p_exception) const { return exceptions.has(p_exception); }
 	_FORCE_INLINE_ const VSet<RID> &get_exceptions() const { return exceptions; }
 
-	_FORCE_INLINE_ uint64_t get_island_step() const { return island_step; }
-	_FORCE_INLINE_ void set_island_step(uint64_t p_step) { island_step = p_step; }
+	_FORCE_INLINE_ GodotIsland3D *get_island() const { return island; }
+	_FORCE_INLINE_ void set_island(GodotIsland3D *p_island) { island = p_island; }
 
-	_FORCE_INLINE_ void add_constraint(GodotConstraint3D *p_constraint, int p_pos) { constraint_map[p_constraint] = p_pos; }
-	_FORCE_INLINE_ void remove_constraint(GodotConstraint3D *p_constraint) { constraint_map.erase(p_constraint); }
+	void add_constraint(GodotConstraint3D *p_constraint, int p_pos);
+	void remove_constraint(GodotConstraint3D *p_constraint);
 	const HashMap<GodotConstraint3D *, int> &get_constraint_map() const { return constraint_map; }
-	_FORCE_INLINE_ void clear_constraint_map() { constraint_map.clear(); }
+	void clear_constraint_map();
 
 	_FORCE_INLINE_ void set_omit_force_integration(bool p_omit_force_integration) { omit_force_integration = p_omit_force_integration; }
 	_FORCE_INLINE_ bool get_omit_force_integration() const { return omit_force_integration; }
@@ -208,44 +227,49 @@ public:
 	_FORCE_INLINE_ Vector3 get_center_of_mass_local() const { return center_of_mass_local; }
 	_FORCE_INLINE_ Vector3 xform_local_to_principal(const Vector3 &p_pos) const { return principal_inertia_axes_local.xform(p_pos - center_of_mass_local); }
 
-	_FORCE_INLINE_ void set_linear_velocity(const Vector3 &p_velocity) { linear_velocity = p_velocity; }
-	_FORCE_INLINE_ Vector3 get_linear_velocity() const { return linear_velocity; }
+	_FORCE_INLINE_ void set_linear_velocity(const Vector3 &p_velocity) { _linear_velocity_ref() = p_velocity; }
+	_FORCE_INLINE_ Vector3 get_linear_velocity() const { return _linear_velocity_ref(); }
 
-	_FORCE_INLINE_ void set_angular_velocity(const Vector3 &p_velocity) { angular_velocity = p_velocity; }
-	_FORCE_INLINE_ Vector3 get_angular_velocity() const { return angular_velocity; }
+	_FORCE_INLINE_ void set_angular_velocity(const Vector3 &p_velocity) { _angular_velocity_ref() = p_velocity; }
+	_FORCE_INLINE_ Vector3 get_angular_velocity() const { return _angular_velocity_ref(); }
 
 	_FORCE_INLINE_ Vector3 get_prev_linear_velocity() const { return prev_linear_velocity; }
 	_FORCE_INLINE_ Vector3 get_prev_angular_velocity() const { return prev_angular_velocity; }
 
-	_FORCE_INLINE_ const Vector3 &get_biased_linear_velocity() const { return biased_linear_velocity; }
-	_FORCE_INLINE_ const Vector3 &get_biased_angular_velocity() const { return biased_angular_velocity; }
+	_FORCE_INLINE_ const Vector3 &get_biased_linear_velocity() const { return _biased_linear_velocity_ref(); }
+	_FORCE_INLINE_ const Vector3 &get_biased_angular_velocity() const { return _biased_angular_velocity_ref(); }
+
+	_FORCE_INLINE_ void reset_biased_velocities() {
+		_biased_linear_velocity_ref() = Vector3();
+		_biased_angular_velocity_ref() = Vector3();
+	}
 
 	_FORCE_INLINE_ void apply_central_impulse(const Vector3 &p_impulse) {
-		linear_velocity += p_impulse * _inv_mass;
+		_linear_velocity_ref() += p_impulse * _inv_mass_value();
 	}
 
 	_FORCE_INLINE_ void apply_impulse(const Vector3 &p_impulse, const Vector3 &p_position = Vector3()) {
-		linear_velocity += p_impulse * _inv_mass;
-		angular_velocity += _inv_inertia_tensor.xform((p_position - center_of_mass).cross(p_impulse));
+		_linear_velocity_ref() += p_impulse * _inv_mass_value();
+		_angular_velocity_ref() += _inv_inertia_tensor_ref().xform((p_position - center_of_mass).cross(p_impulse));
 	}
 
 	_FORCE_INLINE_ void apply_torque_impulse(const Vector3 &p_impulse) {
-		angular_velocity += _inv_inertia_tensor.xform(p_impulse);
+		_angular_velocity_ref() += _inv_inertia_tensor_ref().xform(p_impulse);
 	}
 
 	_FORCE_INLINE_ void apply_bias_impulse(const Vector3 &p_impulse, const Vector3 &p_position = Vector3(), real_t p_max_delta_av = -1.0) {
-		biased_linear_velocity += p_impulse * _inv_mass;
+		_biased_linear_velocity_ref() += p_impulse * _inv_mass_value();
 		if (p_max_delta_av != 0.0) {
-			Vector3 delta_av = _inv_inertia_tensor.xform((p_position - center_of_mass).cross(p_impulse));
+			Vector3 delta_av = _inv_inertia_tensor_ref().xform((p_position - center_of_mass).cross(p_impulse));
 			if (p_max_delta_av > 0 && delta_av.length() > p_max_delta_av) {
 				delta_av = delta_av.normalized() * p_max_delta_av;
 			}
-			biased_angular_velocity += delta_av;
+			_biased_angular_velocity_ref() += delta_av;
 		}
 	}
 
 	_FORCE_INLINE_ void apply_bias_torque_impulse(const Vector3 &p_impulse) {
-		biased_angular_velocity += _inv_inertia_tensor.xform(p_impulse);
+		_biased_angular_velocity_ref() += _inv_inertia_tensor_ref().xform(p_impulse);
 	}
 
 	_FORCE_INLINE_ void apply_central_force(const Vector3 &p_force) {
@@ -299,6 +323,28 @@ public:
 	void set_state(PhysicsServer3D::BodyState p_state, const Variant &p_variant);
 	Variant get_state(PhysicsServer3D::BodyState p_state) const;
 
+	// Dynamic state carried between steps, copied as a flat record by space snapshots.
+	struct Snapshot {
+		uint64_t id = 0;
+		Transform3D transform;
+		Transform3D inv_transform;
+		Transform3D new_transform;
+		Vector3 linear_velocity;
+		Vector3 angular_velocity;
+		Vector3 prev_linear_velocity;
+		Vector3 prev_angular_velocity;
+		Vector3 applied_force;
+		Vector3 applied_torque;
+		Vector3 constant_force;
+		Vector3 constant_torque;
+		real_t still_time = 0.0;
+		bool active = false;
+		bool first_time_kinematic = false;
+	};
+
+	void save_snapshot(Snapshot &r_snapshot) const;
+	void load_snapshot(const Snapshot &p_snapshot);
+
 	_FORCE_INLINE_ void set_continuous_collision_detection(bool p_enable) { continuous_cd = p_enable; }
 	_FORCE_INLINE_ bool is_continuous_collision_detection_enabled() const { return continuous_cd; }
 
@@ -307,20 +353,38 @@ public:
 	void update_mass_properties();
 	void reset_mass_properties();
 
-	_FORCE_INLINE_ real_t get_inv_mass() const { return _inv_mass; }
+	_FORCE_INLINE_ real_t get_inv_mass() const { return _inv_mass_value(); }
 	_FORCE_INLINE_ const Vector3 &get_inv_inertia() const { return _inv_inertia; }
-	_FORCE_INLINE_ const Basis &get_inv_inertia_tensor() const { return _inv_inertia_tensor; }
+	_FORCE_INLINE_ const Basis &get_inv_inertia_tensor() const { return _inv_inertia_tensor_ref(); }
 	_FORCE_INLINE_ real_t get_friction() const { return friction; }
 	_FORCE_INLINE_ real_t get_bounce() const { return bounce; }
 
 	void set_axis_lock(PhysicsServer3D::BodyAxis p_axis, bool lock);
 	bool is_axis_locked(PhysicsServer3D::BodyAxis p_axis) const;
 
-	void integrate_forces(real_t p_step);
+	// Computes gravity and damping, returns true when forces have to be applied to the velocities with apply_forces().
+	bool integrate_forces(real_t p_step);
+	// Applies damping and forces to the velocities, once per solver substep.
+	void apply_forces(real_t p_step);
+	void finish_integrate_forces(real_t p_step);
 	void integrate_velocities(real_t p_step);
 
+	// Gives the hot state of the body a slot in the body states of the step, the solvers work on it there
+	// until release_states(). Bodies with forces to apply must be added first.
+	void acquire_states(GodotBodyStates3D *p_states, bool p_apply_forces);
+	void release_states();
+	_FORCE_INLINE_ const GodotBodyStates3D *get_states() const { return states; }
+	_FORCE_INLINE_ uint32_t get_state_slot() const { return state_slot; }
+	// Moves the body to the transform integrated over its body states, in place of integrate_velocities().
+	void set_integrated_transform(const Transform3D &p_transform);
+
+	_FORCE_INLINE_ void reset_applied_forces() {
+		applied_force = Vector3();
+		applied_torque = Vector3();
+	}
+
 	_FORCE_INLINE_ Vector3 get_velocity_in_local_point(const Vector3 &rel_pos) const {
-		return linear_velocity + angular_velocity.cross(rel_pos - center_of_mass);
+		return _linear_velocity_ref() + _angular_velocity_ref().cross(rel_pos - center_of_mass);
 	}
 
 	_FORCE_INLINE_ real_t compute_impulse_denominator(const Vector3 &p_pos, const Vector3 &p_normal) const {
@@ -328,13 +392,13 @@ public:
 
 		Vector3 c0 = (r0).cross(p_normal);
 
-		Vector3 vec = (_inv_inertia_tensor.xform_inv(c0)).cross(r0);
+		Vector3 vec = (_inv_inertia_tensor_ref().xform_inv(c0)).cross(r0);
 
-		return _inv_mass + p_normal.dot(vec);
+		return _inv_mass_value() + p_normal.dot(vec);
 	}
 
 	_FORCE_INLINE_ real_t compute_angular_impulse_denominator(const Vector3 &p_axis) const {
-		return p_axis.dot(_inv_inertia_tensor.xform_inv(p_axis));
+		return p_axis.dot(_inv_inertia_tensor_ref().xform_inv(p_axis));
 	}
 
 	//void simulate_motion(const Transform3D& p_xform,real_t p_step);
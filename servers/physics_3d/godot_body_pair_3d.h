@@ -61,7 +61,6 @@ protected:
 
 	Vector3 sep_axis;
 	bool collided = false;
-	bool check_ccd = false;
 
 	GodotSpace3D *space = nullptr;
 
@@ -102,13 +101,35 @@ class GodotBodyPair3D : public GodotBodyContact3D {
 	void contact_added_callback(const Vector3 &p_point_A, int p_index_A, const Vector3 &p_point_B, int p_index_B, const Vector3 &normal);
 
 	void validate_contacts();
-	bool _test_ccd(real_t p_step, GodotBody3D *p_A, int p_shape_A, const Transform3D &p_xform_A, GodotBody3D *p_B, int p_shape_B, const Transform3D &p_xform_B);
 
 public:
+	// Contact state kept between steps, copied as a flat record by space snapshots.
+	struct Snapshot {
+		uint64_t id_A = 0;
+		uint64_t id_B = 0;
+		int32_t shape_A = 0;
+		int32_t shape_B = 0;
+		int32_t contact_count = 0;
+		Vector3 sep_axis;
+		Contact contacts[MAX_CONTACTS];
+	};
+
+	_FORCE_INLINE_ GodotBody3D *get_body_A() const { return A; }
+	_FORCE_INLINE_ GodotBody3D *get_body_B() const { return B; }
+	_FORCE_INLINE_ int get_shape_A() const { return shape_A; }
+	_FORCE_INLINE_ int get_shape_B() const { return shape_B; }
+
+	void save_snapshot(Snapshot &r_snapshot) const;
+	void load_snapshot(const Snapshot &p_snapshot);
+	void reset_contacts();
+
 	virtual bool setup(real_t p_step) override;
 	virtual bool pre_solve(real_t p_step) override;
 	virtual void solve(real_t p_step) override;
 
+	virtual uint64_t get_order_key() const override { return ((uint64_t)shape_A << 32) | (uint32_t)shape_B; }
+	virtual bool is_body_pair() const override { return true; }
+
 	GodotBodyPair3D(GodotBody3D *p_A, int p_shape_A, GodotBody3D *p_B, int p_shape_B);
 	~GodotBodyPair3D();
 };
@@ -137,6 +158,8 @@ public:
 	virtual bool pre_solve(real_t p_step) override;
 	virtual void solve(real_t p_step) override;
 
+	virtual uint64_t get_order_key() const override { return ((uint64_t)hash_murmur3_one_64(soft_body->get_self().get_id()) << 32) | (uint32_t)body_shape; }
+
 	virtual GodotSoftBody3D *get_soft_body_ptr(int p_index) const override { return soft_body; }
 	virtual int get_soft_body_count() const override { return 1; }
 
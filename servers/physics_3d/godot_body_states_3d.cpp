@@ -0,0 +1,119 @@
+/**************************************************************************/
+/*  godot_body_states_3d.cpp                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "godot_body_states_3d.h"
+
+#include "godot_body_3d.h"
+
+void GodotBodyStates3D::release() {
+	for (GodotBody3D *body : bodies) {
+		body->release_states();
+	}
+
+	bodies.clear();
+	force_count = 0;
+
+	force.clear();
+	torque.clear();
+	linear_damp.clear();
+	angular_damp.clear();
+
+	inv_mass.clear();
+	inv_inertia_tensor.clear();
+	center_of_mass_local.clear();
+	locked_axes.clear();
+
+	transform.clear();
+	linear_velocity.clear();
+	angular_velocity.clear();
+	biased_linear_velocity.clear();
+	biased_angular_velocity.clear();
+}
+
+void GodotBodyStates3D::apply_forces(real_t p_step) {
+	for (uint32_t i = 0; i < force_count; i++) {
+		real_t damp = 1.0 - p_step * linear_damp[i];
+		if (damp < 0) { // reached zero in the given time
+			damp = 0;
+		}
+
+		real_t angular_damp_new = 1.0 - p_step * angular_damp[i];
+		if (angular_damp_new < 0) { // reached zero in the given time
+			angular_damp_new = 0;
+		}
+
+		linear_velocity[i] *= damp;
+		angular_velocity[i] *= angular_damp_new;
+
+		linear_velocity[i] += inv_mass[i] * force[i] * p_step;
+		angular_velocity[i] += inv_inertia_tensor[i].xform(torque[i]) * p_step;
+	}
+}
+
+void GodotBodyStates3D::integrate_velocities(real_t p_step) {
+	for (uint32_t i = 0; i < bodies.size(); i++) {
+		const uint16_t locked = locked_axes[i];
+		if (locked) {
+			for (int j = 0; j < 3; j++) {
+				if (locked & (1 << j)) {
+					linear_velocity[i][j] = 0;
+					biased_linear_velocity[i][j] = 0;
+				}
+				if (locked & (1 << (j + 3))) {
+					angular_velocity[i][j] = 0;
+					biased_angular_velocity[i][j] = 0;
+				}
+			}
+		}
+
+		Vector3 total_angular_velocity = angular_velocity[i] + biased_angular_velocity[i];
+		real_t ang_vel = total_angular_velocity.length();
+		Transform3D &transform_new = transform[i];
+
+		if (!Math::is_zero_approx(ang_vel)) {
+			Vector3 ang_vel_axis = total_angular_velocity / ang_vel;
+			Basis rot(ang_vel_axis, ang_vel * p_step);
+			Basis identity3(1, 0, 0, 0, 1, 0, 0, 0, 1);
+			transform_new.origin += ((identity3 - rot) * transform_new.basis).xform(center_of_mass_local[i]);
+			transform_new.basis = rot * transform_new.basis;
+			transform_new.orthonormalize();
+		}
+
+		Vector3 total_linear_velocity = linear_velocity[i] + biased_linear_velocity[i];
+		transform_new.origin += total_linear_velocity * p_step;
+	}
+}
+
+void GodotBodyStates3D::reset_biased_velocities() {
+	for (uint32_t i = 0; i < bodies.size(); i++) {
+		biased_linear_velocity[i] = Vector3();
+		biased_angular_velocity[i] = Vector3();
+	}
+}
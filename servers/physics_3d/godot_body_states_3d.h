@@ -0,0 +1,73 @@
+/**************************************************************************/
+/*  godot_body_states_3d.h                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GODOT_BODY_STATES_3D_H
+#define GODOT_BODY_STATES_3D_H
+
+#include "core/math/transform_3d.h"
+#include "core/templates/local_vector.h"
+
+class GodotBody3D;
+
+// Hot state of the active rigid bodies of a step, one array per field indexed by the slot of the body, so
+// forces and velocities are integrated in linear loops. While a body has a slot, the arrays are its storage
+// of record: the solvers read and write them through the body accessors, until the step releases the bodies.
+struct GodotBodyStates3D {
+	LocalVector<GodotBody3D *> bodies;
+	// The first bodies have forces applied, the arrays of forces and damping only cover them.
+	uint32_t force_count = 0;
+
+	LocalVector<Vector3> force;
+	LocalVector<Vector3> torque;
+	LocalVector<real_t> linear_damp;
+	LocalVector<real_t> angular_damp;
+
+	LocalVector<real_t> inv_mass;
+	LocalVector<Basis> inv_inertia_tensor;
+	LocalVector<Vector3> center_of_mass_local;
+	LocalVector<uint16_t> locked_axes;
+
+	LocalVector<Transform3D> transform;
+	LocalVector<Vector3> linear_velocity;
+	LocalVector<Vector3> angular_velocity;
+	LocalVector<Vector3> biased_linear_velocity;
+	LocalVector<Vector3> biased_angular_velocity;
+
+	// Gives the velocities back to the bodies and clears their slots.
+	void release();
+	// Same arithmetic as GodotBody3D::apply_forces().
+	void apply_forces(real_t p_step);
+	// Same arithmetic as GodotBody3D::integrate_velocities() for rigid bodies, the bodies are moved to the
+	// integrated transforms by GodotBody3D::set_integrated_transform().
+	void integrate_velocities(real_t p_step);
+	void reset_biased_velocities();
+};
+
+#endif // GODOT_BODY_STATES_3D_H
@@ -33,6 +33,7 @@
 
 #include "core/math/aabb.h"
 #include "core/math/math_funcs.h"
+#include "core/templates/local_vector.h"
 
 class GodotCollisionObject3D;
 
@@ -60,10 +61,20 @@ public:
 	virtual int cull_point(const Vector3 &p_point, GodotCollisionObject3D **p_results, int p_max_results, int *p_result_indices = nullptr) = 0;
 	virtual int cull_segment(const Vector3 &p_from, const Vector3 &p_to, GodotCollisionObject3D **p_results, int p_max_results, int *p_result_indices = nullptr) = 0;
 	virtual int cull_aabb(const AABB &p_aabb, GodotCollisionObject3D **p_results, int p_max_results, int *p_result_indices = nullptr) = 0;
+	virtual int cull_swept_aabb(const AABB &p_aabb, const Vector3 &p_motion, GodotCollisionObject3D **p_results, int p_max_results, int *p_result_indices = nullptr) = 0;
+
+	// Read-only version of cull_segment() that can run on several threads at once, using r_scratch as working memory.
+	virtual int cull_segment_concurrent(const Vector3 &p_from, const Vector3 &p_to, GodotCollisionObject3D **p_results, int p_max_results, int *p_result_indices, LocalVector<uint32_t, uint32_t, true> &r_scratch) = 0;
+	// Same for cull_aabb().
+	virtual int cull_aabb_concurrent(const AABB &p_aabb, GodotCollisionObject3D **p_results, int p_max_results, int *p_result_indices, LocalVector<uint32_t, uint32_t, true> &r_scratch) = 0;
 
 	virtual void set_pair_callback(PairCallback p_pair_callback, void *p_userdata) = 0;
 	virtual void set_unpair_callback(UnpairCallback p_unpair_callback, void *p_userdata) = 0;
 
+	virtual void set_threaded_pairing(bool p_enable) = 0;
+	// Margin added around AABBs when pairing, so small motions don't unpair and pair the same objects again.
+	virtual void set_pairing_expansion(real_t p_expansion) = 0;
+
 	virtual void update() = 0;
 
 	virtual ~GodotBroadPhase3D();
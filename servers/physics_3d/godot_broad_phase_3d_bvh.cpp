@@ -82,10 +82,22 @@ int GodotBroadPhase3DBVH::cull_segment(const Vector3 &p_from, const Vector3 &p_t
 	return bvh.cull_segment(p_from, p_to, p_results, p_max_results, nullptr, 0xFFFFFFFF, p_result_indices);
 }
 
+int GodotBroadPhase3DBVH::cull_segment_concurrent(const Vector3 &p_from, const Vector3 &p_to, GodotCollisionObject3D **p_results, int p_max_results, int *p_result_indices, LocalVector<uint32_t, uint32_t, true> &r_scratch) {
+	return bvh.cull_segment_concurrent(p_from, p_to, p_results, p_max_results, nullptr, r_scratch, 0xFFFFFFFF, p_result_indices);
+}
+
+int GodotBroadPhase3DBVH::cull_aabb_concurrent(const AABB &p_aabb, GodotCollisionObject3D **p_results, int p_max_results, int *p_result_indices, LocalVector<uint32_t, uint32_t, true> &r_scratch) {
+	return bvh.cull_aabb_concurrent(p_aabb, p_results, p_max_results, nullptr, r_scratch, 0xFFFFFFFF, p_result_indices);
+}
+
 int GodotBroadPhase3DBVH::cull_aabb(const AABB &p_aabb, GodotCollisionObject3D **p_results, int p_max_results, int *p_result_indices) {
 	return bvh.cull_aabb(p_aabb, p_results, p_max_results, nullptr, 0xFFFFFFFF, p_result_indices);
 }
 
+int GodotBroadPhase3DBVH::cull_swept_aabb(const AABB &p_aabb, const Vector3 &p_motion, GodotCollisionObject3D **p_results, int p_max_results, int *p_result_indices) {
+	return bvh.cull_swept_aabb(p_aabb, p_motion, p_results, p_max_results, nullptr, 0xFFFFFFFF, p_result_indices);
+}
+
 void *GodotBroadPhase3DBVH::_pair_callback(void *self, uint32_t p_A, GodotCollisionObject3D *p_object_A, int subindex_A, uint32_t p_B, GodotCollisionObject3D *p_object_B, int subindex_B) {
 	GodotBroadPhase3DBVH *bpo = static_cast<GodotBroadPhase3DBVH *>(self);
 	if (!bpo->pair_callback) {
@@ -114,6 +126,14 @@ void GodotBroadPhase3DBVH::set_unpair_callback(UnpairCallback p_unpair_callback,
 	unpair_userdata = p_userdata;
 }
 
+void GodotBroadPhase3DBVH::set_threaded_pairing(bool p_enable) {
+	bvh.params_set_threaded_pairing(p_enable);
+}
+
+void GodotBroadPhase3DBVH::set_pairing_expansion(real_t p_expansion) {
+	bvh.params_set_pairing_expansion(p_expansion);
+}
+
 void GodotBroadPhase3DBVH::update() {
 	bvh.update();
 }
@@ -75,6 +75,8 @@ private:
 	GodotSpace3D *space = nullptr;
 	Transform3D transform;
 	Transform3D inv_transform;
+	// Changes with the transform and the shapes, so results cached against them know when to be computed again.
+	uint32_t transform_version = 0;
 	bool _static = true;
 
 	SelfList<GodotCollisionObject3D> pending_shape_update_list;
@@ -92,6 +94,7 @@ protected:
 #endif
 
 		transform = p_transform;
+		transform_version++;
 		if (p_update_shapes) {
 			_update_shapes();
 		}
@@ -143,6 +146,7 @@ public:
 
 	_FORCE_INLINE_ const Transform3D &get_transform() const { return transform; }
 	_FORCE_INLINE_ const Transform3D &get_inv_transform() const { return inv_transform; }
+	_FORCE_INLINE_ uint32_t get_transform_version() const { return transform_version; }
 	_FORCE_INLINE_ GodotSpace3D *get_space() const { return space; }
 
 	_FORCE_INLINE_ void set_ray_pickable(bool p_enable) { ray_pickable = p_enable; }
@@ -587,3 +587,121 @@ bool GodotCollisionSolver3D::solve_distance(const GodotShape3D *p_shape_A, const
 		return gjk_epa_calculate_distance(p_shape_A, p_transform_A, p_shape_B, p_transform_B, r_point_A, r_point_B); //should pass sepaxis..
 	}
 }
+
+#define TOI_MAX_ITERATIONS 32
+
+bool GodotCollisionSolver3D::solve_toi_convex(const GodotShape3D *p_shape_A, const Transform3D &p_transform_A, const Vector3 &p_motion_A, const GodotShape3D *p_shape_B, const Transform3D &p_transform_B, real_t p_tolerance, real_t &r_toi, Vector3 &r_normal) {
+	Transform3D xform_A = p_transform_A;
+	real_t toi = 0.0;
+	real_t last_toi = 0.0;
+	real_t last_dist = 0.0;
+	Vector3 last_sep;
+
+	for (int i = 0; i < TOI_MAX_ITERATIONS; i++) {
+		xform_A.origin = p_transform_A.origin + p_motion_A * toi;
+
+		Vector3 point_A, point_B;
+		if (!solve_distance(p_shape_A, xform_A, p_shape_B, p_transform_B, point_A, point_B, AABB())) {
+			// Overlapping, can only happen on the first iteration unless the tolerance is tiny.
+			r_toi = toi;
+			r_normal = -p_motion_A.normalized();
+			return true;
+		}
+
+		Vector3 sep = point_B - point_A;
+		real_t dist = sep.length();
+		if (dist <= p_tolerance) {
+			r_toi = toi;
+			r_normal = dist > CMP_EPSILON ? -sep / dist : -p_motion_A.normalized();
+			return true;
+		}
+
+		// Both shapes are convex and only A translates, so the distance can't shrink faster
+		// than the motion projected on the direction between the closest points.
+		real_t closing = p_motion_A.dot(sep) / dist;
+		if (closing <= CMP_EPSILON) {
+			return false; // Moving apart.
+		}
+
+		last_toi = toi;
+		last_dist = dist;
+		last_sep = sep;
+		toi += (dist - p_tolerance * 0.5) / closing;
+		if (toi > 1.0) {
+			return false;
+		}
+	}
+
+	// Not converged (grazing contact), only report a hit when the last measured step was almost touching.
+	if (last_dist > p_tolerance * 4.0) {
+		return false;
+	}
+	r_toi = last_toi;
+	r_normal = -last_sep / last_dist;
+	return true;
+}
+
+struct _ConcaveTOIInfo {
+	const GodotShape3D *shape_A = nullptr;
+	const Transform3D *transform_A = nullptr;
+	const Vector3 *motion_A = nullptr;
+	const Transform3D *transform_B = nullptr;
+	real_t tolerance = 0.0;
+	bool hit = false;
+	real_t toi = 1.0;
+	Vector3 normal;
+};
+
+bool GodotCollisionSolver3D::concave_toi_callback(void *p_userdata, GodotShape3D *p_convex) {
+	_ConcaveTOIInfo &tinfo = *(static_cast<_ConcaveTOIInfo *>(p_userdata));
+
+	real_t toi;
+	Vector3 normal;
+	if (solve_toi_convex(tinfo.shape_A, *tinfo.transform_A, *tinfo.motion_A, p_convex, *tinfo.transform_B, tinfo.tolerance, toi, normal)) {
+		if (!tinfo.hit || toi < tinfo.toi) {
+			tinfo.hit = true;
+			tinfo.toi = toi;
+			tinfo.normal = normal;
+		}
+	}
+
+	return false;
+}
+
+bool GodotCollisionSolver3D::solve_toi(const GodotShape3D *p_shape_A, const Transform3D &p_transform_A, const Vector3 &p_motion_A, const GodotShape3D *p_shape_B, const Transform3D &p_transform_B, real_t p_tolerance, real_t &r_toi, Vector3 *r_normal) {
+	ERR_FAIL_COND_V(p_shape_A->is_concave(), false);
+	if (p_shape_A->get_type() == PhysicsServer3D::SHAPE_WORLD_BOUNDARY || p_motion_A.length_squared() < CMP_EPSILON2) {
+		return false;
+	}
+
+	Vector3 normal;
+
+	if (p_shape_B->is_concave()) {
+		// Advance against every face around the sweep on its own, keeping the earliest hit.
+		AABB sweep_aabb = p_transform_A.xform(p_shape_A->get_aabb());
+		sweep_aabb = sweep_aabb.merge(AABB(sweep_aabb.position + p_motion_A, sweep_aabb.size));
+		sweep_aabb = sweep_aabb.grow(p_tolerance);
+
+		_ConcaveTOIInfo tinfo;
+		tinfo.shape_A = p_shape_A;
+		tinfo.transform_A = &p_transform_A;
+		tinfo.motion_A = &p_motion_A;
+		tinfo.transform_B = &p_transform_B;
+		tinfo.tolerance = p_tolerance;
+
+		const GodotConcaveShape3D *concave_B = static_cast<const GodotConcaveShape3D *>(p_shape_B);
+		concave_B->cull(p_transform_B.affine_inverse().xform(sweep_aabb), concave_toi_callback, &tinfo, false);
+		if (!tinfo.hit) {
+			return false;
+		}
+		r_toi = tinfo.toi;
+		normal = tinfo.normal;
+	} else if (!solve_toi_convex(p_shape_A, p_transform_A, p_motion_A, p_shape_B, p_transform_B, p_tolerance, r_toi, normal)) {
+		return false;
+	}
+
+	if (r_normal) {
+		*r_normal = normal;
+	}
+	return true;
+}
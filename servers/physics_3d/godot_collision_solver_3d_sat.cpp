@@ -612,6 +612,111 @@ static void _generate_contacts_from_supports(const Vector3 *p_points_A, int p_po
 	contacts_func(points_A, pointcount_A, points_B, pointcount_B, p_callback);
 }
 
+// Candidate separating axes stored as structure of arrays, so both shapes can
+// be projected on all of them in tight loops the compiler is able to vectorize,
+// instead of going through a virtual project_range() call per axis.
+struct _SATAxisBatch {
+	static const int MAX_AXES = 24;
+
+	real_t x[MAX_AXES];
+	real_t y[MAX_AXES];
+	real_t z[MAX_AXES];
+	int count = 0;
+
+	_FORCE_INLINE_ void add_axis(const Vector3 &p_axis) {
+		if (p_axis.is_zero_approx()) {
+			// strange case, try an upwards separator
+			x[count] = 0.0;
+			y[count] = 1.0;
+			z[count] = 0.0;
+		} else {
+			x[count] = p_axis.x;
+			y[count] = p_axis.y;
+			z[count] = p_axis.z;
+		}
+		count++;
+	}
+
+	_FORCE_INLINE_ void clear() {
+		count = 0;
+	}
+
+	_FORCE_INLINE_ Vector3 get_axis(int p_index) const {
+		return Vector3(x[p_index], y[p_index], z[p_index]);
+	}
+};
+
+// Batched versions of project_range(), they must produce the exact same results.
+
+static _FORCE_INLINE_ void _project_range_batch(const GodotBoxShape3D *p_box, const Transform3D &p_transform, const _SATAxisBatch &p_batch, real_t *r_min, real_t *r_max) {
+	const Basis &basis = p_transform.basis;
+	const Vector3 &origin = p_transform.origin;
+	const Vector3 half_extents = p_box->get_half_extents();
+	const int count = p_batch.count;
+
+	for (int i = 0; i < count; i++) {
+		// no matter the angle, the box is mirrored anyway
+		real_t local_x = (basis.rows[0][0] * p_batch.x[i]) + (basis.rows[1][0] * p_batch.y[i]) + (basis.rows[2][0] * p_batch.z[i]);
+		real_t local_y = (basis.rows[0][1] * p_batch.x[i]) + (basis.rows[1][1] * p_batch.y[i]) + (basis.rows[2][1] * p_batch.z[i]);
+		real_t local_z = (basis.rows[0][2] * p_batch.x[i]) + (basis.rows[1][2] * p_batch.y[i]) + (basis.rows[2][2] * p_batch.z[i]);
+
+		real_t length = Math::abs(local_x) * half_extents.x + Math::abs(local_y) * half_extents.y + Math::abs(local_z) * half_extents.z;
+		real_t distance = p_batch.x[i] * origin.x + p_batch.y[i] * origin.y + p_batch.z[i] * origin.z;
+
+		r_min[i] = distance - length;
+		r_max[i] = distance + length;
+	}
+}
+
+static _FORCE_INLINE_ void _project_range_batch(const GodotCapsuleShape3D *p_capsule, const Transform3D &p_transform, const _SATAxisBatch &p_batch, real_t *r_min, real_t *r_max) {
+	const Basis &basis = p_transform.basis;
+	const Vector3 &origin = p_transform.origin;
+	const real_t radius = p_capsule->get_radius();
+	const real_t h = p_capsule->get_height() * 0.5 - radius;
+	const int count = p_batch.count;
+
+	// The axes in local space, and their squared lengths for the normalization below.
+	real_t local_x[_SATAxisBatch::MAX_AXES];
+	real_t local_y[_SATAxisBatch::MAX_AXES];
+	real_t local_z[_SATAxisBatch::MAX_AXES];
+	real_t length_squared[_SATAxisBatch::MAX_AXES];
+	for (int i = 0; i < count; i++) {
+		local_x[i] = (basis.rows[0][0] * p_batch.x[i]) + (basis.rows[1][0] * p_batch.y[i]) + (basis.rows[2][0] * p_batch.z[i]);
+		local_y[i] = (basis.rows[0][1] * p_batch.x[i]) + (basis.rows[1][1] * p_batch.y[i]) + (basis.rows[2][1] * p_batch.z[i]);
+		local_z[i] = (basis.rows[0][2] * p_batch.x[i]) + (basis.rows[1][2] * p_batch.y[i]) + (basis.rows[2][2] * p_batch.z[i]);
+		length_squared[i] = local_x[i] * local_x[i] + local_y[i] * local_y[i] + local_z[i] * local_z[i];
+	}
+
+	// Kept in its own loop, the square root doesn't vectorize without -fno-math-errno but the loops around it do.
+	real_t length[_SATAxisBatch::MAX_AXES];
+	for (int i = 0; i < count; i++) {
+		length[i] = Math::sqrt(length_squared[i]);
+	}
+
+	for (int i = 0; i < count; i++) {
+		// Same as Vector3::normalized(), zero length axes give a zero vector.
+		// Selecting instead of branching around the division keeps the loop vectorizable.
+		const bool is_zero = length_squared[i] == 0;
+		const real_t divisor = is_zero ? 1 : length[i];
+		const real_t scale = is_zero ? 0 : 1;
+		const real_t n_x = local_x[i] / divisor * scale * radius;
+		const real_t n_y_radius = local_y[i] / divisor * scale * radius;
+		const real_t n_y = n_y_radius + ((n_y_radius > 0) ? h : -h);
+		const real_t n_z = local_z[i] / divisor * scale * radius;
+
+		// The support points n and -n in world space, projected on the axis.
+		const real_t max_x = (basis.rows[0][0] * n_x + basis.rows[0][1] * n_y + basis.rows[0][2] * n_z) + origin.x;
+		const real_t max_y = (basis.rows[1][0] * n_x + basis.rows[1][1] * n_y + basis.rows[1][2] * n_z) + origin.y;
+		const real_t max_z = (basis.rows[2][0] * n_x + basis.rows[2][1] * n_y + basis.rows[2][2] * n_z) + origin.z;
+		const real_t min_x = (basis.rows[0][0] * -n_x + basis.rows[0][1] * -n_y + basis.rows[0][2] * -n_z) + origin.x;
+		const real_t min_y = (basis.rows[1][0] * -n_x + basis.rows[1][1] * -n_y + basis.rows[1][2] * -n_z) + origin.y;
+		const real_t min_z = (basis.rows[2][0] * -n_x + basis.rows[2][1] * -n_y + basis.rows[2][2] * -n_z) + origin.z;
+
+		r_max[i] = p_batch.x[i] * max_x + p_batch.y[i] * max_y + p_batch.z[i] * max_z;
+		r_min[i] = p_batch.x[i] * min_x + p_batch.y[i] * min_y + p_batch.z[i] * min_z;
+	}
+}
+
 template <typename ShapeA, typename ShapeB, bool withMargin = false>
 class SeparatorAxisTest {
 	const ShapeA *shape_A = nullptr;
@@ -661,6 +766,63 @@ public:
 		min_B -= (min_A + max_A) * 0.5;
 		max_B -= (min_A + max_A) * 0.5;
 
+		return _test_axis_range(axis, min_B, max_B);
+	}
+
+	// Tests all the axes of the batch, with the same outcome as calling
+	// test_axis() on each of them in order.
+	_FORCE_INLINE_ bool test_axis_batch(const _SATAxisBatch &p_batch) {
+		real_t min_A[_SATAxisBatch::MAX_AXES];
+		real_t max_A[_SATAxisBatch::MAX_AXES];
+		real_t min_B[_SATAxisBatch::MAX_AXES];
+		real_t max_B[_SATAxisBatch::MAX_AXES];
+
+		_project_range_batch(shape_A, *transform_A, p_batch, min_A, max_A);
+		_project_range_batch(shape_B, *transform_B, p_batch, min_B, max_B);
+
+		const int count = p_batch.count;
+
+		for (int i = 0; i < count; i++) {
+			if (withMargin) {
+				min_A[i] -= margin_A;
+				max_A[i] += margin_A;
+				min_B[i] -= margin_B;
+				max_B[i] += margin_B;
+			}
+
+			min_B[i] -= (max_A[i] - min_A[i]) * 0.5;
+			max_B[i] += (max_A[i] - min_A[i]) * 0.5;
+
+			min_B[i] -= (min_A[i] + max_A[i]) * 0.5;
+			max_B[i] -= (min_A[i] + max_A[i]) * 0.5;
+		}
+
+		for (int i = 0; i < count; i++) {
+			if (!_test_axis_range(p_batch.get_axis(i), min_B[i], max_B[i])) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	template <bool batched>
+	_FORCE_INLINE_ bool test_axes(const _SATAxisBatch &p_batch) {
+		if (batched) {
+			return test_axis_batch(p_batch);
+		}
+
+		for (int i = 0; i < p_batch.count; i++) {
+			if (!test_axis(p_batch.get_axis(i))) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	// Takes the range of B relative to the center of A, expanded by the extent of A.
+	_FORCE_INLINE_ bool _test_axis_range(const Vector3 &axis, real_t min_B, real_t max_B) {
 		if (min_B > 0.0 || max_B < 0.0) {
 			separator_axis = axis;
 			return false; // doesn't contain 0
@@ -1068,7 +1230,7 @@ static void _collision_sphere_face(const GodotShape3D *p_a, const Transform3D &p
 	separator.generate_contacts();
 }
 
-template <bool withMargin>
+template <bool withMargin, bool batchedAxes = true>
 static void _collision_box_box(const GodotShape3D *p_a, const Transform3D &p_transform_a, const GodotShape3D *p_b, const Transform3D &p_transform_b, _CollectorCallback *p_collector, real_t p_margin_a, real_t p_margin_b) {
 	const GodotBoxShape3D *box_A = static_cast<const GodotBoxShape3D *>(p_a);
 	const GodotBoxShape3D *box_B = static_cast<const GodotBoxShape3D *>(p_b);
@@ -1079,27 +1241,27 @@ static void _collision_box_box(const GodotShape3D *p_a, const Transform3D &p_tra
 		return;
 	}
 
+	_SATAxisBatch axes;
+
 	// test faces of A
 
 	for (int i = 0; i < 3; i++) {
-		Vector3 axis = p_transform_a.basis.get_column(i).normalized();
-
-		if (!separator.test_axis(axis)) {
-			return;
-		}
+		axes.add_axis(p_transform_a.basis.get_column(i).normalized());
 	}
 
 	// test faces of B
 
 	for (int i = 0; i < 3; i++) {
-		Vector3 axis = p_transform_b.basis.get_column(i).normalized();
+		axes.add_axis(p_transform_b.basis.get_column(i).normalized());
+	}
 
-		if (!separator.test_axis(axis)) {
-			return;
-		}
+	if (!separator.template test_axes<batchedAxes>(axes)) {
+		return;
 	}
 
 	// test combined edges
+
+	axes.clear();
 	for (int i = 0; i < 3; i++) {
 		for (int j = 0; j < 3; j++) {
 			Vector3 axis = p_transform_a.basis.get_column(i).cross(p_transform_b.basis.get_column(j));
@@ -1109,15 +1271,19 @@ static void _collision_box_box(const GodotShape3D *p_a, const Transform3D &p_tra
 			}
 			axis.normalize();
 
-			if (!separator.test_axis(axis)) {
-				return;
-			}
+			axes.add_axis(axis);
 		}
 	}
 
+	if (!separator.template test_axes<batchedAxes>(axes)) {
+		return;
+	}
+
 	if (withMargin) {
 		//add endpoint test between closest vertices and edges
 
+		axes.clear();
+
 		// calculate closest point to sphere
 
 		Vector3 ab_vec = p_transform_b.origin - p_transform_a.origin;
@@ -1140,9 +1306,7 @@ static void _collision_box_box(const GodotShape3D *p_a, const Transform3D &p_tra
 
 		Vector3 axis_ab = (support_a - support_b);
 
-		if (!separator.test_axis(axis_ab.normalized())) {
-			return;
-		}
+		axes.add_axis(axis_ab.normalized());
 
 		//now try edges, which become cylinders!
 
@@ -1150,23 +1314,23 @@ static void _collision_box_box(const GodotShape3D *p_a, const Transform3D &p_tra
 			//a ->b
 			Vector3 axis_a = p_transform_a.basis.get_column(i);
 
-			if (!separator.test_axis(axis_ab.cross(axis_a).cross(axis_a).normalized())) {
-				return;
-			}
+			axes.add_axis(axis_ab.cross(axis_a).cross(axis_a).normalized());
 
 			//b ->a
 			Vector3 axis_b = p_transform_b.basis.get_column(i);
 
-			if (!separator.test_axis(axis_ab.cross(axis_b).cross(axis_b).normalized())) {
-				return;
-			}
+			axes.add_axis(axis_ab.cross(axis_b).cross(axis_b).normalized());
+		}
+
+		if (!separator.template test_axes<batchedAxes>(axes)) {
+			return;
 		}
 	}
 
 	separator.generate_contacts();
 }
 
-template <bool withMargin>
+template <bool withMargin, bool batchedAxes = true>
 static void _collision_box_capsule(const GodotShape3D *p_a, const Transform3D &p_transform_a, const GodotShape3D *p_b, const Transform3D &p_transform_b, _CollectorCallback *p_collector, real_t p_margin_a, real_t p_margin_b) {
 	const GodotBoxShape3D *box_A = static_cast<const GodotBoxShape3D *>(p_a);
 	const GodotCapsuleShape3D *capsule_B = static_cast<const GodotCapsuleShape3D *>(p_b);
@@ -1177,19 +1341,23 @@ static void _collision_box_capsule(const GodotShape3D *p_a, const Transform3D &p
 		return;
 	}
 
+	_SATAxisBatch axes;
+
 	// faces of A
 	for (int i = 0; i < 3; i++) {
-		Vector3 axis = p_transform_a.basis.get_column(i).normalized();
+		axes.add_axis(p_transform_a.basis.get_column(i).normalized());
+	}
 
-		if (!separator.test_axis(axis)) {
-			return;
-		}
+	if (!separator.template test_axes<batchedAxes>(axes)) {
+		return;
 	}
 
 	Vector3 cyl_axis = p_transform_b.basis.get_column(1).normalized();
 
 	// edges of A, capsule cylinder
 
+	axes.clear();
+
 	for (int i = 0; i < 3; i++) {
 		// cylinder
 		Vector3 box_axis = p_transform_a.basis.get_column(i);
@@ -1198,9 +1366,7 @@ static void _collision_box_capsule(const GodotShape3D *p_a, const Transform3D &p
 			continue;
 		}
 
-		if (!separator.test_axis(axis.normalized())) {
-			return;
-		}
+		axes.add_axis(axis.normalized());
 	}
 
 	// points of A, capsule cylinder
@@ -1221,15 +1387,19 @@ static void _collision_box_capsule(const GodotShape3D *p_a, const Transform3D &p
 				//Vector3 axis = (point - cyl_axis * cyl_axis.dot(point)).normalized();
 				Vector3 axis = Plane(cyl_axis).project(point).normalized();
 
-				if (!separator.test_axis(axis)) {
-					return;
-				}
+				axes.add_axis(axis);
 			}
 		}
 	}
 
+	if (!separator.template test_axes<batchedAxes>(axes)) {
+		return;
+	}
+
 	// capsule balls, edges of A
 
+	axes.clear();
+
 	for (int i = 0; i < 2; i++) {
 		Vector3 capsule_axis = p_transform_b.basis.get_column(1) * (capsule_B->get_height() * 0.5 - capsule_B->get_radius());
 
@@ -1246,21 +1416,21 @@ static void _collision_box_capsule(const GodotShape3D *p_a, const Transform3D &p
 		// use point to test axis
 		Vector3 point_axis = (sphere_pos - cpoint).normalized();
 
-		if (!separator.test_axis(point_axis)) {
-			return;
-		}
+		axes.add_axis(point_axis);
 
 		// test edges of A
 
 		for (int j = 0; j < 3; j++) {
 			Vector3 axis = point_axis.cross(p_transform_a.basis.get_column(j)).cross(p_transform_a.basis.get_column(j)).normalized();
 
-			if (!separator.test_axis(axis)) {
-				return;
-			}
+			axes.add_axis(axis);
 		}
 	}
 
+	if (!separator.template test_axes<batchedAxes>(axes)) {
+		return;
+	}
+
 	separator.generate_contacts();
 }
 
@@ -2289,7 +2459,8 @@ static void _collision_convex_polygon_face(const GodotShape3D *p_a, const Transf
 	separator.generate_contacts();
 }
 
-bool sat_calculate_penetration(const GodotShape3D *p_shape_A, const Transform3D &p_transform_A, const GodotShape3D *p_shape_B, const Transform3D &p_transform_B, GodotCollisionSolver3D::CallbackResult p_result_callback, void *p_userdata, bool p_swap, Vector3 *r_prev_axis, real_t p_margin_a, real_t p_margin_b) {
+template <bool batchedAxes>
+static bool _sat_calculate_penetration(const GodotShape3D *p_shape_A, const Transform3D &p_transform_A, const GodotShape3D *p_shape_B, const Transform3D &p_transform_B, GodotCollisionSolver3D::CallbackResult p_result_callback, void *p_userdata, bool p_swap, Vector3 *r_prev_axis, real_t p_margin_a, real_t p_margin_b) {
 	PhysicsServer3D::ShapeType type_A = p_shape_A->get_type();
 
 	ERR_FAIL_COND_V(type_A == PhysicsServer3D::SHAPE_WORLD_BOUNDARY, false);
@@ -2310,8 +2481,8 @@ bool sat_calculate_penetration(const GodotShape3D *p_shape_A, const Transform3D
 				_collision_sphere_convex_polygon<false>,
 				_collision_sphere_face<false> },
 		{ nullptr,
-				_collision_box_box<false>,
-				_collision_box_capsule<false>,
+				_collision_box_box<false, batchedAxes>,
+				_collision_box_capsule<false, batchedAxes>,
 				_collision_box_cylinder<false>,
 				_collision_box_convex_polygon<false>,
 				_collision_box_face<false> },
@@ -2349,8 +2520,8 @@ bool sat_calculate_penetration(const GodotShape3D *p_shape_A, const Transform3D
 				_collision_sphere_convex_polygon<true>,
 				_collision_sphere_face<true> },
 		{ nullptr,
-				_collision_box_box<true>,
-				_collision_box_capsule<true>,
+				_collision_box_box<true, batchedAxes>,
+				_collision_box_capsule<true, batchedAxes>,
 				_collision_box_cylinder<true>,
 				_collision_box_convex_polygon<true>,
 				_collision_box_face<true> },
@@ -2415,3 +2586,11 @@ bool sat_calculate_penetration(const GodotShape3D *p_shape_A, const Transform3D
 
 	return callback.collided;
 }
+
+bool sat_calculate_penetration(const GodotShape3D *p_shape_A, const Transform3D &p_transform_A, const GodotShape3D *p_shape_B, const Transform3D &p_transform_B, GodotCollisionSolver3D::CallbackResult p_result_callback, void *p_userdata, bool p_swap, Vector3 *r_prev_axis, real_t p_margin_a, real_t p_margin_b) {
+	return _sat_calculate_penetration<true>(p_shape_A, p_transform_A, p_shape_B, p_transform_B, p_result_callback, p_userdata, p_swap, r_prev_axis, p_margin_a, p_margin_b);
+}
+
+bool sat_calculate_penetration_unbatched(const GodotShape3D *p_shape_A, const Transform3D &p_transform_A, const GodotShape3D *p_shape_B, const Transform3D &p_transform_B, GodotCollisionSolver3D::CallbackResult p_result_callback, void *p_userdata, bool p_swap, Vector3 *r_prev_axis, real_t p_margin_a, real_t p_margin_b) {
+	return _sat_calculate_penetration<false>(p_shape_A, p_transform_A, p_shape_B, p_transform_B, p_result_callback, p_userdata, p_swap, r_prev_axis, p_margin_a, p_margin_b);
+}
@@ -33,11 +33,14 @@
 
 class GodotBody3D;
 class GodotSoftBody3D;
+struct GodotIsland3D;
 
 class GodotConstraint3D {
 	GodotBody3D **_body_ptr;
 	int _body_count;
 	uint64_t island_step;
+	GodotIsland3D *island = nullptr;
+	uint32_t island_index = 0;
 	int priority;
 	bool disabled_collisions_between_bodies;
 
@@ -59,6 +62,13 @@ public:
 	_FORCE_INLINE_ uint64_t get_island_step() const { return island_step; }
 	_FORCE_INLINE_ void set_island_step(uint64_t p_step) { island_step = p_step; }
 
+	_FORCE_INLINE_ GodotIsland3D *get_island() const { return island; }
+	_FORCE_INLINE_ uint32_t get_island_index() const { return island_index; }
+	_FORCE_INLINE_ void set_island(GodotIsland3D *p_island, uint32_t p_index) {
+		island = p_island;
+		island_index = p_index;
+	}
+
 	_FORCE_INLINE_ GodotBody3D **get_body_ptr() const { return _body_ptr; }
 	_FORCE_INLINE_ int get_body_count() const { return _body_count; }
 
@@ -73,8 +83,15 @@ public:
 
 	virtual bool setup(real_t p_step) = 0;
 	virtual bool pre_solve(real_t p_step) = 0;
+	// Called instead of pre_solve() for the solver substeps after the first one, collisions aren't detected again.
+	virtual bool pre_solve_substep(real_t p_step) { return pre_solve(p_step); }
 	virtual void solve(real_t p_step) = 0;
 
+	// Sorts constraints between the same bodies when islands are solved deterministically.
+	virtual uint64_t get_order_key() const { return self.get_id(); }
+	virtual bool is_body_pair() const { return false; }
+	virtual bool is_joint() const { return false; }
+
 	virtual ~GodotConstraint3D() {}
 };
 
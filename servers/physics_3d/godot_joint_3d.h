@@ -73,8 +73,23 @@ protected:
 	}
 
 public:
+	enum {
+		MAX_SNAPSHOT_IMPULSES = 6,
+	};
+
+	// Impulses accumulated by the solver, copied as a flat record by space snapshots.
+	struct Snapshot {
+		uint64_t id = 0;
+		real_t impulses[MAX_SNAPSHOT_IMPULSES] = {};
+	};
+
 	virtual bool setup(real_t p_step) override { return false; }
 	virtual bool pre_solve(real_t p_step) override { return true; }
+	virtual bool pre_solve_substep(real_t p_step) override {
+		// Bodies moved since the last substep, update the jacobians.
+		setup(p_step);
+		return pre_solve(p_step);
+	}
 	virtual void solve(real_t p_step) override {}
 
 	void copy_settings_from(GodotJoint3D *p_joint) {
@@ -84,6 +99,11 @@ public:
 	}
 
 	virtual PhysicsServer3D::JointType get_type() const { return PhysicsServer3D::JOINT_TYPE_MAX; }
+	virtual bool is_joint() const override { return true; }
+
+	virtual void save_snapshot(Snapshot &r_snapshot) const { r_snapshot.id = get_self().get_id(); }
+	virtual void load_snapshot(const Snapshot &p_snapshot) {}
+
 	_FORCE_INLINE_ GodotJoint3D(GodotBody3D **p_body_ptr = nullptr, int p_body_count = 0) :
 			GodotConstraint3D(p_body_ptr, p_body_count) {
 	}
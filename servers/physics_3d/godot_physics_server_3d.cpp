@@ -196,6 +196,20 @@ PhysicsDirectSpaceState3D *GodotPhysicsServer3D::space_get_direct_state(RID p_sp
 	return space->get_direct_state();
 }
 
+PackedByteArray GodotPhysicsServer3D::space_save_snapshot(RID p_space) const {
+	const GodotSpace3D *space = space_owner.get_or_null(p_space);
+	ERR_FAIL_NULL_V(space, PackedByteArray());
+
+	return space->save_snapshot();
+}
+
+Error GodotPhysicsServer3D::space_restore_snapshot(RID p_space, const PackedByteArray &p_snapshot) {
+	GodotSpace3D *space = space_owner.get_or_null(p_space);
+	ERR_FAIL_NULL_V(space, ERR_INVALID_PARAMETER);
+
+	return space->restore_snapshot(p_snapshot);
+}
+
 void GodotPhysicsServer3D::space_set_debug_contacts(RID p_space, int p_max_contacts) {
 	GodotSpace3D *space = space_owner.get_or_null(p_space);
 	ERR_FAIL_NULL(space);
@@ -1640,11 +1654,15 @@ void GodotPhysicsServer3D::step(real_t p_step) {
 	island_count = 0;
 	active_objects = 0;
 	collision_pairs = 0;
+	broad_phase_time = 0;
+	narrow_phase_time = 0;
 	for (const GodotSpace3D *E : active_spaces) {
 		stepper->step(const_cast<GodotSpace3D *>(E), p_step);
 		island_count += E->get_island_count();
 		active_objects += E->get_active_objects();
 		collision_pairs += E->get_collision_pairs();
+		broad_phase_time += E->get_elapsed_time(GodotSpace3D::ELAPSED_TIME_BROAD_PHASE);
+		narrow_phase_time += E->get_elapsed_time(GodotSpace3D::ELAPSED_TIME_SETUP_CONSTRAINTS);
 	}
 #endif
 }
@@ -1675,6 +1693,7 @@ void GodotPhysicsServer3D::flush_queries() {
 		uint64_t total_time[GodotSpace3D::ELAPSED_TIME_MAX];
 		static const char *time_name[GodotSpace3D::ELAPSED_TIME_MAX] = {
 			"integrate_forces",
+			"broad_phase",
 			"generate_islands",
 			"setup_constraints",
 			"solve_constraints",
@@ -1725,6 +1744,12 @@ int GodotPhysicsServer3D::get_process_info(ProcessInfo p_info) {
 		case INFO_ISLAND_COUNT: {
 			return island_count;
 		} break;
+		case INFO_BROAD_PHASE_TIME: {
+			return broad_phase_time;
+		} break;
+		case INFO_NARROW_PHASE_TIME: {
+			return narrow_phase_time;
+		} break;
 	}
 
 	return 0;
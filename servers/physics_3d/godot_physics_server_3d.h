@@ -48,6 +48,8 @@ class GodotPhysicsServer3D : public PhysicsServer3D {
 	int island_count = 0;
 	int active_objects = 0;
 	int collision_pairs = 0;
+	uint64_t broad_phase_time = 0;
+	uint64_t narrow_phase_time = 0;
 
 	bool using_threads = false;
 	bool doing_sync = false;
@@ -113,6 +115,9 @@ public:
 	// this function only works on physics process, errors and returns null otherwise
 	virtual PhysicsDirectSpaceState3D *space_get_direct_state(RID p_space) override;
 
+	virtual PackedByteArray space_save_snapshot(RID p_space) const override;
+	virtual Error space_restore_snapshot(RID p_space, const PackedByteArray &p_snapshot) override;
+
 	virtual void space_set_debug_contacts(RID p_space, int p_max_contacts) override;
 	virtual Vector<Vector3> space_get_contacts(RID p_space) const override;
 	virtual int space_get_contact_count(RID p_space) const override;
@@ -110,9 +110,29 @@ Variant GodotSoftBody3D::get_state(PhysicsServer3D::BodyState p_state) const {
 	return Variant();
 }
 
+void GodotSoftBody3D::add_constraint(GodotConstraint3D *p_constraint) {
+	constraints.insert(p_constraint);
+	if (get_space()) {
+		get_space()->island_add_constraint(p_constraint, island);
+	}
+}
+
+void GodotSoftBody3D::remove_constraint(GodotConstraint3D *p_constraint) {
+	constraints.erase(p_constraint);
+	GodotSpace3D::island_remove_constraint(p_constraint);
+}
+
+void GodotSoftBody3D::clear_constraints() {
+	for (GodotConstraint3D *constraint : constraints) {
+		GodotSpace3D::island_remove_constraint(constraint);
+	}
+	constraints.clear();
+}
+
 void GodotSoftBody3D::set_space(GodotSpace3D *p_space) {
 	if (get_space()) {
 		get_space()->soft_body_remove_from_active_list(&active_list);
+		get_space()->island_remove_soft_body(this);
 
 		deinitialize_shape();
 	}
@@ -120,6 +140,7 @@ void GodotSoftBody3D::set_space(GodotSpace3D *p_space) {
 	_set_space(p_space);
 
 	if (get_space()) {
+		get_space()->island_add_soft_body(this);
 		get_space()->soft_body_add_to_active_list(&active_list);
 
 		if (bounds != AABB()) {
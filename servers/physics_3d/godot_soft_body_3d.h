@@ -42,6 +42,7 @@
 #include "core/templates/vset.h"
 
 class GodotConstraint3D;
+struct GodotIsland3D;
 
 class GodotSoftBody3D : public GodotCollisionObject3D {
 	RID soft_mesh;
@@ -109,7 +110,7 @@ class GodotSoftBody3D : public GodotCollisionObject3D {
 
 	VSet<RID> exceptions;
 
-	uint64_t island_step = 0;
+	GodotIsland3D *island = nullptr;
 
 	_FORCE_INLINE_ Vector3 _compute_area_windforce(const GodotArea3D *p_area, const Face *p_face);
 
@@ -121,18 +122,18 @@ public:
 	void set_state(PhysicsServer3D::BodyState p_state, const Variant &p_variant);
 	Variant get_state(PhysicsServer3D::BodyState p_state) const;
 
-	_FORCE_INLINE_ void add_constraint(GodotConstraint3D *p_constraint) { constraints.insert(p_constraint); }
-	_FORCE_INLINE_ void remove_constraint(GodotConstraint3D *p_constraint) { constraints.erase(p_constraint); }
+	void add_constraint(GodotConstraint3D *p_constraint);
+	void remove_constraint(GodotConstraint3D *p_constraint);
 	_FORCE_INLINE_ const HashSet<GodotConstraint3D *> &get_constraints() const { return constraints; }
-	_FORCE_INLINE_ void clear_constraints() { constraints.clear(); }
+	void clear_constraints();
 
 	_FORCE_INLINE_ void add_exception(const RID &p_exception) { exceptions.insert(p_exception); }
 	_FORCE_INLINE_ void remove_exception(const RID &p_exception) { exceptions.erase(p_exception); }
 	_FORCE_INLINE_ bool has_exception(const RID &p_exception) const { return exceptions.has(p_exception); }
 	_FORCE_INLINE_ const VSet<RID> &get_exceptions() const { return exceptions; }
 
-	_FORCE_INLINE_ uint64_t get_island_step() const { return island_step; }
-	_FORCE_INLINE_ void set_island_step(uint64_t p_step) { island_step = p_step; }
+	_FORCE_INLINE_ GodotIsland3D *get_island() const { return island; }
+	_FORCE_INLINE_ void set_island(GodotIsland3D *p_island) { island = p_island; }
 
 	_FORCE_INLINE_ void add_area(GodotArea3D *p_area) {
 		int index = areas.find(AreaCMP(p_area));
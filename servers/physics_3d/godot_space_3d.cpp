@@ -31,9 +31,11 @@
 #include "godot_space_3d.h"
 
 #include "godot_collision_solver_3d.h"
+#include "godot_joint_3d.h"
 #include "godot_physics_server_3d.h"
 
 #include "core/config/project_settings.h"
+#include "core/object/worker_thread_pool.h"
 
 #define TEST_MOTION_MARGIN_MIN_VALUE 0.0001
 #define TEST_MOTION_MIN_CONTACT_DEPTH_FACTOR 0.05
@@ -108,14 +110,18 @@ int GodotPhysicsDirectSpaceState3D::intersect_point(const PointParameters &p_par
 bool GodotPhysicsDirectSpaceState3D::intersect_ray(const RayParameters &p_parameters, RayResult &r_result) {
 	ERR_FAIL_COND_V(space->locked, false);
 
+	int amount = space->broadphase->cull_segment(p_parameters.from, p_parameters.to, space->intersection_query_results, GodotSpace3D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
+
+	return _intersect_ray_candidates(p_parameters, p_parameters.from, p_parameters.to, space->intersection_query_results, space->intersection_query_subindex_results, amount, r_result);
+}
+
+bool GodotPhysicsDirectSpaceState3D::_intersect_ray_candidates(const RayParameters &p_parameters, const Vector3 &p_from, const Vector3 &p_to, GodotCollisionObject3D *const *p_candidates, const int *p_candidate_shapes, int p_amount, RayResult &r_result) const {
 	Vector3 begin, end;
 	Vector3 normal;
-	begin = p_parameters.from;
-	end = p_parameters.to;
+	begin = p_from;
+	end = p_to;
 	normal = (end - begin).normalized();
 
-	int amount = space->broadphase->cull_segment(begin, end, space->intersection_query_results, GodotSpace3D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
-
 	//todo, create another array that references results, compute AABBs and check closest point to ray origin, sort, and stop evaluating results when beyond first collision
 
 	bool collided = false;
@@ -125,22 +131,22 @@ bool GodotPhysicsDirectSpaceState3D::intersect_ray(const RayParameters &p_parame
 	const GodotCollisionObject3D *res_obj = nullptr;
 	real_t min_d = 1e10;
 
-	for (int i = 0; i < amount; i++) {
-		if (!_can_collide_with(space->intersection_query_results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
+	for (int i = 0; i < p_amount; i++) {
+		if (!_can_collide_with(p_candidates[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
 			continue;
 		}
 
-		if (p_parameters.pick_ray && !(space->intersection_query_results[i]->is_ray_pickable())) {
+		if (p_parameters.pick_ray && !(p_candidates[i]->is_ray_pickable())) {
 			continue;
 		}
 
-		if (p_parameters.exclude.has(space->intersection_query_results[i]->get_self())) {
+		if (p_parameters.exclude.has(p_candidates[i]->get_self())) {
 			continue;
 		}
 
-		const GodotCollisionObject3D *col_obj = space->intersection_query_results[i];
+		const GodotCollisionObject3D *col_obj = p_candidates[i];
 
-		int shape_idx = space->intersection_query_subindex_results[i];
+		int shape_idx = p_candidate_shapes[i];
 		Transform3D inv_xform = col_obj->get_shape_inv_transform(shape_idx) * col_obj->get_inv_transform();
 
 		Vector3 local_from = inv_xform.xform(begin);
@@ -205,6 +211,74 @@ bool GodotPhysicsDirectSpaceState3D::intersect_ray(const RayParameters &p_parame
 	return true;
 }
 
+struct GodotRayBatch3D {
+	const PhysicsDirectSpaceState3D::RayParameters *parameters = nullptr;
+	const Vector3 *from = nullptr;
+	const Vector3 *to = nullptr;
+	int count = 0;
+	PhysicsDirectSpaceState3D::RayResult *results = nullptr;
+	bool *collided = nullptr;
+	uint32_t chunk_count = 0;
+	// Chunks are taken in order by whichever task is free.
+	SafeNumeric<uint32_t> next_chunk;
+};
+
+void GodotPhysicsDirectSpaceState3D::_intersect_ray_task(uint32_t p_task, void *p_userdata) {
+	GodotRayBatch3D *batch = static_cast<GodotRayBatch3D *>(p_userdata);
+
+	// Every task needs its own candidate buffers, the ones of the space are shared.
+	LocalVector<GodotCollisionObject3D *> candidates;
+	LocalVector<int> candidate_shapes;
+	LocalVector<uint32_t, uint32_t, true> scratch;
+	candidates.resize(GodotSpace3D::INTERSECTION_QUERY_MAX);
+	candidate_shapes.resize(GodotSpace3D::INTERSECTION_QUERY_MAX);
+
+	for (uint32_t chunk = batch->next_chunk.postincrement(); chunk < batch->chunk_count; chunk = batch->next_chunk.postincrement()) {
+		int from = chunk * RAY_BATCH_CHUNK_SIZE;
+		int to = MIN(from + RAY_BATCH_CHUNK_SIZE, batch->count);
+
+		for (int i = from; i < to; i++) {
+			int amount = space->broadphase->cull_segment_concurrent(batch->from[i], batch->to[i], candidates.ptr(), GodotSpace3D::INTERSECTION_QUERY_MAX, candidate_shapes.ptr(), scratch);
+			batch->collided[i] = _intersect_ray_candidates(*batch->parameters, batch->from[i], batch->to[i], candidates.ptr(), candidate_shapes.ptr(), amount, batch->results[i]);
+		}
+	}
+}
+
+int GodotPhysicsDirectSpaceState3D::intersect_rays(const RayParameters &p_parameters, const Vector3 *p_from, const Vector3 *p_to, int p_count, RayResult *r_results, bool *r_collided) {
+	ERR_FAIL_COND_V(space->locked, 0);
+
+	if (p_count <= 0) {
+		return 0;
+	}
+
+	GodotRayBatch3D batch;
+	batch.parameters = &p_parameters;
+	batch.from = p_from;
+	batch.to = p_to;
+	batch.count = p_count;
+	batch.results = r_results;
+	batch.collided = r_collided;
+
+	// The broad phase is not modified while the batch runs, so rays can be cast from several threads.
+	batch.chunk_count = (p_count + RAY_BATCH_CHUNK_SIZE - 1) / RAY_BATCH_CHUNK_SIZE;
+	uint32_t task_count = MIN(batch.chunk_count, (uint32_t)WorkerThreadPool::get_singleton()->get_thread_count());
+	if (task_count > 1) {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotPhysicsDirectSpaceState3D::_intersect_ray_task, (void *)&batch, task_count, -1, true, SNAME("Physics3DIntersectRays"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	} else {
+		_intersect_ray_task(0, &batch);
+	}
+
+	int collided_count = 0;
+	for (int i = 0; i < p_count; i++) {
+		if (r_collided[i]) {
+			collided_count++;
+		}
+	}
+
+	return collided_count;
+}
+
 int GodotPhysicsDirectSpaceState3D::intersect_shape(const ShapeParameters &p_parameters, ShapeResult *r_results, int p_result_max) {
 	if (p_result_max <= 0) {
 		return 0;
@@ -217,29 +291,31 @@ int GodotPhysicsDirectSpaceState3D::intersect_shape(const ShapeParameters &p_par
 
 	int amount = space->broadphase->cull_aabb(aabb, space->intersection_query_results, GodotSpace3D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
 
-	int cc = 0;
+	return _intersect_shape_candidates(p_parameters, shape, p_parameters.transform, space->intersection_query_results, space->intersection_query_subindex_results, amount, r_results, p_result_max);
+}
 
-	//Transform3D ai = p_xform.affine_inverse();
+int GodotPhysicsDirectSpaceState3D::_intersect_shape_candidates(const ShapeParameters &p_parameters, const GodotShape3D *p_shape, const Transform3D &p_transform, GodotCollisionObject3D *const *p_candidates, const int *p_candidate_shapes, int p_amount, ShapeResult *r_results, int p_result_max) const {
+	int cc = 0;
 
-	for (int i = 0; i < amount; i++) {
+	for (int i = 0; i < p_amount; i++) {
 		if (cc >= p_result_max) {
 			break;
 		}
 
-		if (!_can_collide_with(space->intersection_query_results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
+		if (!_can_collide_with(p_candidates[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
 			continue;
 		}
 
 		//area can't be picked by ray (default)
 
-		if (p_parameters.exclude.has(space->intersection_query_results[i]->get_self())) {
+		if (p_parameters.exclude.has(p_candidates[i]->get_self())) {
 			continue;
 		}
 
-		const GodotCollisionObject3D *col_obj = space->intersection_query_results[i];
-		int shape_idx = space->intersection_query_subindex_results[i];
+		const GodotCollisionObject3D *col_obj = p_candidates[i];
+		int shape_idx = p_candidate_shapes[i];
 
-		if (!GodotCollisionSolver3D::solve_static(shape, p_parameters.transform, col_obj->get_shape(shape_idx), col_obj->get_transform() * col_obj->get_shape_transform(shape_idx), nullptr, nullptr, nullptr, p_parameters.margin, 0)) {
+		if (!GodotCollisionSolver3D::solve_static(p_shape, p_transform, col_obj->get_shape(shape_idx), col_obj->get_transform() * col_obj->get_shape_transform(shape_idx), nullptr, nullptr, nullptr, p_parameters.margin, 0)) {
 			continue;
 		}
 
@@ -260,15 +336,95 @@ int GodotPhysicsDirectSpaceState3D::intersect_shape(const ShapeParameters &p_par
 	return cc;
 }
 
+struct GodotShapeBatch3D {
+	const PhysicsDirectSpaceState3D::ShapeParameters *parameters = nullptr;
+	const GodotShape3D *shape = nullptr;
+	const Transform3D *transforms = nullptr;
+	int count = 0;
+	PhysicsDirectSpaceState3D::ShapeResult *results = nullptr;
+	int result_max = 0;
+	int *result_counts = nullptr;
+	uint32_t chunk_count = 0;
+	// Chunks are taken in order by whichever task is free.
+	SafeNumeric<uint32_t> next_chunk;
+};
+
+void GodotPhysicsDirectSpaceState3D::_intersect_shape_task(uint32_t p_task, void *p_userdata) {
+	GodotShapeBatch3D *batch = static_cast<GodotShapeBatch3D *>(p_userdata);
+
+	// Every task needs its own candidate buffers, the ones of the space are shared.
+	LocalVector<GodotCollisionObject3D *> candidates;
+	LocalVector<int> candidate_shapes;
+	LocalVector<uint32_t, uint32_t, true> scratch;
+	candidates.resize(GodotSpace3D::INTERSECTION_QUERY_MAX);
+	candidate_shapes.resize(GodotSpace3D::INTERSECTION_QUERY_MAX);
+
+	const AABB shape_aabb = batch->shape->get_aabb();
+
+	for (uint32_t chunk = batch->next_chunk.postincrement(); chunk < batch->chunk_count; chunk = batch->next_chunk.postincrement()) {
+		int from = chunk * SHAPE_BATCH_CHUNK_SIZE;
+		int to = MIN(from + SHAPE_BATCH_CHUNK_SIZE, batch->count);
+
+		for (int i = from; i < to; i++) {
+			int amount = space->broadphase->cull_aabb_concurrent(batch->transforms[i].xform(shape_aabb), candidates.ptr(), GodotSpace3D::INTERSECTION_QUERY_MAX, candidate_shapes.ptr(), scratch);
+			batch->result_counts[i] = _intersect_shape_candidates(*batch->parameters, batch->shape, batch->transforms[i], candidates.ptr(), candidate_shapes.ptr(), amount, batch->results + i * batch->result_max, batch->result_max);
+		}
+	}
+}
+
+int GodotPhysicsDirectSpaceState3D::intersect_shapes(const ShapeParameters &p_parameters, const Transform3D *p_transforms, int p_count, ShapeResult *r_results, int p_result_max, int *r_result_counts) {
+	ERR_FAIL_COND_V(space->locked, 0);
+
+	if (p_count <= 0) {
+		return 0;
+	}
+	if (p_result_max <= 0) {
+		for (int i = 0; i < p_count; i++) {
+			r_result_counts[i] = 0;
+		}
+		return 0;
+	}
+
+	GodotShape3D *shape = GodotPhysicsServer3D::godot_singleton->shape_owner.get_or_null(p_parameters.shape_rid);
+	ERR_FAIL_NULL_V(shape, 0);
+
+	GodotShapeBatch3D batch;
+	batch.parameters = &p_parameters;
+	batch.shape = shape;
+	batch.transforms = p_transforms;
+	batch.count = p_count;
+	batch.results = r_results;
+	batch.result_max = p_result_max;
+	batch.result_counts = r_result_counts;
+
+	// Like for rays, the broad phase is not modified while the batch runs.
+	batch.chunk_count = (p_count + SHAPE_BATCH_CHUNK_SIZE - 1) / SHAPE_BATCH_CHUNK_SIZE;
+	uint32_t task_count = MIN(batch.chunk_count, (uint32_t)WorkerThreadPool::get_singleton()->get_thread_count());
+	if (task_count > 1) {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotPhysicsDirectSpaceState3D::_intersect_shape_task, (void *)&batch, task_count, -1, true, SNAME("Physics3DIntersectShapes"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	} else {
+		_intersect_shape_task(0, &batch);
+	}
+
+	int result_count = 0;
+	for (int i = 0; i < p_count; i++) {
+		result_count += r_result_counts[i];
+	}
+
+	return result_count;
+}
+
 bool GodotPhysicsDirectSpaceState3D::cast_motion(const ShapeParameters &p_parameters, real_t &p_closest_safe, real_t &p_closest_unsafe, ShapeRestInfo *r_info) {
 	GodotShape3D *shape = GodotPhysicsServer3D::godot_singleton->shape_owner.get_or_null(p_parameters.shape_rid);
 	ERR_FAIL_NULL_V(shape, false);
 
-	AABB aabb = p_parameters.transform.xform(shape->get_aabb());
-	aabb = aabb.merge(AABB(aabb.position + p_parameters.motion, aabb.size)); //motion
-	aabb = aabb.grow(p_parameters.margin);
+	AABB shape_aabb = p_parameters.transform.xform(shape->get_aabb());
+	shape_aabb = shape_aabb.grow(p_parameters.margin);
+	AABB aabb = shape_aabb.merge(AABB(shape_aabb.position + p_parameters.motion, shape_aabb.size)); //motion
 
-	int amount = space->broadphase->cull_aabb(aabb, space->intersection_query_results, GodotSpace3D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
+	// Sweeping skips everything that is only inside the merged box, which is most of it for long diagonal casts.
+	int amount = space->broadphase->cull_swept_aabb(shape_aabb, p_parameters.motion, space->intersection_query_results, GodotSpace3D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
 
 	real_t best_safe = 1;
 	real_t best_unsafe = 1;
@@ -1045,7 +1201,9 @@ void *GodotSpace3D::_broadphase_pair(GodotCollisionObject3D *A, int p_subindex_A
 		GodotArea3D *area = static_cast<GodotArea3D *>(A);
 		if (type_B == GodotCollisionObject3D::TYPE_AREA) {
 			GodotArea3D *area_b = static_cast<GodotArea3D *>(B);
-			GodotArea2Pair3D *area2_pair = memnew(GodotArea2Pair3D(area_b, p_subindex_B, area, p_subindex_A));
+			GodotArea2Pair3D *area2_pair = self->area2_pair_allocator.alloc(area_b, p_subindex_B, area, p_subindex_A);
+			area2_pair->set_index(self->area2_pairs.size());
+			self->area2_pairs.push_back(area2_pair);
 			return area2_pair;
 		} else if (type_B == GodotCollisionObject3D::TYPE_SOFT_BODY) {
 			GodotSoftBody3D *softbody = static_cast<GodotSoftBody3D *>(B);
@@ -1053,7 +1211,9 @@ void *GodotSpace3D::_broadphase_pair(GodotCollisionObject3D *A, int p_subindex_A
 			return soft_area_pair;
 		} else {
 			GodotBody3D *body = static_cast<GodotBody3D *>(B);
-			GodotAreaPair3D *area_pair = memnew(GodotAreaPair3D(body, p_subindex_B, area, p_subindex_A));
+			GodotAreaPair3D *area_pair = self->area_pair_allocator.alloc(body, p_subindex_B, area, p_subindex_A);
+			area_pair->set_index(self->area_pairs.size());
+			self->area_pairs.push_back(area_pair);
 			return area_pair;
 		}
 	} else if (type_A == GodotCollisionObject3D::TYPE_BODY) {
@@ -1061,7 +1221,20 @@ void *GodotSpace3D::_broadphase_pair(GodotCollisionObject3D *A, int p_subindex_A
 			GodotBodySoftBodyPair3D *soft_pair = memnew(GodotBodySoftBodyPair3D(static_cast<GodotBody3D *>(A), p_subindex_A, static_cast<GodotSoftBody3D *>(B)));
 			return soft_pair;
 		} else {
+			if (self->deterministic && A->get_self().get_id() > B->get_self().get_id()) {
+				// Contacts are generated from A's side, don't let the pairing order decide which body it is.
+				SWAP(A, B);
+				SWAP(p_subindex_A, p_subindex_B);
+			}
+
 			GodotBodyPair3D *b = memnew(GodotBodyPair3D(static_cast<GodotBody3D *>(A), p_subindex_A, static_cast<GodotBody3D *>(B), p_subindex_B));
+
+			if (!self->pending_pair_snapshots.is_empty()) {
+				const GodotBodyPair3D::Snapshot *snapshot = self->_find_pending_pair_snapshot(b);
+				if (snapshot) {
+					b->load_snapshot(*snapshot);
+				}
+			}
 			return b;
 		}
 	} else {
@@ -1078,8 +1251,33 @@ void GodotSpace3D::_broadphase_unpair(GodotCollisionObject3D *A, int p_subindex_
 
 	GodotSpace3D *self = static_cast<GodotSpace3D *>(p_self);
 	self->collision_pairs--;
-	GodotConstraint3D *c = static_cast<GodotConstraint3D *>(p_data);
-	memdelete(c);
+
+	GodotCollisionObject3D::Type type_A = A->get_type();
+	GodotCollisionObject3D::Type type_B = B->get_type();
+	if (type_A > type_B) {
+		SWAP(type_A, type_B);
+	}
+
+	if (type_A == GodotCollisionObject3D::TYPE_AREA && type_B == GodotCollisionObject3D::TYPE_AREA) {
+		GodotArea2Pair3D *area2_pair = static_cast<GodotArea2Pair3D *>(p_data);
+		uint32_t index = area2_pair->get_index();
+		self->area2_pairs.remove_at_unordered(index);
+		if (index < self->area2_pairs.size()) {
+			self->area2_pairs[index]->set_index(index);
+		}
+		self->area2_pair_allocator.free(area2_pair);
+	} else if (type_A == GodotCollisionObject3D::TYPE_AREA && type_B == GodotCollisionObject3D::TYPE_BODY) {
+		GodotAreaPair3D *area_pair = static_cast<GodotAreaPair3D *>(p_data);
+		uint32_t index = area_pair->get_index();
+		self->area_pairs.remove_at_unordered(index);
+		if (index < self->area_pairs.size()) {
+			self->area_pairs[index]->set_index(index);
+		}
+		self->area_pair_allocator.free(area_pair);
+	} else {
+		GodotConstraint3D *c = static_cast<GodotConstraint3D *>(p_data);
+		memdelete(c);
+	}
 }
 
 const SelfList<GodotBody3D>::List &GodotSpace3D::get_active_body_list() const {
@@ -1160,6 +1358,163 @@ void GodotSpace3D::soft_body_remove_from_active_list(SelfList<GodotSoftBody3D> *
 	active_soft_body_list.remove(p_soft_body);
 }
 
+void GodotSpace3D::_island_mark_dirty(GodotIsland3D *p_island) {
+	if (!p_island->dirty) {
+		p_island->dirty = true;
+		dirty_islands.push_back(p_island);
+	}
+}
+
+void GodotSpace3D::_island_free(GodotIsland3D *p_island) {
+	if (p_island->dirty) {
+		dirty_islands.erase(p_island);
+	}
+	for (GodotConstraint3D *constraint : p_island->constraints) {
+		constraint->set_island(nullptr, 0);
+	}
+	island_allocator.free(p_island);
+}
+
+GodotIsland3D *GodotSpace3D::_island_merge(GodotIsland3D *p_island_a, GodotIsland3D *p_island_b) {
+	if (p_island_a == p_island_b) {
+		return p_island_a;
+	}
+
+	// Union by size, only the members of the smaller island are moved.
+	if (p_island_a->get_member_count() + p_island_a->constraints.size() < p_island_b->get_member_count() + p_island_b->constraints.size()) {
+		SWAP(p_island_a, p_island_b);
+	}
+
+	for (GodotBody3D *body : p_island_b->bodies) {
+		p_island_a->add_body(body);
+	}
+	for (GodotSoftBody3D *soft_body : p_island_b->soft_bodies) {
+		p_island_a->add_soft_body(soft_body);
+	}
+	for (GodotConstraint3D *constraint : p_island_b->constraints) {
+		p_island_a->add_constraint(constraint);
+	}
+	p_island_b->constraints.clear();
+
+	if (p_island_b->dirty) {
+		_island_mark_dirty(p_island_a);
+	}
+	_island_free(p_island_b);
+
+	return p_island_a;
+}
+
+GodotIsland3D *GodotSpace3D::island_create() {
+	GodotIsland3D *island = island_allocator.alloc();
+	island->space = this;
+	return island;
+}
+
+void GodotSpace3D::island_add_body(GodotBody3D *p_body) {
+	if (p_body->get_island() || p_body->get_mode() == PhysicsServer3D::BODY_MODE_STATIC) {
+		return; // Static bodies don't connect islands.
+	}
+
+	island_create()->add_body(p_body);
+	for (const KeyValue<GodotConstraint3D *, int> &E : p_body->get_constraint_map()) {
+		island_add_constraint(E.key, p_body->get_island());
+	}
+}
+
+void GodotSpace3D::island_remove_body(GodotBody3D *p_body) {
+	GodotIsland3D *island = p_body->get_island();
+	if (!island) {
+		return;
+	}
+
+	for (const KeyValue<GodotConstraint3D *, int> &E : p_body->get_constraint_map()) {
+		island_remove_constraint(E.key);
+	}
+	island->bodies.erase(p_body);
+	p_body->set_island(nullptr);
+
+	if (island->get_member_count() == 0) {
+		_island_free(island);
+	} else {
+		// The remaining bodies may not be connected anymore.
+		_island_mark_dirty(island);
+	}
+}
+
+void GodotSpace3D::island_add_soft_body(GodotSoftBody3D *p_soft_body) {
+	if (p_soft_body->get_island()) {
+		return;
+	}
+
+	island_create()->add_soft_body(p_soft_body);
+	for (GodotConstraint3D *constraint : p_soft_body->get_constraints()) {
+		island_add_constraint(constraint, p_soft_body->get_island());
+	}
+}
+
+void GodotSpace3D::island_remove_soft_body(GodotSoftBody3D *p_soft_body) {
+	GodotIsland3D *island = p_soft_body->get_island();
+	if (!island) {
+		return;
+	}
+
+	for (GodotConstraint3D *constraint : p_soft_body->get_constraints()) {
+		island_remove_constraint(constraint);
+	}
+	island->soft_bodies.erase(p_soft_body);
+	p_soft_body->set_island(nullptr);
+
+	if (island->get_member_count() == 0) {
+		_island_free(island);
+	} else {
+		_island_mark_dirty(island);
+	}
+}
+
+void GodotSpace3D::island_add_constraint(GodotConstraint3D *p_constraint, GodotIsland3D *p_island) {
+	// Called by every body the constraint connects with the island of that body,
+	// which is null for static bodies as they don't connect islands.
+	GodotIsland3D *island = p_constraint->get_island();
+	if (!p_island || (island && island->space != this)) {
+		return;
+	}
+
+	if (island) {
+		_island_merge(island, p_island);
+	} else {
+		p_island->add_constraint(p_constraint);
+	}
+}
+
+void GodotSpace3D::island_remove_constraint(GodotConstraint3D *p_constraint) {
+	GodotIsland3D *island = p_constraint->get_island();
+	if (!island) {
+		return;
+	}
+
+	// The bodies it connected may now be split, the island is flooded again before the next solve.
+	island->remove_constraint(p_constraint);
+	island->space->_island_mark_dirty(island);
+}
+
+void GodotSpace3D::island_dissolve_dirty(LocalVector<GodotBody3D *> &r_bodies, LocalVector<GodotSoftBody3D *> &r_soft_bodies) {
+	for (GodotIsland3D *island : dirty_islands) {
+		for (GodotBody3D *body : island->bodies) {
+			body->set_island(nullptr);
+			r_bodies.push_back(body);
+		}
+		for (GodotSoftBody3D *soft_body : island->soft_bodies) {
+			soft_body->set_island(nullptr);
+			r_soft_bodies.push_back(soft_body);
+		}
+		for (GodotConstraint3D *constraint : island->constraints) {
+			constraint->set_island(nullptr, 0);
+		}
+		island_allocator.free(island);
+	}
+	dirty_islands.clear();
+}
+
 void GodotSpace3D::call_queries() {
 	while (state_query_list.first()) {
 		GodotBody3D *b = state_query_list.first()->self();
@@ -1184,6 +1539,278 @@ void GodotSpace3D::setup() {
 
 void GodotSpace3D::update() {
 	broadphase->update();
+
+	// Pairs missing from a restored snapshot have been created by now.
+	pending_pair_snapshots.clear();
+}
+
+struct GodotBody3DSnapshotComparator {
+	_FORCE_INLINE_ bool operator()(const GodotBody3D::Snapshot &p_a, const GodotBody3D::Snapshot &p_b) const {
+		return p_a.id < p_b.id;
+	}
+};
+
+struct GodotJoint3DSnapshotComparator {
+	_FORCE_INLINE_ bool operator()(const GodotJoint3D::Snapshot &p_a, const GodotJoint3D::Snapshot &p_b) const {
+		return p_a.id < p_b.id;
+	}
+};
+
+// Records of body pairs, area pairs and area to area pairs are all keyed by their two objects and shapes.
+template <typename T>
+static _FORCE_INLINE_ int _compare_pair_snapshot(const T &p_snapshot, uint64_t p_id_A, int p_shape_A, uint64_t p_id_B, int p_shape_B) {
+	if (p_snapshot.id_A != p_id_A) {
+		return p_snapshot.id_A < p_id_A ? -1 : 1;
+	}
+	if (p_snapshot.shape_A != p_shape_A) {
+		return p_snapshot.shape_A < p_shape_A ? -1 : 1;
+	}
+	if (p_snapshot.id_B != p_id_B) {
+		return p_snapshot.id_B < p_id_B ? -1 : 1;
+	}
+	if (p_snapshot.shape_B != p_shape_B) {
+		return p_snapshot.shape_B < p_shape_B ? -1 : 1;
+	}
+	return 0;
+}
+
+template <typename T>
+struct GodotPair3DSnapshotComparator {
+	_FORCE_INLINE_ bool operator()(const T &p_a, const T &p_b) const {
+		return _compare_pair_snapshot(p_a, p_b.id_A, p_b.shape_A, p_b.id_B, p_b.shape_B) < 0;
+	}
+};
+
+template <typename T>
+static const T *_find_pair_snapshot(const LocalVector<T> &p_snapshots, uint64_t p_id_A, int p_shape_A, uint64_t p_id_B, int p_shape_B) {
+	uint32_t low = 0;
+	uint32_t high = p_snapshots.size();
+	while (low < high) {
+		uint32_t middle = (low + high) / 2;
+		int compare = _compare_pair_snapshot(p_snapshots[middle], p_id_A, p_shape_A, p_id_B, p_shape_B);
+		if (compare == 0) {
+			return &p_snapshots[middle];
+		} else if (compare < 0) {
+			low = middle + 1;
+		} else {
+			high = middle;
+		}
+	}
+
+	return nullptr;
+}
+
+// Records are cleared first so the padding bytes are the same in every snapshot.
+template <typename T>
+static _FORCE_INLINE_ T &_push_snapshot_record(LocalVector<T> &r_records) {
+	r_records.resize(r_records.size() + 1);
+	T &record = r_records[r_records.size() - 1];
+	memset((void *)&record, 0, sizeof(T));
+	return record;
+}
+
+template <typename T>
+static _FORCE_INLINE_ void _write_snapshot_records(uint8_t *&r_w, const LocalVector<T> &p_records) {
+	if (p_records.size() > 0) {
+		memcpy(r_w, (const void *)p_records.ptr(), p_records.size() * sizeof(T));
+		r_w += p_records.size() * sizeof(T);
+	}
+}
+
+template <typename T>
+static _FORCE_INLINE_ void _read_snapshot_records(const uint8_t *&r_r, uint32_t p_count, LocalVector<T> &r_records) {
+	r_records.resize(p_count);
+	if (p_count > 0) {
+		memcpy((void *)r_records.ptr(), r_r, p_count * sizeof(T));
+		r_r += p_count * sizeof(T);
+	}
+}
+
+const GodotBodyPair3D::Snapshot *GodotSpace3D::_find_pending_pair_snapshot(const GodotBodyPair3D *p_pair) const {
+	return _find_pair_snapshot(pending_pair_snapshots, p_pair->get_body_A()->get_self().get_id(), p_pair->get_shape_A(), p_pair->get_body_B()->get_self().get_id(), p_pair->get_shape_B());
+}
+
+bool GodotSpace3D::_has_state_outside_snapshot() const {
+	for (const GodotCollisionObject3D *E : objects) {
+		if (E->get_type() == GodotCollisionObject3D::TYPE_SOFT_BODY) {
+			return true;
+		}
+	}
+	return false;
+}
+
+Vector<uint8_t> GodotSpace3D::save_snapshot() const {
+	ERR_FAIL_COND_V_MSG(_has_state_outside_snapshot(), Vector<uint8_t>(), "Can't save a snapshot of a space with soft bodies, their state isn't part of snapshots.");
+
+	LocalVector<GodotBody3D::Snapshot> body_snapshots;
+	LocalVector<GodotBodyPair3D::Snapshot> pair_snapshots;
+	LocalVector<GodotJoint3D::Snapshot> joint_snapshots;
+	LocalVector<GodotAreaPair3D::Snapshot> area_pair_snapshots;
+	LocalVector<GodotArea2Pair3D::Snapshot> area2_pair_snapshots;
+
+	for (const GodotCollisionObject3D *E : objects) {
+		if (E->get_type() != GodotCollisionObject3D::TYPE_BODY) {
+			continue;
+		}
+		const GodotBody3D *body = static_cast<const GodotBody3D *>(E);
+		body->save_snapshot(_push_snapshot_record(body_snapshots));
+
+		for (const KeyValue<GodotConstraint3D *, int> &C : body->get_constraint_map()) {
+			// Pairs and joints are in the maps of all their bodies, only save them from the first one.
+			if (C.value != 0) {
+				continue;
+			}
+			if (C.key->is_body_pair()) {
+				static_cast<const GodotBodyPair3D *>(C.key)->save_snapshot(_push_snapshot_record(pair_snapshots));
+			} else if (C.key->is_joint()) {
+				static_cast<const GodotJoint3D *>(C.key)->save_snapshot(_push_snapshot_record(joint_snapshots));
+			}
+		}
+	}
+
+	for (const GodotAreaPair3D *area_pair : area_pairs) {
+		area_pair->save_snapshot(_push_snapshot_record(area_pair_snapshots));
+	}
+	for (const GodotArea2Pair3D *area2_pair : area2_pairs) {
+		area2_pair->save_snapshot(_push_snapshot_record(area2_pair_snapshots));
+	}
+
+	body_snapshots.sort_custom<GodotBody3DSnapshotComparator>();
+	pair_snapshots.sort_custom<GodotPair3DSnapshotComparator<GodotBodyPair3D::Snapshot>>();
+	joint_snapshots.sort_custom<GodotJoint3DSnapshotComparator>();
+	area_pair_snapshots.sort_custom<GodotPair3DSnapshotComparator<GodotAreaPair3D::Snapshot>>();
+	area2_pair_snapshots.sort_custom<GodotPair3DSnapshotComparator<GodotArea2Pair3D::Snapshot>>();
+
+	SnapshotHeader header;
+	header.magic = SNAPSHOT_MAGIC;
+	header.version = SNAPSHOT_VERSION;
+	header.body_count = body_snapshots.size();
+	header.pair_count = pair_snapshots.size();
+	header.joint_count = joint_snapshots.size();
+	header.area_pair_count = area_pair_snapshots.size();
+	header.area2_pair_count = area2_pair_snapshots.size();
+
+	Vector<uint8_t> snapshot;
+	snapshot.resize(sizeof(SnapshotHeader) + header.body_count * sizeof(GodotBody3D::Snapshot) + header.pair_count * sizeof(GodotBodyPair3D::Snapshot) + header.joint_count * sizeof(GodotJoint3D::Snapshot) + header.area_pair_count * sizeof(GodotAreaPair3D::Snapshot) + header.area2_pair_count * sizeof(GodotArea2Pair3D::Snapshot));
+
+	uint8_t *w = snapshot.ptrw();
+	memcpy(w, &header, sizeof(SnapshotHeader));
+	w += sizeof(SnapshotHeader);
+	_write_snapshot_records(w, body_snapshots);
+	_write_snapshot_records(w, pair_snapshots);
+	_write_snapshot_records(w, joint_snapshots);
+	_write_snapshot_records(w, area_pair_snapshots);
+	_write_snapshot_records(w, area2_pair_snapshots);
+
+	return snapshot;
+}
+
+Error GodotSpace3D::restore_snapshot(const Vector<uint8_t> &p_snapshot) {
+	ERR_FAIL_COND_V_MSG(locked, ERR_LOCKED, "Can't restore a snapshot while the space is being stepped.");
+	ERR_FAIL_COND_V_MSG(_has_state_outside_snapshot(), ERR_UNAVAILABLE, "Can't restore a snapshot in a space with soft bodies, their state isn't part of snapshots.");
+	ERR_FAIL_COND_V(p_snapshot.size() < (int64_t)sizeof(SnapshotHeader), ERR_INVALID_DATA);
+
+	const uint8_t *r = p_snapshot.ptr();
+
+	SnapshotHeader header;
+	memcpy(&header, r, sizeof(SnapshotHeader));
+	r += sizeof(SnapshotHeader);
+
+	ERR_FAIL_COND_V_MSG(header.magic != SNAPSHOT_MAGIC || header.version != SNAPSHOT_VERSION, ERR_INVALID_DATA, "Invalid or incompatible physics space snapshot.");
+	ERR_FAIL_COND_V(p_snapshot.size() != (int64_t)(sizeof(SnapshotHeader) + (uint64_t)header.body_count * sizeof(GodotBody3D::Snapshot) + (uint64_t)header.pair_count * sizeof(GodotBodyPair3D::Snapshot) + (uint64_t)header.joint_count * sizeof(GodotJoint3D::Snapshot) + (uint64_t)header.area_pair_count * sizeof(GodotAreaPair3D::Snapshot) + (uint64_t)header.area2_pair_count * sizeof(GodotArea2Pair3D::Snapshot)), ERR_INVALID_DATA);
+
+	LocalVector<GodotBody3D::Snapshot> body_snapshots;
+	LocalVector<GodotJoint3D::Snapshot> joint_snapshots;
+	LocalVector<GodotAreaPair3D::Snapshot> area_pair_snapshots;
+	LocalVector<GodotArea2Pair3D::Snapshot> area2_pair_snapshots;
+	_read_snapshot_records(r, header.body_count, body_snapshots);
+	_read_snapshot_records(r, header.pair_count, pending_pair_snapshots);
+	_read_snapshot_records(r, header.joint_count, joint_snapshots);
+	_read_snapshot_records(r, header.area_pair_count, area_pair_snapshots);
+	_read_snapshot_records(r, header.area2_pair_count, area2_pair_snapshots);
+
+	HashMap<uint64_t, GodotBody3D *> bodies;
+	HashMap<uint64_t, GodotJoint3D *> joints;
+	for (GodotCollisionObject3D *E : objects) {
+		if (E->get_type() != GodotCollisionObject3D::TYPE_BODY) {
+			continue;
+		}
+		GodotBody3D *body = static_cast<GodotBody3D *>(E);
+		bodies.insert(body->get_self().get_id(), body);
+		for (const KeyValue<GodotConstraint3D *, int> &C : body->get_constraint_map()) {
+			if (C.value == 0 && C.key->is_joint()) {
+				joints.insert(C.key->get_self().get_id(), static_cast<GodotJoint3D *>(C.key));
+			}
+		}
+	}
+
+	// Bodies and joints freed or moved to another space since the snapshot was saved are skipped.
+	for (const GodotBody3D::Snapshot &body_snapshot : body_snapshots) {
+		GodotBody3D **body = bodies.getptr(body_snapshot.id);
+		if (body) {
+			(*body)->load_snapshot(body_snapshot);
+		}
+	}
+	for (const GodotJoint3D::Snapshot &joint_snapshot : joint_snapshots) {
+		GodotJoint3D **joint = joints.getptr(joint_snapshot.id);
+		if (joint) {
+			(*joint)->load_snapshot(joint_snapshot);
+		}
+	}
+
+	pending_pair_snapshots.sort_custom<GodotPair3DSnapshotComparator<GodotBodyPair3D::Snapshot>>();
+	area_pair_snapshots.sort_custom<GodotPair3DSnapshotComparator<GodotAreaPair3D::Snapshot>>();
+	area2_pair_snapshots.sort_custom<GodotPair3DSnapshotComparator<GodotArea2Pair3D::Snapshot>>();
+
+	// Pair the bodies at their restored transforms, new pairs get their state from the pending list.
+	broadphase->update();
+
+	for (const KeyValue<uint64_t, GodotBody3D *> &E : bodies) {
+		for (const KeyValue<GodotConstraint3D *, int> &C : E.value->get_constraint_map()) {
+			if (C.value != 0 || !C.key->is_body_pair()) {
+				continue;
+			}
+			GodotBodyPair3D *pair = static_cast<GodotBodyPair3D *>(C.key);
+			const GodotBodyPair3D::Snapshot *pair_snapshot = _find_pending_pair_snapshot(pair);
+			if (pair_snapshot) {
+				pair->load_snapshot(*pair_snapshot);
+			} else {
+				pair->reset_contacts();
+			}
+		}
+	}
+
+	// Overlaps missing from the snapshot weren't there when it was saved, monitors get the enter and
+	// exit changes at the next step. The keys of the current pairs are taken from their own records.
+	for (GodotAreaPair3D *area_pair : area_pairs) {
+		GodotAreaPair3D::Snapshot key;
+		area_pair->save_snapshot(key);
+		const GodotAreaPair3D::Snapshot *area_pair_snapshot = _find_pair_snapshot(area_pair_snapshots, key.id_A, key.shape_A, key.id_B, key.shape_B);
+		area_pair->load_snapshot(area_pair_snapshot && area_pair_snapshot->colliding);
+	}
+	for (GodotArea2Pair3D *area2_pair : area2_pairs) {
+		GodotArea2Pair3D::Snapshot key;
+		area2_pair->save_snapshot(key);
+		uint32_t colliding = 0;
+		const GodotArea2Pair3D::Snapshot *area2_pair_snapshot = _find_pair_snapshot(area2_pair_snapshots, key.id_A, key.shape_A, key.id_B, key.shape_B);
+		if (area2_pair_snapshot) {
+			colliding = area2_pair_snapshot->colliding;
+		} else {
+			// The broadphase may have paired the areas the other way around this time.
+			area2_pair_snapshot = _find_pair_snapshot(area2_pair_snapshots, key.id_B, key.shape_B, key.id_A, key.shape_A);
+			if (area2_pair_snapshot) {
+				if (area2_pair_snapshot->colliding & GodotArea2Pair3D::COLLIDING_A) {
+					colliding |= GodotArea2Pair3D::COLLIDING_B;
+				}
+				if (area2_pair_snapshot->colliding & GodotArea2Pair3D::COLLIDING_B) {
+					colliding |= GodotArea2Pair3D::COLLIDING_A;
+				}
+			}
+		}
+		area2_pair->load_snapshot(colliding);
+	}
+
+	return OK;
 }
 
 void GodotSpace3D::set_param(PhysicsServer3D::SpaceParameter p_param, real_t p_value) {
@@ -1212,6 +1839,9 @@ void GodotSpace3D::set_param(PhysicsServer3D::SpaceParameter p_param, real_t p_v
 		case PhysicsServer3D::SPACE_PARAM_SOLVER_ITERATIONS:
 			solver_iterations = p_value;
 			break;
+		case PhysicsServer3D::SPACE_PARAM_SOLVER_SUBSTEPS:
+			solver_substeps = MAX(1, (int)p_value);
+			break;
 	}
 }
 
@@ -1233,6 +1863,8 @@ real_t GodotSpace3D::get_param(PhysicsServer3D::SpaceParameter p_param) const {
 			return body_time_to_sleep;
 		case PhysicsServer3D::SPACE_PARAM_SOLVER_ITERATIONS:
 			return solver_iterations;
+		case PhysicsServer3D::SPACE_PARAM_SOLVER_SUBSTEPS:
+			return solver_substeps;
 	}
 	return 0;
 }
@@ -1258,14 +1890,22 @@ GodotSpace3D::GodotSpace3D() {
 	body_angular_velocity_sleep_threshold = GLOBAL_GET("physics/3d/sleep_threshold_angular");
 	body_time_to_sleep = GLOBAL_GET("physics/3d/time_before_sleep");
 	solver_iterations = GLOBAL_GET("physics/3d/solver/solver_iterations");
+	solver_substeps = MAX(1, (int)GLOBAL_GET("physics/3d/solver/solver_substeps"));
 	contact_recycle_radius = GLOBAL_GET("physics/3d/solver/contact_recycle_radius");
 	contact_max_separation = GLOBAL_GET("physics/3d/solver/contact_max_separation");
 	contact_max_allowed_penetration = GLOBAL_GET("physics/3d/solver/contact_max_allowed_penetration");
 	contact_bias = GLOBAL_GET("physics/3d/solver/default_contact_bias");
+	deterministic = GLOBAL_GET("physics/3d/solver/deterministic");
+	structure_of_arrays_integration = GLOBAL_GET("physics/3d/solver/structure_of_arrays_integration");
 
 	broadphase = GodotBroadPhase3D::create_func();
 	broadphase->set_pair_callback(_broadphase_pair, this);
 	broadphase->set_unpair_callback(_broadphase_unpair, this);
+	broadphase->set_threaded_pairing(GLOBAL_GET("physics/3d/threaded_pairing"));
+	if (deterministic) {
+		// Expanded pairing AABBs keep pairs alive depending on past motion, which a snapshot doesn't capture.
+		broadphase->set_pairing_expansion(0.0);
+	}
 
 	direct_access = memnew(GodotPhysicsDirectSpaceState3D);
 	direct_access->space = this;
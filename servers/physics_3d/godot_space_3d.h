@@ -37,21 +37,37 @@
 #include "godot_body_pair_3d.h"
 #include "godot_broad_phase_3d.h"
 #include "godot_collision_object_3d.h"
+#include "godot_island_3d.h"
 #include "godot_soft_body_3d.h"
 
 #include "core/config/project_settings.h"
 #include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/paged_allocator.h"
 #include "core/typedefs.h"
 
 class GodotPhysicsDirectSpaceState3D : public PhysicsDirectSpaceState3D {
 	GDCLASS(GodotPhysicsDirectSpaceState3D, PhysicsDirectSpaceState3D);
 
+	// Rays of a batch are split in chunks of this size, processed by one task per worker thread.
+	static const int RAY_BATCH_CHUNK_SIZE = 64;
+
+	// Shape queries test many more candidates per query, so their chunks are smaller.
+	static const int SHAPE_BATCH_CHUNK_SIZE = 16;
+
+	bool _intersect_ray_candidates(const RayParameters &p_parameters, const Vector3 &p_from, const Vector3 &p_to, GodotCollisionObject3D *const *p_candidates, const int *p_candidate_shapes, int p_amount, RayResult &r_result) const;
+	void _intersect_ray_task(uint32_t p_task, void *p_userdata);
+	int _intersect_shape_candidates(const ShapeParameters &p_parameters, const GodotShape3D *p_shape, const Transform3D &p_transform, GodotCollisionObject3D *const *p_candidates, const int *p_candidate_shapes, int p_amount, ShapeResult *r_results, int p_result_max) const;
+	void _intersect_shape_task(uint32_t p_task, void *p_userdata);
+
 public:
 	GodotSpace3D *space = nullptr;
 
 	virtual int intersect_point(const PointParameters &p_parameters, ShapeResult *r_results, int p_result_max) override;
 	virtual bool intersect_ray(const RayParameters &p_parameters, RayResult &r_result) override;
+	virtual int intersect_rays(const RayParameters &p_parameters, const Vector3 *p_from, const Vector3 *p_to, int p_count, RayResult *r_results, bool *r_collided) override;
 	virtual int intersect_shape(const ShapeParameters &p_parameters, ShapeResult *r_results, int p_result_max) override;
+	virtual int intersect_shapes(const ShapeParameters &p_parameters, const Transform3D *p_transforms, int p_count, ShapeResult *r_results, int p_result_max, int *r_result_counts) override;
 	virtual bool cast_motion(const ShapeParameters &p_parameters, real_t &p_closest_safe, real_t &p_closest_unsafe, ShapeRestInfo *r_info = nullptr) override;
 	virtual bool collide_shape(const ShapeParameters &p_parameters, Vector3 *r_results, int p_result_max, int &r_result_count) override;
 	virtual bool rest_info(const ShapeParameters &p_parameters, ShapeRestInfo *r_info) override;
@@ -64,6 +80,7 @@ class GodotSpace3D {
 public:
 	enum ElapsedTime {
 		ELAPSED_TIME_INTEGRATE_FORCES,
+		ELAPSED_TIME_BROAD_PHASE,
 		ELAPSED_TIME_GENERATE_ISLANDS,
 		ELAPSED_TIME_SETUP_CONSTRAINTS,
 		ELAPSED_TIME_SOLVE_CONSTRAINTS,
@@ -91,9 +108,17 @@ private:
 
 	HashSet<GodotCollisionObject3D *> objects;
 
+	// Area pairs are created and freed as often as objects enter and leave areas, so they are pooled.
+	PagedAllocator<GodotAreaPair3D> area_pair_allocator;
+	PagedAllocator<GodotArea2Pair3D> area2_pair_allocator;
+	LocalVector<GodotAreaPair3D *> area_pairs;
+	LocalVector<GodotArea2Pair3D *> area2_pairs;
+
 	GodotArea3D *area = nullptr;
 
 	int solver_iterations = 0;
+	int solver_substeps = 1;
+	int solver_substep = 0;
 
 	real_t contact_recycle_radius = 0.0;
 	real_t contact_max_separation = 0.0;
@@ -117,8 +142,46 @@ private:
 
 	int island_count = 0;
 	int active_objects = 0;
+
+	// Islands are kept across steps and patched as constraints come and go, see GodotIsland3D.
+	PagedAllocator<GodotIsland3D> island_allocator;
+	LocalVector<GodotIsland3D *> dirty_islands;
+
+	void _island_mark_dirty(GodotIsland3D *p_island);
+	void _island_free(GodotIsland3D *p_island);
+	GodotIsland3D *_island_merge(GodotIsland3D *p_island_a, GodotIsland3D *p_island_b);
 	int collision_pairs = 0;
 
+	// Deterministic mode pairs on exact AABBs, keeps body pairs in the same order and sorts the islands,
+	// so the same state stepped again gives bit-identical results.
+	bool deterministic = false;
+
+	// Keeps the hot state of the active rigid bodies in the body states of the step while it runs.
+	bool structure_of_arrays_integration = false;
+
+	enum {
+		SNAPSHOT_MAGIC = 0x33535347, // "GSS3"
+		SNAPSHOT_VERSION = 2,
+	};
+
+	struct SnapshotHeader {
+		uint32_t magic = 0;
+		uint32_t version = 0;
+		uint32_t body_count = 0;
+		uint32_t pair_count = 0;
+		uint32_t joint_count = 0;
+		uint32_t area_pair_count = 0;
+		uint32_t area2_pair_count = 0;
+	};
+
+	// Pair states of the last restored snapshot, sorted by bodies and shapes. Pairs that didn't exist yet
+	// when the snapshot was restored get their state when created in the next broadphase update.
+	LocalVector<GodotBodyPair3D::Snapshot> pending_pair_snapshots;
+
+	const GodotBodyPair3D::Snapshot *_find_pending_pair_snapshot(const GodotBodyPair3D *p_pair) const;
+	// Soft bodies aren't part of snapshots, spaces with them can't be saved or restored.
+	bool _has_state_outside_snapshot() const;
+
 	RID static_global_body;
 
 	Vector<Vector3> contact_debug;
@@ -160,7 +223,14 @@ public:
 	void remove_object(GodotCollisionObject3D *p_object);
 	const HashSet<GodotCollisionObject3D *> &get_objects() const;
 
+	_FORCE_INLINE_ const LocalVector<GodotAreaPair3D *> &get_area_pairs() const { return area_pairs; }
+	_FORCE_INLINE_ const LocalVector<GodotArea2Pair3D *> &get_area2_pairs() const { return area2_pairs; }
+
 	_FORCE_INLINE_ int get_solver_iterations() const { return solver_iterations; }
+	_FORCE_INLINE_ int get_solver_substeps() const { return solver_substeps; }
+	// Index of the substep being solved, contacts are only reported during the first one.
+	_FORCE_INLINE_ int get_solver_substep() const { return solver_substep; }
+	_FORCE_INLINE_ void set_solver_substep(int p_substep) { solver_substep = p_substep; }
 	_FORCE_INLINE_ real_t get_contact_recycle_radius() const { return contact_recycle_radius; }
 	_FORCE_INLINE_ real_t get_contact_max_separation() const { return contact_max_separation; }
 	_FORCE_INLINE_ real_t get_contact_max_allowed_penetration() const { return contact_max_allowed_penetration; }
@@ -169,10 +239,16 @@ public:
 	_FORCE_INLINE_ real_t get_body_angular_velocity_sleep_threshold() const { return body_angular_velocity_sleep_threshold; }
 	_FORCE_INLINE_ real_t get_body_time_to_sleep() const { return body_time_to_sleep; }
 
+	_FORCE_INLINE_ bool is_deterministic() const { return deterministic; }
+	_FORCE_INLINE_ bool is_structure_of_arrays_integration_enabled() const { return structure_of_arrays_integration; }
+
 	void update();
 	void setup();
 	void call_queries();
 
+	Vector<uint8_t> save_snapshot() const;
+	Error restore_snapshot(const Vector<uint8_t> &p_snapshot);
+
 	bool is_locked() const;
 	void lock();
 	void unlock();
@@ -186,6 +262,17 @@ public:
 	void set_island_count(int p_island_count) { island_count = p_island_count; }
 	int get_island_count() const { return island_count; }
 
+	void island_add_body(GodotBody3D *p_body);
+	void island_remove_body(GodotBody3D *p_body);
+	void island_add_soft_body(GodotSoftBody3D *p_soft_body);
+	void island_remove_soft_body(GodotSoftBody3D *p_soft_body);
+	void island_add_constraint(GodotConstraint3D *p_constraint, GodotIsland3D *p_island);
+	// Static because the constraint may be removed by a body that already left the space of its island.
+	static void island_remove_constraint(GodotConstraint3D *p_constraint);
+	GodotIsland3D *island_create();
+	// Frees the dirty islands and returns their members, which have no island until they are flooded again.
+	void island_dissolve_dirty(LocalVector<GodotBody3D *> &r_bodies, LocalVector<GodotSoftBody3D *> &r_soft_bodies);
+
 	void set_active_objects(int p_active_objects) { active_objects = p_active_objects; }
 	int get_active_objects() const { return active_objects; }
 
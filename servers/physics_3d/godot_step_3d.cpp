@@ -30,86 +30,182 @@
 
 #include "godot_step_3d.h"
 
+#include "godot_collision_solver_3d.h"
 #include "godot_joint_3d.h"
 
 #include "core/object/worker_thread_pool.h"
 #include "core/os/os.h"
 
-#define BODY_ISLAND_COUNT_RESERVE 128
-#define BODY_ISLAND_SIZE_RESERVE 512
 #define ISLAND_COUNT_RESERVE 128
-#define ISLAND_SIZE_RESERVE 512
 #define CONSTRAINT_COUNT_RESERVE 1024
+#define CCD_CANDIDATE_MAX 256
 
-void GodotStep3D::_populate_island(GodotBody3D *p_body, LocalVector<GodotBody3D *> &p_body_island, LocalVector<GodotConstraint3D *> &p_constraint_island) {
-	p_body->set_island_step(_step);
-
-	if (p_body->get_mode() > PhysicsServer3D::BODY_MODE_KINEMATIC) {
-		// Only rigid bodies are tested for activation.
-		p_body_island.push_back(p_body);
+struct GodotConstraint3DOrderComparator {
+	_FORCE_INLINE_ bool operator()(const GodotConstraint3D *p_a, const GodotConstraint3D *p_b) const {
+		if (p_a->get_body_count() != p_b->get_body_count()) {
+			return p_a->get_body_count() < p_b->get_body_count();
+		}
+		for (int i = 0; i < p_a->get_body_count(); i++) {
+			uint64_t id_a = p_a->get_body_ptr()[i]->get_self().get_id();
+			uint64_t id_b = p_b->get_body_ptr()[i]->get_self().get_id();
+			if (id_a != id_b) {
+				return id_a < id_b;
+			}
+		}
+		return p_a->get_order_key() < p_b->get_order_key();
 	}
+};
 
-	for (const KeyValue<GodotConstraint3D *, int> &E : p_body->get_constraint_map()) {
-		GodotConstraint3D *constraint = const_cast<GodotConstraint3D *>(E.key);
-		if (constraint->get_island_step() == _step) {
+void GodotStep3D::_push_constraint_bodies(GodotSpace3D *p_space, GodotIsland3D *p_island, GodotConstraint3D *p_constraint, int p_skip_index) {
+	// Find connected rigid bodies.
+	for (int i = 0; i < p_constraint->get_body_count(); i++) {
+		if (i == p_skip_index) {
+			continue;
+		}
+		GodotBody3D *other_body = p_constraint->get_body_ptr()[i];
+		if (other_body->get_island()) {
 			continue; // Already processed.
 		}
-		constraint->set_island_step(_step);
-		p_constraint_island.push_back(constraint);
+		if (other_body->get_mode() == PhysicsServer3D::BODY_MODE_STATIC || other_body->get_space() != p_space) {
+			continue; // Static bodies and bodies from other spaces don't connect islands.
+		}
+		p_island->add_body(other_body);
+		island_body_stack.push_back(other_body);
+	}
 
-		all_constraints.push_back(constraint);
+	// Find connected soft bodies.
+	for (int i = 0; i < p_constraint->get_soft_body_count(); i++) {
+		GodotSoftBody3D *soft_body = p_constraint->get_soft_body_ptr(i);
+		if (soft_body->get_island() || soft_body->get_space() != p_space) {
+			continue; // Already processed.
+		}
+		p_island->add_soft_body(soft_body);
+		island_soft_body_stack.push_back(soft_body);
+	}
+}
 
-		// Find connected rigid bodies.
-		for (int i = 0; i < constraint->get_body_count(); i++) {
-			if (i == E.value) {
-				continue;
-			}
-			GodotBody3D *other_body = constraint->get_body_ptr()[i];
-			if (other_body->get_island_step() == _step) {
-				continue; // Already processed.
+void GodotStep3D::_populate_island(GodotSpace3D *p_space, GodotIsland3D *p_island) {
+	// Iterative flood fill from the bodies already on the stacks,
+	// so long chains of connected bodies can't overflow the call stack.
+	while (!island_body_stack.is_empty() || !island_soft_body_stack.is_empty()) {
+		if (!island_body_stack.is_empty()) {
+			GodotBody3D *body = island_body_stack[island_body_stack.size() - 1];
+			island_body_stack.remove_at(island_body_stack.size() - 1);
+
+			for (const KeyValue<GodotConstraint3D *, int> &E : body->get_constraint_map()) {
+				GodotConstraint3D *constraint = const_cast<GodotConstraint3D *>(E.key);
+				if (constraint->get_island()) {
+					continue; // Already processed.
+				}
+				p_island->add_constraint(constraint);
+
+				_push_constraint_bodies(p_space, p_island, constraint, E.value);
 			}
-			if (other_body->get_mode() == PhysicsServer3D::BODY_MODE_STATIC) {
-				continue; // Static bodies don't connect islands.
+		} else {
+			GodotSoftBody3D *soft_body = island_soft_body_stack[island_soft_body_stack.size() - 1];
+			island_soft_body_stack.remove_at(island_soft_body_stack.size() - 1);
+
+			for (const GodotConstraint3D *E : soft_body->get_constraints()) {
+				GodotConstraint3D *constraint = const_cast<GodotConstraint3D *>(E);
+				if (constraint->get_island()) {
+					continue; // Already processed.
+				}
+				p_island->add_constraint(constraint);
+
+				_push_constraint_bodies(p_space, p_island, constraint, -1);
 			}
-			_populate_island(other_body, p_body_island, p_constraint_island);
 		}
+	}
+}
 
-		// Find connected soft bodies.
-		for (int i = 0; i < constraint->get_soft_body_count(); i++) {
-			GodotSoftBody3D *soft_body = constraint->get_soft_body_ptr(i);
-			if (soft_body->get_island_step() == _step) {
-				continue; // Already processed.
-			}
-			_populate_island_soft_body(soft_body, p_body_island, p_constraint_island);
+void GodotStep3D::_update_islands(GodotSpace3D *p_space) {
+	// Islands are merged as soon as a constraint connects them, only the ones that lost a constraint
+	// or a body are flooded again here, as they may have split.
+	island_body_seeds.clear();
+	island_soft_body_seeds.clear();
+	p_space->island_dissolve_dirty(island_body_seeds, island_soft_body_seeds);
+
+	for (GodotBody3D *body : island_body_seeds) {
+		if (body->get_island()) {
+			continue; // Reached from another seed.
 		}
+		GodotIsland3D *island = p_space->island_create();
+		island->add_body(body);
+		island_body_stack.push_back(body);
+		_populate_island(p_space, island);
 	}
-}
 
-void GodotStep3D::_populate_island_soft_body(GodotSoftBody3D *p_soft_body, LocalVector<GodotBody3D *> &p_body_island, LocalVector<GodotConstraint3D *> &p_constraint_island) {
-	p_soft_body->set_island_step(_step);
+	for (GodotSoftBody3D *soft_body : island_soft_body_seeds) {
+		if (soft_body->get_island()) {
+			continue; // Reached from another seed.
+		}
+		GodotIsland3D *island = p_space->island_create();
+		island->add_soft_body(soft_body);
+		island_soft_body_stack.push_back(soft_body);
+		_populate_island(p_space, island);
+	}
+}
 
-	for (const GodotConstraint3D *E : p_soft_body->get_constraints()) {
-		GodotConstraint3D *constraint = const_cast<GodotConstraint3D *>(E);
-		if (constraint->get_island_step() == _step) {
-			continue; // Already processed.
+void GodotStep3D::_activate_island(GodotSpace3D *p_space, GodotIsland3D *p_island) {
+	if (!p_island || p_island->step == _step) {
+		return;
+	}
+	p_island->step = _step;
+
+	if (p_space->is_deterministic() && !p_island->sorted) {
+		// The order of the constraints depends on the order they were added in and islands were merged in,
+		// sort them so they are always solved in the same order.
+		p_island->constraints.sort_custom<GodotConstraint3DOrderComparator>();
+		for (uint32_t i = 0; i < p_island->constraints.size(); i++) {
+			p_island->constraints[i]->set_island(p_island, i);
 		}
-		constraint->set_island_step(_step);
-		p_constraint_island.push_back(constraint);
+		p_island->sorted = true;
+	}
 
-		all_constraints.push_back(constraint);
+	active_islands.push_back(p_island);
+}
 
-		// Find connected rigid bodies.
-		for (int i = 0; i < constraint->get_body_count(); i++) {
-			GodotBody3D *body = constraint->get_body_ptr()[i];
-			if (body->get_island_step() == _step) {
-				continue; // Already processed.
-			}
-			if (body->get_mode() == PhysicsServer3D::BODY_MODE_STATIC) {
-				continue; // Static bodies don't connect islands.
-			}
-			_populate_island(body, p_body_island, p_constraint_island);
+void GodotStep3D::_test_area_pair(uint32_t p_pair_index, void *p_userdata) {
+	uint32_t area_pair_count = area_pair_tests.size();
+	if (p_pair_index < area_pair_count) {
+		area_pair_results[p_pair_index] = area_pair_tests[p_pair_index]->test_collision();
+	} else {
+		area_pair_results[p_pair_index] = area2_pair_tests[p_pair_index - area_pair_count]->test_collision();
+	}
+}
+
+void GodotStep3D::_update_area_pairs(GodotSpace3D *p_space) {
+	area_pair_tests.clear();
+	area2_pair_tests.clear();
+
+	for (GodotAreaPair3D *area_pair : p_space->get_area_pairs()) {
+		if (area_pair->needs_test()) {
+			area_pair_tests.push_back(area_pair);
+		}
+	}
+	for (GodotArea2Pair3D *area2_pair : p_space->get_area2_pairs()) {
+		if (area2_pair->needs_test()) {
+			area2_pair_tests.push_back(area2_pair);
 		}
 	}
+
+	uint32_t area_pair_count = area_pair_tests.size();
+	uint32_t total_pair_count = area_pair_count + area2_pair_tests.size();
+	if (total_pair_count == 0) {
+		return;
+	}
+
+	area_pair_results.resize(total_pair_count);
+	WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotStep3D::_test_area_pair, nullptr, total_pair_count, -1, true, SNAME("Physics3DAreaPairTest"));
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+
+	// Monitor queries and area overrides aren't thread-safe, enter and exit changes are applied afterwards.
+	for (uint32_t i = 0; i < area_pair_count; i++) {
+		area_pair_tests[i]->update_collision(area_pair_results[i]);
+	}
+	for (uint32_t i = area_pair_count; i < total_pair_count; i++) {
+		area2_pair_tests[i - area_pair_count]->update_collision(area_pair_results[i]);
+	}
 }
 
 void GodotStep3D::_setup_constraint(uint32_t p_constraint_index, void *p_userdata) {
@@ -117,12 +213,12 @@ void GodotStep3D::_setup_constraint(uint32_t p_constraint_index, void *p_userdat
 	constraint->setup(delta);
 }
 
-void GodotStep3D::_pre_solve_island(LocalVector<GodotConstraint3D *> &p_constraint_island) const {
+void GodotStep3D::_pre_solve_island(LocalVector<GodotConstraint3D *> &p_constraint_island, bool p_substep) const {
 	uint32_t constraint_count = p_constraint_island.size();
 	uint32_t valid_constraint_count = 0;
 	for (uint32_t constraint_index = 0; constraint_index < constraint_count; ++constraint_index) {
 		GodotConstraint3D *constraint = p_constraint_island[constraint_index];
-		if (p_constraint_island[constraint_index]->pre_solve(delta)) {
+		if (p_substep ? constraint->pre_solve_substep(delta) : constraint->pre_solve(delta)) {
 			// Keep this constraint for solving.
 			p_constraint_island[valid_constraint_count++] = constraint;
 		}
@@ -158,21 +254,27 @@ void GodotStep3D::_solve_island(uint32_t p_island_index, void *p_userdata) {
 	}
 }
 
-void GodotStep3D::_check_suspend(const LocalVector<GodotBody3D *> &p_body_island) const {
+void GodotStep3D::_check_suspend(const GodotIsland3D *p_island, real_t p_step) const {
 	bool can_sleep = true;
 
-	uint32_t body_count = p_body_island.size();
+	uint32_t body_count = p_island->bodies.size();
 	for (uint32_t body_index = 0; body_index < body_count; ++body_index) {
-		GodotBody3D *body = p_body_island[body_index];
+		GodotBody3D *body = p_island->bodies[body_index];
+		if (body->get_mode() <= PhysicsServer3D::BODY_MODE_KINEMATIC) {
+			continue; // Only rigid bodies are tested for activation.
+		}
 
-		if (!body->sleep_test(delta)) {
+		if (!body->sleep_test(p_step)) {
 			can_sleep = false;
 		}
 	}
 
 	// Put all to sleep or wake up everyone.
 	for (uint32_t body_index = 0; body_index < body_count; ++body_index) {
-		GodotBody3D *body = p_body_island[body_index];
+		GodotBody3D *body = p_island->bodies[body_index];
+		if (body->get_mode() <= PhysicsServer3D::BODY_MODE_KINEMATIC) {
+			continue;
+		}
 
 		bool active = body->is_active();
 
@@ -182,6 +284,161 @@ void GodotStep3D::_check_suspend(const LocalVector<GodotBody3D *> &p_body_island
 	}
 }
 
+// _test_ccd prevents tunneling by slowing down a high velocity body that is about to collide so that next frame it will be at an appropriate location to collide (i.e. slight overlap)
+// Warning: the way velocity is adjusted down to cause a collision means the momentum will be weaker than it should for a bounce!
+// Process: only proceed if body A's motion is high relative to its size.
+// sweep forward along motion vector to see if A is going to enter/pass B's collider next frame, only proceed if it does.
+// Convex shapes are advanced conservatively to the time of impact, concave ones cast rays from their support points.
+// adjust the velocity of A down so that it will just slightly intersect the collider instead of blowing right past it.
+bool GodotStep3D::_test_ccd(real_t p_step, GodotBody3D *p_A, int p_shape_A, const Transform3D &p_xform_A, GodotBody3D *p_B, int p_shape_B, const Transform3D &p_xform_B) {
+	GodotShape3D *shape_A_ptr = p_A->get_shape(p_shape_A);
+
+	Vector3 motion = p_A->get_linear_velocity() * p_step;
+	real_t mlen = motion.length();
+	if (mlen < CMP_EPSILON) {
+		return false;
+	}
+
+	Vector3 mnormal = motion / mlen;
+
+	real_t min = 0.0, max = 0.0;
+	shape_A_ptr->project_range(mnormal, p_xform_A, min, max);
+
+	// Did it move enough in this direction to even attempt raycast?
+	// Let's say it should move more than 1/3 the size of the object in that axis.
+	bool fast_object = mlen > (max - min) * 0.3;
+	if (!fast_object) {
+		return false; // moving slow enough that there's no chance of tunneling.
+	}
+
+	// A is moving fast enough that tunneling might occur. See if it's really about to collide.
+
+	// Roughly predict body B's position in the next frame (ignoring collisions).
+	Transform3D predicted_xform_B = p_xform_B.translated(p_B->get_linear_velocity() * p_step);
+
+	real_t hit_length = 0.0;
+
+	if (!shape_A_ptr->is_concave()) {
+		// Advance A towards B conservatively. Unlike casting rays from a few support points,
+		// this can't step over thin features of B or miss them with the edges of A.
+		real_t toi = 0.0;
+		if (!GodotCollisionSolver3D::solve_toi(shape_A_ptr, p_xform_A, motion, p_B->get_shape(p_shape_B), predicted_xform_B, (max - min) * 0.005, toi)) {
+			// No hit within this frame's motion, we'll check again next frame once they're closer.
+			return false;
+		}
+		hit_length = toi * mlen;
+	} else {
+		// Support points are the farthest forward points on A in the direction of the motion vector.
+		// i.e. the candidate points of which one should hit B first if any collision does occur.
+		static const int max_supports = 16;
+		Vector3 supports_A[max_supports];
+		int support_count_A;
+		GodotShape3D::FeatureType support_type_A;
+		// Convert mnormal into body A's local xform because get_supports requires (and returns) local coordinates.
+		shape_A_ptr->get_supports(p_xform_A.basis.xform_inv(mnormal).normalized(), max_supports, supports_A, support_count_A, support_type_A);
+
+		// Cast a segment from each support point of A in the motion direction.
+		int segment_support_idx = -1;
+		float segment_hit_length = FLT_MAX;
+		Vector3 segment_hit_local;
+		for (int i = 0; i < support_count_A; i++) {
+			supports_A[i] = p_xform_A.xform(supports_A[i]);
+
+			Vector3 from = supports_A[i];
+			Vector3 to = from + motion;
+
+			Transform3D from_inv = predicted_xform_B.affine_inverse();
+
+			// Back up 10% of the per-frame motion behind the support point and use that as the beginning of our cast.
+			// At high speeds, this may mean we're actually casting from well behind the body instead of inside it, which is odd.
+			// But it still works out.
+			Vector3 local_from = from_inv.xform(from - motion * 0.1);
+			Vector3 local_to = from_inv.xform(to);
+
+			Vector3 rpos, rnorm;
+			int fi = -1;
+			if (p_B->get_shape(p_shape_B)->intersect_segment(local_from, local_to, rpos, rnorm, fi, true)) {
+				float hit_length_local = local_from.distance_to(rpos);
+				if (hit_length_local < segment_hit_length) {
+					segment_support_idx = i;
+					segment_hit_length = hit_length_local;
+					segment_hit_local = rpos;
+				}
+			}
+		}
+
+		if (segment_support_idx == -1) {
+			// There was no hit. Since the segment is the length of per-frame motion, this means the bodies will not
+			// actually collide yet on next frame. We'll probably check again next frame once they're closer.
+			return false;
+		}
+
+		Vector3 hitpos = predicted_xform_B.xform(segment_hit_local);
+		hit_length = hitpos.distance_to(supports_A[segment_support_idx]);
+	}
+
+	// Adding 1% of body length to the distance between collision and support point
+	// should cause body A's support point to arrive just within B's collider next frame.
+	real_t newlen = hit_length + (max - min) * 0.01;
+	// FIXME: This doesn't always work well when colliding with a triangle face of a trimesh shape.
+
+	p_A->set_linear_velocity((mnormal * newlen) / p_step);
+
+	return true;
+}
+
+void GodotStep3D::_solve_ccd(GodotSpace3D *p_space, real_t p_step) {
+	GodotBroadPhase3D *broadphase = p_space->get_broadphase();
+
+	for (GodotBody3D *body : ccd_bodies) {
+		Vector3 motion = body->get_linear_velocity() * p_step;
+		if (motion.length_squared() < CMP_EPSILON2) {
+			continue;
+		}
+
+		for (int shape_idx = 0; shape_idx < body->get_shape_count(); shape_idx++) {
+			if (body->is_shape_disabled(shape_idx)) {
+				continue;
+			}
+
+			// Only what the shape sweeps through this step can be hit, there's no need to extend its broad phase bounds.
+			int candidate_count = broadphase->cull_swept_aabb(body->get_shape_aabb(shape_idx), motion, ccd_candidates.ptr(), CCD_CANDIDATE_MAX, ccd_candidate_shapes.ptr());
+			if (candidate_count == 0) {
+				continue;
+			}
+
+			GodotShape3D *shape = body->get_shape(shape_idx);
+			Transform3D xform = body->get_transform() * body->get_shape_transform(shape_idx);
+
+			for (int i = 0; i < candidate_count; i++) {
+				GodotCollisionObject3D *candidate = ccd_candidates[i];
+				if (candidate == body || candidate->get_type() != GodotCollisionObject3D::TYPE_BODY) {
+					continue;
+				}
+
+				GodotBody3D *other = static_cast<GodotBody3D *>(candidate);
+				if (!body->interacts_with(other) || body->has_exception(other->get_self()) || other->has_exception(body->get_self())) {
+					continue;
+				}
+
+				int other_shape_idx = ccd_candidate_shapes[i];
+				if (other->is_shape_disabled(other_shape_idx)) {
+					continue;
+				}
+
+				Transform3D other_xform = other->get_transform() * other->get_shape_transform(other_shape_idx);
+
+				// Shapes already in contact are handled by the solver.
+				if (GodotCollisionSolver3D::solve_static(shape, xform, other->get_shape(other_shape_idx), other_xform, nullptr, nullptr)) {
+					continue;
+				}
+
+				_test_ccd(p_step, body, shape_idx, xform, other, other_shape_idx, other_xform);
+			}
+		}
+	}
+}
+
 void GodotStep3D::step(GodotSpace3D *p_space, real_t p_delta) {
 	p_space->lock(); // can't access space during this
 
@@ -190,7 +447,10 @@ void GodotStep3D::step(GodotSpace3D *p_space, real_t p_delta) {
 	p_space->set_last_step(p_delta);
 
 	iterations = p_space->get_solver_iterations();
-	delta = p_delta;
+
+	// Soft bodies are simulated over the whole step, so their spaces aren't substepped.
+	int substeps = p_space->get_active_soft_body_list().first() ? 1 : p_space->get_solver_substeps();
+	delta = p_delta / substeps;
 
 	const SelfList<GodotBody3D>::List *body_list = &p_space->get_active_body_list();
 
@@ -203,13 +463,47 @@ void GodotStep3D::step(GodotSpace3D *p_space, real_t p_delta) {
 
 	int active_count = 0;
 
+	const bool use_body_states = p_space->is_structure_of_arrays_integration_enabled();
+
+	force_integration_bodies.clear();
+	body_states_pending.clear();
+	ccd_bodies.clear();
+
 	const SelfList<GodotBody3D> *b = body_list->first();
 	while (b) {
-		b->self()->integrate_forces(p_delta);
+		if (b->self()->integrate_forces(p_delta)) {
+			if (use_body_states) {
+				b->self()->acquire_states(&body_states, true);
+			} else {
+				b->self()->apply_forces(delta);
+			}
+			force_integration_bodies.push_back(b->self());
+		} else {
+			b->self()->reset_applied_forces();
+			if (use_body_states && b->self()->get_mode() > PhysicsServer3D::BODY_MODE_KINEMATIC) {
+				body_states_pending.push_back(b->self());
+			}
+		}
+		if (b->self()->is_continuous_collision_detection_enabled() && b->self()->get_mode() > PhysicsServer3D::BODY_MODE_KINEMATIC) {
+			ccd_bodies.push_back(b->self());
+		}
 		b = b->next();
 		active_count++;
 	}
 
+	if (use_body_states) {
+		for (GodotBody3D *body : body_states_pending) {
+			body->acquire_states(&body_states, false);
+		}
+		body_states.apply_forces(delta);
+	}
+
+	b = body_list->first();
+	while (b) {
+		b->self()->finish_integrate_forces(p_delta);
+		b = b->next();
+	}
+
 	/* UPDATE SOFT BODY MOTION */
 
 	const SelfList<GodotSoftBody3D> *sb = soft_body_list->first();
@@ -221,116 +515,98 @@ void GodotStep3D::step(GodotSpace3D *p_space, real_t p_delta) {
 
 	p_space->set_active_objects(active_count);
 
-	// Update the broadphase to register collision pairs.
-	p_space->update();
-
 	{ //profile
 		profile_endtime = OS::get_singleton()->get_ticks_usec();
 		p_space->set_elapsed_time(GodotSpace3D::ELAPSED_TIME_INTEGRATE_FORCES, profile_endtime - profile_begtime);
 		profile_begtime = profile_endtime;
 	}
 
-	/* GENERATE CONSTRAINT ISLANDS FOR MOVING AREAS */
+	/* BROAD PHASE */
 
-	uint32_t island_count = 0;
-
-	const SelfList<GodotArea3D>::List &aml = p_space->get_moved_area_list();
+	// Update the broadphase to register collision pairs.
+	p_space->update();
 
-	while (aml.first()) {
-		for (GodotConstraint3D *E : aml.first()->self()->get_constraints()) {
-			GodotConstraint3D *constraint = E;
-			if (constraint->get_island_step() == _step) {
-				continue;
-			}
-			constraint->set_island_step(_step);
+	{ //profile
+		profile_endtime = OS::get_singleton()->get_ticks_usec();
+		p_space->set_elapsed_time(GodotSpace3D::ELAPSED_TIME_BROAD_PHASE, profile_endtime - profile_begtime);
+		profile_begtime = profile_endtime;
+	}
 
-			// Each constraint can be on a separate island for areas as there's no solving phase.
-			++island_count;
-			if (constraint_islands.size() < island_count) {
-				constraint_islands.resize(island_count);
-			}
-			LocalVector<GodotConstraint3D *> &constraint_island = constraint_islands[island_count - 1];
-			constraint_island.clear();
+	/* CONTINUOUS COLLISION DETECTION */
 
-			all_constraints.push_back(constraint);
-			constraint_island.push_back(constraint);
-		}
-		p_space->area_remove_from_moved_list((SelfList<GodotArea3D> *)aml.first()); //faster to remove here
+	// Once for the whole step, the substeps integrate the velocities it limited.
+	if (!ccd_bodies.is_empty()) {
+		_solve_ccd(p_space, p_delta);
 	}
 
-	/* GENERATE CONSTRAINT ISLANDS FOR ACTIVE RIGID BODIES */
+	/* GENERATE CONSTRAINT ISLANDS FOR ACTIVE BODIES */
 
-	b = body_list->first();
+	_update_islands(p_space);
 
-	uint32_t body_island_count = 0;
+	// Islands are kept across steps, only the ones with an active body are solved.
+	active_islands.clear();
 
+	b = body_list->first();
 	while (b) {
-		GodotBody3D *body = b->self();
-
-		if (body->get_island_step() != _step) {
-			++body_island_count;
-			if (body_islands.size() < body_island_count) {
-				body_islands.resize(body_island_count);
-			}
-			LocalVector<GodotBody3D *> &body_island = body_islands[body_island_count - 1];
-			body_island.clear();
-			body_island.reserve(BODY_ISLAND_SIZE_RESERVE);
+		_activate_island(p_space, b->self()->get_island());
+		b = b->next();
+	}
 
-			++island_count;
-			if (constraint_islands.size() < island_count) {
-				constraint_islands.resize(island_count);
-			}
-			LocalVector<GodotConstraint3D *> &constraint_island = constraint_islands[island_count - 1];
-			constraint_island.clear();
-			constraint_island.reserve(ISLAND_SIZE_RESERVE);
+	sb = soft_body_list->first();
+	while (sb) {
+		_activate_island(p_space, sb->self()->get_island());
+		sb = sb->next();
+	}
 
-			_populate_island(body, body_island, constraint_island);
+	// The constraints are copied because solving modifies the islands.
+	uint32_t island_count = 0;
 
-			if (body_island.is_empty()) {
-				--body_island_count;
-			}
+	for (const GodotIsland3D *island : active_islands) {
+		if (island->constraints.is_empty()) {
+			continue;
+		}
+		++island_count;
+		if (constraint_islands.size() < island_count) {
+			constraint_islands.resize(island_count);
+		}
+		LocalVector<GodotConstraint3D *> &constraint_island = constraint_islands[island_count - 1];
+		constraint_island = island->constraints;
 
-			if (constraint_island.is_empty()) {
-				--island_count;
-			}
+		for (GodotConstraint3D *constraint : constraint_island) {
+			constraint->set_island_step(_step);
+			all_constraints.push_back(constraint);
 		}
-		b = b->next();
 	}
 
-	/* GENERATE CONSTRAINT ISLANDS FOR ACTIVE SOFT BODIES */
+	/* UPDATE AREA OVERLAPS */
 
-	sb = soft_body_list->first();
-	while (sb) {
-		GodotSoftBody3D *soft_body = sb->self();
+	// Needs to happen before the moved areas are removed from their list below.
+	_update_area_pairs(p_space);
+
+	/* GENERATE CONSTRAINT ISLANDS FOR MOVING AREAS */
 
-		if (soft_body->get_island_step() != _step) {
-			++body_island_count;
-			if (body_islands.size() < body_island_count) {
-				body_islands.resize(body_island_count);
+	const SelfList<GodotArea3D>::List &aml = p_space->get_moved_area_list();
+
+	while (aml.first()) {
+		for (GodotConstraint3D *E : aml.first()->self()->get_constraints()) {
+			GodotConstraint3D *constraint = E;
+			if (constraint->get_island_step() == _step) {
+				continue;
 			}
-			LocalVector<GodotBody3D *> &body_island = body_islands[body_island_count - 1];
-			body_island.clear();
-			body_island.reserve(BODY_ISLAND_SIZE_RESERVE);
+			constraint->set_island_step(_step);
 
+			// Each constraint can be on a separate island for areas as there's no solving phase.
 			++island_count;
 			if (constraint_islands.size() < island_count) {
 				constraint_islands.resize(island_count);
 			}
 			LocalVector<GodotConstraint3D *> &constraint_island = constraint_islands[island_count - 1];
 			constraint_island.clear();
-			constraint_island.reserve(ISLAND_SIZE_RESERVE);
-
-			_populate_island_soft_body(soft_body, body_island, constraint_island);
 
-			if (body_island.is_empty()) {
-				--body_island_count;
-			}
-
-			if (constraint_island.is_empty()) {
-				--island_count;
-			}
+			all_constraints.push_back(constraint);
+			constraint_island.push_back(constraint);
 		}
-		sb = sb->next();
+		p_space->area_remove_from_moved_list((SelfList<GodotArea3D> *)aml.first()); //faster to remove here
 	}
 
 	p_space->set_island_count((int)island_count);
@@ -353,39 +629,101 @@ void GodotStep3D::step(GodotSpace3D *p_space, real_t p_delta) {
 		profile_begtime = profile_endtime;
 	}
 
-	/* PRE-SOLVE CONSTRAINT ISLANDS */
+	p_space->set_solver_substep(0);
 
-	// Warning: This doesn't run on threads, because it involves thread-unsafe processing.
-	for (uint32_t island_index = 0; island_index < island_count; ++island_index) {
-		_pre_solve_island(constraint_islands[island_index]);
-	}
+	uint64_t integrate_velocities_time = 0;
 
-	/* SOLVE CONSTRAINT ISLANDS */
+	for (int substep = 0; substep < substeps; substep++) {
+		if (substep > 0) {
+			/* INTEGRATE FORCES FOR THE SUBSTEP */
 
-	// Warning: _solve_island modifies the constraint islands for optimization purpose,
-	// their content is not reliable after these calls and shouldn't be used anymore.
-	group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotStep3D::_solve_island, nullptr, island_count, -1, true, SNAME("Physics3DConstraintSolveIslands"));
-	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+			p_space->set_solver_substep(substep);
 
-	{ //profile
-		profile_endtime = OS::get_singleton()->get_ticks_usec();
-		p_space->set_elapsed_time(GodotSpace3D::ELAPSED_TIME_SOLVE_CONSTRAINTS, profile_endtime - profile_begtime);
-		profile_begtime = profile_endtime;
+			if (use_body_states) {
+				body_states.apply_forces(delta);
+				body_states.reset_biased_velocities();
+			} else {
+				for (GodotBody3D *body : force_integration_bodies) {
+					body->apply_forces(delta);
+				}
+			}
+
+			b = body_list->first();
+			while (b) {
+				if (!b->self()->get_states()) {
+					b->self()->reset_biased_velocities();
+				}
+				b = b->next();
+			}
+
+			// Solving modified the islands, copy them again. Islands of moving areas only need one pre-solve.
+			island_count = 0;
+			for (const GodotIsland3D *island : active_islands) {
+				if (!island->constraints.is_empty()) {
+					constraint_islands[island_count++] = island->constraints;
+				}
+			}
+		}
+
+		/* PRE-SOLVE CONSTRAINT ISLANDS */
+
+		// Warning: This doesn't run on threads, because it involves thread-unsafe processing.
+		for (uint32_t island_index = 0; island_index < island_count; ++island_index) {
+			_pre_solve_island(constraint_islands[island_index], substep > 0);
+		}
+
+		/* SOLVE CONSTRAINT ISLANDS */
+
+		// Warning: _solve_island modifies the constraint islands for optimization purpose,
+		// their content is not reliable after these calls and shouldn't be used anymore.
+		group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotStep3D::_solve_island, nullptr, island_count, -1, true, SNAME("Physics3DConstraintSolveIslands"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+
+		/* INTEGRATE VELOCITIES */
+
+		uint64_t integrate_velocities_begtime = OS::get_singleton()->get_ticks_usec();
+
+		if (use_body_states) {
+			body_states.integrate_velocities(delta);
+		}
+
+		// Transforms are set in the active list order, this updates the broad phase.
+		b = body_list->first();
+		while (b) {
+			const SelfList<GodotBody3D> *n = b->next();
+			GodotBody3D *body = b->self();
+			if (body->get_states()) {
+				body->set_integrated_transform(body_states.transform[body->get_state_slot()]);
+			} else {
+				// Kinematic bodies, and bodies woken up during the step.
+				body->integrate_velocities(delta);
+			}
+			b = n;
+		}
+
+		integrate_velocities_time += OS::get_singleton()->get_ticks_usec() - integrate_velocities_begtime;
 	}
 
-	/* INTEGRATE VELOCITIES */
+	p_space->set_solver_substep(0);
 
-	b = body_list->first();
-	while (b) {
-		const SelfList<GodotBody3D> *n = b->next();
-		b->self()->integrate_velocities(p_delta);
-		b = n;
+	// Velocities go back to the bodies before they are tested for sleep.
+	body_states.release();
+
+	// Applied forces act over the whole step, so they are only reset once every substep used them.
+	for (GodotBody3D *body : force_integration_bodies) {
+		body->reset_applied_forces();
+	}
+
+	{ //profile
+		profile_endtime = OS::get_singleton()->get_ticks_usec();
+		p_space->set_elapsed_time(GodotSpace3D::ELAPSED_TIME_SOLVE_CONSTRAINTS, profile_endtime - profile_begtime - integrate_velocities_time);
+		profile_begtime = profile_endtime - integrate_velocities_time;
 	}
 
 	/* SLEEP / WAKE UP ISLANDS */
 
-	for (uint32_t island_index = 0; island_index < body_island_count; ++island_index) {
-		_check_suspend(body_islands[island_index]);
+	for (const GodotIsland3D *island : active_islands) {
+		_check_suspend(island, p_delta);
 	}
 
 	/* UPDATE SOFT BODY CONSTRAINTS */
@@ -409,9 +747,11 @@ void GodotStep3D::step(GodotSpace3D *p_space, real_t p_delta) {
 }
 
 GodotStep3D::GodotStep3D() {
-	body_islands.reserve(BODY_ISLAND_COUNT_RESERVE);
 	constraint_islands.reserve(ISLAND_COUNT_RESERVE);
+	active_islands.reserve(ISLAND_COUNT_RESERVE);
 	all_constraints.reserve(CONSTRAINT_COUNT_RESERVE);
+	ccd_candidates.resize(CCD_CANDIDATE_MAX);
+	ccd_candidate_shapes.resize(CCD_CANDIDATE_MAX);
 }
 
 GodotStep3D::~GodotStep3D() {
@@ -31,6 +31,7 @@
 #ifndef GODOT_STEP_3D_H
 #define GODOT_STEP_3D_H
 
+#include "godot_body_states_3d.h"
 #include "godot_space_3d.h"
 
 #include "core/templates/local_vector.h"
@@ -41,16 +42,49 @@ class GodotStep3D {
 	int iterations = 0;
 	real_t delta = 0.0;
 
-	LocalVector<LocalVector<GodotBody3D *>> body_islands;
 	LocalVector<LocalVector<GodotConstraint3D *>> constraint_islands;
 	LocalVector<GodotConstraint3D *> all_constraints;
 
-	void _populate_island(GodotBody3D *p_body, LocalVector<GodotBody3D *> &p_body_island, LocalVector<GodotConstraint3D *> &p_constraint_island);
-	void _populate_island_soft_body(GodotSoftBody3D *p_soft_body, LocalVector<GodotBody3D *> &p_body_island, LocalVector<GodotConstraint3D *> &p_constraint_island);
+	// Area pairs tested in the current step, and their results.
+	LocalVector<GodotAreaPair3D *> area_pair_tests;
+	LocalVector<GodotArea2Pair3D *> area2_pair_tests;
+	LocalVector<uint8_t> area_pair_results;
+
+	// Islands with an active body in the current step.
+	LocalVector<GodotIsland3D *> active_islands;
+
+	// Members of the dirty islands, and the bodies left to visit while populating an island.
+	LocalVector<GodotBody3D *> island_body_seeds;
+	LocalVector<GodotSoftBody3D *> island_soft_body_seeds;
+	LocalVector<GodotBody3D *> island_body_stack;
+	LocalVector<GodotSoftBody3D *> island_soft_body_stack;
+
+	// Bodies that have forces applied in the current step, again for every solver substep.
+	LocalVector<GodotBody3D *> force_integration_bodies;
+
+	// Hot state of the active rigid bodies when the space integrates over structure of arrays, the bodies
+	// read and write it from the integration of forces until the velocities of the last substep are integrated.
+	GodotBodyStates3D body_states;
+	// Active rigid bodies without forces to apply, given slots after the ones with forces.
+	LocalVector<GodotBody3D *> body_states_pending;
+
+	// Bodies with continuous collision detection in the current step, and the broad phase results of their sweeps.
+	LocalVector<GodotBody3D *> ccd_bodies;
+	LocalVector<GodotCollisionObject3D *> ccd_candidates;
+	LocalVector<int> ccd_candidate_shapes;
+
+	void _push_constraint_bodies(GodotSpace3D *p_space, GodotIsland3D *p_island, GodotConstraint3D *p_constraint, int p_skip_index);
+	void _populate_island(GodotSpace3D *p_space, GodotIsland3D *p_island);
+	void _update_islands(GodotSpace3D *p_space);
+	void _activate_island(GodotSpace3D *p_space, GodotIsland3D *p_island);
+	void _test_area_pair(uint32_t p_pair_index, void *p_userdata = nullptr);
+	void _update_area_pairs(GodotSpace3D *p_space);
 	void _setup_constraint(uint32_t p_constraint_index, void *p_userdata = nullptr);
-	void _pre_solve_island(LocalVector<GodotConstraint3D *> &p_constraint_island) const;
+	void _pre_solve_island(LocalVector<GodotConstraint3D *> &p_constraint_island, bool p_substep) const;
 	void _solve_island(uint32_t p_island_index, void *p_userdata = nullptr);
-	void _check_suspend(const LocalVector<GodotBody3D *> &p_body_island) const;
+	void _check_suspend(const GodotIsland3D *p_island, real_t p_step) const;
+	static bool _test_ccd(real_t p_step, GodotBody3D *p_A, int p_shape_A, const Transform3D &p_xform_A, GodotBody3D *p_B, int p_shape_B, const Transform3D &p_xform_B);
+	void _solve_ccd(GodotSpace3D *p_space, real_t p_step);
 
 public:
 	void step(GodotSpace3D *p_space, real_t p_delta);
@@ -278,6 +278,19 @@ void GodotConeTwistJoint3D::solve(real_t p_timestep) {
 	}
 }
 
+void GodotConeTwistJoint3D::save_snapshot(Snapshot &r_snapshot) const {
+	GodotJoint3D::save_snapshot(r_snapshot);
+	r_snapshot.impulses[0] = m_appliedImpulse;
+	r_snapshot.impulses[1] = m_accTwistLimitImpulse;
+	r_snapshot.impulses[2] = m_accSwingLimitImpulse;
+}
+
+void GodotConeTwistJoint3D::load_snapshot(const Snapshot &p_snapshot) {
+	m_appliedImpulse = p_snapshot.impulses[0];
+	m_accTwistLimitImpulse = p_snapshot.impulses[1];
+	m_accSwingLimitImpulse = p_snapshot.impulses[2];
+}
+
 void GodotConeTwistJoint3D::set_param(PhysicsServer3D::ConeTwistJointParam p_param, real_t p_value) {
 	switch (p_param) {
 		case PhysicsServer3D::CONE_TWIST_JOINT_SWING_SPAN: {
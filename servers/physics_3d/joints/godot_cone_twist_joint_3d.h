@@ -107,6 +107,9 @@ public:
 	virtual bool setup(real_t p_step) override;
 	virtual void solve(real_t p_step) override;
 
+	virtual void save_snapshot(Snapshot &r_snapshot) const override;
+	virtual void load_snapshot(const Snapshot &p_snapshot) override;
+
 	GodotConeTwistJoint3D(GodotBody3D *rbA, GodotBody3D *rbB, const Transform3D &rbAFrame, const Transform3D &rbBFrame);
 
 	void setAngularOnly(bool angularOnly) {
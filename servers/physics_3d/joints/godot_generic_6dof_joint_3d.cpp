@@ -418,6 +418,25 @@ void GodotGeneric6DOFJoint3D::solve(real_t p_timestep) {
 	}
 }
 
+void GodotGeneric6DOFJoint3D::save_snapshot(Snapshot &r_snapshot) const {
+	GodotJoint3D::save_snapshot(r_snapshot);
+	r_snapshot.impulses[0] = m_linearLimits.m_accumulatedImpulse.x;
+	r_snapshot.impulses[1] = m_linearLimits.m_accumulatedImpulse.y;
+	r_snapshot.impulses[2] = m_linearLimits.m_accumulatedImpulse.z;
+	r_snapshot.impulses[3] = m_angularLimits[0].m_accumulatedImpulse;
+	r_snapshot.impulses[4] = m_angularLimits[1].m_accumulatedImpulse;
+	r_snapshot.impulses[5] = m_angularLimits[2].m_accumulatedImpulse;
+}
+
+void GodotGeneric6DOFJoint3D::load_snapshot(const Snapshot &p_snapshot) {
+	m_linearLimits.m_accumulatedImpulse.x = p_snapshot.impulses[0];
+	m_linearLimits.m_accumulatedImpulse.y = p_snapshot.impulses[1];
+	m_linearLimits.m_accumulatedImpulse.z = p_snapshot.impulses[2];
+	m_angularLimits[0].m_accumulatedImpulse = p_snapshot.impulses[3];
+	m_angularLimits[1].m_accumulatedImpulse = p_snapshot.impulses[4];
+	m_angularLimits[2].m_accumulatedImpulse = p_snapshot.impulses[5];
+}
+
 void GodotGeneric6DOFJoint3D::updateRHS(real_t timeStep) {
 	(void)timeStep;
 }
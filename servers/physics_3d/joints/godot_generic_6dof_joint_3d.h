@@ -207,6 +207,9 @@ public:
 	virtual bool setup(real_t p_step) override;
 	virtual void solve(real_t p_step) override;
 
+	virtual void save_snapshot(Snapshot &r_snapshot) const override;
+	virtual void load_snapshot(const Snapshot &p_snapshot) override;
+
 	// Calcs the global transform for the joint offset for body A an B, and also calcs the angle differences between the bodies.
 	void calculateTransforms();
 
@@ -342,6 +342,17 @@ void GodotHingeJoint3D::solve(real_t p_step) {
 	}
 }
 
+void GodotHingeJoint3D::save_snapshot(Snapshot &r_snapshot) const {
+	GodotJoint3D::save_snapshot(r_snapshot);
+	r_snapshot.impulses[0] = m_appliedImpulse;
+	r_snapshot.impulses[1] = m_accLimitImpulse;
+}
+
+void GodotHingeJoint3D::load_snapshot(const Snapshot &p_snapshot) {
+	m_appliedImpulse = p_snapshot.impulses[0];
+	m_accLimitImpulse = p_snapshot.impulses[1];
+}
+
 /*
 void	HingeJointSW::updateRHS(real_t	timeStep)
 {
@@ -101,6 +101,9 @@ public:
 	virtual bool setup(real_t p_step) override;
 	virtual void solve(real_t p_step) override;
 
+	virtual void save_snapshot(Snapshot &r_snapshot) const override;
+	virtual void load_snapshot(const Snapshot &p_snapshot) override;
+
 	real_t get_hinge_angle();
 
 	void set_param(PhysicsServer3D::HingeJointParam p_param, real_t p_value);
@@ -139,6 +139,15 @@ void GodotPinJoint3D::solve(real_t p_step) {
 	}
 }
 
+void GodotPinJoint3D::save_snapshot(Snapshot &r_snapshot) const {
+	GodotJoint3D::save_snapshot(r_snapshot);
+	r_snapshot.impulses[0] = m_appliedImpulse;
+}
+
+void GodotPinJoint3D::load_snapshot(const Snapshot &p_snapshot) {
+	m_appliedImpulse = p_snapshot.impulses[0];
+}
+
 void GodotPinJoint3D::set_param(PhysicsServer3D::PinJointParam p_param, real_t p_value) {
 	switch (p_param) {
 		case PhysicsServer3D::PIN_JOINT_BIAS:
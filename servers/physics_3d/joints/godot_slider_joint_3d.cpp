@@ -271,6 +271,17 @@ void GodotSliderJoint3D::solve(real_t p_step) {
 	}
 }
 
+void GodotSliderJoint3D::save_snapshot(Snapshot &r_snapshot) const {
+	GodotJoint3D::save_snapshot(r_snapshot);
+	r_snapshot.impulses[0] = m_accumulatedLinMotorImpulse;
+	r_snapshot.impulses[1] = m_accumulatedAngMotorImpulse;
+}
+
+void GodotSliderJoint3D::load_snapshot(const Snapshot &p_snapshot) {
+	m_accumulatedLinMotorImpulse = p_snapshot.impulses[0];
+	m_accumulatedAngMotorImpulse = p_snapshot.impulses[1];
+}
+
 //-----------------------------------------------------------------------------
 
 void GodotSliderJoint3D::calculateTransforms() {
@@ -606,6 +606,57 @@ void PhysicsTestMotionResult2D::_bind_methods() {
 
 ///////////////////////////////////////
 
+PackedByteArray PhysicsServer2D::space_save_snapshot(RID p_space) const {
+	ERR_FAIL_V_MSG(PackedByteArray(), "Space snapshots aren't supported by this physics server.");
+}
+
+Error PhysicsServer2D::space_restore_snapshot(RID p_space, const PackedByteArray &p_snapshot) {
+	ERR_FAIL_V_MSG(ERR_UNAVAILABLE, "Space snapshots aren't supported by this physics server.");
+}
+
+void PhysicsServer2D::body_set_state_batch(const Vector<RID> &p_bodies, BodyState p_state, const Vector<float> &p_buffer) {
+	int stride = 0;
+	switch (p_state) {
+		case BODY_STATE_TRANSFORM:
+			stride = 6;
+			break;
+		case BODY_STATE_LINEAR_VELOCITY:
+			stride = 2;
+			break;
+		case BODY_STATE_ANGULAR_VELOCITY:
+		case BODY_STATE_SLEEPING:
+		case BODY_STATE_CAN_SLEEP:
+			stride = 1;
+			break;
+	}
+	ERR_FAIL_COND_MSG(p_buffer.size() != p_bodies.size() * stride, vformat("The buffer must hold %d floats per body for this state.", stride));
+
+	const RID *bodies = p_bodies.ptr();
+	const float *data = p_buffer.ptr();
+	for (int i = 0; i < p_bodies.size(); i++) {
+		const float *dataptr = &data[i * stride];
+		switch (p_state) {
+			case BODY_STATE_TRANSFORM: {
+				Transform2D transform;
+				transform.columns[0] = Vector2(dataptr[0], dataptr[3]);
+				transform.columns[1] = Vector2(dataptr[1], dataptr[4]);
+				transform.columns[2] = Vector2(dataptr[2], dataptr[5]);
+				body_set_state(bodies[i], p_state, transform);
+			} break;
+			case BODY_STATE_LINEAR_VELOCITY: {
+				body_set_state(bodies[i], p_state, Vector2(dataptr[0], dataptr[1]));
+			} break;
+			case BODY_STATE_ANGULAR_VELOCITY: {
+				body_set_state(bodies[i], p_state, dataptr[0]);
+			} break;
+			case BODY_STATE_SLEEPING:
+			case BODY_STATE_CAN_SLEEP: {
+				body_set_state(bodies[i], p_state, dataptr[0] != 0.0f);
+			} break;
+		}
+	}
+}
+
 bool PhysicsServer2D::_body_test_motion(RID p_body, const Ref<PhysicsTestMotionParameters2D> &p_parameters, const Ref<PhysicsTestMotionResult2D> &p_result) {
 	ERR_FAIL_COND_V(!p_parameters.is_valid(), false);
 
@@ -638,6 +689,8 @@ void PhysicsServer2D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("space_set_param", "space", "param", "value"), &PhysicsServer2D::space_set_param);
 	ClassDB::bind_method(D_METHOD("space_get_param", "space", "param"), &PhysicsServer2D::space_get_param);
 	ClassDB::bind_method(D_METHOD("space_get_direct_state", "space"), &PhysicsServer2D::space_get_direct_state);
+	ClassDB::bind_method(D_METHOD("space_save_snapshot", "space"), &PhysicsServer2D::space_save_snapshot);
+	ClassDB::bind_method(D_METHOD("space_restore_snapshot", "space", "snapshot"), &PhysicsServer2D::space_restore_snapshot);
 
 	ClassDB::bind_method(D_METHOD("area_create"), &PhysicsServer2D::area_create);
 	ClassDB::bind_method(D_METHOD("area_set_space", "area", "space"), &PhysicsServer2D::area_set_space);
@@ -724,6 +777,7 @@ void PhysicsServer2D::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("body_set_state", "body", "state", "value"), &PhysicsServer2D::body_set_state);
 	ClassDB::bind_method(D_METHOD("body_get_state", "body", "state"), &PhysicsServer2D::body_get_state);
+	ClassDB::bind_method(D_METHOD("body_set_state_batch", "bodies", "state", "buffer"), &PhysicsServer2D::body_set_state_batch);
 
 	ClassDB::bind_method(D_METHOD("body_apply_central_impulse", "body", "impulse"), &PhysicsServer2D::body_apply_central_impulse);
 	ClassDB::bind_method(D_METHOD("body_apply_torque_impulse", "body", "impulse"), &PhysicsServer2D::body_apply_torque_impulse);
@@ -910,6 +964,7 @@ PhysicsServer2D::PhysicsServer2D() {
 	GLOBAL_DEF(PropertyInfo(Variant::FLOAT, "physics/2d/solver/contact_max_allowed_penetration", PROPERTY_HINT_RANGE, "0.01,10,0.01,or_greater"), 0.3);
 	GLOBAL_DEF(PropertyInfo(Variant::FLOAT, "physics/2d/solver/default_contact_bias", PROPERTY_HINT_RANGE, "0,1,0.01"), 0.8);
 	GLOBAL_DEF(PropertyInfo(Variant::FLOAT, "physics/2d/solver/default_constraint_bias", PROPERTY_HINT_RANGE, "0,1,0.01"), 0.2);
+	GLOBAL_DEF("physics/2d/solver/deterministic", false);
 }
 
 PhysicsServer2D::~PhysicsServer2D() {
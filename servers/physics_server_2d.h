@@ -272,6 +272,10 @@ public:
 	// this function only works on physics process, errors and returns null otherwise
 	virtual PhysicsDirectSpaceState2D *space_get_direct_state(RID p_space) = 0;
 
+	// Saves the state of the bodies and their contacts into a flat buffer, restoring it lets the space be stepped again from there.
+	virtual PackedByteArray space_save_snapshot(RID p_space) const;
+	virtual Error space_restore_snapshot(RID p_space, const PackedByteArray &p_snapshot);
+
 	virtual void space_set_debug_contacts(RID p_space, int p_max_contacts) = 0;
 	virtual Vector<Vector2> space_get_contacts(RID p_space) const = 0;
 	virtual int space_get_contact_count(RID p_space) const = 0;
@@ -439,6 +443,9 @@ public:
 	virtual void body_set_state(RID p_body, BodyState p_state, const Variant &p_variant) = 0;
 	virtual Variant body_get_state(RID p_body, BodyState p_state) const = 0;
 
+	// Sets one state on many bodies with a single call, threaded servers queue it as one command.
+	virtual void body_set_state_batch(const Vector<RID> &p_bodies, BodyState p_state, const Vector<float> &p_buffer);
+
 	virtual void body_apply_central_impulse(RID p_body, const Vector2 &p_impulse) = 0;
 	virtual void body_apply_torque_impulse(RID p_body, real_t p_torque) = 0;
 	virtual void body_apply_impulse(RID p_body, const Vector2 &p_impulse, const Vector2 &p_position = Vector2()) = 0;
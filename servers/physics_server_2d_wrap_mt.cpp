@@ -43,7 +43,7 @@ void PhysicsServer2DWrapMT::_thread_exit() {
 
 void PhysicsServer2DWrapMT::_thread_loop() {
 	while (!exit) {
-		WorkerThreadPool::get_singleton()->yield();
+		command_queue.pump_yield();
 		command_queue.flush_all();
 	}
 }
@@ -105,6 +105,7 @@ void PhysicsServer2DWrapMT::finish() {
 PhysicsServer2DWrapMT::PhysicsServer2DWrapMT(PhysicsServer2D *p_contained, bool p_create_thread) {
 	physics_server_2d = p_contained;
 	create_thread = p_create_thread;
+	command_queue.set_multiple_producers(true);
 }
 
 PhysicsServer2DWrapMT::~PhysicsServer2DWrapMT() {
@@ -112,6 +112,9 @@ public:
 		return physics_server_2d->space_get_direct_state(p_space);
 	}
 
+	FUNC1RC(PackedByteArray, space_save_snapshot, RID);
+	FUNC2R(Error, space_restore_snapshot, RID, const PackedByteArray &);
+
 	FUNC2(space_set_debug_contacts, RID, int);
 	virtual Vector<Vector2> space_get_contacts(RID p_space) const override {
 		ERR_FAIL_COND_V(!Thread::is_main_thread(), Vector<Vector2>());
@@ -216,6 +219,7 @@ public:
 
 	FUNC3(body_set_state, RID, BodyState, const Variant &);
 	FUNC2RC(Variant, body_get_state, RID, BodyState);
+	FUNC3(body_set_state_batch, const Vector<RID> &, BodyState, const Vector<float> &);
 
 	FUNC2(body_apply_central_impulse, RID, const Vector2 &);
 	FUNC2(body_apply_torque_impulse, RID, real_t);
@@ -34,6 +34,7 @@
 
 #include "core/config/project_settings.h"
 #include "core/string/print_string.h"
+#include "core/templates/local_vector.h"
 #include "core/variant/typed_array.h"
 
 void PhysicsServer3DRenderingServerHandler::set_vertex(int p_vertex_id, const Vector3 &p_vertex) {
@@ -377,6 +378,86 @@ Dictionary PhysicsDirectSpaceState3D::_intersect_ray(const Ref<PhysicsRayQueryPa
 	return d;
 }
 
+Dictionary PhysicsDirectSpaceState3D::_intersect_rays(const Ref<PhysicsRayQueryParameters3D> &p_ray_query, const PackedVector3Array &p_from, const PackedVector3Array &p_to) {
+	ERR_FAIL_COND_V(!p_ray_query.is_valid(), Dictionary());
+	ERR_FAIL_COND_V_MSG(p_from.size() != p_to.size(), Dictionary(), "The from and to arrays must have the same size.");
+
+	int count = p_from.size();
+
+	LocalVector<RayResult> results;
+	LocalVector<bool> collided;
+	results.resize(count);
+	collided.resize(count);
+
+	intersect_rays(p_ray_query->get_parameters(), p_from.ptr(), p_to.ptr(), count, results.ptr(), collided.ptr());
+
+	PackedVector3Array positions;
+	PackedVector3Array normals;
+	PackedInt64Array collider_ids;
+	PackedInt32Array shapes;
+	PackedInt32Array face_indices;
+	PackedInt64Array rids;
+
+	positions.resize(count);
+	normals.resize(count);
+	collider_ids.resize(count);
+	shapes.resize(count);
+	face_indices.resize(count);
+	rids.resize(count);
+
+	Vector3 *positions_ptr = positions.ptrw();
+	Vector3 *normals_ptr = normals.ptrw();
+	int64_t *collider_ids_ptr = collider_ids.ptrw();
+	int32_t *shapes_ptr = shapes.ptrw();
+	int32_t *face_indices_ptr = face_indices.ptrw();
+	int64_t *rids_ptr = rids.ptrw();
+
+	for (int i = 0; i < count; i++) {
+		if (!collided[i]) {
+			positions_ptr[i] = Vector3();
+			normals_ptr[i] = Vector3();
+			collider_ids_ptr[i] = 0;
+			shapes_ptr[i] = -1;
+			face_indices_ptr[i] = -1;
+			rids_ptr[i] = 0;
+			continue;
+		}
+
+		positions_ptr[i] = results[i].position;
+		normals_ptr[i] = results[i].normal;
+		collider_ids_ptr[i] = int64_t(results[i].collider_id);
+		shapes_ptr[i] = results[i].shape;
+		face_indices_ptr[i] = results[i].face_index;
+		rids_ptr[i] = int64_t(results[i].rid.get_id());
+	}
+
+	Dictionary d;
+	d["position"] = positions;
+	d["normal"] = normals;
+	d["collider_id"] = collider_ids;
+	d["shape"] = shapes;
+	d["face_index"] = face_indices;
+	d["rid"] = rids;
+
+	return d;
+}
+
+int PhysicsDirectSpaceState3D::intersect_rays(const RayParameters &p_parameters, const Vector3 *p_from, const Vector3 *p_to, int p_count, RayResult *r_results, bool *r_collided) {
+	RayParameters parameters = p_parameters;
+	int collided_count = 0;
+
+	for (int i = 0; i < p_count; i++) {
+		parameters.from = p_from[i];
+		parameters.to = p_to[i];
+		r_collided[i] = intersect_ray(parameters, r_results[i]);
+		if (r_collided[i]) {
+			collided_count++;
+		}
+	}
+
+	return collided_count;
+}
+
 TypedArray<Dictionary> PhysicsDirectSpaceState3D::_intersect_point(const Ref<PhysicsPointQueryParameters3D> &p_point_query, int p_max_results) {
 	ERR_FAIL_COND_V(p_point_query.is_null(), TypedArray<Dictionary>());
 
@@ -422,6 +503,85 @@ TypedArray<Dictionary> PhysicsDirectSpaceState3D::_intersect_shape(const Ref<Phy
 	return ret;
 }
 
+Dictionary PhysicsDirectSpaceState3D::_intersect_shapes(const Ref<PhysicsShapeQueryParameters3D> &p_shape_query, const Vector<float> &p_buffer, int p_max_results) {
+	ERR_FAIL_COND_V(!p_shape_query.is_valid(), Dictionary());
+	ERR_FAIL_COND_V(p_max_results < 0, Dictionary());
+	ERR_FAIL_COND_V_MSG(p_buffer.size() % 12 != 0, Dictionary(), "The buffer must hold 12 floats per transform.");
+
+	int count = p_buffer.size() / 12;
+	// Every query gets its own slice of p_max_results results, so bound the total before allocating.
+	constexpr int64_t MAX_TOTAL_RESULTS = 1 << 20;
+	ERR_FAIL_COND_V_MSG(int64_t(count) * p_max_results > MAX_TOTAL_RESULTS, Dictionary(), vformat("Too many results requested: %d transforms with up to %d results each exceeds the limit of %d results.", count, p_max_results, MAX_TOTAL_RESULTS));
+
+	LocalVector<Transform3D> transforms;
+	LocalVector<ShapeResult> results;
+	LocalVector<int> result_counts;
+	transforms.resize(count);
+	results.resize(count * p_max_results);
+	result_counts.resize(count);
+	const float *data = p_buffer.ptr();
+	for (int i = 0; i < count; i++) {
+		const float *dataptr = &data[i * 12];
+		Transform3D &transform = transforms[i];
+		transform.basis.rows[0] = Vector3(dataptr[0], dataptr[1], dataptr[2]);
+		transform.origin.x = dataptr[3];
+		transform.basis.rows[1] = Vector3(dataptr[4], dataptr[5], dataptr[6]);
+		transform.origin.y = dataptr[7];
+		transform.basis.rows[2] = Vector3(dataptr[8], dataptr[9], dataptr[10]);
+		transform.origin.z = dataptr[11];
+	}
+
+	int total = intersect_shapes(p_shape_query->get_parameters(), transforms.ptr(), count, results.ptr(), p_max_results, result_counts.ptr());
+
+	PackedInt32Array queries;
+	PackedInt64Array collider_ids;
+	PackedInt64Array rids;
+	PackedInt32Array shapes;
+
+	queries.resize(total);
+	collider_ids.resize(total);
+	rids.resize(total);
+	shapes.resize(total);
+
+	int32_t *queries_ptr = queries.ptrw();
+	int64_t *collider_ids_ptr = collider_ids.ptrw();
+	int64_t *rids_ptr = rids.ptrw();
+	int32_t *shapes_ptr = shapes.ptrw();
+
+	int n = 0;
+	for (int i = 0; i < count; i++) {
+		const ShapeResult *query_results = results.ptr() + i * p_max_results;
+		for (int j = 0; j < result_counts[i] && n < total; j++) {
+			queries_ptr[n] = i;
+			collider_ids_ptr[n] = int64_t(query_results[j].collider_id);
+			rids_ptr[n] = int64_t(query_results[j].rid.get_id());
+			shapes_ptr[n] = query_results[j].shape;
+			n++;
+		}
+	}
+
+	Dictionary d;
+	d["query"] = queries;
+	d["collider_id"] = collider_ids;
+	d["rid"] = rids;
+	d["shape"] = shapes;
+
+	return d;
+}
+
+int PhysicsDirectSpaceState3D::intersect_shapes(const ShapeParameters &p_parameters, const Transform3D *p_transforms, int p_count, ShapeResult *r_results, int p_result_max, int *r_result_counts) {
+	ShapeParameters parameters = p_parameters;
+	int result_count = 0;
+
+	for (int i = 0; i < p_count; i++) {
+		parameters.transform = p_transforms[i];
+		r_result_counts[i] = intersect_shape(parameters, r_results + i * p_result_max, p_result_max);
+		result_count += r_result_counts[i];
+	}
+
+	return result_count;
+}
+
 Vector<real_t> PhysicsDirectSpaceState3D::_cast_motion(const Ref<PhysicsShapeQueryParameters3D> &p_shape_query) {
 	ERR_FAIL_COND_V(!p_shape_query.is_valid(), Vector<real_t>());
 
@@ -482,6 +642,8 @@ PhysicsDirectSpaceState3D::PhysicsDirectSpaceState3D() {
 void PhysicsDirectSpaceState3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("intersect_point", "parameters", "max_results"), &PhysicsDirectSpaceState3D::_intersect_point, DEFVAL(32));
 	ClassDB::bind_method(D_METHOD("intersect_ray", "parameters"), &PhysicsDirectSpaceState3D::_intersect_ray);
+	ClassDB::bind_method(D_METHOD("intersect_rays", "parameters", "from", "to"), &PhysicsDirectSpaceState3D::_intersect_rays);
+	ClassDB::bind_method(D_METHOD("intersect_shapes", "parameters", "buffer", "max_results"), &PhysicsDirectSpaceState3D::_intersect_shapes, DEFVAL(32));
 	ClassDB::bind_method(D_METHOD("intersect_shape", "parameters", "max_results"), &PhysicsDirectSpaceState3D::_intersect_shape, DEFVAL(32));
 	ClassDB::bind_method(D_METHOD("cast_motion", "parameters"), &PhysicsDirectSpaceState3D::_cast_motion);
 	ClassDB::bind_method(D_METHOD("collide_shape", "parameters", "max_results"), &PhysicsDirectSpaceState3D::_collide_shape, DEFVAL(32));
@@ -651,6 +813,58 @@ void PhysicsTestMotionResult3D::_bind_methods() {
 
 ///////////////////////////////////////
 
+PackedByteArray PhysicsServer3D::space_save_snapshot(RID p_space) const {
+	ERR_FAIL_V_MSG(PackedByteArray(), "Space snapshots aren't supported by this physics server.");
+}
+
+Error PhysicsServer3D::space_restore_snapshot(RID p_space, const PackedByteArray &p_snapshot) {
+	ERR_FAIL_V_MSG(ERR_UNAVAILABLE, "Space snapshots aren't supported by this physics server.");
+}
+
+void PhysicsServer3D::body_set_state_batch(const Vector<RID> &p_bodies, BodyState p_state, const Vector<float> &p_buffer) {
+	int stride = 0;
+	switch (p_state) {
+		case BODY_STATE_TRANSFORM:
+			stride = 12;
+			break;
+		case BODY_STATE_LINEAR_VELOCITY:
+		case BODY_STATE_ANGULAR_VELOCITY:
+			stride = 3;
+			break;
+		case BODY_STATE_SLEEPING:
+		case BODY_STATE_CAN_SLEEP:
+			stride = 1;
+			break;
+	}
+	ERR_FAIL_COND_MSG(p_buffer.size() != p_bodies.size() * stride, vformat("The buffer must hold %d floats per body for this state.", stride));
+
+	const RID *bodies = p_bodies.ptr();
+	const float *data = p_buffer.ptr();
+	for (int i = 0; i < p_bodies.size(); i++) {
+		const float *dataptr = &data[i * stride];
+		switch (p_state) {
+			case BODY_STATE_TRANSFORM: {
+				Transform3D transform;
+				transform.basis.rows[0] = Vector3(dataptr[0], dataptr[1], dataptr[2]);
+				transform.origin.x = dataptr[3];
+				transform.basis.rows[1] = Vector3(dataptr[4], dataptr[5], dataptr[6]);
+				transform.origin.y = dataptr[7];
+				transform.basis.rows[2] = Vector3(dataptr[8], dataptr[9], dataptr[10]);
+				transform.origin.z = dataptr[11];
+				body_set_state(bodies[i], p_state, transform);
+			} break;
+			case BODY_STATE_LINEAR_VELOCITY:
+			case BODY_STATE_ANGULAR_VELOCITY: {
+				body_set_state(bodies[i], p_state, Vector3(dataptr[0], dataptr[1], dataptr[2]));
+			} break;
+			case BODY_STATE_SLEEPING:
+			case BODY_STATE_CAN_SLEEP: {
+				body_set_state(bodies[i], p_state, dataptr[0] != 0.0f);
+			} break;
+		}
+	}
+}
+
 bool PhysicsServer3D::_body_test_motion(RID p_body, const Ref<PhysicsTestMotionParameters3D> &p_parameters, const Ref<PhysicsTestMotionResult3D> &p_result) {
 	ERR_FAIL_COND_V(!p_parameters.is_valid(), false);
 
@@ -716,6 +930,8 @@ void PhysicsServer3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("space_set_param", "space", "param", "value"), &PhysicsServer3D::space_set_param);
 	ClassDB::bind_method(D_METHOD("space_get_param", "space", "param"), &PhysicsServer3D::space_get_param);
 	ClassDB::bind_method(D_METHOD("space_get_direct_state", "space"), &PhysicsServer3D::space_get_direct_state);
+	ClassDB::bind_method(D_METHOD("space_save_snapshot", "space"), &PhysicsServer3D::space_save_snapshot);
+	ClassDB::bind_method(D_METHOD("space_restore_snapshot", "space", "snapshot"), &PhysicsServer3D::space_restore_snapshot);
 
 	ClassDB::bind_method(D_METHOD("area_create"), &PhysicsServer3D::area_create);
 	ClassDB::bind_method(D_METHOD("area_set_space", "area", "space"), &PhysicsServer3D::area_set_space);
@@ -796,6 +1012,7 @@ void PhysicsServer3D::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("body_set_state", "body", "state", "value"), &PhysicsServer3D::body_set_state);
 	ClassDB::bind_method(D_METHOD("body_get_state", "body", "state"), &PhysicsServer3D::body_get_state);
+	ClassDB::bind_method(D_METHOD("body_set_state_batch", "bodies", "state", "buffer"), &PhysicsServer3D::body_set_state_batch);
 
 	ClassDB::bind_method(D_METHOD("body_apply_central_impulse", "body", "impulse"), &PhysicsServer3D::body_apply_central_impulse);
 	ClassDB::bind_method(D_METHOD("body_apply_impulse", "body", "impulse", "position"), &PhysicsServer3D::body_apply_impulse, Vector3());
@@ -1101,6 +1318,8 @@ void PhysicsServer3D::_bind_methods() {
 	BIND_ENUM_CONSTANT(INFO_ACTIVE_OBJECTS);
 	BIND_ENUM_CONSTANT(INFO_COLLISION_PAIRS);
 	BIND_ENUM_CONSTANT(INFO_ISLAND_COUNT);
+	BIND_ENUM_CONSTANT(INFO_BROAD_PHASE_TIME);
+	BIND_ENUM_CONSTANT(INFO_NARROW_PHASE_TIME);
 
 	BIND_ENUM_CONSTANT(SPACE_PARAM_CONTACT_RECYCLE_RADIUS);
 	BIND_ENUM_CONSTANT(SPACE_PARAM_CONTACT_MAX_SEPARATION);
@@ -1110,6 +1329,7 @@ void PhysicsServer3D::_bind_methods() {
 	BIND_ENUM_CONSTANT(SPACE_PARAM_BODY_ANGULAR_VELOCITY_SLEEP_THRESHOLD);
 	BIND_ENUM_CONSTANT(SPACE_PARAM_BODY_TIME_TO_SLEEP);
 	BIND_ENUM_CONSTANT(SPACE_PARAM_SOLVER_ITERATIONS);
+	BIND_ENUM_CONSTANT(SPACE_PARAM_SOLVER_SUBSTEPS);
 
 	BIND_ENUM_CONSTANT(BODY_AXIS_LINEAR_X);
 	BIND_ENUM_CONSTANT(BODY_AXIS_LINEAR_Y);
@@ -1135,10 +1355,14 @@ PhysicsServer3D::PhysicsServer3D() {
 	GLOBAL_DEF("physics/3d/sleep_threshold_angular", Math::deg_to_rad(8.0));
 	GLOBAL_DEF(PropertyInfo(Variant::FLOAT, "physics/3d/time_before_sleep", PROPERTY_HINT_RANGE, "0,5,0.01,or_greater"), 0.5);
 	GLOBAL_DEF(PropertyInfo(Variant::INT, "physics/3d/solver/solver_iterations", PROPERTY_HINT_RANGE, "1,32,1,or_greater"), 16);
+	GLOBAL_DEF(PropertyInfo(Variant::INT, "physics/3d/solver/solver_substeps", PROPERTY_HINT_RANGE, "1,16,1,or_greater"), 1);
 	GLOBAL_DEF(PropertyInfo(Variant::FLOAT, "physics/3d/solver/contact_recycle_radius", PROPERTY_HINT_RANGE, "0,0.1,0.001,or_greater"), 0.01);
 	GLOBAL_DEF(PropertyInfo(Variant::FLOAT, "physics/3d/solver/contact_max_separation", PROPERTY_HINT_RANGE, "0,0.1,0.001,or_greater"), 0.05);
 	GLOBAL_DEF(PropertyInfo(Variant::FLOAT, "physics/3d/solver/contact_max_allowed_penetration", PROPERTY_HINT_RANGE, "0.001,0.1,0.001,or_greater"), 0.01);
 	GLOBAL_DEF(PropertyInfo(Variant::FLOAT, "physics/3d/solver/default_contact_bias", PROPERTY_HINT_RANGE, "0,1,0.01"), 0.8);
+	GLOBAL_DEF("physics/3d/solver/deterministic", false);
+	GLOBAL_DEF("physics/3d/solver/structure_of_arrays_integration", false);
+	GLOBAL_DEF("physics/3d/threaded_pairing", false);
 }
 
 PhysicsServer3D::~PhysicsServer3D() {
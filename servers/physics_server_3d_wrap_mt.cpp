@@ -43,7 +43,7 @@ void PhysicsServer3DWrapMT::_thread_exit() {
 
 void PhysicsServer3DWrapMT::_thread_loop() {
 	while (!exit) {
-		WorkerThreadPool::get_singleton()->yield();
+		command_queue.pump_yield();
 		command_queue.flush_all();
 	}
 }
@@ -105,6 +105,7 @@ void PhysicsServer3DWrapMT::finish() {
 PhysicsServer3DWrapMT::PhysicsServer3DWrapMT(PhysicsServer3D *p_contained, bool p_create_thread) {
 	physics_server_3d = p_contained;
 	create_thread = p_create_thread;
+	command_queue.set_multiple_producers(true);
 }
 
 PhysicsServer3DWrapMT::~PhysicsServer3DWrapMT() {
@@ -31,6 +31,7 @@
 #ifndef RENDERER_CANVAS_CULL_H
 #define RENDERER_CANVAS_CULL_H
 
+#include "core/math/dynamic_bvh.h"
 #include "core/templates/paged_allocator.h"
 #include "renderer_compositor.h"
 #include "renderer_viewport.h"
@@ -58,6 +59,18 @@ public:
 
 		Vector<Item *> child_items;
 
+		// Bounds of this item and all its descendants, used by the spatial index to skip whole subtrees.
+		Rect2 subtree_rect; // In local space.
+		Rect2 parent_subtree_rect; // In the parent's space.
+		bool subtree_rect_dirty = true;
+		bool subtree_unbounded = false; // The subtree contains items that can't be culled by their rect.
+		bool children_unbounded = false;
+		uint32_t child_order = 0; // Position in the parent's sorted child_items.
+		DynamicBVH *children_index = nullptr; // Children bounds in local space, only for items with many children.
+		DynamicBVH::ID children_index_id; // Leaf of this item in the parent's children_index.
+		uint32_t children_index_count = 0;
+		LocalVector<Item *> dirty_children; // Children whose subtree rect changed since the last update.
+
 		struct VisibilityNotifierData {
 			Rect2 area;
 			Callable enter_callable;
@@ -88,6 +101,27 @@ public:
 			ysort_index = 0;
 			ysort_parent_abs_z_index = 0;
 		}
+
+		~Item() {
+			if (children_index) {
+				memdelete(children_index);
+			}
+		}
+	};
+
+	struct ItemChildOrderSort {
+		_FORCE_INLINE_ bool operator()(const Item *p_left, const Item *p_right) const {
+			return p_left->child_order < p_right->child_order;
+		}
+	};
+
+	struct ChildrenIndexCullResult {
+		LocalVector<Item *> *items = nullptr;
+
+		_FORCE_INLINE_ bool operator()(void *p_data) {
+			items->push_back(static_cast<Item *>(p_data));
+			return false;
+		}
 	};
 
 	struct ItemIndexSort {
@@ -176,6 +210,26 @@ public:
 	bool sdf_used = false;
 	bool snapping_2d_transforms_to_pixel = false;
 
+	bool use_spatial_index = false;
+	static constexpr int CHILDREN_INDEX_MIN_COUNT = 64;
+
+	struct ThreadedCullData {
+		Canvas::ChildItem *child_items = nullptr;
+		uint32_t child_item_count = 0;
+		uint32_t range_count = 0;
+		Transform2D transform;
+		Rect2 clip_rect;
+		uint32_t canvas_cull_mask = 0;
+	};
+
+	bool use_threaded_cull = false;
+	// Set while worker threads are culling, so shared state is only touched under a lock.
+	bool cull_threaded = false;
+	SafeFlag cull_redraw_requested;
+	BinaryMutex visibility_notifier_mutex;
+	// One z_list and z_last_list pair per range of top-level items.
+	LocalVector<RendererCanvasRender::Item *> threaded_z_lists;
+
 	bool debug_redraw = false;
 	double debug_redraw_time = 0;
 	Color debug_redraw_color;
@@ -186,7 +240,12 @@ public:
 	_FORCE_INLINE_ void _attach_canvas_item_for_draw(Item *ci, Item *p_canvas_clip, RendererCanvasRender::Item **r_z_list, RendererCanvasRender::Item **r_z_last_list, const Transform2D &p_transform, const Rect2 &p_clip_rect, Rect2 p_global_rect, const Color &modulate, int p_z, RendererCanvasCull::Item *p_material_owner, bool p_use_canvas_group, RendererCanvasRender::Item *r_canvas_group_from);
 
 private:
+	void _mark_subtree_rect_dirty(Item *p_item);
+	void _remove_from_children_index(Item *p_item, Item *p_parent);
+	void _update_subtree_rect(Item *p_item);
+
 	void _render_canvas_item_tree(RID p_to_render_target, Canvas::ChildItem *p_child_items, int p_child_item_count, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, RendererCanvasRender::Light *p_lights, RendererCanvasRender::Light *p_directional_lights, RS::CanvasItemTextureFilter p_default_filter, RS::CanvasItemTextureRepeat p_default_repeat, bool p_snap_2d_vertices_to_pixel, uint32_t p_canvas_cull_mask, RenderingMethod::RenderInfo *r_render_info = nullptr);
+	void _cull_canvas_items_threaded(uint32_t p_range, ThreadedCullData *p_data);
 	void _cull_canvas_item(Item *p_canvas_item, const Transform2D &p_parent_xform, const Rect2 &p_clip_rect, const Color &p_modulate, int p_z, RendererCanvasRender::Item **r_z_list, RendererCanvasRender::Item **r_z_last_list, Item *p_canvas_clip, Item *p_material_owner, bool p_allow_y_sort, uint32_t p_canvas_cull_mask, const Point2 &p_repeat_size, int p_repeat_times, RendererCanvasRender::Item *p_repeat_source_item);
 
 	static constexpr int z_range = RS::CANVAS_ITEM_Z_MAX - RS::CANVAS_ITEM_Z_MIN + 1;
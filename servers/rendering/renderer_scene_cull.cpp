@@ -33,6 +33,7 @@
 #include "core/config/project_settings.h"
 #include "core/object/worker_thread_pool.h"
 #include "core/os/os.h"
+#include "renderer_scene_occlusion_cull_raster.h"
 #include "rendering_light_culler.h"
 #include "rendering_server_constants.h"
 #include "rendering_server_default.h"
@@ -1038,6 +1039,137 @@ void RendererSceneCull::instance_set_transform(RID p_instance, const Transform3D
 #endif
 }
 
+bool RendererSceneCull::_instance_can_bulk_transform(const Instance *p_instance, const Transform3D &p_transform) const {
+	// Only plain meshes already in the BVH, whose update touches nothing but their own data, the BVH and their pairs.
+	if (p_instance->base_type != RS::INSTANCE_MESH && p_instance->base_type != RS::INSTANCE_MULTIMESH) {
+		return false;
+	}
+	if (!p_instance->scenario || !p_instance->visible || !p_instance->indexer_id.is_valid() || p_instance->update_item.in_list()) {
+		return false;
+	}
+	if (!p_instance->aabb.has_surface() || p_transform.basis.determinant() == 0) {
+		return false;
+	}
+
+	const InstanceGeometryData *geom = static_cast<const InstanceGeometryData *>(p_instance->base_data);
+	return geom->lightmap_captures.is_empty() && p_instance->lightmap_sh.is_empty();
+}
+
+void RendererSceneCull::_instance_set_transforms_threaded(uint32_t p_thread, LocalVector<BulkTransform> *p_bulk_transforms) {
+	uint32_t total = p_bulk_transforms->size();
+	uint32_t total_threads = WorkerThreadPool::get_singleton()->get_thread_count();
+	uint32_t from = p_thread * total / total_threads;
+	uint32_t to = (p_thread + 1 == total_threads) ? total : ((p_thread + 1) * total / total_threads);
+
+	_instance_set_transforms(*p_bulk_transforms, from, to);
+}
+
+void RendererSceneCull::_instance_set_transforms(LocalVector<BulkTransform> &p_bulk_transforms, uint32_t p_from, uint32_t p_to) {
+	for (uint32_t i = p_from; i < p_to; i++) {
+		BulkTransform &bulk = p_bulk_transforms[i];
+		Instance *instance = bulk.instance;
+
+		instance->version++;
+		instance->transformed_aabb = instance->transform.xform(instance->aabb);
+		instance->scenario->instance_aabbs[instance->array_index] = InstanceBounds(instance->transformed_aabb);
+		bulk.bvh_aabb = _get_instance_bvh_aabb(instance);
+
+		InstanceGeometryData *geom = static_cast<InstanceGeometryData *>(instance->base_data);
+		geom->geometry_instance->set_transform(instance->transform, instance->aabb, instance->transformed_aabb);
+	}
+}
+
+void RendererSceneCull::instance_set_transforms(const Vector<RID> &p_instances, const Vector<float> &p_buffer) {
+	ERR_FAIL_COND_MSG(p_buffer.size() != p_instances.size() * 12, "The buffer must hold 12 floats per instance.");
+
+	const RID *instances = p_instances.ptr();
+	const float *data = p_buffer.ptr();
+	int count = p_instances.size();
+
+	// Tag the instances gathered below, so that repeated ones aren't transformed twice.
+	uint64_t bulk_pass = ++pair_pass;
+	bulk_transforms.clear();
+
+	for (int i = 0; i < count; i++) {
+		Instance *instance = instance_owner.get_or_null(instances[i]);
+		ERR_CONTINUE(!instance);
+
+		const float *dataptr = &data[i * 12];
+		Transform3D transform;
+		transform.basis.rows[0] = Vector3(dataptr[0], dataptr[1], dataptr[2]);
+		transform.origin.x = dataptr[3];
+		transform.basis.rows[1] = Vector3(dataptr[4], dataptr[5], dataptr[6]);
+		transform.origin.y = dataptr[7];
+		transform.basis.rows[2] = Vector3(dataptr[8], dataptr[9], dataptr[10]);
+		transform.origin.z = dataptr[11];
+
+		if (_interpolation_data.interpolation_enabled && instance->interpolated && instance->scenario) {
+			// Interpolated instances need the transform history to be tracked, so take the regular path.
+			instance_set_transform(instances[i], transform);
+			continue;
+		}
+
+		if (instance->transform == transform) {
+			continue;
+		}
+
+#ifdef DEBUG_ENABLED
+		if (!transform.basis.rows[0].is_finite() || !transform.basis.rows[1].is_finite() || !transform.basis.rows[2].is_finite() || !transform.origin.is_finite()) {
+			ERR_CONTINUE_MSG(true, "Instance transform is not finite.");
+		}
+#endif
+
+		instance->transform = transform;
+
+		if (instance->pair_check == bulk_pass) {
+			continue;
+		}
+
+		if (_instance_can_bulk_transform(instance, transform)) {
+			instance->pair_check = bulk_pass;
+			BulkTransform bulk;
+			bulk.instance = instance;
+			bulk_transforms.push_back(bulk);
+		} else {
+			// Moving an instance doesn't change its local AABB, so don't query the base again.
+			_instance_queue_update(instance, false);
+		}
+	}
+
+	if (bulk_transforms.is_empty()) {
+		return;
+	}
+
+	// Transforming the AABBs only touches each instance's own data, so it can be split among threads.
+	if (bulk_transforms.size() > thread_cull_threshold) {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &RendererSceneCull::_instance_set_transforms_threaded, &bulk_transforms, WorkerThreadPool::get_singleton()->get_thread_count(), -1, true, SNAME("RenderInstanceTransforms"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	} else {
+		_instance_set_transforms(bulk_transforms, 0, bulk_transforms.size());
+	}
+
+	// The BVH, the shadows of the paired lights and the pairs themselves are shared, update them serially.
+	for (const BulkTransform &bulk : bulk_transforms) {
+		Instance *instance = bulk.instance;
+		InstanceGeometryData *geom = static_cast<InstanceGeometryData *>(instance->base_data);
+
+		if (geom->can_cast_shadows) {
+			for (const Instance *E : geom->lights) {
+				InstanceLightData *light = static_cast<InstanceLightData *>(E->base_data);
+				light->make_shadow_dirty();
+			}
+		}
+
+		instance->scenario->indexers[Scenario::INDEXER_GEOMETRY].update(instance->indexer_id, bulk.bvh_aabb);
+
+		if (instance->visibility_index != -1) {
+			instance->scenario->instance_visibility[instance->visibility_index].position = instance->transformed_aabb.get_center();
+		}
+
+		_update_instance_pairs(instance);
+	}
+}
+
 void RendererSceneCull::instance_set_interpolated(RID p_instance, bool p_interpolated) {
 	Instance *instance = instance_owner.get_or_null(p_instance);
 	ERR_FAIL_NULL(instance);
@@ -1839,21 +1971,7 @@ void RendererSceneCull::_update_instance(Instance *p_instance) {
 		return;
 	}
 
-	//quantize to improve moving object performance
-	AABB bvh_aabb = p_instance->transformed_aabb;
-
-	if (p_instance->indexer_id.is_valid() && bvh_aabb != p_instance->prev_transformed_aabb) {
-		//assume motion, see if bounds need to be quantized
-		AABB motion_aabb = bvh_aabb.merge(p_instance->prev_transformed_aabb);
-		float motion_longest_axis = motion_aabb.get_longest_axis_size();
-		float longest_axis = p_instance->transformed_aabb.get_longest_axis_size();
-
-		if (motion_longest_axis < longest_axis * 2) {
-			//moved but not a lot, use motion aabb quantizing
-			float quantize_size = Math::pow(2.0, Math::ceil(Math::log(motion_longest_axis) / Math::log(2.0))) * 0.5; //one fifth
-			bvh_aabb.quantize(quantize_size);
-		}
-	}
+	AABB bvh_aabb = _get_instance_bvh_aabb(p_instance);
 
 	if (!p_instance->indexer_id.is_valid()) {
 		if ((1 << p_instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) {
@@ -1958,6 +2076,30 @@ void RendererSceneCull::_update_instance(Instance *p_instance) {
 		p_instance->scenario->instance_visibility[p_instance->visibility_index].position = p_instance->transformed_aabb.get_center();
 	}
 
+	_update_instance_pairs(p_instance);
+}
+
+AABB RendererSceneCull::_get_instance_bvh_aabb(const Instance *p_instance) const {
+	//quantize to improve moving object performance
+	AABB bvh_aabb = p_instance->transformed_aabb;
+
+	if (p_instance->indexer_id.is_valid() && bvh_aabb != p_instance->prev_transformed_aabb) {
+		//assume motion, see if bounds need to be quantized
+		AABB motion_aabb = bvh_aabb.merge(p_instance->prev_transformed_aabb);
+		float motion_longest_axis = motion_aabb.get_longest_axis_size();
+		float longest_axis = p_instance->transformed_aabb.get_longest_axis_size();
+
+		if (motion_longest_axis < longest_axis * 2) {
+			//moved but not a lot, use motion aabb quantizing
+			float quantize_size = Math::pow(2.0, Math::ceil(Math::log(motion_longest_axis) / Math::log(2.0))) * 0.5; //one fifth
+			bvh_aabb.quantize(quantize_size);
+		}
+	}
+
+	return bvh_aabb;
+}
+
+void RendererSceneCull::_update_instance_pairs(Instance *p_instance) {
 	//move instance and repair
 	pair_pass++;
 
@@ -4518,7 +4660,12 @@ RendererSceneCull::RendererSceneCull() {
 	thread_cull_threshold = MAX(thread_cull_threshold, (uint32_t)WorkerThreadPool::get_singleton()->get_thread_count()); //make sure there is at least one thread per CPU
 	RendererSceneOcclusionCull::HZBuffer::occlusion_jitter_enabled = GLOBAL_GET("rendering/occlusion_culling/jitter_projection");
 
-	dummy_occlusion_culling = memnew(RendererSceneOcclusionCull);
+	// The raycast backend is provided by a module, which replaces this default when it's enabled.
+	if (int(GLOBAL_GET("rendering/occlusion_culling/backend")) == 1) {
+		default_occlusion_culling = memnew(RendererSceneOcclusionCullRaster);
+	} else {
+		default_occlusion_culling = memnew(RendererSceneOcclusionCull);
+	}
 
 	light_culler = memnew(RenderingLightCuller);
 
@@ -4544,8 +4691,8 @@ RendererSceneCull::~RendererSceneCull() {
 	}
 	scene_cull_result_threads.clear();
 
-	if (dummy_occlusion_culling) {
-		memdelete(dummy_occlusion_culling);
+	if (default_occlusion_culling) {
+		memdelete(default_occlusion_culling);
 	}
 
 	if (light_culler) {
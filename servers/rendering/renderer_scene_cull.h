@@ -129,7 +129,7 @@ public:
 
 	/* VISIBILITY NOTIFIER API */
 
-	RendererSceneOcclusionCull *dummy_occlusion_culling = nullptr;
+	RendererSceneOcclusionCull *default_occlusion_culling = nullptr;
 
 	/* SCENARIO API */
 
@@ -1044,6 +1044,18 @@ public:
 
 	uint32_t thread_cull_threshold = 200;
 
+	// Instances moved by instance_set_transforms() that can skip the update list.
+	struct BulkTransform {
+		Instance *instance = nullptr;
+		AABB bvh_aabb;
+	};
+
+	LocalVector<BulkTransform> bulk_transforms;
+
+	_FORCE_INLINE_ bool _instance_can_bulk_transform(const Instance *p_instance, const Transform3D &p_transform) const;
+	void _instance_set_transforms_threaded(uint32_t p_thread, LocalVector<BulkTransform> *p_bulk_transforms);
+	void _instance_set_transforms(LocalVector<BulkTransform> &p_bulk_transforms, uint32_t p_from, uint32_t p_to);
+
 	RID_Owner<Instance, true> instance_owner;
 
 	uint32_t geometry_instance_pair_mask = 0; // used in traditional forward, unnecessary on clustered
@@ -1059,6 +1071,7 @@ public:
 	virtual void instance_set_layer_mask(RID p_instance, uint32_t p_mask);
 	virtual void instance_set_pivot_data(RID p_instance, float p_sorting_offset, bool p_use_aabb_center);
 	virtual void instance_set_transform(RID p_instance, const Transform3D &p_transform);
+	virtual void instance_set_transforms(const Vector<RID> &p_instances, const Vector<float> &p_buffer);
 	virtual void instance_set_interpolated(RID p_instance, bool p_interpolated);
 	virtual void instance_reset_physics_interpolation(RID p_instance);
 	virtual void instance_attach_object_instance_id(RID p_instance, ObjectID p_id);
@@ -1103,6 +1116,8 @@ public:
 	virtual Variant instance_geometry_get_shader_parameter_default_value(RID p_instance, const StringName &p_parameter) const;
 
 	_FORCE_INLINE_ void _update_instance(Instance *p_instance);
+	_FORCE_INLINE_ AABB _get_instance_bvh_aabb(const Instance *p_instance) const;
+	_FORCE_INLINE_ void _update_instance_pairs(Instance *p_instance);
 	_FORCE_INLINE_ void _update_instance_aabb(Instance *p_instance);
 	_FORCE_INLINE_ void _update_dirty_instance(Instance *p_instance);
 	_FORCE_INLINE_ void _update_instance_lightmap_captures(Instance *p_instance);
@@ -0,0 +1,644 @@
+/**************************************************************************/
+/*  renderer_scene_occlusion_cull_raster.cpp                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "renderer_scene_occlusion_cull_raster.h"
+
+#include "core/object/worker_thread_pool.h"
+
+// Spans are rasterized 4 pixels at a time. These wrappers map the few operations
+// needed onto SSE2 or NEON, other platforms use the scalar loop.
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define RASTER_SIMD_ENABLED
+
+typedef __m128 simd_float4;
+typedef __m128 simd_mask4;
+
+static _FORCE_INLINE_ simd_float4 simd_set1(float p_value) { return _mm_set1_ps(p_value); }
+static _FORCE_INLINE_ simd_float4 simd_set(float p_a, float p_b, float p_c, float p_d) { return _mm_setr_ps(p_a, p_b, p_c, p_d); }
+static _FORCE_INLINE_ simd_float4 simd_load(const float *p_ptr) { return _mm_loadu_ps(p_ptr); }
+static _FORCE_INLINE_ void simd_store(float *p_ptr, simd_float4 p_value) { _mm_storeu_ps(p_ptr, p_value); }
+static _FORCE_INLINE_ simd_float4 simd_add(simd_float4 p_a, simd_float4 p_b) { return _mm_add_ps(p_a, p_b); }
+static _FORCE_INLINE_ simd_float4 simd_madd(simd_float4 p_a, simd_float4 p_b, simd_float4 p_c) { return _mm_add_ps(_mm_mul_ps(p_a, p_b), p_c); }
+static _FORCE_INLINE_ simd_float4 simd_div(simd_float4 p_a, simd_float4 p_b) { return _mm_div_ps(p_a, p_b); }
+static _FORCE_INLINE_ simd_float4 simd_min(simd_float4 p_a, simd_float4 p_b) { return _mm_min_ps(p_a, p_b); }
+static _FORCE_INLINE_ simd_mask4 simd_is_positive(simd_float4 p_value) { return _mm_cmpge_ps(p_value, _mm_setzero_ps()); }
+static _FORCE_INLINE_ simd_mask4 simd_and(simd_mask4 p_a, simd_mask4 p_b) { return _mm_and_ps(p_a, p_b); }
+static _FORCE_INLINE_ bool simd_any(simd_mask4 p_mask) { return _mm_movemask_ps(p_mask) != 0; }
+static _FORCE_INLINE_ simd_float4 simd_select(simd_mask4 p_mask, simd_float4 p_a, simd_float4 p_b) { return _mm_or_ps(_mm_and_ps(p_mask, p_a), _mm_andnot_ps(p_mask, p_b)); }
+
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define RASTER_SIMD_ENABLED
+
+typedef float32x4_t simd_float4;
+typedef uint32x4_t simd_mask4;
+
+static _FORCE_INLINE_ simd_float4 simd_set1(float p_value) { return vdupq_n_f32(p_value); }
+static _FORCE_INLINE_ simd_float4 simd_set(float p_a, float p_b, float p_c, float p_d) {
+	const float values[4] = { p_a, p_b, p_c, p_d };
+	return vld1q_f32(values);
+}
+static _FORCE_INLINE_ simd_float4 simd_load(const float *p_ptr) { return vld1q_f32(p_ptr); }
+static _FORCE_INLINE_ void simd_store(float *p_ptr, simd_float4 p_value) { vst1q_f32(p_ptr, p_value); }
+static _FORCE_INLINE_ simd_float4 simd_add(simd_float4 p_a, simd_float4 p_b) { return vaddq_f32(p_a, p_b); }
+static _FORCE_INLINE_ simd_float4 simd_madd(simd_float4 p_a, simd_float4 p_b, simd_float4 p_c) { return vaddq_f32(vmulq_f32(p_a, p_b), p_c); }
+static _FORCE_INLINE_ simd_float4 simd_div(simd_float4 p_a, simd_float4 p_b) { return vdivq_f32(p_a, p_b); }
+static _FORCE_INLINE_ simd_float4 simd_min(simd_float4 p_a, simd_float4 p_b) { return vminq_f32(p_a, p_b); }
+static _FORCE_INLINE_ simd_mask4 simd_is_positive(simd_float4 p_value) { return vcgeq_f32(p_value, vdupq_n_f32(0.0f)); }
+static _FORCE_INLINE_ simd_mask4 simd_and(simd_mask4 p_a, simd_mask4 p_b) { return vandq_u32(p_a, p_b); }
+static _FORCE_INLINE_ bool simd_any(simd_mask4 p_mask) { return vmaxvq_u32(p_mask) != 0; }
+static _FORCE_INLINE_ simd_float4 simd_select(simd_mask4 p_mask, simd_float4 p_a, simd_float4 p_b) { return vbslq_f32(p_mask, p_a, p_b); }
+#endif
+
+RendererSceneOcclusionCullRaster *RendererSceneOcclusionCullRaster::raster_singleton = nullptr;
+
+void RendererSceneOcclusionCullRaster::RasterHZBuffer::clear() {
+	HZBuffer::clear();
+
+	setup_batches.clear();
+	triangles.clear();
+	tile_bins.clear();
+	tile_grid_size = Size2i();
+}
+
+void RendererSceneOcclusionCullRaster::RasterHZBuffer::resize(const Size2i &p_size) {
+	if (p_size == Size2i()) {
+		clear();
+		return;
+	}
+
+	if (!sizes.is_empty() && p_size == sizes[0]) {
+		return; // Size didn't change
+	}
+
+	HZBuffer::resize(p_size);
+
+	tile_grid_size = Size2i((p_size.x + TILE_WIDTH - 1) / TILE_WIDTH, (p_size.y + TILE_HEIGHT - 1) / TILE_HEIGHT);
+	tile_bins.resize(tile_grid_size.x * tile_grid_size.y);
+}
+
+void RendererSceneOcclusionCullRaster::RasterHZBuffer::begin_occluders(const Transform3D &p_cam_transform, const Projection &p_cam_projection, bool p_cam_orthogonal) {
+	cam_inv_transform = p_cam_transform.affine_inverse();
+	cam_projection = p_cam_projection;
+	cam_orthogonal = p_cam_orthogonal;
+	z_near = p_cam_projection.get_z_near();
+	far_depth = p_cam_projection.get_z_far() * 1.05f;
+	debug_tex_range = far_depth;
+
+	setup_batches.clear();
+}
+
+void RendererSceneOcclusionCullRaster::RasterHZBuffer::add_occluder(const Vector3 *p_vertices, uint32_t p_vertex_count, const uint32_t *p_indices, uint32_t p_index_count) {
+	uint32_t triangle_offset = 0;
+	if (!setup_batches.is_empty()) {
+		const SetupBatch &last = setup_batches[setup_batches.size() - 1];
+		triangle_offset = last.triangle_offset + (last.to - last.from) * 2;
+	}
+
+	// Split big meshes into batches so their setup is spread across threads.
+	// Every source triangle reserves two output triangles, as clipping it against
+	// the near plane can produce a quad.
+	uint32_t triangle_count = p_index_count / 3;
+	for (uint32_t from = 0; from < triangle_count; from += SETUP_BATCH_SIZE) {
+		SetupBatch batch;
+		batch.vertices = p_vertices;
+		batch.indices = p_indices;
+		batch.vertex_count = p_vertex_count;
+		batch.from = from;
+		batch.to = MIN(from + SETUP_BATCH_SIZE, triangle_count);
+		batch.triangle_offset = triangle_offset;
+		setup_batches.push_back(batch);
+
+		triangle_offset += (batch.to - batch.from) * 2;
+	}
+}
+
+void RendererSceneOcclusionCullRaster::RasterHZBuffer::_setup_triangle(const Vector3 p_view[3], Triangle &r_triangle) const {
+	const Size2i &buffer_size = sizes[0];
+
+	// Setup is done in double precision, as triangles crossing the near plane
+	// can project very far outside the buffer.
+	double x[3];
+	double y[3];
+	double inv_w[3];
+	double depth_inv_w[3];
+
+	for (int i = 0; i < 3; i++) {
+		Plane projected = cam_projection.xform4(Plane(p_view[i], 1.0));
+		double w = 1.0;
+		if (!cam_orthogonal) {
+			w = projected.d;
+			if (w <= 0.0) {
+				return;
+			}
+		}
+
+		x[i] = (projected.normal.x / w * 0.5 + 0.5) * buffer_size.x;
+		y[i] = (projected.normal.y / w * 0.5 + 0.5) * buffer_size.y;
+		inv_w[i] = 1.0 / w;
+		depth_inv_w[i] = -p_view[i].z / w;
+	}
+
+	double area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+	if (Math::abs(area) < CMP_EPSILON) {
+		return;
+	}
+
+	// Only pixels whose center is inside the triangle are covered.
+	double min_x = MAX(Math::ceil(MIN(x[0], MIN(x[1], x[2])) - 0.5), 0.0);
+	double max_x = MIN(Math::floor(MAX(x[0], MAX(x[1], x[2])) - 0.5), buffer_size.x - 1.0);
+	double min_y = MAX(Math::ceil(MIN(y[0], MIN(y[1], y[2])) - 0.5), 0.0);
+	double max_y = MIN(Math::floor(MAX(y[0], MAX(y[1], y[2])) - 0.5), buffer_size.y - 1.0);
+	if (min_x > max_x || min_y > max_y) {
+		return;
+	}
+
+	// Occluders are double-sided, flip the edges of clockwise triangles.
+	double sign = area > 0.0 ? 1.0 : -1.0;
+	for (int i = 0; i < 3; i++) {
+		// Edge opposite to vertex i, positive inside the triangle.
+		int j = (i + 1) % 3;
+		int k = (i + 2) % 3;
+		double a = (y[j] - y[k]) * sign;
+		double b = (x[k] - x[j]) * sign;
+		double c = (x[j] * y[k] - x[k] * y[j]) * sign;
+
+		// Normalize to pixel distances to keep the float evaluation precise.
+		double length = Math::sqrt(a * a + b * b);
+		a /= length;
+		b /= length;
+		c /= length;
+
+		r_triangle.edge_a[i] = a;
+		r_triangle.edge_b[i] = b;
+		r_triangle.edge_c[i] = c + (a + b) * 0.5; // Evaluated at pixel centers.
+	}
+
+	const double *attributes[2] = { inv_w, depth_inv_w };
+	float *planes[2] = { r_triangle.inv_w, r_triangle.depth_inv_w };
+	for (int i = 0; i < 2; i++) {
+		const double *v = attributes[i];
+		double a = ((v[1] - v[0]) * (y[2] - y[0]) - (v[2] - v[0]) * (y[1] - y[0])) / area;
+		double b = ((v[2] - v[0]) * (x[1] - x[0]) - (v[1] - v[0]) * (x[2] - x[0])) / area;
+		double c = v[0] - a * x[0] - b * y[0];
+
+		planes[i][0] = a;
+		planes[i][1] = b;
+		planes[i][2] = c + (a + b) * 0.5;
+	}
+
+	r_triangle.min_x = min_x;
+	r_triangle.max_x = max_x;
+	r_triangle.min_y = min_y;
+	r_triangle.max_y = max_y;
+}
+
+void RendererSceneOcclusionCullRaster::RasterHZBuffer::_setup_triangles(uint32_t p_batch, void *p_userdata) {
+	const SetupBatch &batch = setup_batches[p_batch];
+	Triangle *output = &triangles[batch.triangle_offset];
+
+	for (uint32_t i = batch.from; i < batch.to; i++, output += 2) {
+		output[0] = Triangle();
+		output[1] = Triangle();
+
+		Vector3 view[3];
+		bool valid = true;
+		for (int j = 0; j < 3; j++) {
+			uint32_t index = batch.indices[i * 3 + j];
+			if (index >= batch.vertex_count) {
+				valid = false;
+				break;
+			}
+			view[j] = cam_inv_transform.xform(batch.vertices[index]);
+		}
+
+		if (!valid) {
+			continue;
+		}
+
+		// Clip against the near plane, which turns the triangle into a quad when a single vertex is behind it.
+		Vector3 clipped[4];
+		int clipped_count = 0;
+		for (int j = 0; j < 3; j++) {
+			const Vector3 &a = view[j];
+			const Vector3 &b = view[(j + 1) % 3];
+			real_t distance_a = -a.z - z_near;
+			real_t distance_b = -b.z - z_near;
+
+			if (distance_a >= 0.0) {
+				clipped[clipped_count++] = a;
+			}
+			if ((distance_a >= 0.0) != (distance_b >= 0.0)) {
+				clipped[clipped_count++] = a + (b - a) * (distance_a / (distance_a - distance_b));
+			}
+		}
+
+		if (clipped_count < 3) {
+			continue;
+		}
+
+		_setup_triangle(clipped, output[0]);
+		if (clipped_count == 4) {
+			const Vector3 second[3] = { clipped[0], clipped[2], clipped[3] };
+			_setup_triangle(second, output[1]);
+		}
+	}
+}
+
+void RendererSceneOcclusionCullRaster::RasterHZBuffer::_rasterize_tile(uint32_t p_tile, void *p_userdata) {
+	const Size2i &buffer_size = sizes[0];
+	const int tile_x = (p_tile % tile_grid_size.x) * TILE_WIDTH;
+	const int tile_y = (p_tile / tile_grid_size.x) * TILE_HEIGHT;
+	const int tile_w = MIN(TILE_WIDTH, buffer_size.x - tile_x);
+	const int tile_h = MIN(TILE_HEIGHT, buffer_size.y - tile_y);
+
+	// Rasterize into a local copy of the tile, so full 4-pixel spans
+	// can be written without touching the tiles of other threads.
+	float tile_depth[TILE_WIDTH * TILE_HEIGHT];
+	for (int i = 0; i < TILE_WIDTH * TILE_HEIGHT; i++) {
+		tile_depth[i] = far_depth;
+	}
+
+	for (const uint32_t &triangle_index : tile_bins[p_tile]) {
+		const Triangle &triangle = triangles[triangle_index];
+
+		// Spans start on a 4-pixel boundary, the edge tests reject the extra pixels.
+		const int from_x = MAX(triangle.min_x - tile_x, 0) & ~3;
+		const int to_x = MIN(triangle.max_x - tile_x, tile_w - 1);
+		const int from_y = MAX(triangle.min_y - tile_y, 0);
+		const int to_y = MIN(triangle.max_y - tile_y, tile_h - 1);
+
+		for (int y = from_y; y <= to_y; y++) {
+			const float py = tile_y + y;
+			float *row = &tile_depth[y * TILE_WIDTH];
+
+			float edge_row[3];
+			for (int i = 0; i < 3; i++) {
+				edge_row[i] = triangle.edge_b[i] * py + triangle.edge_c[i];
+			}
+			const float inv_w_row = triangle.inv_w[1] * py + triangle.inv_w[2];
+			const float depth_row = triangle.depth_inv_w[1] * py + triangle.depth_inv_w[2];
+
+#ifdef RASTER_SIMD_ENABLED
+			const simd_float4 lane_offsets = simd_set(0.0f, 1.0f, 2.0f, 3.0f);
+			const simd_float4 edge_a0 = simd_set1(triangle.edge_a[0]);
+			const simd_float4 edge_a1 = simd_set1(triangle.edge_a[1]);
+			const simd_float4 edge_a2 = simd_set1(triangle.edge_a[2]);
+			const simd_float4 edge_row0 = simd_set1(edge_row[0]);
+			const simd_float4 edge_row1 = simd_set1(edge_row[1]);
+			const simd_float4 edge_row2 = simd_set1(edge_row[2]);
+			const simd_float4 inv_w_a = simd_set1(triangle.inv_w[0]);
+			const simd_float4 inv_w_b = simd_set1(inv_w_row);
+			const simd_float4 depth_a = simd_set1(triangle.depth_inv_w[0]);
+			const simd_float4 depth_b = simd_set1(depth_row);
+
+			for (int x = from_x; x <= to_x; x += 4) {
+				const simd_float4 px = simd_add(simd_set1(float(tile_x + x)), lane_offsets);
+				simd_mask4 inside = simd_is_positive(simd_madd(edge_a0, px, edge_row0));
+				inside = simd_and(inside, simd_is_positive(simd_madd(edge_a1, px, edge_row1)));
+				inside = simd_and(inside, simd_is_positive(simd_madd(edge_a2, px, edge_row2)));
+				if (!simd_any(inside)) {
+					continue;
+				}
+
+				simd_float4 depth = simd_madd(depth_a, px, depth_b);
+				if (!cam_orthogonal) {
+					depth = simd_div(depth, simd_madd(inv_w_a, px, inv_w_b));
+				}
+				const simd_float4 current = simd_load(&row[x]);
+				simd_store(&row[x], simd_select(inside, simd_min(depth, current), current));
+			}
+#else
+			for (int x = from_x; x <= to_x; x++) {
+				const float px = tile_x + x;
+				if (triangle.edge_a[0] * px + edge_row[0] < 0.0f || triangle.edge_a[1] * px + edge_row[1] < 0.0f || triangle.edge_a[2] * px + edge_row[2] < 0.0f) {
+					continue;
+				}
+
+				float depth = triangle.depth_inv_w[0] * px + depth_row;
+				if (!cam_orthogonal) {
+					depth /= triangle.inv_w[0] * px + inv_w_row;
+				}
+				row[x] = MIN(row[x], depth);
+			}
+#endif
+		}
+	}
+
+	for (int y = 0; y < tile_h; y++) {
+		memcpy(&mips[0][(tile_y + y) * buffer_size.x + tile_x], &tile_depth[y * TILE_WIDTH], tile_w * sizeof(float));
+	}
+}
+
+void RendererSceneOcclusionCullRaster::RasterHZBuffer::rasterize() {
+	ERR_FAIL_COND(is_empty());
+
+	uint32_t triangle_count = 0;
+	if (!setup_batches.is_empty()) {
+		const SetupBatch &last = setup_batches[setup_batches.size() - 1];
+		triangle_count = last.triangle_offset + (last.to - last.from) * 2;
+	}
+	triangles.resize(triangle_count);
+
+	if (setup_batches.size() > 1) {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &RasterHZBuffer::_setup_triangles, (void *)nullptr, setup_batches.size(), -1, true, SNAME("RasterOcclusionCullSetup"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	} else if (setup_batches.size() == 1) {
+		_setup_triangles(0, nullptr);
+	}
+
+	for (LocalVector<uint32_t> &bin : tile_bins) {
+		bin.clear();
+	}
+
+	for (uint32_t i = 0; i < triangle_count; i++) {
+		const Triangle &triangle = triangles[i];
+		if (triangle.is_empty()) {
+			continue;
+		}
+
+		for (int tile_y = triangle.min_y / TILE_HEIGHT; tile_y <= triangle.max_y / TILE_HEIGHT; tile_y++) {
+			for (int tile_x = triangle.min_x / TILE_WIDTH; tile_x <= triangle.max_x / TILE_WIDTH; tile_x++) {
+				tile_bins[tile_y * tile_grid_size.x + tile_x].push_back(i);
+			}
+		}
+	}
+
+	WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &RasterHZBuffer::_rasterize_tile, (void *)nullptr, tile_bins.size(), -1, true, SNAME("RasterOcclusionCullRasterize"));
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+}
+
+////////////////////////////////////////////////////////
+
+bool RendererSceneOcclusionCullRaster::is_occluder(RID p_rid) {
+	return occluder_owner.owns(p_rid);
+}
+
+RID RendererSceneOcclusionCullRaster::occluder_allocate() {
+	return occluder_owner.allocate_rid();
+}
+
+void RendererSceneOcclusionCullRaster::occluder_initialize(RID p_occluder) {
+	Occluder *occluder = memnew(Occluder);
+	occluder_owner.initialize_rid(p_occluder, occluder);
+}
+
+void RendererSceneOcclusionCullRaster::occluder_set_mesh(RID p_occluder, const PackedVector3Array &p_vertices, const PackedInt32Array &p_indices) {
+	Occluder *occluder = occluder_owner.get_or_null(p_occluder);
+	ERR_FAIL_NULL(occluder);
+
+	occluder->vertices = p_vertices;
+	occluder->indices = p_indices;
+
+	for (const InstanceID &E : occluder->users) {
+		Scenario *scenario = scenarios.getptr(E.scenario);
+		ERR_CONTINUE(!scenario);
+		ERR_CONTINUE(!scenario->instances.has(E.instance));
+
+		if (!scenario->dirty_instances.has(E.instance)) {
+			scenario->dirty_instances.insert(E.instance);
+			scenario->dirty_instances_array.push_back(E.instance);
+		}
+	}
+}
+
+void RendererSceneOcclusionCullRaster::free_occluder(RID p_occluder) {
+	Occluder *occluder = occluder_owner.get_or_null(p_occluder);
+	ERR_FAIL_NULL(occluder);
+	memdelete(occluder);
+	occluder_owner.free(p_occluder);
+}
+
+////////////////////////////////////////////////////////
+
+void RendererSceneOcclusionCullRaster::add_scenario(RID p_scenario) {
+	ERR_FAIL_COND(scenarios.has(p_scenario));
+	scenarios[p_scenario] = Scenario();
+}
+
+void RendererSceneOcclusionCullRaster::remove_scenario(RID p_scenario) {
+	ERR_FAIL_COND(!scenarios.has(p_scenario));
+	scenarios.erase(p_scenario);
+}
+
+void RendererSceneOcclusionCullRaster::scenario_set_instance(RID p_scenario, RID p_instance, RID p_occluder, const Transform3D &p_xform, bool p_enabled) {
+	Scenario *scenario = scenarios.getptr(p_scenario);
+	ERR_FAIL_NULL(scenario);
+
+	if (!scenario->instances.has(p_instance)) {
+		scenario->instances[p_instance] = OccluderInstance();
+	}
+
+	OccluderInstance &instance = scenario->instances[p_instance];
+
+	bool changed = false;
+
+	if (instance.removed) {
+		instance.removed = false;
+		scenario->removed_instances.erase(p_instance);
+		changed = true; // It was removed and re-added, we might have missed some changes
+	}
+
+	if (instance.occluder != p_occluder) {
+		Occluder *old_occluder = occluder_owner.get_or_null(instance.occluder);
+		if (old_occluder) {
+			old_occluder->users.erase(InstanceID(p_scenario, p_instance));
+		}
+
+		instance.occluder = p_occluder;
+
+		if (p_occluder.is_valid()) {
+			Occluder *occluder = occluder_owner.get_or_null(p_occluder);
+			ERR_FAIL_NULL(occluder);
+			occluder->users.insert(InstanceID(p_scenario, p_instance));
+		}
+		changed = true;
+	}
+
+	if (instance.xform != p_xform) {
+		instance.xform = p_xform;
+		changed = true;
+	}
+
+	// Disabled instances are skipped when rasterizing, they don't need an update.
+	instance.enabled = p_enabled;
+
+	if (changed && !scenario->dirty_instances.has(p_instance)) {
+		scenario->dirty_instances.insert(p_instance);
+		scenario->dirty_instances_array.push_back(p_instance);
+	}
+}
+
+void RendererSceneOcclusionCullRaster::scenario_remove_instance(RID p_scenario, RID p_instance) {
+	Scenario *scenario = scenarios.getptr(p_scenario);
+	ERR_FAIL_NULL(scenario);
+
+	OccluderInstance *instance = scenario->instances.getptr(p_instance);
+	if (instance && !instance->removed) {
+		Occluder *occluder = occluder_owner.get_or_null(instance->occluder);
+		if (occluder) {
+			occluder->users.erase(InstanceID(p_scenario, p_instance));
+		}
+
+		scenario->removed_instances.push_back(p_instance);
+		instance->removed = true;
+	}
+}
+
+void RendererSceneOcclusionCullRaster::Scenario::_update_dirty_instance(uint32_t p_idx, RID *p_instances) {
+	OccluderInstance *occ_inst = instances.getptr(p_instances[p_idx]);
+
+	if (!occ_inst) {
+		return;
+	}
+
+	Occluder *occ = raster_singleton->occluder_owner.get_or_null(occ_inst->occluder);
+
+	if (!occ) {
+		return;
+	}
+
+	int vertices_size = occ->vertices.size();
+	occ_inst->xformed_vertices.resize(vertices_size);
+
+	const Vector3 *read_ptr = occ->vertices.ptr();
+	Vector3 *write_ptr = occ_inst->xformed_vertices.ptr();
+
+	occ_inst->aabb = AABB();
+	for (int i = 0; i < vertices_size; i++) {
+		write_ptr[i] = occ_inst->xform.xform(read_ptr[i]);
+		if (i == 0) {
+			occ_inst->aabb.position = write_ptr[i];
+		} else {
+			occ_inst->aabb.expand_to(write_ptr[i]);
+		}
+	}
+
+	occ_inst->indices.resize(occ->indices.size());
+	memcpy(occ_inst->indices.ptr(), occ->indices.ptr(), occ->indices.size() * sizeof(int32_t));
+}
+
+void RendererSceneOcclusionCullRaster::Scenario::update() {
+	for (const RID &instance : removed_instances) {
+		instances.erase(instance);
+	}
+
+	if (dirty_instances_array.size() > 1) {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &Scenario::_update_dirty_instance, dirty_instances_array.ptr(), dirty_instances_array.size(), -1, true, SNAME("RasterOcclusionCullUpdate"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	} else if (dirty_instances_array.size() == 1) {
+		_update_dirty_instance(0, dirty_instances_array.ptr());
+	}
+
+	dirty_instances.clear();
+	dirty_instances_array.clear();
+	removed_instances.clear();
+}
+
+////////////////////////////////////////////////////////
+
+void RendererSceneOcclusionCullRaster::add_buffer(RID p_buffer) {
+	ERR_FAIL_COND(buffers.has(p_buffer));
+	buffers[p_buffer] = RasterHZBuffer();
+}
+
+void RendererSceneOcclusionCullRaster::remove_buffer(RID p_buffer) {
+	ERR_FAIL_COND(!buffers.has(p_buffer));
+	buffers.erase(p_buffer);
+}
+
+void RendererSceneOcclusionCullRaster::buffer_set_scenario(RID p_buffer, RID p_scenario) {
+	ERR_FAIL_COND(!buffers.has(p_buffer));
+	ERR_FAIL_COND(p_scenario.is_valid() && !scenarios.has(p_scenario));
+	buffers[p_buffer].scenario_rid = p_scenario;
+}
+
+void RendererSceneOcclusionCullRaster::buffer_set_size(RID p_buffer, const Vector2i &p_size) {
+	ERR_FAIL_COND(!buffers.has(p_buffer));
+	buffers[p_buffer].resize(p_size);
+}
+
+void RendererSceneOcclusionCullRaster::buffer_update(RID p_buffer, const Transform3D &p_cam_transform, const Projection &p_cam_projection, bool p_cam_orthogonal) {
+	RasterHZBuffer *buffer = buffers.getptr(p_buffer);
+	if (!buffer || buffer->is_empty()) {
+		return;
+	}
+
+	Scenario *scenario = scenarios.getptr(buffer->scenario_rid);
+	if (!scenario) {
+		return;
+	}
+
+	scenario->update();
+
+	Projection jittered_proj = _jitter_projection(p_cam_projection, buffer->get_occlusion_buffer_size());
+
+	Vector<Plane> planes = jittered_proj.get_projection_planes(p_cam_transform);
+	Vector3 endpoints[8];
+	jittered_proj.get_endpoints(p_cam_transform, endpoints);
+
+	buffer->begin_occluders(p_cam_transform, jittered_proj, p_cam_orthogonal);
+
+	for (const KeyValue<RID, OccluderInstance> &E : scenario->instances) {
+		const OccluderInstance &occ_inst = E.value;
+		if (!occ_inst.enabled || occ_inst.indices.is_empty() || !occluder_owner.owns(occ_inst.occluder)) {
+			continue;
+		}
+
+		if (!occ_inst.aabb.intersects_convex_shape(planes.ptr(), planes.size(), endpoints, 8)) {
+			continue;
+		}
+
+		buffer->add_occluder(occ_inst.xformed_vertices.ptr(), occ_inst.xformed_vertices.size(), occ_inst.indices.ptr(), occ_inst.indices.size());
+	}
+
+	buffer->rasterize();
+	buffer->update_mips();
+}
+
+RendererSceneOcclusionCullRaster::HZBuffer *RendererSceneOcclusionCullRaster::buffer_get_ptr(RID p_buffer) {
+	return buffers.getptr(p_buffer);
+}
+
+RID RendererSceneOcclusionCullRaster::buffer_get_debug_texture(RID p_buffer) {
+	ERR_FAIL_COND_V(!buffers.has(p_buffer), RID());
+	return buffers[p_buffer].get_debug_texture();
+}
+
+////////////////////////////////////////////////////////
+
+RendererSceneOcclusionCullRaster::RendererSceneOcclusionCullRaster() {
+	raster_singleton = this;
+}
+
+RendererSceneOcclusionCullRaster::~RendererSceneOcclusionCullRaster() {
+	raster_singleton = nullptr;
+}
@@ -372,7 +372,7 @@ void RenderingServerDefault::_thread_loop() {
 	DisplayServer::get_singleton()->gl_window_make_current(DisplayServer::MAIN_WINDOW_ID); // Move GL to this thread.
 
 	while (!exit) {
-		WorkerThreadPool::get_singleton()->yield();
+		command_queue.pump_yield();
 		command_queue.flush_all();
 	}
 
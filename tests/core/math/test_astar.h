@@ -32,6 +32,7 @@
 #define TEST_ASTAR_H
 
 #include "core/math/a_star.h"
+#include "core/math/a_star_grid_2d.h"
 
 #include "tests/test_macros.h"
 
@@ -85,6 +86,98 @@ TEST_CASE("[AStar3D] ABCX path") {
 	CHECK(path[3] == ABCX::C);
 }
 
+TEST_CASE("[AStar3D] Bulk paths") {
+	// Overridden costs are solved serially and must still be used.
+	ABCX abcx;
+	PackedInt64Array from_ids = { ABCX::A, ABCX::X, ABCX::C };
+	PackedInt64Array to_ids = { ABCX::C, ABCX::C, ABCX::C };
+	TypedArray<PackedInt64Array> paths = abcx.get_id_paths(from_ids, to_ids);
+	REQUIRE(paths.size() == 3);
+	CHECK(PackedInt64Array(paths[0]) == abcx.get_id_path(ABCX::A, ABCX::C));
+	CHECK(PackedInt64Array(paths[1]) == abcx.get_id_path(ABCX::X, ABCX::C));
+	CHECK(PackedInt64Array(paths[2]).size() == 1);
+
+	// A grid with a disabled point, solved in parallel.
+	AStar3D a;
+	const int size = 16;
+	for (int y = 0; y < size; y++) {
+		for (int x = 0; x < size; x++) {
+			a.add_point(y * size + x, Vector3(x, y, 0));
+			if (x > 0) {
+				a.connect_points(y * size + x, y * size + x - 1);
+			}
+			if (y > 0) {
+				a.connect_points(y * size + x, (y - 1) * size + x);
+			}
+		}
+	}
+	a.set_point_disabled(size * size / 2);
+
+	from_ids.clear();
+	to_ids.clear();
+	for (int i = 0; i < size * size; i += 7) {
+		from_ids.push_back(i);
+		to_ids.push_back(size * size - 1 - i);
+	}
+	paths = a.get_id_paths(from_ids, to_ids);
+	REQUIRE(paths.size() == from_ids.size());
+	for (int i = 0; i < from_ids.size(); i++) {
+		const PackedInt64Array path = paths[i];
+		CHECK(path == a.get_id_path(from_ids[i], to_ids[i]));
+	}
+
+	ERR_PRINT_OFF;
+	CHECK(a.get_id_paths(from_ids, PackedInt64Array()).is_empty());
+	ERR_PRINT_ON;
+}
+
+TEST_CASE("[AStar2D] Bulk paths") {
+	// A grid with a walled in corner, solved in parallel.
+	AStar2D a;
+	const int size = 16;
+	for (int y = 0; y < size; y++) {
+		for (int x = 0; x < size; x++) {
+			a.add_point(y * size + x, Vector2(x, y));
+			if (x > 0) {
+				a.connect_points(y * size + x, y * size + x - 1);
+			}
+			if (y > 0) {
+				a.connect_points(y * size + x, (y - 1) * size + x);
+			}
+		}
+	}
+	a.set_point_disabled(size * size / 2);
+	a.set_point_disabled(1);
+	a.set_point_disabled(size);
+
+	PackedInt64Array from_ids;
+	PackedInt64Array to_ids;
+	for (int i = 0; i < size * size; i += 5) {
+		from_ids.push_back(i);
+		to_ids.push_back(size * size - 1 - i);
+	}
+	from_ids.push_back(size * size - 1);
+	to_ids.push_back(0); // Unreachable corner.
+
+	TypedArray<PackedInt64Array> paths = a.get_id_paths(from_ids, to_ids);
+	REQUIRE(paths.size() == from_ids.size());
+	for (int i = 0; i < from_ids.size(); i++) {
+		CHECK(PackedInt64Array(paths[i]) == a.get_id_path(from_ids[i], to_ids[i]));
+	}
+	CHECK(PackedInt64Array(paths[paths.size() - 1]).is_empty());
+
+	paths = a.get_id_paths(from_ids, to_ids, true);
+	REQUIRE(paths.size() == from_ids.size());
+	for (int i = 0; i < from_ids.size(); i++) {
+		CHECK(PackedInt64Array(paths[i]) == a.get_id_path(from_ids[i], to_ids[i], true));
+	}
+	CHECK_FALSE(PackedInt64Array(paths[paths.size() - 1]).is_empty());
+
+	ERR_PRINT_OFF;
+	CHECK(a.get_id_paths(from_ids, PackedInt64Array()).is_empty());
+	ERR_PRINT_ON;
+}
+
 TEST_CASE("[AStar3D] Add/Remove") {
 	AStar3D a;
 
@@ -213,6 +306,156 @@ TEST_CASE("[AStar3D] Add/Remove") {
 	// It's been great work, cheers. \(^ ^)/
 }
 
+TEST_CASE("[AStarGrid2D] Jump table paths") {
+	Math::seed(0);
+
+	for (int mode = 0; mode < AStarGrid2D::DIAGONAL_MODE_MAX; mode++) {
+		Ref<AStarGrid2D> scanned;
+		Ref<AStarGrid2D> precomputed;
+		scanned.instantiate();
+		precomputed.instantiate();
+		for (Ref<AStarGrid2D> grid : { scanned, precomputed }) {
+			grid->set_region(Rect2i(-4, -4, 32, 32));
+			grid->set_diagonal_mode((AStarGrid2D::DiagonalMode)mode);
+			grid->set_jumping_enabled(true);
+			grid->update();
+		}
+		precomputed->set_jump_table_enabled(true);
+		CHECK(precomputed->is_jump_table_enabled());
+
+		// Change the obstacles between queries, so the table is also updated partially.
+		for (int change = 0; change < 4; change++) {
+			for (int i = 0; i < 24; i++) {
+				const Rect2i obstacle(Math::rand() % 32 - 4, Math::rand() % 32 - 4, Math::rand() % 4 + 1, Math::rand() % 4 + 1);
+				const bool solid = change == 0 || Math::rand() % 2;
+				scanned->fill_solid_region(obstacle, solid);
+				precomputed->fill_solid_region(obstacle, solid);
+			}
+
+			for (int i = 0; i < 32; i++) {
+				const Vector2i from(Math::rand() % 32 - 4, Math::rand() % 32 - 4);
+				const Vector2i to(Math::rand() % 32 - 4, Math::rand() % 32 - 4);
+				CHECK(precomputed->get_id_path(from, to) == scanned->get_id_path(from, to));
+			}
+		}
+	}
+}
+
+static real_t _get_id_path_length(const TypedArray<Vector2i> &p_path) {
+	real_t length = 0.0;
+	for (int i = 1; i < p_path.size(); i++) {
+		length += Vector2(Vector2i(p_path[i]) - Vector2i(p_path[i - 1])).length();
+	}
+	return length;
+}
+
+TEST_CASE("[AStarGrid2D] Jump table paths on a grid wider than the jump table steps") {
+	// Open runs longer than the 16384 steps a jump table value can hold are saturated and walked in several hops.
+	const Rect2i region(0, 0, 20000, 4);
+	const Vector2i queries[][2] = {
+		{ Vector2i(0, 0), Vector2i(19999, 0) },
+		{ Vector2i(19999, 3), Vector2i(0, 1) },
+		{ Vector2i(50, 2), Vector2i(19500, 1) },
+		{ Vector2i(17000, 0), Vector2i(17000, 3) },
+	};
+
+	for (int mode = 0; mode < AStarGrid2D::DIAGONAL_MODE_MAX; mode++) {
+		Ref<AStarGrid2D> plain;
+		Ref<AStarGrid2D> scanned;
+		Ref<AStarGrid2D> precomputed;
+		plain.instantiate();
+		scanned.instantiate();
+		precomputed.instantiate();
+		for (Ref<AStarGrid2D> grid : { plain, scanned, precomputed }) {
+			grid->set_region(region);
+			grid->set_diagonal_mode((AStarGrid2D::DiagonalMode)mode);
+			grid->update();
+			// Walls open at alternating ends, far enough apart for the runs between them to saturate.
+			grid->fill_solid_region(Rect2i(100, 0, 1, 3));
+			grid->fill_solid_region(Rect2i(19000, 1, 1, 3));
+		}
+		scanned->set_jumping_enabled(true);
+		precomputed->set_jumping_enabled(true);
+		precomputed->set_jump_table_enabled(true);
+
+		// The second round only updates the jump table around the new wall, the third one around the gap opened in it.
+		for (int change = 0; change < 3; change++) {
+			if (change > 0) {
+				const Rect2i wall(10000, change == 1 ? 0 : 1, 1, change == 1 ? 3 : 1);
+				const bool solid = change == 1;
+				for (Ref<AStarGrid2D> grid : { plain, scanned, precomputed }) {
+					grid->fill_solid_region(wall, solid);
+				}
+			}
+
+			for (const Vector2i *query : queries) {
+				const TypedArray<Vector2i> plain_path = plain->get_id_path(query[0], query[1]);
+				const TypedArray<Vector2i> precomputed_path = precomputed->get_id_path(query[0], query[1]);
+				REQUIRE(plain_path.size() > 0);
+				CHECK(precomputed_path == scanned->get_id_path(query[0], query[1]));
+				CHECK_MESSAGE(_get_id_path_length(precomputed_path) == doctest::Approx(_get_id_path_length(plain_path)),
+						vformat("Jump table path from %s to %s should be as short as the A* path in diagonal mode %d.", query[0], query[1], mode));
+			}
+		}
+	}
+}
+
+TEST_CASE("[AStarGrid2D] Flow fields") {
+	Ref<AStarGrid2D> grid;
+	grid.instantiate();
+	grid->set_region(Rect2i(0, 0, 16, 16));
+	grid->set_diagonal_mode(AStarGrid2D::DIAGONAL_MODE_NEVER);
+	grid->set_default_compute_heuristic(AStarGrid2D::HEURISTIC_MANHATTAN);
+	grid->update();
+	// A wall with a gap, and a walled in point.
+	grid->fill_solid_region(Rect2i(8, 0, 1, 14));
+	grid->fill_solid_region(Rect2i(12, 12, 3, 3));
+	grid->set_point_solid(Vector2i(13, 13), false);
+
+	const Vector2i target(15, 0);
+	TypedArray<Vector2i> targets;
+	targets.push_back(target);
+	targets.push_back(Vector2i(0, 15));
+	grid->update_flow_fields(targets);
+
+	PackedFloat32Array costs = grid->get_flow_field_costs(target);
+	REQUIRE(costs.size() == 16 * 16);
+	CHECK(costs[0] == doctest::Approx(grid->get_id_path(Vector2i(0, 0), target).size() - 1));
+	CHECK(Math::is_inf(costs[13 * 16 + 13]));
+	CHECK(grid->get_flow_field_next_point(target, Vector2i(13, 13)) == Vector2i(13, 13));
+	CHECK(grid->get_flow_field_next_point(target, target) == target);
+
+	// Following the directions reaches the target.
+	Vector2i point(0, 0);
+	int steps = 0;
+	while (point != target && steps < 256) {
+		const Vector2i next_point = grid->get_flow_field_next_point(target, point);
+		CHECK(grid->get_flow_field_directions(target)[point.y * 16 + point.x] == Vector2(next_point - point));
+		point = next_point;
+		steps++;
+	}
+	CHECK(point == target);
+	CHECK(steps == grid->get_id_path(Vector2i(0, 0), target).size() - 1);
+
+	// Changing the grid updates the cached flow fields.
+	grid->fill_solid_region(Rect2i(8, 14, 1, 2));
+	CHECK(Math::is_inf(grid->get_flow_field_costs(target)[0]));
+	CHECK(grid->get_flow_field_next_point(target, Vector2i(0, 0)) == Vector2i(0, 0));
+
+	// Fields freed from the cache by more recent targets are computed again.
+	TypedArray<Vector2i> many_targets;
+	for (int x = 0; x < 8; x++) {
+		for (int y = 0; y < 8; y++) {
+			many_targets.push_back(Vector2i(x, y));
+		}
+	}
+	grid->update_flow_fields(many_targets);
+	CHECK(grid->get_flow_field_costs(Vector2i(0, 0))[1] == doctest::Approx(1));
+	CHECK(grid->get_flow_field_costs(Vector2i(7, 7))[7 * 16 + 6] == doctest::Approx(1));
+	CHECK(Math::is_inf(grid->get_flow_field_costs(target)[0]));
+	grid->clear_flow_fields();
+}
+
 TEST_CASE("[Stress][AStar3D] Find paths") {
 	// Random stress tests with Floyd-Warshall.
 	const int N = 30;
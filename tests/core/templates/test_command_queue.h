@@ -157,7 +157,7 @@ public:
 					command_queue.flush_all();
 				}
 				for (int i = 0; i < message_count_to_read; i++) {
-					WorkerThreadPool::get_singleton()->yield();
+					command_queue.pump_yield();
 					command_queue.wait_and_flush();
 				}
 			}
@@ -446,6 +446,239 @@ TEST_CASE("[Stress][CommandQueue] Stress test command queue") {
 	ProjectSettings::get_singleton()->set_setting(COMMAND_QUEUE_SETTING,
 			ProjectSettings::get_singleton()->property_get_revert(COMMAND_QUEUE_SETTING));
 }
+
+class MultipleProducerState {
+public:
+	static const int WRITER_COUNT = 4;
+	static const int MESSAGES_PER_WRITER = 4096;
+
+	struct Writer {
+		MultipleProducerState *state = nullptr;
+		int index = 0;
+		int sync_errors = 0;
+		Thread thread;
+	};
+
+	CommandQueueMT command_queue;
+	Writer writers[WRITER_COUNT];
+	Thread reader_thread;
+	SafeFlag exit_reader;
+
+	// Only touched from the reader thread while commands are flushed.
+	int last_received[WRITER_COUNT];
+	int order_errors = 0;
+	int received = 0;
+
+	void receive(int p_writer, int p_message) {
+		if (p_message != last_received[p_writer] + 1) {
+			order_errors++;
+		}
+		last_received[p_writer] = p_message;
+		received++;
+	}
+	int get_last_received(int p_writer) {
+		return last_received[p_writer];
+	}
+
+	static void reader_thread_loop(void *p_userdata) {
+		MultipleProducerState *state = static_cast<MultipleProducerState *>(p_userdata);
+		while (!state->exit_reader.is_set()) {
+			state->command_queue.flush_all();
+		}
+		state->command_queue.flush_all();
+	}
+
+	static void writer_thread_loop(void *p_userdata) {
+		Writer *writer = static_cast<Writer *>(p_userdata);
+		CommandQueueMT &queue = writer->state->command_queue;
+		for (int i = 0; i < MESSAGES_PER_WRITER; i++) {
+			queue.push(writer->state, &MultipleProducerState::receive, writer->index, i);
+			if (i % 512 == 511) {
+				int last = -1;
+				queue.push_and_ret(writer->state, &MultipleProducerState::get_last_received, writer->index, &last);
+				if (last != i) {
+					writer->sync_errors++;
+				}
+			}
+		}
+		queue.sync();
+	}
+
+	void run() {
+		for (int i = 0; i < WRITER_COUNT; i++) {
+			last_received[i] = -1;
+		}
+		command_queue.set_multiple_producers(true);
+		reader_thread.start(&MultipleProducerState::reader_thread_loop, this);
+		for (int i = 0; i < WRITER_COUNT; i++) {
+			writers[i].state = this;
+			writers[i].index = i;
+			writers[i].thread.start(&MultipleProducerState::writer_thread_loop, &writers[i]);
+		}
+		for (int i = 0; i < WRITER_COUNT; i++) {
+			writers[i].thread.wait_to_finish();
+		}
+		exit_reader.set();
+		reader_thread.wait_to_finish();
+	}
+};
+
+TEST_CASE("[CommandQueue] Test multiple producers") {
+	MultipleProducerState mps;
+	mps.run();
+
+	CHECK_MESSAGE(mps.received == MultipleProducerState::WRITER_COUNT * MultipleProducerState::MESSAGES_PER_WRITER,
+			"Reader should have received every message from every writer.");
+	CHECK_MESSAGE(mps.order_errors == 0,
+			"Messages from each writer should be received in push order.");
+	for (int i = 0; i < MultipleProducerState::WRITER_COUNT; i++) {
+		CHECK_MESSAGE(mps.writers[i].sync_errors == 0,
+				"Returning commands should only run after everything the writer pushed before them.");
+	}
+}
+
+class ProducerOrderState {
+public:
+	static const int MESSAGES = 2048;
+
+	CommandQueueMT command_queue;
+	Thread reader_thread;
+	Thread setter_thread;
+	Thread checker_thread;
+	SafeFlag exit_reader;
+	SafeFlag checker_registered;
+	SafeNumeric<int> published;
+
+	// Only touched from the reader thread while commands are flushed.
+	int value = -1;
+	int order_errors = 0;
+	int received = 0;
+
+	void set_value(int p_value) {
+		value = p_value;
+		received++;
+	}
+	void check_value(int p_value) {
+		if (value != p_value) {
+			order_errors++;
+		}
+		received++;
+	}
+	void count() {
+		received++;
+	}
+
+	static void reader_thread_loop(void *p_userdata) {
+		ProducerOrderState *state = static_cast<ProducerOrderState *>(p_userdata);
+		while (!state->exit_reader.is_set()) {
+			state->command_queue.flush_all();
+		}
+		state->command_queue.flush_all();
+	}
+
+	static void setter_thread_loop(void *p_userdata) {
+		ProducerOrderState *state = static_cast<ProducerOrderState *>(p_userdata);
+		for (int i = 0; i < MESSAGES; i++) {
+			state->command_queue.push(state, &ProducerOrderState::set_value, i);
+			state->published.set(i);
+		}
+	}
+
+	static void checker_thread_loop(void *p_userdata) {
+		ProducerOrderState *state = static_cast<ProducerOrderState *>(p_userdata);
+		// Take the first producer slot, so draining slots in order would run this
+		// thread's commands too early.
+		state->command_queue.push(state, &ProducerOrderState::count);
+		state->checker_registered.set();
+		for (int i = 0; i < MESSAGES; i++) {
+			while (state->published.get() < i) {
+				OS::get_singleton()->delay_usec(1);
+			}
+			// Pushed after the matching set_value() was, so it must run after it.
+			state->command_queue.push(state, &ProducerOrderState::check_value, i);
+		}
+		state->command_queue.sync();
+	}
+
+	void run() {
+		published.set(-1);
+		command_queue.set_multiple_producers(true);
+		reader_thread.start(&ProducerOrderState::reader_thread_loop, this);
+		checker_thread.start(&ProducerOrderState::checker_thread_loop, this);
+		while (!checker_registered.is_set()) {
+			OS::get_singleton()->delay_usec(1);
+		}
+		setter_thread.start(&ProducerOrderState::setter_thread_loop, this);
+		setter_thread.wait_to_finish();
+		checker_thread.wait_to_finish();
+		exit_reader.set();
+		reader_thread.wait_to_finish();
+	}
+};
+
+TEST_CASE("[CommandQueue] Test multiple producers keep cross-thread order") {
+	ProducerOrderState pos;
+	pos.run();
+
+	CHECK_MESSAGE(pos.received == ProducerOrderState::MESSAGES * 2 + 1,
+			"Reader should have received every message.");
+	CHECK_MESSAGE(pos.order_errors == 0,
+			"Commands pushed after another thread's push returned should run after it.");
+}
+
+class ShortLivedProducerState {
+public:
+	static const int THREAD_COUNT = 80;
+	static const int MESSAGES_PER_THREAD = 64;
+
+	CommandQueueMT command_queue;
+	Thread reader_thread;
+	SafeFlag exit_reader;
+
+	// Only touched from the reader thread while commands are flushed.
+	int received = 0;
+
+	void receive() {
+		received++;
+	}
+
+	static void reader_thread_loop(void *p_userdata) {
+		ShortLivedProducerState *state = static_cast<ShortLivedProducerState *>(p_userdata);
+		while (!state->exit_reader.is_set()) {
+			state->command_queue.flush_all();
+		}
+		state->command_queue.flush_all();
+	}
+
+	static void writer_thread_loop(void *p_userdata) {
+		ShortLivedProducerState *state = static_cast<ShortLivedProducerState *>(p_userdata);
+		for (int i = 0; i < MESSAGES_PER_THREAD; i++) {
+			state->command_queue.push(state, &ShortLivedProducerState::receive);
+		}
+		state->command_queue.sync();
+	}
+
+	void run() {
+		command_queue.set_multiple_producers(true);
+		reader_thread.start(&ShortLivedProducerState::reader_thread_loop, this);
+		// More threads than producer slots, one after another.
+		for (int i = 0; i < THREAD_COUNT; i++) {
+			Thread writer_thread;
+			writer_thread.start(&ShortLivedProducerState::writer_thread_loop, this);
+			writer_thread.wait_to_finish();
+		}
+		exit_reader.set();
+		reader_thread.wait_to_finish();
+	}
+};
+
+TEST_CASE("[CommandQueue] Test multiple producers with short-lived threads") {
+	ShortLivedProducerState slps;
+	slps.run();
+
+	CHECK_MESSAGE(slps.received == ShortLivedProducerState::THREAD_COUNT * ShortLivedProducerState::MESSAGES_PER_THREAD,
+			"Reader should have received every message, including from threads that reused a producer slot.");
+}
 } // namespace TestCommandQueue
 
 #endif // TEST_COMMAND_QUEUE_H
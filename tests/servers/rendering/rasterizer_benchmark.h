@@ -0,0 +1,323 @@
+/**************************************************************************/
+/*  rasterizer_benchmark.h                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef RASTERIZER_BENCHMARK_H
+#define RASTERIZER_BENCHMARK_H
+
+#include "servers/rendering/dummy/rasterizer_dummy.h"
+#include "servers/rendering/rendering_server_default.h"
+#include "servers/rendering/storage/render_scene_buffers.h"
+
+// A compositor for the rendering benchmarks. It builds on the dummy rasterizer, but keeps the
+// lights and render targets that the dummy one ignores, so that viewports are drawn and lights
+// are paired with geometry, and it counts what it is asked to draw.
+// It is only installed by ScopedBenchmarkRenderingServer, the dummy rasterizer stays a no-op.
+
+namespace TestRenderingBenchmark {
+
+class BenchmarkLightStorage : public RendererDummy::LightStorage {
+	struct Light {
+		RS::LightType type = RS::LIGHT_OMNI;
+		float param[RS::LIGHT_PARAM_MAX] = {};
+		Color color = Color(1, 1, 1, 1);
+		bool shadow = false;
+		uint32_t cull_mask = 0xFFFFFFFF;
+	};
+
+	mutable RID_Owner<Light, true> light_owner;
+
+	void _light_initialize(RID p_light, RS::LightType p_type) {
+		Light light;
+		light.type = p_type;
+		light.param[RS::LIGHT_PARAM_ENERGY] = 1.0;
+		light.param[RS::LIGHT_PARAM_RANGE] = 1.0;
+		light.param[RS::LIGHT_PARAM_ATTENUATION] = 1.0;
+		light.param[RS::LIGHT_PARAM_SPOT_ANGLE] = 45;
+		light.param[RS::LIGHT_PARAM_SHADOW_SPLIT_1_OFFSET] = 0.1;
+		light.param[RS::LIGHT_PARAM_SHADOW_SPLIT_2_OFFSET] = 0.3;
+		light.param[RS::LIGHT_PARAM_SHADOW_SPLIT_3_OFFSET] = 0.6;
+		light.param[RS::LIGHT_PARAM_SHADOW_FADE_START] = 0.8;
+		light.param[RS::LIGHT_PARAM_SHADOW_PANCAKE_SIZE] = 20.0;
+		light_owner.initialize_rid(p_light, light);
+	}
+
+public:
+	bool owns_light(RID p_rid) { return light_owner.owns(p_rid); }
+
+	virtual RID directional_light_allocate() override { return light_owner.allocate_rid(); }
+	virtual void directional_light_initialize(RID p_rid) override { _light_initialize(p_rid, RS::LIGHT_DIRECTIONAL); }
+	virtual RID omni_light_allocate() override { return light_owner.allocate_rid(); }
+	virtual void omni_light_initialize(RID p_rid) override { _light_initialize(p_rid, RS::LIGHT_OMNI); }
+	virtual RID spot_light_allocate() override { return light_owner.allocate_rid(); }
+	virtual void spot_light_initialize(RID p_rid) override { _light_initialize(p_rid, RS::LIGHT_SPOT); }
+
+	virtual void light_free(RID p_rid) override { light_owner.free(p_rid); }
+
+	virtual void light_set_color(RID p_light, const Color &p_color) override {
+		Light *light = light_owner.get_or_null(p_light);
+		ERR_FAIL_NULL(light);
+		light->color = p_color;
+	}
+
+	virtual void light_set_param(RID p_light, RS::LightParam p_param, float p_value) override {
+		Light *light = light_owner.get_or_null(p_light);
+		ERR_FAIL_NULL(light);
+		ERR_FAIL_INDEX(p_param, RS::LIGHT_PARAM_MAX);
+		light->param[p_param] = p_value;
+	}
+
+	virtual void light_set_shadow(RID p_light, bool p_enabled) override {
+		Light *light = light_owner.get_or_null(p_light);
+		ERR_FAIL_NULL(light);
+		light->shadow = p_enabled;
+	}
+
+	virtual void light_set_cull_mask(RID p_light, uint32_t p_mask) override {
+		Light *light = light_owner.get_or_null(p_light);
+		ERR_FAIL_NULL(light);
+		light->cull_mask = p_mask;
+	}
+
+	virtual bool light_has_shadow(RID p_light) const override {
+		const Light *light = light_owner.get_or_null(p_light);
+		ERR_FAIL_NULL_V(light, false);
+		return light->shadow;
+	}
+
+	virtual RS::LightType light_get_type(RID p_light) const override {
+		const Light *light = light_owner.get_or_null(p_light);
+		ERR_FAIL_NULL_V(light, RS::LIGHT_DIRECTIONAL);
+		return light->type;
+	}
+
+	virtual AABB light_get_aabb(RID p_light) const override {
+		const Light *light = light_owner.get_or_null(p_light);
+		ERR_FAIL_NULL_V(light, AABB());
+
+		switch (light->type) {
+			case RS::LIGHT_SPOT: {
+				float len = light->param[RS::LIGHT_PARAM_RANGE];
+				float size = Math::tan(Math::deg_to_rad(light->param[RS::LIGHT_PARAM_SPOT_ANGLE])) * len;
+				return AABB(Vector3(-size, -size, -len), Vector3(size * 2, size * 2, len));
+			}
+			case RS::LIGHT_OMNI: {
+				float r = light->param[RS::LIGHT_PARAM_RANGE];
+				return AABB(-Vector3(r, r, r), Vector3(r, r, r) * 2);
+			}
+			case RS::LIGHT_DIRECTIONAL: {
+				return AABB();
+			}
+		}
+
+		ERR_FAIL_V(AABB());
+	}
+
+	virtual float light_get_param(RID p_light, RS::LightParam p_param) override {
+		const Light *light = light_owner.get_or_null(p_light);
+		ERR_FAIL_NULL_V(light, 0);
+		ERR_FAIL_INDEX_V(p_param, RS::LIGHT_PARAM_MAX, 0);
+		return light->param[p_param];
+	}
+
+	virtual Color light_get_color(RID p_light) override {
+		const Light *light = light_owner.get_or_null(p_light);
+		ERR_FAIL_NULL_V(light, Color());
+		return light->color;
+	}
+
+	virtual uint32_t light_get_cull_mask(RID p_light) const override {
+		const Light *light = light_owner.get_or_null(p_light);
+		ERR_FAIL_NULL_V(light, 0);
+		return light->cull_mask;
+	}
+};
+
+class BenchmarkTextureStorage : public RendererDummy::TextureStorage {
+	struct RenderTarget {
+		Size2i size;
+	};
+
+	mutable RID_Owner<RenderTarget> render_target_owner;
+
+public:
+	virtual RID render_target_create() override { return render_target_owner.make_rid(RenderTarget()); }
+	virtual void render_target_free(RID p_rid) override { render_target_owner.free(p_rid); }
+
+	virtual void render_target_set_size(RID p_render_target, int p_width, int p_height, uint32_t p_view_count) override {
+		RenderTarget *rt = render_target_owner.get_or_null(p_render_target);
+		ERR_FAIL_NULL(rt);
+		rt->size = Size2i(p_width, p_height);
+	}
+
+	virtual Size2i render_target_get_size(RID p_render_target) const override {
+		const RenderTarget *rt = render_target_owner.get_or_null(p_render_target);
+		ERR_FAIL_NULL_V(rt, Size2i());
+		return rt->size;
+	}
+};
+
+class BenchmarkUtilities : public RendererDummy::Utilities {
+public:
+	BenchmarkLightStorage *light_storage = nullptr;
+
+	virtual RS::InstanceType get_base_type(RID p_rid) const override {
+		if (light_storage->owns_light(p_rid)) {
+			return RS::INSTANCE_LIGHT;
+		}
+		return RendererDummy::Utilities::get_base_type(p_rid);
+	}
+
+	virtual bool free(RID p_rid) override {
+		if (light_storage->owns_light(p_rid)) {
+			light_storage->light_free(p_rid);
+			return true;
+		}
+		return RendererDummy::Utilities::free(p_rid);
+	}
+};
+
+// Counts the canvas items that survived culling, as the real renderers do.
+class BenchmarkCanvasRender : public RasterizerCanvasDummy {
+public:
+	void canvas_render_items(RID p_to_render_target, Item *p_item_list, const Color &p_modulate, Light *p_light_list, Light *p_directional_list, const Transform2D &p_canvas_transform, RS::CanvasItemTextureFilter p_default_filter, RS::CanvasItemTextureRepeat p_default_repeat, bool p_snap_2d_vertices_to_pixel, bool &r_sdf_used, RenderingMethod::RenderInfo *r_render_info = nullptr) override {
+		r_sdf_used = false;
+		if (r_render_info) {
+			for (Item *item = p_item_list; item; item = item->next) {
+				r_render_info->info[RS::VIEWPORT_RENDER_INFO_TYPE_CANVAS][RS::VIEWPORT_RENDER_INFO_OBJECTS_IN_FRAME]++;
+			}
+		}
+	}
+};
+
+class BenchmarkRenderSceneBuffers : public RenderSceneBuffers {
+	GDCLASS(BenchmarkRenderSceneBuffers, RenderSceneBuffers);
+
+public:
+	virtual void configure(const RenderSceneBuffersConfiguration *p_config) override {}
+	virtual void set_fsr_sharpness(float p_fsr_sharpness) override {}
+	virtual void set_texture_mipmap_bias(float p_texture_mipmap_bias) override {}
+	virtual void set_use_debanding(bool p_use_debanding) override {}
+};
+
+// Counts the instances that survived culling, as the real renderers do.
+class BenchmarkSceneRender : public RasterizerSceneDummy {
+public:
+	void render_scene(const Ref<RenderSceneBuffers> &p_render_buffers, const CameraData *p_camera_data, const CameraData *p_prev_camera_data, const PagedArray<RenderGeometryInstance *> &p_instances, const PagedArray<RID> &p_lights, const PagedArray<RID> &p_reflection_probes, const PagedArray<RID> &p_voxel_gi_instances, const PagedArray<RID> &p_decals, const PagedArray<RID> &p_lightmaps, const PagedArray<RID> &p_fog_volumes, RID p_environment, RID p_camera_attributes, RID p_compositor, RID p_shadow_atlas, RID p_occluder_debug_tex, RID p_reflection_atlas, RID p_reflection_probe, int p_reflection_probe_pass, float p_screen_mesh_lod_threshold, const RenderShadowData *p_render_shadows, int p_render_shadow_count, const RenderSDFGIData *p_render_sdfgi_regions, int p_render_sdfgi_region_count, const RenderSDFGIUpdateData *p_sdfgi_update_data = nullptr, RenderingMethod::RenderInfo *r_info = nullptr) override {
+		if (r_info) {
+			r_info->info[RS::VIEWPORT_RENDER_INFO_TYPE_VISIBLE][RS::VIEWPORT_RENDER_INFO_OBJECTS_IN_FRAME] += p_instances.size();
+		}
+	}
+
+	Ref<RenderSceneBuffers> render_buffers_create() override { return memnew(BenchmarkRenderSceneBuffers); }
+};
+
+class RasterizerBenchmark : public RendererCompositor {
+	uint64_t frame = 1;
+	double delta = 0;
+	double time = 0.0;
+
+	BenchmarkCanvasRender canvas;
+	BenchmarkUtilities utilities;
+	BenchmarkLightStorage light_storage;
+	RendererDummy::MaterialStorage material_storage;
+	RendererDummy::MeshStorage mesh_storage;
+	RendererDummy::ParticlesStorage particles_storage;
+	BenchmarkTextureStorage texture_storage;
+	RendererDummy::GI gi;
+	RendererDummy::Fog fog;
+	BenchmarkSceneRender scene;
+
+public:
+	RendererUtilities *get_utilities() override { return &utilities; };
+	RendererLightStorage *get_light_storage() override { return &light_storage; };
+	RendererMaterialStorage *get_material_storage() override { return &material_storage; };
+	RendererMeshStorage *get_mesh_storage() override { return &mesh_storage; };
+	RendererParticlesStorage *get_particles_storage() override { return &particles_storage; };
+	RendererTextureStorage *get_texture_storage() override { return &texture_storage; };
+	RendererGI *get_gi() override { return &gi; };
+	RendererFog *get_fog() override { return &fog; };
+	RendererCanvasRender *get_canvas() override { return &canvas; }
+	RendererSceneRender *get_scene() override { return &scene; }
+
+	void set_boot_image(const Ref<Image> &p_image, const Color &p_color, bool p_scale, bool p_use_filter = true) override {}
+
+	void initialize() override {}
+	void begin_frame(double frame_step) override {
+		frame++;
+		delta = frame_step;
+		time += frame_step;
+	}
+
+	void blit_render_targets_to_screen(int p_screen, const BlitToScreen *p_render_targets, int p_amount) override {}
+	void gl_end_frame(bool p_swap_buffers) override {}
+	void end_frame(bool p_swap_buffers) override {}
+	void finalize() override {}
+
+	static RendererCompositor *_create_current() {
+		return memnew(RasterizerBenchmark);
+	}
+
+	static void make_current() {
+		_create_func = _create_current;
+		low_end = false;
+	}
+
+	uint64_t get_frame_number() const override { return frame; }
+	double get_frame_delta_time() const override { return delta; }
+	double get_total_time() const override { return time; }
+
+	RasterizerBenchmark() {
+		utilities.light_storage = &light_storage;
+	}
+};
+
+// Creates a rendering server that draws with RasterizerBenchmark for the lifetime of the object.
+// The benchmarks don't run in a scene tree, whose root viewport would keep RIDs of another server.
+struct ScopedBenchmarkRenderingServer {
+	ScopedBenchmarkRenderingServer() {
+		RasterizerBenchmark::make_current();
+		memnew(RenderingServerDefault());
+		RenderingServerDefault::get_singleton()->init();
+		RenderingServerDefault::get_singleton()->set_render_loop_enabled(false);
+		RasterizerDummy::make_current();
+	}
+
+	~ScopedBenchmarkRenderingServer() {
+		RenderingServer *rs = RenderingServer::get_singleton();
+		rs->sync();
+		rs->global_shader_parameters_clear();
+		rs->finish();
+		memdelete(rs);
+	}
+};
+
+} // namespace TestRenderingBenchmark
+
+#endif // RASTERIZER_BENCHMARK_H
@@ -0,0 +1,146 @@
+/**************************************************************************/
+/*  test_occlusion_cull_raster.h                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_OCCLUSION_CULL_RASTER_H
+#define TEST_OCCLUSION_CULL_RASTER_H
+
+#include "servers/rendering/renderer_scene_occlusion_cull_raster.h"
+
+#include "tests/test_macros.h"
+
+namespace TestOcclusionCullRaster {
+
+bool is_aabb_occluded(RendererSceneOcclusionCull::HZBuffer *p_buffer, const AABB &p_aabb, const Transform3D &p_cam_transform, const Projection &p_cam_projection) {
+	const Vector3 end = p_aabb.get_end();
+	const real_t bounds[6] = { p_aabb.position.x, p_aabb.position.y, p_aabb.position.z, end.x, end.y, end.z };
+	uint64_t occlusion_timeout = 0;
+	return p_buffer->is_occluded(bounds, p_cam_transform.origin, p_cam_transform.affine_inverse(), p_cam_projection, p_cam_projection.get_z_near(), occlusion_timeout);
+}
+
+TEST_CASE("[RendererSceneOcclusionCullRaster] Occluders hide the instances behind them") {
+	RendererSceneOcclusionCullRaster occlusion_cull;
+	const RID scenario = RID::from_uint64(1);
+	const RID buffer = RID::from_uint64(2);
+	const RID instances[2] = { RID::from_uint64(3), RID::from_uint64(4) };
+
+	RID quad = occlusion_cull.occluder_allocate();
+	occlusion_cull.occluder_initialize(quad);
+	occlusion_cull.occluder_set_mesh(quad, { Vector3(-1, -1, 0), Vector3(1, -1, 0), Vector3(1, 1, 0), Vector3(-1, 1, 0) }, { 0, 1, 2, 0, 2, 3 });
+
+	occlusion_cull.add_scenario(scenario);
+	occlusion_cull.add_buffer(buffer);
+	occlusion_cull.buffer_set_scenario(buffer, scenario);
+	occlusion_cull.buffer_set_size(buffer, Vector2i(64, 64));
+
+	Projection projection;
+	projection.set_perspective(90.0, 1.0, 0.05, 100.0);
+	const Transform3D cam_transform;
+
+	RendererSceneOcclusionCull::HZBuffer *hz_buffer = occlusion_cull.buffer_get_ptr(buffer);
+	REQUIRE(hz_buffer != nullptr);
+
+	SUBCASE("Quad in front of the camera") {
+		occlusion_cull.scenario_set_instance(scenario, instances[0], quad, Transform3D(Basis(), Vector3(0, 0, -5)), true);
+		occlusion_cull.buffer_update(buffer, cam_transform, projection, false);
+
+		CHECK(is_aabb_occluded(hz_buffer, AABB(Vector3(-0.5, -0.5, -11), Vector3(1, 1, 1)), cam_transform, projection));
+		CHECK_FALSE(is_aabb_occluded(hz_buffer, AABB(Vector3(-0.5, -0.5, -4), Vector3(1, 1, 1)), cam_transform, projection));
+		CHECK_FALSE(is_aabb_occluded(hz_buffer, AABB(Vector3(5, -0.5, -11), Vector3(1, 1, 1)), cam_transform, projection));
+
+		// Disabled and removed occluders don't hide anything.
+		occlusion_cull.scenario_set_instance(scenario, instances[0], quad, Transform3D(Basis(), Vector3(0, 0, -5)), false);
+		occlusion_cull.buffer_update(buffer, cam_transform, projection, false);
+		CHECK_FALSE(is_aabb_occluded(hz_buffer, AABB(Vector3(-0.5, -0.5, -11), Vector3(1, 1, 1)), cam_transform, projection));
+
+		occlusion_cull.scenario_set_instance(scenario, instances[0], quad, Transform3D(Basis(), Vector3(0, 0, -5)), true);
+		occlusion_cull.scenario_remove_instance(scenario, instances[0]);
+		occlusion_cull.buffer_update(buffer, cam_transform, projection, false);
+		CHECK_FALSE(is_aabb_occluded(hz_buffer, AABB(Vector3(-0.5, -0.5, -11), Vector3(1, 1, 1)), cam_transform, projection));
+	}
+
+	SUBCASE("Floor crossing the near plane") {
+		// A large floor below the camera, which has to be clipped against the near plane.
+		const Transform3D floor_transform = Transform3D(Basis(Vector3(1, 0, 0), -Math_PI * 0.5).scaled(Vector3(50, 50, 50)), Vector3(0, -1, 0));
+		occlusion_cull.scenario_set_instance(scenario, instances[1], quad, floor_transform, true);
+		occlusion_cull.buffer_update(buffer, cam_transform, projection, false);
+
+		CHECK(is_aabb_occluded(hz_buffer, AABB(Vector3(-0.5, -4, -11), Vector3(1, 1, 1)), cam_transform, projection));
+		CHECK_FALSE(is_aabb_occluded(hz_buffer, AABB(Vector3(-0.5, 0, -11), Vector3(1, 1, 1)), cam_transform, projection));
+
+		occlusion_cull.scenario_remove_instance(scenario, instances[1]);
+	}
+
+	occlusion_cull.remove_buffer(buffer);
+	occlusion_cull.remove_scenario(scenario);
+	occlusion_cull.free_occluder(quad);
+}
+
+TEST_CASE("[RendererSceneOcclusionCullRaster] Occluders with an orthogonal camera") {
+	RendererSceneOcclusionCullRaster occlusion_cull;
+	const RID scenario = RID::from_uint64(1);
+	const RID buffer = RID::from_uint64(2);
+	const RID instance = RID::from_uint64(3);
+
+	RID quad = occlusion_cull.occluder_allocate();
+	occlusion_cull.occluder_initialize(quad);
+	occlusion_cull.occluder_set_mesh(quad, { Vector3(-1, -1, 0), Vector3(1, -1, 0), Vector3(1, 1, 0), Vector3(-1, 1, 0) }, { 0, 1, 2, 0, 2, 3 });
+
+	occlusion_cull.add_scenario(scenario);
+	occlusion_cull.add_buffer(buffer);
+	occlusion_cull.buffer_set_scenario(buffer, scenario);
+	occlusion_cull.buffer_set_size(buffer, Vector2i(64, 64));
+
+	Projection projection;
+	projection.set_orthogonal(10.0, 1.0, 0.05, 100.0);
+	const Transform3D cam_transform = Transform3D(Basis(), Vector3(0, 0, 10));
+
+	RendererSceneOcclusionCull::HZBuffer *hz_buffer = occlusion_cull.buffer_get_ptr(buffer);
+	REQUIRE(hz_buffer != nullptr);
+
+	occlusion_cull.scenario_set_instance(scenario, instance, quad, Transform3D(Basis(), Vector3(0, 0, 5)), true);
+	occlusion_cull.buffer_update(buffer, cam_transform, projection, true);
+
+	// Directly behind the quad, no matter how far away.
+	CHECK(is_aabb_occluded(hz_buffer, AABB(Vector3(-0.5, -0.5, 3), Vector3(1, 1, 1)), cam_transform, projection));
+	CHECK(is_aabb_occluded(hz_buffer, AABB(Vector3(-0.5, -0.5, -80), Vector3(1, 1, 1)), cam_transform, projection));
+	// In front of the quad.
+	CHECK_FALSE(is_aabb_occluded(hz_buffer, AABB(Vector3(-0.5, -0.5, 6), Vector3(1, 1, 1)), cam_transform, projection));
+	// Far away and beside the quad. A perspective camera would see this one shrink behind the quad.
+	CHECK_FALSE(is_aabb_occluded(hz_buffer, AABB(Vector3(1.5, -0.5, -80), Vector3(1, 1, 1)), cam_transform, projection));
+
+	occlusion_cull.scenario_remove_instance(scenario, instance);
+	occlusion_cull.remove_buffer(buffer);
+	occlusion_cull.remove_scenario(scenario);
+	occlusion_cull.free_occluder(quad);
+}
+
+} // namespace TestOcclusionCullRaster
+
+#endif // TEST_OCCLUSION_CULL_RASTER_H
@@ -0,0 +1,333 @@
+/**************************************************************************/
+/*  test_renderer_canvas_cull.h                                           */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_RENDERER_CANVAS_CULL_H
+#define TEST_RENDERER_CANVAS_CULL_H
+
+#include "servers/rendering/dummy/rasterizer_canvas_dummy.h"
+#include "servers/rendering/renderer_canvas_cull.h"
+#include "servers/rendering/rendering_server_globals.h"
+#include "servers/rendering_server.h"
+
+#include "tests/test_macros.h"
+
+namespace TestRendererCanvasCull {
+
+// Records the items that reach the canvas renderer, in draw order.
+class CanvasRenderRecorder : public RasterizerCanvasDummy {
+public:
+	LocalVector<Item *> items;
+
+	void canvas_render_items(RID p_to_render_target, Item *p_item_list, const Color &p_modulate, Light *p_light_list, Light *p_directional_list, const Transform2D &p_canvas_transform, RS::CanvasItemTextureFilter p_default_filter, RS::CanvasItemTextureRepeat p_default_repeat, bool p_snap_2d_vertices_to_pixel, bool &r_sdf_used, RenderingMethod::RenderInfo *r_render_info = nullptr) override {
+		r_sdf_used = false;
+		for (Item *item = p_item_list; item; item = item->next) {
+			items.push_back(item);
+		}
+	}
+};
+
+// Replaces the canvas renderer of the rendering server for the lifetime of the object.
+struct ScopedCanvasRenderRecorder {
+	RendererCanvasRender *previous = nullptr;
+	CanvasRenderRecorder *recorder = nullptr;
+
+	ScopedCanvasRenderRecorder() {
+		previous = RSG::canvas_render;
+		RendererCanvasRender::singleton = nullptr;
+		recorder = memnew(CanvasRenderRecorder);
+		RSG::canvas_render = recorder;
+	}
+
+	~ScopedCanvasRenderRecorder() {
+		memdelete(recorder);
+		RendererCanvasRender::singleton = previous;
+		RSG::canvas_render = previous;
+	}
+};
+
+LocalVector<RendererCanvasRender::Item *> cull_canvas(CanvasRenderRecorder *p_recorder, RID p_canvas, const Rect2 &p_clip_rect) {
+	RendererCanvasCull::Canvas *canvas = RSG::canvas->canvas_owner.get_or_null(p_canvas);
+	p_recorder->items.clear();
+	RSG::canvas->render_canvas(RID(), canvas, Transform2D(), nullptr, nullptr, p_clip_rect, RS::CANVAS_ITEM_TEXTURE_FILTER_LINEAR, RS::CANVAS_ITEM_TEXTURE_REPEAT_DISABLED, false, false, 0xFFFFFFFF);
+	return p_recorder->items;
+}
+
+// Culls the canvas with and without the spatial index and checks both draw the same items in the same order.
+// Returns the number of items drawn.
+int check_spatial_index_matches(CanvasRenderRecorder *p_recorder, RID p_canvas, const Rect2 &p_clip_rect) {
+	const bool use_spatial_index = RSG::canvas->use_spatial_index;
+
+	RSG::canvas->use_spatial_index = false;
+	LocalVector<RendererCanvasRender::Item *> reference = cull_canvas(p_recorder, p_canvas, p_clip_rect);
+	RSG::canvas->use_spatial_index = true;
+	LocalVector<RendererCanvasRender::Item *> indexed = cull_canvas(p_recorder, p_canvas, p_clip_rect);
+	RSG::canvas->use_spatial_index = use_spatial_index;
+
+	bool matches = reference.size() == indexed.size();
+	for (uint32_t i = 0; matches && i < reference.size(); i++) {
+		matches = reference[i] == indexed[i];
+	}
+	CHECK_MESSAGE(matches, "Culling with the spatial index should draw the same items in the same order as without it.");
+	return reference.size();
+}
+
+// Records the canvas group of each drawn item, items in a canvas group are drawn into it.
+struct DrawnItem {
+	RendererCanvasRender::Item *item = nullptr;
+	RendererCanvasRender::Item *canvas_group_owner = nullptr;
+
+	bool operator==(const DrawnItem &p_other) const {
+		return item == p_other.item && canvas_group_owner == p_other.canvas_group_owner;
+	}
+};
+
+LocalVector<DrawnItem> cull_canvas_with_groups(CanvasRenderRecorder *p_recorder, RID p_canvas, const Rect2 &p_clip_rect) {
+	LocalVector<DrawnItem> drawn;
+	for (RendererCanvasRender::Item *item : cull_canvas(p_recorder, p_canvas, p_clip_rect)) {
+		drawn.push_back({ item, item->canvas_group_owner });
+	}
+	return drawn;
+}
+
+// Culls the canvas on worker threads and on a single thread, and checks both draw the same items in the same order.
+// Returns the number of items drawn.
+int check_threaded_cull_matches(CanvasRenderRecorder *p_recorder, RID p_canvas, const Rect2 &p_clip_rect) {
+	const bool use_threaded_cull = RSG::canvas->use_threaded_cull;
+
+	RSG::canvas->use_threaded_cull = false;
+	LocalVector<DrawnItem> reference = cull_canvas_with_groups(p_recorder, p_canvas, p_clip_rect);
+	RSG::canvas->use_threaded_cull = true;
+	LocalVector<DrawnItem> threaded = cull_canvas_with_groups(p_recorder, p_canvas, p_clip_rect);
+	RSG::canvas->use_threaded_cull = use_threaded_cull;
+
+	bool matches = reference.size() == threaded.size();
+	for (uint32_t i = 0; matches && i < reference.size(); i++) {
+		matches = reference[i] == threaded[i];
+	}
+	CHECK_MESSAGE(matches, "Culling on worker threads should draw the same items in the same order as on a single thread.");
+	return reference.size();
+}
+
+// Keeps track of the canvas items of a test. Freeing an item doesn't free its children.
+struct CanvasItems {
+	HashSet<RID> items;
+
+	RID create_rect_item(RID p_parent, const Vector2 &p_position) {
+		RenderingServer *rs = RenderingServer::get_singleton();
+		RID item = rs->canvas_item_create();
+		rs->canvas_item_set_parent(item, p_parent);
+		rs->canvas_item_add_rect(item, Rect2(0, 0, 10, 10), Color(1, 1, 1));
+		rs->canvas_item_set_transform(item, Transform2D(0, p_position));
+		items.insert(item);
+		return item;
+	}
+
+	void free_item(RID p_item) {
+		RenderingServer::get_singleton()->free(p_item);
+		items.erase(p_item);
+	}
+
+	void free_all() {
+		for (const RID &item : items) {
+			RenderingServer::get_singleton()->free(item);
+		}
+		items.clear();
+	}
+};
+
+TEST_CASE("[SceneTree][RendererCanvasCull] Spatial index culls the same items as a full traversal") {
+	ScopedCanvasRenderRecorder scoped_recorder;
+	CanvasRenderRecorder *recorder = scoped_recorder.recorder;
+	RenderingServer *rs = RenderingServer::get_singleton();
+	const Rect2 clip_rect(0, 0, 400, 300);
+
+	RID canvas = rs->canvas_create();
+	CanvasItems items;
+
+	// Enough children to be kept in a DynamicBVH, spread over an area larger than the clip rect.
+	RID flat = items.create_rect_item(canvas, Vector2());
+	LocalVector<RID> flat_children;
+	for (int i = 0; i < 100; i++) {
+		RID child = items.create_rect_item(flat, Vector2((i % 10) * 80, (i / 10) * 60));
+		if (i % 7 == 0) {
+			rs->canvas_item_set_z_index(child, 1);
+		}
+		flat_children.push_back(child);
+	}
+	// A grandchild far outside its parent's own rect.
+	RID grandchild = items.create_rect_item(flat_children[0], Vector2(1000, 0));
+
+	RID ysort = items.create_rect_item(canvas, Vector2(0, 350));
+	rs->canvas_item_set_sort_children_by_y(ysort, true);
+	LocalVector<RID> ysort_children;
+	for (int i = 0; i < 10; i++) {
+		RID child = items.create_rect_item(ysort, Vector2(i * 50, 500 - i * 50));
+		items.create_rect_item(child, Vector2(5, -20));
+		ysort_children.push_back(child);
+	}
+
+	RID behind_parent = items.create_rect_item(canvas, Vector2(200, 200));
+	RID behind_child = items.create_rect_item(behind_parent, Vector2(-5, -5));
+	rs->canvas_item_set_draw_behind_parent(behind_child, true);
+	RID behind_hidden_child = items.create_rect_item(behind_parent, Vector2(1000, 1000));
+	rs->canvas_item_set_draw_behind_parent(behind_hidden_child, true);
+
+	int drawn_count = check_spatial_index_matches(recorder, canvas, clip_rect);
+	CHECK(drawn_count > 0);
+	CHECK(drawn_count < 100);
+
+	SUBCASE("Moving children") {
+		for (uint32_t i = 0; i < flat_children.size(); i += 3) {
+			rs->canvas_item_set_transform(flat_children[i], Transform2D(0, Vector2(800 - (i % 10) * 80, (i / 10) * 30)));
+		}
+		rs->canvas_item_set_transform(grandchild, Transform2D(0, Vector2(50, 50)));
+		rs->canvas_item_set_transform(ysort_children[9], Transform2D(0, Vector2(50, 600)));
+		check_spatial_index_matches(recorder, canvas, clip_rect);
+
+		rs->canvas_item_set_transform(flat, Transform2D(0, Vector2(-400, -300)));
+		check_spatial_index_matches(recorder, canvas, clip_rect);
+	}
+
+	SUBCASE("Reparenting") {
+		rs->canvas_item_set_parent(flat_children[5], ysort);
+		rs->canvas_item_set_parent(ysort_children[2], flat);
+		rs->canvas_item_set_parent(grandchild, behind_parent);
+		check_spatial_index_matches(recorder, canvas, clip_rect);
+	}
+
+	SUBCASE("Freeing") {
+		for (uint32_t i = 0; i < flat_children.size(); i += 2) {
+			items.free_item(flat_children[i]);
+		}
+		items.free_item(ysort_children[0]);
+		check_spatial_index_matches(recorder, canvas, clip_rect);
+	}
+
+	SUBCASE("Changing draw order") {
+		rs->canvas_item_set_draw_behind_parent(behind_hidden_child, false);
+		rs->canvas_item_set_transform(behind_hidden_child, Transform2D(0, Vector2(0, 0)));
+		rs->canvas_item_set_z_index(flat_children[1], -1);
+		rs->canvas_item_set_sort_children_by_y(ysort, false);
+		check_spatial_index_matches(recorder, canvas, clip_rect);
+	}
+
+	SUBCASE("Freeing a parent with many children") {
+		items.free_item(flat);
+		check_spatial_index_matches(recorder, canvas, clip_rect);
+	}
+
+	items.free_all();
+	rs->free(canvas);
+}
+
+TEST_CASE("[SceneTree][RendererCanvasCull] Threaded culling draws the same items as a single thread") {
+	ScopedCanvasRenderRecorder scoped_recorder;
+	CanvasRenderRecorder *recorder = scoped_recorder.recorder;
+	RenderingServer *rs = RenderingServer::get_singleton();
+	const Rect2 clip_rect(0, 0, 400, 300);
+
+	RID canvas = rs->canvas_create();
+	CanvasItems items;
+
+	// Many top-level items, so every worker thread gets a range of them, with z indices interleaving the ranges.
+	LocalVector<RID> top_level;
+	for (int i = 0; i < 64; i++) {
+		RID item = items.create_rect_item(canvas, Vector2((i % 8) * 60, (i / 8) * 45));
+		rs->canvas_item_set_z_index(item, (i * 7) % 5 - 2);
+		for (int j = 0; j < 3; j++) {
+			RID child = items.create_rect_item(item, Vector2(j * 5, j * 5));
+			if (j == 1) {
+				rs->canvas_item_set_z_index(child, 1);
+			} else if (j == 2) {
+				rs->canvas_item_set_z_as_relative_to_parent(child, false);
+			}
+		}
+		top_level.push_back(item);
+	}
+
+	// Canvas groups draw their children into their own buffer.
+	RID group = items.create_rect_item(canvas, Vector2(100, 100));
+	rs->canvas_item_set_canvas_group_mode(group, RS::CANVAS_GROUP_MODE_CLIP_AND_DRAW);
+	for (int i = 0; i < 10; i++) {
+		RID child = items.create_rect_item(group, Vector2(i * 10, 0));
+		items.create_rect_item(child, Vector2(0, 10));
+	}
+	RID nested_group = items.create_rect_item(group, Vector2(0, 50));
+	rs->canvas_item_set_canvas_group_mode(nested_group, RS::CANVAS_GROUP_MODE_TRANSPARENT);
+	items.create_rect_item(nested_group, Vector2(10, 10));
+
+	// Y-sorted children, with their own children sorted along.
+	RID ysort = items.create_rect_item(canvas, Vector2(0, 150));
+	rs->canvas_item_set_sort_children_by_y(ysort, true);
+	LocalVector<RID> ysort_children;
+	for (int i = 0; i < 20; i++) {
+		RID child = items.create_rect_item(ysort, Vector2(i * 20, 100 - (i % 5) * 20));
+		RID grandchild = items.create_rect_item(child, Vector2(5, -20));
+		rs->canvas_item_set_sort_children_by_y(child, true);
+		if (i % 4 == 0) {
+			rs->canvas_item_set_z_index(grandchild, 2);
+		}
+		ysort_children.push_back(child);
+	}
+
+	int drawn_count = check_threaded_cull_matches(recorder, canvas, clip_rect);
+	CHECK(drawn_count > 0);
+
+	SUBCASE("Moving items") {
+		for (uint32_t i = 0; i < top_level.size(); i += 3) {
+			rs->canvas_item_set_transform(top_level[i], Transform2D(0, Vector2(400 - (i % 8) * 60, (i / 8) * 20)));
+		}
+		rs->canvas_item_set_transform(ysort_children[3], Transform2D(0, Vector2(60, 200)));
+		rs->canvas_item_set_transform(group, Transform2D(0, Vector2(250, 20)));
+		check_threaded_cull_matches(recorder, canvas, clip_rect);
+	}
+
+	SUBCASE("Changing draw order") {
+		rs->canvas_item_set_draw_index(top_level[10], -1);
+		rs->canvas_item_set_z_index(top_level[20], 3);
+		rs->canvas_item_set_z_index(group, -1);
+		rs->canvas_item_set_sort_children_by_y(ysort, false);
+		check_threaded_cull_matches(recorder, canvas, clip_rect);
+	}
+
+	SUBCASE("Fewer top-level items than threads") {
+		for (uint32_t i = 1; i < top_level.size(); i++) {
+			items.free_item(top_level[i]);
+		}
+		check_threaded_cull_matches(recorder, canvas, clip_rect);
+	}
+
+	items.free_all();
+	rs->free(canvas);
+}
+
+} // namespace TestRendererCanvasCull
+
+#endif // TEST_RENDERER_CANVAS_CULL_H
@@ -0,0 +1,142 @@
+/**************************************************************************/
+/*  test_renderer_scene_cull.h                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_RENDERER_SCENE_CULL_H
+#define TEST_RENDERER_SCENE_CULL_H
+
+#include "servers/rendering_server.h"
+
+#include "tests/test_macros.h"
+
+namespace TestRendererSceneCull {
+
+void set_buffer_origin(Vector<float> &r_buffer, int p_index, const Vector3 &p_origin) {
+	float *transform = &r_buffer.write[p_index * 12];
+	transform[0] = 1;
+	transform[1] = 0;
+	transform[2] = 0;
+	transform[3] = p_origin.x;
+	transform[4] = 0;
+	transform[5] = 1;
+	transform[6] = 0;
+	transform[7] = p_origin.y;
+	transform[8] = 0;
+	transform[9] = 0;
+	transform[10] = 1;
+	transform[11] = p_origin.z;
+}
+
+#ifndef _3D_DISABLED
+TEST_CASE("[SceneTree][RendererSceneCull] Moving instances in bulk updates culling") {
+	// More than RendererSceneCull::thread_cull_threshold, so that the AABBs are transformed on worker threads.
+	constexpr int INSTANCE_COUNT = 500;
+
+	RenderingServer *rs = RenderingServer::get_singleton();
+	RID scenario = rs->scenario_create();
+	RID mesh = rs->mesh_create();
+
+	Vector<RID> instances;
+	Vector<float> buffer;
+	buffer.resize(INSTANCE_COUNT * 12);
+	for (int i = 0; i < INSTANCE_COUNT; i++) {
+		RID instance = rs->instance_create2(mesh, scenario);
+		// The dummy mesh storage doesn't keep vertex data, so give the instances bounds explicitly.
+		rs->instance_set_custom_aabb(instance, AABB(Vector3(-0.5, -0.5, -0.5), Vector3(1, 1, 1)));
+		rs->instance_attach_object_instance_id(instance, ObjectID(uint64_t(i + 1)));
+		instances.push_back(instance);
+		set_buffer_origin(buffer, i, Vector3(i * 2, 0, 0));
+	}
+	rs->instance_set_transforms(instances, buffer);
+
+	const AABB ground_area(Vector3(-1, -1, -1), Vector3(INSTANCE_COUNT * 2 + 2, 2, 2));
+	const AABB raised_area(Vector3(-1, 99, -1), Vector3(INSTANCE_COUNT * 2 + 2, 2, 2));
+	REQUIRE(rs->instances_cull_aabb(ground_area, scenario).size() == INSTANCE_COUNT);
+	REQUIRE(rs->instances_cull_aabb(raised_area, scenario).is_empty());
+
+	SUBCASE("Moving every instance") {
+		for (int i = 0; i < INSTANCE_COUNT; i++) {
+			set_buffer_origin(buffer, i, Vector3(i * 2, 100, 0));
+		}
+		rs->instance_set_transforms(instances, buffer);
+
+		CHECK(rs->instances_cull_aabb(ground_area, scenario).is_empty());
+		CHECK(rs->instances_cull_aabb(raised_area, scenario).size() == INSTANCE_COUNT);
+		CHECK(rs->instances_cull_aabb(AABB(Vector3(9.5, 99.5, -0.5), Vector3(1, 1, 1)), scenario) == Vector<ObjectID>{ ObjectID(uint64_t(6)) });
+	}
+
+	SUBCASE("Moving some of the instances") {
+		Vector<RID> odd_instances;
+		Vector<float> odd_buffer;
+		odd_buffer.resize(INSTANCE_COUNT / 2 * 12);
+		for (int i = 1; i < INSTANCE_COUNT; i += 2) {
+			set_buffer_origin(odd_buffer, odd_instances.size(), Vector3(i * 2, 100, 0));
+			odd_instances.push_back(instances[i]);
+		}
+		rs->instance_set_transforms(odd_instances, odd_buffer);
+
+		Vector<ObjectID> ground = rs->instances_cull_aabb(ground_area, scenario);
+		Vector<ObjectID> raised = rs->instances_cull_aabb(raised_area, scenario);
+		CHECK(ground.size() == INSTANCE_COUNT / 2);
+		CHECK(raised.size() == INSTANCE_COUNT / 2);
+		for (const ObjectID &id : ground) {
+			CHECK_MESSAGE((uint64_t(id) - 1) % 2 == 0, "Only the even instances should stay on the ground.");
+		}
+		for (const ObjectID &id : raised) {
+			CHECK_MESSAGE((uint64_t(id) - 1) % 2 == 1, "Only the odd instances should be raised.");
+		}
+	}
+
+	SUBCASE("Repeated instances use the last transform") {
+		Vector<RID> repeated_instances = instances;
+		repeated_instances.append_array(instances);
+		Vector<float> repeated_buffer;
+		repeated_buffer.resize(INSTANCE_COUNT * 2 * 12);
+		for (int i = 0; i < INSTANCE_COUNT; i++) {
+			set_buffer_origin(repeated_buffer, i, Vector3(i * 2, 50, 0));
+			set_buffer_origin(repeated_buffer, INSTANCE_COUNT + i, Vector3(i * 2, 100, 0));
+		}
+		rs->instance_set_transforms(repeated_instances, repeated_buffer);
+
+		CHECK(rs->instances_cull_aabb(ground_area, scenario).is_empty());
+		CHECK(rs->instances_cull_aabb(AABB(Vector3(-1, 49, -1), Vector3(INSTANCE_COUNT * 2 + 2, 2, 2)), scenario).is_empty());
+		CHECK(rs->instances_cull_aabb(raised_area, scenario).size() == INSTANCE_COUNT);
+	}
+
+	for (const RID &instance : instances) {
+		rs->free(instance);
+	}
+	rs->free(mesh);
+	rs->free(scenario);
+}
+#endif // _3D_DISABLED
+
+} // namespace TestRendererSceneCull
+
+#endif // TEST_RENDERER_SCENE_CULL_H
@@ -0,0 +1,434 @@
+/**************************************************************************/
+/*  test_rendering_benchmark.h                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_RENDERING_BENCHMARK_H
+#define TEST_RENDERING_BENCHMARK_H
+
+#include "core/math/random_pcg.h"
+#include "servers/rendering/renderer_canvas_cull.h"
+#include "servers/rendering/renderer_viewport.h"
+#include "servers/rendering/rendering_light_culler.h"
+#include "servers/rendering/rendering_server_globals.h"
+#include "servers/rendering/storage/render_scene_buffers.h"
+#include "servers/rendering_server.h"
+
+#include "tests/servers/rendering/rasterizer_benchmark.h"
+#include "tests/test_macros.h"
+
+// These benchmarks drive the CPU side of the rendering server with RasterizerBenchmark,
+// which only counts what it is asked to draw. They are skipped by default, run them with:
+//   godot --test --test-case="*[Benchmark]*" --no-skip
+
+namespace TestRenderingBenchmark {
+
+constexpr int FRAME_COUNT = 10;
+
+void print_stage_time(const String &p_stage, uint64_t p_usec) {
+	print_line(vformat("[Benchmark] %s: %.3f ms per frame", p_stage, p_usec / 1000.0 / FRAME_COUNT));
+}
+
+void free_rids(const Vector<RID> &p_rids) {
+	for (const RID &rid : p_rids) {
+		RenderingServer::get_singleton()->free(rid);
+	}
+}
+
+#ifndef _3D_DISABLED
+constexpr real_t SPACING = 2.0;
+
+// Lays the instances out on a grid in front of the camera, so that only part of them is visible.
+// Returns the side of the grid.
+int create_instance_grid(RID p_scenario, RID p_mesh, int p_count, Vector<RID> &r_instances, Vector<float> &r_transforms) {
+	RenderingServer *rs = RenderingServer::get_singleton();
+	const int side = Math::ceil(Math::sqrt((double)p_count));
+
+	r_instances.resize(p_count);
+	r_transforms.resize(p_count * 12);
+	r_transforms.fill(0);
+	for (int i = 0; i < p_count; i++) {
+		RID instance = rs->instance_create2(p_mesh, p_scenario);
+		// The dummy mesh storage doesn't keep vertex data, so give the instances bounds explicitly.
+		rs->instance_set_custom_aabb(instance, AABB(Vector3(-0.5, -0.5, -0.5), Vector3(1, 1, 1)));
+		r_instances.write[i] = instance;
+
+		float *transform = &r_transforms.write[i * 12];
+		transform[0] = 1;
+		transform[3] = (i % side - side / 2) * SPACING;
+		transform[5] = 1;
+		transform[10] = 1;
+		transform[11] = -(i / side) * SPACING;
+	}
+	rs->instance_set_transforms(r_instances, r_transforms);
+
+	return side;
+}
+
+// Scatters omni and spot lights over the grid and adds a directional light, so that light pairing is part of the frame.
+void create_lights(RID p_scenario, int p_side, Vector<RID> &r_lights, Vector<RID> &r_light_instances) {
+	constexpr int LIGHTS_PER_SIDE = 16;
+	RenderingServer *rs = RenderingServer::get_singleton();
+	const real_t light_spacing = p_side * SPACING / LIGHTS_PER_SIDE;
+
+	for (int i = 0; i < LIGHTS_PER_SIDE * LIGHTS_PER_SIDE; i++) {
+		RID light = (i % 2) ? rs->spot_light_create() : rs->omni_light_create();
+		rs->light_set_param(light, RS::LIGHT_PARAM_RANGE, light_spacing);
+		rs->light_set_shadow(light, true);
+		r_lights.push_back(light);
+
+		RID light_instance = rs->instance_create2(light, p_scenario);
+		// Point the spot lights down at the grid.
+		Transform3D transform(Basis(Vector3(1, 0, 0), -Math_PI / 2), Vector3((i % LIGHTS_PER_SIDE - LIGHTS_PER_SIDE / 2) * light_spacing, 4, -(i / LIGHTS_PER_SIDE) * light_spacing));
+		rs->instance_set_transform(light_instance, transform);
+		r_light_instances.push_back(light_instance);
+	}
+
+	RID sun = rs->directional_light_create();
+	rs->light_set_shadow(sun, true);
+	r_lights.push_back(sun);
+
+	RID sun_instance = rs->instance_create2(sun, p_scenario);
+	rs->instance_set_transform(sun_instance, Transform3D(Basis(Vector3(1, 0, 0), -Math_PI / 4), Vector3()));
+	r_light_instances.push_back(sun_instance);
+}
+
+TEST_CASE("[RenderingServer][Benchmark] RendererSceneCull with many moving instances" * doctest::skip()) {
+	ScopedBenchmarkRenderingServer benchmark_server;
+
+	constexpr int INSTANCE_COUNT = 100000;
+
+	RenderingServer *rs = RenderingServer::get_singleton();
+	RID scenario = rs->scenario_create();
+	RID mesh = rs->mesh_create();
+
+	Vector<RID> instances;
+	Vector<float> transforms;
+	const int side = create_instance_grid(scenario, mesh, INSTANCE_COUNT, instances, transforms);
+
+	Vector<RID> lights;
+	Vector<RID> light_instances;
+	create_lights(scenario, side, lights, light_instances);
+
+	RID camera = rs->camera_create();
+	rs->camera_set_perspective(camera, 75.0, 0.05, 200.0);
+	rs->camera_set_transform(camera, Transform3D(Basis(), Vector3(0, 10, 0)));
+
+	Ref<RenderSceneBuffers> render_buffers = RSG::scene->render_buffers_create();
+	Ref<XRInterface> xr_interface;
+
+	// Insert everything into the BVH before measuring.
+	RSG::scene->update();
+
+	uint64_t update_usec = 0;
+	uint64_t cull_usec = 0;
+	int visible_count = 0;
+	for (int frame = 0; frame < FRAME_COUNT; frame++) {
+		for (int i = 0; i < INSTANCE_COUNT; i++) {
+			transforms.write[i * 12 + 7] = Math::sin(frame + i * 0.01);
+		}
+
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		rs->instance_set_transforms(instances, transforms);
+		RSG::scene->update();
+		uint64_t updated = OS::get_singleton()->get_ticks_usec();
+
+		RenderingMethod::RenderInfo render_info;
+		RSG::scene->render_camera(render_buffers, camera, scenario, RID(), Size2(1920, 1080), 0, 1.0, RID(), xr_interface, &render_info);
+		uint64_t culled = OS::get_singleton()->get_ticks_usec();
+
+		update_usec += updated - begin;
+		cull_usec += culled - updated;
+		visible_count = render_info.info[RS::VIEWPORT_RENDER_INFO_TYPE_VISIBLE][RS::VIEWPORT_RENDER_INFO_OBJECTS_IN_FRAME];
+	}
+
+	print_stage_time(vformat("Update %d instances and %d lights", INSTANCE_COUNT, lights.size()), update_usec);
+	print_stage_time(vformat("Cull %d instances (%d visible)", INSTANCE_COUNT, visible_count), cull_usec);
+
+	CHECK_MESSAGE(visible_count > 0, "Instances in front of the camera should be visible.");
+	CHECK_MESSAGE(visible_count < INSTANCE_COUNT, "Instances beyond the far plane should be culled.");
+
+	free_rids(instances);
+	free_rids(light_instances);
+	free_rids(lights);
+	rs->free(camera);
+	rs->free(mesh);
+	rs->free(scenario);
+}
+
+TEST_CASE("[RenderingServer][Benchmark] RendererViewport drawing a lit 3D scene with a 2D overlay" * doctest::skip()) {
+	ScopedBenchmarkRenderingServer benchmark_server;
+
+	constexpr int INSTANCE_COUNT = 20000;
+	constexpr int ITEM_COUNT = 10000;
+	const Size2i viewport_size(1920, 1080);
+
+	RenderingServer *rs = RenderingServer::get_singleton();
+	RID scenario = rs->scenario_create();
+	RID mesh = rs->mesh_create();
+
+	Vector<RID> instances;
+	Vector<float> transforms;
+	const int side = create_instance_grid(scenario, mesh, INSTANCE_COUNT, instances, transforms);
+
+	Vector<RID> lights;
+	Vector<RID> light_instances;
+	create_lights(scenario, side, lights, light_instances);
+
+	RID camera = rs->camera_create();
+	rs->camera_set_perspective(camera, 75.0, 0.05, 200.0);
+	rs->camera_set_transform(camera, Transform3D(Basis(), Vector3(0, 10, 0)));
+
+	// A HUD that is four screens wide, so part of it is culled.
+	RID canvas = rs->canvas_create();
+	Vector<RID> items;
+	for (int i = 0; i < ITEM_COUNT; i++) {
+		RID item = rs->canvas_item_create();
+		rs->canvas_item_set_parent(item, canvas);
+		rs->canvas_item_add_rect(item, Rect2(0, 0, 16, 16), Color(1, 1, 1));
+		rs->canvas_item_set_transform(item, Transform2D(0, Vector2((i % 200) * 40, (i / 200) * 20)));
+		items.push_back(item);
+	}
+
+	RID viewport = rs->viewport_create();
+	rs->viewport_set_size(viewport, viewport_size.x, viewport_size.y);
+	rs->viewport_set_update_mode(viewport, RS::VIEWPORT_UPDATE_ALWAYS);
+	rs->viewport_attach_camera(viewport, camera);
+	rs->viewport_set_scenario(viewport, scenario);
+	rs->viewport_attach_canvas(viewport, canvas);
+	rs->viewport_set_active(viewport, true);
+
+	RSG::scene->update();
+
+	uint64_t update_usec = 0;
+	uint64_t draw_usec = 0;
+	for (int frame = 0; frame < FRAME_COUNT; frame++) {
+		for (int i = 0; i < INSTANCE_COUNT; i++) {
+			transforms.write[i * 12 + 7] = Math::sin(frame + i * 0.01);
+		}
+
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		rs->instance_set_transforms(instances, transforms);
+		RSG::scene->update();
+		uint64_t updated = OS::get_singleton()->get_ticks_usec();
+
+		RSG::viewport->draw_viewports(false);
+		uint64_t drawn = OS::get_singleton()->get_ticks_usec();
+
+		update_usec += updated - begin;
+		draw_usec += drawn - updated;
+	}
+
+	const int visible_count = rs->viewport_get_render_info(viewport, RS::VIEWPORT_RENDER_INFO_TYPE_VISIBLE, RS::VIEWPORT_RENDER_INFO_OBJECTS_IN_FRAME);
+	const int canvas_count = rs->viewport_get_render_info(viewport, RS::VIEWPORT_RENDER_INFO_TYPE_CANVAS, RS::VIEWPORT_RENDER_INFO_OBJECTS_IN_FRAME);
+
+	print_stage_time(vformat("Update %d instances and %d lights", INSTANCE_COUNT, lights.size()), update_usec);
+	print_stage_time(vformat("Draw viewport (%d of %d instances, %d of %d canvas items)", visible_count, INSTANCE_COUNT, canvas_count, ITEM_COUNT), draw_usec);
+
+	CHECK_MESSAGE(visible_count > 0, "The viewport should draw the instances in front of its camera.");
+	CHECK_MESSAGE(visible_count < INSTANCE_COUNT, "The viewport should cull instances beyond the far plane.");
+	CHECK_MESSAGE(canvas_count > 0, "The viewport should draw the canvas items on screen.");
+	CHECK_MESSAGE(canvas_count < ITEM_COUNT, "The viewport should cull canvas items off screen.");
+
+	rs->free(viewport);
+	free_rids(items);
+	rs->free(canvas);
+	free_rids(instances);
+	free_rids(light_instances);
+	free_rids(lights);
+	rs->free(camera);
+	rs->free(mesh);
+	rs->free(scenario);
+}
+
+TEST_CASE("[RenderingServer][Benchmark] RenderingLightCuller with many shadow casters" * doctest::skip()) {
+	ScopedBenchmarkRenderingServer benchmark_server;
+
+	constexpr int CASTER_COUNT = 20000;
+	constexpr int LIGHT_COUNT = 64;
+	constexpr float EXTENT = 200.0f;
+
+	RenderingServer *rs = RenderingServer::get_singleton();
+	RandomPCG rng(0);
+
+	// Drive the culler directly with synthetic instances, as RendererSceneCull does when it collects shadow casters.
+	Vector<RendererSceneCull::Instance *> casters;
+	for (int i = 0; i < CASTER_COUNT; i++) {
+		RendererSceneCull::Instance *caster = memnew(RendererSceneCull::Instance);
+		caster->transformed_aabb = AABB(Vector3(rng.random(-EXTENT, EXTENT), rng.random(0.0f, 4.0f), rng.random(-EXTENT, 0.0f)), Vector3(1, 1, 1));
+		casters.push_back(caster);
+	}
+
+	Vector<RID> lights;
+	Vector<RendererSceneCull::Instance *> light_instances;
+	for (int i = 0; i < LIGHT_COUNT; i++) {
+		RID light = (i % 2) ? rs->spot_light_create() : rs->omni_light_create();
+		rs->light_set_param(light, RS::LIGHT_PARAM_RANGE, 20.0);
+		lights.push_back(light);
+
+		RendererSceneCull::Instance *light_instance = memnew(RendererSceneCull::Instance);
+		light_instance->base_type = RS::INSTANCE_LIGHT;
+		light_instance->base = light;
+		light_instance->transform = Transform3D(Basis(Vector3(1, 0, 0), -Math_PI / 4), Vector3(rng.random(-EXTENT, EXTENT), 8, rng.random(-EXTENT, 0.0f)));
+		light_instances.push_back(light_instance);
+	}
+
+	RID sun = rs->directional_light_create();
+	lights.push_back(sun);
+	RendererSceneCull::Instance *sun_instance = memnew(RendererSceneCull::Instance);
+	sun_instance->base_type = RS::INSTANCE_LIGHT;
+	sun_instance->base = sun;
+	sun_instance->transform = Transform3D(Basis(Vector3(1, 0, 0), -Math_PI / 4), Vector3());
+
+	Projection projection;
+	projection.set_perspective(75.0, 16.0 / 9.0, 0.05, 200.0);
+	const Transform3D camera_transform(Basis(), Vector3(0, 10, 0));
+
+	RenderingLightCuller light_culler;
+	PagedArrayPool<RendererSceneCull::Instance *> pool;
+	PagedArray<RendererSceneCull::Instance *> shadow_casters;
+	shadow_casters.set_page_pool(&pool);
+
+	uint64_t regular_usec = 0;
+	uint64_t directional_usec = 0;
+	int regular_kept = 0;
+	int directional_kept = 0;
+	for (int frame = 0; frame < FRAME_COUNT; frame++) {
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		light_culler.prepare_camera(camera_transform, projection);
+
+		regular_kept = 0;
+		for (RendererSceneCull::Instance *light_instance : light_instances) {
+			if (!light_culler.prepare_regular_light(*light_instance)) {
+				continue;
+			}
+			shadow_casters.clear();
+			for (RendererSceneCull::Instance *caster : casters) {
+				shadow_casters.push_back(caster);
+			}
+			light_culler.cull_regular_light(shadow_casters);
+			regular_kept += shadow_casters.size();
+		}
+		uint64_t regular = OS::get_singleton()->get_ticks_usec();
+
+		light_culler.prepare_directional_light(sun_instance, 0);
+		directional_kept = 0;
+		for (const RendererSceneCull::Instance *caster : casters) {
+			if (light_culler.cull_directional_light(RendererSceneCull::InstanceBounds(caster->transformed_aabb), 0)) {
+				directional_kept++;
+			}
+		}
+		uint64_t directional = OS::get_singleton()->get_ticks_usec();
+
+		regular_usec += regular - begin;
+		directional_usec += directional - regular;
+	}
+
+	print_stage_time(vformat("Cull %d casters for %d lights (%d kept)", CASTER_COUNT, LIGHT_COUNT, regular_kept), regular_usec);
+	print_stage_time(vformat("Cull %d casters for a directional light (%d kept)", CASTER_COUNT, directional_kept), directional_usec);
+
+	CHECK_MESSAGE(regular_kept < CASTER_COUNT * LIGHT_COUNT, "Casters that can't shadow the view should be culled for regular lights.");
+	CHECK_MESSAGE(directional_kept > 0, "Casters inside the view should be kept for the directional light.");
+	CHECK_MESSAGE(directional_kept < CASTER_COUNT, "Casters that can't shadow the view should be culled for the directional light.");
+
+	shadow_casters.reset();
+	pool.reset();
+	memdelete(sun_instance);
+	for (RendererSceneCull::Instance *light_instance : light_instances) {
+		memdelete(light_instance);
+	}
+	for (RendererSceneCull::Instance *caster : casters) {
+		memdelete(caster);
+	}
+	free_rids(lights);
+}
+#endif // _3D_DISABLED
+
+TEST_CASE("[RenderingServer][Benchmark] RendererCanvasCull with many canvas items" * doctest::skip()) {
+	ScopedBenchmarkRenderingServer benchmark_server;
+
+	constexpr int GROUP_COUNT = 64;
+	constexpr int ITEMS_PER_GROUP = 800;
+	const Rect2 viewport_rect(0, 0, 1920, 1080);
+
+	RenderingServer *rs = RenderingServer::get_singleton();
+	RID canvas = rs->canvas_create();
+
+	// Spread the items over an area much larger than the viewport, like a big scrolling UI or level.
+	Vector<RID> groups;
+	Vector<RID> items;
+	for (int i = 0; i < GROUP_COUNT; i++) {
+		RID group = rs->canvas_item_create();
+		rs->canvas_item_set_parent(group, canvas);
+		groups.push_back(group);
+
+		for (int j = 0; j < ITEMS_PER_GROUP; j++) {
+			RID item = rs->canvas_item_create();
+			rs->canvas_item_set_parent(item, group);
+			rs->canvas_item_add_rect(item, Rect2(0, 0, 16, 16), Color(1, 1, 1));
+			rs->canvas_item_set_transform(item, Transform2D(0, Vector2((i % 8) * viewport_rect.size.x + (j % 40) * 48, (i / 8) * viewport_rect.size.y + (j / 40) * 48)));
+			items.push_back(item);
+		}
+	}
+
+	RendererCanvasCull::Canvas *canvas_ptr = RSG::canvas->canvas_owner.get_or_null(canvas);
+	REQUIRE(canvas_ptr);
+
+	uint64_t update_usec = 0;
+	uint64_t cull_usec = 0;
+	int visible_count = 0;
+	for (int frame = 0; frame < FRAME_COUNT; frame++) {
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < GROUP_COUNT; i++) {
+			rs->canvas_item_set_transform(groups[i], Transform2D(0, Vector2(-frame * 16, 0)));
+		}
+		uint64_t updated = OS::get_singleton()->get_ticks_usec();
+
+		RenderingMethod::RenderInfo render_info;
+		RSG::canvas->render_canvas(RID(), canvas_ptr, Transform2D(), nullptr, nullptr, viewport_rect, RS::CANVAS_ITEM_TEXTURE_FILTER_LINEAR, RS::CANVAS_ITEM_TEXTURE_REPEAT_DISABLED, false, false, 0xFFFFFFFF, &render_info);
+		uint64_t culled = OS::get_singleton()->get_ticks_usec();
+
+		update_usec += updated - begin;
+		cull_usec += culled - updated;
+		visible_count = render_info.info[RS::VIEWPORT_RENDER_INFO_TYPE_CANVAS][RS::VIEWPORT_RENDER_INFO_OBJECTS_IN_FRAME];
+	}
+
+	print_stage_time(vformat("Move %d canvas item groups", GROUP_COUNT), update_usec);
+	print_stage_time(vformat("Cull %d canvas items (%d visible)", GROUP_COUNT * ITEMS_PER_GROUP, visible_count), cull_usec);
+
+	CHECK_MESSAGE(visible_count > 0, "Items inside the viewport should be drawn.");
+	CHECK_MESSAGE(visible_count < GROUP_COUNT * ITEMS_PER_GROUP, "Items outside the viewport should be culled.");
+
+	free_rids(items);
+	free_rids(groups);
+	rs->free(canvas);
+}
+
+} // namespace TestRenderingBenchmark
+
+#endif // TEST_RENDERING_BENCHMARK_H
@@ -0,0 +1,294 @@
+/**************************************************************************/
+/*  test_godot_area_pair_3d.h                                             */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_GODOT_AREA_PAIR_3D_H
+#define TEST_GODOT_AREA_PAIR_3D_H
+
+#include "servers/physics_server_3d.h"
+
+#include "tests/test_macros.h"
+
+namespace TestGodotAreaPair3D {
+
+constexpr real_t STEP_TIME = 1.0 / 60.0;
+
+// The body sphere's bounds overlap the unit area sphere here, but the shapes don't touch, so the pair stays alive.
+const Vector3 NEAR_POSITION = Vector3(0.95, 0.95, 0);
+const Vector3 INSIDE_POSITION = Vector3(0.3, 0, 0);
+const Vector3 FAR_POSITION = Vector3(10, 0, 0);
+
+class AreaMonitor : public Object {
+	GDCLASS(AreaMonitor, Object);
+
+public:
+	void body_monitor(int p_status, const RID &p_body, ObjectID p_instance, int p_body_shape, int p_area_shape) {
+		if (p_status == PhysicsServer3D::AREA_BODY_ADDED) {
+			body_entered++;
+		} else {
+			body_exited++;
+		}
+	}
+
+	void area_monitor(int p_status, const RID &p_area, ObjectID p_instance, int p_area_shape, int p_self_shape) {
+		if (p_status == PhysicsServer3D::AREA_BODY_ADDED) {
+			area_entered++;
+		} else {
+			area_exited++;
+		}
+	}
+
+	void reset() {
+		body_entered = 0;
+		body_exited = 0;
+		area_entered = 0;
+		area_exited = 0;
+	}
+
+	int body_entered = 0;
+	int body_exited = 0;
+	int area_entered = 0;
+	int area_exited = 0;
+};
+
+struct AreaScene {
+	RID space;
+	RID area_shape;
+	RID body_shape;
+	RID area;
+	AreaMonitor *monitor = nullptr;
+
+	void step() {
+		PhysicsServer3D *physics_server = PhysicsServer3D::get_singleton();
+		monitor->reset();
+		physics_server->step(STEP_TIME);
+		physics_server->flush_queries();
+	}
+
+	RID create_body(PhysicsServer3D::BodyMode p_mode, const Vector3 &p_position) {
+		PhysicsServer3D *physics_server = PhysicsServer3D::get_singleton();
+		RID body = physics_server->body_create();
+		physics_server->body_set_mode(body, p_mode);
+		physics_server->body_add_shape(body, body_shape);
+		physics_server->body_set_param(body, PhysicsServer3D::BODY_PARAM_GRAVITY_SCALE, 0.0);
+		physics_server->body_set_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), p_position));
+		physics_server->body_set_space(body, space);
+		return body;
+	}
+
+	RID create_area(const Vector3 &p_position, bool p_monitorable) {
+		PhysicsServer3D *physics_server = PhysicsServer3D::get_singleton();
+		RID other_area = physics_server->area_create();
+		physics_server->area_add_shape(other_area, body_shape);
+		physics_server->area_set_transform(other_area, Transform3D(Basis(), p_position));
+		physics_server->area_set_monitorable(other_area, p_monitorable);
+		physics_server->area_set_space(other_area, space);
+		return other_area;
+	}
+
+	// A unit sphere area at the origin, monitorable areas are also paired with static bodies.
+	AreaScene(bool p_monitorable) {
+		PhysicsServer3D *physics_server = PhysicsServer3D::get_singleton();
+		space = physics_server->space_create();
+		physics_server->space_set_active(space, true);
+
+		area_shape = physics_server->sphere_shape_create();
+		physics_server->shape_set_data(area_shape, 1.0);
+		body_shape = physics_server->sphere_shape_create();
+		physics_server->shape_set_data(body_shape, 0.2);
+
+		monitor = memnew(AreaMonitor);
+		area = physics_server->area_create();
+		physics_server->area_add_shape(area, area_shape);
+		physics_server->area_set_monitorable(area, p_monitorable);
+		physics_server->area_set_space(area, space);
+		physics_server->area_set_monitor_callback(area, callable_mp(monitor, &AreaMonitor::body_monitor));
+		physics_server->area_set_area_monitor_callback(area, callable_mp(monitor, &AreaMonitor::area_monitor));
+	}
+
+	~AreaScene() {
+		PhysicsServer3D *physics_server = PhysicsServer3D::get_singleton();
+		physics_server->free(space);
+		physics_server->free(area);
+		physics_server->free(area_shape);
+		physics_server->free(body_shape);
+		memdelete(monitor);
+	}
+};
+
+TEST_CASE("[SceneTree][Physics] Area monitors report bodies entering and leaving") {
+	PhysicsServer3D *physics_server = PhysicsServer3D::get_singleton();
+
+	SUBCASE("Moving rigid body") {
+		AreaScene scene(false);
+		RID body = scene.create_body(PhysicsServer3D::BODY_MODE_RIGID, FAR_POSITION);
+		scene.step();
+		CHECK(scene.monitor->body_entered == 0);
+
+		// Slides from the far side through the area and out again.
+		physics_server->body_set_state(body, PhysicsServer3D::BODY_STATE_LINEAR_VELOCITY, Vector3(-120, 0, 0));
+		int entered = 0;
+		int exited = 0;
+		for (int i = 0; i < 12; i++) {
+			scene.step();
+			entered += scene.monitor->body_entered;
+			exited += scene.monitor->body_exited;
+		}
+		CHECK_MESSAGE(entered == 1, vformat("The body entered the area %d times.", entered));
+		CHECK_MESSAGE(exited == 1, vformat("The body left the area %d times.", exited));
+
+		physics_server->free(body);
+	}
+
+	SUBCASE("Sleeping body teleported into the area") {
+		AreaScene scene(false);
+		RID body = scene.create_body(PhysicsServer3D::BODY_MODE_RIGID, NEAR_POSITION);
+		physics_server->body_set_state(body, PhysicsServer3D::BODY_STATE_SLEEPING, true);
+		scene.step();
+		CHECK(scene.monitor->body_entered == 0);
+
+		// The body is put back to sleep before the step, so only its new transform can tell the pair to test again.
+		physics_server->body_set_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), INSIDE_POSITION));
+		physics_server->body_set_state(body, PhysicsServer3D::BODY_STATE_SLEEPING, true);
+		scene.step();
+		CHECK_MESSAGE(scene.monitor->body_entered == 1, "A sleeping body moved into the area should be reported.");
+
+		physics_server->body_set_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), NEAR_POSITION));
+		physics_server->body_set_state(body, PhysicsServer3D::BODY_STATE_SLEEPING, true);
+		scene.step();
+		CHECK_MESSAGE(scene.monitor->body_exited == 1, "A sleeping body moved out of the area should be reported.");
+
+		physics_server->free(body);
+	}
+
+	SUBCASE("Static body moved with body_set_state") {
+		AreaScene scene(true);
+		RID body = scene.create_body(PhysicsServer3D::BODY_MODE_STATIC, NEAR_POSITION);
+		scene.step();
+		CHECK(scene.monitor->body_entered == 0);
+
+		physics_server->body_set_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), INSIDE_POSITION));
+		scene.step();
+		CHECK_MESSAGE(scene.monitor->body_entered == 1, "A static body moved into the area should be reported.");
+
+		// Nothing moves, nothing should be reported again.
+		scene.step();
+		CHECK(scene.monitor->body_entered == 0);
+		CHECK(scene.monitor->body_exited == 0);
+
+		physics_server->body_set_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), NEAR_POSITION));
+		scene.step();
+		CHECK_MESSAGE(scene.monitor->body_exited == 1, "A static body moved out of the area should be reported.");
+
+		physics_server->free(body);
+	}
+
+	SUBCASE("Pair removed in the step it entered") {
+		AreaScene scene(false);
+		RID body = scene.create_body(PhysicsServer3D::BODY_MODE_RIGID, FAR_POSITION);
+		scene.step();
+
+		physics_server->body_set_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), INSIDE_POSITION));
+		scene.monitor->reset();
+		physics_server->step(STEP_TIME);
+		// The enter and the exit cancel out before the callbacks are flushed.
+		physics_server->body_set_space(body, RID());
+		physics_server->flush_queries();
+		CHECK(scene.monitor->body_entered == 0);
+		CHECK(scene.monitor->body_exited == 0);
+
+		physics_server->body_set_space(body, scene.space);
+		scene.step();
+		CHECK_MESSAGE(scene.monitor->body_entered == 1, "Adding the body back should report it once.");
+		CHECK(scene.monitor->body_exited == 0);
+
+		physics_server->free(body);
+	}
+}
+
+TEST_CASE("[SceneTree][Physics] Area monitors report areas entering and leaving") {
+	PhysicsServer3D *physics_server = PhysicsServer3D::get_singleton();
+
+	SUBCASE("Moving monitorable area") {
+		AreaScene scene(false);
+		RID other_area = scene.create_area(NEAR_POSITION, true);
+		scene.step();
+		CHECK(scene.monitor->area_entered == 0);
+
+		physics_server->area_set_transform(other_area, Transform3D(Basis(), INSIDE_POSITION));
+		scene.step();
+		CHECK_MESSAGE(scene.monitor->area_entered == 1, "A monitorable area moved into the area should be reported.");
+
+		scene.step();
+		CHECK(scene.monitor->area_entered == 0);
+		CHECK(scene.monitor->area_exited == 0);
+
+		physics_server->area_set_transform(other_area, Transform3D(Basis(), NEAR_POSITION));
+		scene.step();
+		CHECK_MESSAGE(scene.monitor->area_exited == 1, "A monitorable area moved out of the area should be reported.");
+
+		physics_server->free(other_area);
+	}
+
+	SUBCASE("Area that isn't monitorable") {
+		AreaScene scene(true);
+		RID other_area = scene.create_area(NEAR_POSITION, false);
+		scene.step();
+
+		physics_server->area_set_transform(other_area, Transform3D(Basis(), INSIDE_POSITION));
+		scene.step();
+		CHECK(scene.monitor->area_entered == 0);
+
+		physics_server->free(other_area);
+	}
+
+	SUBCASE("Pair removed in the step it entered") {
+		AreaScene scene(false);
+		RID other_area = scene.create_area(FAR_POSITION, true);
+		scene.step();
+
+		physics_server->area_set_transform(other_area, Transform3D(Basis(), INSIDE_POSITION));
+		scene.monitor->reset();
+		physics_server->step(STEP_TIME);
+		physics_server->area_set_space(other_area, RID());
+		physics_server->flush_queries();
+		CHECK(scene.monitor->area_entered == 0);
+		CHECK(scene.monitor->area_exited == 0);
+
+		physics_server->area_set_space(other_area, scene.space);
+		scene.step();
+		CHECK_MESSAGE(scene.monitor->area_entered == 1, "Adding the area back should report it once.");
+
+		physics_server->free(other_area);
+	}
+}
+
+} // namespace TestGodotAreaPair3D
+
+#endif // TEST_GODOT_AREA_PAIR_3D_H
@@ -0,0 +1,260 @@
+/**************************************************************************/
+/*  test_godot_collision_solver_3d.h                                      */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_GODOT_COLLISION_SOLVER_3D_H
+#define TEST_GODOT_COLLISION_SOLVER_3D_H
+
+#include "core/math/random_pcg.h"
+#include "core/os/os.h"
+#include "servers/physics_3d/godot_collision_solver_3d.h"
+#include "servers/physics_3d/godot_collision_solver_3d_sat.h"
+#include "servers/physics_3d/godot_shape_3d.h"
+
+#include "tests/test_macros.h"
+
+namespace TestGodotCollisionSolver3D {
+
+struct ContactManifold {
+	LocalVector<Vector3> points_A;
+	LocalVector<Vector3> points_B;
+	Vector3 normal;
+	Vector3 prev_axis;
+	bool collided = false;
+
+	bool operator==(const ContactManifold &p_other) const {
+		if (collided != p_other.collided || normal != p_other.normal || prev_axis != p_other.prev_axis) {
+			return false;
+		}
+		if (points_A.size() != p_other.points_A.size()) {
+			return false;
+		}
+		for (uint32_t i = 0; i < points_A.size(); i++) {
+			if (points_A[i] != p_other.points_A[i] || points_B[i] != p_other.points_B[i]) {
+				return false;
+			}
+		}
+		return true;
+	}
+};
+
+static void _add_contact(const Vector3 &p_point_A, int p_index_A, const Vector3 &p_point_B, int p_index_B, const Vector3 &p_normal, void *p_userdata) {
+	ContactManifold *manifold = static_cast<ContactManifold *>(p_userdata);
+	manifold->points_A.push_back(p_point_A);
+	manifold->points_B.push_back(p_point_B);
+	manifold->normal = p_normal;
+}
+
+static Transform3D _random_transform(RandomPCG &p_rng, real_t p_spread) {
+	Vector3 axis(p_rng.random(-1.0f, 1.0f), p_rng.random(-1.0f, 1.0f), p_rng.random(-1.0f, 1.0f));
+	if (axis.is_zero_approx()) {
+		axis = Vector3(0, 1, 0);
+	}
+	Basis basis(axis.normalized(), p_rng.random(-Math_PI, Math_PI));
+	// Keep some of the pairs axis-aligned, they hit the degenerate edge axes.
+	if (p_rng.rand() % 4 == 0) {
+		basis = Basis();
+	}
+	Vector3 origin(p_rng.random(-p_spread, p_spread), p_rng.random(-p_spread, p_spread), p_rng.random(-p_spread, p_spread));
+	return Transform3D(basis, origin);
+}
+
+static ContactManifold _collide(const GodotShape3D *p_shape_A, const Transform3D &p_transform_A, const GodotShape3D *p_shape_B, const Transform3D &p_transform_B, real_t p_margin, bool p_batched) {
+	ContactManifold manifold;
+	if (p_batched) {
+		manifold.collided = sat_calculate_penetration(p_shape_A, p_transform_A, p_shape_B, p_transform_B, _add_contact, &manifold, false, &manifold.prev_axis, p_margin, p_margin);
+	} else {
+		manifold.collided = sat_calculate_penetration_unbatched(p_shape_A, p_transform_A, p_shape_B, p_transform_B, _add_contact, &manifold, false, &manifold.prev_axis, p_margin, p_margin);
+	}
+	return manifold;
+}
+
+static void _check_identical_manifolds(const GodotShape3D *p_shape_A, const GodotShape3D *p_shape_B) {
+	RandomPCG rng(1234);
+	int collided = 0;
+
+	for (int i = 0; i < 2000; i++) {
+		Transform3D transform_A = _random_transform(rng, 1.5);
+		Transform3D transform_B = _random_transform(rng, 1.5);
+		real_t margin = (i % 2 == 0) ? 0.0 : 0.04;
+
+		ContactManifold reference = _collide(p_shape_A, transform_A, p_shape_B, transform_B, margin, false);
+		ContactManifold batched = _collide(p_shape_A, transform_A, p_shape_B, transform_B, margin, true);
+
+		CHECK_MESSAGE(reference == batched, "Batched axis tests should generate the same contacts as testing one axis at a time.");
+		if (reference.collided) {
+			collided++;
+		}
+	}
+
+	// Make sure both the colliding and separated cases are covered.
+	CHECK(collided > 0);
+	CHECK(collided < 2000);
+}
+
+struct BenchmarkResult {
+	uint64_t usec = 0;
+	int collided = 0;
+	int contacts = 0;
+};
+
+static BenchmarkResult _benchmark(const GodotShape3D *p_shape_A, const GodotShape3D *p_shape_B, bool p_batched) {
+	RandomPCG rng(4321);
+	LocalVector<Transform3D> transforms;
+	for (int i = 0; i < 2000; i++) {
+		transforms.push_back(_random_transform(rng, 2.0));
+	}
+
+	BenchmarkResult result;
+	ContactManifold manifold;
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int r = 0; r < 10; r++) {
+		for (uint32_t i = 0; i + 1 < transforms.size(); i += 2) {
+			manifold.points_A.clear();
+			manifold.points_B.clear();
+			bool collided;
+			if (p_batched) {
+				collided = sat_calculate_penetration(p_shape_A, transforms[i], p_shape_B, transforms[i + 1], _add_contact, &manifold);
+			} else {
+				collided = sat_calculate_penetration_unbatched(p_shape_A, transforms[i], p_shape_B, transforms[i + 1], _add_contact, &manifold);
+			}
+			if (collided) {
+				result.collided++;
+			}
+			result.contacts += manifold.points_A.size();
+		}
+	}
+	result.usec = OS::get_singleton()->get_ticks_usec() - begin;
+	return result;
+}
+
+TEST_CASE("[Physics][SAT] Box-box batched axis tests match the scalar path") {
+	GodotBoxShape3D box_A;
+	box_A.set_data(Vector3(0.5, 1.0, 0.75));
+	GodotBoxShape3D box_B;
+	box_B.set_data(Vector3(1.0, 0.25, 0.5));
+
+	_check_identical_manifolds(&box_A, &box_B);
+}
+
+TEST_CASE("[Physics][SAT] Box-capsule batched axis tests match the scalar path") {
+	GodotBoxShape3D box;
+	box.set_data(Vector3(0.5, 1.0, 0.75));
+	GodotCapsuleShape3D capsule;
+	Dictionary capsule_data;
+	capsule_data["radius"] = 0.4;
+	capsule_data["height"] = 1.8;
+	capsule.set_data(capsule_data);
+
+	_check_identical_manifolds(&box, &capsule);
+	_check_identical_manifolds(&capsule, &box);
+}
+
+TEST_CASE("[Physics][SAT][Benchmark] Batched axis tests" * doctest::skip()) {
+	GodotBoxShape3D box_A;
+	box_A.set_data(Vector3(0.5, 1.0, 0.75));
+	GodotBoxShape3D box_B;
+	box_B.set_data(Vector3(1.0, 0.25, 0.5));
+	GodotCapsuleShape3D capsule;
+	Dictionary capsule_data;
+	capsule_data["radius"] = 0.4;
+	capsule_data["height"] = 1.8;
+	capsule.set_data(capsule_data);
+
+	BenchmarkResult box_box_scalar = _benchmark(&box_A, &box_B, false);
+	BenchmarkResult box_box_batched = _benchmark(&box_A, &box_B, true);
+	BenchmarkResult box_capsule_scalar = _benchmark(&box_A, &capsule, false);
+	BenchmarkResult box_capsule_batched = _benchmark(&box_A, &capsule, true);
+
+	MESSAGE("Box-box: ", box_box_scalar.usec, " usec scalar, ", box_box_batched.usec, " usec batched.");
+	MESSAGE("Box-capsule: ", box_capsule_scalar.usec, " usec scalar, ", box_capsule_batched.usec, " usec batched.");
+
+	CHECK(box_box_batched.collided == box_box_scalar.collided);
+	CHECK(box_box_batched.contacts == box_box_scalar.contacts);
+	CHECK(box_capsule_batched.collided == box_capsule_scalar.collided);
+	CHECK(box_capsule_batched.contacts == box_capsule_scalar.contacts);
+}
+
+TEST_CASE("[Physics][TOI] Conservative advancement doesn't tunnel through thin boxes") {
+	GodotSphereShape3D sphere;
+	sphere.set_data(0.25);
+	GodotBoxShape3D wall;
+	wall.set_data(Vector3(2.0, 2.0, 0.01));
+
+	Transform3D sphere_xform(Basis(), Vector3(0, 0, -5));
+	Transform3D wall_xform;
+	real_t tolerance = 0.001;
+
+	real_t toi = -1.0;
+	Vector3 normal;
+	// The motion skips right over the wall, both ends are clear of it.
+	CHECK(GodotCollisionSolver3D::solve_toi(&sphere, sphere_xform, Vector3(0, 0, 10), &wall, wall_xform, tolerance, toi, &normal));
+	// Contact when the sphere's front reaches the wall's face, at z = -0.26.
+	CHECK(toi == doctest::Approx(0.474).epsilon(0.001));
+	CHECK(normal.is_equal_approx(Vector3(0, 0, -1)));
+
+	// Sliding along the wall never reaches it.
+	CHECK_FALSE(GodotCollisionSolver3D::solve_toi(&sphere, sphere_xform, Vector3(10, 0, 0), &wall, wall_xform, tolerance, toi));
+	// Moving away from it either.
+	CHECK_FALSE(GodotCollisionSolver3D::solve_toi(&sphere, sphere_xform, Vector3(0, 0, -10), &wall, wall_xform, tolerance, toi));
+	// Stopping short of it.
+	CHECK_FALSE(GodotCollisionSolver3D::solve_toi(&sphere, sphere_xform, Vector3(0, 0, 4), &wall, wall_xform, tolerance, toi));
+}
+
+TEST_CASE("[Physics][TOI] Conservative advancement against concave shapes") {
+	GodotBoxShape3D box;
+	box.set_data(Vector3(0.1, 0.1, 0.1));
+
+	// A single upwards facing quad at y = 0.
+	PackedVector3Array faces;
+	faces.push_back(Vector3(-1, 0, -1));
+	faces.push_back(Vector3(1, 0, -1));
+	faces.push_back(Vector3(1, 0, 1));
+	faces.push_back(Vector3(-1, 0, -1));
+	faces.push_back(Vector3(1, 0, 1));
+	faces.push_back(Vector3(-1, 0, 1));
+	GodotConcavePolygonShape3D floor;
+	Dictionary floor_data;
+	floor_data["faces"] = faces;
+	floor_data["backface_collision"] = false;
+	floor.set_data(floor_data);
+
+	Transform3D box_xform(Basis(), Vector3(0.3, 2.1, 0.2));
+	real_t toi = -1.0;
+	CHECK(GodotCollisionSolver3D::solve_toi(&box, box_xform, Vector3(0, -4, 0), &floor, Transform3D(), 0.001, toi));
+	CHECK(toi == doctest::Approx(0.5).epsilon(0.001));
+
+	// Passing next to the quad.
+	box_xform.origin.x = 1.5;
+	CHECK_FALSE(GodotCollisionSolver3D::solve_toi(&box, box_xform, Vector3(0, -4, 0), &floor, Transform3D(), 0.001, toi));
+}
+
+} // namespace TestGodotCollisionSolver3D
+
+#endif // TEST_GODOT_COLLISION_SOLVER_3D_H
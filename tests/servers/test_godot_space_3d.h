@@ -0,0 +1,225 @@
+/**************************************************************************/
+/*  test_godot_space_3d.h                                                 */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_GODOT_SPACE_3D_H
+#define TEST_GODOT_SPACE_3D_H
+
+#include "core/math/random_pcg.h"
+#include "servers/physics_server_3d.h"
+
+#include "tests/test_macros.h"
+
+namespace TestGodotSpace3D {
+
+struct QueryScene {
+	RID space;
+	RID box_shape;
+	RID sphere_shape;
+	LocalVector<RID> objects;
+};
+
+// Static boxes and spheres on two collision layers, plus a few areas, scattered in a 20m cube.
+static QueryScene _create_query_scene() {
+	PhysicsServer3D *physics_server = PhysicsServer3D::get_singleton();
+	QueryScene scene;
+	scene.space = physics_server->space_create();
+	physics_server->space_set_active(scene.space, true);
+
+	scene.box_shape = physics_server->box_shape_create();
+	physics_server->shape_set_data(scene.box_shape, Vector3(0.5, 0.75, 0.5));
+	scene.sphere_shape = physics_server->sphere_shape_create();
+	physics_server->shape_set_data(scene.sphere_shape, 0.6);
+
+	RandomPCG rng(42);
+	for (int i = 0; i < 200; i++) {
+		const Transform3D transform(Basis::from_euler(Vector3(rng.randf(), rng.randf(), rng.randf()) * Math_TAU), Vector3(rng.random(-10.0f, 10.0f), rng.random(-10.0f, 10.0f), rng.random(-10.0f, 10.0f)));
+		RID object;
+		if (i % 10 == 9) {
+			object = physics_server->area_create();
+			physics_server->area_add_shape(object, scene.sphere_shape);
+			physics_server->area_set_transform(object, transform);
+			physics_server->area_set_collision_layer(object, 1);
+			physics_server->area_set_space(object, scene.space);
+		} else {
+			object = physics_server->body_create();
+			physics_server->body_set_mode(object, PhysicsServer3D::BODY_MODE_STATIC);
+			physics_server->body_add_shape(object, i % 2 ? scene.box_shape : scene.sphere_shape);
+			// A second shape, so shape indices are compared too.
+			if (i % 3 == 0) {
+				physics_server->body_add_shape(object, scene.box_shape, Transform3D(Basis(), Vector3(0, 1.5, 0)));
+			}
+			physics_server->body_set_state(object, PhysicsServer3D::BODY_STATE_TRANSFORM, transform);
+			physics_server->body_set_collision_layer(object, i % 4 == 0 ? 2 : 1);
+			physics_server->body_set_space(object, scene.space);
+		}
+		scene.objects.push_back(object);
+	}
+
+	// Registers everything in the broad phase.
+	physics_server->step(1.0 / 60.0);
+	return scene;
+}
+
+static void _free_query_scene(const QueryScene &p_scene) {
+	PhysicsServer3D *physics_server = PhysicsServer3D::get_singleton();
+	for (const RID &object : p_scene.objects) {
+		physics_server->free(object);
+	}
+	physics_server->free(p_scene.box_shape);
+	physics_server->free(p_scene.sphere_shape);
+	physics_server->free(p_scene.space);
+}
+
+TEST_CASE("[SceneTree][Physics] Batched ray queries match serial ray queries") {
+	PhysicsServer3D *physics_server = PhysicsServer3D::get_singleton();
+	const QueryScene scene = _create_query_scene();
+	PhysicsDirectSpaceState3D *space_state = physics_server->space_get_direct_state(scene.space);
+	REQUIRE(space_state);
+
+	RandomPCG rng(7);
+	const int ray_count = 1000;
+	LocalVector<Vector3> from;
+	LocalVector<Vector3> to;
+	for (int i = 0; i < ray_count; i++) {
+		from.push_back(Vector3(rng.random(-12.0f, 12.0f), rng.random(-12.0f, 12.0f), rng.random(-12.0f, 12.0f)));
+		to.push_back(Vector3(rng.random(-12.0f, 12.0f), rng.random(-12.0f, 12.0f), rng.random(-12.0f, 12.0f)));
+	}
+
+	PhysicsDirectSpaceState3D::RayParameters parameters;
+	SUBCASE("Default parameters") {
+	}
+	SUBCASE("Collision mask, excluded objects and areas") {
+		parameters.collision_mask = 1;
+		parameters.collide_with_areas = true;
+		parameters.exclude.insert(scene.objects[1]);
+		parameters.exclude.insert(scene.objects[19]);
+	}
+	SUBCASE("Hits from inside without back faces") {
+		parameters.hit_from_inside = true;
+		parameters.hit_back_faces = false;
+	}
+
+	LocalVector<PhysicsDirectSpaceState3D::RayResult> results;
+	LocalVector<bool> collided;
+	results.resize(ray_count);
+	collided.resize(ray_count);
+	const int collided_count = space_state->intersect_rays(parameters, from.ptr(), to.ptr(), ray_count, results.ptr(), collided.ptr());
+
+	int serial_collided_count = 0;
+	int mismatch_count = 0;
+	for (int i = 0; i < ray_count; i++) {
+		PhysicsDirectSpaceState3D::RayParameters serial_parameters = parameters;
+		serial_parameters.from = from[i];
+		serial_parameters.to = to[i];
+		PhysicsDirectSpaceState3D::RayResult serial_result;
+		const bool serial_collided = space_state->intersect_ray(serial_parameters, serial_result);
+		if (serial_collided) {
+			serial_collided_count++;
+		}
+		if (serial_collided != collided[i]) {
+			mismatch_count++;
+			continue;
+		}
+		if (serial_collided && (serial_result.position != results[i].position || serial_result.normal != results[i].normal || serial_result.collider_id != results[i].collider_id || serial_result.rid != results[i].rid || serial_result.shape != results[i].shape || serial_result.face_index != results[i].face_index)) {
+			mismatch_count++;
+		}
+	}
+
+	// Some rays must hit and some must miss, or the comparison says little.
+	CHECK(serial_collided_count > 0);
+	CHECK(serial_collided_count < ray_count);
+	CHECK(collided_count == serial_collided_count);
+	CHECK_MESSAGE(mismatch_count == 0, vformat("%d batched rays differ from the serial ones.", mismatch_count));
+
+	_free_query_scene(scene);
+}
+
+TEST_CASE("[SceneTree][Physics] Batched shape queries match serial shape queries") {
+	PhysicsServer3D *physics_server = PhysicsServer3D::get_singleton();
+	const QueryScene scene = _create_query_scene();
+	PhysicsDirectSpaceState3D *space_state = physics_server->space_get_direct_state(scene.space);
+	REQUIRE(space_state);
+
+	RandomPCG rng(11);
+	const int query_count = 300;
+	const int result_max = 8;
+	LocalVector<Transform3D> transforms;
+	for (int i = 0; i < query_count; i++) {
+		transforms.push_back(Transform3D(Basis::from_euler(Vector3(rng.randf(), rng.randf(), rng.randf()) * Math_TAU), Vector3(rng.random(-10.0f, 10.0f), rng.random(-10.0f, 10.0f), rng.random(-10.0f, 10.0f))));
+	}
+
+	PhysicsDirectSpaceState3D::ShapeParameters parameters;
+	parameters.shape_rid = scene.box_shape;
+	SUBCASE("Default parameters") {
+	}
+	SUBCASE("Collision mask, excluded objects, areas and margin") {
+		parameters.collision_mask = 2;
+		parameters.collide_with_areas = true;
+		parameters.margin = 0.1;
+		parameters.exclude.insert(scene.objects[0]);
+	}
+
+	LocalVector<PhysicsDirectSpaceState3D::ShapeResult> results;
+	LocalVector<int> result_counts;
+	results.resize(query_count * result_max);
+	result_counts.resize(query_count);
+	const int total = space_state->intersect_shapes(parameters, transforms.ptr(), query_count, results.ptr(), result_max, result_counts.ptr());
+
+	int serial_total = 0;
+	int mismatch_count = 0;
+	PhysicsDirectSpaceState3D::ShapeResult serial_results[result_max];
+	for (int i = 0; i < query_count; i++) {
+		PhysicsDirectSpaceState3D::ShapeParameters serial_parameters = parameters;
+		serial_parameters.transform = transforms[i];
+		const int serial_count = space_state->intersect_shape(serial_parameters, serial_results, result_max);
+		serial_total += serial_count;
+		if (serial_count != result_counts[i]) {
+			mismatch_count++;
+			continue;
+		}
+		for (int j = 0; j < serial_count; j++) {
+			const PhysicsDirectSpaceState3D::ShapeResult &result = results[i * result_max + j];
+			if (serial_results[j].rid != result.rid || serial_results[j].collider_id != result.collider_id || serial_results[j].shape != result.shape) {
+				mismatch_count++;
+				break;
+			}
+		}
+	}
+
+	CHECK(serial_total > 0);
+	CHECK(total == serial_total);
+	CHECK_MESSAGE(mismatch_count == 0, vformat("%d batched shape queries differ from the serial ones.", mismatch_count));
+
+	_free_query_scene(scene);
+}
+
+} // namespace TestGodotSpace3D
+
+#endif // TEST_GODOT_SPACE_3D_H
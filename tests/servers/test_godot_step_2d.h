@@ -0,0 +1,219 @@
+/**************************************************************************/
+/*  test_godot_step_2d.h                                                  */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_GODOT_STEP_2D_H
+#define TEST_GODOT_STEP_2D_H
+
+#include "core/config/project_settings.h"
+#include "servers/physics_2d/godot_joints_2d.h"
+#include "servers/physics_2d/godot_step_2d.h"
+#include "servers/physics_server_2d.h"
+
+#include "tests/test_macros.h"
+
+namespace TestGodotStep2D {
+
+constexpr real_t STEP_TIME = 1.0 / 60.0;
+
+struct BodyMotion {
+	Transform2D transform;
+	Vector2 linear_velocity;
+	real_t angular_velocity = 0.0;
+};
+
+static RID _create_box_body(RID p_space, RID p_shape, const Vector2 &p_position, PhysicsServer2D::BodyMode p_mode) {
+	PhysicsServer2D *physics_server = PhysicsServer2D::get_singleton();
+	RID body = physics_server->body_create();
+	physics_server->body_set_mode(body, p_mode);
+	physics_server->body_add_shape(body, p_shape);
+	physics_server->body_set_state(body, PhysicsServer2D::BODY_STATE_TRANSFORM, Transform2D(0, p_position));
+	physics_server->body_set_space(body, p_space);
+	return body;
+}
+
+// Steps the space with a few forces applied and appends the state of the bodies after every step.
+static void _record_motions(const LocalVector<RID> &p_bodies, int p_step_count, LocalVector<BodyMotion> &r_motions) {
+	PhysicsServer2D *physics_server = PhysicsServer2D::get_singleton();
+	for (int i = 0; i < p_step_count; i++) {
+		physics_server->body_apply_central_force(p_bodies[i % p_bodies.size()], Vector2(400, -2000));
+		physics_server->step(STEP_TIME);
+		for (const RID &body : p_bodies) {
+			BodyMotion motion;
+			motion.transform = physics_server->body_get_state(body, PhysicsServer2D::BODY_STATE_TRANSFORM);
+			motion.linear_velocity = physics_server->body_get_state(body, PhysicsServer2D::BODY_STATE_LINEAR_VELOCITY);
+			motion.angular_velocity = physics_server->body_get_state(body, PhysicsServer2D::BODY_STATE_ANGULAR_VELOCITY);
+			r_motions.push_back(motion);
+		}
+	}
+}
+
+TEST_CASE("[SceneTree][Physics] Stepping again from a restored 2D space snapshot gives the same results") {
+	PhysicsServer2D *physics_server = PhysicsServer2D::get_singleton();
+	ProjectSettings *project_settings = ProjectSettings::get_singleton();
+	const Variant old_deterministic = project_settings->get_setting("physics/2d/solver/deterministic");
+	project_settings->set_setting("physics/2d/solver/deterministic", true);
+	RID space = physics_server->space_create();
+	project_settings->set_setting("physics/2d/solver/deterministic", old_deterministic);
+	physics_server->space_set_active(space, true);
+
+	RID floor_shape = physics_server->rectangle_shape_create();
+	physics_server->shape_set_data(floor_shape, Vector2(1000, 10));
+	RID floor = _create_box_body(space, floor_shape, Vector2(0, 10), PhysicsServer2D::BODY_MODE_STATIC);
+
+	RID box_shape = physics_server->rectangle_shape_create();
+	physics_server->shape_set_data(box_shape, Vector2(10, 10));
+
+	// Boxes falling on top of each other, so contacts are kept between steps when the snapshot is saved.
+	LocalVector<RID> boxes;
+	for (int i = 0; i < 12; i++) {
+		RID box = _create_box_body(space, box_shape, Vector2((i % 3) * 7, -10 - i * 22), PhysicsServer2D::BODY_MODE_RIGID);
+		physics_server->body_set_state(box, PhysicsServer2D::BODY_STATE_ANGULAR_VELOCITY, i * 0.2);
+		boxes.push_back(box);
+	}
+
+	// A joint and an area overriding gravity around the bottom of the stack, their state is saved along with the bodies.
+	RID joint = physics_server->joint_create();
+	physics_server->joint_make_pin(joint, Vector2(0, -43), boxes[0], boxes[3]);
+
+	RID area_shape = physics_server->rectangle_shape_create();
+	physics_server->shape_set_data(area_shape, Vector2(40, 40));
+	RID area = physics_server->area_create();
+	physics_server->area_add_shape(area, area_shape);
+	physics_server->area_set_transform(area, Transform2D(0, Vector2(7, -20)));
+	physics_server->area_set_param(area, PhysicsServer2D::AREA_PARAM_GRAVITY_OVERRIDE_MODE, PhysicsServer2D::AREA_SPACE_OVERRIDE_REPLACE);
+	physics_server->area_set_param(area, PhysicsServer2D::AREA_PARAM_GRAVITY_VECTOR, Vector2(0.5, 1));
+	physics_server->area_set_space(area, space);
+
+	for (int i = 0; i < 90; i++) {
+		physics_server->step(STEP_TIME);
+	}
+
+	const PackedByteArray snapshot = physics_server->space_save_snapshot(space);
+	REQUIRE_FALSE(snapshot.is_empty());
+
+	LocalVector<BodyMotion> first_motions;
+	_record_motions(boxes, 60, first_motions);
+
+	REQUIRE(physics_server->space_restore_snapshot(space, snapshot) == OK);
+
+	LocalVector<BodyMotion> second_motions;
+	_record_motions(boxes, 60, second_motions);
+
+	REQUIRE(first_motions.size() == second_motions.size());
+	uint32_t mismatch_count = 0;
+	for (uint32_t i = 0; i < first_motions.size(); i++) {
+		if (first_motions[i].transform != second_motions[i].transform || first_motions[i].linear_velocity != second_motions[i].linear_velocity || first_motions[i].angular_velocity != second_motions[i].angular_velocity) {
+			mismatch_count++;
+		}
+	}
+	CHECK_MESSAGE(mismatch_count == 0, vformat("%d body states differ after restoring the snapshot.", mismatch_count));
+
+	physics_server->free(joint);
+	physics_server->free(area);
+	physics_server->free(area_shape);
+
+	for (const RID &box : boxes) {
+		physics_server->free(box);
+	}
+	physics_server->free(box_shape);
+	physics_server->free(floor);
+	physics_server->free(floor_shape);
+	physics_server->free(space);
+}
+
+TEST_CASE("[SceneTree][Physics] Islands are kept across steps and only patched where constraints change") {
+	GodotSpace2D *space = memnew(GodotSpace2D);
+	GodotArea2D *default_area = memnew(GodotArea2D);
+	space->set_default_area(default_area);
+	default_area->set_space(space);
+	GodotStep2D *step = memnew(GodotStep2D);
+
+	// Two pairs of bodies, A-B and C-D, without shapes so only the joints connect them.
+	GodotBody2D *bodies[4];
+	for (int i = 0; i < 4; i++) {
+		bodies[i] = memnew(GodotBody2D);
+		bodies[i]->set_mode(PhysicsServer2D::BODY_MODE_RIGID);
+		bodies[i]->set_space(space);
+	}
+	CHECK(bodies[0]->get_island() != nullptr);
+	CHECK(bodies[0]->get_island() != bodies[1]->get_island());
+
+	GodotJoint2D *joint_cd = memnew(GodotPinJoint2D(Vector2(), bodies[2], bodies[3]));
+	GodotIsland2D *island_cd = bodies[2]->get_island();
+	CHECK_MESSAGE(bodies[3]->get_island() == island_cd, "Adding a joint merges the islands of its bodies right away.");
+	CHECK(island_cd->constraints.size() == 1);
+	CHECK_FALSE(island_cd->dirty);
+
+	GodotJoint2D *joint_ab = memnew(GodotPinJoint2D(Vector2(), bodies[0], bodies[1]));
+	GodotIsland2D *island_ab = bodies[0]->get_island();
+	CHECK(bodies[1]->get_island() == island_ab);
+	CHECK(island_ab != island_cd);
+
+	for (int i = 0; i < 5; i++) {
+		step->step(space, STEP_TIME);
+		CHECK(bodies[0]->get_island() == island_ab);
+		CHECK(bodies[1]->get_island() == island_ab);
+		CHECK(bodies[2]->get_island() == island_cd);
+		CHECK(bodies[3]->get_island() == island_cd);
+	}
+
+	// Sleeping doesn't change how bodies are connected.
+	bodies[2]->set_active(false);
+	bodies[3]->set_active(false);
+	CHECK_FALSE(island_cd->dirty);
+	step->step(space, STEP_TIME);
+	CHECK(bodies[2]->get_island() == island_cd);
+	CHECK_FALSE(bodies[2]->is_active());
+
+	// Removing a joint only floods its own island again.
+	memdelete(joint_ab);
+	CHECK(island_ab->dirty);
+	CHECK_FALSE(island_cd->dirty);
+	step->step(space, STEP_TIME);
+	CHECK(bodies[0]->get_island() != nullptr);
+	CHECK_MESSAGE(bodies[0]->get_island() != bodies[1]->get_island(), "Bodies are in separate islands once their joint is removed.");
+	CHECK(bodies[2]->get_island() == island_cd);
+	CHECK(bodies[3]->get_island() == island_cd);
+
+	memdelete(joint_cd);
+	for (int i = 0; i < 4; i++) {
+		bodies[i]->set_space(nullptr);
+		CHECK(bodies[i]->get_island() == nullptr);
+		memdelete(bodies[i]);
+	}
+	default_area->set_space(nullptr);
+	memdelete(default_area);
+	memdelete(step);
+	memdelete(space);
+}
+
+} // namespace TestGodotStep2D
+
+#endif // TEST_GODOT_STEP_2D_H
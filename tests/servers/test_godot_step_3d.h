@@ -0,0 +1,523 @@
+/**************************************************************************/
+/*  test_godot_step_3d.h                                                  */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_GODOT_STEP_3D_H
+#define TEST_GODOT_STEP_3D_H
+
+#include "core/config/project_settings.h"
+#include "core/os/os.h"
+#include "servers/physics_3d/godot_step_3d.h"
+#include "servers/physics_3d/joints/godot_pin_joint_3d.h"
+#include "servers/physics_server_3d.h"
+
+#include "tests/test_macros.h"
+
+namespace TestGodotStep3D {
+
+constexpr int STEP_COUNT = 300;
+constexpr real_t STEP_TIME = 1.0 / 60.0;
+
+struct SolverConfig {
+	int iterations = 16;
+	int substeps = 1;
+};
+
+struct SolverResult {
+	uint64_t usec = 0;
+	// How far the bodies ended from where they settle, or the worst joint separation for ragdolls.
+	real_t error = 0.0;
+	real_t max_linear_velocity = 0.0;
+};
+
+static RID _create_box_body(RID p_space, RID p_shape, const Vector3 &p_position, PhysicsServer3D::BodyMode p_mode) {
+	PhysicsServer3D *physics_server = PhysicsServer3D::get_singleton();
+	RID body = physics_server->body_create();
+	physics_server->body_set_mode(body, p_mode);
+	physics_server->body_add_shape(body, p_shape);
+	physics_server->body_set_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), p_position));
+	physics_server->body_set_space(body, p_space);
+	return body;
+}
+
+static RID _create_space(const SolverConfig &p_config, RID &r_floor_shape, RID &r_floor) {
+	PhysicsServer3D *physics_server = PhysicsServer3D::get_singleton();
+	RID space = physics_server->space_create();
+	physics_server->space_set_active(space, true);
+	physics_server->space_set_param(space, PhysicsServer3D::SPACE_PARAM_SOLVER_ITERATIONS, p_config.iterations);
+	physics_server->space_set_param(space, PhysicsServer3D::SPACE_PARAM_SOLVER_SUBSTEPS, p_config.substeps);
+
+	r_floor_shape = physics_server->box_shape_create();
+	physics_server->shape_set_data(r_floor_shape, Vector3(50, 0.5, 50));
+	r_floor = _create_box_body(space, r_floor_shape, Vector3(0, -0.5, 0), PhysicsServer3D::BODY_MODE_STATIC);
+	return space;
+}
+
+static uint64_t _simulate(const LocalVector<RID> &p_bodies, real_t &r_max_linear_velocity) {
+	PhysicsServer3D *physics_server = PhysicsServer3D::get_singleton();
+	const uint64_t begin_usec = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < STEP_COUNT; i++) {
+		physics_server->step(STEP_TIME);
+	}
+	const uint64_t usec = OS::get_singleton()->get_ticks_usec() - begin_usec;
+
+	r_max_linear_velocity = 0.0;
+	for (const RID &body : p_bodies) {
+		const Vector3 velocity = physics_server->body_get_state(body, PhysicsServer3D::BODY_STATE_LINEAR_VELOCITY);
+		r_max_linear_velocity = MAX(r_max_linear_velocity, velocity.length());
+	}
+	return usec;
+}
+
+// Pyramid of unit boxes resting on the floor, the boxes should not move from their initial positions.
+static SolverResult _benchmark_pyramid(const SolverConfig &p_config) {
+	PhysicsServer3D *physics_server = PhysicsServer3D::get_singleton();
+	RID floor_shape;
+	RID floor;
+	RID space = _create_space(p_config, floor_shape, floor);
+
+	RID box_shape = physics_server->box_shape_create();
+	physics_server->shape_set_data(box_shape, Vector3(0.5, 0.5, 0.5));
+
+	const int base_size = 10;
+	LocalVector<RID> boxes;
+	LocalVector<Vector3> positions;
+	for (int row = 0; row < base_size; row++) {
+		for (int i = 0; i < base_size - row; i++) {
+			const Vector3 position = Vector3(i - (base_size - row - 1) * 0.5, row + 0.5, 0);
+			boxes.push_back(_create_box_body(space, box_shape, position, PhysicsServer3D::BODY_MODE_RIGID));
+			positions.push_back(position);
+		}
+	}
+
+	SolverResult result;
+	result.usec = _simulate(boxes, result.max_linear_velocity);
+	for (uint32_t i = 0; i < boxes.size(); i++) {
+		const Transform3D transform = physics_server->body_get_state(boxes[i], PhysicsServer3D::BODY_STATE_TRANSFORM);
+		result.error = MAX(result.error, transform.origin.distance_to(positions[i]));
+		physics_server->free(boxes[i]);
+	}
+
+	physics_server->free(box_shape);
+	physics_server->free(floor);
+	physics_server->free(floor_shape);
+	physics_server->free(space);
+	return result;
+}
+
+// Ragdolls made of boxes held together by pin joints, dropped on top of each other.
+static SolverResult _benchmark_ragdoll_pile(const SolverConfig &p_config) {
+	PhysicsServer3D *physics_server = PhysicsServer3D::get_singleton();
+	RID floor_shape;
+	RID floor;
+	RID space = _create_space(p_config, floor_shape, floor);
+
+	RID torso_shape = physics_server->box_shape_create();
+	physics_server->shape_set_data(torso_shape, Vector3(0.3, 0.4, 0.15));
+	RID limb_shape = physics_server->box_shape_create();
+	physics_server->shape_set_data(limb_shape, Vector3(0.1, 0.35, 0.1));
+
+	struct Pin {
+		RID joint;
+		RID body_a;
+		RID body_b;
+		Vector3 local_a;
+		Vector3 local_b;
+	};
+
+	// Limbs hang from the corners of the torso.
+	const Vector3 limb_anchors[4] = { Vector3(-0.4, 0.35, 0), Vector3(0.4, 0.35, 0), Vector3(-0.2, -0.4, 0), Vector3(0.2, -0.4, 0) };
+	const int ragdoll_count = 10;
+	LocalVector<RID> bodies;
+	LocalVector<Pin> pins;
+	for (int i = 0; i < ragdoll_count; i++) {
+		const Vector3 torso_position = Vector3((i % 2) * 0.3, 1.5 + i * 1.2, (i % 3) * 0.2);
+		RID torso = _create_box_body(space, torso_shape, torso_position, PhysicsServer3D::BODY_MODE_RIGID);
+		bodies.push_back(torso);
+		for (const Vector3 &anchor : limb_anchors) {
+			const Vector3 limb_offset = Vector3(0, anchor.y > 0 ? 0.35 : -0.35, 0);
+			RID limb = _create_box_body(space, limb_shape, torso_position + anchor + limb_offset, PhysicsServer3D::BODY_MODE_RIGID);
+			bodies.push_back(limb);
+
+			Pin pin;
+			pin.joint = physics_server->joint_create();
+			pin.body_a = torso;
+			pin.body_b = limb;
+			pin.local_a = anchor;
+			pin.local_b = -limb_offset;
+			physics_server->joint_make_pin(pin.joint, torso, pin.local_a, limb, pin.local_b);
+			pins.push_back(pin);
+		}
+	}
+
+	SolverResult result;
+	result.usec = _simulate(bodies, result.max_linear_velocity);
+	for (const Pin &pin : pins) {
+		const Transform3D transform_a = physics_server->body_get_state(pin.body_a, PhysicsServer3D::BODY_STATE_TRANSFORM);
+		const Transform3D transform_b = physics_server->body_get_state(pin.body_b, PhysicsServer3D::BODY_STATE_TRANSFORM);
+		result.error = MAX(result.error, transform_a.xform(pin.local_a).distance_to(transform_b.xform(pin.local_b)));
+		physics_server->free(pin.joint);
+	}
+
+	for (const RID &body : bodies) {
+		physics_server->free(body);
+	}
+	physics_server->free(limb_shape);
+	physics_server->free(torso_shape);
+	physics_server->free(floor);
+	physics_server->free(floor_shape);
+	physics_server->free(space);
+	return result;
+}
+
+// Run with: godot --test --test-case="*[Benchmark]*" --no-skip
+TEST_CASE("[SceneTree][Physics][Benchmark] Solver iterations and substeps on stacking scenes" * doctest::skip()) {
+	const SolverConfig configs[] = { { 16, 1 }, { 8, 1 }, { 4, 2 }, { 2, 4 } };
+	for (const SolverConfig &config : configs) {
+		const SolverResult pyramid = _benchmark_pyramid(config);
+		const SolverResult ragdoll_pile = _benchmark_ragdoll_pile(config);
+
+		MESSAGE("Pyramid stack, ", config.iterations, " iterations x ", config.substeps, " substeps: ", pyramid.usec, " usec, drift ", pyramid.error, ", max velocity ", pyramid.max_linear_velocity, ".");
+		MESSAGE("Ragdoll pile, ", config.iterations, " iterations x ", config.substeps, " substeps: ", ragdoll_pile.usec, " usec, joint error ", ragdoll_pile.error, ", max velocity ", ragdoll_pile.max_linear_velocity, ".");
+	}
+}
+
+// Shoots a small box at a thin wall fast enough to cross it in a single step, returns where the box ends.
+static real_t _shoot_at_wall(const SolverConfig &p_config, bool p_continuous_cd) {
+	PhysicsServer3D *physics_server = PhysicsServer3D::get_singleton();
+	RID floor_shape;
+	RID floor;
+	RID space = _create_space(p_config, floor_shape, floor);
+
+	RID wall_shape = physics_server->box_shape_create();
+	physics_server->shape_set_data(wall_shape, Vector3(0.05, 2, 2));
+	RID wall = _create_box_body(space, wall_shape, Vector3(5, 2, 0), PhysicsServer3D::BODY_MODE_STATIC);
+
+	RID box_shape = physics_server->box_shape_create();
+	physics_server->shape_set_data(box_shape, Vector3(0.25, 0.25, 0.25));
+	RID box = _create_box_body(space, box_shape, Vector3(0, 1, 0), PhysicsServer3D::BODY_MODE_RIGID);
+	physics_server->body_set_param(box, PhysicsServer3D::BODY_PARAM_GRAVITY_SCALE, 0.0);
+	physics_server->body_set_enable_continuous_collision_detection(box, p_continuous_cd);
+	physics_server->body_set_state(box, PhysicsServer3D::BODY_STATE_LINEAR_VELOCITY, Vector3(600, 0, 0));
+
+	for (int i = 0; i < 3; i++) {
+		physics_server->step(STEP_TIME);
+	}
+	const Transform3D transform = physics_server->body_get_state(box, PhysicsServer3D::BODY_STATE_TRANSFORM);
+
+	physics_server->free(box);
+	physics_server->free(box_shape);
+	physics_server->free(wall);
+	physics_server->free(wall_shape);
+	physics_server->free(floor);
+	physics_server->free(floor_shape);
+	physics_server->free(space);
+	return transform.origin.x;
+}
+
+TEST_CASE("[SceneTree][Physics] Continuous collision detection stops fast bodies at thin walls") {
+	SUBCASE("The box tunnels through the wall without continuous collision detection") {
+		CHECK(_shoot_at_wall(SolverConfig(), false) > 5.0);
+	}
+
+	SUBCASE("The box stops at the wall with continuous collision detection") {
+		CHECK(_shoot_at_wall(SolverConfig(), true) < 5.0);
+	}
+
+	SUBCASE("The box stops at the wall when the step is split in substeps") {
+		SolverConfig config;
+		config.substeps = 4;
+		CHECK(_shoot_at_wall(config, true) < 5.0);
+	}
+}
+
+struct BodyMotion {
+	Transform3D transform;
+	Vector3 linear_velocity;
+	Vector3 angular_velocity;
+};
+
+// Pile of boxes with damping, applied forces and torques, an axis locked box, two pinned boxes and a kinematic pusher,
+// returns the state of every body after a few seconds.
+static LocalVector<BodyMotion> _simulate_integration_scene(bool p_structure_of_arrays) {
+	PhysicsServer3D *physics_server = PhysicsServer3D::get_singleton();
+	ProjectSettings *project_settings = ProjectSettings::get_singleton();
+	const Variant old_deterministic = project_settings->get_setting("physics/3d/solver/deterministic");
+	const Variant old_structure_of_arrays = project_settings->get_setting("physics/3d/solver/structure_of_arrays_integration");
+	// Runs in different spaces are compared, so pairs must not depend on the RIDs.
+	project_settings->set_setting("physics/3d/solver/deterministic", true);
+	project_settings->set_setting("physics/3d/solver/structure_of_arrays_integration", p_structure_of_arrays);
+
+	SolverConfig config;
+	config.iterations = 8;
+	config.substeps = 2;
+	RID floor_shape;
+	RID floor;
+	RID space = _create_space(config, floor_shape, floor);
+
+	project_settings->set_setting("physics/3d/solver/deterministic", old_deterministic);
+	project_settings->set_setting("physics/3d/solver/structure_of_arrays_integration", old_structure_of_arrays);
+
+	RID box_shape = physics_server->box_shape_create();
+	physics_server->shape_set_data(box_shape, Vector3(0.5, 0.5, 0.5));
+
+	LocalVector<RID> boxes;
+	for (int i = 0; i < 24; i++) {
+		const Vector3 position = Vector3((i % 4) * 1.1 - 1.5, 0.6 + (i / 4) * 1.2, (i % 3) * 0.3);
+		RID box = _create_box_body(space, box_shape, position, PhysicsServer3D::BODY_MODE_RIGID);
+		physics_server->body_set_param(box, PhysicsServer3D::BODY_PARAM_LINEAR_DAMP, (i % 5) * 0.2);
+		physics_server->body_set_param(box, PhysicsServer3D::BODY_PARAM_ANGULAR_DAMP, (i % 3) * 0.5);
+		physics_server->body_set_state(box, PhysicsServer3D::BODY_STATE_ANGULAR_VELOCITY, Vector3(0, i * 0.1, 0.5));
+		boxes.push_back(box);
+	}
+	physics_server->body_set_axis_lock(boxes[5], PhysicsServer3D::BODY_AXIS_LINEAR_Z, true);
+	physics_server->body_set_axis_lock(boxes[5], PhysicsServer3D::BODY_AXIS_ANGULAR_X, true);
+	physics_server->body_set_constant_force(boxes[7], Vector3(0, 5, 0));
+	physics_server->body_set_constant_torque(boxes[9], Vector3(1, 0, 0));
+
+	RID joint = physics_server->joint_create();
+	physics_server->joint_make_pin(joint, boxes[12], Vector3(0.55, 0, 0), boxes[13], Vector3(-0.55, 0, 0));
+
+	RID pusher = _create_box_body(space, box_shape, Vector3(-6, 1, 0), PhysicsServer3D::BODY_MODE_KINEMATIC);
+	boxes.push_back(pusher);
+
+	for (int i = 0; i < 180; i++) {
+		physics_server->body_apply_central_force(boxes[i % 24], Vector3(3, 0, -2));
+		physics_server->body_apply_torque(boxes[(i * 7) % 24], Vector3(0, 2, 0));
+		physics_server->body_set_state(pusher, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), Vector3(-6 + i * 0.03, 1, 0)));
+		physics_server->step(STEP_TIME);
+	}
+	physics_server->free(joint);
+
+	LocalVector<BodyMotion> motions;
+	for (const RID &box : boxes) {
+		BodyMotion motion;
+		motion.transform = physics_server->body_get_state(box, PhysicsServer3D::BODY_STATE_TRANSFORM);
+		motion.linear_velocity = physics_server->body_get_state(box, PhysicsServer3D::BODY_STATE_LINEAR_VELOCITY);
+		motion.angular_velocity = physics_server->body_get_state(box, PhysicsServer3D::BODY_STATE_ANGULAR_VELOCITY);
+		motions.push_back(motion);
+		physics_server->free(box);
+	}
+
+	physics_server->free(box_shape);
+	physics_server->free(floor);
+	physics_server->free(floor_shape);
+	physics_server->free(space);
+	return motions;
+}
+
+TEST_CASE("[SceneTree][Physics] Structure of arrays integration matches the per-body integration") {
+	const LocalVector<BodyMotion> reference = _simulate_integration_scene(false);
+	const LocalVector<BodyMotion> arrays = _simulate_integration_scene(true);
+
+	REQUIRE(reference.size() == arrays.size());
+	bool moved = false;
+	for (uint32_t i = 0; i < reference.size(); i++) {
+		CHECK_MESSAGE(reference[i].transform == arrays[i].transform, vformat("Body %d has a different transform.", i));
+		CHECK_MESSAGE(reference[i].linear_velocity == arrays[i].linear_velocity, vformat("Body %d has a different linear velocity.", i));
+		CHECK_MESSAGE(reference[i].angular_velocity == arrays[i].angular_velocity, vformat("Body %d has a different angular velocity.", i));
+		moved = moved || !reference[i].linear_velocity.is_zero_approx();
+	}
+	// The bodies must still be moving, or the comparison says little about the integration.
+	CHECK(moved);
+	CHECK(reference[5].transform.origin.z == doctest::Approx(0.6));
+}
+
+// Steps the space with a few forces applied and appends the state of the bodies after every step.
+static void _record_motions(const LocalVector<RID> &p_bodies, int p_step_count, LocalVector<BodyMotion> &r_motions) {
+	PhysicsServer3D *physics_server = PhysicsServer3D::get_singleton();
+	for (int i = 0; i < p_step_count; i++) {
+		physics_server->body_apply_central_force(p_bodies[i % p_bodies.size()], Vector3(0, 40, 10));
+		physics_server->step(STEP_TIME);
+		for (const RID &body : p_bodies) {
+			BodyMotion motion;
+			motion.transform = physics_server->body_get_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM);
+			motion.linear_velocity = physics_server->body_get_state(body, PhysicsServer3D::BODY_STATE_LINEAR_VELOCITY);
+			motion.angular_velocity = physics_server->body_get_state(body, PhysicsServer3D::BODY_STATE_ANGULAR_VELOCITY);
+			r_motions.push_back(motion);
+		}
+	}
+}
+
+TEST_CASE("[SceneTree][Physics] Stepping again from a restored space snapshot gives the same results") {
+	PhysicsServer3D *physics_server = PhysicsServer3D::get_singleton();
+	ProjectSettings *project_settings = ProjectSettings::get_singleton();
+	const Variant old_deterministic = project_settings->get_setting("physics/3d/solver/deterministic");
+	project_settings->set_setting("physics/3d/solver/deterministic", true);
+	RID floor_shape;
+	RID floor;
+	RID space = _create_space(SolverConfig(), floor_shape, floor);
+	project_settings->set_setting("physics/3d/solver/deterministic", old_deterministic);
+
+	RID box_shape = physics_server->box_shape_create();
+	physics_server->shape_set_data(box_shape, Vector3(0.5, 0.5, 0.5));
+
+	// Boxes falling on top of each other, so contacts are kept between steps when the snapshot is saved.
+	LocalVector<RID> boxes;
+	for (int i = 0; i < 12; i++) {
+		RID box = _create_box_body(space, box_shape, Vector3((i % 3) * 0.7, 0.5 + i * 1.1, (i % 2) * 0.4), PhysicsServer3D::BODY_MODE_RIGID);
+		physics_server->body_set_state(box, PhysicsServer3D::BODY_STATE_ANGULAR_VELOCITY, Vector3(i * 0.2, 0, 0.3));
+		boxes.push_back(box);
+	}
+
+	// A joint and an area overriding gravity around the bottom of the stack, their state is saved along with the bodies.
+	RID joint = physics_server->joint_create();
+	physics_server->joint_make_pin(joint, boxes[0], Vector3(0, 1.65, 0.2), boxes[3], Vector3(0, -1.65, -0.2));
+
+	RID area_shape = physics_server->box_shape_create();
+	physics_server->shape_set_data(area_shape, Vector3(1.5, 1.5, 1.5));
+	RID area = physics_server->area_create();
+	physics_server->area_add_shape(area, area_shape);
+	physics_server->area_set_transform(area, Transform3D(Basis(), Vector3(0.7, 1.5, 0.2)));
+	physics_server->area_set_param(area, PhysicsServer3D::AREA_PARAM_GRAVITY_OVERRIDE_MODE, PhysicsServer3D::AREA_SPACE_OVERRIDE_REPLACE);
+	physics_server->area_set_param(area, PhysicsServer3D::AREA_PARAM_GRAVITY_VECTOR, Vector3(0.5, -1, 0));
+	physics_server->area_set_space(area, space);
+
+	for (int i = 0; i < 90; i++) {
+		physics_server->step(STEP_TIME);
+	}
+
+	const PackedByteArray snapshot = physics_server->space_save_snapshot(space);
+	REQUIRE_FALSE(snapshot.is_empty());
+
+	LocalVector<BodyMotion> first_motions;
+	_record_motions(boxes, 60, first_motions);
+
+	REQUIRE(physics_server->space_restore_snapshot(space, snapshot) == OK);
+
+	LocalVector<BodyMotion> second_motions;
+	_record_motions(boxes, 60, second_motions);
+
+	REQUIRE(first_motions.size() == second_motions.size());
+	uint32_t mismatch_count = 0;
+	for (uint32_t i = 0; i < first_motions.size(); i++) {
+		if (first_motions[i].transform != second_motions[i].transform || first_motions[i].linear_velocity != second_motions[i].linear_velocity || first_motions[i].angular_velocity != second_motions[i].angular_velocity) {
+			mismatch_count++;
+		}
+	}
+	CHECK_MESSAGE(mismatch_count == 0, vformat("%d body states differ after restoring the snapshot.", mismatch_count));
+
+	SUBCASE("Spaces with soft bodies can't be saved or restored") {
+		RID soft_body = physics_server->soft_body_create();
+		physics_server->soft_body_set_space(soft_body, space);
+
+		ERR_PRINT_OFF;
+		CHECK(physics_server->space_save_snapshot(space).is_empty());
+		CHECK(physics_server->space_restore_snapshot(space, snapshot) == ERR_UNAVAILABLE);
+		ERR_PRINT_ON;
+
+		physics_server->free(soft_body);
+		CHECK(physics_server->space_restore_snapshot(space, snapshot) == OK);
+	}
+
+	physics_server->free(joint);
+	physics_server->free(area);
+	physics_server->free(area_shape);
+
+	for (const RID &box : boxes) {
+		physics_server->free(box);
+	}
+	physics_server->free(box_shape);
+	physics_server->free(floor);
+	physics_server->free(floor_shape);
+	physics_server->free(space);
+}
+
+TEST_CASE("[SceneTree][Physics] Islands are kept across steps and only patched where constraints change") {
+	GodotSpace3D *space = memnew(GodotSpace3D);
+	GodotArea3D *default_area = memnew(GodotArea3D);
+	space->set_default_area(default_area);
+	default_area->set_space(space);
+	GodotStep3D *step = memnew(GodotStep3D);
+
+	// Two pairs of bodies, A-B and C-D, without shapes so only the joints connect them.
+	GodotBody3D *bodies[4];
+	for (int i = 0; i < 4; i++) {
+		bodies[i] = memnew(GodotBody3D);
+		bodies[i]->set_mode(PhysicsServer3D::BODY_MODE_RIGID);
+		bodies[i]->set_space(space);
+	}
+	CHECK(bodies[0]->get_island() != nullptr);
+	CHECK(bodies[0]->get_island() != bodies[1]->get_island());
+
+	GodotJoint3D *joint_cd = memnew(GodotPinJoint3D(bodies[2], Vector3(), bodies[3], Vector3()));
+	GodotIsland3D *island_cd = bodies[2]->get_island();
+	CHECK_MESSAGE(bodies[3]->get_island() == island_cd, "Adding a joint merges the islands of its bodies right away.");
+	CHECK(island_cd->constraints.size() == 1);
+	CHECK_FALSE(island_cd->dirty);
+
+	GodotJoint3D *joint_ab = memnew(GodotPinJoint3D(bodies[0], Vector3(), bodies[1], Vector3()));
+	GodotIsland3D *island_ab = bodies[0]->get_island();
+	CHECK(bodies[1]->get_island() == island_ab);
+	CHECK(island_ab != island_cd);
+	CHECK(bodies[2]->get_island() == island_cd);
+
+	for (int i = 0; i < 5; i++) {
+		step->step(space, STEP_TIME);
+		CHECK(bodies[0]->get_island() == island_ab);
+		CHECK(bodies[1]->get_island() == island_ab);
+		CHECK(bodies[2]->get_island() == island_cd);
+		CHECK(bodies[3]->get_island() == island_cd);
+	}
+
+	// Sleeping doesn't change how bodies are connected.
+	bodies[2]->set_active(false);
+	bodies[3]->set_active(false);
+	CHECK_FALSE(island_cd->dirty);
+	step->step(space, STEP_TIME);
+	CHECK(bodies[2]->get_island() == island_cd);
+	CHECK_FALSE(bodies[2]->is_active());
+
+	// Removing a joint only floods its own island again.
+	memdelete(joint_ab);
+	CHECK(island_ab->dirty);
+	CHECK_FALSE(island_cd->dirty);
+	step->step(space, STEP_TIME);
+	CHECK(bodies[0]->get_island() != nullptr);
+	CHECK(bodies[1]->get_island() != nullptr);
+	CHECK_MESSAGE(bodies[0]->get_island() != bodies[1]->get_island(), "Bodies are in separate islands once their joint is removed.");
+	CHECK(bodies[2]->get_island() == island_cd);
+	CHECK(bodies[3]->get_island() == island_cd);
+	CHECK(island_cd->constraints.size() == 1);
+
+	memdelete(joint_cd);
+	for (int i = 0; i < 4; i++) {
+		bodies[i]->set_space(nullptr);
+		CHECK(bodies[i]->get_island() == nullptr);
+		memdelete(bodies[i]);
+	}
+	default_area->set_space(nullptr);
+	memdelete(default_area);
+	memdelete(step);
+	memdelete(space);
+}
+
+} // namespace TestGodotStep3D
+
+#endif // TEST_GODOT_STEP_3D_H
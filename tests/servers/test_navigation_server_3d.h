@@ -31,6 +31,9 @@
 #ifndef TEST_NAVIGATION_SERVER_3D_H
 #define TEST_NAVIGATION_SERVER_3D_H
 
+#include "core/math/random_pcg.h"
+#include "core/os/os.h"
+#include "modules/navigation/3d/nav_mesh_generator_3d.h"
 #include "modules/navigation/nav_utils.h"
 #include "scene/3d/mesh_instance_3d.h"
 #include "scene/resources/3d/primitive_meshes.h"
@@ -43,11 +46,16 @@ class CallableMock : public Object {
 	GDCLASS(CallableMock, Object);
 
 public:
+	void function0() {
+		function0_calls++;
+	}
+
 	void function1(Variant arg0) {
 		function1_calls++;
 		function1_latest_arg0 = arg0;
 	}
 
+	unsigned function0_calls{ 0 };
 	unsigned function1_calls{ 0 };
 	Variant function1_latest_arg0{};
 };
@@ -152,6 +160,7 @@ TEST_SUITE("[Navigation]") {
 			CHECK_EQ(navigation_server->map_get_closest_point(map, Vector3(7, 7, 7)), Vector3());
 			CHECK_EQ(navigation_server->map_get_closest_point_normal(map, Vector3(7, 7, 7)), Vector3());
 			CHECK_FALSE(navigation_server->map_get_closest_point_owner(map, Vector3(7, 7, 7)).is_valid());
+			CHECK_EQ(navigation_server->map_get_flow_field_next_position(map, Vector3(7, 7, 7), Vector3(8, 8, 8)), Vector3());
 			CHECK_EQ(navigation_server->map_get_closest_point_to_segment(map, Vector3(7, 7, 7), Vector3(8, 8, 8), true), Vector3());
 			CHECK_EQ(navigation_server->map_get_closest_point_to_segment(map, Vector3(7, 7, 7), Vector3(8, 8, 8), false), Vector3());
 			CHECK_EQ(navigation_server->map_get_path(map, Vector3(7, 7, 7), Vector3(8, 8, 8), true).size(), 0);
@@ -256,6 +265,7 @@ TEST_SUITE("[Navigation]") {
 			CHECK_EQ(navigation_server->map_get_closest_point(map, Vector3(7, 7, 7)), Vector3());
 			CHECK_EQ(navigation_server->map_get_closest_point_normal(map, Vector3(7, 7, 7)), Vector3());
 			CHECK_FALSE(navigation_server->map_get_closest_point_owner(map, Vector3(7, 7, 7)).is_valid());
+			CHECK_EQ(navigation_server->map_get_flow_field_next_position(map, Vector3(7, 7, 7), Vector3(8, 8, 8)), Vector3(8, 8, 8));
 			CHECK_EQ(navigation_server->map_get_closest_point_to_segment(map, Vector3(7, 7, 7), Vector3(8, 8, 8), true), Vector3());
 			CHECK_EQ(navigation_server->map_get_closest_point_to_segment(map, Vector3(7, 7, 7), Vector3(8, 8, 8), false), Vector3());
 			CHECK_EQ(navigation_server->map_get_path(map, Vector3(7, 7, 7), Vector3(8, 8, 8), true).size(), 0);
@@ -454,6 +464,50 @@ TEST_SUITE("[Navigation]") {
 		navigation_server->free(map);
 	}
 
+	TEST_CASE("[NavigationServer3D] Server should avoid agents the same way with the avoidance spatial hash") {
+		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+
+		// The same agents on two maps, one map searches the agent neighbors with the spatial hash.
+		const int agent_count = 8;
+		RID maps[2];
+		RID agents[2][agent_count];
+		CallableMock avoidance_callback_mocks[2][agent_count];
+		for (int map_index = 0; map_index < 2; map_index++) {
+			maps[map_index] = navigation_server->map_create();
+			navigation_server->map_set_active(maps[map_index], true);
+			navigation_server->map_set_use_avoidance_spatial_hash(maps[map_index], map_index == 1);
+			for (int i = 0; i < agent_count; i++) {
+				// Agents on a circle heading to the opposite side.
+				const Vector3 position = Vector3(5.0 + 0.1 * i, 0, 0).rotated(Vector3(0, 1, 0), Math_TAU * i / agent_count);
+				RID agent = navigation_server->agent_create();
+				navigation_server->agent_set_map(agent, maps[map_index]);
+				navigation_server->agent_set_avoidance_enabled(agent, true);
+				navigation_server->agent_set_position(agent, position);
+				navigation_server->agent_set_radius(agent, 1);
+				navigation_server->agent_set_neighbor_distance(agent, 4.0 + i);
+				navigation_server->agent_set_velocity(agent, -position.normalized());
+				navigation_server->agent_set_avoidance_callback(agent, callable_mp(&avoidance_callback_mocks[map_index][i], &CallableMock::function1));
+				agents[map_index][i] = agent;
+			}
+		}
+		CHECK(navigation_server->map_get_use_avoidance_spatial_hash(maps[1]));
+
+		navigation_server->process(0.0); // Give server some cycles to commit.
+		for (int i = 0; i < agent_count; i++) {
+			CHECK_EQ(avoidance_callback_mocks[1][i].function1_calls, 1);
+			const Vector3 safe_velocity = avoidance_callback_mocks[0][i].function1_latest_arg0;
+			const Vector3 spatial_hash_safe_velocity = avoidance_callback_mocks[1][i].function1_latest_arg0;
+			CHECK(spatial_hash_safe_velocity.is_equal_approx(safe_velocity));
+		}
+
+		for (int map_index = 0; map_index < 2; map_index++) {
+			for (int i = 0; i < agent_count; i++) {
+				navigation_server->free(agents[map_index][i]);
+			}
+			navigation_server->free(maps[map_index]);
+		}
+	}
+
 	TEST_CASE("[NavigationServer3D] Server should make agents avoid dynamic obstacles when avoidance enabled") {
 		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
 
@@ -699,6 +753,76 @@ TEST_SUITE("[Navigation]") {
 		memdelete(node_3d);
 	}
 
+	TEST_CASE("[NavigationServer3D] Server should be able to bake navigation mesh in tiles") {
+		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+		Ref<NavigationMeshSourceGeometryData3D> source_geometry = memnew(NavigationMeshSourceGeometryData3D);
+
+		Array arr;
+		arr.resize(RS::ARRAY_MAX);
+		BoxMesh::create_mesh_array(arr, Vector3(20.0, 0.001, 20.0));
+		source_geometry->add_mesh_array(arr, Transform3D());
+
+		Ref<NavigationMesh> navigation_mesh = memnew(NavigationMesh);
+		navigation_mesh->set_tile_size(5.0);
+		uint64_t baked_tile_count = NavMeshGenerator3D::get_baked_tile_count();
+		navigation_server->bake_from_source_geometry_data(navigation_mesh, source_geometry, Callable());
+		CHECK_GT(navigation_mesh->get_polygon_count(), 2);
+		// 4x4 tiles of 5 units, anchored to world space multiples of the tile size.
+		CHECK_EQ(NavMeshGenerator3D::get_baked_tile_count() - baked_tile_count, 16);
+		baked_tile_count = NavMeshGenerator3D::get_baked_tile_count();
+
+		const Vector<Vector3> vertices = navigation_mesh->get_vertices();
+		for (const Vector3 &vertex : vertices) {
+			CHECK_LE(Math::abs(vertex.x), 10.0);
+			CHECK_LE(Math::abs(vertex.z), 10.0);
+		}
+
+		SUBCASE("Baking unchanged source geometry again should give the same navigation mesh") {
+			navigation_server->bake_from_source_geometry_data(navigation_mesh, source_geometry, Callable());
+			CHECK_EQ(navigation_mesh->get_vertices(), vertices);
+			CHECK_MESSAGE(NavMeshGenerator3D::get_baked_tile_count() == baked_tile_count, "All the tiles should be reused from the cache.");
+		}
+
+		SUBCASE("Baking changed source geometry should take it into account") {
+			// An obstruction in the middle of the first tile.
+			Vector<Vector3> obstruction_outline = { Vector3(-9, 0, -9), Vector3(-7, 0, -9), Vector3(-7, 0, -7), Vector3(-9, 0, -7) };
+			source_geometry->add_projected_obstruction(obstruction_outline, -1.0, 2.0, true);
+			navigation_server->bake_from_source_geometry_data(navigation_mesh, source_geometry, Callable());
+			CHECK_NE(navigation_mesh->get_vertices(), vertices);
+			CHECK_MESSAGE(NavMeshGenerator3D::get_baked_tile_count() - baked_tile_count == 1, "Only the tile with the obstruction should be baked again.");
+		}
+
+		SUBCASE("Growing the source geometry should only bake the tiles it reaches") {
+			// A platform beyond the +x edge, at another height, so the bounds grow on two axes.
+			Array platform_arr;
+			platform_arr.resize(RS::ARRAY_MAX);
+			BoxMesh::create_mesh_array(platform_arr, Vector3(2.0, 0.001, 2.0));
+			source_geometry->add_mesh_array(platform_arr, Transform3D(Basis(), Vector3(27.5, 3.0, 2.5)));
+			navigation_server->bake_from_source_geometry_data(navigation_mesh, source_geometry, Callable());
+			CHECK_GT(navigation_mesh->get_vertices().size(), vertices.size());
+			CHECK_MESSAGE(NavMeshGenerator3D::get_baked_tile_count() - baked_tile_count == 1, "The tiles of the first plane should be reused from the cache.");
+		}
+
+		SUBCASE("Paths should cross tile edges") {
+			RID map = navigation_server->map_create();
+			RID region = navigation_server->region_create();
+			navigation_server->map_set_active(map, true);
+			navigation_server->region_set_map(region, map);
+			navigation_server->region_set_navigation_mesh(region, navigation_mesh);
+			navigation_server->process(0.0); // Give server some cycles to commit.
+
+			// From the first tile to the last one, crossing several tile edges on the way.
+			const Vector3 target = Vector3(8.0, 0.0, 8.0);
+			const Vector<Vector3> path = navigation_server->map_get_path(map, Vector3(-8.0, 0.0, -8.0), target, true);
+			REQUIRE_GE(path.size(), 2);
+			CHECK_LT(path[path.size() - 1].distance_to(target), 0.5);
+
+			navigation_server->free(region);
+			navigation_server->free(map);
+			navigation_server->process(0.0); // Give server some cycles to commit.
+		}
+	}
+
 	// This test case does not check precise values on purpose - to not be too sensitivte.
 	TEST_CASE("[NavigationServer3D] Server should respond to queries against valid map properly") {
 		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
@@ -790,11 +914,525 @@ TEST_SUITE("[Navigation]") {
 			CHECK_EQ(query_result->get_path_owner_ids().size(), 0);
 		}
 
+		SUBCASE("Asynchronous queries should yield the same paths as 'map_get_path'") {
+			const Vector3 starts[] = { Vector3(0, 0, 0), Vector3(10, 0, 10), Vector3(-3, 0, 2), Vector3(4, 0, -4) };
+			const Vector3 targets[] = { Vector3(10, 0, 10), Vector3(0, 0, 0), Vector3(4, 0, -4), Vector3(-3, 0, 2) };
+			constexpr int query_count = 4;
+
+			CallableMock callable_mock;
+			Ref<NavigationPathQueryResult3D> query_results[query_count];
+			for (int i = 0; i < query_count; i++) {
+				Ref<NavigationPathQueryParameters3D> query_parameters = memnew(NavigationPathQueryParameters3D);
+				query_parameters->set_map(map);
+				query_parameters->set_start_position(starts[i]);
+				query_parameters->set_target_position(targets[i]);
+				query_results[i].instantiate();
+				navigation_server->query_path_async(query_parameters, query_results[i], callable_mp(&callable_mock, &CallableMock::function0));
+			}
+			CHECK_EQ(callable_mock.function0_calls, 0);
+			CHECK_EQ(query_results[0]->get_path().size(), 0);
+
+			navigation_server->process(0.0); // Resolves the queued queries.
+			CHECK_EQ(callable_mock.function0_calls, query_count);
+			for (int i = 0; i < query_count; i++) {
+				Vector<Vector3> path = navigation_server->map_get_path(map, starts[i], targets[i], true);
+				CHECK_NE(path.size(), 0);
+				CHECK(query_results[i]->get_path() == path);
+			}
+		}
+
+		navigation_server->free(region);
+		navigation_server->free(map);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+	}
+
+	TEST_CASE("[NavigationServer3D] Server should only resync changed regions") {
+		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+
+		// Two quads for the first region and one quad for the second one, sharing an edge at x = 2.
+		Ref<NavigationMesh> navigation_mesh_a = memnew(NavigationMesh);
+		navigation_mesh_a->set_vertices({ Vector3(0, 0, 0), Vector3(1, 0, 0), Vector3(2, 0, 0), Vector3(0, 0, 1), Vector3(1, 0, 1), Vector3(2, 0, 1) });
+		navigation_mesh_a->add_polygon({ 0, 1, 4, 3 });
+		navigation_mesh_a->add_polygon({ 1, 2, 5, 4 });
+
+		Ref<NavigationMesh> navigation_mesh_b = memnew(NavigationMesh);
+		navigation_mesh_b->set_vertices({ Vector3(0, 0, 0), Vector3(1, 0, 0), Vector3(0, 0, 1), Vector3(1, 0, 1) });
+		navigation_mesh_b->add_polygon({ 0, 1, 3, 2 });
+
+		RID map = navigation_server->map_create();
+		RID region_a = navigation_server->region_create();
+		RID region_b = navigation_server->region_create();
+		navigation_server->map_set_active(map, true);
+		navigation_server->region_set_map(region_a, map);
+		navigation_server->region_set_map(region_b, map);
+		navigation_server->region_set_navigation_mesh(region_a, navigation_mesh_a);
+		navigation_server->region_set_navigation_mesh(region_b, navigation_mesh_b);
+		navigation_server->region_set_transform(region_b, Transform3D(Basis(), Vector3(2, 0, 0)));
+		navigation_server->process(0.0); // Give server some cycles to commit.
+
+		CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_POLYGON_COUNT), 3);
+		CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_EDGE_MERGE_COUNT), 2);
+		CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_POLYGON_SYNC_COUNT), 3);
+
+		SUBCASE("Unchanged map should not sync any polygon") {
+			navigation_server->process(0.0);
+			CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_POLYGON_SYNC_COUNT), 0);
+		}
+
+		SUBCASE("Changed region should stay connected to its neighbors") {
+			navigation_server->region_set_transform(region_b, Transform3D(Basis(), Vector3(2, 0, 0.5)));
+			navigation_server->process(0.0);
+			CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_POLYGON_COUNT), 3);
+			CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_EDGE_MERGE_COUNT), 1);
+
+			navigation_server->region_set_transform(region_b, Transform3D(Basis(), Vector3(2, 0, 0)));
+			navigation_server->process(0.0);
+			CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_POLYGON_COUNT), 3);
+			CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_EDGE_MERGE_COUNT), 2);
+
+			const Vector<Vector3> path = navigation_server->map_get_path(map, Vector3(0.5, 0, 0.5), Vector3(2.5, 0, 0.5), true);
+			REQUIRE_GT(path.size(), 0);
+			CHECK(path[path.size() - 1].is_equal_approx(Vector3(2.5, 0, 0.5)));
+		}
+
+		SUBCASE("Disabled region should be removed from the map") {
+			navigation_server->region_set_enabled(region_b, false);
+			navigation_server->process(0.0);
+			CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_POLYGON_COUNT), 2);
+			CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_EDGE_MERGE_COUNT), 1);
+			CHECK_EQ(navigation_server->map_get_closest_point_owner(map, Vector3(2.5, 0, 0.5)), region_a);
+		}
+
+		navigation_server->free(region_b);
+		navigation_server->free(region_a);
+		navigation_server->free(map);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+	}
+
+	TEST_CASE("[NavigationServer3D] Server should find the same closest points as a linear scan") {
+		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+		RandomPCG rng(1234);
+
+		// Random triangles spread over several regions, so both the region subtrees and the top-level nodes are searched.
+		const int region_count = 4;
+		const int triangle_count = 200;
+		RID map = navigation_server->map_create();
+		navigation_server->map_set_active(map, true);
+		LocalVector<RID> regions;
+		LocalVector<Ref<NavigationMesh>> navigation_meshes;
+		for (int i = 0; i < region_count; i++) {
+			Vector<Vector3> vertices;
+			Ref<NavigationMesh> navigation_mesh = memnew(NavigationMesh);
+			for (int j = 0; j < triangle_count; j++) {
+				const Vector3 corner = Vector3(rng.random(0.0f, 100.0f), rng.random(0.0f, 10.0f), rng.random(0.0f, 100.0f));
+				for (int k = 0; k < 3; k++) {
+					vertices.push_back(corner + Vector3(rng.random(-2.0f, 2.0f), rng.random(-0.5f, 0.5f), rng.random(-2.0f, 2.0f)));
+				}
+				navigation_mesh->add_polygon({ j * 3, j * 3 + 1, j * 3 + 2 });
+			}
+			navigation_mesh->set_vertices(vertices);
+
+			RID region = navigation_server->region_create();
+			navigation_server->region_set_map(region, map);
+			navigation_server->region_set_navigation_mesh(region, navigation_mesh);
+			regions.push_back(region);
+			navigation_meshes.push_back(navigation_mesh);
+		}
+		navigation_server->process(0.0); // Give server some cycles to commit.
+
+		const auto check_closest_points = [&]() {
+			for (int i = 0; i < 100; i++) {
+				const Vector3 point = Vector3(rng.random(-10.0f, 110.0f), rng.random(-10.0f, 20.0f), rng.random(-10.0f, 110.0f));
+
+				real_t linear_distance = FLT_MAX;
+				for (uint32_t j = 0; j < regions.size(); j++) {
+					const Transform3D transform = navigation_server->region_get_transform(regions[j]);
+					const Vector<Vector3> vertices = navigation_meshes[j]->get_vertices();
+					for (int k = 0; k < navigation_meshes[j]->get_polygon_count(); k++) {
+						const Vector<int> polygon = navigation_meshes[j]->get_polygon(k);
+						const Face3 face(transform.xform(vertices[polygon[0]]), transform.xform(vertices[polygon[1]]), transform.xform(vertices[polygon[2]]));
+						linear_distance = MIN(linear_distance, face.get_closest_point_to(point).distance_to(point));
+					}
+				}
+
+				const Vector3 closest_point = navigation_server->map_get_closest_point(map, point);
+				CHECK(closest_point.distance_to(point) == doctest::Approx(linear_distance).epsilon(0.0001));
+			}
+		};
+
+		check_closest_points();
+
+		SUBCASE("Closest points should still match after a region moved") {
+			navigation_server->region_set_transform(regions[1], Transform3D(Basis(), Vector3(20, 5, -30)));
+			navigation_server->process(0.0);
+			check_closest_points();
+		}
+
+		for (const RID &region : regions) {
+			navigation_server->free(region);
+		}
+		navigation_server->free(map);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+	}
+
+	TEST_CASE("[NavigationServer3D] Server should reconnect links only when nearby polygons change") {
+		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+
+		Ref<NavigationMesh> navigation_mesh = memnew(NavigationMesh);
+		navigation_mesh->set_vertices({ Vector3(0, 0, 0), Vector3(2, 0, 0), Vector3(0, 0, 2), Vector3(2, 0, 2) });
+		navigation_mesh->add_polygon({ 0, 1, 3, 2 });
+
+		RID map = navigation_server->map_create();
+		navigation_server->map_set_active(map, true);
+		RID regions[3];
+		const Vector3 region_positions[3] = { Vector3(), Vector3(10, 0, 0), Vector3(100, 0, 0) };
+		for (int i = 0; i < 2; i++) {
+			regions[i] = navigation_server->region_create();
+			navigation_server->region_set_map(regions[i], map);
+			navigation_server->region_set_navigation_mesh(regions[i], navigation_mesh);
+			navigation_server->region_set_transform(regions[i], Transform3D(Basis(), region_positions[i]));
+		}
+		RID link = navigation_server->link_create();
+		navigation_server->link_set_map(link, map);
+		navigation_server->link_set_start_position(link, Vector3(1.9, 0, 1));
+		navigation_server->link_set_end_position(link, Vector3(10.1, 0, 1));
+		navigation_server->process(0.0); // Give server some cycles to commit.
+		CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_LINK_SYNC_COUNT), 1);
+
+		const Vector3 start = Vector3(0.5, 0, 1);
+		const Vector3 end = Vector3(11.5, 0, 1);
+		Vector<Vector3> path = navigation_server->map_get_path(map, start, end, true);
+		REQUIRE_GT(path.size(), 0);
+		CHECK(path[path.size() - 1].is_equal_approx(end));
+
+		// A region far away from the link doesn't change its connections.
+		regions[2] = navigation_server->region_create();
+		navigation_server->region_set_map(regions[2], map);
+		navigation_server->region_set_navigation_mesh(regions[2], navigation_mesh);
+		navigation_server->region_set_transform(regions[2], Transform3D(Basis(), region_positions[2]));
+		navigation_server->process(0.0);
+		CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_POLYGON_SYNC_COUNT), 1);
+		CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_LINK_SYNC_COUNT), 0);
+		path = navigation_server->map_get_path(map, start, end, true);
+		REQUIRE_GT(path.size(), 0);
+		CHECK(path[path.size() - 1].is_equal_approx(end));
+
+		// Moving the region at the end of the link away disconnects it, moving it back reconnects it.
+		navigation_server->region_set_transform(regions[1], Transform3D(Basis(), Vector3(10, 0, 10)));
+		navigation_server->process(0.0);
+		CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_LINK_SYNC_COUNT), 1);
+		path = navigation_server->map_get_path(map, start, Vector3(11.5, 0, 11), true);
+		REQUIRE_GT(path.size(), 0);
+		CHECK_FALSE(path[path.size() - 1].is_equal_approx(Vector3(11.5, 0, 11)));
+
+		navigation_server->region_set_transform(regions[1], Transform3D(Basis(), region_positions[1]));
+		navigation_server->process(0.0);
+		path = navigation_server->map_get_path(map, start, end, true);
+		REQUIRE_GT(path.size(), 0);
+		CHECK(path[path.size() - 1].is_equal_approx(end));
+
+		navigation_server->free(link);
+		for (int i = 0; i < 3; i++) {
+			navigation_server->free(regions[i]);
+		}
+		navigation_server->free(map);
+	}
+
+	TEST_CASE("[NavigationServer3D] Server should find paths with the hierarchical path search") {
+		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+
+		// Grid of 32x32 quads with a wall at x = 15 that is only open at the far end.
+		const int grid_size = 32;
+		Vector<Vector3> vertices;
+		for (int z = 0; z <= grid_size; z++) {
+			for (int x = 0; x <= grid_size; x++) {
+				vertices.push_back(Vector3(x, 0, z));
+			}
+		}
+		Ref<NavigationMesh> navigation_mesh = memnew(NavigationMesh);
+		navigation_mesh->set_vertices(vertices);
+		for (int z = 0; z < grid_size; z++) {
+			for (int x = 0; x < grid_size; x++) {
+				if (x == 15 && z < grid_size - 2) {
+					continue;
+				}
+				const int i = z * (grid_size + 1) + x;
+				navigation_mesh->add_polygon({ i, i + 1, i + grid_size + 2, i + grid_size + 1 });
+			}
+		}
+
+		RID map = navigation_server->map_create();
+		RID region = navigation_server->region_create();
+		navigation_server->map_set_active(map, true);
+		navigation_server->region_set_map(region, map);
+		navigation_server->region_set_navigation_mesh(region, navigation_mesh);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+
+		const Vector3 start = Vector3(0.5, 0, 0.5);
+		const Vector3 end = Vector3(30.5, 0, 0.5);
+		const Vector<Vector3> full_path = navigation_server->map_get_path(map, start, end, true);
+		REQUIRE_GT(full_path.size(), 0);
+
+		navigation_server->map_set_path_cluster_size(map, 16);
+		navigation_server->process(0.0);
+		CHECK_EQ(navigation_server->map_get_path_cluster_size(map), 16);
+		// The sync reports the work of the queries since the previous one.
+		const int full_polygon_count = navigation_server->get_process_info(NavigationServer3D::INFO_PATH_QUERY_POLYGON_COUNT);
+		CHECK_GT(full_polygon_count, 0);
+		CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_PATH_QUERY_CLUSTER_COUNT), 0);
+
+		SUBCASE("Path should go around the wall through the clusters") {
+			const Vector<Vector3> path = navigation_server->map_get_path(map, start, end, true);
+			REQUIRE_GT(path.size(), 0);
+			CHECK(path[path.size() - 1].is_equal_approx(end));
+
+			navigation_server->process(0.0);
+			CHECK_GT(navigation_server->get_process_info(NavigationServer3D::INFO_PATH_QUERY_CLUSTER_COUNT), 0);
+			CHECK_LE(navigation_server->get_process_info(NavigationServer3D::INFO_PATH_QUERY_POLYGON_COUNT), full_polygon_count);
+			CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_PATH_QUERY_RETRY_COUNT), 0);
+
+			real_t full_path_length = 0.0;
+			for (int i = 1; i < full_path.size(); i++) {
+				full_path_length += full_path[i - 1].distance_to(full_path[i]);
+			}
+			real_t path_length = 0.0;
+			for (int i = 1; i < path.size(); i++) {
+				path_length += path[i - 1].distance_to(path[i]);
+			}
+			CHECK_LT(path_length, full_path_length * 1.1);
+		}
+
+		SUBCASE("Path should be found when the corridor misses the route") {
+			// A bridge through the wall on other navigation layers connects the clusters on both sides,
+			// so the corridor takes it even though the query can't.
+			Ref<NavigationMesh> bridge_navigation_mesh = memnew(NavigationMesh);
+			bridge_navigation_mesh->set_vertices({ Vector3(15, 0, 0), Vector3(16, 0, 0), Vector3(15, 0, 1), Vector3(16, 0, 1) });
+			bridge_navigation_mesh->add_polygon({ 0, 1, 3, 2 });
+			RID bridge_region = navigation_server->region_create();
+			navigation_server->region_set_map(bridge_region, map);
+			navigation_server->region_set_navigation_mesh(bridge_region, bridge_navigation_mesh);
+			navigation_server->region_set_navigation_layers(bridge_region, 2);
+			navigation_server->process(0.0);
+
+			const Vector<Vector3> path = navigation_server->map_get_path(map, start, end, true, 1);
+			REQUIRE_GT(path.size(), 0);
+			CHECK(path[path.size() - 1].is_equal_approx(end));
+			real_t path_length = 0.0;
+			for (int i = 1; i < path.size(); i++) {
+				path_length += path[i - 1].distance_to(path[i]);
+			}
+			CHECK_GT(path_length, 2.0 * (grid_size - 2));
+
+			// The path can only have come from the search without the corridor.
+			navigation_server->process(0.0);
+			CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_PATH_QUERY_RETRY_COUNT), 1);
+
+			navigation_server->free(bridge_region);
+		}
+
+		SUBCASE("Path should still be found after another region is synced") {
+			Ref<NavigationMesh> other_navigation_mesh = memnew(NavigationMesh);
+			other_navigation_mesh->set_vertices({ Vector3(50, 0, 0), Vector3(51, 0, 0), Vector3(50, 0, 1), Vector3(51, 0, 1) });
+			other_navigation_mesh->add_polygon({ 0, 1, 3, 2 });
+			RID other_region = navigation_server->region_create();
+			navigation_server->region_set_map(other_region, map);
+			navigation_server->region_set_navigation_mesh(other_region, other_navigation_mesh);
+			navigation_server->process(0.0);
+
+			navigation_server->region_set_transform(other_region, Transform3D(Basis(), Vector3(0, 0, 10)));
+			navigation_server->process(0.0);
+
+			const Vector<Vector3> path = navigation_server->map_get_path(map, start, end, true);
+			REQUIRE_GT(path.size(), 0);
+			CHECK(path[path.size() - 1].is_equal_approx(end));
+
+			navigation_server->free(other_region);
+			navigation_server->process(0.0);
+
+			const Vector<Vector3> path_after_free = navigation_server->map_get_path(map, start, end, true);
+			REQUIRE_GT(path_after_free.size(), 0);
+			CHECK(path_after_free[path_after_free.size() - 1].is_equal_approx(end));
+		}
+
 		navigation_server->free(region);
 		navigation_server->free(map);
 		navigation_server->process(0.0); // Give server some cycles to commit.
 	}
 
+	TEST_CASE("[NavigationServer3D] Server should lead agents to a target with flow fields") {
+		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+
+		// Grid of 32x32 quads with a wall at x = 15 that is only open at the far end.
+		const int grid_size = 32;
+		Vector<Vector3> vertices;
+		for (int z = 0; z <= grid_size; z++) {
+			for (int x = 0; x <= grid_size; x++) {
+				vertices.push_back(Vector3(x, 0, z));
+			}
+		}
+		Ref<NavigationMesh> navigation_mesh = memnew(NavigationMesh);
+		navigation_mesh->set_vertices(vertices);
+		for (int z = 0; z < grid_size; z++) {
+			for (int x = 0; x < grid_size; x++) {
+				if (x == 15 && z < grid_size - 2) {
+					continue;
+				}
+				const int i = z * (grid_size + 1) + x;
+				navigation_mesh->add_polygon({ i, i + 1, i + grid_size + 2, i + grid_size + 1 });
+			}
+		}
+
+		RID map = navigation_server->map_create();
+		RID region = navigation_server->region_create();
+		navigation_server->map_set_active(map, true);
+		navigation_server->region_set_map(region, map);
+		navigation_server->region_set_navigation_mesh(region, navigation_mesh);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+
+		const Vector3 start = Vector3(0.5, 0, 0.5);
+		const Vector3 end = Vector3(30.5, 0, 0.5);
+
+		// Follows the next positions to the target, stepping a bit past each gateway to enter the next polygon.
+		const auto walk = [&](real_t &r_length) -> bool {
+			r_length = 0.0;
+			Vector3 position = start;
+			for (int i = 0; i < 200; i++) {
+				const Vector3 next_position = navigation_server->map_get_flow_field_next_position(map, end, position);
+				if (next_position.is_equal_approx(end)) {
+					r_length += position.distance_to(end);
+					return true;
+				}
+				if (next_position.is_equal_approx(position)) {
+					return false;
+				}
+				r_length += position.distance_to(next_position);
+				position = next_position + (next_position - position).normalized() * 0.01;
+			}
+			return false;
+		};
+
+		SUBCASE("Flow field should go around the wall") {
+			real_t length = 0.0;
+			CHECK(walk(length));
+			CHECK_GT(length, 2.0 * (grid_size - 2));
+			CHECK(navigation_server->map_get_flow_field_next_position(map, end, Vector3(30.2, 0, 0.7)).is_equal_approx(end));
+		}
+
+		SUBCASE("Flow field should take a link through the wall") {
+			RID link = navigation_server->link_create();
+			navigation_server->link_set_map(link, map);
+			navigation_server->link_set_start_position(link, Vector3(14.5, 0, 0.5));
+			navigation_server->link_set_end_position(link, Vector3(16.5, 0, 0.5));
+			navigation_server->link_set_bidirectional(link, true);
+			navigation_server->process(0.0);
+
+			real_t length = 0.0;
+			CHECK(walk(length));
+			CHECK_LT(length, 40.0);
+
+			navigation_server->free(link);
+			navigation_server->process(0.0);
+		}
+
+		SUBCASE("Flow field should only use the polygons in the navigation layers") {
+			navigation_server->region_set_navigation_layers(region, 2);
+			navigation_server->process(0.0);
+
+			CHECK_EQ(navigation_server->map_get_flow_field_next_position(map, end, start, 1), start);
+			CHECK_NE(navigation_server->map_get_flow_field_next_position(map, end, start, 2), start);
+		}
+
+		navigation_server->free(region);
+		navigation_server->free(map);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+	}
+
+	// Run with: godot --test --test-case="*[Benchmark]*" --no-skip
+	TEST_CASE("[NavigationServer3D][Benchmark] Map sync and path queries with path clusters" * doctest::skip()) {
+		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+
+		// Tiles of 32x32 quads, the tile edges merge with the neighbor tiles.
+		// Each tile has a wall in its middle that is only open at one end, alternating between the tile columns.
+		const int tile_size = 32;
+		const int tile_count = 16;
+		Vector<Vector3> vertices;
+		for (int z = 0; z <= tile_size; z++) {
+			for (int x = 0; x <= tile_size; x++) {
+				vertices.push_back(Vector3(x, 0, z));
+			}
+		}
+		Ref<NavigationMesh> navigation_meshes[2];
+		for (int mesh_index = 0; mesh_index < 2; mesh_index++) {
+			navigation_meshes[mesh_index].instantiate();
+			navigation_meshes[mesh_index]->set_vertices(vertices);
+			for (int z = 0; z < tile_size; z++) {
+				for (int x = 0; x < tile_size; x++) {
+					const bool is_gap = mesh_index == 0 ? z >= tile_size - 2 : z < 2;
+					if (x == tile_size / 2 && !is_gap) {
+						continue;
+					}
+					const int i = z * (tile_size + 1) + x;
+					navigation_meshes[mesh_index]->add_polygon({ i, i + 1, i + tile_size + 2, i + tile_size + 1 });
+				}
+			}
+		}
+
+		RID map = navigation_server->map_create();
+		navigation_server->map_set_active(map, true);
+		Vector<RID> regions;
+		for (int z = 0; z < tile_count; z++) {
+			for (int x = 0; x < tile_count; x++) {
+				RID region = navigation_server->region_create();
+				navigation_server->region_set_map(region, map);
+				navigation_server->region_set_transform(region, Transform3D(Basis(), Vector3(x * tile_size, 0, z * tile_size)));
+				navigation_server->region_set_navigation_mesh(region, navigation_meshes[x % 2]);
+				regions.push_back(region);
+			}
+		}
+		navigation_server->process(0.0); // Give server some cycles to commit.
+
+		const Vector3 start = Vector3(0.5, 0, 0.5);
+		const Vector3 end = Vector3(tile_count * tile_size - 0.5, 0, tile_count * tile_size - 0.5);
+		const int sync_count = 20;
+		const int query_count = 100;
+		const uint32_t cluster_sizes[] = { 0, 16 };
+		for (const uint32_t cluster_size : cluster_sizes) {
+			navigation_server->map_set_path_cluster_size(map, cluster_size);
+			navigation_server->process(0.0);
+
+			// Toggling one tile only syncs its polygons and clusters.
+			uint64_t begin_usec = OS::get_singleton()->get_ticks_usec();
+			for (int i = 0; i < sync_count; i++) {
+				navigation_server->region_set_enabled(regions[i % regions.size()], false);
+				navigation_server->process(0.0);
+				navigation_server->region_set_enabled(regions[i % regions.size()], true);
+				navigation_server->process(0.0);
+			}
+			const uint64_t sync_usec = OS::get_singleton()->get_ticks_usec() - begin_usec;
+
+			begin_usec = OS::get_singleton()->get_ticks_usec();
+			for (int i = 0; i < query_count; i++) {
+				const Vector<Vector3> path = navigation_server->map_get_path(map, start, end, true);
+				CHECK_GT(path.size(), 0);
+			}
+			const uint64_t query_usec = OS::get_singleton()->get_ticks_usec() - begin_usec;
+
+			// The next sync reports what the queries expanded.
+			navigation_server->process(0.0);
+			const int polygon_count = navigation_server->get_process_info(NavigationServer3D::INFO_PATH_QUERY_POLYGON_COUNT);
+			const int cluster_count = navigation_server->get_process_info(NavigationServer3D::INFO_PATH_QUERY_CLUSTER_COUNT);
+			const int retry_count = navigation_server->get_process_info(NavigationServer3D::INFO_PATH_QUERY_RETRY_COUNT);
+
+			print_line(vformat("[Benchmark] Cluster size %d: %.3f ms per sync, %.3f ms per path query, %d polygons and %d clusters expanded per path query, %d of %d path queries searched again without the corridor", cluster_size, sync_usec / 1000.0 / (2 * sync_count), query_usec / 1000.0 / query_count, polygon_count / query_count, cluster_count / query_count, retry_count, query_count));
+		}
+
+		for (const RID &region : regions) {
+			navigation_server->free(region);
+		}
+		navigation_server->free(map);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+	}
+
 	// FIXME: The race condition mentioned below is actually a problem and fails on CI (GH-90613).
 	/*
 	TEST_CASE("[NavigationServer3D] Server should be able to bake asynchronously") {
@@ -128,7 +128,12 @@
 #include "tests/scene/test_viewport.h"
 #include "tests/scene/test_visual_shader.h"
 #include "tests/scene/test_window.h"
+#include "tests/servers/rendering/test_occlusion_cull_raster.h"
+#include "tests/servers/rendering/test_renderer_canvas_cull.h"
+#include "tests/servers/rendering/test_renderer_scene_cull.h"
+#include "tests/servers/rendering/test_rendering_benchmark.h"
 #include "tests/servers/rendering/test_shader_preprocessor.h"
+#include "tests/servers/test_godot_step_2d.h"
 #include "tests/servers/test_text_server.h"
 #include "tests/test_validate_testing.h"
 
@@ -158,6 +163,10 @@
 #include "tests/scene/test_path_3d.h"
 #include "tests/scene/test_path_follow_3d.h"
 #include "tests/scene/test_primitives.h"
+#include "tests/servers/test_godot_area_pair_3d.h"
+#include "tests/servers/test_godot_collision_solver_3d.h"
+#include "tests/servers/test_godot_space_3d.h"
+#include "tests/servers/test_godot_step_3d.h"
 #endif // _3D_DISABLED
 
 #include "modules/modules_tests.gen.h"